@@ -0,0 +1,722 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampAsyncLogger.cpp
+ * @brief Logging with formatting and output moved to a writer thread
+ */
+
+#include "AampAsyncLogger.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+
+#define MAX_CONVERSION_LENGTH	31	/**< Longest conversion specification queued, such as %-#0*.*llx */
+
+std::atomic<bool> AampAsyncLogger::sRunning(false);
+thread_local AampAsyncLogger::ThreadSlot AampAsyncLogger::sThreadSlot;
+
+/**
+ * @enum ArgType
+ * @brief Argument consumed by a conversion
+ */
+enum ArgType
+{
+	eARG_NONE,	/**< %% */
+	eARG_INT,	/**< int and types promoted to it */
+	eARG_LONG,
+	eARG_LLONG,
+	eARG_SIZE,
+	eARG_INTMAX,
+	eARG_PTRDIFF,
+	eARG_DOUBLE,
+	eARG_LDOUBLE,
+	eARG_STRING,	/**< Queued as flag byte, 0 for NULL, then the characters and NUL */
+	eARG_POINTER
+};
+
+/**
+ * @struct Conversion
+ * @brief Parsed conversion specification of a format
+ */
+struct Conversion
+{
+	size_t length;		/**< Characters from % up to the conversion character */
+	bool starWidth;		/**< Width is an int argument */
+	bool starPrecision;	/**< Precision is an int argument */
+	int precision;		/**< Literal precision, -1 if none */
+	ArgType type;
+};
+
+/**
+ * @struct AampLogRecord
+ * @brief Header of a queued message, packed arguments follow it
+ */
+struct AampLogRecord
+{
+	struct timeval time;
+	const char *levelstr;
+	const char *function;
+	const char *format;
+	int playerId;
+	int line;
+	int argsSize;
+};
+
+/**
+ * @brief Parse conversion specification starting at %
+ * @retval false if the conversion cannot be queued
+ */
+static bool ParseConversion(const char *spec, Conversion &conversion)
+{
+	enum { eMOD_NONE, eMOD_HH, eMOD_H, eMOD_L, eMOD_LL, eMOD_LONG_DOUBLE, eMOD_Z, eMOD_J, eMOD_T } modifier = eMOD_NONE;
+	const char *p = spec + 1;
+	conversion.length = 0;
+	conversion.starWidth = false;
+	conversion.starPrecision = false;
+	conversion.precision = -1;
+	conversion.type = eARG_NONE;
+	if (*p == '%')
+	{
+		conversion.length = 2;
+		return true;
+	}
+	while (*p && strchr("-+ #0'", *p))
+	{
+		p++;
+	}
+	if (*p == '*')
+	{
+		conversion.starWidth = true;
+		p++;
+	}
+	while (isdigit((unsigned char)*p))
+	{
+		p++;
+	}
+	if (*p == '$')
+	{
+		// positional arguments are not consumed in order
+		return false;
+	}
+	if (*p == '.')
+	{
+		p++;
+		if (*p == '*')
+		{
+			conversion.starPrecision = true;
+			p++;
+		}
+		else
+		{
+			conversion.precision = 0;
+			while (isdigit((unsigned char)*p))
+			{
+				conversion.precision = std::min(conversion.precision * 10 + (*p - '0'), AAMP_ASYNC_LOG_LINE_SIZE);
+				p++;
+			}
+		}
+	}
+	switch (*p)
+	{
+		case 'h':
+			modifier = (p[1] == 'h') ? eMOD_HH : eMOD_H;
+			p += (p[1] == 'h') ? 2 : 1;
+			break;
+		case 'l':
+			modifier = (p[1] == 'l') ? eMOD_LL : eMOD_L;
+			p += (p[1] == 'l') ? 2 : 1;
+			break;
+		case 'q':
+			modifier = eMOD_LL;
+			p++;
+			break;
+		case 'L':
+			modifier = eMOD_LONG_DOUBLE;
+			p++;
+			break;
+		case 'z':
+			modifier = eMOD_Z;
+			p++;
+			break;
+		case 'j':
+			modifier = eMOD_J;
+			p++;
+			break;
+		case 't':
+			modifier = eMOD_T;
+			p++;
+			break;
+		default:
+			break;
+	}
+	switch (*p)
+	{
+		case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+			switch (modifier)
+			{
+				case eMOD_NONE: case eMOD_HH: case eMOD_H: conversion.type = eARG_INT; break;
+				case eMOD_L: conversion.type = eARG_LONG; break;
+				case eMOD_LL: conversion.type = eARG_LLONG; break;
+				case eMOD_Z: conversion.type = eARG_SIZE; break;
+				case eMOD_J: conversion.type = eARG_INTMAX; break;
+				case eMOD_T: conversion.type = eARG_PTRDIFF; break;
+				default: return false;
+			}
+			break;
+		case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+			if (modifier == eMOD_NONE || modifier == eMOD_L)
+			{
+				conversion.type = eARG_DOUBLE;
+			}
+			else if (modifier == eMOD_LONG_DOUBLE)
+			{
+				conversion.type = eARG_LDOUBLE;
+			}
+			else
+			{
+				return false;
+			}
+			break;
+		case 'c':
+			conversion.type = eARG_INT;
+			break;
+		case 's':
+			conversion.type = eARG_STRING;
+			break;
+		case 'p':
+			conversion.type = eARG_POINTER;
+			break;
+		default:
+			// %n, %m and unknown conversions
+			return false;
+	}
+	if (modifier != eMOD_NONE && (*p == 'c' || *p == 's' || *p == 'p'))
+	{
+		// wide characters
+		return false;
+	}
+	conversion.length = (size_t)(p + 1 - spec);
+	return (conversion.length <= MAX_CONVERSION_LENGTH);
+}
+
+/**
+ * @brief Append value to packed arguments
+ */
+template<typename T>
+static bool Put(unsigned char *&pos, const unsigned char *end, T value)
+{
+	if ((size_t)(end - pos) < sizeof(T))
+	{
+		return false;
+	}
+	memcpy(pos, &value, sizeof(T));
+	pos += sizeof(T);
+	return true;
+}
+
+/**
+ * @brief Read value from packed arguments
+ */
+template<typename T>
+static bool Get(const unsigned char *&pos, const unsigned char *end, T &value)
+{
+	if ((size_t)(end - pos) < sizeof(T))
+	{
+		return false;
+	}
+	memcpy(&value, pos, sizeof(T));
+	pos += sizeof(T);
+	return true;
+}
+
+/**
+ * @brief Append string to packed arguments, cut to precision and to the space left
+ */
+static bool PutString(unsigned char *&pos, const unsigned char *end, const char *str, int precision)
+{
+	if ((end - pos) < 2)
+	{
+		return false;
+	}
+	*pos++ = (str != NULL);
+	if (str)
+	{
+		size_t maxLength = (size_t)(end - pos) - 1;
+		if (precision >= 0 && (size_t)precision < maxLength)
+		{
+			maxLength = (size_t)precision;
+		}
+		size_t length = strnlen(str, maxLength);
+		memcpy(pos, str, length);
+		pos[length] = 0;
+		pos += length + 1;
+	}
+	return true;
+}
+
+/**
+ * @brief Pack the arguments format consumes
+ * @return packed size, -1 if format cannot be queued or arguments do not fit
+ */
+static int PackArgs(const char *format, va_list args, unsigned char *buffer, size_t size)
+{
+	unsigned char *pos = buffer;
+	const unsigned char *end = buffer + size;
+	Conversion conversion;
+	for (const char *p = strchr(format, '%'); p; p = strchr(p + conversion.length, '%'))
+	{
+		if (!ParseConversion(p, conversion))
+		{
+			return -1;
+		}
+		bool fits = true;
+		int precision = conversion.precision;
+		if (conversion.starWidth)
+		{
+			fits = Put(pos, end, va_arg(args, int));
+		}
+		if (conversion.starPrecision)
+		{
+			precision = va_arg(args, int);
+			fits = fits && Put(pos, end, precision);
+		}
+		switch (conversion.type)
+		{
+			case eARG_NONE: break;
+			case eARG_INT: fits = fits && Put(pos, end, va_arg(args, int)); break;
+			case eARG_LONG: fits = fits && Put(pos, end, va_arg(args, long)); break;
+			case eARG_LLONG: fits = fits && Put(pos, end, va_arg(args, long long)); break;
+			case eARG_SIZE: fits = fits && Put(pos, end, va_arg(args, size_t)); break;
+			case eARG_INTMAX: fits = fits && Put(pos, end, va_arg(args, intmax_t)); break;
+			case eARG_PTRDIFF: fits = fits && Put(pos, end, va_arg(args, ptrdiff_t)); break;
+			case eARG_DOUBLE: fits = fits && Put(pos, end, va_arg(args, double)); break;
+			case eARG_LDOUBLE: fits = fits && Put(pos, end, va_arg(args, long double)); break;
+			case eARG_STRING: fits = fits && PutString(pos, end, va_arg(args, const char *), precision); break;
+			case eARG_POINTER: fits = fits && Put(pos, end, va_arg(args, void *)); break;
+		}
+		if (!fits)
+		{
+			return -1;
+		}
+	}
+	return (int)(pos - buffer);
+}
+
+/**
+ * @brief Format one packed argument with its conversion specification
+ */
+template<typename T>
+static int FormatArg(char *out, size_t size, const char *spec, const Conversion &conversion, int width, int precision, T value)
+{
+	if (conversion.starWidth && conversion.starPrecision)
+	{
+		return snprintf(out, size, spec, width, precision, value);
+	}
+	else if (conversion.starWidth)
+	{
+		return snprintf(out, size, spec, width, value);
+	}
+	else if (conversion.starPrecision)
+	{
+		return snprintf(out, size, spec, precision, value);
+	}
+	return snprintf(out, size, spec, value);
+}
+
+/**
+ * @brief Read argument of type T and format it
+ */
+template<typename T>
+static int FormatPacked(const unsigned char *&pos, const unsigned char *end, char *out, size_t size, const char *spec,
+		const Conversion &conversion, int width, int precision)
+{
+	T value;
+	if (!Get(pos, end, value))
+	{
+		return -1;
+	}
+	return FormatArg(out, size, spec, conversion, width, precision, value);
+}
+
+/**
+ * @brief Format packed arguments as snprintf would have formatted the originals
+ * @return length written to out, which is always terminated
+ */
+static size_t FormatArgs(const char *format, const unsigned char *pos, const unsigned char *end, char *out, size_t size)
+{
+	size_t used = 0;
+	const char *p = format;
+	while (*p && used + 1 < size)
+	{
+		size_t literal = std::min(strcspn(p, "%"), size - used - 1);
+		memcpy(out + used, p, literal);
+		used += literal;
+		p += literal;
+		Conversion conversion;
+		if (*p != '%' || used + 1 >= size || !ParseConversion(p, conversion))
+		{
+			break;
+		}
+		char spec[MAX_CONVERSION_LENGTH + 1];
+		memcpy(spec, p, conversion.length);
+		spec[conversion.length] = 0;
+		int width = 0;
+		int precision = 0;
+		if ((conversion.starWidth && !Get(pos, end, width)) || (conversion.starPrecision && !Get(pos, end, precision)))
+		{
+			break;
+		}
+		char *dst = out + used;
+		size_t left = size - used;
+		int written = -1;
+		switch (conversion.type)
+		{
+			case eARG_NONE:
+				*dst = '%';
+				written = 1;
+				break;
+			case eARG_INT: written = FormatPacked<int>(pos, end, dst, left, spec, conversion, width, precision); break;
+			case eARG_LONG: written = FormatPacked<long>(pos, end, dst, left, spec, conversion, width, precision); break;
+			case eARG_LLONG: written = FormatPacked<long long>(pos, end, dst, left, spec, conversion, width, precision); break;
+			case eARG_SIZE: written = FormatPacked<size_t>(pos, end, dst, left, spec, conversion, width, precision); break;
+			case eARG_INTMAX: written = FormatPacked<intmax_t>(pos, end, dst, left, spec, conversion, width, precision); break;
+			case eARG_PTRDIFF: written = FormatPacked<ptrdiff_t>(pos, end, dst, left, spec, conversion, width, precision); break;
+			case eARG_DOUBLE: written = FormatPacked<double>(pos, end, dst, left, spec, conversion, width, precision); break;
+			case eARG_LDOUBLE: written = FormatPacked<long double>(pos, end, dst, left, spec, conversion, width, precision); break;
+			case eARG_POINTER: written = FormatPacked<void *>(pos, end, dst, left, spec, conversion, width, precision); break;
+			case eARG_STRING:
+			{
+				unsigned char present = 0;
+				if (Get(pos, end, present))
+				{
+					const char *str = "(null)";
+					if (present)
+					{
+						str = (const char *)pos;
+						pos += strnlen(str, (size_t)(end - pos)) + 1;
+					}
+					written = FormatArg(dst, left, spec, conversion, width, precision, str);
+				}
+				break;
+			}
+		}
+		if (written < 0)
+		{
+			break;
+		}
+		used += std::min((size_t)written, left - 1);
+		p += conversion.length;
+	}
+	out[used] = 0;
+	return used;
+}
+
+/**
+ * @brief Copy record to ring slots from slot on, wrapping around
+ */
+static void CopyToRing(std::vector<unsigned char> &data, int slot, const unsigned char *src, size_t size)
+{
+	size_t offset = (size_t)slot * AAMP_ASYNC_LOG_SLOT_SIZE;
+	size_t first = std::min(size, data.size() - offset);
+	memcpy(&data[offset], src, first);
+	if (first < size)
+	{
+		memcpy(&data[0], src + first, size - first);
+	}
+}
+
+/**
+ * @brief Copy record from ring slots from slot on, wrapping around
+ */
+static void CopyFromRing(const std::vector<unsigned char> &data, int slot, unsigned char *dst, size_t size)
+{
+	size_t offset = (size_t)slot * AAMP_ASYNC_LOG_SLOT_SIZE;
+	size_t first = std::min(size, data.size() - offset);
+	memcpy(dst, &data[offset], first);
+	if (first < size)
+	{
+		memcpy(dst + first, &data[0], size - first);
+	}
+}
+
+/**
+ * @brief Slots taken by a record
+ */
+static int GetSlotCount(size_t size)
+{
+	return (int)((size + AAMP_ASYNC_LOG_SLOT_SIZE - 1) / AAMP_ASYNC_LOG_SLOT_SIZE);
+}
+
+/**
+ * @brief Get process wide logger
+ */
+AampAsyncLogger &AampAsyncLogger::GetInstance()
+{
+	static AampAsyncLogger instance;
+	return instance;
+}
+
+/**
+ * @brief AampAsyncLogger constructor
+ */
+AampAsyncLogger::AampAsyncLogger() : mControlMutex(), mMutex(), mCond(), mRings(), mDrainRings(), mThread(), mSink(),
+	mSlotsPerThread(AAMP_ASYNC_LOG_SLOTS), mStopping(false), mWakeup(false), mDroppedCount(0), mText(), mOffsets(), mLines()
+{
+}
+
+/**
+ * @brief AampAsyncLogger destructor
+ */
+AampAsyncLogger::~AampAsyncLogger()
+{
+	Stop();
+}
+
+/**
+ * @brief Mark ring of ending thread for removal, its messages are still written
+ */
+AampAsyncLogger::ThreadSlot::~ThreadSlot()
+{
+	exited = true;
+	if (ring)
+	{
+		ring->retired.store(true, std::memory_order_release);
+		ring.reset();
+	}
+}
+
+/**
+ * @brief Start writer thread
+ */
+void AampAsyncLogger::Start(int slotsPerThread, AampLogSink sink)
+{
+	std::lock_guard<std::mutex> control(mControlMutex);
+	if (mThread.joinable())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		mSlotsPerThread = std::max(slotsPerThread, 1);
+		mStopping = false;
+	}
+	mSink = sink;
+	mThread = std::thread(&AampAsyncLogger::Run, this);
+	sRunning.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Write out queued messages and stop writer thread
+ */
+void AampAsyncLogger::Stop()
+{
+	std::lock_guard<std::mutex> control(mControlMutex);
+	if (!mThread.joinable())
+	{
+		return;
+	}
+	// a message queued by a thread which saw the logger running after this is written on next Start
+	sRunning.store(false, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		mStopping = true;
+	}
+	mCond.notify_one();
+	mThread.join();
+}
+
+/**
+ * @brief Get ring of calling thread, registering one on its first message
+ */
+AampAsyncLogger::ThreadRing *AampAsyncLogger::GetThreadRing()
+{
+	ThreadSlot &slot = sThreadSlot;
+	if (slot.ring)
+	{
+		return slot.ring.get();
+	}
+	if (slot.exited)
+	{
+		return NULL;
+	}
+	char threadName[16] = {0};
+	(void)pthread_getname_np(pthread_self(), threadName, sizeof(threadName));
+
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (mRings.size() >= AAMP_ASYNC_LOG_MAX_THREADS)
+	{
+		return NULL;
+	}
+	slot.ring = std::make_shared<ThreadRing>(mSlotsPerThread, threadName);
+	mRings.push_back(slot.ring);
+	return slot.ring.get();
+}
+
+/**
+ * @brief Queue a message to the ring of calling thread
+ */
+bool AampAsyncLogger::Log(int playerId, const char *levelstr, const char *function, int line, const char *format, va_list args)
+{
+	if (!IsRunning() || !format)
+	{
+		return false;
+	}
+	ThreadRing *ring = GetThreadRing();
+	if (!ring)
+	{
+		return false;
+	}
+	unsigned char record[sizeof(AampLogRecord) + AAMP_ASYNC_LOG_MAX_ARGS_SIZE];
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+	int argsSize = PackArgs(format, argsCopy, record + sizeof(AampLogRecord), AAMP_ASYNC_LOG_MAX_ARGS_SIZE);
+	va_end(argsCopy);
+	if (argsSize < 0)
+	{
+		return false;
+	}
+	AampLogRecord header;
+	gettimeofday(&header.time, NULL);
+	header.levelstr = levelstr;
+	header.function = function;
+	header.format = format;
+	header.playerId = playerId;
+	header.line = line;
+	header.argsSize = argsSize;
+	memcpy(record, &header, sizeof(header));
+
+	size_t size = sizeof(header) + argsSize;
+	int slots = GetSlotCount(size);
+	AampSpscRing &spscRing = ring->ring;
+	if (slots > spscRing.GetCapacity())
+	{
+		return false;
+	}
+	if (spscRing.GetCapacity() - spscRing.GetCount() < slots)
+	{
+		ring->dropped.fetch_add(1, std::memory_order_relaxed);
+		mDroppedCount++;
+		return true;
+	}
+	CopyToRing(ring->data, spscRing.GetWriteIndex(), record, size);
+	spscRing.Push(slots);
+	// a notification missed by the writer only delays the messages to its next timeout
+	if (spscRing.GetCount() * 2 >= spscRing.GetCapacity() && !mWakeup.exchange(true))
+	{
+		mCond.notify_one();
+	}
+	return true;
+}
+
+/**
+ * @brief Writer thread
+ */
+void AampAsyncLogger::Run()
+{
+	(void)pthread_setname_np(pthread_self(), "aampAsyncLog");
+	bool stopping = false;
+	while (!stopping)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			if (!mStopping && !mWakeup.load())
+			{
+				mCond.wait_for(lock, std::chrono::milliseconds(AAMP_ASYNC_LOG_FLUSH_MS));
+			}
+			mWakeup.store(false);
+			stopping = mStopping;
+			mDrainRings = mRings;
+			// rings of ended threads go once their messages and drops are written
+			mRings.erase(std::remove_if(mRings.begin(), mRings.end(), [](const std::shared_ptr<ThreadRing> &ring)
+			{
+				return ring->retired.load(std::memory_order_acquire) && ring->ring.GetCount() == 0 &&
+					ring->dropped.load() == ring->droppedReported;
+			}), mRings.end());
+		}
+		Drain();
+	}
+}
+
+/**
+ * @brief Format messages of all rings and pass them to the sink
+ */
+void AampAsyncLogger::Drain()
+{
+	unsigned char record[sizeof(AampLogRecord) + AAMP_ASYNC_LOG_MAX_ARGS_SIZE];
+	char line[AAMP_ASYNC_LOG_LINE_SIZE];
+	mText.clear();
+	mOffsets.clear();
+	mLines.clear();
+	for (const std::shared_ptr<ThreadRing> &ring : mDrainRings)
+	{
+		AampSpscRing &spscRing = ring->ring;
+		for (int count = spscRing.GetCount(); count > 0; )
+		{
+			AampLogRecord header;
+			CopyFromRing(ring->data, spscRing.GetReadIndex(), (unsigned char *)&header, sizeof(header));
+			size_t size = sizeof(header) + header.argsSize;
+			int slots = GetSlotCount(size);
+			CopyFromRing(ring->data, spscRing.GetReadIndex(), record, size);
+			spscRing.Pop(slots);
+			count -= slots;
+
+			int length = snprintf(line, sizeof(line), AAMP_LOG_PREFIX_FORMAT, header.playerId, header.levelstr, header.function, header.line);
+			length = std::min(std::max(length, 0), (int)sizeof(line) - 1);
+			length += (int)FormatArgs(header.format, record + sizeof(header), record + size, line + length, sizeof(line) - length);
+			mOffsets.push_back(mText.size());
+			mText.append(line, length + 1);
+			mLines.push_back({header.time, NULL});
+		}
+		unsigned long long dropped = ring->dropped.load();
+		if (dropped != ring->droppedReported)
+		{
+			AampLogLine dropLine;
+			gettimeofday(&dropLine.time, NULL);
+			int length = snprintf(line, sizeof(line), AAMP_LOG_PREFIX_FORMAT "%llu messages of thread %s dropped, log ring full",
+				-1, "WARN", __FUNCTION__, __LINE__, dropped - ring->droppedReported, ring->threadName.c_str());
+			length = std::min(std::max(length, 0), (int)sizeof(line) - 1);
+			ring->droppedReported = dropped;
+			mOffsets.push_back(mText.size());
+			mText.append(line, length + 1);
+			mLines.push_back(dropLine);
+		}
+	}
+	mDrainRings.clear();
+	if (!mLines.empty())
+	{
+		for (size_t i = 0; i < mLines.size(); i++)
+		{
+			mLines[i].text = mText.c_str() + mOffsets[i];
+		}
+		// rings are drained one after another, the batch is merged back in time order
+		std::stable_sort(mLines.begin(), mLines.end(), [](const AampLogLine &a, const AampLogLine &b)
+		{
+			return (a.time.tv_sec < b.time.tv_sec) || (a.time.tv_sec == b.time.tv_sec && a.time.tv_usec < b.time.tv_usec);
+		});
+		if (mSink)
+		{
+			mSink(mLines.data(), (int)mLines.size());
+		}
+	}
+}
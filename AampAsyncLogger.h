@@ -0,0 +1,212 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampAsyncLogger.h
+ * @brief Logging with formatting and output moved to a writer thread
+ */
+
+#ifndef __AAMP_ASYNC_LOGGER_H__
+#define __AAMP_ASYNC_LOGGER_H__
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <sys/time.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AampSpscRing.h"
+
+#define AAMP_LOG_PREFIX_FORMAT		"[AAMP-PLAYER][%d][%s][%s][%d]"	/**< Player, level, function and line of a log line */
+#define AAMP_ASYNC_LOG_SLOT_SIZE	64	/**< Bytes of a ring slot, a message takes one or more */
+#define AAMP_ASYNC_LOG_SLOTS		1024	/**< Default slots of a thread ring */
+#define AAMP_ASYNC_LOG_MAX_THREADS	64	/**< Rings in use at once, further threads log synchronously */
+#define AAMP_ASYNC_LOG_MAX_ARGS_SIZE	1024	/**< Packed arguments of a message, strings are cut to fit */
+#define AAMP_ASYNC_LOG_LINE_SIZE	1024	/**< Formatted line, same as MAX_DEBUG_LOG_BUFF_SIZE */
+#define AAMP_ASYNC_LOG_FLUSH_MS		20	/**< Longest a queued message waits for the writer thread */
+
+/**
+ * @struct AampLogLine
+ * @brief Formatted message handed to the sink
+ */
+struct AampLogLine
+{
+	struct timeval time;	/**< When the message was logged */
+	const char *text;	/**< Valid during the sink call */
+};
+
+/**
+ * @brief Output of formatted messages, called on the writer thread with a batch in time order
+ */
+typedef std::function<void(const AampLogLine *lines, int count)> AampLogSink;
+
+/**
+ * @class AampAsyncLogger
+ * @brief Process wide logger which queues format and raw arguments, formatting them later
+ *
+ * Each thread writes its messages to a ring of its own without lock or allocation: the
+ * message header, the format pointer and the arguments the format consumes, with strings
+ * copied. A writer thread drains all rings every AAMP_ASYNC_LOG_FLUSH_MS, or earlier once
+ * a ring is half full, formats the messages with snprintf and passes them to the sink
+ * in batches. A message which does not fit the ring of its thread is dropped and counted;
+ * the writer reports the drops of each thread as a line of its own.
+ *
+ * Formats are read after the call returns, so they have to be string literals. Formats
+ * with conversions that cannot be queued (%n, %m, %ls, %lc, positional arguments) are
+ * refused by Log and have to be logged synchronously by the caller.
+ */
+class AampAsyncLogger
+{
+public:
+	/**
+	 * @fn GetInstance
+	 * @return process wide logger
+	 */
+	static AampAsyncLogger &GetInstance();
+
+	/**
+	 * @fn IsRunning
+	 * @retval true while messages are queued, cheap enough to test on every message
+	 */
+	static bool IsRunning() { return sRunning.load(std::memory_order_relaxed); }
+
+	AampAsyncLogger(const AampAsyncLogger&) = delete;
+	AampAsyncLogger& operator=(const AampAsyncLogger&) = delete;
+
+	/**
+	 * @fn ~AampAsyncLogger
+	 * @brief Writes out queued messages
+	 */
+	~AampAsyncLogger();
+
+	/**
+	 * @fn Start
+	 * @brief Start writer thread, no effect while running
+	 * @param[in] slotsPerThread - ring size of threads logging from now on
+	 * @param[in] sink - output of formatted messages
+	 * @return void
+	 */
+	void Start(int slotsPerThread, AampLogSink sink);
+
+	/**
+	 * @fn Stop
+	 * @brief Write out queued messages and stop writer thread
+	 * @return void
+	 */
+	void Stop();
+
+	/**
+	 * @fn Log
+	 * @brief Queue a message to the ring of calling thread
+	 * @param[in] playerId - player instance, -1 for none
+	 * @param[in] levelstr - level literal
+	 * @param[in] function - function name, __FUNCTION__
+	 * @param[in] line - source line
+	 * @param[in] format - printf format literal
+	 * @param[in] args - arguments of format
+	 * @retval true if queued or dropped, false if it has to be logged synchronously
+	 */
+	bool Log(int playerId, const char *levelstr, const char *function, int line, const char *format, va_list args);
+
+	/**
+	 * @fn GetDroppedCount
+	 * @return messages dropped on full rings since process start
+	 */
+	unsigned long long GetDroppedCount() const { return mDroppedCount.load(); }
+
+private:
+	/**
+	 * @struct ThreadRing
+	 * @brief Message ring written by one thread
+	 */
+	struct ThreadRing
+	{
+		ThreadRing(int capacity, const char *name) : ring(), data((size_t)capacity * AAMP_ASYNC_LOG_SLOT_SIZE), dropped(0),
+			droppedReported(0), threadName(name), retired(false)
+		{
+			ring.Reset(capacity);
+		}
+		AampSpscRing ring;
+		std::vector<unsigned char> data;	/**< AAMP_ASYNC_LOG_SLOT_SIZE bytes per slot */
+		std::atomic<unsigned long long> dropped;
+		unsigned long long droppedReported;	/**< Writer thread only */
+		std::string threadName;
+		std::atomic<bool> retired;		/**< Thread ended, ring is removed once drained */
+	};
+
+	/**
+	 * @struct ThreadSlot
+	 * @brief Thread local link to the ring of a thread
+	 */
+	struct ThreadSlot
+	{
+		ThreadSlot() : ring(), exited(false) {}
+		~ThreadSlot();
+		std::shared_ptr<ThreadRing> ring;
+		bool exited;	/**< Set on thread exit, later messages are logged synchronously */
+	};
+
+	/**
+	 * @fn AampAsyncLogger
+	 */
+	AampAsyncLogger();
+
+	/**
+	 * @fn GetThreadRing
+	 * @return ring of calling thread, NULL if none is available
+	 */
+	ThreadRing *GetThreadRing();
+
+	/**
+	 * @fn Run
+	 * @brief Writer thread
+	 */
+	void Run();
+
+	/**
+	 * @fn Drain
+	 * @brief Format messages of all rings and pass them to the sink
+	 */
+	void Drain();
+
+	static std::atomic<bool> sRunning;
+	static thread_local ThreadSlot sThreadSlot;
+
+	std::mutex mControlMutex;	/**< Serializes Start and Stop */
+	std::mutex mMutex;
+	std::condition_variable mCond;
+	std::vector<std::shared_ptr<ThreadRing>> mRings;
+	std::vector<std::shared_ptr<ThreadRing>> mDrainRings;	/**< Writer thread copy of mRings */
+	std::thread mThread;
+	AampLogSink mSink;
+	int mSlotsPerThread;
+	bool mStopping;
+	std::atomic<bool> mWakeup;
+	std::atomic<unsigned long long> mDroppedCount;
+	std::string mText;			/**< Formatted text of a batch */
+	std::vector<size_t> mOffsets;		/**< Start of each line of a batch in mText */
+	std::vector<AampLogLine> mLines;
+};
+
+#endif /* __AAMP_ASYNC_LOGGER_H__ */
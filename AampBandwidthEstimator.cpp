@@ -0,0 +1,284 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampBandwidthEstimator.cpp
+ * @brief Incremental network bandwidth estimation for ABR
+ */
+
+#include "AampBandwidthEstimator.h"
+#include <math.h>
+
+/**
+ * @brief Add a value to the moving average with weight in seconds
+ */
+void AampEwmaBandwidthModel::Average::Sample(double weight, double value)
+{
+	double alpha = pow(0.5, weight / halfLife);
+	estimate = value * (1 - alpha) + alpha * estimate;
+	totalWeight += weight;
+}
+
+/**
+ * @brief Moving average corrected for its start at 0
+ */
+double AampEwmaBandwidthModel::Average::Get() const
+{
+	double zeroFactor = 1 - pow(0.5, totalWeight / halfLife);
+	return (zeroFactor > 0) ? (estimate / zeroFactor) : 0;
+}
+
+/**
+ * @brief AampEwmaBandwidthModel Constructor
+ */
+AampEwmaBandwidthModel::AampEwmaBandwidthModel(double fastHalfLife, double slowHalfLife, double minBytes) : AampBandwidthModel(),
+	mFast(), mSlow(), mMinBytes(minBytes), mTotalBytes(0)
+{
+	mFast.halfLife = fastHalfLife;
+	mSlow.halfLife = slowHalfLife;
+	Reset();
+}
+
+/**
+ * @brief Add a transfer sample to both averages
+ */
+long AampEwmaBandwidthModel::AddSample(double bytes, double durationMs, long long /*nowMs*/)
+{
+	double seconds = durationMs / 1000.0;
+	double bitsPerSecond = (bytes * 8) / seconds;
+	mFast.Sample(seconds, bitsPerSecond);
+	mSlow.Sample(seconds, bitsPerSecond);
+	mTotalBytes += bytes;
+	if (mTotalBytes < mMinBytes)
+	{
+		return -1;
+	}
+	double estimate = mFast.Get();
+	double slow = mSlow.Get();
+	if (slow < estimate)
+	{
+		estimate = slow;
+	}
+	return (long)estimate;
+}
+
+/**
+ * @brief Drop all samples
+ */
+void AampEwmaBandwidthModel::Reset()
+{
+	mFast.estimate = mFast.totalWeight = 0;
+	mSlow.estimate = mSlow.totalWeight = 0;
+	mTotalBytes = 0;
+}
+
+/**
+ * @brief AampSlidingWindowBandwidthModel Constructor
+ */
+AampSlidingWindowBandwidthModel::AampSlidingWindowBandwidthModel(long windowMs, size_t maxSamples) : AampBandwidthModel(),
+	mSamples(maxSamples ? maxSamples : 1), mFirst(0), mCount(0), mWindowMs(windowMs), mBytes(0), mDurationMs(0)
+{
+}
+
+/**
+ * @brief Remove oldest sample from running sums
+ */
+void AampSlidingWindowBandwidthModel::DropOldest()
+{
+	const Sample &sample = mSamples[mFirst];
+	mBytes -= sample.bytes;
+	mDurationMs -= sample.durationMs;
+	mFirst = (mFirst + 1) % mSamples.size();
+	mCount--;
+	if (!mCount)
+	{
+		// no rounding error carried into next window
+		mBytes = mDurationMs = 0;
+	}
+}
+
+/**
+ * @brief Add a transfer sample, drop samples that left the window
+ */
+long AampSlidingWindowBandwidthModel::AddSample(double bytes, double durationMs, long long nowMs)
+{
+	while (mCount && (mCount == mSamples.size() || (nowMs - mSamples[mFirst].timeMs) > mWindowMs))
+	{
+		DropOldest();
+	}
+	Sample &sample = mSamples[(mFirst + mCount) % mSamples.size()];
+	sample.timeMs = nowMs;
+	sample.bytes = bytes;
+	sample.durationMs = durationMs;
+	mCount++;
+	mBytes += bytes;
+	mDurationMs += durationMs;
+	return (long)((mBytes * 8 * 1000) / mDurationMs);
+}
+
+/**
+ * @brief Drop all samples
+ */
+void AampSlidingWindowBandwidthModel::Reset()
+{
+	mFirst = mCount = 0;
+	mBytes = mDurationMs = 0;
+}
+
+/**
+ * @brief AampBandwidthEstimator Constructor
+ */
+AampBandwidthEstimator::AampBandwidthEstimator() : mMutex(), mModel(), mMaxAgeMs(0), mEnabled(false), mBitsPerSecond(-1), mLastSampleTimeMs(0)
+{
+}
+
+/**
+ * @brief Select model by type
+ */
+void AampBandwidthEstimator::Configure(int type, long maxAgeMs)
+{
+	std::unique_ptr<AampBandwidthModel> model;
+	switch (type)
+	{
+		case eBANDWIDTH_ESTIMATOR_EWMA:
+			model.reset(new AampEwmaBandwidthModel());
+			break;
+		case eBANDWIDTH_ESTIMATOR_SLIDING_WINDOW:
+			model.reset(new AampSlidingWindowBandwidthModel(maxAgeMs));
+			break;
+		default:
+			break;
+	}
+	SetModel(std::move(model), maxAgeMs);
+}
+
+/**
+ * @brief Install a custom model
+ */
+void AampBandwidthEstimator::SetModel(std::unique_ptr<AampBandwidthModel> model, long maxAgeMs)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	mModel = std::move(model);
+	mMaxAgeMs = maxAgeMs;
+	mBitsPerSecond.store(-1, std::memory_order_relaxed);
+	mEnabled.store(mModel != nullptr, std::memory_order_release);
+}
+
+/**
+ * @brief Feed a transfer sample to the model and publish the new estimate
+ */
+void AampBandwidthEstimator::AddSample(double bytes, long long durationMs, long long nowMs)
+{
+	if (durationMs <= 0 || bytes <= 0)
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (mModel)
+	{
+		long bitsPerSecond = mModel->AddSample(bytes, (double)durationMs, nowMs);
+		mLastSampleTimeMs.store(nowMs, std::memory_order_relaxed);
+		mBitsPerSecond.store(bitsPerSecond, std::memory_order_release);
+	}
+}
+
+/**
+ * @brief Read last published estimate
+ */
+long AampBandwidthEstimator::GetEstimate(long long nowMs) const
+{
+	long bitsPerSecond = mBitsPerSecond.load(std::memory_order_acquire);
+	if (bitsPerSecond > 0 && mMaxAgeMs > 0 && (nowMs - mLastSampleTimeMs.load(std::memory_order_relaxed)) > mMaxAgeMs)
+	{
+		// same as HybridABRManager dropping samples beyond cache life
+		bitsPerSecond = -1;
+	}
+	return bitsPerSecond;
+}
+
+/**
+ * @brief Drop samples, keeps model
+ */
+void AampBandwidthEstimator::Reset()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (mModel)
+	{
+		mModel->Reset();
+	}
+	mBitsPerSecond.store(-1, std::memory_order_release);
+}
+
+/**
+ * @brief AampTransferSampler Constructor
+ */
+AampTransferSampler::AampTransferSampler(long idleGapMs) : mIdleGapMs(idleGapMs), mStartMs(-1), mLastMs(-1), mLastBytes(0), mActiveMs(0)
+{
+}
+
+/**
+ * @brief Transfer (re)starts from 0 bytes
+ */
+void AampTransferSampler::Start(long long nowMs)
+{
+	mStartMs = nowMs;
+	mLastMs = -1;
+	mLastBytes = 0;
+	mActiveMs = 0;
+}
+
+/**
+ * @brief Sample interval since previous update if it was active transfer
+ */
+void AampTransferSampler::OnProgress(double bytesNow, long long nowMs, AampBandwidthEstimator &estimator)
+{
+	if (mStartMs < 0 || bytesNow <= mLastBytes)
+	{
+		return;
+	}
+	if (mLastMs >= 0)
+	{
+		long long gapMs = nowMs - mLastMs;
+		if (gapMs <= 0)
+		{
+			// same millisecond, bytes are timed with the next update
+			return;
+		}
+		if (gapMs <= mIdleGapMs)
+		{
+			estimator.AddSample(bytesNow - mLastBytes, gapMs, nowMs);
+			mActiveMs += gapMs;
+		}
+	}
+	// first bytes include request latency and bytes after a pause include encoder wait, neither is timed
+	mLastMs = nowMs;
+	mLastBytes = bytesNow;
+}
+
+/**
+ * @brief Sample whole transfer if nothing was timed
+ */
+void AampTransferSampler::Finish(double bytes, long long nowMs, AampBandwidthEstimator &estimator)
+{
+	if (mStartMs >= 0 && !mActiveMs)
+	{
+		estimator.AddSample(bytes, nowMs - mStartMs, nowMs);
+	}
+	mStartMs = -1;
+}
@@ -0,0 +1,305 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampBandwidthEstimator.h
+ * @brief Incremental network bandwidth estimation for ABR
+ */
+
+#ifndef __AAMP_BANDWIDTH_ESTIMATOR_H__
+#define __AAMP_BANDWIDTH_ESTIMATOR_H__
+
+#include <stddef.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define BANDWIDTH_ESTIMATOR_IDLE_GAP_MS		20		/**< Longer pause between bytes of a chunked transfer is taken as waiting for the encoder */
+#define BANDWIDTH_ESTIMATOR_EWMA_FAST_HALF_LIFE	2.0		/**< Half life in seconds of transfer time of fast EWMA */
+#define BANDWIDTH_ESTIMATOR_EWMA_SLOW_HALF_LIFE	5.0		/**< Half life in seconds of transfer time of slow EWMA */
+#define BANDWIDTH_ESTIMATOR_EWMA_MIN_BYTES	(64*1024)	/**< Bytes needed before EWMA estimate is reported */
+#define BANDWIDTH_ESTIMATOR_WINDOW_SAMPLES	64		/**< Max samples held by sliding window */
+
+/**
+ * @enum AampBandwidthEstimatorType
+ * @brief Bandwidth estimation model, value of bandwidthEstimator config
+ */
+enum AampBandwidthEstimatorType
+{
+	eBANDWIDTH_ESTIMATOR_HYBRID_ABR = 0,	/**< Median and outlier filter of HybridABRManager over cached download samples */
+	eBANDWIDTH_ESTIMATOR_EWMA,		/**< Lower of a fast and a slow exponentially weighted moving average */
+	eBANDWIDTH_ESTIMATOR_SLIDING_WINDOW	/**< Bytes over transfer time of samples within cache life */
+};
+
+/**
+ * @class AampBandwidthModel
+ * @brief Model fed with transfer samples, called with the estimator lock held
+ */
+class AampBandwidthModel
+{
+public:
+	AampBandwidthModel() {}
+	virtual ~AampBandwidthModel() {}
+
+	AampBandwidthModel(const AampBandwidthModel&) = delete;
+	AampBandwidthModel& operator=(const AampBandwidthModel&) = delete;
+
+	/**
+	 * @fn AddSample
+	 * @param[in] bytes - bytes received
+	 * @param[in] durationMs - time the bytes were transferred in, greater than 0
+	 * @param[in] nowMs - steady clock time of sample
+	 * @return estimate in bits per second after this sample, -1 if not enough data yet
+	 */
+	virtual long AddSample(double bytes, double durationMs, long long nowMs) = 0;
+
+	/**
+	 * @fn Reset
+	 * @brief Drop all samples
+	 */
+	virtual void Reset() = 0;
+};
+
+/**
+ * @class AampEwmaBandwidthModel
+ * @brief Two moving averages weighted by transfer time, lower one is reported
+ *
+ * The fast average follows drops quickly, the slow one keeps a short burst from
+ * ramping up. Both are corrected for the zero they start from, so the first samples
+ * after Reset are not biased low.
+ */
+class AampEwmaBandwidthModel : public AampBandwidthModel
+{
+public:
+	/**
+	 * @fn AampEwmaBandwidthModel
+	 * @param[in] fastHalfLife - half life of fast average in seconds
+	 * @param[in] slowHalfLife - half life of slow average in seconds
+	 * @param[in] minBytes - bytes needed before an estimate is reported
+	 */
+	AampEwmaBandwidthModel(double fastHalfLife = BANDWIDTH_ESTIMATOR_EWMA_FAST_HALF_LIFE, double slowHalfLife = BANDWIDTH_ESTIMATOR_EWMA_SLOW_HALF_LIFE, double minBytes = BANDWIDTH_ESTIMATOR_EWMA_MIN_BYTES);
+
+	long AddSample(double bytes, double durationMs, long long nowMs) override;
+	void Reset() override;
+
+private:
+	/**
+	 * @struct Average
+	 * @brief One exponentially weighted moving average
+	 */
+	struct Average
+	{
+		double halfLife;	/**< Seconds of transfer time after which a sample has half its weight */
+		double estimate;	/**< Average, biased towards 0 until enough weight is seen */
+		double totalWeight;	/**< Seconds of transfer time seen */
+
+		void Sample(double weight, double value);
+		double Get() const;
+	};
+
+	Average mFast;
+	Average mSlow;
+	double mMinBytes;
+	double mTotalBytes;
+};
+
+/**
+ * @class AampSlidingWindowBandwidthModel
+ * @brief Bytes over transfer time of the samples received within a time window
+ *
+ * Samples are kept in a fixed ring with running sums, so adding one is O(1)
+ * amortized regardless of window length.
+ */
+class AampSlidingWindowBandwidthModel : public AampBandwidthModel
+{
+public:
+	/**
+	 * @fn AampSlidingWindowBandwidthModel
+	 * @param[in] windowMs - samples older than this are dropped
+	 * @param[in] maxSamples - samples kept at most, oldest is dropped first
+	 */
+	AampSlidingWindowBandwidthModel(long windowMs, size_t maxSamples = BANDWIDTH_ESTIMATOR_WINDOW_SAMPLES);
+
+	long AddSample(double bytes, double durationMs, long long nowMs) override;
+	void Reset() override;
+
+private:
+	/**
+	 * @struct Sample
+	 * @brief One transfer sample held by the window
+	 */
+	struct Sample
+	{
+		long long timeMs;
+		double bytes;
+		double durationMs;
+	};
+
+	/**
+	 * @fn DropOldest
+	 * @return void
+	 */
+	void DropOldest();
+
+	std::vector<Sample> mSamples;
+	size_t mFirst;
+	size_t mCount;
+	long mWindowMs;
+	double mBytes;
+	double mDurationMs;
+};
+
+/**
+ * @class AampBandwidthEstimator
+ * @brief Thread safe holder of the configured model, queried without locking
+ *
+ * Fetcher and curl callback threads add samples under a short lock, each sample
+ * costs O(1). The estimate is published through atomics, so ABR reads it without
+ * taking any lock and without sorting.
+ */
+class AampBandwidthEstimator
+{
+public:
+	/**
+	 * @fn AampBandwidthEstimator
+	 */
+	AampBandwidthEstimator();
+
+	AampBandwidthEstimator(const AampBandwidthEstimator&) = delete;
+	AampBandwidthEstimator& operator=(const AampBandwidthEstimator&) = delete;
+
+	/**
+	 * @fn Configure
+	 * @brief Select model, drops samples
+	 * @param[in] type - AampBandwidthEstimatorType; eBANDWIDTH_ESTIMATOR_HYBRID_ABR disables estimator
+	 * @param[in] maxAgeMs - estimate is not reported once the last sample is older, also sliding window length
+	 * @return void
+	 */
+	void Configure(int type, long maxAgeMs);
+
+	/**
+	 * @fn SetModel
+	 * @brief Install a custom model, drops samples
+	 * @param[in] model - model to use, NULL disables estimator
+	 * @param[in] maxAgeMs - estimate is not reported once the last sample is older
+	 * @return void
+	 */
+	void SetModel(std::unique_ptr<AampBandwidthModel> model, long maxAgeMs);
+
+	/**
+	 * @fn IsEnabled
+	 * @return true if a model is installed
+	 */
+	bool IsEnabled() const { return mEnabled.load(std::memory_order_acquire); }
+
+	/**
+	 * @fn AddSample
+	 * @param[in] bytes - bytes received
+	 * @param[in] durationMs - time the bytes were transferred in, samples of 0 ms are ignored
+	 * @param[in] nowMs - steady clock time of sample
+	 * @return void
+	 */
+	void AddSample(double bytes, long long durationMs, long long nowMs);
+
+	/**
+	 * @fn GetEstimate
+	 * @brief Lock free read of the last published estimate
+	 * @param[in] nowMs - steady clock time
+	 * @return bits per second, -1 if disabled, not enough data or data is too old
+	 */
+	long GetEstimate(long long nowMs) const;
+
+	/**
+	 * @fn Reset
+	 * @brief Drop samples, keeps model
+	 * @return void
+	 */
+	void Reset();
+
+private:
+	std::mutex mMutex;					/**< Serializes writers */
+	std::unique_ptr<AampBandwidthModel> mModel;
+	long mMaxAgeMs;
+	std::atomic<bool> mEnabled;
+	std::atomic<long> mBitsPerSecond;
+	std::atomic<long long> mLastSampleTimeMs;
+};
+
+/**
+ * @class AampTransferSampler
+ * @brief Turns progress of one chunked transfer into samples of active transfer time
+ *
+ * Bytes of a low latency chunk arrive back to back, between chunks the response
+ * waits for the encoder. Intervals between two progress updates that both brought
+ * bytes and are at most idleGapMs apart are sampled; bytes arriving after a longer
+ * pause start a new run and are not timed. A transfer without any timed interval
+ * is sampled once over its whole duration, which can only underestimate.
+ */
+class AampTransferSampler
+{
+public:
+	/**
+	 * @fn AampTransferSampler
+	 * @param[in] idleGapMs - longest pause still taken as active transfer
+	 */
+	AampTransferSampler(long idleGapMs = BANDWIDTH_ESTIMATOR_IDLE_GAP_MS);
+
+	/**
+	 * @fn Start
+	 * @brief Transfer (re)starts from 0 bytes
+	 * @param[in] nowMs - steady clock time
+	 * @return void
+	 */
+	void Start(long long nowMs);
+
+	/**
+	 * @fn OnProgress
+	 * @param[in] bytesNow - bytes received so far by the transfer
+	 * @param[in] nowMs - steady clock time
+	 * @param[in] estimator - receives samples
+	 * @return void
+	 */
+	void OnProgress(double bytesNow, long long nowMs, AampBandwidthEstimator &estimator);
+
+	/**
+	 * @fn Finish
+	 * @brief Transfer completed, samples it whole if no interval was timed
+	 * @param[in] bytes - bytes received by the transfer
+	 * @param[in] nowMs - steady clock time
+	 * @param[in] estimator - receives samples
+	 * @return void
+	 */
+	void Finish(double bytes, long long nowMs, AampBandwidthEstimator &estimator);
+
+	/**
+	 * @fn GetActiveMs
+	 * @return transfer time sampled so far
+	 */
+	long long GetActiveMs() const { return mActiveMs; }
+
+private:
+	long mIdleGapMs;
+	long long mStartMs;		/**< Start of transfer, -1 if not started */
+	long long mLastMs;		/**< Time of last progress update that brought bytes */
+	double mLastBytes;		/**< Bytes received at mLastMs */
+	long long mActiveMs;		/**< Transfer time sampled */
+};
+
+#endif /* __AAMP_BANDWIDTH_ESTIMATOR_H__ */
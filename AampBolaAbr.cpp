@@ -0,0 +1,162 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampBolaAbr.cpp
+ * @brief Buffer occupancy based ABR (BOLA)
+ */
+
+#include "AampBolaAbr.h"
+#include "AampDefine.h"
+#include <math.h>
+#include <algorithm>
+
+/**
+ * @brief AampBolaAbr Constructor
+ */
+AampBolaAbr::AampBolaAbr() : mUtility(), mBufferTargetSec(0), mSteady(false)
+{
+	Configure(DEFAULT_BOLA_UTILITY, DEFAULT_BOLA_BUFFER_TARGET);
+}
+
+/**
+ * @brief Select utility and buffer target
+ */
+void AampBolaAbr::Configure(int utilityType, double bufferTargetSec)
+{
+	if (utilityType == eBOLA_UTILITY_SQRT)
+	{
+		mUtility = [](double bitrateRatio) { return sqrt(bitrateRatio); };
+	}
+	else
+	{
+		mUtility = [](double bitrateRatio) { return log(bitrateRatio); };
+	}
+	mBufferTargetSec = bufferTargetSec;
+	mSteady = false;
+}
+
+/**
+ * @brief Install a custom utility
+ */
+void AampBolaAbr::SetUtility(UtilityFunction utility)
+{
+	if (utility)
+	{
+		mUtility = utility;
+	}
+}
+
+/**
+ * @brief Highest ladder position within a bitrate
+ */
+size_t AampBolaAbr::GetThroughputPosition(const std::vector<AampBolaProfile> &ladder, double bitsPerSecond)
+{
+	size_t position = 0;
+	for (size_t i = 1; i < ladder.size(); i++)
+	{
+		if (ladder[i].bandwidthBitsPerSecond <= bitsPerSecond)
+		{
+			position = i;
+		}
+	}
+	return position;
+}
+
+/**
+ * @brief Choose profile of next fragment
+ */
+int AampBolaAbr::GetProfileIndex(const std::vector<AampBolaProfile> &ladder, int currentProfileIndex, double bufferSec,
+		double fragmentDurationSec, double sizeScale, long throughputBps)
+{
+	if (ladder.empty())
+	{
+		return currentProfileIndex;
+	}
+	size_t top = ladder.size() - 1;
+	size_t currentPosition = 0;
+	for (size_t i = 0; i < ladder.size(); i++)
+	{
+		if (ladder[i].profileIndex == currentProfileIndex)
+		{
+			currentPosition = i;
+			break;
+		}
+	}
+	if (fragmentDurationSec <= 0)
+	{
+		fragmentDurationSec = BOLA_DEFAULT_FRAGMENT_DURATION;
+	}
+	sizeScale = (sizeScale > 0) ? std::min(std::max(sizeScale, BOLA_MIN_SIZE_SCALE), BOLA_MAX_SIZE_SCALE) : 1.0;
+	double minBufferSec = std::max(mBufferTargetSec / BOLA_MIN_BUFFER_RATIO, fragmentDurationSec);
+	double bufferTargetSec = std::max(mBufferTargetSec, minBufferSec + fragmentDurationSec);
+
+	if (!mSteady && bufferSec >= minBufferSec)
+	{
+		mSteady = true;
+	}
+	else if (mSteady && bufferSec < minBufferSec / 2)
+	{
+		mSteady = false;
+	}
+
+	size_t position = top;
+	if (!mSteady)
+	{
+		position = (throughputBps > 0) ? GetThroughputPosition(ladder, throughputBps * BOLA_THROUGHPUT_SAFETY) : currentPosition;
+	}
+	else
+	{
+		double lowest = std::max(ladder[0].bandwidthBitsPerSecond, 1L);
+		double baseUtility = mUtility(1.0);
+		double topUtility = mUtility(ladder[top].bandwidthBitsPerSecond / lowest) - baseUtility + 1;
+		if (topUtility > 1)
+		{
+			// lowest profile is preferred up to minBufferSec, top one from about bufferTargetSec
+			double gamma = (topUtility - 1) / (bufferTargetSec / minBufferSec - 1);
+			double v = minBufferSec / gamma;
+			double bestScore = 0;
+			for (size_t i = 0; i < ladder.size(); i++)
+			{
+				double utility = mUtility(ladder[i].bandwidthBitsPerSecond / lowest) - baseUtility + 1;
+				double sizeBits = std::max(ladder[i].bandwidthBitsPerSecond, 1L) * fragmentDurationSec * sizeScale;
+				double score = (v * (utility + gamma) - bufferSec) / sizeBits;
+				if (i == 0 || score > bestScore)
+				{
+					bestScore = score;
+					position = i;
+				}
+			}
+		}
+		if (throughputBps > 0)
+		{
+			// no upswitch beyond what the network sustains, it would only be reverted
+			if (position > currentPosition)
+			{
+				position = std::max(currentPosition, std::min(position, GetThroughputPosition(ladder, throughputBps)));
+			}
+			// next fragment has to arrive before the buffer drains
+			while (position > 0 && (ladder[position].bandwidthBitsPerSecond * fragmentDurationSec * sizeScale / throughputBps) > bufferSec)
+			{
+				position--;
+			}
+		}
+	}
+	return ladder[position].profileIndex;
+}
@@ -0,0 +1,138 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampBolaAbr.h
+ * @brief Buffer occupancy based ABR (BOLA)
+ */
+
+#ifndef __AAMP_BOLA_ABR_H__
+#define __AAMP_BOLA_ABR_H__
+
+#include <stddef.h>
+#include <functional>
+#include <vector>
+
+#define BOLA_MIN_BUFFER_RATIO		3	/**< Buffer target over buffer at which lowest profile stops being preferred */
+#define BOLA_THROUGHPUT_SAFETY		0.9	/**< Share of throughput used while buffer is low */
+#define BOLA_MIN_SIZE_SCALE		0.5	/**< Bounds of measured over nominal fragment size */
+#define BOLA_MAX_SIZE_SCALE		2.0
+#define BOLA_DEFAULT_FRAGMENT_DURATION	2.0	/**< Fragment duration assumed until one is known */
+
+/**
+ * @enum AampBolaUtilityType
+ * @brief Utility of a bitrate, value of bolaUtility config
+ */
+enum AampBolaUtilityType
+{
+	eBOLA_UTILITY_LOG = 0,		/**< Logarithm of bitrate, each doubling adds the same */
+	eBOLA_UTILITY_SQRT		/**< Square root of bitrate, reaches top profiles at a lower buffer */
+};
+
+/**
+ * @struct AampBolaProfile
+ * @brief Profile eligible for ABR
+ */
+struct AampBolaProfile
+{
+	int profileIndex;		/**< Index passed back as decision */
+	long bandwidthBitsPerSecond;	/**< Nominal bitrate */
+};
+
+/**
+ * @class AampBolaAbr
+ * @brief Picks the profile of the next fragment from the buffer level
+ *
+ * Steady state follows BOLA: the profile maximizing
+ * (V * (utility + gamma) - buffer) / fragmentSize is chosen, with V and gamma derived
+ * from the buffer target, so a low buffer prefers small fragments and a buffer near
+ * the target prefers high utility. Throughput does not drive the choice and its
+ * oscillation causes no switches; it only caps upswitches at what the network
+ * sustains and drops profiles whose next fragment would not arrive before the
+ * buffer drains.
+ *
+ * Until the buffer first reaches target / BOLA_MIN_BUFFER_RATIO, and again after it
+ * falls below half that, the highest profile within BOLA_THROUGHPUT_SAFETY of
+ * throughput is chosen, as the buffer says nothing at startup.
+ */
+class AampBolaAbr
+{
+public:
+	/**
+	 * @brief Utility of a bitrate over the lowest bitrate, must grow with the ratio
+	 *
+	 * It has to grow slower than the ratio, a linear utility only ever picks the
+	 * lowest or the top profile.
+	 */
+	typedef std::function<double(double bitrateRatio)> UtilityFunction;
+
+	/**
+	 * @fn AampBolaAbr
+	 */
+	AampBolaAbr();
+
+	/**
+	 * @fn Configure
+	 * @brief Select utility and buffer target, returns to throughput based startup
+	 * @param[in] utilityType - AampBolaUtilityType
+	 * @param[in] bufferTargetSec - buffer at which top profile is chosen
+	 * @return void
+	 */
+	void Configure(int utilityType, double bufferTargetSec);
+
+	/**
+	 * @fn SetUtility
+	 * @brief Install a custom utility
+	 * @param[in] utility - utility of bitrate ratio
+	 * @return void
+	 */
+	void SetUtility(UtilityFunction utility);
+
+	/**
+	 * @fn GetProfileIndex
+	 * @param[in] ladder - eligible profiles ordered by ascending bitrate
+	 * @param[in] currentProfileIndex - profile of last fragment
+	 * @param[in] bufferSec - buffered duration of the track
+	 * @param[in] fragmentDurationSec - duration of next fragment
+	 * @param[in] sizeScale - measured over nominal size of fragments, 1 if unknown
+	 * @param[in] throughputBps - network bandwidth estimate, -1 if unknown
+	 * @return profileIndex of chosen ladder entry, currentProfileIndex if ladder is empty
+	 */
+	int GetProfileIndex(const std::vector<AampBolaProfile> &ladder, int currentProfileIndex, double bufferSec,
+			double fragmentDurationSec, double sizeScale, long throughputBps);
+
+	/**
+	 * @fn IsSteady
+	 * @return true if buffer drives the choice, false during throughput based startup
+	 */
+	bool IsSteady() const { return mSteady; }
+
+private:
+	/**
+	 * @fn GetThroughputPosition
+	 * @return ladder position of highest profile within bitsPerSecond, 0 if none
+	 */
+	static size_t GetThroughputPosition(const std::vector<AampBolaProfile> &ladder, double bitsPerSecond);
+
+	UtilityFunction mUtility;
+	double mBufferTargetSec;
+	bool mSteady;
+};
+
+#endif /* __AAMP_BOLA_ABR_H__ */
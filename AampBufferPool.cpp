@@ -0,0 +1,214 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampBufferPool.cpp
+ * @brief Size classed buffer pool for fragment downloads
+ */
+
+#include "AampBufferPool.h"
+#include <glib.h>
+#include <string.h>
+
+/**
+ * @brief AampBufferPool Constructor
+ */
+AampBufferPool::AampBufferPool(AampLogManager *logObj, size_t maxPoolBytes) : mMutex(), mFreeBlocks(), mSizeHint(), mMaxPoolBytes(maxPoolBytes), mStats(), mLogObj(logObj)
+{
+}
+
+/**
+ * @brief AampBufferPool Destructor
+ */
+AampBufferPool::~AampBufferPool()
+{
+	Flush();
+}
+
+/**
+ * @brief Get the smallest size class which can hold the requested size
+ */
+int AampBufferPool::GetSizeClassForRequest(size_t size)
+{
+	for (int idx = 0; idx < AAMP_BUFFER_POOL_SIZE_CLASSES; idx++)
+	{
+		if (size <= ((size_t)1 << (AAMP_BUFFER_POOL_MIN_CLASS_SHIFT + idx)))
+		{
+			return idx;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Get the largest size class which fits in given block
+ */
+int AampBufferPool::GetSizeClassForBlock(size_t size)
+{
+	for (int idx = AAMP_BUFFER_POOL_SIZE_CLASSES - 1; idx >= 0; idx--)
+	{
+		if (size >= ((size_t)1 << (AAMP_BUFFER_POOL_MIN_CLASS_SHIFT + idx)))
+		{
+			return idx;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Prepare an empty buffer to receive a download
+ */
+bool AampBufferPool::Acquire(GrowableBuffer *buffer, size_t expectedSize, MediaType type)
+{
+	if (!buffer || buffer->ptr)
+	{
+		return false;
+	}
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (0 == expectedSize && type >= 0 && type < eMEDIATYPE_DEFAULT)
+	{
+		expectedSize = mSizeHint[type];
+	}
+	int sizeClass = GetSizeClassForRequest(expectedSize);
+	char *ptr = NULL;
+	size_t size = 0;
+	if (sizeClass < 0)
+	{ // too large to be pooled
+		size = expectedSize;
+	}
+	else
+	{
+		// a block from the next class up is accepted as well, avoids heap allocation when sizes hover around a class boundary
+		for (int idx = sizeClass; idx < AAMP_BUFFER_POOL_SIZE_CLASSES && idx <= sizeClass + 1; idx++)
+		{
+			if (!mFreeBlocks[idx].empty())
+			{
+				PoolBlock block = mFreeBlocks[idx].back();
+				mFreeBlocks[idx].pop_back();
+				mStats.pooledBytes -= block.size;
+				mStats.reuses++;
+				ptr = block.ptr;
+				size = block.size;
+				break;
+			}
+		}
+		if (!ptr)
+		{
+			size = (size_t)1 << (AAMP_BUFFER_POOL_MIN_CLASS_SHIFT + sizeClass);
+		}
+	}
+	if (!ptr)
+	{
+		ptr = (char *)g_malloc(size);
+		mStats.allocations++;
+	}
+	buffer->ptr = ptr;
+	buffer->len = 0;
+	buffer->avail = size;
+	return true;
+}
+
+/**
+ * @brief Return a buffer's memory to pool
+ */
+void AampBufferPool::Release(GrowableBuffer *buffer, MediaType type)
+{
+	if (!buffer || !buffer->ptr)
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (buffer->len > 0 && type >= 0 && type < eMEDIATYPE_DEFAULT)
+	{
+		mSizeHint[type] = buffer->len;
+	}
+	int sizeClass = GetSizeClassForBlock(buffer->avail);
+	if (sizeClass >= 0 && buffer->avail < ((size_t)2 << AAMP_BUFFER_POOL_MAX_CLASS_SHIFT) && (mStats.pooledBytes + buffer->avail) <= mMaxPoolBytes)
+	{
+		PoolBlock block = { buffer->ptr, buffer->avail };
+		mFreeBlocks[sizeClass].push_back(block);
+		mStats.pooledBytes += buffer->avail;
+		mStats.releases++;
+		if (mStats.pooledBytes > mStats.peakPooledBytes)
+		{
+			mStats.peakPooledBytes = mStats.pooledBytes;
+		}
+	}
+	else
+	{
+		g_free(buffer->ptr);
+		mStats.discards++;
+	}
+	memset(buffer, 0x00, sizeof(GrowableBuffer));
+}
+
+/**
+ * @brief Free blocks until pool is within byte budget
+ */
+void AampBufferPool::TrimLocked()
+{
+	// free the smallest blocks first, large blocks are the expensive ones to re-allocate
+	for (int idx = 0; idx < AAMP_BUFFER_POOL_SIZE_CLASSES && mStats.pooledBytes > mMaxPoolBytes; idx++)
+	{
+		while (!mFreeBlocks[idx].empty() && mStats.pooledBytes > mMaxPoolBytes)
+		{
+			PoolBlock &block = mFreeBlocks[idx].back();
+			mStats.pooledBytes -= block.size;
+			g_free(block.ptr);
+			mFreeBlocks[idx].pop_back();
+		}
+	}
+}
+
+/**
+ * @brief Free all blocks retained by pool
+ */
+void AampBufferPool::Flush()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	for (int idx = 0; idx < AAMP_BUFFER_POOL_SIZE_CLASSES; idx++)
+	{
+		for (PoolBlock &block : mFreeBlocks[idx])
+		{
+			g_free(block.ptr);
+		}
+		mFreeBlocks[idx].clear();
+	}
+	mStats.pooledBytes = 0;
+	memset(mSizeHint, 0x00, sizeof(mSizeHint));
+}
+
+/**
+ * @brief Set maximum bytes retained by pool
+ */
+void AampBufferPool::SetMaxPoolSize(size_t maxPoolBytes)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	mMaxPoolBytes = maxPoolBytes;
+	TrimLocked();
+}
+
+/**
+ * @brief Get copy of pool counters
+ */
+AampBufferPoolStats AampBufferPool::GetStats()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	return mStats;
+}
@@ -0,0 +1,160 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampBufferPool.h
+ * @brief Size classed buffer pool for fragment downloads
+ */
+
+#ifndef __AAMP_BUFFER_POOL_H__
+#define __AAMP_BUFFER_POOL_H__
+
+#include <stddef.h>
+#include <mutex>
+#include <vector>
+#include "AampMemoryUtils.h"
+#include "AampMediaType.h"
+#include "AampLogManager.h"
+
+#define AAMP_BUFFER_POOL_MIN_CLASS_SHIFT	16	/**< Smallest size class, 64KB */
+#define AAMP_BUFFER_POOL_MAX_CLASS_SHIFT	24	/**< Largest size class, 16MB */
+#define AAMP_BUFFER_POOL_SIZE_CLASSES		(AAMP_BUFFER_POOL_MAX_CLASS_SHIFT - AAMP_BUFFER_POOL_MIN_CLASS_SHIFT + 1)
+
+/**
+ * @struct AampBufferPoolStats
+ * @brief Counters reported by the fragment buffer pool
+ */
+struct AampBufferPoolStats
+{
+	unsigned long allocations;	/**< Number of blocks allocated from heap */
+	unsigned long reuses;		/**< Number of requests served from pool */
+	unsigned long releases;		/**< Number of blocks returned to pool */
+	unsigned long discards;		/**< Number of blocks freed on release as pool was full or block unsuitable */
+	size_t pooledBytes;		/**< Bytes currently held by pool */
+	size_t peakPooledBytes;		/**< Maximum bytes held by pool */
+
+	AampBufferPoolStats() : allocations(0), reuses(0), releases(0), discards(0), pooledBytes(0), peakPooledBytes(0)
+	{
+	}
+};
+
+/**
+ * @class AampBufferPool
+ * @brief Recycles fragment download buffers in power of two size classes
+ *
+ * Blocks are allocated with g_malloc, so a buffer obtained from the pool is a regular
+ * GrowableBuffer which can still be grown with aamp_AppendBytes or freed with aamp_Free.
+ * The pool is owned through a shared_ptr by the player instance; holders of buffers that
+ * outlive a track (e.g. sink side consumers) can keep a reference to return them later.
+ */
+class AampBufferPool
+{
+public:
+	/**
+	 * @fn AampBufferPool
+	 * @param[in] logObj - log object
+	 * @param[in] maxPoolBytes - maximum bytes retained by pool for reuse
+	 */
+	AampBufferPool(AampLogManager *logObj, size_t maxPoolBytes);
+
+	/**
+	 * @fn ~AampBufferPool
+	 */
+	~AampBufferPool();
+
+	AampBufferPool(const AampBufferPool&) = delete;
+	AampBufferPool& operator=(const AampBufferPool&) = delete;
+
+	/**
+	 * @fn Acquire
+	 * @brief Prepare an empty buffer to receive a download
+	 *
+	 * @param[out] buffer - empty growable buffer to be populated
+	 * @param[in] expectedSize - expected size (Content-Length), 0 if not known
+	 * @param[in] type - media type, used to look up previous fragment size if size is not known
+	 * @return true if a block was assigned
+	 */
+	bool Acquire(GrowableBuffer *buffer, size_t expectedSize, MediaType type);
+
+	/**
+	 * @fn Release
+	 * @brief Return a buffer's memory to pool, buffer is reset on return
+	 *
+	 * @param[in,out] buffer - buffer allocated either from pool or with g_malloc
+	 * @param[in] type - media type, used to remember fragment size for next Acquire
+	 */
+	void Release(GrowableBuffer *buffer, MediaType type);
+
+	/**
+	 * @fn Flush
+	 * @brief Free all blocks retained by pool
+	 */
+	void Flush();
+
+	/**
+	 * @fn SetMaxPoolSize
+	 * @param[in] maxPoolBytes - maximum bytes retained by pool for reuse
+	 */
+	void SetMaxPoolSize(size_t maxPoolBytes);
+
+	/**
+	 * @fn GetStats
+	 * @return copy of pool counters
+	 */
+	AampBufferPoolStats GetStats();
+
+private:
+	/**
+	 * @brief Block retained for reuse
+	 */
+	struct PoolBlock
+	{
+		char *ptr;
+		size_t size;
+	};
+
+	/**
+	 * @fn GetSizeClassForRequest
+	 * @param[in] size - requested size
+	 * @return index of smallest class that holds size, -1 if larger than all classes
+	 */
+	static int GetSizeClassForRequest(size_t size);
+
+	/**
+	 * @fn GetSizeClassForBlock
+	 * @param[in] size - block size
+	 * @return index of largest class that fits in block, -1 if block is smaller than all classes
+	 */
+	static int GetSizeClassForBlock(size_t size);
+
+	/**
+	 * @fn TrimLocked
+	 * @brief Free blocks until pool is within byte budget, called with mMutex held
+	 */
+	void TrimLocked();
+
+	std::mutex mMutex;
+	std::vector<PoolBlock> mFreeBlocks[AAMP_BUFFER_POOL_SIZE_CLASSES];
+	size_t mSizeHint[eMEDIATYPE_DEFAULT];	/**< Size of last released buffer per media type */
+	size_t mMaxPoolBytes;
+	AampBufferPoolStats mStats;
+	AampLogManager *mLogObj;
+};
+
+#endif /* __AAMP_BUFFER_POOL_H__ */
@@ -26,11 +26,12 @@
 
 
 /**
- *  @brief Retrieve playlist from cache  
+ *  @brief Insert playlist into cache
  */
 void AampCacheHandler::InsertToPlaylistCache(const std::string url, const GrowableBuffer* buffer, std::string effectiveUrl,bool trackLiveStatus,MediaType fileType)
 {
-	PlayListCachedData *tmpData,*newtmpData;
+	bool store = false;
+	std::shared_ptr<AampDiskCache> diskCache;
 	pthread_mutex_lock(&mMutex);
 
 	//Initialize AampCacheHandler
@@ -40,99 +41,124 @@ void AampCacheHandler::InsertToPlaylistCache(const std::string url, const Growab
 	// For Main manifest , fileType will bypass storing for live content
 	if(trackLiveStatus==false || fileType==eMEDIATYPE_MANIFEST)
 	{
-
-		PlaylistCacheIter it = mPlaylistCache.find(url);
-		if (it != mPlaylistCache.end())
+		store = !mPlaylistCache.Contains(url);
+		if(!store)
 		{
 			AAMPLOG_INFO("playlist %s already present in cache", url.c_str());
 		}
-		// insert only if buffer size is less than Max size
-		else
+		diskCache = mDiskCache;
+	}
+	pthread_mutex_unlock(&mMutex);
+
+	if(store)
+	{
+		// Copy is taken without lock, readers of other playlists are not held up by it
+		AampCachedFilePtr file = std::make_shared<AampCachedFile>(buffer->ptr, buffer->len, effectiveUrl, fileType);
+		pthread_mutex_lock(&mMutex);
+		InsertPlaylistEntry(url, file);
+		pthread_mutex_unlock(&mMutex);
+		// Main manifest is fetched again on every tune, only VOD playlists are kept across restart
+		if(diskCache && trackLiveStatus==false && fileType!=eMEDIATYPE_MANIFEST)
 		{
-			if(fileType==eMEDIATYPE_MANIFEST && mPlaylistCache.size())
-			{
-				// If new Manifest is inserted which is not present in the cache , flush out other playlist files related with old manifest,
-				ClearPlaylistCache();
-			}
-			// Dont check for CacheSize if Max is configured as unlimited 
-			if(mMaxPlaylistCacheSize == PLAYLIST_CACHE_SIZE_UNLIMITED || (mMaxPlaylistCacheSize != PLAYLIST_CACHE_SIZE_UNLIMITED  && buffer->len < mMaxPlaylistCacheSize))
-			{
-				// Before inserting into cache, need to check if max cache size will exceed or not on adding new data
-				// if more , need to pop out some from same type of playlist
-				bool cacheStoreReady = true;
-				if(mMaxPlaylistCacheSize != PLAYLIST_CACHE_SIZE_UNLIMITED  && ((mCacheStoredSize + buffer->len) > mMaxPlaylistCacheSize))
-				{
-					AAMPLOG_WARN("Count[%d]Avail[%d]Needed[%d] Reached max cache size ",mPlaylistCache.size(),mCacheStoredSize,buffer->len);
-					cacheStoreReady = AllocatePlaylistCacheSlot(fileType,buffer->len);
-				}
-				if(cacheStoreReady)
-				{
-					tmpData = new PlayListCachedData();
-					tmpData->mCachedBuffer = new GrowableBuffer();
-					memset (tmpData->mCachedBuffer, 0, sizeof(GrowableBuffer));
-					aamp_AppendBytes(tmpData->mCachedBuffer, buffer->ptr, buffer->len );
-
-					tmpData->mEffectiveUrl = effectiveUrl;
-					tmpData->mFileType = fileType;
-					mPlaylistCache[url] = tmpData;
-					mCacheStoredSize += buffer->len;
-					AAMPLOG_INFO("Inserted. url %s", url.c_str());
-					// There are cases where Main url and effective url will be different ( for Main manifest)
-					// Need to store both the entries with same content data 
-					// When retune happens within aamp due to failure , effective url wll be asked to read from cached manifest
-					// When retune happens from JS , regular Main url will be asked to read from cached manifest. 
-					// So need to have two entries in cache table but both pointing to same CachedBuffer (no space is consumed for storage)
-					{						
-						// if n only there is diff in url , need to store both
-						if(url != effectiveUrl)
-						{
-							newtmpData = new PlayListCachedData();
-							// Not to allocate for Cachebuffer again , use the same buffer as above
-							newtmpData->mCachedBuffer = tmpData->mCachedBuffer;
-							newtmpData->mEffectiveUrl = effectiveUrl;
-							// This is a duplicate entry
-							newtmpData->mDuplicateEntry = true;
-							newtmpData->mFileType = fileType;
-							mPlaylistCache[effectiveUrl] = newtmpData;
-							AAMPLOG_INFO("Added an effective url entry %s", effectiveUrl.c_str());
-						}
-					}
-				}
-			}
+			diskCache->Insert(url, "", effectiveUrl, fileType, buffer->ptr, buffer->len, time(NULL));
 		}
 	}
-	pthread_mutex_unlock(&mMutex);
 }
 
+/**
+ *  @brief Add playlist to in memory cache
+ */
+void AampCacheHandler::InsertPlaylistEntry(const std::string &url, const AampCachedFilePtr &file)
+{
+	if(mPlaylistCache.Contains(url))
+	{
+		AAMPLOG_INFO("playlist %s already present in cache", url.c_str());
+		return;
+	}
+	if(file->type==eMEDIATYPE_MANIFEST && mPlaylistCache.GetCount())
+	{
+		// If new Manifest is inserted which is not present in the cache , flush out other playlist files related with old manifest,
+		ClearPlaylistCache();
+	}
+	// Main url and effective url both map to the same cached file, so that retune from JS
+	// and internal retune after failure can both read the cached manifest
+	if(mPlaylistCache.Insert(url, file))
+	{
+		AAMPLOG_INFO("Inserted. url %s", url.c_str());
+	}
+	else
+	{
+		AAMPLOG_WARN("Count[%zu]Stored[%zu]Needed[%zu] Exceeds max cache size", mPlaylistCache.GetCount(), mPlaylistCache.GetTotalBytes(), file->data.size());
+	}
+}
 
 /**
  *  @brief Retrieve playlist from cache
  */
 bool AampCacheHandler::RetrieveFromPlaylistCache(const std::string url, GrowableBuffer* buffer, std::string& effectiveUrl)
 {
-	GrowableBuffer* buf = NULL;
-	bool ret; 
-	std::string eUrl;
+	return CopyCachedFile(BorrowFromPlaylistCache(url), buffer, effectiveUrl);
+}
+
+/**
+ *  @brief Cached playlist without copy
+ */
+AampCachedFilePtr AampCacheHandler::BorrowFromPlaylistCache(const std::string &url)
+{
 	pthread_mutex_lock(&mMutex);
-	PlaylistCacheIter it = mPlaylistCache.find(url);
-	if (it != mPlaylistCache.end())
+	AampCachedFilePtr file = mPlaylistCache.Find(url);
+	if(file)
 	{
-		PlayListCachedData *tmpData = it->second;
-		buf = tmpData->mCachedBuffer;
-		eUrl = tmpData->mEffectiveUrl;
-		buffer->len = 0;
-		aamp_AppendBytes(buffer, buf->ptr, buf->len );
-		effectiveUrl = eUrl;
 		AAMPLOG_TRACE("url %s found", url.c_str());
-		ret = true;
+	}
+	else if(mDiskCache)
+	{
+		file = RetrieveFromDiskCache(url);
+		if(file)
+		{
+			Init();
+			InsertPlaylistEntry(url, file);
+		}
 	}
 	else
 	{
 		AAMPLOG_TRACE("url %s not found", url.c_str());
-		ret = false;
 	}
 	pthread_mutex_unlock(&mMutex);
-	return ret;
+	return file;
+}
+
+/**
+ *  @brief Copy borrowed file to caller buffer
+ */
+bool AampCacheHandler::CopyCachedFile(const AampCachedFilePtr &file, GrowableBuffer* buffer, std::string& effectiveUrl)
+{
+	if(!file)
+	{
+		return false;
+	}
+	// file is immutable, no lock needed while copying
+	buffer->len = 0;
+	aamp_AppendBytes(buffer, file->data.data(), file->data.size());
+	effectiveUrl = file->effectiveUrl;
+	return true;
+}
+
+/**
+ *  @brief Read file from persistent tier
+ */
+AampCachedFilePtr AampCacheHandler::RetrieveFromDiskCache(const std::string &url)
+{
+	std::vector<char> data;
+	std::string effectiveUrl;
+	int type = eMEDIATYPE_DEFAULT;
+	if(!mDiskCache->Retrieve(url, data, effectiveUrl, type, NULL, time(NULL), mDiskCacheMaxAge))
+	{
+		AAMPLOG_TRACE("url %s not found", url.c_str());
+		return NULL;
+	}
+	AAMPLOG_INFO("url %s found in persistent cache", url.c_str());
+	return std::make_shared<AampCachedFile>(std::move(data), effectiveUrl, type);
 }
 
 /**
@@ -141,24 +167,18 @@ bool AampCacheHandler::RetrieveFromPlaylistCache(const std::string url, Growable
 void AampCacheHandler::RemoveFromPlaylistCache(const std::string url)
 {
 	pthread_mutex_lock(&mMutex);
-	PlaylistCacheIter it = mPlaylistCache.find(url);
-	if (it != mPlaylistCache.end())
+	if(mPlaylistCache.Remove(url))
 	{
-		PlayListCachedData *tmpData = it->second;
-		if(!tmpData->mDuplicateEntry)
-		{
-			aamp_Free(tmpData->mCachedBuffer);
-			SAFE_DELETE(tmpData->mCachedBuffer);
-		}
-		SAFE_DELETE(tmpData);
-
-		AAMPLOG_INFO("Removing Playlist URL %s from Cache", it->first.c_str());
-		mPlaylistCache.erase(it);
+		AAMPLOG_INFO("Removing Playlist URL %s from Cache", url.c_str());
 	}
 	else
 	{
 		AAMPLOG_WARN("Playlist URL %s not found in cache", url.c_str());
 	}
+	if(mDiskCache)
+	{
+		mDiskCache->Remove(url);
+	}
 	pthread_mutex_unlock(&mMutex);
 }
 
@@ -167,91 +187,8 @@ void AampCacheHandler::RemoveFromPlaylistCache(const std::string url)
  */
 void AampCacheHandler::ClearPlaylistCache()
 {
-	AAMPLOG_INFO("cache size %d", (int)mPlaylistCache.size());
-	PlaylistCacheIter it = mPlaylistCache.begin();
-	for (;it != mPlaylistCache.end(); it++)
-	{
-		PlayListCachedData *tmpData = it->second;
-		if(!tmpData->mDuplicateEntry)
-		{
-			aamp_Free(tmpData->mCachedBuffer);
-			SAFE_DELETE(tmpData->mCachedBuffer);
-		}
-		SAFE_DELETE(tmpData);
-	}
-	mCacheStoredSize = 0;
-	mPlaylistCache.clear();
-}
-
-/**
- *  @brief AllocatePlaylistCacheSlot Allocate Slot for adding new playlist
- */
-bool AampCacheHandler::AllocatePlaylistCacheSlot(MediaType fileType,size_t newLen)
-{
-	bool retVal = true;
-	size_t freedSize=0;
-	if(mPlaylistCache.size())
-	{
-		if(fileType == eMEDIATYPE_MANIFEST)
-		{
-			// This case cannot happen, but for safety need to handle.
-			// If for any reason Main Manifest is pushed after cache is full , better clear all the playlist cached .
-			// As per new Main Manifest  ,new  playlist files need to be downloaded and cached
-			ClearPlaylistCache();
-		}
-		else // for non main manifest
-		{
-		PlaylistCacheIter Iter = mPlaylistCache.begin();
-		// Two pass to remove the item from cache to create space for caching
-		// First pass : Search for same file type to clean, If Video need to be inserted , free another Video type
-		// 				if audio type to be inserted , remove older audio type . Same for iframe .
-		// Second pass : Even after removing same file type entry ,still not enough space to add new item then remove from other file type ( rare scenario)
-		while(Iter != mPlaylistCache.end())
-		{
-			PlayListCachedData *tmpData = Iter->second;
-			if(tmpData->mFileType == eMEDIATYPE_MANIFEST || tmpData->mFileType != fileType)
-			{ 	// Not to remove main manifest file and filetype which are different
-				Iter++;
-				continue;
-			}
-			if(!tmpData->mDuplicateEntry)
-			{
-				freedSize += tmpData->mCachedBuffer->len;
-				aamp_Free(tmpData->mCachedBuffer);
-				SAFE_DELETE(tmpData->mCachedBuffer);
-			}
-			SAFE_DELETE(tmpData);
-			Iter = mPlaylistCache.erase(Iter);
-		}
-		//Second Pass - if still more cleanup required for space, remove  from other playlist types
-		if(freedSize < newLen)
-		{
-			Iter = mPlaylistCache.begin();
-			while(Iter != mPlaylistCache.end())
-			{
-				PlayListCachedData *tmpData = Iter->second;
-				if(tmpData->mFileType == eMEDIATYPE_MANIFEST)
-				{ 	// Not to remove main manifest file
-					Iter++;
-					continue;
-				}
-				if(!tmpData->mDuplicateEntry)
-				{
-					freedSize += tmpData->mCachedBuffer->len;
-					aamp_Free(tmpData->mCachedBuffer);
-					SAFE_DELETE(tmpData->mCachedBuffer);
-				}
-				SAFE_DELETE(tmpData);
-				Iter = mPlaylistCache.erase(Iter);
-			}
-		}
-		mCacheStoredSize -= freedSize;
-		// After all freeing still size is not enough to insert , better not allow to insert such huge file
-		if(freedSize < newLen)
-			retVal = false;
-		}
-	}
-	return retVal;
+	AAMPLOG_INFO("cache size %d", (int)mPlaylistCache.GetCount());
+	mPlaylistCache.Clear();
 }
 
 
@@ -303,7 +240,7 @@ void AampCacheHandler::ClearCacheHandler()
 	}
 	ClearPlaylistCache();
 
-	//Clear init fragment & track queue
+	//Clear init fragment cache
 	ClearInitFragCache();
 	mInitialized = false;
 }
@@ -312,17 +249,22 @@ void AampCacheHandler::ClearCacheHandler()
  *  @brief Default Constructor
  */
 AampCacheHandler::AampCacheHandler(AampLogManager *logObj):
-	mCacheStoredSize(0),mAsyncThreadStartedFlag(false),mAsyncCleanUpTaskThreadId(0),mCacheActive(false),
+	mAsyncThreadStartedFlag(false),mAsyncCleanUpTaskThreadId(0),mCacheActive(false),
 	mAsyncCacheCleanUpThread(false),mMutex(),mCondVarMutex(),mCondVar(),mPlaylistCache()
 	,mMaxPlaylistCacheSize(MAX_PLAYLIST_CACHE_SIZE*1024),mInitialized(false)
 	,mLogObj(logObj)
-	,umInitFragCache(),umCacheTrackQ(),bInitFragCache(false),mInitFragMutex()
-	,MaxInitCacheSlot(MAX_INIT_FRAGMENT_CACHE_PER_TRACK)
+	,mInitFragCache(),mInitFragMutex()
+	,MaxInitCacheSlot(MAX_INIT_FRAGMENT_CACHE_PER_TRACK),mDiskCache(),mDiskCacheMaxAge(0)
 {
 	pthread_mutex_init(&mMutex, NULL);
 	pthread_mutex_init(&mCondVarMutex, NULL);
 	pthread_cond_init(&mCondVar, NULL);
 
+	mPlaylistCache.SetTotalBudget(mMaxPlaylistCacheSize);
+	// Not to remove main manifest file to make room for other playlists
+	mPlaylistCache.SetTypeBudget(eMEDIATYPE_MANIFEST, AAMP_LRU_CACHE_UNLIMITED, AAMP_LRU_CACHE_UNLIMITED, true);
+	mInitFragCache.SetDefaultBudget(MAX_INIT_FRAGMENT_CACHE_SIZE_PER_TRACK*1024, MaxInitCacheSlot);
+
 	pthread_mutex_init(&mInitFragMutex, NULL);
 }
 
@@ -380,10 +322,17 @@ void AampCacheHandler::AsyncCacheCleanUpTask()
 			if(ETIMEDOUT == pthread_cond_timedwait(&mCondVar, &mCondVarMutex, &ts))
 			{
 				AAMPLOG_INFO("[%p] Cacheflush timed out", this);
+				// Cache locks are taken without mCondVarMutex held, Init() locks them the other way round
+				pthread_mutex_unlock(&mCondVarMutex);
+				pthread_mutex_lock(&mMutex);
 				ClearPlaylistCache();
+				pthread_mutex_unlock(&mMutex);
 
-				//Clear init fragment & track queue
+				//Clear init fragment cache
+				pthread_mutex_lock(&mInitFragMutex);
 				ClearInitFragCache();
+				pthread_mutex_unlock(&mInitFragMutex);
+				pthread_mutex_lock(&mCondVarMutex);
 			}
 		}
 	}
@@ -397,6 +346,7 @@ void AampCacheHandler::SetMaxPlaylistCacheSize(int maxPlaylistCacheSz)
 {
 	pthread_mutex_lock(&mMutex);
 	mMaxPlaylistCacheSize = maxPlaylistCacheSz;
+	mPlaylistCache.SetTotalBudget((maxPlaylistCacheSz == PLAYLIST_CACHE_SIZE_UNLIMITED) ? AAMP_LRU_CACHE_UNLIMITED : (size_t)maxPlaylistCacheSz);
 	AAMPLOG_WARN("Setting mMaxPlaylistCacheSize to :%d",maxPlaylistCacheSz);
 	pthread_mutex_unlock(&mMutex);	
 }
@@ -408,9 +358,7 @@ bool AampCacheHandler::IsUrlCached(std::string url)
 {
 	bool retval = false;
 	pthread_mutex_lock(&mMutex);
-	PlaylistCacheIter it = mPlaylistCache.find(url);
-	if (it != mPlaylistCache.end())
-		retval = true;
+	retval = mPlaylistCache.Contains(url);
 
 	pthread_mutex_unlock(&mMutex);
 	return retval;
@@ -418,86 +366,57 @@ bool AampCacheHandler::IsUrlCached(std::string url)
 
 
 /**
- *  @brief Insert init fragment into cache table
+ *  @brief Insert init fragment into cache table, taking over the buffer memory
  */
-void AampCacheHandler::InsertToInitFragCache(const std::string url, const GrowableBuffer* buffer,
-						std::string effectiveUrl, MediaType fileType)
+AampCachedFilePtr AampCacheHandler::InsertToInitFragCache(const std::string url, GrowableBuffer* buffer,
+						std::string effectiveUrl, MediaType fileType, const std::string &validator)
 {
-	InitFragCacheStruct *NewInitData;
-	InitFragTrackStruct *NewTrackQueueCache;
-
+	if(!buffer->ptr)
+	{
+		return nullptr;
+	}
 	pthread_mutex_lock(&mInitFragMutex);
-
-	InitFragCacheIter Iter = umInitFragCache.find(url);
-	if ( Iter != umInitFragCache.end() )
+	AampCachedFilePtr file = mInitFragCache.Find(url);
+	std::shared_ptr<AampDiskCache> diskCache = mDiskCache;
+	pthread_mutex_unlock(&mInitFragMutex);
+	if(file)
 	{
 		AAMPLOG_INFO("playlist %s already present in cache", url.c_str());
+		aamp_Free(buffer);
+		memset(buffer, 0x00, sizeof(GrowableBuffer));
+		return file;
 	}
-	else
-	{
-		NewInitData = new playlistcacheddata();
-		NewInitData->mCachedBuffer = new GrowableBuffer();
-		memset (NewInitData->mCachedBuffer, 0, sizeof(GrowableBuffer));
-		aamp_AppendBytes(NewInitData->mCachedBuffer, buffer->ptr, buffer->len );
-
-		NewInitData->mEffectiveUrl = effectiveUrl;
-		NewInitData->mFileType = fileType;
-		NewInitData->mDuplicateEntry = (effectiveUrl.length() && (effectiveUrl!=url));
-
-		/* 
-		 * Check if queue created for given track type, if not create a queue
-		 * and add a corresponding url into a track queue.
-		 */
-		CacheTrackQueueIter IterCq = umCacheTrackQ.find(fileType);
-		if(IterCq == umCacheTrackQ.end())
-		{
-			NewTrackQueueCache = new initfragtrackstruct();
-			NewTrackQueueCache->Trackqueue.push(url);
 
-			umCacheTrackQ[fileType]=NewTrackQueueCache;
-		}
-		else
-		{
-			NewTrackQueueCache = IterCq->second;
-			NewTrackQueueCache->Trackqueue.push(url);
-		}
-
-
-		/* 
-		 * If track queue of given filetype reached maximum limit, remove the very first
-		 * inserted entry & its duplicate entry from cache table.
-		 */
-		if ( NewTrackQueueCache->Trackqueue.size() > MaxInitCacheSlot )
-		{
-			RemoveInitFragCacheEntry ( fileType );
-		}
-
-		umInitFragCache[url] = NewInitData;
+	// download buffer is g_malloc'd, the cached file g_frees it once the last borrower is done
+	file = std::make_shared<AampCachedFile>(buffer->ptr, buffer->len, g_free, effectiveUrl, fileType);
+	memset(buffer, 0x00, sizeof(GrowableBuffer));
+	pthread_mutex_lock(&mInitFragMutex);
+	// Least recently used init fragment of same track is removed on exceeding limit, with its effective url entry
+	if(mInitFragCache.Insert(url, file))
+	{
 		AAMPLOG_INFO("Inserted init url %s", url.c_str());
+	}
+	AAMPLOG_INFO("Size [CacheTable:%zu,CurrentTrack:%zu bytes,MaxLimit:%d]", mInitFragCache.GetCount(),
+					mInitFragCache.GetTypeBytes(fileType), MaxInitCacheSlot);
+	pthread_mutex_unlock(&mInitFragMutex);
 
-
-		/* 
-		 * If current init fragment has any redirected url which is different, that must be
-		 * inserted in cache table with same init fragment data of url and which will not inserted in track queue.
-		 */
-		if ( NewInitData->mDuplicateEntry )
-		{
-			InitFragCacheStruct *DupInitData;
-			DupInitData = new playlistcacheddata();
-			DupInitData->mCachedBuffer = NewInitData->mCachedBuffer;
-			DupInitData->mEffectiveUrl = effectiveUrl;
-			DupInitData->mFileType = fileType;
-			umInitFragCache[effectiveUrl] = DupInitData;
-	
-			AAMPLOG_INFO("Inserted effective init url %s", url.c_str());
-		}
-
-		AAMPLOG_INFO("Size [CacheTable:%d,TrackQ:%d,CurrentTrack:%d,MaxLimit:%d]\n", umInitFragCache.size(),umCacheTrackQ.size(),
-						NewTrackQueueCache->Trackqueue.size(),
-						MaxInitCacheSlot );
+	if(diskCache)
+	{
+		diskCache->Insert(url, validator, effectiveUrl, fileType, file->data.data(), file->data.size(), time(NULL));
 	}
+	return file;
+}
 
+/**
+ *  @brief Check if init fragment is in cache
+ */
+bool AampCacheHandler::IsInitFragmentCached(const std::string &url)
+{
+	bool retval = false;
+	pthread_mutex_lock(&mInitFragMutex);
+	retval = mInitFragCache.Contains(url);
 	pthread_mutex_unlock(&mInitFragMutex);
+	return retval;
 }
 
 /**
@@ -506,110 +425,43 @@ void AampCacheHandler::InsertToInitFragCache(const std::string url, const Growab
 bool AampCacheHandler::RetrieveFromInitFragCache(const std::string url, GrowableBuffer* buffer,
 									std::string& effectiveUrl)
 {
-	GrowableBuffer* buf = NULL;
-	bool ret;
-	std::string eUrl;
-	pthread_mutex_lock(&mInitFragMutex);
-	InitFragCacheIter it = umInitFragCache.find(url);
-	if (it != umInitFragCache.end())
-	{
-		InitFragCacheStruct *findFragData = it->second;
-		buf = findFragData->mCachedBuffer;
-		eUrl = findFragData->mEffectiveUrl;
-		buffer->len = 0;
-		aamp_AppendBytes(buffer, buf->ptr, buf->len );
-		effectiveUrl = eUrl;
-		AAMPLOG_INFO("url %s found", url.c_str());
-		ret = true;
-	}
-	else
-	{
-		AAMPLOG_INFO("url %s not found", url.c_str());
-		ret = false;
-	}
-	pthread_mutex_unlock(&mInitFragMutex);
-	return ret;
+	return CopyCachedFile(BorrowFromInitFragCache(url), buffer, effectiveUrl);
 }
 
 /**
- *  @brief Removes very first inserted entry ( and duplicate entry, if present)  of given filetype
- *         from fragment cache table in FIFO order, also removes the corresponding url from track queue.
- */ 
-void AampCacheHandler::RemoveInitFragCacheEntry ( MediaType fileType )
+ *  @brief Cached init fragment without copy
+ */
+AampCachedFilePtr AampCacheHandler::BorrowFromInitFragCache(const std::string &url)
 {
-	CacheTrackQueueIter IterCq = umCacheTrackQ.find(fileType);
-	if(IterCq == umCacheTrackQ.end())
+	pthread_mutex_lock(&mInitFragMutex);
+	AampCachedFilePtr file = mInitFragCache.Find(url);
+	if(file)
 	{
-		return;
+		AAMPLOG_INFO("url %s found", url.c_str());
 	}
-
-	InitFragTrackStruct *QueperTrack = IterCq->second;
-
-	/* Delete data in FIFO order
-	 * Get url from Track Queue, which is used to
-	 * remove fragment entry from cache table in FIFO order.
-	 */
-	InitFragCacheIter Iter = umInitFragCache.find(QueperTrack->Trackqueue.front());
-	if (Iter != umInitFragCache.end())
+	else if(mDiskCache)
 	{
-		InitFragCacheStruct *removeCacheData = Iter->second;
-
-		/* Remove duplicate entry
-		 * Check if the first inserted data has any duplicate entry, If so
-		 * then delete the duplicat entry as well.
-		 */
-		if ( removeCacheData->mDuplicateEntry )
+		file = RetrieveFromDiskCache(url);
+		if(file)
 		{
-			InitFragCacheStruct *dupData;
-			InitFragCacheIter IterDup = umInitFragCache.find(removeCacheData->mEffectiveUrl);
-			if(IterDup != umInitFragCache.end())
-			{
-				dupData = IterDup->second;
-				SAFE_DELETE(dupData);
-				umInitFragCache.erase(IterDup);
-				AAMPLOG_INFO("Removed dup url:%s",removeCacheData->mEffectiveUrl.c_str());
-			}
+			mInitFragCache.Insert(url, file);
 		}
-		aamp_Free(removeCacheData->mCachedBuffer);
-		SAFE_DELETE(removeCacheData->mCachedBuffer);
-		SAFE_DELETE(removeCacheData);
-		umInitFragCache.erase(Iter);
-		AAMPLOG_INFO("Removed main url:%s",QueperTrack->Trackqueue.front().c_str());
-
-		// Remove the url entry from corresponding track queue.
-		QueperTrack->Trackqueue.pop();
 	}
+	else
+	{
+		AAMPLOG_INFO("url %s not found", url.c_str());
+	}
+	pthread_mutex_unlock(&mInitFragMutex);
+	return file;
 }
 
 /**
- *  @brief Clear init fragment cache & track queue table
+ *  @brief Clear init fragment cache
  */
 void AampCacheHandler::ClearInitFragCache()
 {
-	AAMPLOG_INFO("Fragment cache size %d", (int)umInitFragCache.size());
-	InitFragCacheIter it = umInitFragCache.begin();
-	for (;it != umInitFragCache.end(); it++)
-	{
-		InitFragCacheStruct *delData = it->second;
-		if(!delData->mDuplicateEntry)
-		{
-			aamp_Free(delData->mCachedBuffer);
-			SAFE_DELETE(delData->mCachedBuffer);
-		}
-		SAFE_DELETE(delData);
-	}
-	umInitFragCache.clear();
-
-	AAMPLOG_INFO("Track queue size %d", (int)umCacheTrackQ.size());
-	CacheTrackQueueIter IterCq = umCacheTrackQ.begin();
-	for (;IterCq != umCacheTrackQ.end(); IterCq++)
-	{
-		InitFragTrackStruct *delTrack = IterCq->second;
-
-		std::queue<std::string>().swap(delTrack->Trackqueue);
-		SAFE_DELETE(delTrack);
-	}
-	umCacheTrackQ.clear();
+	AAMPLOG_INFO("Fragment cache size %d", (int)mInitFragCache.GetCount());
+	mInitFragCache.Clear();
 }
 
 /**
@@ -619,6 +471,30 @@ void AampCacheHandler::SetMaxInitFragCacheSize(int maxInitFragCacheSz)
 {
 	pthread_mutex_lock(&mInitFragMutex);
 	MaxInitCacheSlot = maxInitFragCacheSz;
+	mInitFragCache.SetDefaultBudget(MAX_INIT_FRAGMENT_CACHE_SIZE_PER_TRACK*1024, maxInitFragCacheSz);
 	AAMPLOG_WARN("Setting mMaxPlaylistCacheSize to :%d",maxInitFragCacheSz);
 	pthread_mutex_unlock(&mInitFragMutex);	
 }
+
+/**
+ *  @brief Configure persistent tier
+ */
+void AampCacheHandler::SetPersistentCache(const std::string &path, int maxSizeKB, int maxAgeSec)
+{
+	std::shared_ptr<AampDiskCache> diskCache;
+	if(!path.empty() && maxSizeKB > 0)
+	{
+		// store is shared by player instances, it is opened once per process
+		diskCache = AampDiskCache::Acquire(path, (size_t)maxSizeKB*1024);
+		if(!diskCache)
+		{
+			AAMPLOG_WARN("Persistent cache %s not available", path.c_str());
+		}
+	}
+	pthread_mutex_lock(&mMutex);
+	pthread_mutex_lock(&mInitFragMutex);
+	mDiskCache = diskCache;
+	mDiskCacheMaxAge = maxAgeSec;
+	pthread_mutex_unlock(&mInitFragMutex);
+	pthread_mutex_unlock(&mMutex);
+}
@@ -29,91 +29,27 @@
 #include <memory>
 #include <unordered_map>
 #include "priv_aamp.h"
+#include "AampDiskCache.h"
+#include "AampLruCache.h"
 
 #define PLAYLIST_CACHE_SIZE_UNLIMITED -1
 
-/**
- * @brief PlayListCachedData structure to store playlist data
- */
-typedef struct playlistcacheddata{
-	std::string mEffectiveUrl;
-	GrowableBuffer* mCachedBuffer;
-	MediaType mFileType;
-	bool mDuplicateEntry;
-
-	playlistcacheddata() : mEffectiveUrl(""), mCachedBuffer(NULL), mFileType(eMEDIATYPE_DEFAULT),mDuplicateEntry(false)
-	{
-	}
-
-	playlistcacheddata(const playlistcacheddata& p) : mEffectiveUrl(p.mEffectiveUrl), mCachedBuffer(p.mCachedBuffer), mFileType(p.mFileType),mDuplicateEntry(p.mDuplicateEntry)
-	{
-		mCachedBuffer->ptr = p.mCachedBuffer->ptr;
-		mCachedBuffer->len = p.mCachedBuffer->len;
-		mCachedBuffer->avail = p.mCachedBuffer->avail;
-	}
-
-	playlistcacheddata& operator=(const playlistcacheddata &p)
-	{
-		mEffectiveUrl = p.mEffectiveUrl;
-		mCachedBuffer = p.mCachedBuffer;
-		mFileType = p.mFileType;
-		mDuplicateEntry = p.mDuplicateEntry;
-		return *this;
-	}
-
-}PlayListCachedData;
-
-/**
- * @brief InitFragCacheStruct to store Init Fragment data
- * Init fragment cache mechanism
- * All types (VID/AUD/SUB/AUX) of Init Fragment maintained in a single Cache Table,
- * and these fragment's url are stored in a Track Queue corrsponding to file type.
- * This queue will be used to count fragments inserted, to remove entry in FIFO order
- * upon exceeding limit with respect to file type.
- * Eg:
- * TrackQ[VID]={"http://sample_domain/vid_qual1.init"}	   umCacheTable={{"http://sample_domain/vid_qual1.init"}, VidUrlData1}
- *             {"http://sample_domain/vid_qual2.init"}					{{"http://sample_domain/vid_qual1.init_redirect"}, VidUrlData1}
- * 			   {"http://sample_domain/vid_qual3.init"}					{{"http://sample_domain/aud_qual1.init"}, AudUrlData1}
- * TrackQ[AUD]={"http://sample_domain/aud_qual1.init"}					{{"http://sample_domain/vid_qual2.init"}, VidUrlData2}
- *             {"http://sample_domain/aud_qual2.init"}					{{"http://sample_domain/aud_qual1.init_redirect"}, AudUrlData1}
- * 			   {"http://sample_domain/aud_qual3.init"}					{{"http://sample_domain/aud_qual3.init"}, AudUrlData3}
- * 																		{{"http://sample_domain/aud_qual2.init"}, AudUrlData2}
- * 																		{{"http://sample_domain/vid_qual2.init_redirect"}, VidUrlData2}
- * 																		{{"http://sample_domain/vid_qual3.init"}, VidUrlData3}
- * 																		{{"http://sample_domain/aud_qual2.init_redirect"}, AudUrlData2}
- * Track queue will not maintain duplicate entry of cache table, so we can have maximum of different init fragments in cache table.
- * As per above eg, TrackQ[VID] size is 3, but cache table has 5 including effective url entry. If we maintain effective url entry
- * in cache queue, we will have only 3 init fragments in diff quality.
- * If cache table reaches max no of cache per track, we remove both main entry and dup entry if present, in FIFO order.
- * 
- * Fragment cache & track queue will be cleared upon exiting from aamp player or from async clear thread.
- */
-typedef struct playlistcacheddata InitFragCacheStruct;
-
-/**
- * @brief initfragtrackstruct to store init fragment url per media track in FIFO Queue.
- */
-typedef struct initfragtrackstruct
-{
-	std::queue<std::string> Trackqueue;
-
-	initfragtrackstruct() : Trackqueue()
-	{
-	}
-}InitFragTrackStruct;
-
 /**
  * @class AampCacheHandler
  * @brief Handles Aamp Cahe operations
+ *
+ * Playlists and init fragments are held as immutable AampCachedFile shared by the cache
+ * and its readers. Read only consumers borrow the cached file instead of copying it,
+ * consumers which modify the content get a private copy from the Retrieve functions.
+ * Each media type has its own LRU; playlists share the max playlist cache size, main
+ * manifest is never evicted for other playlists. Init fragments have a per track limit
+ * of entries and bytes.
  */
 
 class AampCacheHandler
 {
 private:
-	typedef std::unordered_map<std::string, PlayListCachedData *> PlaylistCache ;
-	typedef std::unordered_map<std::string, PlayListCachedData *>::iterator PlaylistCacheIter;
-	PlaylistCache mPlaylistCache;
-	int mCacheStoredSize;
+	AampLruCache mPlaylistCache;
 	bool mInitialized;
 	bool mCacheActive;
 	bool mAsyncCacheCleanUpThread;
@@ -125,15 +61,11 @@ private:
 	pthread_t mAsyncCleanUpTaskThreadId;
 	AampLogManager *mLogObj;
 
-	typedef std::unordered_map <std::string, InitFragCacheStruct*> InitFragCache ;
-	typedef std::unordered_map <std::string, InitFragCacheStruct*>::iterator InitFragCacheIter;
-	typedef std::unordered_map <MediaType, InitFragTrackStruct*, std::hash<int>> CacheTrackQueue;
-	typedef std::unordered_map <MediaType, InitFragTrackStruct*, std::hash<int>>::iterator CacheTrackQueueIter;
-	InitFragCache umInitFragCache;
-	CacheTrackQueue umCacheTrackQ;
+	AampLruCache mInitFragCache;
 	pthread_mutex_t mInitFragMutex;
-	bool bInitFragCache;
 	int MaxInitCacheSlot;						/**< Max no of init fragment per track */
+	std::shared_ptr<AampDiskCache> mDiskCache;			/**< Persistent tier, NULL if not configured */
+	int mDiskCacheMaxAge;						/**< Seconds an entry of persistent tier is served */
 
 private:
 
@@ -164,14 +96,6 @@ private:
 	 *	 @return void
 	 */
 	void ClearPlaylistCache();
-	/**
-	 *   @fn AllocatePlaylistCacheSlot
-	 *   @param[in] fileType - Indicate the type of playlist to store/remove
-	 *   @param[in] newLen  - Size required to store new playlist
-	 *
-	 *   @return bool Success or Failure
-	 */
-	bool AllocatePlaylistCacheSlot(MediaType fileType,size_t newLen);
 
 	/**
 	 *   @fn ClearInitFragCache
@@ -181,13 +105,34 @@ private:
 	void ClearInitFragCache();
 
 	/**
-	 *   @fn RemoveInitFragCacheEntry
-	 * 
-	 *   @param fileType type of file format to be removed from cache table
-	 * 
+	 *   @fn InsertPlaylistEntry
+	 *   @brief Add playlist to in memory cache, called with mMutex held
+	 *   @param[in] url - URL
+	 *   @param[in] file - cached playlist
+	 *
 	 *   @return void
 	 */
-	void RemoveInitFragCacheEntry ( MediaType fileType );
+	void InsertPlaylistEntry(const std::string &url, const AampCachedFilePtr &file);
+
+	/**
+	 *   @fn RetrieveFromDiskCache
+	 *   @brief Read file from persistent tier
+	 *   @param[in] url - URL
+	 *
+	 *   @return cached file, NULL if not found
+	 */
+	AampCachedFilePtr RetrieveFromDiskCache(const std::string &url);
+
+	/**
+	 *   @fn CopyCachedFile
+	 *   @brief Copy borrowed file to caller buffer
+	 *   @param[in] file - cached file, may be NULL
+	 *   @param[out] buffer - Pointer to growable buffer
+	 *   @param[out] effectiveUrl - Final URL
+	 *
+	 *   @return true if file is not NULL
+	 */
+	static bool CopyCachedFile(const AampCachedFilePtr &file, GrowableBuffer* buffer, std::string& effectiveUrl);
 
 public:
 
@@ -230,6 +175,7 @@ public:
 
 	/**
 	 *   @fn RetrieveFromPlaylistCache
+	 *   @brief Copy of cached playlist, for callers which modify it
 	 *   @param[in] url - URL
 	 *   @param[out] buffer - Pointer to growable buffer
 	 *   @param[out] effectiveUrl - Final URL
@@ -237,6 +183,15 @@ public:
 	 */
 	bool RetrieveFromPlaylistCache(const std::string url, GrowableBuffer* buffer, std::string& effectiveUrl);
 
+	/**
+	 *   @fn BorrowFromPlaylistCache
+	 *   @brief Cached playlist without copy. Content must not be modified, it stays valid
+	 *          while the returned reference is held, even if evicted meanwhile
+	 *   @param[in] url - URL
+	 *   @return cached playlist, NULL if not found
+	 */
+	AampCachedFilePtr BorrowFromPlaylistCache(const std::string &url);
+
 	/**
 	 *  @brief Remove specific playlist cache
 	 *   @param[in] url - URL
@@ -265,15 +220,17 @@ public:
 
 	/**
 	 *   @fn InsertToInitFragCache
+	 *   @brief Insert init fragment, the cache takes over the buffer memory without copy
 	 *
 	 *   @param[in] url - URL
-	 *   @param[in] buffer - Pointer to growable buffer
+	 *   @param[in,out] buffer - Pointer to growable buffer, reset on return
 	 *   @param[in] effectiveUrl - Final URL
 	 *   @param[in] fileType - Type of the file inserted
+	 *   @param[in] validator - ETag or Last-Modified of response, stored with persistent copy
      	 *
-	 *   @return void
+	 *   @return cached init fragment of url, NULL if buffer is empty
 	 */
-	void InsertToInitFragCache(const std::string url, const GrowableBuffer* buffer, std::string effectiveUrl,MediaType fileType);
+	AampCachedFilePtr InsertToInitFragCache(const std::string url, GrowableBuffer* buffer, std::string effectiveUrl,MediaType fileType, const std::string &validator = "");
 
 	/**
 	 *   @fn RetrieveFromInitFragCache
@@ -286,6 +243,24 @@ public:
 	 */
 	bool RetrieveFromInitFragCache(const std::string url, GrowableBuffer* buffer, std::string& effectiveUrl);
 
+	/**
+	 *   @fn BorrowFromInitFragCache
+	 *   @brief Cached init fragment without copy. Content must not be modified, it stays valid
+	 *          while the returned reference is held, even if evicted meanwhile
+	 *   @param[in] url - URL
+	 *   @return cached init fragment, NULL if not found
+	 */
+	AampCachedFilePtr BorrowFromInitFragCache(const std::string &url);
+
+	/**
+	 *   @fn IsInitFragmentCached
+	 *
+	 *   @param[in] url - URL
+	 *
+	 *   @return true if init fragment of url is in cache
+	 */
+	bool IsInitFragmentCached(const std::string &url);
+
 	/**
 	*   @fn SetMaxInitFragCacheSize
 	*
@@ -302,6 +277,19 @@ public:
 	*/
 	int  GetMaxInitFragCacheSize() { return MaxInitCacheSlot; }
 
+	/**
+	*   @fn SetPersistentCache
+	*   @brief Configure persistent tier, which keeps init fragments and VOD playlists across restart.
+	*          Lookups missing the in memory cache fall through to it
+	*
+	*   @param[in] path - store file, empty to disable
+	*   @param[in] maxSizeKB - store size in KB
+	*   @param[in] maxAgeSec - seconds an entry is served after download, 0 for no limit
+	*
+	*   @return None
+	*/
+	void SetPersistentCache(const std::string &path, int maxSizeKB, int maxAgeSec);
+
         /**
          * @brief Copy constructor disabled
          *
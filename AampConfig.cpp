@@ -291,6 +291,34 @@ static AampConfigLookupEntry ConfigLookUpTable[] =
 	,{"enableSCTE35PresentationTime", eAAMPConfig_EnableSCTE35PresentationTime, false, -1, -1}
 	,{"jsinfo",eAAMPConfig_JsInfoLogging,false, -1, -1}
 	,{"ignoreAppLiveOffset", eAAMPConfig_IgnoreAppLiveOffset, false, -1, -1}
+	,{"fragmentBufferPool", eAAMPConfig_EnableFragmentBufferPool, false, -1, -1}
+	,{"zeroCopyInjection", eAAMPConfig_EnableZeroCopyInjection, false, -1, -1}
+	,{"hlsIncrementalIndex", eAAMPConfig_HlsIncrementalIndex, false, -1, -1}
+	,{"downloadEngine", eAAMPConfig_EnableDownloadEngine, false, -1, -1}
+	,{"http2Multiplex", eAAMPConfig_EnableHttp2Multiplex, false, -1, -1}
+	,{"mpdIncrementalParse", eAAMPConfig_MpdIncrementalParse, false, -1, -1}
+	,{"tunePrefetch", eAAMPConfig_EnableTunePrefetch, false, -1, -1}
+	,{"streamingAesDecrypt", eAAMPConfig_StreamingAesDecrypt, false, -1, -1}
+	,{"persistentCache", eAAMPConfig_PersistentCache, false, -1, -1}
+	,{"persistentCachePath", eAAMPConfig_PersistentCachePath, false, -1, -1}
+	,{"perfTrace", eAAMPConfig_EnablePerfTrace, false, -1, -1}
+	,{"perfTracePath", eAAMPConfig_PerfTracePath, false, -1, -1}
+	,{"bolaAbr", eAAMPConfig_BolaAbr, false, -1, -1}
+	,{"asyncLogging", eAAMPConfig_AsyncLogging, false, -1, -1}
+	,{"batchEventDispatch", eAAMPConfig_BatchEventDispatch, false, -1, -1}
+	,{"fragmentBufferPoolSize", eAAMPConfig_FragmentBufferPoolSize, false, {.iMinValue=0}, {.iMaxValue=262144}}
+	,{"downloadEngineDepth", eAAMPConfig_DownloadEngineDepth, false, {.iMinValue=0}, {.iMaxValue=8}}
+	,{"downloadEngineMaxTransfers", eAAMPConfig_DownloadEngineMaxTransfers, false, {.iMinValue=1}, {.iMaxValue=32}}
+	,{"bandwidthEstimator", eAAMPConfig_BandwidthEstimator, false, {.iMinValue=0}, {.iMaxValue=2}}
+	,{"persistentCacheSize", eAAMPConfig_PersistentCacheSize, false, {.iMinValue=256}, {.iMaxValue=1048576}}
+	,{"persistentCacheMaxAge", eAAMPConfig_PersistentCacheMaxAge, false, {.iMinValue=0}, {.iMaxValue=31536000}}
+	,{"preTuneCacheSize", eAAMPConfig_PreTuneCacheSize, false, {.iMinValue=256}, {.iMaxValue=65536}}
+	,{"preTuneMaxAge", eAAMPConfig_PreTuneMaxAge, false, {.iMinValue=1}, {.iMaxValue=3600}}
+	,{"preTuneMaxBandwidth", eAAMPConfig_PreTuneMaxBandwidth, false, {.iMinValue=0}, {.iMaxValue=1000000}}
+	,{"perfTraceBufferSize", eAAMPConfig_PerfTraceBufferSize, false, {.iMinValue=256}, {.iMaxValue=1048576}}
+	,{"bolaBufferTarget", eAAMPConfig_BolaBufferTarget, false, {.iMinValue=4}, {.iMaxValue=300}}
+	,{"bolaUtility", eAAMPConfig_BolaUtility, false, {.iMinValue=0}, {.iMaxValue=1}}
+	,{"eventRateLimit", eAAMPConfig_EventRateLimit, false, {.iMinValue=0}, {.iMaxValue=10000}}
 };
 /////////////////// Public Functions /////////////////////////////////////
 /**
@@ -486,6 +514,19 @@ void AampConfig::Initialize()
 	bAampCfgValue[eAAMPConfig_EnableSlowMotion].value			=	true;
 	bAampCfgValue[eAAMPConfig_EnableSCTE35PresentationTime].value			=	false;
 	bAampCfgValue[eAAMPConfig_JsInfoLogging].value                          = 	false;
+	bAampCfgValue[eAAMPConfig_EnableFragmentBufferPool].value		=	false;
+	bAampCfgValue[eAAMPConfig_EnableZeroCopyInjection].value		=	false;
+	bAampCfgValue[eAAMPConfig_HlsIncrementalIndex].value			=	false;
+	bAampCfgValue[eAAMPConfig_EnableDownloadEngine].value			=	false;
+	bAampCfgValue[eAAMPConfig_EnableHttp2Multiplex].value			=	false;
+	bAampCfgValue[eAAMPConfig_MpdIncrementalParse].value			=	false;
+	bAampCfgValue[eAAMPConfig_EnableTunePrefetch].value			=	false;
+	bAampCfgValue[eAAMPConfig_StreamingAesDecrypt].value			=	false;
+	bAampCfgValue[eAAMPConfig_PersistentCache].value			=	false;
+	bAampCfgValue[eAAMPConfig_EnablePerfTrace].value			=	false;
+	bAampCfgValue[eAAMPConfig_BolaAbr].value				=	false;
+	bAampCfgValue[eAAMPConfig_AsyncLogging].value				=	false;
+	bAampCfgValue[eAAMPConfig_BatchEventDispatch].value			=	false;
 
 	///////////////// Following for Integer Data type configs ////////////////////////////
 	iAampCfgValue[eAAMPConfig_HarvestCountLimit-eAAMPConfig_IntStartValue].value		=	0;
@@ -543,6 +584,19 @@ void AampConfig::Initialize()
 	iAampCfgValue[eAAMPConfig_FogMaxConcurrentDownloads-eAAMPConfig_IntStartValue].value	=	FOG_MAX_CONCURRENT_DOWNLOADS;
 	iAampCfgValue[eAAMPConfig_ContentProtectionDataUpdateTimeout-eAAMPConfig_IntStartValue].value	=	DEFAULT_CONTENT_PROTECTION_DATA_UPDATE_TIMEOUT;
 	iAampCfgValue[eAAMPConfig_MaxCurlSockStore-eAAMPConfig_IntStartValue].value		=	MAX_CURL_SOCK_STORE;
+	iAampCfgValue[eAAMPConfig_FragmentBufferPoolSize-eAAMPConfig_IntStartValue].value	=	DEFAULT_FRAGMENT_BUFFER_POOL_SIZE;
+	iAampCfgValue[eAAMPConfig_DownloadEngineDepth-eAAMPConfig_IntStartValue].value		=	DEFAULT_DOWNLOAD_ENGINE_DEPTH;
+	iAampCfgValue[eAAMPConfig_DownloadEngineMaxTransfers-eAAMPConfig_IntStartValue].value	=	DEFAULT_DOWNLOAD_ENGINE_MAX_TRANSFERS;
+	iAampCfgValue[eAAMPConfig_BandwidthEstimator-eAAMPConfig_IntStartValue].value		=	DEFAULT_BANDWIDTH_ESTIMATOR;
+	iAampCfgValue[eAAMPConfig_PersistentCacheSize-eAAMPConfig_IntStartValue].value		=	DEFAULT_PERSISTENT_CACHE_SIZE;
+	iAampCfgValue[eAAMPConfig_PersistentCacheMaxAge-eAAMPConfig_IntStartValue].value	=	DEFAULT_PERSISTENT_CACHE_MAX_AGE;
+	iAampCfgValue[eAAMPConfig_PreTuneCacheSize-eAAMPConfig_IntStartValue].value		=	DEFAULT_PRETUNE_CACHE_SIZE;
+	iAampCfgValue[eAAMPConfig_PreTuneMaxAge-eAAMPConfig_IntStartValue].value		=	DEFAULT_PRETUNE_MAX_AGE;
+	iAampCfgValue[eAAMPConfig_PreTuneMaxBandwidth-eAAMPConfig_IntStartValue].value		=	DEFAULT_PRETUNE_MAX_BANDWIDTH;
+	iAampCfgValue[eAAMPConfig_PerfTraceBufferSize-eAAMPConfig_IntStartValue].value		=	DEFAULT_PERF_TRACE_BUFFER_SIZE;
+	iAampCfgValue[eAAMPConfig_BolaBufferTarget-eAAMPConfig_IntStartValue].value		=	DEFAULT_BOLA_BUFFER_TARGET;
+	iAampCfgValue[eAAMPConfig_BolaUtility-eAAMPConfig_IntStartValue].value			=	DEFAULT_BOLA_UTILITY;
+	iAampCfgValue[eAAMPConfig_EventRateLimit-eAAMPConfig_IntStartValue].value		=	DEFAULT_EVENT_RATE_LIMIT;
 
 	///////////////// Following for long data types /////////////////////////////
 	lAampCfgValue[eAAMPConfig_DiscontinuityTimeout-eAAMPConfig_LongStartValue].value	=	DEFAULT_DISCONTINUITY_TIMEOUT;
@@ -597,6 +651,8 @@ void AampConfig::Initialize()
 	sAampCfgValue[eAAMPConfig_PreferredTextLabel-eAAMPConfig_StringStartValue].value    =       "";
 	sAampCfgValue[eAAMPConfig_PreferredTextType-eAAMPConfig_StringStartValue].value    =       "";
 	sAampCfgValue[eAAMPConfig_CustomLicenseData-eAAMPConfig_StringStartValue].value        =       "";
+	sAampCfgValue[eAAMPConfig_PersistentCachePath-eAAMPConfig_StringStartValue].value	=	DEFAULT_PERSISTENT_CACHE_PATH;
+	sAampCfgValue[eAAMPConfig_PerfTracePath-eAAMPConfig_StringStartValue].value		=	DEFAULT_PERF_TRACE_PATH;
 }
 
 void AampConfig::ReadDeviceCapability()
@@ -206,6 +206,19 @@ typedef enum
 	eAAMPConfig_EnableSCTE35PresentationTime,			/**< Enable/Disable use of SCTE PTS presentation time */
 	eAAMPConfig_JsInfoLogging,						/**< Enable/disable jsinfo logging       */
 	eAAMPConfig_IgnoreAppLiveOffset,				/** <Config to ignore the liveOffset from App for LLD */
+	eAAMPConfig_EnableFragmentBufferPool,				/**< Enable/Disable recycling of fragment download buffers */
+	eAAMPConfig_EnableZeroCopyInjection,				/**< Enable/Disable injection of fragment memory to gstreamer without copy */
+	eAAMPConfig_HlsIncrementalIndex,				/**< Enable/Disable incremental indexing of refreshed HLS live playlists */
+	eAAMPConfig_EnableDownloadEngine,				/**< Enable/Disable curl_multi download engine with fragment lookahead */
+	eAAMPConfig_EnableHttp2Multiplex,				/**< Enable/Disable HTTP/2 multiplexing of downloads to the same host */
+	eAAMPConfig_MpdIncrementalParse,				/**< Enable/Disable reuse of unchanged periods when parsing refreshed DASH manifests */
+	eAAMPConfig_EnableTunePrefetch,					/**< Enable/Disable download of init and first fragments on download engine as soon as tracks are selected */
+	eAAMPConfig_StreamingAesDecrypt,				/**< Enable/Disable decryption of HLS AES-128 fragments while they download */
+	eAAMPConfig_PersistentCache,					/**< Enable/Disable file backed cache of init fragments and VOD playlists kept across restart */
+	eAAMPConfig_EnablePerfTrace,					/**< Enable/Disable recording of fragment pipeline spans written as Chrome trace JSON */
+	eAAMPConfig_BolaAbr,						/**< Enable/Disable buffer occupancy based ABR */
+	eAAMPConfig_AsyncLogging,					/**< Enable/Disable formatting and writing logs on a background thread */
+	eAAMPConfig_BatchEventDispatch,					/**< Enable/Disable dispatch of all queued async events in one idle task */
 	eAAMPConfig_BoolMaxValue,
 	/////////////////////////////////
 	eAAMPConfig_IntStartValue,
@@ -263,6 +276,19 @@ typedef enum
 	eAAMPConfig_FogMaxConcurrentDownloads,                                  /**< Concurrent download posted to fog from player*/
 	eAAMPConfig_ContentProtectionDataUpdateTimeout,				/**< Default Timeout For ContentProtectionData Update */
 	eAAMPConfig_MaxCurlSockStore,						/**< Max no of curl socket to be stored */
+	eAAMPConfig_FragmentBufferPoolSize,					/**< Max size of fragment buffer pool in KB */
+	eAAMPConfig_DownloadEngineDepth,					/**< Number of fragments prefetched ahead per track by download engine */
+	eAAMPConfig_DownloadEngineMaxTransfers,				/**< Max transfers in flight on download engine */
+	eAAMPConfig_BandwidthEstimator,						/**< Network bandwidth estimation model used by ABR */
+	eAAMPConfig_PersistentCacheSize,					/**< Size of persistent cache file in KB */
+	eAAMPConfig_PersistentCacheMaxAge,					/**< Seconds a persistent cache entry is served after download */
+	eAAMPConfig_PreTuneCacheSize,						/**< Memory for pre-tuned channels in KB */
+	eAAMPConfig_PreTuneMaxAge,						/**< Seconds a pre-tuned channel is used for a tune */
+	eAAMPConfig_PreTuneMaxBandwidth,					/**< Download rate limit of pre-tune in kbps */
+	eAAMPConfig_PerfTraceBufferSize,					/**< Trace events kept per thread */
+	eAAMPConfig_BolaBufferTarget,						/**< Buffer in seconds at which buffer based ABR picks top profile */
+	eAAMPConfig_BolaUtility,						/**< Utility of bitrate for buffer based ABR */
+	eAAMPConfig_EventRateLimit,						/**< Minimum ms between batch dispatches of a coalescable event type */
 	eAAMPConfig_IntMaxValue,
 	///////////////////////////////////
 	eAAMPConfig_LongStartValue,
@@ -319,6 +345,8 @@ typedef enum
 	eAAMPConfig_PreferredTextLabel,						/**< New Configuration to save preferred Text label field; Label is a textual description of the content. Support only single string value*/
 	eAAMPConfig_PreferredTextType,						/**< New Configuration to save preferred Text Type field; type indicate the accessibility type of text track*/
 	eAAMPConfig_CustomLicenseData,                          		/**< Custom Data for License Request */
+	eAAMPConfig_PersistentCachePath,					/**< Path of persistent cache file */
+	eAAMPConfig_PerfTracePath,						/**< Path of Chrome trace JSON file */
 	eAAMPConfig_StringMaxValue,
 	eAAMPConfig_MaxValue
 }AAMPConfigSettings;
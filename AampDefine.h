@@ -115,8 +115,24 @@
 #define MAX_ANOMALY_BUFF_SIZE   256
 #define MAX_WAIT_TIMEOUT_MS	200				/**< Max Timeout furation for wait until cache is available to inject next*/
 #define MAX_INIT_FRAGMENT_CACHE_PER_TRACK  5       		/**< Max No Of cached Init fragements per track */
+#define MAX_INIT_FRAGMENT_CACHE_SIZE_PER_TRACK	1024		/**< Max size of cached Init fragments per track in KB */
 #define MIN_SEG_DURTION_THREASHOLD	(0.25)			/**< Min Segment Duration threshold for pushing to pipeline at period End*/
 #define MAX_CURL_SOCK_STORE		10			/**< Maximum no of host to be maintained in curl store*/
+#define DEFAULT_FRAGMENT_BUFFER_POOL_SIZE	(32*1024)		/**< Default max size of fragment buffer pool in KB */
+#define DEFAULT_DOWNLOAD_ENGINE_DEPTH		2			/**< Default number of fragments prefetched ahead per track */
+#define DEFAULT_DOWNLOAD_ENGINE_MAX_TRANSFERS	8			/**< Default max transfers in flight on download engine */
+#define DEFAULT_BANDWIDTH_ESTIMATOR		0			/**< Default bandwidth estimation, median of cached samples by HybridABRManager */
+#define DEFAULT_PERSISTENT_CACHE_PATH		"/opt/persistent/aamp_cache.bin"	/**< Default file of persistent cache */
+#define DEFAULT_PERSISTENT_CACHE_SIZE		(8*1024)		/**< Default size of persistent cache in KB */
+#define DEFAULT_PERSISTENT_CACHE_MAX_AGE	(7*24*3600)		/**< Default seconds a persistent cache entry is served */
+#define DEFAULT_PRETUNE_CACHE_SIZE		(6*1024)		/**< Default memory for pre-tuned channels in KB */
+#define DEFAULT_PRETUNE_MAX_AGE			10			/**< Default seconds a pre-tuned channel is used for a tune */
+#define DEFAULT_PRETUNE_MAX_BANDWIDTH		2000			/**< Default download rate limit of pre-tune in kbps */
+#define DEFAULT_PERF_TRACE_BUFFER_SIZE		4096			/**< Default trace events kept per thread */
+#define DEFAULT_PERF_TRACE_PATH			"/opt/aamp_trace.json"	/**< Default file of Chrome trace JSON */
+#define DEFAULT_BOLA_BUFFER_TARGET		AAMP_HIGH_BUFFER_BEFORE_RAMPUP	/**< Default buffer in seconds at which buffer based ABR picks top profile */
+#define DEFAULT_BOLA_UTILITY			0			/**< Default utility of buffer based ABR, logarithmic */
+#define DEFAULT_EVENT_RATE_LIMIT		0			/**< Default minimum ms between batch dispatches of a coalescable event type, no limit */
 
 // Player supported play/trick-play rates.
 #define AAMP_RATE_TRICKPLAY_MAX		64
@@ -144,6 +160,7 @@
 #define DEFAULT_MAX_RATE_CORRECTION_SPEED		1.10f					/**< max Rate correction speed */
 #define AAMP_NORMAL_LL_PLAY_RATE 				1.01f					/**< LL Normal play rate adjusted to 1.01 */
 #define DEFAULT_CACHED_FRAGMENT_CHUNKS_PER_TRACK	20					/**< Default cached fragement chunks per track */
+#define DEFAULT_CHUNK_RING_WAKEUP_SLOTS(chunks)	(((chunks) + 3) / 4)			/**< Free chunk slots needed to wake a blocked chunk fetcher */
 #define DEFAULT_ABR_CHUNK_CACHE_LENGTH			10					/**< Default ABR chunk cache length */
 #define DEFAULT_AAMP_ABR_CHUNK_THRESHOLD_SIZE		(DEFAULT_AAMP_ABR_THRESHOLD_SIZE)	/**< aamp abr Chunk threshold size */
 #define DEFAULT_ABR_CHUNK_SPEEDCNT			10					/**< Chunk Speed Count Store Size */
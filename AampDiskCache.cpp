@@ -0,0 +1,451 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampDiskCache.cpp
+ * @brief Size bounded persistent store for playlists and init fragments
+ */
+
+#include "AampDiskCache.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+
+#define FNV_OFFSET_BASIS	2166136261u
+#define FNV_PRIME		16777619u
+
+/**
+ * @brief FNV-1a hash of a byte range
+ */
+static uint32_t DiskCacheChecksum(const char *data, size_t len)
+{
+	uint32_t hash = FNV_OFFSET_BASIS;
+	for (size_t i = 0; i < len; i++)
+	{
+		hash ^= (uint8_t)data[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+/**
+ * @brief AampDiskCache Constructor
+ */
+AampDiskCache::AampDiskCache() : mMutex(), mPath(), mFd(-1), mBase(NULL), mCapacity(0), mDataStart(0), mHeader(NULL), mSlots(NULL), mIndex(), mUsedBytes(0)
+{
+}
+
+/**
+ * @brief AampDiskCache Destructor
+ */
+AampDiskCache::~AampDiskCache()
+{
+	Close();
+}
+
+/**
+ * @brief Store shared by all player instances of the process for a path
+ */
+std::shared_ptr<AampDiskCache> AampDiskCache::Acquire(const std::string &path, size_t capacity)
+{
+	static std::mutex storesMutex;
+	static std::unordered_map<std::string, std::weak_ptr<AampDiskCache>> stores;
+	std::lock_guard<std::mutex> guard(storesMutex);
+	std::shared_ptr<AampDiskCache> store = stores[path].lock();
+	if (!store)
+	{
+		store = std::make_shared<AampDiskCache>();
+		if (store->Open(path, capacity))
+		{
+			stores[path] = store;
+		}
+		else
+		{
+			store.reset();
+			stores.erase(path);
+		}
+	}
+	return store;
+}
+
+/**
+ * @brief Map store file
+ */
+bool AampDiskCache::Open(const std::string &path, size_t capacity)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	long pageSize = sysconf(_SC_PAGESIZE);
+	if (mBase || path.empty() || pageSize <= 0)
+	{
+		return false;
+	}
+	capacity -= capacity % pageSize;
+	if (capacity < AAMP_DISK_CACHE_MIN_SIZE)
+	{
+		return false;
+	}
+	int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+	if (fd < 0)
+	{
+		return false;
+	}
+	if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+	{
+		close(fd);
+		return false;
+	}
+	struct stat fileStat;
+	bool reuse = (fstat(fd, &fileStat) == 0 && (size_t)fileStat.st_size == capacity);
+	if (!reuse)
+	{
+		bool allocated = (ftruncate(fd, 0) == 0);
+#ifdef __APPLE__
+		allocated = allocated && (ftruncate(fd, capacity) == 0);
+#else
+		// blocks are reserved up front, a store to a hole on a full file system would raise SIGBUS
+		allocated = allocated && (posix_fallocate(fd, 0, capacity) == 0);
+#endif
+		if (!allocated)
+		{
+			close(fd);
+			return false;
+		}
+	}
+	void *base = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (base == MAP_FAILED)
+	{
+		close(fd);
+		return false;
+	}
+	mPath = path;
+	mFd = fd;
+	mBase = (char *)base;
+	mCapacity = capacity;
+	mDataStart = (sizeof(AampDiskCacheHeader) + AAMP_DISK_CACHE_SLOTS * sizeof(AampDiskCacheSlot) + 7) & ~(uint64_t)7;
+	mHeader = (AampDiskCacheHeader *)mBase;
+	mSlots = (AampDiskCacheSlot *)(mBase + sizeof(AampDiskCacheHeader));
+	if (!reuse || mHeader->magic != AAMP_DISK_CACHE_MAGIC || mHeader->version != AAMP_DISK_CACHE_VERSION ||
+		mHeader->slotCount != AAMP_DISK_CACHE_SLOTS || mHeader->capacity != capacity)
+	{
+		memset(mBase, 0, mDataStart);
+		mHeader->version = AAMP_DISK_CACHE_VERSION;
+		mHeader->slotCount = AAMP_DISK_CACHE_SLOTS;
+		mHeader->capacity = capacity;
+		std::atomic_thread_fence(std::memory_order_release);
+		mHeader->magic = AAMP_DISK_CACHE_MAGIC;
+	}
+	LoadIndex();
+	return true;
+}
+
+/**
+ * @brief Unmap store file
+ */
+void AampDiskCache::Close()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (mBase)
+	{
+		munmap(mBase, mCapacity);
+		close(mFd);	// releases lock
+	}
+	mFd = -1;
+	mBase = NULL;
+	mHeader = NULL;
+	mSlots = NULL;
+	mCapacity = 0;
+	mIndex.clear();
+	mUsedBytes = 0;
+}
+
+/**
+ * @brief Build url lookup from entry table
+ */
+void AampDiskCache::LoadIndex()
+{
+	mIndex.clear();
+	mUsedBytes = 0;
+	std::vector<uint32_t> order;
+	for (uint32_t i = 0; i < AAMP_DISK_CACHE_SLOTS; i++)
+	{
+		AampDiskCacheSlot &slot = mSlots[i];
+		if (!slot.inUse)
+		{
+			continue;
+		}
+		uint64_t recordLen = (uint64_t)slot.urlLen + slot.validatorLen + slot.effectiveUrlLen + slot.payloadLen;
+		if (slot.offset < mDataStart || slot.offset > mCapacity || slot.size > mCapacity - slot.offset ||
+			recordLen > slot.size || slot.urlLen == 0)
+		{
+			slot.inUse = 0;
+			continue;
+		}
+		order.push_back(i);
+		if (slot.lastUse > mHeader->useClock)
+		{
+			mHeader->useClock = slot.lastUse;
+		}
+	}
+	std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return mSlots[a].offset < mSlots[b].offset; });
+	uint64_t end = mDataStart;
+	for (uint32_t index : order)
+	{
+		AampDiskCacheSlot &slot = mSlots[index];
+		if (slot.offset < end)
+		{
+			// overlapping records are left by an interrupted write, keep the earlier one
+			slot.inUse = 0;
+			continue;
+		}
+		std::string url(mBase + slot.offset, slot.urlLen);
+		auto it = mIndex.find(url);
+		if (it != mIndex.end())
+		{
+			AampDiskCacheSlot &other = mSlots[it->second];
+			if (other.lastUse >= slot.lastUse)
+			{
+				slot.inUse = 0;
+				continue;
+			}
+			other.inUse = 0;
+			mUsedBytes -= other.size;
+		}
+		mIndex[url] = index;
+		mUsedBytes += slot.size;
+		end = slot.offset + slot.size;
+	}
+}
+
+/**
+ * @brief Find free slot and data area for a record, evicting least recently used entries
+ */
+int AampDiskCache::Allocate(uint32_t size, uint64_t &offset)
+{
+	if (size > mCapacity - mDataStart)
+	{
+		return -1;
+	}
+	std::vector<uint32_t> used;
+	used.reserve(mIndex.size());
+	for (;;)
+	{
+		int freeSlot = -1;
+		int lruSlot = -1;
+		used.clear();
+		for (uint32_t i = 0; i < AAMP_DISK_CACHE_SLOTS; i++)
+		{
+			if (mSlots[i].inUse)
+			{
+				used.push_back(i);
+				if (lruSlot < 0 || mSlots[i].lastUse < mSlots[lruSlot].lastUse)
+				{
+					lruSlot = i;
+				}
+			}
+			else if (freeSlot < 0)
+			{
+				freeSlot = i;
+			}
+		}
+		if (freeSlot >= 0)
+		{
+			std::sort(used.begin(), used.end(), [this](uint32_t a, uint32_t b) { return mSlots[a].offset < mSlots[b].offset; });
+			uint64_t pos = mDataStart;
+			for (uint32_t index : used)
+			{
+				if (mSlots[index].offset - pos >= size)
+				{
+					break;
+				}
+				pos = mSlots[index].offset + mSlots[index].size;
+			}
+			if (mCapacity - pos >= size)
+			{
+				offset = pos;
+				return freeSlot;
+			}
+		}
+		if (lruSlot < 0)
+		{
+			return -1;
+		}
+		RemoveSlot(lruSlot);
+	}
+}
+
+/**
+ * @brief Remove entry
+ */
+void AampDiskCache::RemoveSlot(uint32_t index)
+{
+	AampDiskCacheSlot &slot = mSlots[index];
+	mIndex.erase(std::string(mBase + slot.offset, slot.urlLen));
+	mUsedBytes -= slot.size;
+	slot.inUse = 0;
+}
+
+/**
+ * @brief Mark entry as most recently used
+ */
+void AampDiskCache::Touch(uint32_t index)
+{
+	mSlots[index].lastUse = ++mHeader->useClock;
+}
+
+/**
+ * @brief Store file content
+ */
+bool AampDiskCache::Insert(const std::string &url, const std::string &validator, const std::string &effectiveUrl, int type, const char *data, size_t len, int64_t now)
+{
+	if (url.empty() || url.size() > UINT16_MAX || validator.size() > UINT16_MAX || effectiveUrl.size() > UINT16_MAX || (len && !data))
+	{
+		return false;
+	}
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (!mBase)
+	{
+		return false;
+	}
+	auto it = mIndex.find(url);
+	if (it != mIndex.end())
+	{
+		AampDiskCacheSlot &slot = mSlots[it->second];
+		if (!validator.empty() && slot.validatorLen == validator.size() && slot.payloadLen == len &&
+			0 == memcmp(mBase + slot.offset + slot.urlLen, validator.data(), validator.size()))
+		{
+			// same version downloaded again, nothing to rewrite
+			slot.storeTime = now;
+			Touch(it->second);
+			return true;
+		}
+		RemoveSlot(it->second);
+	}
+	size_t recordLen = url.size() + validator.size() + effectiveUrl.size();
+	if (len > mCapacity || recordLen + len > mCapacity - mDataStart)
+	{
+		return false;
+	}
+	recordLen += len;
+	uint32_t size = (uint32_t)((recordLen + 7) & ~(size_t)7);
+	uint64_t offset = 0;
+	int index = Allocate(size, offset);
+	if (index < 0)
+	{
+		return false;
+	}
+	char *record = mBase + offset;
+	char *dst = record;
+	memcpy(dst, url.data(), url.size());
+	dst += url.size();
+	memcpy(dst, validator.data(), validator.size());
+	dst += validator.size();
+	memcpy(dst, effectiveUrl.data(), effectiveUrl.size());
+	dst += effectiveUrl.size();
+	if (len)
+	{
+		memcpy(dst, data, len);
+	}
+
+	AampDiskCacheSlot &slot = mSlots[index];
+	slot.offset = offset;
+	slot.storeTime = now;
+	slot.size = size;
+	slot.payloadLen = (uint32_t)len;
+	slot.checksum = DiskCacheChecksum(record, recordLen);
+	slot.urlLen = (uint16_t)url.size();
+	slot.validatorLen = (uint16_t)validator.size();
+	slot.effectiveUrlLen = (uint16_t)effectiveUrl.size();
+	slot.type = (uint8_t)type;
+	Touch(index);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.inUse = 1;
+	mIndex[url] = index;
+	mUsedBytes += size;
+	return true;
+}
+
+/**
+ * @brief Read stored file and mark entry as used
+ */
+bool AampDiskCache::Retrieve(const std::string &url, std::vector<char> &data, std::string &effectiveUrl, int &type, std::string *validator, int64_t now, int64_t maxAge)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	auto it = mIndex.find(url);
+	if (it == mIndex.end())
+	{
+		return false;
+	}
+	uint32_t index = it->second;
+	AampDiskCacheSlot &slot = mSlots[index];
+	const char *record = mBase + slot.offset;
+	size_t headLen = (size_t)slot.urlLen + slot.validatorLen + slot.effectiveUrlLen;
+	if ((maxAge > 0 && now - slot.storeTime > maxAge) ||
+		DiskCacheChecksum(record, headLen + slot.payloadLen) != slot.checksum)
+	{
+		RemoveSlot(index);
+		return false;
+	}
+	if (validator)
+	{
+		validator->assign(record + slot.urlLen, slot.validatorLen);
+	}
+	effectiveUrl.assign(record + slot.urlLen + slot.validatorLen, slot.effectiveUrlLen);
+	data.assign(record + headLen, record + headLen + slot.payloadLen);
+	type = slot.type;
+	Touch(index);
+	return true;
+}
+
+/**
+ * @brief Remove entry of url
+ */
+bool AampDiskCache::Remove(const std::string &url)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	auto it = mIndex.find(url);
+	if (it == mIndex.end())
+	{
+		return false;
+	}
+	RemoveSlot(it->second);
+	return true;
+}
+
+/**
+ * @brief Number of stored entries
+ */
+size_t AampDiskCache::GetEntryCount()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	return mIndex.size();
+}
+
+/**
+ * @brief Bytes of data area held by stored entries
+ */
+size_t AampDiskCache::GetUsedBytes()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	return mUsedBytes;
+}
@@ -0,0 +1,229 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampDiskCache.h
+ * @brief Size bounded persistent store for playlists and init fragments
+ */
+
+#ifndef __AAMP_DISK_CACHE_H__
+#define __AAMP_DISK_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#define AAMP_DISK_CACHE_MAGIC		0x43444141	/**< "AADC" */
+#define AAMP_DISK_CACHE_VERSION		1
+#define AAMP_DISK_CACHE_SLOTS		1024		/**< Max number of entries in store */
+#define AAMP_DISK_CACHE_MIN_SIZE	(256*1024)	/**< Least store size, including header and entry table */
+
+/**
+ * @struct AampDiskCacheHeader
+ * @brief Start of store file
+ */
+struct AampDiskCacheHeader
+{
+	uint32_t magic;		/**< AAMP_DISK_CACHE_MAGIC */
+	uint32_t version;	/**< AAMP_DISK_CACHE_VERSION */
+	uint32_t slotCount;	/**< Entries in table following header */
+	uint32_t reserved;
+	uint64_t capacity;	/**< File size */
+	uint64_t useClock;	/**< Last LRU stamp given to an entry */
+};
+
+/**
+ * @struct AampDiskCacheSlot
+ * @brief Entry table record. The data record holds url, validator, effective url and payload back to back
+ */
+struct AampDiskCacheSlot
+{
+	uint64_t offset;	/**< Data record offset from start of file */
+	uint64_t lastUse;	/**< LRU stamp, higher is more recent */
+	int64_t storeTime;	/**< Wall clock seconds when stored */
+	uint32_t size;		/**< Data record size, multiple of 8 */
+	uint32_t payloadLen;	/**< Cached file length */
+	uint32_t checksum;	/**< FNV-1a of data record up to end of payload */
+	uint16_t urlLen;
+	uint16_t validatorLen;
+	uint16_t effectiveUrlLen;
+	uint8_t type;		/**< MediaType of cached file */
+	uint8_t inUse;		/**< Set last when entry is written, cleared first when removed */
+};
+
+/**
+ * @class AampDiskCache
+ * @brief Memory mapped file store keyed by url, with LRU eviction
+ *
+ * The file is allocated in full on open and mapped shared, so stored entries survive player
+ * and process restart without explicit flush. Data records are placed first fit between
+ * existing records, least recently used entries are evicted until a new record fits. An
+ * entry is written before it is marked in use and its checksum is verified on every read,
+ * so a record torn by power loss is dropped rather than served. The file is locked while
+ * open; a second process opening the same path fails and runs without persistent tier.
+ */
+class AampDiskCache
+{
+public:
+	/**
+	 * @fn AampDiskCache
+	 */
+	AampDiskCache();
+
+	/**
+	 * @fn ~AampDiskCache
+	 */
+	~AampDiskCache();
+
+	AampDiskCache(const AampDiskCache&) = delete;
+	AampDiskCache& operator=(const AampDiskCache&) = delete;
+
+	/**
+	 * @fn Acquire
+	 * @brief Store shared by all player instances of the process for a path
+	 * @param[in] path - store file
+	 * @param[in] capacity - file size in bytes, used if the store is not open yet
+	 * @return opened store, NULL on failure
+	 */
+	static std::shared_ptr<AampDiskCache> Acquire(const std::string &path, size_t capacity);
+
+	/**
+	 * @fn Open
+	 * @brief Map store file, existing entries are kept if the file matches layout and capacity
+	 * @param[in] path - store file
+	 * @param[in] capacity - file size in bytes, rounded down to page size
+	 * @retval true on success
+	 */
+	bool Open(const std::string &path, size_t capacity);
+
+	/**
+	 * @fn Close
+	 * @return void
+	 */
+	void Close();
+
+	/**
+	 * @fn IsOpen
+	 * @retval true if store is mapped
+	 */
+	bool IsOpen() const { return mBase != NULL; }
+
+	/**
+	 * @fn GetPath
+	 * @return store file path
+	 */
+	const std::string &GetPath() const { return mPath; }
+
+	/**
+	 * @fn Insert
+	 * @brief Store file content, replacing an entry of same url. An entry with same non empty
+	 *        validator and length is only marked as used
+	 * @param[in] url - key
+	 * @param[in] validator - ETag or Last-Modified of response, may be empty
+	 * @param[in] effectiveUrl - final url after redirection
+	 * @param[in] type - MediaType of file
+	 * @param[in] data - file content
+	 * @param[in] len - file length
+	 * @param[in] now - wall clock seconds
+	 * @retval true if stored
+	 */
+	bool Insert(const std::string &url, const std::string &validator, const std::string &effectiveUrl, int type, const char *data, size_t len, int64_t now);
+
+	/**
+	 * @fn Retrieve
+	 * @brief Read stored file and mark entry as used. Expired and corrupt entries are removed
+	 * @param[in] url - key
+	 * @param[out] data - file content
+	 * @param[out] effectiveUrl - final url after redirection
+	 * @param[out] type - MediaType of file
+	 * @param[out] validator - ETag or Last-Modified of stored response, may be NULL
+	 * @param[in] now - wall clock seconds
+	 * @param[in] maxAge - seconds an entry is served after it was stored, 0 for no limit
+	 * @retval true if found
+	 */
+	bool Retrieve(const std::string &url, std::vector<char> &data, std::string &effectiveUrl, int &type, std::string *validator, int64_t now, int64_t maxAge);
+
+	/**
+	 * @fn Remove
+	 * @param[in] url - key
+	 * @retval true if an entry was removed
+	 */
+	bool Remove(const std::string &url);
+
+	/**
+	 * @fn GetEntryCount
+	 * @return number of stored entries
+	 */
+	size_t GetEntryCount();
+
+	/**
+	 * @fn GetUsedBytes
+	 * @return bytes of data area held by stored entries
+	 */
+	size_t GetUsedBytes();
+
+private:
+	/**
+	 * @fn LoadIndex
+	 * @brief Build url lookup from entry table, dropping entries which are out of bounds or overlap
+	 * @return void
+	 */
+	void LoadIndex();
+
+	/**
+	 * @fn Allocate
+	 * @brief Find free slot and data area for a record, evicting least recently used entries
+	 * @param[in] size - record size
+	 * @param[out] offset - record offset
+	 * @return slot index, -1 if record cannot fit
+	 */
+	int Allocate(uint32_t size, uint64_t &offset);
+
+	/**
+	 * @fn RemoveSlot
+	 * @param[in] index - slot index
+	 * @return void
+	 */
+	void RemoveSlot(uint32_t index);
+
+	/**
+	 * @fn Touch
+	 * @brief Mark entry as most recently used
+	 * @param[in] index - slot index
+	 * @return void
+	 */
+	void Touch(uint32_t index);
+
+	std::mutex mMutex;
+	std::string mPath;			/**< Store file */
+	int mFd;				/**< Store file descriptor, locked while open */
+	char *mBase;				/**< Mapped file */
+	size_t mCapacity;			/**< Mapped size */
+	uint64_t mDataStart;			/**< Offset of data area, after entry table */
+	AampDiskCacheHeader *mHeader;		/**< Header in mapped file */
+	AampDiskCacheSlot *mSlots;		/**< Entry table in mapped file */
+	std::unordered_map<std::string, uint32_t> mIndex;	/**< url to slot index */
+	size_t mUsedBytes;			/**< Sum of record sizes of stored entries */
+};
+
+#endif /* __AAMP_DISK_CACHE_H__ */
@@ -0,0 +1,583 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampDownloadEngine.cpp
+ * @brief curl_multi based download engine serving all transfers of a player from one thread
+ */
+
+#include "AampDownloadEngine.h"
+#include "AampUtils.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <functional>
+
+/**
+ * @brief AampDownloadEngine Constructor
+ */
+AampDownloadEngine::AampDownloadEngine(AampLogManager *logObj, int maxTransfers) : mMutex(), mCond(), mThread(), mRunning(false), mMulti(NULL),
+	mWakeupFds(), mMaxTransfers(maxTransfers), mMultiplex(false), mSequence(0), mPending(), mActive(), mPrefetch(), mConnectionStreams(), mStats(), mLogObj(logObj)
+{
+	mWakeupFds[0] = -1;
+	mWakeupFds[1] = -1;
+}
+
+/**
+ * @brief AampDownloadEngine Destructor
+ */
+AampDownloadEngine::~AampDownloadEngine()
+{
+	Stop();
+}
+
+/**
+ * @brief Start event loop thread
+ */
+bool AampDownloadEngine::Start()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (mRunning)
+	{
+		return true;
+	}
+	if (0 != pipe(mWakeupFds))
+	{
+		AAMPLOG_ERR("Failed to create wakeup pipe for download engine");
+		mWakeupFds[0] = mWakeupFds[1] = -1;
+		return false;
+	}
+	for (int idx = 0; idx < 2; idx++)
+	{
+		fcntl(mWakeupFds[idx], F_SETFL, fcntl(mWakeupFds[idx], F_GETFL) | O_NONBLOCK);
+	}
+	mMulti = curl_multi_init();
+	if (!mMulti)
+	{
+		AAMPLOG_ERR("curl_multi_init failed");
+		close(mWakeupFds[0]);
+		close(mWakeupFds[1]);
+		mWakeupFds[0] = mWakeupFds[1] = -1;
+		return false;
+	}
+	// all transfers of the engine share the connection cache of its multi handle
+	curl_multi_setopt(mMulti, CURLMOPT_PIPELINING, mMultiplex ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+	mStats = AampDownloadEngineStats();
+	mRunning = true;
+	try
+	{
+		mThread = std::thread(std::bind(&AampDownloadEngine::RunLoop, this));
+	}
+	catch (std::exception &e)
+	{
+		AAMPLOG_ERR("Failed to create download engine thread : %s", e.what());
+		mRunning = false;
+		curl_multi_cleanup(mMulti);
+		mMulti = NULL;
+		close(mWakeupFds[0]);
+		close(mWakeupFds[1]);
+		mWakeupFds[0] = mWakeupFds[1] = -1;
+		return false;
+	}
+	AAMPLOG_INFO("Download engine started, maxTransfers:%d multiplex:%d", mMaxTransfers, mMultiplex);
+	return true;
+}
+
+/**
+ * @brief Abort all transfers and stop event loop thread
+ */
+void AampDownloadEngine::Stop()
+{
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		if (!mRunning)
+		{
+			return;
+		}
+		mRunning = false;
+		for (int type = 0; type < eMEDIATYPE_DEFAULT; type++)
+		{
+			mStats.discarded += mPrefetch[type].size();
+			mPrefetch[type].clear();
+		}
+		WakeupLocked();
+	}
+	if (mThread.joinable())
+	{
+		mThread.join();
+	}
+	std::lock_guard<std::mutex> guard(mMutex);
+	curl_multi_cleanup(mMulti);
+	mMulti = NULL;
+	close(mWakeupFds[0]);
+	close(mWakeupFds[1]);
+	mWakeupFds[0] = mWakeupFds[1] = -1;
+	AAMPLOG_INFO("Download engine stopped");
+}
+
+/**
+ * @brief Check if event loop is running
+ */
+bool AampDownloadEngine::IsRunning()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	return mRunning;
+}
+
+/**
+ * @brief Set maximum transfers in flight
+ */
+void AampDownloadEngine::SetMaxTransfers(int maxTransfers)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	mMaxTransfers = (maxTransfers > 0) ? maxTransfers : 1;
+	WakeupLocked();
+}
+
+/**
+ * @brief Enable HTTP/2 multiplexing
+ */
+void AampDownloadEngine::SetMultiplex(bool multiplex)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	mMultiplex = multiplex;
+}
+
+/**
+ * @brief Get HTTP/2 stream weight (1-256) of a transfer priority
+ */
+static long GetStreamWeight(AampDownloadPriority priority)
+{
+	long weight;
+	switch (priority)
+	{
+		case eDOWNLOAD_PRIORITY_MEDIA:
+			weight = 256;
+			break;
+		case eDOWNLOAD_PRIORITY_PREFETCH:
+			weight = 128;
+			break;
+		case eDOWNLOAD_PRIORITY_PLAYLIST:
+			weight = 64;
+			break;
+		default:
+			weight = 16;
+			break;
+	}
+	return weight;
+}
+
+/**
+ * @brief Get priority of a blocking download of given media type
+ */
+AampDownloadPriority AampDownloadEngine::GetPriorityForMediaType(MediaType type)
+{
+	AampDownloadPriority priority;
+	switch (type)
+	{
+		case eMEDIATYPE_VIDEO:
+		case eMEDIATYPE_AUDIO:
+		case eMEDIATYPE_AUX_AUDIO:
+		case eMEDIATYPE_INIT_VIDEO:
+		case eMEDIATYPE_INIT_AUDIO:
+		case eMEDIATYPE_INIT_AUX_AUDIO:
+			priority = eDOWNLOAD_PRIORITY_MEDIA;
+			break;
+		case eMEDIATYPE_MANIFEST:
+		case eMEDIATYPE_PLAYLIST_VIDEO:
+		case eMEDIATYPE_PLAYLIST_AUDIO:
+		case eMEDIATYPE_PLAYLIST_SUBTITLE:
+		case eMEDIATYPE_PLAYLIST_AUX_AUDIO:
+			priority = eDOWNLOAD_PRIORITY_PLAYLIST;
+			break;
+		default:
+			priority = eDOWNLOAD_PRIORITY_AUXILIARY;
+			break;
+	}
+	return priority;
+}
+
+/**
+ * @brief Add request to pending queue in priority order
+ */
+void AampDownloadEngine::QueueLocked(std::shared_ptr<AampDownloadRequest> request)
+{
+	request->sequence = ++mSequence;
+	auto it = mPending.begin();
+	while (it != mPending.end() && (*it)->priority <= request->priority)
+	{
+		++it;
+	}
+	mPending.insert(it, request);
+}
+
+/**
+ * @brief Mark request cancelled
+ */
+void AampDownloadEngine::CancelLocked(std::shared_ptr<AampDownloadRequest> request)
+{
+	request->cancelled = true;
+	mStats.discarded++;
+}
+
+/**
+ * @brief Interrupt curl_multi_wait of event loop
+ */
+void AampDownloadEngine::WakeupLocked()
+{
+	if (mWakeupFds[1] >= 0)
+	{
+		char c = 0;
+		if (write(mWakeupFds[1], &c, 1) < 0)
+		{
+			// pipe already holds a pending wakeup
+		}
+	}
+}
+
+/**
+ * @brief Run a configured easy handle on event loop and wait for its completion
+ */
+CURLcode AampDownloadEngine::Perform(CURL *curl, AampDownloadPriority priority)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!mRunning)
+	{
+		lock.unlock();
+		return curl_easy_perform(curl);
+	}
+	std::shared_ptr<AampDownloadRequest> request = std::make_shared<AampDownloadRequest>();
+	request->curl = curl;
+	request->priority = priority;
+	QueueLocked(request);
+	mStats.performed++;
+	WakeupLocked();
+	mCond.wait(lock, [&request] { return request->done; });
+	return request->result;
+}
+
+/**
+ * @brief Check if a prefetch can be queued
+ */
+bool AampDownloadEngine::CanPrefetch(MediaType type, const std::string &url, const std::string &range, int maxOutstanding)
+{
+	if (type < 0 || type >= eMEDIATYPE_DEFAULT)
+	{
+		return false;
+	}
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (!mRunning || (int)mPrefetch[type].size() >= maxOutstanding)
+	{
+		return false;
+	}
+	for (auto &queued : mPrefetch[type])
+	{
+		if (queued->url == url && queued->range == range)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Queue a lookahead download
+ */
+bool AampDownloadEngine::Prefetch(std::shared_ptr<AampDownloadRequest> request, int maxOutstanding)
+{
+	if (!request || !request->curl || request->type < 0 || request->type >= eMEDIATYPE_DEFAULT)
+	{
+		return false;
+	}
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		std::deque<std::shared_ptr<AampDownloadRequest>> &queue = mPrefetch[request->type];
+		if (!mRunning || (int)queue.size() >= maxOutstanding)
+		{
+			return false;
+		}
+		for (auto &queued : queue)
+		{
+			if (queued->url == request->url && queued->range == request->range)
+			{
+				return false;
+			}
+		}
+		request->priority = eDOWNLOAD_PRIORITY_PREFETCH;
+		queue.push_back(request);
+		QueueLocked(request);
+		mStats.prefetched++;
+		WakeupLocked();
+	}
+	AAMPLOG_TRACE("Prefetch queued type:%d url:%s", request->type, request->url.c_str());
+	return true;
+}
+
+/**
+ * @brief Take over a prefetched download
+ */
+std::shared_ptr<AampDownloadRequest> AampDownloadEngine::ClaimPrefetch(MediaType type, const std::string &url, const std::string &range)
+{
+	std::shared_ptr<AampDownloadRequest> request;
+	if (type < 0 || type >= eMEDIATYPE_DEFAULT)
+	{
+		return request;
+	}
+	std::unique_lock<std::mutex> lock(mMutex);
+	std::deque<std::shared_ptr<AampDownloadRequest>> &queue = mPrefetch[type];
+	if (!mRunning || queue.empty())
+	{
+		return request;
+	}
+	size_t idx = 0;
+	while (idx < queue.size() && !(queue[idx]->url == url && queue[idx]->range == range))
+	{
+		idx++;
+	}
+	// entries ahead of the match were skipped by the track; with no match the track has moved elsewhere
+	for (size_t stale = 0; stale < idx; stale++)
+	{
+		CancelLocked(queue.front());
+		queue.pop_front();
+	}
+	if (idx)
+	{
+		WakeupLocked();
+	}
+	if (queue.empty())
+	{
+		return request;
+	}
+	request = queue.front();
+	queue.pop_front();
+	mCond.wait(lock, [&request] { return request->done; });
+	if (request->cancelled)
+	{ // engine stopped while waiting
+		request.reset();
+	}
+	else
+	{
+		mStats.claimed++;
+	}
+	return request;
+}
+
+/**
+ * @brief Cancel prefetches of a media type
+ */
+void AampDownloadEngine::CancelPrefetch(MediaType type)
+{
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		for (int idx = 0; idx < eMEDIATYPE_DEFAULT; idx++)
+		{
+			if (type == eMEDIATYPE_DEFAULT || type == idx)
+			{
+				for (auto &queued : mPrefetch[idx])
+				{
+					CancelLocked(queued);
+				}
+				mPrefetch[idx].clear();
+			}
+		}
+		WakeupLocked();
+	}
+}
+
+/**
+ * @brief Get copy of engine counters
+ */
+AampDownloadEngineStats AampDownloadEngine::GetStats()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	return mStats;
+}
+
+/**
+ * @brief Track transfers sharing a connection
+ */
+void AampDownloadEngine::UpdateStreamConcurrency()
+{
+	mConnectionStreams.clear();
+	for (auto &active : mActive)
+	{
+		curl_socket_t sock = CURL_SOCKET_BAD;
+		if (CURLE_OK != curl_easy_getinfo(active.first, CURLINFO_ACTIVESOCKET, &sock) || CURL_SOCKET_BAD == sock)
+		{
+			continue; // not connected yet
+		}
+		bool found = false;
+		for (auto &conn : mConnectionStreams)
+		{
+			if (conn.first == sock)
+			{
+				conn.second++;
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+		{
+			mConnectionStreams.push_back(std::make_pair(sock, 1));
+		}
+	}
+	for (auto &conn : mConnectionStreams)
+	{
+		if (conn.second > mStats.peakStreamsPerConnection)
+		{
+			mStats.peakStreamsPerConnection = conn.second;
+		}
+	}
+}
+
+/**
+ * @brief Event loop thread function
+ */
+void AampDownloadEngine::RunLoop()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (mRunning)
+	{
+		bool completed = false;
+		for (auto it = mActive.begin(); it != mActive.end();)
+		{
+			if (it->second->cancelled)
+			{
+				curl_multi_remove_handle(mMulti, it->first);
+				it->second->result = CURLE_ABORTED_BY_CALLBACK;
+				it->second->done = true;
+				it = mActive.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		while (!mPending.empty() && (int)mActive.size() < mMaxTransfers)
+		{
+			std::shared_ptr<AampDownloadRequest> request = mPending.front();
+			mPending.pop_front();
+			if (request->cancelled)
+			{
+				request->result = CURLE_ABORTED_BY_CALLBACK;
+				request->done = true;
+				continue;
+			}
+			request->startTimeMs = NOW_STEADY_TS_MS;
+			if (mMultiplex)
+			{
+				curl_easy_setopt(request->curl, CURLOPT_PIPEWAIT, 1L);
+				curl_easy_setopt(request->curl, CURLOPT_STREAM_WEIGHT, GetStreamWeight(request->priority));
+			}
+			else
+			{
+				curl_easy_setopt(request->curl, CURLOPT_PIPEWAIT, 0L); // handles are reused across sessions
+			}
+			CURLMcode rc = curl_multi_add_handle(mMulti, request->curl);
+			if (CURLM_OK != rc)
+			{
+				AAMPLOG_ERR("curl_multi_add_handle failed:%d type:%d", rc, request->type);
+				request->result = CURLE_FAILED_INIT;
+				request->done = true;
+				completed = true;
+				continue;
+			}
+			mActive[request->curl] = request;
+		}
+		if ((int)mActive.size() > mStats.peakActive)
+		{
+			mStats.peakActive = (int)mActive.size();
+		}
+		lock.unlock();
+
+		// transfer callbacks run from here, engine lock must not be held
+		int running = 0;
+		curl_multi_perform(mMulti, &running);
+
+		lock.lock();
+		if (mMultiplex)
+		{
+			UpdateStreamConcurrency();
+		}
+		CURLMsg *msg = NULL;
+		int msgsLeft = 0;
+		while ((msg = curl_multi_info_read(mMulti, &msgsLeft)) != NULL)
+		{
+			if (CURLMSG_DONE == msg->msg)
+			{
+				CURL *easy = msg->easy_handle;
+				CURLcode result = msg->data.result;
+				long connects = 0;
+				if (CURLE_OK == curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects))
+				{
+					mStats.connects += connects;
+				}
+				mStats.transfers++;
+				curl_multi_remove_handle(mMulti, easy);
+				auto it = mActive.find(easy);
+				if (it != mActive.end())
+				{
+					it->second->result = result;
+					it->second->endTimeMs = NOW_STEADY_TS_MS;
+					it->second->done = true;
+					mActive.erase(it);
+					completed = true;
+				}
+			}
+		}
+		if (completed)
+		{
+			mCond.notify_all();
+		}
+		if (!mRunning)
+		{
+			break;
+		}
+		lock.unlock();
+
+		struct curl_waitfd wakeupFd;
+		wakeupFd.fd = mWakeupFds[0];
+		wakeupFd.events = CURL_WAIT_POLLIN;
+		wakeupFd.revents = 0;
+		curl_multi_wait(mMulti, &wakeupFd, 1, AAMP_DOWNLOAD_ENGINE_POLL_MS, NULL);
+		char drain[64];
+		while (read(mWakeupFds[0], drain, sizeof(drain)) > 0)
+		{
+		}
+
+		lock.lock();
+	}
+
+	// stopping, abort whatever is left so that waiting tracks return
+	for (auto &active : mActive)
+	{
+		curl_multi_remove_handle(mMulti, active.first);
+		active.second->result = CURLE_ABORTED_BY_CALLBACK;
+		active.second->cancelled = true;
+		active.second->done = true;
+	}
+	mActive.clear();
+	for (auto &pending : mPending)
+	{
+		pending->result = CURLE_ABORTED_BY_CALLBACK;
+		pending->cancelled = true;
+		pending->done = true;
+	}
+	mPending.clear();
+	mCond.notify_all();
+}
@@ -0,0 +1,284 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampDownloadEngine.h
+ * @brief curl_multi based download engine serving all transfers of a player from one thread
+ */
+
+#ifndef __AAMP_DOWNLOAD_ENGINE_H__
+#define __AAMP_DOWNLOAD_ENGINE_H__
+
+#include <curl/curl.h>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <map>
+#include <vector>
+#include <memory>
+#include <string>
+#include "AampMediaType.h"
+#include "AampLogManager.h"
+
+#define AAMP_DOWNLOAD_ENGINE_POLL_MS	100	/**< Max time event loop waits in curl_multi_wait before re-checking its queues */
+
+/**
+ * @enum AampDownloadPriority
+ * @brief Order in which queued transfers are started when engine is at its transfer limit
+ */
+enum AampDownloadPriority
+{
+	eDOWNLOAD_PRIORITY_MEDIA,		/**< Audio/video fragments and init fragments a track is waiting for */
+	eDOWNLOAD_PRIORITY_PLAYLIST,		/**< Manifest and playlists */
+	eDOWNLOAD_PRIORITY_AUXILIARY,		/**< Subtitle, iframe, DAI, AES key and other downloads */
+	eDOWNLOAD_PRIORITY_PREFETCH		/**< Lookahead fragment downloads nobody is waiting for yet */
+};
+
+/**
+ * @struct AampDownloadRequest
+ * @brief A transfer run by the download engine
+ *
+ * Owner of the easy handle is responsible for its cleanup. Prefetch requests are expected
+ * to be derived, to carry the callback contexts and buffer their easy handle writes into.
+ */
+struct AampDownloadRequest
+{
+	CURL *curl;				/**< Easy handle, fully configured before queuing */
+	MediaType type;				/**< Media type, prefetch requests are tracked per type */
+	AampDownloadPriority priority;		/**< Start order when queued */
+	std::string url;			/**< Url used to match a prefetch with a later request */
+	std::string range;			/**< Byte range used to match a prefetch with a later request */
+	bool done;				/**< Transfer finished, removed from multi handle */
+	bool cancelled;				/**< Transfer abandoned, result is not used */
+	CURLcode result;			/**< Transfer result, valid when done */
+	long long startTimeMs;			/**< Time transfer was added to multi handle */
+	long long endTimeMs;			/**< Time transfer finished */
+	unsigned long sequence;			/**< Queuing order, keeps requests of same priority FIFO */
+
+	AampDownloadRequest() : curl(NULL), type(eMEDIATYPE_DEFAULT), priority(eDOWNLOAD_PRIORITY_MEDIA), url(), range(),
+		done(false), cancelled(false), result(CURLE_OK), startTimeMs(0), endTimeMs(0), sequence(0)
+	{
+	}
+
+	virtual ~AampDownloadRequest()
+	{
+	}
+
+	AampDownloadRequest(const AampDownloadRequest&) = delete;
+	AampDownloadRequest& operator=(const AampDownloadRequest&) = delete;
+};
+
+/**
+ * @struct AampDownloadEngineStats
+ * @brief Counters reported by the download engine
+ */
+struct AampDownloadEngineStats
+{
+	unsigned long performed;	/**< Number of blocking transfers run by engine */
+	unsigned long prefetched;	/**< Number of prefetch transfers queued */
+	unsigned long claimed;		/**< Number of prefetch transfers handed over to a track */
+	unsigned long discarded;	/**< Number of prefetch transfers dropped as stale or cancelled */
+	int peakActive;			/**< Maximum transfers in flight at the same time */
+	unsigned long transfers;	/**< Number of transfers completed on multi handle */
+	unsigned long connects;		/**< Number of new connections opened for those transfers */
+	int peakStreamsPerConnection;	/**< Maximum transfers multiplexed on one connection at the same time */
+
+	AampDownloadEngineStats() : performed(0), prefetched(0), claimed(0), discarded(0), peakActive(0), transfers(0), connects(0), peakStreamsPerConnection(0)
+	{
+	}
+};
+
+/**
+ * @class AampDownloadEngine
+ * @brief Runs transfers of a player instance on a single curl_multi event loop thread
+ *
+ * Tracks keep using their own configured easy handles; Perform() hands a handle to the
+ * event loop and blocks the calling track until it is done, so all tracks share one
+ * connection cache. Prefetch() queues lookahead downloads for following fragments of a
+ * track; results are held by the engine until the track asks for the same url through
+ * ClaimPrefetch(), so fragments still reach the track in playlist order.
+ * All curl_multi calls are made from event loop thread only.
+ */
+class AampDownloadEngine
+{
+public:
+	/**
+	 * @fn AampDownloadEngine
+	 * @param[in] logObj - log object
+	 * @param[in] maxTransfers - maximum transfers in flight, further requests wait in priority order
+	 */
+	AampDownloadEngine(AampLogManager *logObj, int maxTransfers);
+
+	/**
+	 * @fn ~AampDownloadEngine
+	 */
+	~AampDownloadEngine();
+
+	AampDownloadEngine(const AampDownloadEngine&) = delete;
+	AampDownloadEngine& operator=(const AampDownloadEngine&) = delete;
+
+	/**
+	 * @fn Start
+	 * @brief Start event loop thread, no-op if already running. Counters are reset on start
+	 * @return true if event loop is running
+	 */
+	bool Start();
+
+	/**
+	 * @fn Stop
+	 * @brief Abort all transfers and stop event loop thread
+	 */
+	void Stop();
+
+	/**
+	 * @fn IsRunning
+	 * @return true if event loop is running
+	 */
+	bool IsRunning();
+
+	/**
+	 * @fn SetMaxTransfers
+	 * @param[in] maxTransfers - maximum transfers in flight
+	 */
+	void SetMaxTransfers(int maxTransfers);
+
+	/**
+	 * @fn SetMultiplex
+	 * @brief Enable HTTP/2 multiplexing of transfers to the same host, applied on next Start
+	 *
+	 * Transfers then wait for a multiplexable connection instead of opening new ones and
+	 * get a HTTP/2 stream weight from their priority.
+	 * @param[in] multiplex - true to multiplex
+	 */
+	void SetMultiplex(bool multiplex);
+
+	/**
+	 * @fn Perform
+	 * @brief Run a configured easy handle on event loop and wait for its completion
+	 *
+	 * Falls back to curl_easy_perform on calling thread when event loop is not running.
+	 * @param[in] curl - configured easy handle
+	 * @param[in] priority - start order when engine is at its transfer limit
+	 * @return transfer result
+	 */
+	CURLcode Perform(CURL *curl, AampDownloadPriority priority);
+
+	/**
+	 * @fn CanPrefetch
+	 * @param[in] type - media type
+	 * @param[in] url - fragment url
+	 * @param[in] range - byte range, empty if none
+	 * @param[in] maxOutstanding - maximum prefetch transfers held for the media type
+	 * @return true if url is not yet queued and media type has room for another prefetch
+	 */
+	bool CanPrefetch(MediaType type, const std::string &url, const std::string &range, int maxOutstanding);
+
+	/**
+	 * @fn Prefetch
+	 * @brief Queue a lookahead download
+	 *
+	 * @param[in] request - configured request, its easy handle writes into memory owned by request
+	 * @param[in] maxOutstanding - maximum prefetch transfers held for the media type
+	 * @return true if queued
+	 */
+	bool Prefetch(std::shared_ptr<AampDownloadRequest> request, int maxOutstanding);
+
+	/**
+	 * @fn ClaimPrefetch
+	 * @brief Take over a prefetched download, waiting for it to finish if still in flight
+	 *
+	 * Prefetches of the media type queued before the claimed one are stale (skipped
+	 * fragments) and get cancelled. If url was not prefetched, all prefetches of the media
+	 * type are cancelled as the track moved elsewhere (seek, profile switch).
+	 * @param[in] type - media type
+	 * @param[in] url - fragment url
+	 * @param[in] range - byte range, empty if none
+	 * @return finished request, NULL if url was not prefetched or engine stopped meanwhile
+	 */
+	std::shared_ptr<AampDownloadRequest> ClaimPrefetch(MediaType type, const std::string &url, const std::string &range);
+
+	/**
+	 * @fn CancelPrefetch
+	 * @param[in] type - media type, eMEDIATYPE_DEFAULT to cancel prefetches of all media types
+	 */
+	void CancelPrefetch(MediaType type);
+
+	/**
+	 * @fn GetStats
+	 * @return copy of engine counters
+	 */
+	AampDownloadEngineStats GetStats();
+
+	/**
+	 * @fn GetPriorityForMediaType
+	 * @param[in] type - media type of a blocking download
+	 * @return priority for the media type
+	 */
+	static AampDownloadPriority GetPriorityForMediaType(MediaType type);
+
+private:
+	/**
+	 * @fn RunLoop
+	 * @brief Event loop thread function
+	 */
+	void RunLoop();
+
+	/**
+	 * @fn QueueLocked
+	 * @brief Add request to pending queue in priority order, called with mMutex held
+	 */
+	void QueueLocked(std::shared_ptr<AampDownloadRequest> request);
+
+	/**
+	 * @fn CancelLocked
+	 * @brief Mark request cancelled, event loop drops it, called with mMutex held
+	 */
+	void CancelLocked(std::shared_ptr<AampDownloadRequest> request);
+
+	/**
+	 * @fn WakeupLocked
+	 * @brief Interrupt curl_multi_wait of event loop, called with mMutex held
+	 */
+	void WakeupLocked();
+
+	/**
+	 * @fn UpdateStreamConcurrency
+	 * @brief Track transfers sharing a connection, called from event loop with mMutex held
+	 */
+	void UpdateStreamConcurrency();
+
+	std::mutex mMutex;
+	std::condition_variable mCond;			/**< Signalled when a request completes */
+	std::thread mThread;
+	bool mRunning;
+	CURLM *mMulti;
+	int mWakeupFds[2];				/**< Pipe used to interrupt curl_multi_wait */
+	int mMaxTransfers;
+	bool mMultiplex;				/**< HTTP/2 multiplexing enabled for current run */
+	unsigned long mSequence;
+	std::deque<std::shared_ptr<AampDownloadRequest>> mPending;		/**< Requests waiting for a transfer slot, in priority order */
+	std::map<CURL *, std::shared_ptr<AampDownloadRequest>> mActive;	/**< Requests added to multi handle */
+	std::deque<std::shared_ptr<AampDownloadRequest>> mPrefetch[eMEDIATYPE_DEFAULT];	/**< Unclaimed prefetches per media type, in playlist order */
+	std::vector<std::pair<curl_socket_t, int>> mConnectionStreams;	/**< Scratch list of active transfers per connection socket */
+	AampDownloadEngineStats mStats;
+	AampLogManager *mLogObj;
+};
+
+#endif /* __AAMP_DOWNLOAD_ENGINE_H__ */
@@ -48,12 +48,16 @@ guint AampEventManager::GetSourceID()
  */
 AampEventManager::AampEventManager(AampLogManager *logObj): mIsFakeTune(false),mLogObj(logObj),
 					mAsyncTuneEnabled(false),mEventPriority(G_PRIORITY_DEFAULT_IDLE),mMutexVar(PTHREAD_MUTEX_INITIALIZER),
-					mPlayerState(eSTATE_IDLE),mEventWorkerDataQue(),mPendingAsyncEvents()
+					mPlayerState(eSTATE_IDLE),mEventWorkerDataQue(),mPendingAsyncEvents(),
+					mBatchDispatch(false),mBatchDispatchPending(false),mRateLimitTimerPending(false),mEventSequence(0)
 {
 	for (int i = 0; i < AAMP_MAX_NUM_EVENTS; i++)
 	{
 		mEventListeners[i]	= NULL;
 		mEventStats[i]		=	 0;
+		mLatestSequence[i]	=	 0;
+		mEventRateLimitMs[i]	=	 0;
+		mLastDispatchUs[i]	=	 0;
 	}
 }
 
@@ -88,7 +92,7 @@ void AampEventManager::FlushPendingEvents()
 	while(!mEventWorkerDataQue.empty())
 	{
 		// Remove each AampEventPtr from the queue , not deleting the Shard_ptr
-		mEventWorkerDataQue.pop();
+		mEventWorkerDataQue.pop_front();
 	}
 
 	if (mPendingAsyncEvents.size() > 0)
@@ -105,9 +109,21 @@ void AampEventManager::FlushPendingEvents()
 		}
 		mPendingAsyncEvents.clear();
 	}
+	mBatchDispatchPending = false;
+	mRateLimitTimerPending = false;
 
 	for (int i = 0; i < AAMP_MAX_NUM_EVENTS; i++)
+	{
+		if (mDispatchStats[i].dispatched)
+		{
+			AAMPLOG_INFO("EventType[%d] dispatched %lu merged %lu latencyUs avg %lld max %lld", i, mDispatchStats[i].dispatched,
+				mDispatchStats[i].merged, mDispatchStats[i].totalLatencyUs / (long long)mDispatchStats[i].dispatched, mDispatchStats[i].maxLatencyUs);
+		}
 		mEventStats[i] = 0;
+		mLatestSequence[i] = 0;
+		mLastDispatchUs[i] = 0;
+		mDispatchStats[i] = AampEventDispatchStats();
+	}
 	pthread_mutex_unlock(&mMutexVar);
 
 #ifdef EVENT_DEBUGGING
@@ -258,6 +274,85 @@ void AampEventManager::SetAsyncTuneState(bool isAsyncTuneSetting)
 	pthread_mutex_unlock(&mMutexVar);
 }
 
+/**
+ * @brief SetBatchDispatch - Flag for draining async events in one idle task
+ */
+void AampEventManager::SetBatchDispatch(bool enable)
+{
+	pthread_mutex_lock(&mMutexVar);
+	mBatchDispatch = enable;
+	pthread_mutex_unlock(&mMutexVar);
+}
+
+/**
+ * @brief SetEventRateLimit - Minimum time between batch dispatches of coalescable events
+ */
+bool AampEventManager::SetEventRateLimit(AAMPEventType eventType, int intervalMs)
+{
+	bool retVal = false;
+	pthread_mutex_lock(&mMutexVar);
+	for (int i = AAMP_EVENT_TUNED; i < AAMP_MAX_NUM_EVENTS; i++)
+	{
+		if (IsCoalescable((AAMPEventType)i) && (eventType == AAMP_EVENT_ALL_EVENTS || eventType == i))
+		{
+			mEventRateLimitMs[i] = (intervalMs > 0) ? intervalMs : 0;
+			retVal = true;
+		}
+	}
+	pthread_mutex_unlock(&mMutexVar);
+	return retVal;
+}
+
+/**
+ * @brief GetDispatchStats - Async dispatch stats of one event type
+ */
+void AampEventManager::GetDispatchStats(AAMPEventType eventType, AampEventDispatchStats &stats)
+{
+	pthread_mutex_lock(&mMutexVar);
+	if ((eventType >= AAMP_EVENT_ALL_EVENTS) && (eventType < AAMP_MAX_NUM_EVENTS))
+	{
+		stats = mDispatchStats[eventType];
+	}
+	else
+	{
+		stats = AampEventDispatchStats();
+	}
+	pthread_mutex_unlock(&mMutexVar);
+}
+
+/**
+ * @brief IsCoalescable - Events carrying the latest state only, a later one makes a queued one obsolete
+ */
+bool AampEventManager::IsCoalescable(AAMPEventType eventType)
+{
+	switch (eventType)
+	{
+		case AAMP_EVENT_PROGRESS:
+		case AAMP_EVENT_SPEEDS_CHANGED:
+		case AAMP_EVENT_AUDIO_TRACKS_CHANGED:
+		case AAMP_EVENT_TEXT_TRACKS_CHANGED:
+		case AAMP_EVENT_AD_PLACEMENT_PROGRESS:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * @brief UpdateDispatchStats - Count dispatch of an async event and its time in queue
+ */
+void AampEventManager::UpdateDispatchStats(const QueuedEvent &queued, gint64 nowUs)
+{
+	AampEventDispatchStats &stats = mDispatchStats[queued.eventData->getType()];
+	long long latencyUs = (long long)(nowUs - queued.queuedUs);
+	stats.dispatched++;
+	stats.totalLatencyUs += latencyUs;
+	if (latencyUs > stats.maxLatencyUs)
+	{
+		stats.maxLatencyUs = latencyUs;
+	}
+}
+
 /**
  * @brief SetPlayerState - Flag to update player state
  */
@@ -326,8 +421,9 @@ void AampEventManager::AsyncEvent()
 	// pop out the event to sent in async mode
 	if(mEventWorkerDataQue.size())
 	{
-		eventData = (AAMPEventPtr)mEventWorkerDataQue.front();
-		mEventWorkerDataQue.pop();
+		eventData = mEventWorkerDataQue.front().eventData;
+		UpdateDispatchStats(mEventWorkerDataQue.front(), g_get_monotonic_time());
+		mEventWorkerDataQue.pop_front();
 	}
 	pthread_mutex_unlock(&mMutexVar);
 	// Push the new event in sync mode from the idle task
@@ -336,6 +432,100 @@ void AampEventManager::AsyncEvent()
 	}
 }
 
+/**
+ * @brief BatchAsyncEvent - Task function draining the async queue in one idle task
+ */
+void AampEventManager::BatchAsyncEvent(bool fromTimer)
+{
+	EventWorkerDataQ batch;
+	EventWorkerDataQ held;
+	gint64 holdUs = 0;
+	pthread_mutex_lock(&mMutexVar);
+	if (fromTimer)
+	{
+		mRateLimitTimerPending = false;
+	}
+	else
+	{
+		mBatchDispatchPending = false;
+	}
+	// events queued from now on, also by listeners, go to the next idle task
+	batch.swap(mEventWorkerDataQue);
+	pthread_mutex_unlock(&mMutexVar);
+
+	gint64 nowUs = g_get_monotonic_time();
+	while (!batch.empty())
+	{
+		QueuedEvent queued = batch.front();
+		batch.pop_front();
+		AAMPEventType eventType = queued.eventData->getType();
+		bool dispatch = true;
+		pthread_mutex_lock(&mMutexVar);
+		if (IsCoalescable(eventType))
+		{
+			if (mLatestSequence[eventType] != 0 && queued.sequence != mLatestSequence[eventType])
+			{
+				// a later event of the type is queued
+				dispatch = false;
+			}
+			else if (mEventRateLimitMs[eventType] && mLastDispatchUs[eventType] &&
+				(nowUs - mLastDispatchUs[eventType]) < mEventRateLimitMs[eventType] * 1000LL)
+			{
+				gint64 waitUs = mLastDispatchUs[eventType] + mEventRateLimitMs[eventType] * 1000LL - nowUs;
+				if (holdUs == 0 || waitUs < holdUs)
+				{
+					holdUs = waitUs;
+				}
+				held.push_back(queued);
+				dispatch = false;
+			}
+			else
+			{
+				mLatestSequence[eventType] = 0;
+				mLastDispatchUs[eventType] = nowUs;
+			}
+		}
+		if (dispatch)
+		{
+			UpdateDispatchStats(queued, nowUs);
+		}
+		pthread_mutex_unlock(&mMutexVar);
+		if (dispatch && IsEventListenerAvailable(eventType) && (mPlayerState != eSTATE_RELEASED))
+		{
+			SendEventSync(queued.eventData);
+		}
+	}
+
+	if (!held.empty())
+	{
+		pthread_mutex_lock(&mMutexVar);
+		bool addTimer = !mRateLimitTimerPending && (mPlayerState != eSTATE_RELEASED);
+		// held events are older than any queued meanwhile
+		while (!held.empty())
+		{
+			mEventWorkerDataQue.push_front(held.back());
+			held.pop_back();
+		}
+		mRateLimitTimerPending = mRateLimitTimerPending || addTimer;
+		pthread_mutex_unlock(&mMutexVar);
+		if (addTimer)
+		{
+			guint intervalMs = (guint)((holdUs + 999) / 1000);
+			guint callbackID = g_timeout_add_full(mEventPriority, intervalMs, RateLimitThreadFunction, this, NULL);
+			if(callbackID != 0)
+			{
+				SetCallbackAsPending(callbackID);
+			}
+			else
+			{
+				pthread_mutex_lock(&mMutexVar);
+				mRateLimitTimerPending = false;
+				pthread_mutex_unlock(&mMutexVar);
+			}
+		}
+	}
+}
+
 /**
  * @brief SendEventAsync - Function to send events Async
  */ 
@@ -347,7 +537,44 @@ void AampEventManager::SendEventAsync(const AAMPEventPtr &eventData)
 	if(mPlayerState != eSTATE_RELEASED)
 	{
 		AAMPLOG_INFO("Sending event %d to AsyncQ", eventType);
-		mEventWorkerDataQue.push(eventData);
+		if (++mEventSequence == 0)
+		{
+			// 0 marks no queued event of a type
+			++mEventSequence;
+		}
+		QueuedEvent queued(eventData, g_get_monotonic_time(), mEventSequence);
+		mEventWorkerDataQue.push_back(queued);
+		if (mBatchDispatch)
+		{
+			if (IsCoalescable(eventType))
+			{
+				if (mLatestSequence[eventType] != 0)
+				{
+					// the queued one is dropped when the batch reaches it
+					mDispatchStats[eventType].merged++;
+				}
+				mLatestSequence[eventType] = queued.sequence;
+			}
+			bool addTask = !mBatchDispatchPending;
+			mBatchDispatchPending = true;
+			pthread_mutex_unlock(&mMutexVar);
+			// One idle task drains all events queued until it runs
+			if (addTask)
+			{
+				guint callbackID = g_idle_add_full(mEventPriority, BatchEventThreadFunction, this, NULL);
+				if(callbackID != 0)
+				{
+					SetCallbackAsPending(callbackID);
+				}
+				else
+				{
+					pthread_mutex_lock(&mMutexVar);
+					mBatchDispatchPending = false;
+					pthread_mutex_unlock(&mMutexVar);
+				}
+			}
+			return;
+		}
 		pthread_mutex_unlock(&mMutexVar);
 		// Every event need a idle task to execute it
 		guint callbackID = g_idle_add_full(mEventPriority, EventManagerThreadFunction, this, NULL);
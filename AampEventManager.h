@@ -34,6 +34,7 @@
 #include <pthread.h>
 #include <signal.h>
 #include <mutex>
+#include <deque>
 #include <queue>
 #include <glib.h>
 
@@ -47,6 +48,21 @@ struct ListenerData {
 	ListenerData* pNext;            /**< Next listener */
 };
 
+/**
+ * @struct AampEventDispatchStats
+ * @brief Async dispatch counters of an event type
+ */
+struct AampEventDispatchStats
+{
+	AampEventDispatchStats() : dispatched(0), merged(0), totalLatencyUs(0), maxLatencyUs(0)
+	{
+	}
+	unsigned long dispatched;		/**< Events sent to listeners from the async queue */
+	unsigned long merged;			/**< Events superseded by a later event of the type before dispatch */
+	long long totalLatencyUs;		/**< Time from queueing to dispatch */
+	long long maxLatencyUs;
+};
+
 /**
  * @class AampEventManager
  * @brief Class to Handle Aamp Events
@@ -64,12 +80,34 @@ private:
 	// Separate registration for each event
 	ListenerData* mEventListeners[AAMP_MAX_NUM_EVENTS];	  /**< Event listener registration */
 	int mEventStats[AAMP_MAX_NUM_EVENTS];			  /**< Event stats */
-	typedef std::queue<AAMPEventPtr> EventWorkerDataQ;	  /**< Event Queue for Async processing  */
+	/**
+	 * @struct QueuedEvent
+	 * @brief Event waiting in the async queue
+	 */
+	struct QueuedEvent
+	{
+		QueuedEvent(const AAMPEventPtr &event, gint64 timeUs, unsigned int eventSequence) : eventData(event),
+			queuedUs(timeUs), sequence(eventSequence)
+		{
+		}
+		AAMPEventPtr eventData;
+		gint64 queuedUs;				  /**< Monotonic time of queueing */
+		unsigned int sequence;				  /**< Order of queueing, to find superseded events */
+	};
+	typedef std::deque<QueuedEvent> EventWorkerDataQ;	  /**< Event Queue for Async processing  */
 	EventWorkerDataQ mEventWorkerDataQue;
 	typedef std::map<guint, bool> AsyncEventList;		  /**< Collection of Async tasks pending */
 	typedef std::map<guint, bool>::iterator AsyncEventListIter;
 	AsyncEventList	mPendingAsyncEvents;
 	AampLogManager *mLogObj;
+	bool mBatchDispatch;					  /**< Drain the whole async queue in one idle task */
+	bool mBatchDispatchPending;				  /**< Idle task draining the queue is added */
+	bool mRateLimitTimerPending;				  /**< Timer for events held by rate limit is added */
+	unsigned int mEventSequence;				  /**< Sequence of last queued event */
+	unsigned int mLatestSequence[AAMP_MAX_NUM_EVENTS];	  /**< Sequence of latest queued coalescable event, 0 if none queued */
+	int mEventRateLimitMs[AAMP_MAX_NUM_EVENTS];		  /**< Minimum time between dispatches of a coalescable type */
+	gint64 mLastDispatchUs[AAMP_MAX_NUM_EVENTS];		  /**< Monotonic time of last batch dispatch of type */
+	AampEventDispatchStats mDispatchStats[AAMP_MAX_NUM_EVENTS]; /**< Async dispatch stats */
 private:
 	/**
 	 * @fn AsyncEvent
@@ -103,6 +141,47 @@ private:
 		evtMgr->AsyncEvent();
 		return G_SOURCE_REMOVE ;
 	}
+	/**
+	 * @brief Idle task entry function for batch Async Event Processing
+	 */
+	static gboolean BatchEventThreadFunction(gpointer This)
+	{
+		guint callbackId =	g_source_get_id(g_main_current_source());
+		AampEventManager *evtMgr = (AampEventManager *)This;
+		evtMgr->SetCallbackAsDispatched(callbackId);
+		evtMgr->BatchAsyncEvent(false);
+		return G_SOURCE_REMOVE ;
+	}
+	/**
+	 * @brief Timer entry function for events held by rate limit
+	 */
+	static gboolean RateLimitThreadFunction(gpointer This)
+	{
+		guint callbackId =	g_source_get_id(g_main_current_source());
+		AampEventManager *evtMgr = (AampEventManager *)This;
+		evtMgr->SetCallbackAsDispatched(callbackId);
+		evtMgr->BatchAsyncEvent(true);
+		return G_SOURCE_REMOVE ;
+	}
+	/**
+	 * @fn BatchAsyncEvent
+	 * @param fromTimer - true if run by the rate limit timer
+	 * @return void
+	 */
+	void BatchAsyncEvent(bool fromTimer);
+	/**
+	 * @fn IsCoalescable
+	 * @param eventType - Aamp Event type
+	 * @return True if a later event of the type supersedes a queued one
+	 */
+	static bool IsCoalescable(AAMPEventType eventType);
+	/**
+	 * @fn UpdateDispatchStats
+	 * @param queued - event taken from the async queue, mMutexVar held
+	 * @param nowUs - monotonic time of dispatch
+	 * @return void
+	 */
+	void UpdateDispatchStats(const QueuedEvent &queued, gint64 nowUs);
 	/**
 	 * @fn SendEventAsync
 	 * @param eventData - Event data
@@ -139,6 +218,26 @@ public:
 	 * @return void
 	 */
 	void SetAsyncTuneState(bool isAsyncTuneSetting);
+	/**
+	 * @fn SetBatchDispatch
+	 * @param enable - True to drain the async queue in one idle task and merge superseded events
+	 * @return void
+	 */
+	void SetBatchDispatch(bool enable);
+	/**
+	 * @fn SetEventRateLimit
+	 * @param eventType - coalescable Aamp Event type, AAMP_EVENT_ALL_EVENTS for all of them
+	 * @param intervalMs - minimum time between batch dispatches of the type, 0 for no limit
+	 * @return True if eventType is coalescable or AAMP_EVENT_ALL_EVENTS
+	 */
+	bool SetEventRateLimit(AAMPEventType eventType, int intervalMs);
+	/**
+	 * @fn GetDispatchStats
+	 * @param eventType - Aamp Event type
+	 * @param[out] stats - async dispatch stats of the type since last FlushPendingEvents
+	 * @return void
+	 */
+	void GetDispatchStats(AAMPEventType eventType, AampEventDispatchStats &stats);
 	/**
 	 * @fn SetPlayerState
 	 * @param state - Aamp Player state
@@ -0,0 +1,247 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampHlsSegmentIndexer.cpp
+ * @brief Segment and discontinuity index of a clear HLS media playlist, updated in place on refresh
+ */
+
+#include "AampHlsSegmentIndexer.h"
+#include "AampUtils.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Retained segment durations may differ by rounding of EXTINF only
+ */
+#define SEGMENT_DURATION_TOLERANCE 0.001
+
+/**
+ * @brief AampHlsSegmentIndexer constructor
+ */
+AampHlsSegmentIndexer::AampHlsSegmentIndexer(GrowableBuffer &index, int &indexCount, GrowableBuffer &discontinuityIndex, int &discontinuityIndexCount) :
+	mIndex(index), mIndexCount(indexCount), mDiscontinuityIndex(discontinuityIndex), mDiscontinuityIndexCount(discontinuityIndexCount),
+	mTotalDuration(0.0), mCulledDuration(0.0), mProgramDateTime(0.0), mProgramDateTimeFound(false),
+	mInitFragmentPtr(NULL), mSegmentProgramDateTime(NULL), mDiscontinuity(false)
+{
+	if (mIndexCount > 0)
+	{
+		mTotalDuration = ((const IndexNode *)mIndex.ptr)[mIndexCount - 1].completionTimeSecondsFromStart;
+	}
+}
+
+/**
+ * @brief Index segments of playlist lines from lineIdx on
+ */
+void AampHlsSegmentIndexer::Append(char *playlist, const std::vector<HlsPlaylistLine> &lines, size_t lineIdx)
+{
+	for (; lineIdx < lines.size(); lineIdx++)
+	{
+		const HlsPlaylistLine &line = lines[lineIdx];
+		char *ptr = playlist + line.offset + line.valueOffset;
+		switch (line.tag)
+		{
+			case eHLS_TAG_EXTINF:
+			{
+				double fragDuration = atof(ptr);
+				if (mDiscontinuity)
+				{
+					DiscontinuityIndexNode discontinuityIndexNode;
+					discontinuityIndexNode.fragmentIdx = mIndexCount;
+					discontinuityIndexNode.position = mTotalDuration;
+					discontinuityIndexNode.discontinuityPDT = 0.0;
+					if (mSegmentProgramDateTime)
+					{
+						discontinuityIndexNode.discontinuityPDT = ISO8601DateTimeToUTCSeconds(mSegmentProgramDateTime);
+					}
+					discontinuityIndexNode.fragmentDuration = fragDuration;
+					aamp_AppendBytes(&mDiscontinuityIndex, &discontinuityIndexNode, sizeof(DiscontinuityIndexNode));
+					mDiscontinuityIndexCount++;
+					mDiscontinuity = false;
+				}
+				mSegmentProgramDateTime = NULL;
+				IndexNode node;
+				mTotalDuration += fragDuration;
+				node.completionTimeSecondsFromStart = mTotalDuration;
+				node.pFragmentInfo = playlist + line.offset; //Point to beginning of #EXTINF
+				node.drmMetadataIdx = -1;
+				node.initFragmentPtr = mInitFragmentPtr;
+				aamp_AppendBytes(&mIndex, &node, sizeof(node));
+				mIndexCount++;
+				break;
+			}
+			case eHLS_TAG_DISCONTINUITY:
+				mDiscontinuity = true;
+				break;
+			case eHLS_TAG_PROGRAM_DATE_TIME:
+				mSegmentProgramDateTime = ptr;
+				SetProgramDateTime(ptr);
+				break;
+			case eHLS_TAG_MAP:
+				mInitFragmentPtr = ptr;
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * @brief Re-index a refreshed playlist that starts culledCount segments after the indexed one
+ */
+bool AampHlsSegmentIndexer::Update(char *playlist, const std::vector<HlsPlaylistLine> &lines, int culledCount)
+{
+	int retainedCount = mIndexCount - culledCount;
+	if (culledCount < 0 || retainedCount <= 0)
+	{
+		return false;
+	}
+	size_t firstExtInf = 0;
+	size_t lastExtInf = 0;
+	size_t tailIdx = FindTail(lines, retainedCount, firstExtInf, lastExtInf);
+	if (tailIdx == 0)
+	{ // playlist lost segments at tail
+		return false;
+	}
+	// retained segments are not parsed, sequence numbering is only checked at both ends
+	const IndexNode *nodes = (const IndexNode *)mIndex.ptr;
+	double firstStart = (culledCount > 0) ? nodes[culledCount - 1].completionTimeSecondsFromStart : 0.0;
+	double firstDuration = nodes[culledCount].completionTimeSecondsFromStart - firstStart;
+	double lastStart = (mIndexCount > 1) ? nodes[mIndexCount - 2].completionTimeSecondsFromStart : 0.0;
+	double lastDuration = nodes[mIndexCount - 1].completionTimeSecondsFromStart - lastStart;
+	if (fabs(atof(playlist + lines[firstExtInf].offset + lines[firstExtInf].valueOffset) - firstDuration) > SEGMENT_DURATION_TOLERANCE ||
+		fabs(atof(playlist + lines[lastExtInf].offset + lines[lastExtInf].valueOffset) - lastDuration) > SEGMENT_DURATION_TOLERANCE)
+	{
+		return false;
+	}
+	Cull(culledCount);
+	Rebase(playlist, lines, tailIdx);
+	Append(playlist, lines, tailIdx);
+	return true;
+}
+
+/**
+ * @brief Find line after EXTINF number retainedCount
+ */
+size_t AampHlsSegmentIndexer::FindTail(const std::vector<HlsPlaylistLine> &lines, int retainedCount, size_t &firstExtInf, size_t &lastExtInf) const
+{
+	int extInfCount = 0;
+	for (size_t lineIdx = 1; lineIdx < lines.size(); lineIdx++)
+	{
+		if (lines[lineIdx].tag == eHLS_TAG_EXTINF)
+		{
+			if (extInfCount == 0)
+			{
+				firstExtInf = lineIdx;
+			}
+			if (++extInfCount == retainedCount)
+			{
+				lastExtInf = lineIdx;
+				return lineIdx + 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Drop head segments in place, moving completion times and discontinuities to the new first segment
+ */
+void AampHlsSegmentIndexer::Cull(int culledCount)
+{
+	IndexNode *nodes = (IndexNode *)mIndex.ptr;
+	mCulledDuration = (culledCount > 0) ? nodes[culledCount - 1].completionTimeSecondsFromStart : 0.0;
+	mIndexCount -= culledCount;
+	if (culledCount > 0)
+	{
+		memmove(nodes, nodes + culledCount, mIndexCount * sizeof(IndexNode));
+		mIndex.len = mIndexCount * sizeof(IndexNode);
+		for (int i = 0; i < mIndexCount; i++)
+		{
+			nodes[i].completionTimeSecondsFromStart -= mCulledDuration;
+		}
+	}
+
+	DiscontinuityIndexNode *discontinuities = (DiscontinuityIndexNode *)mDiscontinuityIndex.ptr;
+	int retained = 0;
+	for (int i = 0; i < mDiscontinuityIndexCount; i++)
+	{
+		if (discontinuities[i].fragmentIdx >= culledCount)
+		{
+			discontinuities[retained] = discontinuities[i];
+			discontinuities[retained].fragmentIdx -= culledCount;
+			discontinuities[retained].position -= mCulledDuration;
+			retained++;
+		}
+	}
+	mDiscontinuityIndexCount = retained;
+	mDiscontinuityIndex.len = retained * sizeof(DiscontinuityIndexNode);
+}
+
+/**
+ * @brief Point retained nodes at lines of refreshed playlist before tailIdx
+ */
+void AampHlsSegmentIndexer::Rebase(char *playlist, const std::vector<HlsPlaylistLine> &lines, size_t tailIdx)
+{
+	IndexNode *nodes = (IndexNode *)mIndex.ptr;
+	int fragmentIdx = 0;
+	mTotalDuration = 0.0;
+	for (size_t lineIdx = 1; lineIdx < tailIdx; lineIdx++)
+	{
+		const HlsPlaylistLine &line = lines[lineIdx];
+		char *ptr = playlist + line.offset + line.valueOffset;
+		switch (line.tag)
+		{
+			case eHLS_TAG_EXTINF:
+				nodes[fragmentIdx].pFragmentInfo = playlist + line.offset;
+				nodes[fragmentIdx].initFragmentPtr = mInitFragmentPtr;
+				mTotalDuration = nodes[fragmentIdx].completionTimeSecondsFromStart;
+				fragmentIdx++;
+				// discontinuities of retained segments are already indexed
+				mDiscontinuity = false;
+				mSegmentProgramDateTime = NULL;
+				break;
+			case eHLS_TAG_DISCONTINUITY:
+				mDiscontinuity = true;
+				break;
+			case eHLS_TAG_PROGRAM_DATE_TIME:
+				mSegmentProgramDateTime = ptr;
+				SetProgramDateTime(ptr);
+				break;
+			case eHLS_TAG_MAP:
+				mInitFragmentPtr = ptr;
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * @brief Record PDT of a line, extrapolated back to first segment if it is the first one
+ */
+void AampHlsSegmentIndexer::SetProgramDateTime(const char *ptr)
+{
+	if (!mProgramDateTimeFound)
+	{
+		mProgramDateTime = ISO8601DateTimeToUTCSeconds(ptr) - mTotalDuration;
+		mProgramDateTimeFound = true;
+	}
+}
@@ -0,0 +1,157 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampHlsSegmentIndexer.h
+ * @brief Segment and discontinuity index of a clear HLS media playlist, updated in place on refresh
+ */
+
+#ifndef __AAMP_HLS_SEGMENT_INDEXER_H__
+#define __AAMP_HLS_SEGMENT_INDEXER_H__
+
+#include <stddef.h>
+#include <vector>
+#include "AampMemoryUtils.h"
+#include "AampHlsTagLexer.h"
+
+/**
+*	\struct	IndexNode
+* 	\brief	IndexNode structure for Node/DRM Index
+*/
+struct IndexNode
+{
+	double completionTimeSecondsFromStart;	/**< Time of index from start */
+	const char *pFragmentInfo;		/**< Fragment Information pointer */
+	int drmMetadataIdx;			/**< DRM Index for Fragment */
+	const char *initFragmentPtr;		/**< Fragmented MP4 specific pointer to associated (preceding) initialization fragment */
+};
+
+/**
+*	\struct	DiscontinuityIndexNode
+* 	\brief	Index Node structure for Discontinuity Index
+*/
+struct DiscontinuityIndexNode
+{
+	int fragmentIdx;	         /**< Idx of fragment in index table*/
+	double position;	         /**< Time of index from start */
+	double fragmentDuration;	 /**< Fragment duration of current discontinuity index */
+	double discontinuityPDT;	 /**< Program Date time value */
+};
+
+/**
+ * @class AampHlsSegmentIndexer
+ * @brief Builds the IndexNode and DiscontinuityIndexNode tables of a track from EXTINF, EXT-X-MAP,
+ * EXT-X-DISCONTINUITY and EXT-X-PROGRAM-DATE-TIME lines.
+ * On refresh of a live playlist, Update drops culled head segments in place, points retained
+ * segments at the new playlist buffer and parses only the lines after the last retained segment.
+ * Tables are owned by the track, the indexer only holds references for one indexing pass.
+ */
+class AampHlsSegmentIndexer
+{
+public:
+	/**
+	 * @fn AampHlsSegmentIndexer
+	 * @param[in,out] index - IndexNode table
+	 * @param[in,out] indexCount - number of IndexNode in table
+	 * @param[in,out] discontinuityIndex - DiscontinuityIndexNode table
+	 * @param[in,out] discontinuityIndexCount - number of DiscontinuityIndexNode in table
+	 */
+	AampHlsSegmentIndexer(GrowableBuffer &index, int &indexCount, GrowableBuffer &discontinuityIndex, int &discontinuityIndexCount);
+
+	AampHlsSegmentIndexer(const AampHlsSegmentIndexer&) = delete;
+	AampHlsSegmentIndexer& operator=(const AampHlsSegmentIndexer&) = delete;
+
+	/**
+	 * @fn Append
+	 * @brief Index segments of playlist lines from lineIdx on
+	 * @param[in] playlist - playlist buffer the lines were tokenized from
+	 * @param[in] lines - playlist lines
+	 * @param[in] lineIdx - first line to index
+	 */
+	void Append(char *playlist, const std::vector<HlsPlaylistLine> &lines, size_t lineIdx);
+
+	/**
+	 * @fn Update
+	 * @brief Re-index a refreshed playlist that starts culledCount segments after the indexed one
+	 * Tables are left untouched if the playlist does not hold the retained segments, or their
+	 * first or last duration changed.
+	 * @param[in] playlist - refreshed playlist buffer
+	 * @param[in] lines - refreshed playlist lines
+	 * @param[in] culledCount - segments removed from head, less than indexed segment count
+	 * @return true if indexed, false if a full re-index is required
+	 */
+	bool Update(char *playlist, const std::vector<HlsPlaylistLine> &lines, int culledCount);
+
+	/**
+	 * @fn GetTotalDuration
+	 * @return duration of indexed segments
+	 */
+	double GetTotalDuration() const { return mTotalDuration; }
+
+	/**
+	 * @fn GetProgramDateTime
+	 * @return program date time of first segment, from first EXT-X-PROGRAM-DATE-TIME, 0 if none
+	 */
+	double GetProgramDateTime() const { return mProgramDateTime; }
+
+	/**
+	 * @fn GetCulledDuration
+	 * @return duration of segments dropped by Update
+	 */
+	double GetCulledDuration() const { return mCulledDuration; }
+
+private:
+	/**
+	 * @fn FindTail
+	 * @return line after EXTINF number retainedCount, 0 if playlist has fewer segments
+	 */
+	size_t FindTail(const std::vector<HlsPlaylistLine> &lines, int retainedCount, size_t &firstExtInf, size_t &lastExtInf) const;
+
+	/**
+	 * @fn Cull
+	 * @brief Drop head segments in place, moving completion times and discontinuities to the new first segment
+	 */
+	void Cull(int culledCount);
+
+	/**
+	 * @fn Rebase
+	 * @brief Point retained nodes at lines of refreshed playlist before tailIdx
+	 */
+	void Rebase(char *playlist, const std::vector<HlsPlaylistLine> &lines, size_t tailIdx);
+
+	/**
+	 * @fn SetProgramDateTime
+	 * @brief Record PDT of a line, extrapolated back to first segment if it is the first one
+	 */
+	void SetProgramDateTime(const char *ptr);
+
+	GrowableBuffer &mIndex;
+	int &mIndexCount;
+	GrowableBuffer &mDiscontinuityIndex;
+	int &mDiscontinuityIndexCount;
+	double mTotalDuration;			/**< Completion time of last indexed segment */
+	double mCulledDuration;			/**< Duration dropped from head by Update */
+	double mProgramDateTime;		/**< PDT of first segment, 0 if none found */
+	bool mProgramDateTimeFound;		/**< First PDT seen */
+	const char *mInitFragmentPtr;		/**< EXT-X-MAP value for next segment */
+	const char *mSegmentProgramDateTime;	/**< PDT value since previous EXTINF */
+	bool mDiscontinuity;			/**< EXT-X-DISCONTINUITY since previous EXTINF */
+};
+
+#endif /* __AAMP_HLS_SEGMENT_INDEXER_H__ */
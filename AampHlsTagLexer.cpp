@@ -0,0 +1,265 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampHlsTagLexer.cpp
+ * @brief Single pass classification of HLS playlist lines by tag
+ */
+
+#include "AampHlsTagLexer.h"
+#include <string.h>
+
+/**
+ * @brief Names of known tags, in HlsTag order starting at eHLS_TAG_EXTM3U
+ */
+static const char *const gHlsTagNames[] =
+{
+	"#EXTM3U",
+	"#EXTINF",
+	"#EXT-X-VERSION",
+	"#EXT-X-TARGETDURATION",
+	"#EXT-X-MEDIA-SEQUENCE",
+	"#EXT-X-DISCONTINUITY-SEQUENCE",
+	"#EXT-X-DISCONTINUITY",
+	"#EXT-X-ENDLIST",
+	"#EXT-X-PLAYLIST-TYPE",
+	"#EXT-X-I-FRAMES-ONLY",
+	"#EXT-X-BYTERANGE",
+	"#EXT-X-KEY",
+	"#EXT-X-MAP",
+	"#EXT-X-PROGRAM-DATE-TIME",
+	"#EXT-X-DATERANGE",
+	"#EXT-X-ALLOW-CACHE",
+	"#EXT-X-INDEPENDENT-SEGMENTS",
+	"#EXT-X-START",
+	"#EXT-X-MEDIA",
+	"#EXT-X-STREAM-INF",
+	"#EXT-X-I-FRAME-STREAM-INF",
+	"#EXT-X-IMAGE-STREAM-INF",
+	"#EXT-X-SESSION-KEY",
+	"#EXT-X-TILES",
+	"#EXT-X-BITRATE",
+	"#EXT-X-FAXS-CM",
+	"#EXT-X-FAXS-PACKAGINGCERT",
+	"#EXT-X-FAXS-SIGNATURE",
+	"#EXT-X-X1-LIN-CK",
+	"#EXT-X-CONTENT-IDENTIFIER",
+	"#EXT-X-TRICKMODE-RESTRICTION",
+	"#EXT-X-CUE",
+	"#EXT-X-CUE-OUT",
+	"#EXT-X-CUE-OUT-CONT",
+	"#EXT-X-CUE-IN",
+	"#EXT-X-CM-SEQUENCE",
+	"#EXT-X-MARKER",
+	"#EXT-X-MEDIA-TIME",
+	"#EXT-X-END-TOP-TAGS",
+	"#EXT-X-FOG",
+	"#EXT-X-XCAL-CONTENTMETADATA",
+	"#EXT-NOM-I-FRAME-DISTANCE",
+	"#EXT-X-ADVERTISING",
+	"#EXT-UPLYNK-LIVE",
+	"#EXT-X-SOURCE-STREAM",
+	"#EXT-X-SCTE35",
+	"#EXT-X-ASSET",
+	"#EXT-X-SPLICEPOINT-SCTE35"
+};
+
+static_assert(sizeof(gHlsTagNames) / sizeof(gHlsTagNames[0]) == (eHLS_TAG_COUNT - eHLS_TAG_EXTM3U), "gHlsTagNames does not match HlsTag");
+
+/**
+ * @brief AampHlsTagLexer Constructor
+ */
+AampHlsTagLexer::AampHlsTagLexer() : mNodes(), mSubscribedTags()
+{
+	Build();
+}
+
+/**
+ * @brief Add subscribed tags to the trie
+ */
+bool AampHlsTagLexer::SetSubscribedTags(const std::vector<std::string> &tags)
+{
+	if (tags == mSubscribedTags)
+	{
+		return false;
+	}
+	mSubscribedTags = tags;
+	Build();
+	return true;
+}
+
+/**
+ * @brief Build trie of known and subscribed tags
+ */
+void AampHlsTagLexer::Build()
+{
+	mNodes.clear();
+	mNodes.push_back(Node('\0'));
+	for (int tag = eHLS_TAG_EXTM3U; tag < eHLS_TAG_COUNT; tag++)
+	{
+		int node = AddName(gHlsTagNames[tag - eHLS_TAG_EXTM3U] + HLS_TAG_PREFIX_LEN);
+		mNodes[node].tag = (HlsTag)tag;
+	}
+	for (size_t i = 0; i < mSubscribedTags.size(); i++)
+	{
+		const std::string &tag = mSubscribedTags[i];
+		if (tag.compare(0, HLS_TAG_PREFIX_LEN, HLS_TAG_PREFIX) != 0)
+		{ // not a tag, can never match a line
+			continue;
+		}
+		int node = AddName(tag.c_str() + HLS_TAG_PREFIX_LEN);
+		if (mNodes[node].subscribedTag == HLS_NO_SUBSCRIBED_TAG)
+		{
+			mNodes[node].subscribedTag = (int)i;
+		}
+	}
+}
+
+/**
+ * @brief Add name to the trie
+ */
+int AampHlsTagLexer::AddName(const char *name)
+{
+	int node = 0;
+	for (; *name; name++)
+	{
+		int child = mNodes[node].firstChild;
+		while (child >= 0 && mNodes[child].c != *name)
+		{
+			child = mNodes[child].nextSibling;
+		}
+		if (child < 0)
+		{
+			child = (int)mNodes.size();
+			mNodes.push_back(Node(*name));
+			mNodes[child].nextSibling = mNodes[node].firstChild;
+			mNodes[node].firstChild = child;
+		}
+		node = child;
+	}
+	return node;
+}
+
+/**
+ * @brief Classify a line
+ */
+void AampHlsTagLexer::Classify(const char *buffer, HlsPlaylistLine &line) const
+{
+	const char *ptr = buffer + line.offset;
+	size_t length = line.length;
+	line.tag = eHLS_TAG_NONE;
+	line.valueOffset = 0;
+	line.subscribedTag = HLS_NO_SUBSCRIBED_TAG;
+	if (length < HLS_TAG_PREFIX_LEN || memcmp(ptr, HLS_TAG_PREFIX, HLS_TAG_PREFIX_LEN) != 0)
+	{
+		return;
+	}
+	line.tag = eHLS_TAG_UNKNOWN;
+	line.valueOffset = HLS_TAG_PREFIX_LEN;
+	int subscribedTag = mNodes[0].subscribedTag;
+	int node = 0;
+	size_t pos = HLS_TAG_PREFIX_LEN;
+	while (pos < length)
+	{
+		int child = mNodes[node].firstChild;
+		while (child >= 0 && mNodes[child].c != ptr[pos])
+		{
+			child = mNodes[child].nextSibling;
+		}
+		if (child < 0)
+		{
+			break;
+		}
+		node = child;
+		pos++;
+		const Node &current = mNodes[node];
+		if (current.subscribedTag != HLS_NO_SUBSCRIBED_TAG &&
+			(subscribedTag == HLS_NO_SUBSCRIBED_TAG || current.subscribedTag < subscribedTag))
+		{
+			subscribedTag = current.subscribedTag;
+		}
+		if (current.tag != eHLS_TAG_NONE)
+		{
+			if (pos == length || ptr[pos] == ' ' || ptr[pos] == '\t')
+			{
+				line.tag = current.tag;
+				line.valueOffset = (uint16_t)pos;
+			}
+			else if (ptr[pos] == ':')
+			{
+				line.tag = current.tag;
+				line.valueOffset = (uint16_t)(pos + 1);
+			}
+		}
+	}
+	line.subscribedTag = subscribedTag;
+}
+
+/**
+ * @brief Split playlist into lines and classify each
+ */
+void AampHlsTagLexer::Tokenize(const char *buffer, size_t len, std::vector<HlsPlaylistLine> &lines) const
+{
+	lines.clear();
+	if (!buffer)
+	{
+		return;
+	}
+	const char *end = (const char *)memchr(buffer, '\0', len);
+	if (!end)
+	{
+		end = buffer + len;
+	}
+	const char *ptr = buffer;
+	while (ptr < end)
+	{ // lines are terminated by either a single LF character or CR characters followed by an LF character
+		const char *fin = (const char *)memchr(ptr, '\n', end - ptr);
+		const char *next = end;
+		if (fin)
+		{
+			next = fin + 1;
+		}
+		else
+		{
+			fin = end;
+		}
+		while (fin > ptr && fin[-1] == '\r')
+		{
+			fin--;
+		}
+		HlsPlaylistLine line;
+		line.offset = (uint32_t)(ptr - buffer);
+		line.length = (uint32_t)(fin - ptr);
+		Classify(buffer, line);
+		lines.push_back(line);
+		ptr = next;
+	}
+}
+
+/**
+ * @brief Get name of a known tag
+ */
+const char *AampHlsTagLexer::GetTagName(HlsTag tag)
+{
+	if (tag < eHLS_TAG_EXTM3U || tag >= eHLS_TAG_COUNT)
+	{
+		return NULL;
+	}
+	return gHlsTagNames[tag - eHLS_TAG_EXTM3U];
+}
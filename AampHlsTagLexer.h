@@ -0,0 +1,198 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampHlsTagLexer.h
+ * @brief Single pass classification of HLS playlist lines by tag
+ */
+
+#ifndef __AAMP_HLS_TAG_LEXER_H__
+#define __AAMP_HLS_TAG_LEXER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define HLS_TAG_PREFIX		"#EXT"
+#define HLS_TAG_PREFIX_LEN	4
+#define HLS_NO_SUBSCRIBED_TAG	-1
+
+/**
+ * @enum HlsTag
+ * @brief Known HLS tags, matched by full tag name
+ */
+enum HlsTag
+{
+	eHLS_TAG_NONE,				/**< URI, comment or empty line */
+	eHLS_TAG_UNKNOWN,			/**< #EXT tag not in the table */
+	eHLS_TAG_EXTM3U,
+	eHLS_TAG_EXTINF,
+	eHLS_TAG_VERSION,
+	eHLS_TAG_TARGETDURATION,
+	eHLS_TAG_MEDIA_SEQUENCE,
+	eHLS_TAG_DISCONTINUITY_SEQUENCE,
+	eHLS_TAG_DISCONTINUITY,
+	eHLS_TAG_ENDLIST,
+	eHLS_TAG_PLAYLIST_TYPE,
+	eHLS_TAG_I_FRAMES_ONLY,
+	eHLS_TAG_BYTERANGE,
+	eHLS_TAG_KEY,
+	eHLS_TAG_MAP,
+	eHLS_TAG_PROGRAM_DATE_TIME,
+	eHLS_TAG_DATERANGE,
+	eHLS_TAG_ALLOW_CACHE,
+	eHLS_TAG_INDEPENDENT_SEGMENTS,
+	eHLS_TAG_START,
+	eHLS_TAG_MEDIA,
+	eHLS_TAG_STREAM_INF,
+	eHLS_TAG_I_FRAME_STREAM_INF,
+	eHLS_TAG_IMAGE_STREAM_INF,
+	eHLS_TAG_SESSION_KEY,
+	eHLS_TAG_TILES,
+	eHLS_TAG_BITRATE,
+	eHLS_TAG_FAXS_CM,
+	eHLS_TAG_FAXS_PACKAGINGCERT,
+	eHLS_TAG_FAXS_SIGNATURE,
+	eHLS_TAG_X1_LIN_CK,
+	eHLS_TAG_CONTENT_IDENTIFIER,
+	eHLS_TAG_TRICKMODE_RESTRICTION,
+	eHLS_TAG_CUE,
+	eHLS_TAG_CUE_OUT,
+	eHLS_TAG_CUE_OUT_CONT,
+	eHLS_TAG_CUE_IN,
+	eHLS_TAG_CM_SEQUENCE,
+	eHLS_TAG_MARKER,
+	eHLS_TAG_MEDIA_TIME,
+	eHLS_TAG_END_TOP_TAGS,
+	eHLS_TAG_FOG,
+	eHLS_TAG_XCAL_CONTENTMETADATA,
+	eHLS_TAG_NOM_I_FRAME_DISTANCE,
+	eHLS_TAG_ADVERTISING,
+	eHLS_TAG_UPLYNK_LIVE,
+	eHLS_TAG_SOURCE_STREAM,
+	eHLS_TAG_SCTE35,
+	eHLS_TAG_ASSET,
+	eHLS_TAG_SPLICEPOINT_SCTE35,
+	eHLS_TAG_COUNT
+};
+
+/**
+ * @struct HlsPlaylistLine
+ * @brief Position and tag of one playlist line
+ */
+struct HlsPlaylistLine
+{
+	HlsPlaylistLine() : offset(0), length(0), tag(eHLS_TAG_NONE), valueOffset(0), subscribedTag(HLS_NO_SUBSCRIBED_TAG)
+	{
+	}
+	uint32_t offset;		/**< Start of line in playlist */
+	uint32_t length;		/**< Length without CR and LF */
+	uint16_t tag;			/**< HlsTag */
+	uint16_t valueOffset;		/**< Start of tag value from start of line, after the ':' */
+	int32_t subscribedTag;		/**< First subscribed tag the line starts with, HLS_NO_SUBSCRIBED_TAG if none */
+};
+
+/**
+ * @class AampHlsTagLexer
+ * @brief Finds the tag of a playlist line with one walk of a trie
+ *
+ * The trie holds the names of all known tags and of the tags subscribed by the application,
+ * so classifying a line costs the length of its tag name, not the number of tags.
+ * Known tags match the full tag name, which ends at ':' or at the end of line. Subscribed
+ * tags keep their established prefix match; when several match, the first subscribed wins.
+ */
+class AampHlsTagLexer
+{
+public:
+	/**
+	 * @fn AampHlsTagLexer
+	 * @brief Build trie of the known tags
+	 */
+	AampHlsTagLexer();
+
+	/**
+	 * @fn SetSubscribedTags
+	 * @brief Add subscribed tags to the trie, rebuilt only if the list changed
+	 * @param[in] tags - subscribed tags, each starting with "#EXT"
+	 * @retval true if the list changed and lines need classifying again
+	 */
+	bool SetSubscribedTags(const std::vector<std::string> &tags);
+
+	/**
+	 * @fn Classify
+	 * @brief Set tag, value offset and subscribed tag of a line from its offset and length
+	 * @param[in] buffer - playlist
+	 * @param[in,out] line - line to classify
+	 * @return void
+	 */
+	void Classify(const char *buffer, HlsPlaylistLine &line) const;
+
+	/**
+	 * @fn Tokenize
+	 * @brief Split playlist into lines and classify each
+	 * @param[in] buffer - playlist, ends at len or at the first NUL
+	 * @param[in] len - size of buffer
+	 * @param[out] lines - one entry per line, in playlist order
+	 * @return void
+	 */
+	void Tokenize(const char *buffer, size_t len, std::vector<HlsPlaylistLine> &lines) const;
+
+	/**
+	 * @fn GetTagName
+	 * @param[in] tag - known tag
+	 * @return tag name including "#EXT", NULL for eHLS_TAG_NONE and eHLS_TAG_UNKNOWN
+	 */
+	static const char *GetTagName(HlsTag tag);
+
+private:
+	/**
+	 * @struct Node
+	 * @brief Trie node, children are a sibling list as tag names share long prefixes
+	 */
+	struct Node
+	{
+		explicit Node(char character) : c(character), firstChild(-1), nextSibling(-1), tag(eHLS_TAG_NONE), subscribedTag(HLS_NO_SUBSCRIBED_TAG)
+		{
+		}
+		char c;
+		int firstChild;
+		int nextSibling;
+		HlsTag tag;
+		int subscribedTag;
+	};
+
+	/**
+	 * @fn Build
+	 * @brief Build trie of known and subscribed tags
+	 */
+	void Build();
+
+	/**
+	 * @fn AddName
+	 * @param[in] name - tag name following "#EXT"
+	 * @return node of the last character of name
+	 */
+	int AddName(const char *name);
+
+	std::vector<Node> mNodes;			/**< Root is node 0, matching "#EXT" */
+	std::vector<std::string> mSubscribedTags;
+};
+
+#endif /* __AAMP_HLS_TAG_LEXER_H__ */
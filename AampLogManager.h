@@ -41,6 +41,15 @@
 #define traceprintf(FORMAT, ...)
 #endif
 
+/**
+ * @brief True for a string literal format, which the async logger may format after the call
+ */
+#if defined(__GNUC__)
+#define AAMPLOG_LITERAL(FORMAT) __builtin_constant_p(FORMAT)
+#else
+#define AAMPLOG_LITERAL(FORMAT) 0
+#endif
+
 /**
  * @brief Macro for validating the log level to be enabled
  *
@@ -51,10 +60,10 @@
 				do { \
 					if (MYLOGOBJ) { \
 					       	if(MYLOGOBJ->isLogLevelAllowed(LEVEL)) { \
-							logprintf_new(MYLOGOBJ->getPlayerId(),LEVELSTR, __FUNCTION__, __LINE__,FORMAT, ##__VA_ARGS__); }\
+							logprintf_async(AAMPLOG_LITERAL(FORMAT), MYLOGOBJ->getPlayerId(),LEVELSTR, __FUNCTION__, __LINE__,FORMAT, ##__VA_ARGS__); }\
 						} \
 					else if (gpGlobalConfig && gpGlobalConfig->logging.isLogLevelAllowed(LEVEL)) { \
-						logprintf_new(-1,LEVELSTR, __FUNCTION__, __LINE__,FORMAT, ##__VA_ARGS__); }\
+						logprintf_async(AAMPLOG_LITERAL(FORMAT), -1,LEVELSTR, __FUNCTION__, __LINE__,FORMAT, ##__VA_ARGS__); }\
 				 } while (0)
 
 /**
@@ -68,7 +77,7 @@
 
 #define AAMPLOG_FAILOVER(FORMAT, ...) \
 		if (mLogObj && mLogObj->failover) { \
-				logprintf_new(mLogObj->getPlayerId(), "FAILOVER",__FUNCTION__, __LINE__, FORMAT, ##__VA_ARGS__); \
+				logprintf_async(AAMPLOG_LITERAL(FORMAT), mLogObj->getPlayerId(), "FAILOVER",__FUNCTION__, __LINE__, FORMAT, ##__VA_ARGS__); \
 		}
 
 /**
@@ -277,6 +286,14 @@ public:
 	 */
 	static std::string getHexDebugStr(const std::vector<uint8_t>& data);
 
+	/**
+	 * @fn setAsyncLogging
+	 * @brief Queue AAMPLOG messages to a writer thread instead of writing them on the calling thread
+	 * @param[in] enable - start or stop the async logger
+	 * @return void
+	 */
+	static void setAsyncLogging(bool enable);
+
 private:
 	AAMP_LogLevel aampLoglevel;
 };
@@ -297,6 +314,13 @@ extern void logprintf(const char *format, ...);
  * @return void
  */
 extern void logprintf_new(int playerId,const char* levelstr,const char* file, int line,const char *format, ...);
+/**
+ * @fn logprintf_async
+ * @param[in] literalFormat - format is a string literal, see AAMPLOG_LITERAL
+ * @param[in] format - printf style string
+ * @return void
+ */
+extern void logprintf_async(bool literalFormat, int playerId,const char* levelstr,const char* file, int line,const char *format, ...);
 
 /**
  * @fn DumpBlob
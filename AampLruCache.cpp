@@ -0,0 +1,312 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampLruCache.cpp
+ * @brief Byte budgeted LRU of shared, immutable cached files
+ */
+
+#include "AampLruCache.h"
+
+/**
+ * @brief AampCachedContent constructor, takes over vector
+ */
+AampCachedContent::AampCachedContent(std::vector<char> &&content) :
+	mContent(std::move(content)), mPtr(mContent.data()), mLen(mContent.size()), mRelease(NULL)
+{
+}
+
+/**
+ * @brief AampCachedContent constructor, takes over memory
+ */
+AampCachedContent::AampCachedContent(char *ptr, size_t len, void (*release)(void *)) :
+	mContent(), mPtr(ptr), mLen(len), mRelease(release)
+{
+}
+
+/**
+ * @brief AampCachedContent destructor
+ */
+AampCachedContent::~AampCachedContent()
+{
+	if (mRelease)
+	{
+		mRelease(mPtr);
+	}
+}
+
+/**
+ * @brief AampCachedFile constructor, copies content
+ */
+AampCachedFile::AampCachedFile(const char *ptr, size_t len, const std::string &effectiveUrl, int type) :
+	data(std::vector<char>(ptr, ptr + len)), effectiveUrl(effectiveUrl), type(type)
+{
+}
+
+/**
+ * @brief AampCachedFile constructor, takes over content
+ */
+AampCachedFile::AampCachedFile(std::vector<char> &&content, const std::string &effectiveUrl, int type) :
+	data(std::move(content)), effectiveUrl(effectiveUrl), type(type)
+{
+}
+
+/**
+ * @brief AampCachedFile constructor, takes over memory of another allocator
+ */
+AampCachedFile::AampCachedFile(char *ptr, size_t len, void (*release)(void *), const std::string &effectiveUrl, int type) :
+	data(ptr, len, release), effectiveUrl(effectiveUrl), type(type)
+{
+}
+
+/**
+ * @brief AampLruCache constructor
+ */
+AampLruCache::AampLruCache() : mEntries(), mTypes(), mTotalBytes(0), mMaxTotalBytes(AAMP_LRU_CACHE_UNLIMITED),
+	mDefaultMaxBytes(AAMP_LRU_CACHE_UNLIMITED), mDefaultMaxEntries(AAMP_LRU_CACHE_UNLIMITED), mCount(0)
+{
+}
+
+/**
+ * @brief Set max bytes over all types
+ */
+void AampLruCache::SetTotalBudget(size_t maxBytes)
+{
+	mMaxTotalBytes = maxBytes;
+}
+
+/**
+ * @brief Set budget of types without one of their own
+ */
+void AampLruCache::SetDefaultBudget(size_t maxBytes, size_t maxEntries)
+{
+	mDefaultMaxBytes = maxBytes;
+	mDefaultMaxEntries = maxEntries;
+	for (auto &it : mTypes)
+	{
+		if (!it.second.hasBudget)
+		{
+			it.second.maxBytes = maxBytes;
+			it.second.maxEntries = maxEntries;
+		}
+	}
+}
+
+/**
+ * @brief Set budget of a type
+ */
+void AampLruCache::SetTypeBudget(int type, size_t maxBytes, size_t maxEntries, bool reserved)
+{
+	TypeState &state = GetType(type);
+	state.maxBytes = maxBytes;
+	state.maxEntries = maxEntries;
+	state.reserved = reserved;
+	state.hasBudget = true;
+}
+
+/**
+ * @brief State of type, created with default budget on first use
+ */
+AampLruCache::TypeState &AampLruCache::GetType(int type)
+{
+	auto it = mTypes.find(type);
+	if (it == mTypes.end())
+	{
+		it = mTypes.emplace(type, TypeState()).first;
+		it->second.maxBytes = mDefaultMaxBytes;
+		it->second.maxEntries = mDefaultMaxEntries;
+	}
+	return it->second;
+}
+
+/**
+ * @brief Size of type
+ */
+size_t AampLruCache::GetTypeBytes(int type) const
+{
+	auto it = mTypes.find(type);
+	return (it != mTypes.end()) ? it->second.bytes : 0;
+}
+
+/**
+ * @brief Add file under url and effective url
+ */
+bool AampLruCache::Insert(const std::string &url, const AampCachedFilePtr &file)
+{
+	if (!file || mEntries.find(url) != mEntries.end())
+	{
+		return false;
+	}
+	size_t size = file->data.size();
+	TypeState &state = GetType(file->type);
+	if (size > state.maxBytes || size > mMaxTotalBytes || state.maxEntries == 0)
+	{
+		return false;
+	}
+	while (!state.lru.empty() && (state.lru.size() >= state.maxEntries || state.bytes + size > state.maxBytes))
+	{
+		EvictOldest(state);
+	}
+	while (mTotalBytes + size > mMaxTotalBytes)
+	{
+		TypeState *victim = NULL;
+		if (!state.lru.empty())
+		{
+			victim = &state;
+		}
+		else
+		{
+			// fewer than ten media types, scan is constant time
+			for (auto &it : mTypes)
+			{
+				if (!it.second.reserved && !it.second.lru.empty() && (!victim || it.second.bytes > victim->bytes))
+				{
+					victim = &it.second;
+				}
+			}
+		}
+		if (!victim)
+		{
+			return false;
+		}
+		EvictOldest(*victim);
+	}
+
+	Entry &entry = mEntries[url];
+	entry.file = file;
+	state.lru.push_front(url);
+	entry.lruPos = state.lru.begin();
+	state.bytes += size;
+	mTotalBytes += size;
+	mCount++;
+
+	const std::string &effectiveUrl = file->effectiveUrl;
+	if (!effectiveUrl.empty() && effectiveUrl != url && mEntries.find(effectiveUrl) == mEntries.end())
+	{
+		Entry &alias = mEntries[effectiveUrl];
+		alias.file = file;
+		alias.link = url;
+		alias.isAlias = true;
+		entry.link = effectiveUrl;
+	}
+	return true;
+}
+
+/**
+ * @brief Look up url and mark entry as most recently used
+ */
+AampCachedFilePtr AampLruCache::Find(const std::string &url)
+{
+	auto it = mEntries.find(url);
+	if (it == mEntries.end())
+	{
+		return NULL;
+	}
+	auto owner = it;
+	if (it->second.isAlias)
+	{
+		owner = mEntries.find(it->second.link);
+	}
+	if (owner != mEntries.end())
+	{
+		LruList &lru = GetType(owner->second.file->type).lru;
+		lru.splice(lru.begin(), lru, owner->second.lruPos);
+	}
+	return it->second.file;
+}
+
+/**
+ * @brief Remove entry of url
+ */
+bool AampLruCache::Remove(const std::string &url)
+{
+	auto it = mEntries.find(url);
+	if (it == mEntries.end())
+	{
+		return false;
+	}
+	if (it->second.isAlias)
+	{
+		auto owner = mEntries.find(it->second.link);
+		if (owner != mEntries.end())
+		{
+			owner->second.link.clear();
+		}
+		mEntries.erase(it);
+	}
+	else
+	{
+		RemoveEntry(it);
+	}
+	return true;
+}
+
+/**
+ * @brief Remove all entries
+ */
+void AampLruCache::Clear()
+{
+	mEntries.clear();
+	for (auto &it : mTypes)
+	{
+		it.second.lru.clear();
+		it.second.bytes = 0;
+	}
+	mTotalBytes = 0;
+	mCount = 0;
+}
+
+/**
+ * @brief Remove least recently used entry of a type
+ */
+void AampLruCache::EvictOldest(TypeState &state)
+{
+	auto it = mEntries.find(state.lru.back());
+	if (it != mEntries.end())
+	{
+		RemoveEntry(it);
+	}
+	else
+	{
+		state.lru.pop_back();
+	}
+}
+
+/**
+ * @brief Remove url entry and its effective url entry
+ */
+void AampLruCache::RemoveEntry(std::unordered_map<std::string, Entry>::iterator it)
+{
+	Entry &entry = it->second;
+	size_t size = entry.file->data.size();
+	TypeState &state = GetType(entry.file->type);
+	state.lru.erase(entry.lruPos);
+	state.bytes -= size;
+	mTotalBytes -= size;
+	mCount--;
+	if (!entry.link.empty())
+	{
+		auto alias = mEntries.find(entry.link);
+		if (alias != mEntries.end() && alias->second.isAlias)
+		{
+			mEntries.erase(alias);
+		}
+	}
+	mEntries.erase(it);
+}
@@ -0,0 +1,298 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampLruCache.h
+ * @brief Byte budgeted LRU of shared, immutable cached files
+ */
+
+#ifndef __AAMP_LRU_CACHE_H__
+#define __AAMP_LRU_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#define AAMP_LRU_CACHE_UNLIMITED SIZE_MAX	/**< No byte or entry limit */
+
+/**
+ * @class AampCachedContent
+ * @brief Read only file content, either an owned vector or adopted memory released with its
+ *        allocator's free function when the content is destroyed
+ */
+class AampCachedContent
+{
+public:
+	/**
+	 * @brief AampCachedContent constructor, takes over vector
+	 * @param[in] content - file content
+	 */
+	explicit AampCachedContent(std::vector<char> &&content);
+
+	/**
+	 * @brief AampCachedContent constructor, takes over memory
+	 * @param[in] ptr - file content
+	 * @param[in] len - file length
+	 * @param[in] release - frees ptr on destruction
+	 */
+	AampCachedContent(char *ptr, size_t len, void (*release)(void *));
+
+	/**
+	 * @brief AampCachedContent destructor
+	 */
+	~AampCachedContent();
+
+	AampCachedContent(const AampCachedContent&) = delete;
+	AampCachedContent& operator=(const AampCachedContent&) = delete;
+
+	const char *data() const { return mPtr; }
+	size_t size() const { return mLen; }
+	bool empty() const { return (mLen == 0); }
+	const char *begin() const { return mPtr; }
+	const char *end() const { return mPtr + mLen; }
+
+private:
+	std::vector<char> mContent;	/**< Owned content, empty for adopted memory */
+	char *mPtr;			/**< Content start */
+	size_t mLen;			/**< Content length */
+	void (*mRelease)(void *);	/**< Frees adopted memory, NULL for owned content */
+};
+
+/**
+ * @struct AampCachedFile
+ * @brief Cached file content. Never modified after construction, so it is shared by the
+ *        cache entries of url and effective url and by any number of borrowers without lock
+ */
+struct AampCachedFile
+{
+	/**
+	 * @brief AampCachedFile constructor, copies content
+	 * @param[in] ptr - file content
+	 * @param[in] len - file length
+	 * @param[in] effectiveUrl - final url after redirection
+	 * @param[in] type - MediaType of file
+	 */
+	AampCachedFile(const char *ptr, size_t len, const std::string &effectiveUrl, int type);
+
+	/**
+	 * @brief AampCachedFile constructor, takes over content
+	 * @param[in] content - file content
+	 * @param[in] effectiveUrl - final url after redirection
+	 * @param[in] type - MediaType of file
+	 */
+	AampCachedFile(std::vector<char> &&content, const std::string &effectiveUrl, int type);
+
+	/**
+	 * @brief AampCachedFile constructor, takes over memory of another allocator
+	 * @param[in] ptr - file content
+	 * @param[in] len - file length
+	 * @param[in] release - frees ptr once the last borrower drops the file
+	 * @param[in] effectiveUrl - final url after redirection
+	 * @param[in] type - MediaType of file
+	 */
+	AampCachedFile(char *ptr, size_t len, void (*release)(void *), const std::string &effectiveUrl, int type);
+
+	AampCachedFile(const AampCachedFile&) = delete;
+	AampCachedFile& operator=(const AampCachedFile&) = delete;
+
+	const AampCachedContent data;		/**< File content */
+	const std::string effectiveUrl;		/**< Final url after redirection */
+	const int type;				/**< MediaType of file */
+};
+
+typedef std::shared_ptr<const AampCachedFile> AampCachedFilePtr;
+
+/**
+ * @class AampLruCache
+ * @brief Url keyed cache of AampCachedFile with a least recently used list per media type
+ *
+ * Each media type has its own byte and entry budget and is trimmed from its own LRU tail,
+ * so inserting audio playlists never evicts video playlists. An optional total byte budget
+ * is enforced across types, evicting from the inserted type first and then from the
+ * type holding most bytes. Lookup, insert and eviction of an entry are O(1). Bytes are
+ * counted while the cache holds a file; a borrower keeps an evicted file alive until it
+ * drops its reference. Not thread safe, the owner serializes access.
+ */
+class AampLruCache
+{
+public:
+	/**
+	 * @fn AampLruCache
+	 */
+	AampLruCache();
+
+	AampLruCache(const AampLruCache&) = delete;
+	AampLruCache& operator=(const AampLruCache&) = delete;
+
+	/**
+	 * @fn SetTotalBudget
+	 * @param[in] maxBytes - max bytes over all types, AAMP_LRU_CACHE_UNLIMITED for no limit
+	 * @return void
+	 */
+	void SetTotalBudget(size_t maxBytes);
+
+	/**
+	 * @fn SetDefaultBudget
+	 * @brief Budget of types without one of their own
+	 * @param[in] maxBytes - max bytes of a type
+	 * @param[in] maxEntries - max entries of a type
+	 * @return void
+	 */
+	void SetDefaultBudget(size_t maxBytes, size_t maxEntries);
+
+	/**
+	 * @fn SetTypeBudget
+	 * @param[in] type - media type
+	 * @param[in] maxBytes - max bytes of type
+	 * @param[in] maxEntries - max entries of type
+	 * @param[in] reserved - entries are only evicted for files of the same type
+	 * @return void
+	 */
+	void SetTypeBudget(int type, size_t maxBytes, size_t maxEntries, bool reserved = false);
+
+	/**
+	 * @fn Insert
+	 * @brief Add file under url, and under its effective url if that differs and is not cached.
+	 *        Evicts least recently used entries to stay within budget
+	 * @param[in] url - key
+	 * @param[in] file - cached file
+	 * @retval true if inserted, false if url is already cached or file does not fit budget
+	 */
+	bool Insert(const std::string &url, const AampCachedFilePtr &file);
+
+	/**
+	 * @fn Find
+	 * @brief Look up url or effective url and mark the entry as most recently used
+	 * @param[in] url - key
+	 * @return cached file, NULL if not found
+	 */
+	AampCachedFilePtr Find(const std::string &url);
+
+	/**
+	 * @fn Contains
+	 * @param[in] url - key
+	 * @retval true if url is cached
+	 */
+	bool Contains(const std::string &url) const { return mEntries.find(url) != mEntries.end(); }
+
+	/**
+	 * @fn Remove
+	 * @brief Remove entry of url. Removing a url also removes its effective url entry,
+	 *        removing an effective url keeps the url entry
+	 * @param[in] url - key
+	 * @retval true if removed
+	 */
+	bool Remove(const std::string &url);
+
+	/**
+	 * @fn Clear
+	 * @return void
+	 */
+	void Clear();
+
+	/**
+	 * @fn GetTotalBytes
+	 * @return bytes of cached files
+	 */
+	size_t GetTotalBytes() const { return mTotalBytes; }
+
+	/**
+	 * @fn GetTypeBytes
+	 * @param[in] type - media type
+	 * @return bytes of cached files of type
+	 */
+	size_t GetTypeBytes(int type) const;
+
+	/**
+	 * @fn GetCount
+	 * @return number of cached files, effective url entries not counted
+	 */
+	size_t GetCount() const { return mCount; }
+
+private:
+	typedef std::list<std::string> LruList;
+
+	/**
+	 * @struct Entry
+	 * @brief Cache table record. An effective url entry shares the file of its url entry
+	 *        and is not on an LRU list
+	 */
+	struct Entry
+	{
+		Entry() : file(), link(), lruPos(), isAlias(false) {}
+		AampCachedFilePtr file;
+		std::string link;		/**< Effective url entry of a url entry, or url entry of an effective url entry */
+		LruList::iterator lruPos;	/**< Position on LRU list of type, url entries only */
+		bool isAlias;			/**< Effective url entry */
+	};
+
+	/**
+	 * @struct TypeState
+	 * @brief LRU list and budget of a media type
+	 */
+	struct TypeState
+	{
+		TypeState() : lru(), bytes(0), maxBytes(AAMP_LRU_CACHE_UNLIMITED), maxEntries(AAMP_LRU_CACHE_UNLIMITED), reserved(false), hasBudget(false) {}
+		LruList lru;		/**< Url entries, most recently used first */
+		size_t bytes;		/**< Bytes of cached files */
+		size_t maxBytes;
+		size_t maxEntries;
+		bool reserved;		/**< Only evicted for files of the same type */
+		bool hasBudget;		/**< Budget set by SetTypeBudget */
+	};
+
+	/**
+	 * @fn GetType
+	 * @brief State of type, created with default budget on first use
+	 * @param[in] type - media type
+	 * @return type state
+	 */
+	TypeState &GetType(int type);
+
+	/**
+	 * @fn EvictOldest
+	 * @brief Remove least recently used entry of a type
+	 * @param[in] state - type state with non empty LRU list
+	 * @return void
+	 */
+	void EvictOldest(TypeState &state);
+
+	/**
+	 * @fn RemoveEntry
+	 * @brief Remove url entry and its effective url entry
+	 * @param[in] it - url entry
+	 * @return void
+	 */
+	void RemoveEntry(std::unordered_map<std::string, Entry>::iterator it);
+
+	std::unordered_map<std::string, Entry> mEntries;	/**< Url and effective url entries */
+	std::map<int, TypeState> mTypes;			/**< Per media type LRU, few types */
+	size_t mTotalBytes;
+	size_t mMaxTotalBytes;
+	size_t mDefaultMaxBytes;
+	size_t mDefaultMaxEntries;
+	size_t mCount;
+};
+
+#endif /* __AAMP_LRU_CACHE_H__ */
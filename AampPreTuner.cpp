@@ -0,0 +1,749 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampPreTuner.cpp
+ * @brief Background staging of likely next channels for fast channel change
+ */
+
+#include "AampPreTuner.h"
+#include "AampHlsTagLexer.h"
+#include "AampUtils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @brief Read attribute of a HLS tag attribute list, quotes removed
+ */
+static bool GetAttribute(const std::string &attrs, const char *name, std::string &value)
+{
+	size_t nameLen = strlen(name);
+	size_t pos = 0;
+	while ((pos = attrs.find(name, pos)) != std::string::npos)
+	{
+		bool atStart = (pos == 0 || attrs[pos - 1] == ',' || attrs[pos - 1] == ':');
+		size_t valueStart = pos + nameLen;
+		if (atStart && valueStart < attrs.size() && attrs[valueStart] == '=')
+		{
+			valueStart++;
+			size_t valueEnd;
+			if (valueStart < attrs.size() && attrs[valueStart] == '"')
+			{
+				valueStart++;
+				valueEnd = attrs.find('"', valueStart);
+			}
+			else
+			{
+				valueEnd = attrs.find(',', valueStart);
+			}
+			if (valueEnd == std::string::npos)
+			{
+				valueEnd = attrs.size();
+			}
+			value = attrs.substr(valueStart, valueEnd - valueStart);
+			return true;
+		}
+		pos += nameLen;
+	}
+	return false;
+}
+
+/**
+ * @brief Lexer of known tags, shared as it is never changed after construction
+ */
+static const AampHlsTagLexer &GetTagLexer()
+{
+	static const AampHlsTagLexer lexer;
+	return lexer;
+}
+
+/**
+ * @brief Text of playlist line
+ */
+static std::string GetLine(const std::string &text, const HlsPlaylistLine &line)
+{
+	return text.substr(line.offset, line.length);
+}
+
+/**
+ * @brief Tag value of playlist line, after the ':'
+ */
+static std::string GetValue(const std::string &text, const HlsPlaylistLine &line)
+{
+	return text.substr(line.offset + line.valueOffset, line.length - line.valueOffset);
+}
+
+/**
+ * @brief Check if playlist line is a uri
+ */
+static bool IsUri(const std::string &text, const HlsPlaylistLine &line)
+{
+	return (line.tag == eHLS_TAG_NONE && line.length > 0 && text[line.offset] != '#');
+}
+
+/**
+ * @brief AampPreTuner constructor
+ */
+AampPreTuner::AampPreTuner(AampLogManager *logObj, Downloader downloader) : mMutex(), mCond(), mThread(), mRunning(false), mPaused(false),
+	mInterrupt(false), mChannels(), mStaged(), mAttemptTimeMs(), mUnsupported(), mConfig(), mStats(), mDownloader(downloader), mCurl(NULL), mLogObj(logObj)
+{
+}
+
+/**
+ * @brief AampPreTuner destructor
+ */
+AampPreTuner::~AampPreTuner()
+{
+	StopThread();
+	if (mCurl)
+	{
+		curl_easy_cleanup(mCurl);
+	}
+}
+
+/**
+ * @brief Set staging limits
+ */
+void AampPreTuner::SetConfig(const AampPreTuneConfig &config)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	mConfig = config;
+	mCond.notify_all();
+}
+
+/**
+ * @brief Set candidate channels, most likely first
+ */
+void AampPreTuner::SetChannels(const std::vector<std::string> &urls)
+{
+	bool stop = false;
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		mChannels = urls;
+		for (auto it = mStaged.begin(); it != mStaged.end();)
+		{
+			if (std::find(urls.begin(), urls.end(), it->first) == urls.end())
+			{
+				it = mStaged.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		for (auto it = mAttemptTimeMs.begin(); it != mAttemptTimeMs.end();)
+		{
+			if (std::find(urls.begin(), urls.end(), it->first) == urls.end())
+			{
+				it = mAttemptTimeMs.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		for (auto it = mUnsupported.begin(); it != mUnsupported.end();)
+		{
+			if (std::find(urls.begin(), urls.end(), *it) == urls.end())
+			{
+				it = mUnsupported.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		if (urls.empty())
+		{
+			stop = mRunning;
+		}
+		else if (!mRunning && !mThread.joinable())
+		{
+			mRunning = true;
+			mThread = std::thread(&AampPreTuner::Run, this);
+			AAMPLOG_INFO("Pre-tune started with %zu channels", urls.size());
+		}
+		mCond.notify_all();
+	}
+	if (stop)
+	{
+		StopThread();
+	}
+}
+
+/**
+ * @brief Hold background downloads
+ */
+void AampPreTuner::SetPaused(bool paused)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	mPaused = paused;
+	if (paused)
+	{
+		mInterrupt = true;
+	}
+	mCond.notify_all();
+}
+
+/**
+ * @brief Hand over staged files of a channel being tuned
+ */
+bool AampPreTuner::Take(const std::string &url, AampPreTunedFiles &files)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	auto it = mStaged.find(url);
+	if (it == mStaged.end())
+	{
+		return false;
+	}
+	bool fresh = (NOW_STEADY_TS_MS - it->second.stagedTimeMs) <= mConfig.maxAgeMs;
+	if (fresh)
+	{
+		files = std::move(it->second.files);
+		mStats.taken++;
+	}
+	else
+	{
+		mStats.expired++;
+	}
+	mStaged.erase(it);
+	mAttemptTimeMs.erase(url);
+	return fresh;
+}
+
+/**
+ * @brief Get counters
+ */
+AampPreTuneStats AampPreTuner::GetStats()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	AampPreTuneStats stats = mStats;
+	stats.stagedBytes = 0;
+	for (auto &it : mStaged)
+	{
+		stats.stagedBytes += it.second.bytes;
+	}
+	return stats;
+}
+
+/**
+ * @brief Stop worker thread
+ */
+void AampPreTuner::StopThread()
+{
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		mRunning = false;
+		mInterrupt = true;
+		mCond.notify_all();
+	}
+	if (mThread.joinable())
+	{
+		mThread.join();
+		AAMPLOG_INFO("Pre-tune stopped");
+	}
+}
+
+/**
+ * @brief Worker thread function
+ */
+void AampPreTuner::Run()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (mRunning)
+	{
+		std::string next;
+		long long waitMs = -1;
+		if (!mPaused)
+		{
+			long long now = NOW_STEADY_TS_MS;
+			long long refreshMs = std::max<long long>(mConfig.maxAgeMs / 2, mConfig.intervalMs);
+			for (const std::string &url : mChannels)
+			{
+				if (mUnsupported.find(url) != mUnsupported.end())
+				{
+					continue;
+				}
+				auto it = mAttemptTimeMs.find(url);
+				long long due = (it == mAttemptTimeMs.end()) ? now : (it->second + refreshMs);
+				if (due <= now)
+				{
+					next = url;
+					break;
+				}
+				if (waitMs < 0 || (due - now) < waitMs)
+				{
+					waitMs = due - now;
+				}
+			}
+		}
+		if (next.empty())
+		{
+			if (waitMs < 0)
+			{
+				mCond.wait(lock);
+			}
+			else
+			{
+				mCond.wait_for(lock, std::chrono::milliseconds(waitMs));
+			}
+			continue;
+		}
+		mAttemptTimeMs[next] = NOW_STEADY_TS_MS;
+		lock.unlock();
+		StageChannel(next);
+		lock.lock();
+	}
+}
+
+/**
+ * @brief Download and store files of a channel
+ */
+bool AampPreTuner::StageChannel(const std::string &url)
+{
+	StagedChannel staged;
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		staged.config = mConfig;
+	}
+	AampCachedFilePtr manifest = Fetch(url, url, eMEDIATYPE_MANIFEST, staged);
+	if (!manifest)
+	{
+		return false;
+	}
+	std::string text(manifest->data.begin(), manifest->data.end());
+	std::vector<HlsPlaylistLine> lines;
+	GetTagLexer().Tokenize(text.c_str(), text.size(), lines);
+	bool isHls = false;
+	bool isMaster = false;
+	for (const HlsPlaylistLine &line : lines)
+	{
+		isHls = isHls || (line.tag == eHLS_TAG_EXTM3U);
+		isMaster = isMaster || (line.tag == eHLS_TAG_STREAM_INF);
+	}
+	if (!isHls)
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		AAMPLOG_INFO("Pre-tune skips %s, not a HLS playlist", url.c_str());
+		mUnsupported.insert(url);
+		return false;
+	}
+	if (isMaster)
+	{
+		std::string videoUri;
+		std::string audioUri;
+		if (SelectVariant(text, staged.config.initialBitrate, videoUri, audioUri))
+		{
+			std::string resolved;
+			aamp_ResolveURL(resolved, manifest->effectiveUrl, videoUri.c_str(), staged.config.propagateUriParams);
+			AampCachedFilePtr playlist = Fetch(url, resolved, eMEDIATYPE_PLAYLIST_VIDEO, staged);
+			if (playlist)
+			{
+				StageMediaPlaylist(url, playlist, false, staged);
+			}
+			if (!audioUri.empty())
+			{
+				aamp_ResolveURL(resolved, manifest->effectiveUrl, audioUri.c_str(), staged.config.propagateUriParams);
+				playlist = Fetch(url, resolved, eMEDIATYPE_PLAYLIST_AUDIO, staged);
+				if (playlist)
+				{
+					StageMediaPlaylist(url, playlist, true, staged);
+				}
+			}
+		}
+	}
+	else
+	{
+		StageMediaPlaylist(url, manifest, false, staged);
+	}
+
+	std::lock_guard<std::mutex> guard(mMutex);
+	auto channel = std::find(mChannels.begin(), mChannels.end(), url);
+	if (!mRunning || mPaused || channel == mChannels.end())
+	{
+		// interrupted, a partial set would hold off the next attempt until refresh
+		return false;
+	}
+	size_t priority = channel - mChannels.begin();
+	size_t total = staged.bytes;
+	for (auto &it : mStaged)
+	{
+		if (it.first != url)
+		{
+			total += it.second.bytes;
+		}
+	}
+	while (total > staged.config.maxBytes)
+	{
+		// drop the least likely channel staged behind this one
+		auto victim = mStaged.end();
+		size_t victimPriority = priority;
+		for (auto it = mStaged.begin(); it != mStaged.end(); ++it)
+		{
+			size_t itPriority = std::find(mChannels.begin(), mChannels.end(), it->first) - mChannels.begin();
+			if (it->first != url && itPriority > victimPriority)
+			{
+				victim = it;
+				victimPriority = itPriority;
+			}
+		}
+		if (victim == mStaged.end())
+		{
+			AAMPLOG_WARN("Pre-tune of %s needs %zu bytes, over budget %zu", url.c_str(), staged.bytes, staged.config.maxBytes);
+			return false;
+		}
+		total -= victim->second.bytes;
+		mStaged.erase(victim);
+	}
+	staged.stagedTimeMs = NOW_STEADY_TS_MS;
+	AAMPLOG_INFO("Pre-tuned %s files:%zu bytes:%zu", url.c_str(), staged.files.size(), staged.bytes);
+	mStaged[url] = std::move(staged);
+	mStats.staged++;
+	return true;
+}
+
+/**
+ * @brief Stage HLS media playlist and the files a tune starts with
+ */
+void AampPreTuner::StageMediaPlaylist(const std::string &channelUrl, const AampCachedFilePtr &playlist, bool isAudio, StagedChannel &staged)
+{
+	std::string text(playlist->data.begin(), playlist->data.end());
+	std::string initUri;
+	std::string keyUri;
+	std::string segmentUri;
+	if (!SelectFragments(text, staged.config.liveOffset, initUri, keyUri, segmentUri))
+	{
+		return;
+	}
+	std::string resolved;
+	if (!keyUri.empty())
+	{
+		// AES-128 key is the license of clear key HLS, fetched as eMEDIATYPE_LICENCE
+		aamp_ResolveURL(resolved, playlist->effectiveUrl, keyUri.c_str(), staged.config.propagateUriParams);
+		if (!Fetch(channelUrl, resolved, eMEDIATYPE_LICENCE, staged))
+		{
+			return;
+		}
+	}
+	if (!initUri.empty())
+	{
+		aamp_ResolveURL(resolved, playlist->effectiveUrl, initUri.c_str(), staged.config.propagateUriParams);
+		if (!Fetch(channelUrl, resolved, isAudio ? eMEDIATYPE_INIT_AUDIO : eMEDIATYPE_INIT_VIDEO, staged))
+		{
+			return;
+		}
+	}
+	aamp_ResolveURL(resolved, playlist->effectiveUrl, segmentUri.c_str(), staged.config.propagateUriParams);
+	Fetch(channelUrl, resolved, isAudio ? eMEDIATYPE_AUDIO : eMEDIATYPE_VIDEO, staged);
+}
+
+/**
+ * @brief Download a file into staging set of a channel
+ */
+AampCachedFilePtr AampPreTuner::Fetch(const std::string &channelUrl, const std::string &url, MediaType type, StagedChannel &staged)
+{
+	auto found = staged.files.find(url);
+	if (found != staged.files.end())
+	{
+		return found->second;
+	}
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (!staged.files.empty())
+		{
+			// space out downloads, the playing channel keeps the network in between
+			mCond.wait_for(lock, std::chrono::milliseconds(staged.config.intervalMs), [this] { return !mRunning || mPaused; });
+		}
+		if (!mRunning || mPaused || std::find(mChannels.begin(), mChannels.end(), channelUrl) == mChannels.end())
+		{
+			return NULL;
+		}
+		mInterrupt = false;
+	}
+
+	std::vector<char> data;
+	std::string effectiveUrl;
+	bool ok = mDownloader ? mDownloader(url, data, effectiveUrl) : CurlDownload(url, data, effectiveUrl, staged.config);
+
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (!ok)
+	{
+		mStats.failures++;
+		AAMPLOG_WARN("Pre-tune download failed type:%d url:%s", type, url.c_str());
+		return NULL;
+	}
+	mStats.downloads++;
+	if (effectiveUrl.empty())
+	{
+		effectiveUrl = url;
+	}
+	staged.bytes += data.size();
+	AampCachedFilePtr file = std::make_shared<const AampCachedFile>(std::move(data), effectiveUrl, type);
+	staged.files[url] = file;
+	return file;
+}
+
+/**
+ * @brief curl write callback appending to vector
+ */
+size_t AampPreTuner::WriteCallback(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+	std::vector<char> *data = static_cast<std::vector<char> *>(userdata);
+	size_t len = size * nmemb;
+	data->insert(data->end(), ptr, ptr + len);
+	return len;
+}
+
+/**
+ * @brief curl progress callback aborting transfer on pause or stop
+ */
+int AampPreTuner::ProgressCallback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
+{
+	AampPreTuner *preTuner = static_cast<AampPreTuner *>(clientp);
+	return preTuner->mInterrupt ? 1 : 0;
+}
+
+/**
+ * @brief Default download function, rate limited and aborted on pause
+ */
+bool AampPreTuner::CurlDownload(const std::string &url, std::vector<char> &data, std::string &effectiveUrl, const AampPreTuneConfig &config)
+{
+	if (!mCurl)
+	{
+		mCurl = curl_easy_init();
+		if (!mCurl)
+		{
+			return false;
+		}
+	}
+	// handle is reused, every option is set on each download
+	curl_easy_setopt(mCurl, CURLOPT_URL, url.c_str());
+	curl_easy_setopt(mCurl, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(mCurl, CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(mCurl, CURLOPT_TIMEOUT_MS, config.timeoutMs);
+	curl_easy_setopt(mCurl, CURLOPT_WRITEFUNCTION, &AampPreTuner::WriteCallback);
+	curl_easy_setopt(mCurl, CURLOPT_WRITEDATA, &data);
+	curl_easy_setopt(mCurl, CURLOPT_NOPROGRESS, 0L);
+	curl_easy_setopt(mCurl, CURLOPT_XFERINFOFUNCTION, &AampPreTuner::ProgressCallback);
+	curl_easy_setopt(mCurl, CURLOPT_XFERINFODATA, this);
+	curl_easy_setopt(mCurl, CURLOPT_MAX_RECV_SPEED_LARGE, (curl_off_t)config.maxRecvSpeed);
+	// same TLS checks as GetFile
+	if (config.sslVerifyPeer)
+	{
+		curl_easy_setopt(mCurl, CURLOPT_SSLVERSION, config.sslVersion);
+		curl_easy_setopt(mCurl, CURLOPT_SSL_VERIFYHOST, 2L);
+		curl_easy_setopt(mCurl, CURLOPT_SSL_VERIFYPEER, 1L);
+	}
+	else
+	{
+		curl_easy_setopt(mCurl, CURLOPT_SSL_VERIFYHOST, 0L);
+		curl_easy_setopt(mCurl, CURLOPT_SSL_VERIFYPEER, 0L);
+	}
+	curl_easy_setopt(mCurl, CURLOPT_USERAGENT, config.userAgent.empty() ? NULL : config.userAgent.c_str());
+	curl_easy_setopt(mCurl, CURLOPT_PROXY, config.proxy.empty() ? NULL : config.proxy.c_str());
+
+	CURLcode res = curl_easy_perform(mCurl);
+	long httpCode = 0;
+	char *finalUrl = NULL;
+	curl_easy_getinfo(mCurl, CURLINFO_RESPONSE_CODE, &httpCode);
+	curl_easy_getinfo(mCurl, CURLINFO_EFFECTIVE_URL, &finalUrl);
+	if (finalUrl)
+	{
+		effectiveUrl = finalUrl;
+	}
+	if (res != CURLE_OK || httpCode != 200)
+	{
+		AAMPLOG_INFO("Pre-tune curl result:%d http:%ld url:%s", res, httpCode, url.c_str());
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Pick media playlists of HLS master playlist a tune starts with
+ */
+bool AampPreTuner::SelectVariant(const std::string &manifest, long bitrate, std::string &videoUri, std::string &audioUri)
+{
+	std::vector<HlsPlaylistLine> lines;
+	GetTagLexer().Tokenize(manifest.c_str(), manifest.size(), lines);
+	std::map<std::string, std::string> audioGroups;	// group id to default rendition uri
+	long bestBandwidth = -1;
+	long lowestBandwidth = -1;
+	std::string bestGroup;
+	std::string lowestUri;
+	std::string lowestGroup;
+	videoUri.clear();
+	audioUri.clear();
+	for (size_t i = 0; i < lines.size(); i++)
+	{
+		std::string value;
+		switch (lines[i].tag)
+		{
+			case eHLS_TAG_MEDIA:
+			{
+				std::string attrs = GetValue(manifest, lines[i]);
+				std::string groupId;
+				std::string uri;
+				if (GetAttribute(attrs, "TYPE", value) && value == "AUDIO" && GetAttribute(attrs, "GROUP-ID", groupId) && GetAttribute(attrs, "URI", uri))
+				{
+					bool isDefault = GetAttribute(attrs, "DEFAULT", value) && value == "YES";
+					if (isDefault || audioGroups.find(groupId) == audioGroups.end())
+					{
+						audioGroups[groupId] = uri;
+					}
+				}
+				break;
+			}
+			case eHLS_TAG_STREAM_INF:
+			{
+				std::string attrs = GetValue(manifest, lines[i]);
+				long bandwidth = GetAttribute(attrs, "BANDWIDTH", value) ? atol(value.c_str()) : 0;
+				std::string group;
+				GetAttribute(attrs, "AUDIO", group);
+				size_t next = i + 1;
+				while (next < lines.size() && !IsUri(manifest, lines[next]))
+				{
+					next++;
+				}
+				if (next >= lines.size())
+				{
+					break;
+				}
+				std::string uri = GetLine(manifest, lines[next]);
+				if (bandwidth <= bitrate && bandwidth > bestBandwidth)
+				{
+					bestBandwidth = bandwidth;
+					videoUri = uri;
+					bestGroup = group;
+				}
+				if (lowestBandwidth < 0 || bandwidth < lowestBandwidth)
+				{
+					lowestBandwidth = bandwidth;
+					lowestUri = uri;
+					lowestGroup = group;
+				}
+				i = next;
+				break;
+			}
+			default:
+				break;
+		}
+	}
+	if (videoUri.empty())
+	{
+		videoUri = lowestUri;
+		bestGroup = lowestGroup;
+	}
+	auto group = audioGroups.find(bestGroup);
+	if (group != audioGroups.end())
+	{
+		audioUri = group->second;
+	}
+	return !videoUri.empty();
+}
+
+/**
+ * @brief Pick files of HLS media playlist a tune starts with
+ */
+bool AampPreTuner::SelectFragments(const std::string &playlist, double liveOffset, std::string &initUri, std::string &keyUri, std::string &segmentUri)
+{
+	struct Segment
+	{
+		Segment() : duration(0), uri(), initUri(), keyUri() {}
+		double duration;
+		std::string uri;
+		std::string initUri;
+		std::string keyUri;
+	};
+	std::vector<HlsPlaylistLine> lines;
+	GetTagLexer().Tokenize(playlist.c_str(), playlist.size(), lines);
+	std::vector<Segment> segments;
+	std::string currentInit;
+	std::string currentKey;
+	double duration = 0;
+	bool isLive = true;
+	for (const HlsPlaylistLine &line : lines)
+	{
+		std::string value;
+		switch (line.tag)
+		{
+			case eHLS_TAG_EXTINF:
+				duration = atof(GetValue(playlist, line).c_str());
+				break;
+			case eHLS_TAG_MAP:
+				currentInit.clear();
+				GetAttribute(GetValue(playlist, line), "URI", currentInit);
+				break;
+			case eHLS_TAG_KEY:
+			{
+				std::string attrs = GetValue(playlist, line);
+				currentKey.clear();
+				if (GetAttribute(attrs, "METHOD", value) && value == "AES-128")
+				{
+					GetAttribute(attrs, "URI", currentKey);
+				}
+				break;
+			}
+			case eHLS_TAG_ENDLIST:
+				isLive = false;
+				break;
+			case eHLS_TAG_PLAYLIST_TYPE:
+				if (GetValue(playlist, line).find("VOD") != std::string::npos)
+				{
+					isLive = false;
+				}
+				break;
+			case eHLS_TAG_NONE:
+				if (IsUri(playlist, line))
+				{
+					Segment segment;
+					segment.duration = duration;
+					segment.uri = GetLine(playlist, line);
+					segment.initUri = currentInit;
+					segment.keyUri = currentKey;
+					segments.push_back(segment);
+					duration = 0;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	if (segments.empty())
+	{
+		return false;
+	}
+	size_t index = 0;
+	if (isLive)
+	{
+		double fromEdge = 0;
+		index = segments.size() - 1;
+		while (index > 0 && fromEdge + segments[index].duration < liveOffset)
+		{
+			fromEdge += segments[index].duration;
+			index--;
+		}
+	}
+	initUri = segments[index].initUri;
+	keyUri = segments[index].keyUri;
+	segmentUri = segments[index].uri;
+	return true;
+}
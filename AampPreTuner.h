@@ -0,0 +1,282 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampPreTuner.h
+ * @brief Background staging of likely next channels for fast channel change
+ */
+
+#ifndef __AAMP_PRE_TUNER_H__
+#define __AAMP_PRE_TUNER_H__
+
+#include <curl/curl.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include "AampLruCache.h"
+#include "AampMediaType.h"
+#include "AampLogManager.h"
+
+#define AAMP_PRETUNE_DOWNLOAD_INTERVAL_MS	200	/**< Default pause between background downloads */
+#define AAMP_PRETUNE_DOWNLOAD_TIMEOUT_MS	10000	/**< Default timeout of a background download */
+
+/**
+ * @struct AampPreTuneConfig
+ * @brief Limits of pre-tune staging
+ */
+struct AampPreTuneConfig
+{
+	size_t maxBytes;		/**< Staged bytes over all channels */
+	int maxAgeMs;			/**< Staged channel is used for a tune up to this age, it is refreshed at half of it */
+	int intervalMs;			/**< Pause between background downloads */
+	long timeoutMs;			/**< Timeout of a background download */
+	long maxRecvSpeed;		/**< Download rate limit in bytes per second, 0 for none */
+	long initialBitrate;		/**< HLS variant closest to it from below is staged */
+	double liveOffset;		/**< Seconds from live edge where a live tune starts */
+	bool propagateUriParams;	/**< Add manifest url parameters to relative urls */
+	bool sslVerifyPeer;		/**< Verify peer certificate and host name */
+	long sslVersion;		/**< CURLOPT_SSLVERSION used while verifying */
+	std::string userAgent;
+	std::string proxy;
+
+	AampPreTuneConfig() : maxBytes(0), maxAgeMs(0), intervalMs(AAMP_PRETUNE_DOWNLOAD_INTERVAL_MS), timeoutMs(AAMP_PRETUNE_DOWNLOAD_TIMEOUT_MS),
+		maxRecvSpeed(0), initialBitrate(0), liveOffset(0), propagateUriParams(true), sslVerifyPeer(true), sslVersion(0), userAgent(), proxy()
+	{
+	}
+};
+
+/**
+ * @struct AampPreTuneStats
+ * @brief Counters reported by the pre-tuner
+ */
+struct AampPreTuneStats
+{
+	unsigned long staged;		/**< Channels staged or refreshed */
+	unsigned long downloads;	/**< Files downloaded */
+	unsigned long failures;		/**< Failed downloads */
+	unsigned long taken;		/**< Tunes started from staged files */
+	unsigned long expired;		/**< Tunes finding staged files too old */
+	size_t stagedBytes;		/**< Bytes currently staged */
+
+	AampPreTuneStats() : staged(0), downloads(0), failures(0), taken(0), expired(0), stagedBytes(0)
+	{
+	}
+};
+
+typedef std::map<std::string, AampCachedFilePtr> AampPreTunedFiles;	/**< Staged files by request url */
+
+/**
+ * @class AampPreTuner
+ * @brief Keeps files needed to start the likely next channels staged in memory
+ *
+ * A worker thread walks the candidate channels in priority order and stages the master
+ * playlist of each, the media playlists of the variant a tune starts with, their init
+ * fragment and AES-128 key and the segment a tune starts from (first for VOD, live offset
+ * from edge for live). Only HLS is staged: a DASH start also needs the MPD parsed for its
+ * segments and a license requested through a DRM session, so a manifest that is not a
+ * HLS playlist is dropped and not downloaded again while the channel stays a candidate. Downloads use
+ * a dedicated rate limited handle, pause while the player tunes, and are spaced out so
+ * that playback of the current channel keeps the network. Staged bytes are bounded;
+ * channels lower in priority are dropped first. A tune takes the staged files of its
+ * channel, which are then served in place of the downloads they stand for.
+ */
+class AampPreTuner
+{
+public:
+	/**
+	 * @brief Download function, returns file content and final url after redirection
+	 */
+	typedef std::function<bool(const std::string &url, std::vector<char> &data, std::string &effectiveUrl)> Downloader;
+
+	/**
+	 * @fn AampPreTuner
+	 * @param[in] logObj - log object
+	 * @param[in] downloader - download function, empty to download with curl
+	 */
+	AampPreTuner(AampLogManager *logObj, Downloader downloader = Downloader());
+
+	/**
+	 * @fn ~AampPreTuner
+	 */
+	~AampPreTuner();
+
+	AampPreTuner(const AampPreTuner&) = delete;
+	AampPreTuner& operator=(const AampPreTuner&) = delete;
+
+	/**
+	 * @fn SetConfig
+	 * @param[in] config - staging limits, applied from next staged channel
+	 * @return void
+	 */
+	void SetConfig(const AampPreTuneConfig &config);
+
+	/**
+	 * @fn SetChannels
+	 * @brief Set candidate channels, most likely first. Staged files of other channels are
+	 *        dropped; an empty list stops the worker thread
+	 * @param[in] urls - manifest urls
+	 * @return void
+	 */
+	void SetChannels(const std::vector<std::string> &urls);
+
+	/**
+	 * @fn SetPaused
+	 * @brief Hold background downloads, an ongoing download is aborted
+	 * @param[in] paused - true to hold
+	 * @return void
+	 */
+	void SetPaused(bool paused);
+
+	/**
+	 * @fn Take
+	 * @brief Hand over staged files of a channel being tuned
+	 * @param[in] url - manifest url
+	 * @param[out] files - staged files by request url
+	 * @retval true if channel was staged and is not older than max age
+	 */
+	bool Take(const std::string &url, AampPreTunedFiles &files);
+
+	/**
+	 * @fn StageChannel
+	 * @brief Download and store files of a HLS channel, called from worker thread
+	 * @param[in] url - manifest url
+	 * @retval true if staged
+	 */
+	bool StageChannel(const std::string &url);
+
+	/**
+	 * @fn GetStats
+	 * @return copy of counters
+	 */
+	AampPreTuneStats GetStats();
+
+	/**
+	 * @fn SelectVariant
+	 * @brief Pick media playlists of HLS master playlist a tune starts with
+	 * @param[in] manifest - master playlist
+	 * @param[in] bitrate - initial bitrate, highest variant not above it is picked
+	 * @param[out] videoUri - variant playlist uri
+	 * @param[out] audioUri - default audio rendition uri of variant, empty if muxed
+	 * @retval true if a variant was found
+	 */
+	static bool SelectVariant(const std::string &manifest, long bitrate, std::string &videoUri, std::string &audioUri);
+
+	/**
+	 * @fn SelectFragments
+	 * @brief Pick files of HLS media playlist a tune starts with
+	 * @param[in] playlist - media playlist
+	 * @param[in] liveOffset - seconds from live edge where live tune starts
+	 * @param[out] initUri - EXT-X-MAP uri of segment, empty if none
+	 * @param[out] keyUri - AES-128 key uri of segment, empty if none
+	 * @param[out] segmentUri - first segment of tune
+	 * @retval true if a segment was found
+	 */
+	static bool SelectFragments(const std::string &playlist, double liveOffset, std::string &initUri, std::string &keyUri, std::string &segmentUri);
+
+private:
+	/**
+	 * @struct StagedChannel
+	 * @brief Staged files of a channel
+	 */
+	struct StagedChannel
+	{
+		StagedChannel() : files(), bytes(0), stagedTimeMs(0), config() {}
+		AampPreTunedFiles files;
+		size_t bytes;
+		long long stagedTimeMs;
+		AampPreTuneConfig config;	/**< Limits in effect while staging */
+	};
+
+	/**
+	 * @fn Run
+	 * @brief Worker thread function
+	 * @return void
+	 */
+	void Run();
+
+	/**
+	 * @fn StopThread
+	 * @return void
+	 */
+	void StopThread();
+
+	/**
+	 * @fn Fetch
+	 * @brief Download a file into staging set of a channel
+	 * @param[in] channelUrl - manifest url of channel
+	 * @param[in] url - file url
+	 * @param[in] type - media type
+	 * @param[in,out] staged - staging set
+	 * @return downloaded file, NULL on failure or when channel is no longer wanted
+	 */
+	AampCachedFilePtr Fetch(const std::string &channelUrl, const std::string &url, MediaType type, StagedChannel &staged);
+
+	/**
+	 * @fn StageMediaPlaylist
+	 * @brief Stage HLS media playlist and the files a tune starts with
+	 * @param[in] channelUrl - manifest url of channel
+	 * @param[in] playlist - media playlist, already staged
+	 * @param[in] isAudio - audio rendition playlist
+	 * @param[in,out] staged - staging set
+	 * @return void
+	 */
+	void StageMediaPlaylist(const std::string &channelUrl, const AampCachedFilePtr &playlist, bool isAudio, StagedChannel &staged);
+
+	/**
+	 * @fn CurlDownload
+	 * @brief Default download function, rate limited and aborted on pause
+	 */
+	bool CurlDownload(const std::string &url, std::vector<char> &data, std::string &effectiveUrl, const AampPreTuneConfig &config);
+
+	/**
+	 * @fn WriteCallback
+	 * @brief curl write callback appending to vector
+	 */
+	static size_t WriteCallback(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+	/**
+	 * @fn ProgressCallback
+	 * @brief curl progress callback aborting transfer on pause or stop
+	 */
+	static int ProgressCallback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
+
+	std::mutex mMutex;
+	std::condition_variable mCond;
+	std::thread mThread;
+	bool mRunning;
+	bool mPaused;
+	std::atomic<bool> mInterrupt;				/**< Abort ongoing download */
+	std::vector<std::string> mChannels;			/**< Candidates, most likely first */
+	std::map<std::string, StagedChannel> mStaged;		/**< Staged channels by manifest url */
+	std::map<std::string, long long> mAttemptTimeMs;	/**< Last staging attempt of channels */
+	std::set<std::string> mUnsupported;			/**< Candidates whose manifest is not HLS */
+	AampPreTuneConfig mConfig;
+	AampPreTuneStats mStats;
+	Downloader mDownloader;
+	CURL *mCurl;						/**< Handle of default downloader, worker thread only */
+	AampLogManager *mLogObj;
+};
+
+#endif /* __AAMP_PRE_TUNER_H__ */
@@ -36,7 +36,7 @@
  */
 ProfileEventAAMP::ProfileEventAAMP():
 	tuneStartMonotonicBase(0), tuneStartBaseUTCMS(0), bandwidthBitsPerSecondVideo(0),
-        bandwidthBitsPerSecondAudio(0), drmErrorCode(0), enabled(false), xreTimeBuckets(), tuneEventList(),
+        bandwidthBitsPerSecondAudio(0), drmErrorCode(0), connectionCount(0), peakStreamsPerConnection(0), enabled(false), xreTimeBuckets(), tuneEventList(),
 	tuneEventListMtx(), mTuneFailBucketType(PROFILE_BUCKET_MANIFEST), mTuneFailErrorCode(0),mLogObj(NULL)
 {
 
@@ -99,6 +99,8 @@ void ProfileEventAAMP::TuneBegin(void)
 	bandwidthBitsPerSecondVideo = 0;
 	bandwidthBitsPerSecondAudio = 0;
 	drmErrorCode = 0;
+	connectionCount = 0;
+	peakStreamsPerConnection = 0;
 	enabled = true;
 	mTuneFailBucketType = PROFILE_BUCKET_MANIFEST;
 	mTuneFailErrorCode = 0;
@@ -236,6 +238,12 @@ void ProfileEventAAMP::TuneEnd(TuneEndMetrics &mTuneEndMetrics,std::string appNa
 		mTuneEndMetrics.mTuneAttempts, mTuneEndMetrics.success,failureReason.c_str(),appName.c_str(),
 		mTuneEndMetrics.mTimedMetadata,mTimedMetadataStartTime < 0 ? 0 : mTimedMetadataStartTime , mTuneEndMetrics.mTimedMetadataDuration,mTuneEndMetrics.mTSBEnabled,mTotalTime
 		);	
+	if (connectionCount > 0)
+	{
+		// kept out of IP_AAMP_TUNETIME to leave its format unchanged
+		AAMPLOG_WARN("%s PLAYER[%d] IP_AAMP_CONNECTIONS:%d,%d", // connections opened, max streams on one connection
+			playerActiveMode.c_str(), playerId, connectionCount, peakStreamsPerConnection);
+	}
 }
 
 /**
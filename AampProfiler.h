@@ -204,6 +204,8 @@ private:
 	long bandwidthBitsPerSecondVideo;       /**< Video bandwidth in bps */
 	long bandwidthBitsPerSecondAudio;       /**< Audio bandwidth in bps */
 	int drmErrorCode;                       /**< DRM error code */
+	int connectionCount;                    /**< Connections opened by download engine during tune */
+	int peakStreamsPerConnection;           /**< Max transfers multiplexed on one connection during tune */
 	bool enabled;                           /**< Profiler started or not */
 	std::list<TuneEvent> tuneEventList;     /**< List of events happened during tuning */
 	std::mutex tuneEventListMtx;            /**< Mutex protecting tuneEventList */
@@ -282,6 +284,19 @@ public:
 		drmErrorCode = errCode;
 	}
 
+	/**
+	 * @brief Setting HTTP/2 connection usage of download engine
+	 *
+	 * @param[in] connections - Connections opened
+	 * @param[in] peakStreams - Max transfers multiplexed on one connection
+	 * @return void
+	 */
+	void SetConnectionStreamConcurrency(int connections, int peakStreams)
+	{
+		connectionCount = connections;
+		peakStreamsPerConnection = peakStreams;
+	}
+
 
 	/**
 	 * @fn getTuneEventsJSON
@@ -0,0 +1,497 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampReactor.cpp
+ * @brief Process wide timer wheel and worker pool running periodic and deferred tasks
+ */
+
+#include "AampReactor.h"
+#include <pthread.h>
+#include <limits.h>
+#include <algorithm>
+#include <chrono>
+
+#define AAMP_REACTOR_TICK_US		(AAMP_REACTOR_TICK_MS * 1000LL)
+#define AAMP_REACTOR_WHEEL_MASK		(AAMP_REACTOR_WHEEL_SLOTS - 1)
+#define AAMP_REACTOR_WHEEL_RANGE	(1ULL << (AAMP_REACTOR_WHEEL_BITS * AAMP_REACTOR_WHEEL_LEVELS))	/**< Ticks covered by the wheel */
+
+/**
+ * @brief Process wide reactor
+ */
+AampReactor &AampReactor::GetInstance()
+{
+	static AampReactor instance;
+	return instance;
+}
+
+/**
+ * @brief AampReactor Constructor
+ */
+AampReactor::AampReactor() : mMutex(), mTimerCond(), mWorkerCond(), mDoneCond(), mTasks(), mWheel(), mOccupied(),
+	mCurrentTick(0), mSleepUntilTick(UINT64_MAX), mStartUs(NowUs()), mReady(), mStats(), mTimerThread(), mWorkers(),
+	mIdleWorkers(0), mNextId(AAMP_REACTOR_TASK_ID_INVALID + 1), mStopping(false)
+{
+}
+
+/**
+ * @brief AampReactor Destructor
+ */
+AampReactor::~AampReactor()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mTimerCond.notify_all();
+	mWorkerCond.notify_all();
+	if (mTimerThread.joinable())
+	{
+		mTimerThread.join();
+	}
+	for (std::thread &worker : mWorkers)
+	{
+		worker.join();
+	}
+}
+
+/**
+ * @brief Monotonic time in us
+ */
+long long AampReactor::NowUs()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Start timer thread and first workers
+ */
+void AampReactor::StartThreads()
+{
+	mTimerThread = std::thread(&AampReactor::RunTimer, this);
+	while (mWorkers.size() < AAMP_REACTOR_MIN_WORKERS)
+	{
+		AddWorker();
+	}
+}
+
+/**
+ * @brief Start a worker thread
+ */
+void AampReactor::AddWorker()
+{
+	mWorkers.push_back(std::thread(&AampReactor::RunWorker, this));
+}
+
+/**
+ * @brief Schedule a task
+ */
+int AampReactor::Schedule(const char *name, int delayMs, AampReactorTask task)
+{
+	if (!task)
+	{
+		return AAMP_REACTOR_TASK_ID_INVALID;
+	}
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mStopping)
+	{
+		return AAMP_REACTOR_TASK_ID_INVALID;
+	}
+	if (!mTimerThread.joinable())
+	{
+		StartThreads();
+	}
+	int id;
+	do
+	{
+		id = mNextId;
+		mNextId = (mNextId == INT_MAX) ? (AAMP_REACTOR_TASK_ID_INVALID + 1) : (mNextId + 1);
+	} while (mTasks.find(id) != mTasks.end());
+	Task *entry = new Task(id, name ? name : "", task);
+	mTasks[id] = std::unique_ptr<Task>(entry);
+	if (delayMs == AAMP_REACTOR_WAIT_WAKE)
+	{
+		entry->state = eTASK_PARKED;
+	}
+	else
+	{
+		Arm(entry, std::max(delayMs, 0));
+	}
+	return id;
+}
+
+/**
+ * @brief Run a waiting task now
+ */
+bool AampReactor::Wake(int id)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mTasks.find(id);
+	if (it == mTasks.end())
+	{
+		return false;
+	}
+	Task *task = it->second.get();
+	switch (task->state)
+	{
+		case eTASK_WAITING:
+			Unlink(task);
+			// fall through
+		case eTASK_PARKED:
+			task->dueUs = NowUs();
+			MakeReady(task);
+			break;
+		case eTASK_RUNNING:
+			task->wakePending = true;
+			break;
+		case eTASK_READY:
+		default:
+			break;
+	}
+	return true;
+}
+
+/**
+ * @brief Remove a task
+ */
+bool AampReactor::Cancel(int id)
+{
+	AampReactorTask function;
+	std::unique_lock<std::mutex> lock(mMutex);
+	auto it = mTasks.find(id);
+	if (it == mTasks.end())
+	{
+		return false;
+	}
+	Task *task = it->second.get();
+	switch (task->state)
+	{
+		case eTASK_RUNNING:
+			task->cancelled = true;
+			if (task->runner != std::this_thread::get_id())
+			{
+				mDoneCond.wait(lock, [this, id]() { return mTasks.find(id) == mTasks.end(); });
+			}
+			return true;
+		case eTASK_WAITING:
+			Unlink(task);
+			break;
+		case eTASK_READY:
+			mReady.erase(std::find(mReady.begin(), mReady.end(), task));
+			break;
+		case eTASK_PARKED:
+		default:
+			break;
+	}
+	// captures are destroyed without the lock held
+	function.swap(task->function);
+	mTasks.erase(it);
+	lock.unlock();
+	return true;
+}
+
+/**
+ * @brief Check if task is pending or running
+ */
+bool AampReactor::IsScheduled(int id)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return (mTasks.find(id) != mTasks.end());
+}
+
+/**
+ * @brief Statistics per task name
+ */
+void AampReactor::GetStats(std::vector<AampReactorTaskStats> &stats)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	stats.clear();
+	for (const auto &entry : mStats)
+	{
+		stats.push_back(entry.second);
+	}
+}
+
+/**
+ * @brief Workers started so far
+ */
+int AampReactor::GetWorkerCount()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return (int)mWorkers.size();
+}
+
+/**
+ * @brief Insert task into wheel, or ready queue if due
+ */
+void AampReactor::Arm(Task *task, int delayMs)
+{
+	long long nowUs = NowUs();
+	task->dueUs = nowUs + delayMs * 1000LL;
+	task->dueTick = (uint64_t)((task->dueUs - mStartUs + AAMP_REACTOR_TICK_US - 1) / AAMP_REACTOR_TICK_US);
+	if (delayMs == 0 || task->dueTick <= mCurrentTick)
+	{
+		MakeReady(task);
+	}
+	else
+	{
+		task->state = eTASK_WAITING;
+		Insert(task);
+		if (task->dueTick < mSleepUntilTick)
+		{
+			mTimerCond.notify_one();
+		}
+	}
+}
+
+/**
+ * @brief Link task into the wheel slot of its due tick
+ *
+ * The level is the lowest one whose range covers the delay; the slot is taken from the
+ * due tick bits of that level, so the slot is cascaded to lower levels at the tick its
+ * lower bits are zero. Delays beyond the wheel range are parked in the last slot reached
+ * and inserted again from there.
+ */
+void AampReactor::Insert(Task *task)
+{
+	uint64_t delta = task->dueTick - mCurrentTick;
+	uint64_t tick = task->dueTick;
+	if (delta >= AAMP_REACTOR_WHEEL_RANGE)
+	{
+		tick = mCurrentTick + AAMP_REACTOR_WHEEL_RANGE - 1;
+		delta = AAMP_REACTOR_WHEEL_RANGE - 1;
+	}
+	int level = 0;
+	while ((level < AAMP_REACTOR_WHEEL_LEVELS - 1) && (delta >= (1ULL << (AAMP_REACTOR_WHEEL_BITS * (level + 1)))))
+	{
+		level++;
+	}
+	int slot = (int)((tick >> (AAMP_REACTOR_WHEEL_BITS * level)) & AAMP_REACTOR_WHEEL_MASK);
+	task->level = level;
+	task->slot = slot;
+	task->prev = NULL;
+	task->next = mWheel[level][slot];
+	if (task->next)
+	{
+		task->next->prev = task;
+	}
+	mWheel[level][slot] = task;
+	mOccupied[level] |= (1ULL << slot);
+}
+
+/**
+ * @brief Remove task from its wheel slot
+ */
+void AampReactor::Unlink(Task *task)
+{
+	if (task->prev)
+	{
+		task->prev->next = task->next;
+	}
+	else
+	{
+		mWheel[task->level][task->slot] = task->next;
+		if (!task->next)
+		{
+			mOccupied[task->level] &= ~(1ULL << task->slot);
+		}
+	}
+	if (task->next)
+	{
+		task->next->prev = task->prev;
+	}
+	task->prev = NULL;
+	task->next = NULL;
+}
+
+/**
+ * @brief Queue task for the workers
+ */
+void AampReactor::MakeReady(Task *task)
+{
+	task->state = eTASK_READY;
+	mReady.push_back(task);
+	if (((int)mReady.size() > mIdleWorkers) && (mWorkers.size() < AAMP_REACTOR_MAX_WORKERS))
+	{
+		AddWorker();
+	}
+	else
+	{
+		mWorkerCond.notify_one();
+	}
+}
+
+/**
+ * @brief First tick with work after mCurrentTick
+ *
+ * Slots of a level are reached in order starting after the current position, so the
+ * first occupied one is found by rotating the bitmap to that position.
+ */
+uint64_t AampReactor::GetNextEventTick() const
+{
+	uint64_t next = UINT64_MAX;
+	for (int level = 0; level < AAMP_REACTOR_WHEEL_LEVELS; level++)
+	{
+		uint64_t occupied = mOccupied[level];
+		if (occupied)
+		{
+			int shift = AAMP_REACTOR_WHEEL_BITS * level;
+			uint64_t position = mCurrentTick >> shift;
+			int rotate = (int)((position + 1) & AAMP_REACTOR_WHEEL_MASK);
+			uint64_t rotated = rotate ? ((occupied >> rotate) | (occupied << (AAMP_REACTOR_WHEEL_SLOTS - rotate))) : occupied;
+			uint64_t tick = (position + 1 + __builtin_ctzll(rotated)) << shift;
+			next = std::min(next, tick);
+		}
+	}
+	return next;
+}
+
+/**
+ * @brief Cascade upper level slots reached at tick and make level 0 slot ready
+ */
+void AampReactor::ProcessTick(uint64_t tick)
+{
+	for (int level = AAMP_REACTOR_WHEEL_LEVELS - 1; level >= 0; level--)
+	{
+		int shift = AAMP_REACTOR_WHEEL_BITS * level;
+		if (tick & ((1ULL << shift) - 1))
+		{
+			continue;
+		}
+		int slot = (int)((tick >> shift) & AAMP_REACTOR_WHEEL_MASK);
+		Task *task = mWheel[level][slot];
+		mWheel[level][slot] = NULL;
+		mOccupied[level] &= ~(1ULL << slot);
+		while (task)
+		{
+			Task *next = task->next;
+			task->prev = NULL;
+			task->next = NULL;
+			if (task->dueTick <= tick)
+			{
+				MakeReady(task);
+			}
+			else
+			{
+				Insert(task);
+			}
+			task = next;
+		}
+	}
+}
+
+/**
+ * @brief Timer thread, moves due tasks to the ready queue
+ */
+void AampReactor::RunTimer()
+{
+	(void)pthread_setname_np(pthread_self(), "aampReactorTmr");
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (!mStopping)
+	{
+		uint64_t nowTick = (uint64_t)((NowUs() - mStartUs) / AAMP_REACTOR_TICK_US);
+		uint64_t next = GetNextEventTick();
+		while (next <= nowTick)
+		{
+			mCurrentTick = next;
+			ProcessTick(next);
+			next = GetNextEventTick();
+		}
+		// no slot is reached up to nowTick, skipping there keeps all slots in place
+		mCurrentTick = std::max(mCurrentTick, nowTick);
+		mSleepUntilTick = GetNextEventTick();
+		if (mSleepUntilTick == UINT64_MAX)
+		{
+			mTimerCond.wait(lock);
+		}
+		else
+		{
+			std::chrono::microseconds until(mStartUs + (long long)mSleepUntilTick * AAMP_REACTOR_TICK_US);
+			mTimerCond.wait_until(lock, std::chrono::steady_clock::time_point(until));
+		}
+	}
+}
+
+/**
+ * @brief Worker thread, runs ready tasks and reschedules them by their return value
+ */
+void AampReactor::RunWorker()
+{
+	(void)pthread_setname_np(pthread_self(), "aampReactorWrk");
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (!mStopping)
+	{
+		if (mReady.empty())
+		{
+			mIdleWorkers++;
+			mWorkerCond.wait(lock);
+			mIdleWorkers--;
+			continue;
+		}
+		Task *task = mReady.front();
+		mReady.pop_front();
+		task->state = eTASK_RUNNING;
+		task->runner = std::this_thread::get_id();
+		lock.unlock();
+
+		long long startUs = NowUs();
+		int next = task->function();
+		long long endUs = NowUs();
+
+		AampReactorTask function;
+		lock.lock();
+		AampReactorTaskStats &stats = mStats[task->name];
+		long long runUs = endUs - startUs;
+		long long lateUs = std::max(startUs - task->dueUs, 0LL);
+		if (stats.runs == 0)
+		{
+			stats.name = task->name;
+		}
+		stats.runs++;
+		stats.totalRunUs += runUs;
+		stats.maxRunUs = std::max(stats.maxRunUs, runUs);
+		stats.totalLateUs += lateUs;
+		stats.maxLateUs = std::max(stats.maxLateUs, lateUs);
+		task->runner = std::thread::id();
+
+		if (task->cancelled || (next < 0 && next != AAMP_REACTOR_WAIT_WAKE))
+		{
+			function.swap(task->function);
+			mTasks.erase(task->id);
+			mDoneCond.notify_all();
+			lock.unlock();
+			function = nullptr;
+			lock.lock();
+		}
+		else if (task->wakePending)
+		{
+			task->wakePending = false;
+			task->dueUs = endUs;
+			MakeReady(task);
+		}
+		else if (next == AAMP_REACTOR_WAIT_WAKE)
+		{
+			task->state = eTASK_PARKED;
+		}
+		else
+		{
+			Arm(task, next);
+		}
+	}
+}
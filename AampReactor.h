@@ -0,0 +1,282 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampReactor.h
+ * @brief Process wide timer wheel and worker pool running periodic and deferred tasks
+ */
+
+#ifndef __AAMP_REACTOR_H__
+#define __AAMP_REACTOR_H__
+
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#define AAMP_REACTOR_TICK_MS		10	/**< Timer wheel resolution */
+#define AAMP_REACTOR_WHEEL_BITS		6	/**< log2 of slots per wheel level */
+#define AAMP_REACTOR_WHEEL_SLOTS	(1 << AAMP_REACTOR_WHEEL_BITS)
+#define AAMP_REACTOR_WHEEL_LEVELS	4	/**< Levels cover 2^24 ticks, longer delays are cascaded again */
+#define AAMP_REACTOR_MIN_WORKERS	2	/**< Workers started with the reactor */
+#define AAMP_REACTOR_MAX_WORKERS	8	/**< Workers added while all are busy, up to this */
+#define AAMP_REACTOR_TASK_ID_INVALID	0
+#define AAMP_REACTOR_TASK_DONE		-1	/**< Task return value ending the task */
+#define AAMP_REACTOR_WAIT_WAKE		-2	/**< Delay or task return value waiting for Wake */
+
+/**
+ * @brief Task run by the reactor
+ * @return ms until next run, AAMP_REACTOR_WAIT_WAKE or AAMP_REACTOR_TASK_DONE
+ */
+typedef std::function<int()> AampReactorTask;
+
+/**
+ * @struct AampReactorTaskStats
+ * @brief Run time and lateness of the tasks of a name
+ */
+struct AampReactorTaskStats
+{
+	AampReactorTaskStats() : name(), runs(0), totalRunUs(0), maxRunUs(0), totalLateUs(0), maxLateUs(0)
+	{
+	}
+	std::string name;
+	unsigned long long runs;
+	long long totalRunUs;
+	long long maxRunUs;
+	long long totalLateUs;		/**< Start of run after its due time, includes tick rounding */
+	long long maxLateUs;
+};
+
+/**
+ * @class AampReactor
+ * @brief Runs tasks of all players on one timer thread and a small worker pool
+ *
+ * Due times are kept in a hierarchical timer wheel of AAMP_REACTOR_WHEEL_LEVELS levels
+ * with AAMP_REACTOR_WHEEL_SLOTS slots each, so scheduling and cancelling are constant
+ * time. Each level has an occupancy bitmap from which the timer thread finds the next
+ * tick with work and sleeps until then, or until an earlier task is scheduled.
+ *
+ * Due tasks go to a ready queue served by the workers. A task never runs on two workers
+ * at once; the value it returns reschedules it, a periodic task returning its interval
+ * runs that long after the end of its previous run. A task waiting for Wake is not in
+ * the wheel at all.
+ */
+class AampReactor
+{
+public:
+	/**
+	 * @fn GetInstance
+	 * @return process wide reactor
+	 */
+	static AampReactor &GetInstance();
+
+	AampReactor(const AampReactor&) = delete;
+	AampReactor& operator=(const AampReactor&) = delete;
+
+	/**
+	 * @fn ~AampReactor
+	 * @brief Stop threads, tasks not yet run are dropped
+	 */
+	~AampReactor();
+
+	/**
+	 * @fn Schedule
+	 * @param[in] name - name of statistics entry, a string literal
+	 * @param[in] delayMs - delay of first run, AAMP_REACTOR_WAIT_WAKE to run on Wake
+	 * @param[in] task - task to run
+	 * @return task id, AAMP_REACTOR_TASK_ID_INVALID if not scheduled
+	 */
+	int Schedule(const char *name, int delayMs, AampReactorTask task);
+
+	/**
+	 * @fn Wake
+	 * @brief Run a waiting task now, or again as soon as its current run ends
+	 * @param[in] id - task id
+	 * @retval true if the task exists
+	 */
+	bool Wake(int id);
+
+	/**
+	 * @fn Cancel
+	 * @brief Remove a task, waiting for a run in progress on another thread
+	 * @param[in] id - task id
+	 * @retval true if the task existed
+	 */
+	bool Cancel(int id);
+
+	/**
+	 * @fn IsScheduled
+	 * @param[in] id - task id
+	 * @retval true until the task ends or is cancelled
+	 */
+	bool IsScheduled(int id);
+
+	/**
+	 * @fn GetStats
+	 * @param[out] stats - one entry per task name seen since process start
+	 * @return void
+	 */
+	void GetStats(std::vector<AampReactorTaskStats> &stats);
+
+	/**
+	 * @fn GetWorkerCount
+	 * @return workers started so far
+	 */
+	int GetWorkerCount();
+
+private:
+	/**
+	 * @enum TaskState
+	 */
+	enum TaskState
+	{
+		eTASK_WAITING,		/**< In the timer wheel */
+		eTASK_PARKED,		/**< Waiting for Wake */
+		eTASK_READY,		/**< In the ready queue */
+		eTASK_RUNNING
+	};
+
+	/**
+	 * @struct Task
+	 * @brief Scheduled task, linked into a wheel slot while waiting
+	 */
+	struct Task
+	{
+		Task(int taskId, const char *taskName, AampReactorTask taskFunction) : id(taskId), name(taskName),
+			function(taskFunction), state(eTASK_WAITING), dueTick(0), dueUs(0), level(0), slot(0),
+			prev(NULL), next(NULL), runner(), wakePending(false), cancelled(false)
+		{
+		}
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+		int id;
+		std::string name;
+		AampReactorTask function;
+		TaskState state;
+		uint64_t dueTick;
+		long long dueUs;	/**< Requested time of next run, for lateness */
+		int level;
+		int slot;
+		Task *prev;
+		Task *next;
+		std::thread::id runner;
+		bool wakePending;
+		bool cancelled;
+	};
+
+	/**
+	 * @fn AampReactor
+	 */
+	AampReactor();
+
+	/**
+	 * @fn NowUs
+	 * @return monotonic time in us
+	 */
+	static long long NowUs();
+
+	/**
+	 * @fn StartThreads
+	 * @brief Start timer thread and first workers, mMutex held
+	 */
+	void StartThreads();
+
+	/**
+	 * @fn AddWorker
+	 * @brief Start a worker thread, mMutex held
+	 */
+	void AddWorker();
+
+	/**
+	 * @fn Arm
+	 * @brief Insert task into wheel, or ready queue if due, mMutex held
+	 * @param[in] task - task to insert
+	 * @param[in] delayMs - delay from now
+	 */
+	void Arm(Task *task, int delayMs);
+
+	/**
+	 * @fn Insert
+	 * @brief Link task into the wheel slot of its due tick, mMutex held
+	 */
+	void Insert(Task *task);
+
+	/**
+	 * @fn Unlink
+	 * @brief Remove task from its wheel slot, mMutex held
+	 */
+	void Unlink(Task *task);
+
+	/**
+	 * @fn MakeReady
+	 * @brief Queue task for the workers, mMutex held
+	 */
+	void MakeReady(Task *task);
+
+	/**
+	 * @fn GetNextEventTick
+	 * @return first tick after mCurrentTick with a due slot or a cascade, UINT64_MAX if wheel is empty
+	 */
+	uint64_t GetNextEventTick() const;
+
+	/**
+	 * @fn ProcessTick
+	 * @brief Cascade upper level slots reached at tick and make level 0 slot ready, mMutex held
+	 */
+	void ProcessTick(uint64_t tick);
+
+	/**
+	 * @fn RunTimer
+	 * @brief Timer thread
+	 */
+	void RunTimer();
+
+	/**
+	 * @fn RunWorker
+	 * @brief Worker thread
+	 */
+	void RunWorker();
+
+	std::mutex mMutex;
+	std::condition_variable mTimerCond;
+	std::condition_variable mWorkerCond;
+	std::condition_variable mDoneCond;	/**< A task ended, for Cancel */
+	std::unordered_map<int, std::unique_ptr<Task>> mTasks;
+	Task *mWheel[AAMP_REACTOR_WHEEL_LEVELS][AAMP_REACTOR_WHEEL_SLOTS];
+	uint64_t mOccupied[AAMP_REACTOR_WHEEL_LEVELS];	/**< Bit per non empty slot */
+	uint64_t mCurrentTick;				/**< Last tick processed */
+	uint64_t mSleepUntilTick;			/**< Tick the timer thread waits for */
+	long long mStartUs;
+	std::deque<Task *> mReady;
+	std::map<std::string, AampReactorTaskStats> mStats;
+	std::thread mTimerThread;
+	std::vector<std::thread> mWorkers;
+	int mIdleWorkers;
+	int mNextId;
+	bool mStopping;
+};
+
+#endif /* __AAMP_REACTOR_H__ */
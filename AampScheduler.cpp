@@ -23,12 +23,13 @@
  */
 
 #include "AampScheduler.h"
+#include "AampReactor.h"
 
 /**
  * @brief AampScheduler Constructor
  */
-AampScheduler::AampScheduler() : mTaskQueue(), mQMutex(), mQCond(),
-	mSchedulerRunning(false), mSchedulerThread(), mExMutex(),
+AampScheduler::AampScheduler() : mTaskQueue(), mQMutex(),
+	mSchedulerRunning(false), mDrainTaskId(AAMP_REACTOR_TASK_ID_INVALID), mExMutex(),
 	mExLock(mExMutex, std::defer_lock), mNextTaskId(AAMP_SCHEDULER_ID_DEFAULT),
 	mCurrentTaskId(AAMP_TASK_ID_INVALID), mLockOut(false),
 	mLogObj(NULL),mState(eSTATE_IDLE)
@@ -47,15 +48,14 @@ AampScheduler::~AampScheduler()
 }
 
 /**
- * @brief To start scheduler thread
+ * @brief To start scheduler
  */
 void AampScheduler::StartScheduler()
 {
-	//Turn on thread for processing async operations
+	//Queued tasks are run by a reactor task, posted when the queue gets a task
 	std::lock_guard<std::mutex>lock(mQMutex);
-	mSchedulerThread = std::thread(std::bind(&AampScheduler::ExecuteAsyncTask, this));
 	mSchedulerRunning = true;
-	AAMPLOG_WARN("Started Async Worker Thread");
+	AAMPLOG_WARN("Started Async Worker");
 }
 
 /**
@@ -81,7 +81,10 @@ int AampScheduler::ScheduleTask(AsyncTaskObj obj)
 			}
 			obj.mId = id;
 			mTaskQueue.push_back(obj);
-			mQCond.notify_one();
+			if (AAMP_REACTOR_TASK_ID_INVALID == mDrainTaskId)
+			{
+				mDrainTaskId = AampReactor::GetInstance().Schedule("AampScheduler", 0, std::bind(&AampScheduler::ExecuteAsyncTask, this));
+			}
 		}
 		else
 		{
@@ -97,57 +100,52 @@ int AampScheduler::ScheduleTask(AsyncTaskObj obj)
 }
 
 /**
- * @brief Executes scheduled tasks - invoked by thread
+ * @brief Executes scheduled tasks - invoked by reactor
  */
-void AampScheduler::ExecuteAsyncTask()
+int AampScheduler::ExecuteAsyncTask()
 {
 	std::unique_lock<std::mutex>queueLock(mQMutex);
-	while (mSchedulerRunning)
+	while (mSchedulerRunning && !mTaskQueue.empty())
 	{
-		if (mTaskQueue.empty())
-		{
-			mQCond.wait(queueLock);
-		}
-		else
+		/* DELIA-57121
+		Take the execution lock before taking a task from the queue
+		otherwise this function could hold a task, out of the queue,
+		that cannot be deleted by RemoveAllTasks()!
+		Allow the queue to be modified while waiting.*/
+		queueLock.unlock();
+		std::lock_guard<std::mutex>executionLock(mExMutex);
+		queueLock.lock();
+
+		//DELIA-57121 - note: mTaskQueue could have been modified while waiting for execute permission
+		if (!mTaskQueue.empty())
 		{
-			/* DELIA-57121
-			Take the execution lock before taking a task from the queue
-			otherwise this function could hold a task, out of the queue,
-			that cannot be deleted by RemoveAllTasks()!
-			Allow the queue to be modified while waiting.*/
-			queueLock.unlock();
-			std::lock_guard<std::mutex>executionLock(mExMutex);
-			queueLock.lock();
-
-			//DELIA-57121 - note: mTaskQueue could have been modified while waiting for execute permission
-			if (!mTaskQueue.empty())
+			AsyncTaskObj obj = mTaskQueue.front();
+			mTaskQueue.pop_front();
+			if (obj.mId != AAMP_TASK_ID_INVALID)
 			{
-				AsyncTaskObj obj = mTaskQueue.front();
-				mTaskQueue.pop_front();
-				if (obj.mId != AAMP_TASK_ID_INVALID)
+				mCurrentTaskId = obj.mId;
+				AAMPLOG_INFO("Found entry in function queue!!, task:%s. State:%d",obj.mTaskName.c_str(),mState);
+				if( mState != eSTATE_ERROR && mState != eSTATE_RELEASED)
 				{
-					mCurrentTaskId = obj.mId;
-					AAMPLOG_INFO("Found entry in function queue!!, task:%s. State:%d",obj.mTaskName.c_str(),mState);
-					if( mState != eSTATE_ERROR && mState != eSTATE_RELEASED)
-					{
-						//Unlock so that new entries can be added to queue while function executes
-						queueLock.unlock();
-
-						AAMPLOG_WARN("SchedulerTask Execution:%s",obj.mTaskName.c_str());
-						//Execute function
-						obj.mTask(obj.mData);
-						//May be used in a wait() in future loops, it needs to be locked
-						queueLock.lock();
-					}
-				}
-				else
-				{
-					AAMPLOG_ERR("Scheduler found a task with invalid ID, skip task!");
+					//Unlock so that new entries can be added to queue while function executes
+					queueLock.unlock();
+
+					AAMPLOG_WARN("SchedulerTask Execution:%s",obj.mTaskName.c_str());
+					//Execute function
+					obj.mTask(obj.mData);
+					//Queue is checked again for the next task, it needs to be locked
+					queueLock.lock();
 				}
 			}
+			else
+			{
+				AAMPLOG_ERR("Scheduler found a task with invalid ID, skip task!");
+			}
 		}
 	}
-	AAMPLOG_INFO("Exited Async Worker Thread");
+	//Next task scheduled posts the drain again
+	mDrainTaskId = AAMP_REACTOR_TASK_ID_INVALID;
+	return AAMP_REACTOR_TASK_DONE;
 }
 
 /**
@@ -172,9 +170,12 @@ void AampScheduler::RemoveAllTasks()
  */
 void AampScheduler::StopScheduler()
 {
-	AAMPLOG_WARN("Stopping Async Worker Thread");
+	AAMPLOG_WARN("Stopping Async Worker");
 	// Clean up things in queue
-	mSchedulerRunning = false;
+	{
+		std::lock_guard<std::mutex>lock(mQMutex);
+		mSchedulerRunning = false;
+	}
 
 	//DELIA-57121 allow StopScheduler() to be called without warning from a nonsuspended state and
 	//DELIA-57122 not cause an error in ResumeScheduler() below due to trying to unlock an unlocked lock
@@ -185,11 +186,17 @@ void AampScheduler::StopScheduler()
 
 	RemoveAllTasks();
 
-	//DELIA-57122 prevent possible deadlock where mSchedulerThread is waiting for mExLock/mExMutex
+	//DELIA-57122 prevent possible deadlock where the drain task is waiting for mExLock/mExMutex
 	ResumeScheduler();
-	mQCond.notify_one();
-    if (mSchedulerThread.joinable())
-        mSchedulerThread.join();
+	int drainTaskId;
+	{
+		std::lock_guard<std::mutex>lock(mQMutex);
+		drainTaskId = mDrainTaskId;
+	}
+	//Drain task sees the empty queue, waits for it to return
+	AampReactor::GetInstance().Cancel(drainTaskId);
+	std::lock_guard<std::mutex>lock(mQMutex);
+	mDrainTaskId = AAMP_REACTOR_TASK_ID_INVALID;
 }
 
 /**
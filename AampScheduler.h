@@ -176,16 +176,16 @@ protected:
 
 	/**
 	 * @fn ExecuteAsyncTask
+	 * @brief Run queued tasks in order, run by the reactor while the queue is not empty
 	 *
-	 * @return void
+	 * @return AAMP_REACTOR_TASK_DONE once the queue is empty
 	 */
-	void ExecuteAsyncTask();
+	int ExecuteAsyncTask();
 
 	std::deque<AsyncTaskObj> mTaskQueue;	/**< Queue for storing scheduled tasks */
 	std::mutex mQMutex;			/**< Mutex for accessing mTaskQueue */
-	std::condition_variable mQCond;		/**< To notify when a task is queued in mTaskQueue */
-	bool mSchedulerRunning;			/**< Flag denotes if scheduler thread is running */
-	std::thread mSchedulerThread;		/**< Scheduler thread */
+	bool mSchedulerRunning;			/**< Flag denotes if scheduler is running */
+	int mDrainTaskId;			/**< Reactor task running mTaskQueue, invalid while queue is idle */
 	std::mutex mExMutex;			/**< Execution mutex for synchronization */
 	std::unique_lock<std::mutex> mExLock;	/**< Lock to be used by SuspendScheduler and ResumeScheduler */
 	int mNextTaskId;			/**< counter that holds ID value of next task to be scheduled */
@@ -0,0 +1,188 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampSpscRing.cpp
+ * @brief Positions of a bounded single producer, single consumer ring
+ */
+
+#include "AampSpscRing.h"
+#include <chrono>
+
+/**
+ * @brief AampSpscRing Constructor
+ */
+AampSpscRing::AampSpscRing() : mCapacity(0), mWakeupSlots(1), mCount(0), mWriteIndex(0), mReadIndex(0),
+	mProducerWaiting(false), mConsumerWaiting(false), mAborted(false), mWakeups(0), mMutex(), mCond()
+{
+}
+
+/**
+ * @brief Empty ring
+ */
+void AampSpscRing::Reset(int capacity, int wakeupSlots)
+{
+	mCapacity = (capacity > 0) ? capacity : 0;
+	mWakeupSlots = wakeupSlots;
+	if (mWakeupSlots > mCapacity)
+	{
+		mWakeupSlots = mCapacity;
+	}
+	if (mWakeupSlots < 1)
+	{
+		mWakeupSlots = 1;
+	}
+	mCount = 0;
+	mWriteIndex = 0;
+	mReadIndex = 0;
+}
+
+/**
+ * @brief Publish slots from write index
+ */
+bool AampSpscRing::Push(int slots)
+{
+	if (slots < 1 || mCount.load(std::memory_order_acquire) > mCapacity - slots)
+	{
+		return false;
+	}
+	int next = mWriteIndex.load(std::memory_order_relaxed) + slots;
+	mWriteIndex.store((next >= mCapacity) ? next - mCapacity : next, std::memory_order_relaxed);
+	// sequentially consistent with the waiting flag store in Wait, one side always sees the other
+	mCount.fetch_add(slots);
+	if (mConsumerWaiting.load())
+	{
+		Notify();
+	}
+	return true;
+}
+
+/**
+ * @brief Free slots from read index
+ */
+bool AampSpscRing::Pop(int slots)
+{
+	if (slots < 1 || mCount.load(std::memory_order_acquire) < slots)
+	{
+		return false;
+	}
+	int next = mReadIndex.load(std::memory_order_relaxed) + slots;
+	mReadIndex.store((next >= mCapacity) ? next - mCapacity : next, std::memory_order_relaxed);
+	int count = mCount.fetch_sub(slots) - slots;
+	if (mProducerWaiting.load() && (mCapacity - count) >= mWakeupSlots)
+	{
+		Notify();
+	}
+	return true;
+}
+
+/**
+ * @brief Block producer while ring is full
+ */
+bool AampSpscRing::WaitForFreeSlot(int timeoutMs)
+{
+	if (mAborted.load())
+	{
+		return false;
+	}
+	if (mCount.load(std::memory_order_acquire) < mCapacity)
+	{
+		return true;
+	}
+	return Wait(true, timeoutMs);
+}
+
+/**
+ * @brief Block consumer while ring is empty
+ */
+bool AampSpscRing::WaitForUsedSlot(int timeoutMs)
+{
+	if (mAborted.load())
+	{
+		return false;
+	}
+	if (mCount.load(std::memory_order_acquire) > 0)
+	{
+		return true;
+	}
+	return Wait(false, timeoutMs);
+}
+
+/**
+ * @brief Set or clear abort
+ */
+void AampSpscRing::SetAborted(bool aborted)
+{
+	mAborted = aborted;
+	if (aborted)
+	{
+		Notify();
+	}
+}
+
+/**
+ * @brief Make consumer wait in progress return
+ */
+void AampSpscRing::WakeConsumer()
+{
+	mWakeups++;
+	Notify();
+}
+
+/**
+ * @brief Slow path of WaitForFreeSlot and WaitForUsedSlot
+ */
+bool AampSpscRing::Wait(bool producer, int timeoutMs)
+{
+	std::atomic<bool> &waiting = producer ? mProducerWaiting : mConsumerWaiting;
+	unsigned int wakeups = mWakeups.load();
+	// once blocked, producer waits for a batch of free slots
+	int minFree = producer ? mWakeupSlots : 0;
+	auto ready = [&]() {
+		int count = mCount.load();
+		return mAborted.load() || (!producer && wakeups != mWakeups.load()) || (producer ? (mCapacity - count >= minFree) : (count > 0));
+	};
+	std::unique_lock<std::mutex> lock(mMutex);
+	waiting = true;
+	if (timeoutMs >= 0)
+	{
+		mCond.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready);
+	}
+	else
+	{
+		mCond.wait(lock, ready);
+	}
+	waiting = false;
+	if (mAborted.load() || (!producer && wakeups != mWakeups.load()))
+	{
+		return false;
+	}
+	int count = mCount.load(std::memory_order_acquire);
+	return producer ? (count < mCapacity) : (count > 0);
+}
+
+/**
+ * @brief Wake blocked side
+ */
+void AampSpscRing::Notify()
+{
+	// taking the mutex orders notify after a waiter that saw the old state has blocked
+	std::lock_guard<std::mutex> guard(mMutex);
+	mCond.notify_all();
+}
@@ -0,0 +1,160 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampSpscRing.h
+ * @brief Positions of a bounded single producer, single consumer ring
+ */
+
+#ifndef __AAMP_SPSC_RING_H__
+#define __AAMP_SPSC_RING_H__
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @class AampSpscRing
+ * @brief Write and read positions of a ring of slots owned by the caller
+ *
+ * One thread fills the slot at GetWriteIndex and publishes it with Push, another one
+ * consumes the slot at GetReadIndex and frees it with Pop. Both run without a lock while
+ * the ring is neither full nor empty; the mutex is only taken by a side that has to block
+ * and by the other side to wake it. A blocked producer is woken once the configured
+ * number of slots is free, so a consumer draining a full ring does not switch threads
+ * on every slot.
+ */
+class AampSpscRing
+{
+public:
+	/**
+	 * @fn AampSpscRing
+	 */
+	AampSpscRing();
+
+	AampSpscRing(const AampSpscRing&) = delete;
+	AampSpscRing& operator=(const AampSpscRing&) = delete;
+
+	/**
+	 * @fn Reset
+	 * @brief Empty ring, not to be called while producer or consumer use it
+	 * @param[in] capacity - number of slots
+	 * @param[in] wakeupSlots - free slots needed to wake a blocked producer, 1 to wake on every Pop
+	 */
+	void Reset(int capacity, int wakeupSlots = 1);
+
+	/**
+	 * @fn GetCapacity
+	 * @return number of slots
+	 */
+	int GetCapacity() const { return mCapacity; }
+
+	/**
+	 * @fn GetCount
+	 * @return number of published slots not yet freed
+	 */
+	int GetCount() const { return mCount.load(std::memory_order_acquire); }
+
+	/**
+	 * @fn GetWriteIndex
+	 * @return slot to fill next, producer only
+	 */
+	int GetWriteIndex() const { return mWriteIndex.load(std::memory_order_relaxed); }
+
+	/**
+	 * @fn GetReadIndex
+	 * @return slot to consume next, consumer only
+	 */
+	int GetReadIndex() const { return mReadIndex.load(std::memory_order_relaxed); }
+
+	/**
+	 * @fn Push
+	 * @brief Publish slots from write index, wakes consumer if it is blocked
+	 * @param[in] slots - consecutive slots filled, published at once
+	 * @return false if fewer slots are free
+	 */
+	bool Push(int slots = 1);
+
+	/**
+	 * @fn Pop
+	 * @brief Free slots from read index, wakes producer if it is blocked and enough slots are free
+	 * @param[in] slots - consecutive slots consumed
+	 * @return false if fewer slots are published
+	 */
+	bool Pop(int slots = 1);
+
+	/**
+	 * @fn WaitForFreeSlot
+	 * @brief Block producer while ring is full
+	 * @param[in] timeoutMs - maximum wait, negative to wait until woken
+	 * @return true if a slot is free, false on timeout or abort
+	 */
+	bool WaitForFreeSlot(int timeoutMs);
+
+	/**
+	 * @fn WaitForUsedSlot
+	 * @brief Block consumer while ring is empty
+	 * @param[in] timeoutMs - maximum wait, negative to wait until woken
+	 * @return true if a slot is published, false on timeout, abort or WakeConsumer
+	 */
+	bool WaitForUsedSlot(int timeoutMs);
+
+	/**
+	 * @fn SetAborted
+	 * @brief While set, waits return false immediately
+	 */
+	void SetAborted(bool aborted);
+
+	/**
+	 * @fn IsAborted
+	 */
+	bool IsAborted() const { return mAborted.load(); }
+
+	/**
+	 * @fn WakeConsumer
+	 * @brief Make a consumer wait in progress return false without setting abort
+	 */
+	void WakeConsumer();
+
+private:
+	/**
+	 * @fn Wait
+	 * @param[in] producer - true to wait for free slots, false for used ones
+	 */
+	bool Wait(bool producer, int timeoutMs);
+
+	/**
+	 * @fn Notify
+	 */
+	void Notify();
+
+	int mCapacity;
+	int mWakeupSlots;
+	std::atomic<int> mCount;
+	std::atomic<int> mWriteIndex;
+	std::atomic<int> mReadIndex;
+	std::atomic<bool> mProducerWaiting;
+	std::atomic<bool> mConsumerWaiting;
+	std::atomic<bool> mAborted;
+	std::atomic<unsigned int> mWakeups;	/**< Incremented by WakeConsumer, consumer waits return when it changes */
+	std::mutex mMutex;
+	std::condition_variable mCond;
+};
+
+#endif /* __AAMP_SPSC_RING_H__ */
@@ -0,0 +1,183 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampTimelineIndex.cpp
+ * @brief Prefix sum index over a DASH SegmentTimeline for logarithmic seeks
+ */
+
+#include "AampTimelineIndex.h"
+#include <algorithm>
+
+#define TIMELINE_INDEX_DEFAULT_FRAGMENT_DURATION 2.0	/**< Same fallback as used by MPD collector for bad S@d or timescale */
+
+/**
+ * @brief AampTimelineIndex Constructor
+ */
+AampTimelineIndex::AampTimelineIndex() : mNodes(), mFragmentCount(0), mOwner(NULL), mGeneration(0), mTimeScale(0)
+{
+}
+
+/**
+ * @brief Build prefix sums for a timeline
+ */
+void AampTimelineIndex::Build(const std::vector<AampTimelineEntry> &entries, uint32_t timeScale, const void *owner, unsigned int generation)
+{
+	mNodes.clear();
+	mNodes.reserve(entries.size());
+	uint64_t nextStartTime = 0;
+	uint64_t ordinal = 0;
+	double offsetSeconds = 0;
+	int lastStartEntry = -1;
+	for (size_t idx = 0; idx < entries.size(); idx++)
+	{
+		const AampTimelineEntry &entry = entries[idx];
+		Node node;
+		if (entry.hasStartTime)
+		{
+			node.startTime = entry.startTime;
+			lastStartEntry = (int)idx;
+		}
+		else
+		{
+			node.startTime = nextStartTime;
+		}
+		node.ordinal = ordinal;
+		node.offsetSeconds = offsetSeconds;
+		node.fragmentDuration = (entry.duration && timeScale) ? ((double)entry.duration / (double)timeScale) : TIMELINE_INDEX_DEFAULT_FRAGMENT_DURATION;
+		node.duration = entry.duration;
+		node.repeatCount = entry.repeatCount;
+		node.lastStartEntry = lastStartEntry;
+		mNodes.push_back(node);
+
+		uint64_t fragments = (uint64_t)entry.repeatCount + 1;
+		nextStartTime = node.startTime + fragments * entry.duration;
+		ordinal += fragments;
+		offsetSeconds += fragments * node.fragmentDuration;
+	}
+	mFragmentCount = ordinal;
+	mOwner = owner;
+	mGeneration = generation;
+	mTimeScale = timeScale;
+}
+
+/**
+ * @brief Drop index
+ */
+void AampTimelineIndex::Reset()
+{
+	mNodes.clear();
+	mFragmentCount = 0;
+	mOwner = NULL;
+	mGeneration = 0;
+	mTimeScale = 0;
+}
+
+/**
+ * @brief Check if index is current for given timeline
+ */
+bool AampTimelineIndex::IsBuiltFor(const void *owner, unsigned int generation, size_t entryCount, uint32_t timeScale) const
+{
+	return (owner != NULL && owner == mOwner && generation == mGeneration && entryCount == mNodes.size() && timeScale == mTimeScale);
+}
+
+/**
+ * @brief Get fragment ordinal of (entry, repeat)
+ */
+uint64_t AampTimelineIndex::GetOrdinal(int entry, int repeat) const
+{
+	return mNodes[entry].ordinal + repeat;
+}
+
+/**
+ * @brief Convert fragment ordinal to (entry, repeat)
+ */
+void AampTimelineIndex::GetPosition(uint64_t ordinal, int &entry, int &repeat) const
+{
+	// last entry starting at or before ordinal
+	auto it = std::upper_bound(mNodes.begin(), mNodes.end(), ordinal,
+		[](uint64_t value, const Node &node) { return value < node.ordinal; });
+	entry = (int)(it - mNodes.begin()) - 1;
+	repeat = (int)(ordinal - mNodes[entry].ordinal);
+}
+
+/**
+ * @brief Get offset of fragment start from timeline start
+ */
+double AampTimelineIndex::GetOffsetSeconds(int entry, int repeat) const
+{
+	const Node &node = mNodes[entry];
+	return node.offsetSeconds + repeat * node.fragmentDuration;
+}
+
+/**
+ * @brief Get start time of fragment in timescale units
+ */
+uint64_t AampTimelineIndex::GetStartTime(int entry, int repeat) const
+{
+	const Node &node = mNodes[entry];
+	return node.startTime + (uint64_t)repeat * node.duration;
+}
+
+/**
+ * @brief Check for S@t in (fromEntry, toEntry]
+ */
+bool AampTimelineIndex::HasStartTimeBetween(int fromEntry, int toEntry) const
+{
+	return mNodes[toEntry].lastStartEntry > fromEntry;
+}
+
+/**
+ * @brief Find fragment containing an offset
+ */
+uint64_t AampTimelineIndex::FindFragmentBySeconds(double offsetSeconds) const
+{
+	if (mNodes.empty())
+	{
+		return 0;
+	}
+	if (offsetSeconds <= 0)
+	{
+		return 0;
+	}
+	auto it = std::upper_bound(mNodes.begin(), mNodes.end(), offsetSeconds,
+		[](double value, const Node &node) { return value < node.offsetSeconds; });
+	const Node &node = *(it - 1);
+	uint64_t repeat = (uint64_t)((offsetSeconds - node.offsetSeconds) / node.fragmentDuration);
+	if (repeat > node.repeatCount)
+	{
+		if (it == mNodes.end())
+		{
+			return mFragmentCount;
+		}
+		repeat = node.repeatCount; // rounding at entry boundary
+	}
+	return node.ordinal + repeat;
+}
+
+/**
+ * @brief Find first entry ending after a time
+ */
+int AampTimelineIndex::FindEntryByTime(uint64_t time, int fromEntry) const
+{
+	// entries are in presentation order, so ends are ascending
+	auto it = std::upper_bound(mNodes.begin() + fromEntry, mNodes.end(), time,
+		[](uint64_t value, const Node &node) { return value < node.startTime + ((uint64_t)node.repeatCount + 1) * node.duration; });
+	return (int)(it - mNodes.begin());
+}
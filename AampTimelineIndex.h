@@ -0,0 +1,170 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampTimelineIndex.h
+ * @brief Prefix sum index over a DASH SegmentTimeline for logarithmic seeks
+ */
+
+#ifndef __AAMP_TIMELINE_INDEX_H__
+#define __AAMP_TIMELINE_INDEX_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/**
+ * @struct AampTimelineEntry
+ * @brief One S element of a SegmentTimeline
+ */
+struct AampTimelineEntry
+{
+	uint64_t startTime;	/**< S@t, valid if hasStartTime */
+	bool hasStartTime;	/**< S@t present */
+	uint32_t duration;	/**< S@d in timescale units */
+	uint32_t repeatCount;	/**< S@r, entry describes repeatCount+1 fragments */
+
+	AampTimelineEntry() : startTime(0), hasStartTime(false), duration(0), repeatCount(0)
+	{
+	}
+};
+
+/**
+ * @class AampTimelineIndex
+ * @brief Cumulative fragment numbers, start times and offsets of each S element
+ *
+ * A fragment is addressed either by (entry, repeat), matching timeLineIndex and
+ * fragmentRepeatCount of a track, or by its ordinal from start of the timeline.
+ * Offsets in seconds are sums of S@d/timescale per fragment, the unit tracks advance
+ * fragmentTime in, so a jump lands where stepping fragment by fragment would.
+ * Index is rebuilt when owner (timeline) or generation (manifest update) changes.
+ */
+class AampTimelineIndex
+{
+public:
+	/**
+	 * @fn AampTimelineIndex
+	 */
+	AampTimelineIndex();
+
+	AampTimelineIndex(const AampTimelineIndex&) = delete;
+	AampTimelineIndex& operator=(const AampTimelineIndex&) = delete;
+
+	/**
+	 * @fn Build
+	 * @param[in] entries - S elements in document order
+	 * @param[in] timeScale - timescale of the segment template
+	 * @param[in] owner - timeline the entries were read from
+	 * @param[in] generation - manifest update count the timeline belongs to
+	 */
+	void Build(const std::vector<AampTimelineEntry> &entries, uint32_t timeScale, const void *owner, unsigned int generation);
+
+	/**
+	 * @fn Reset
+	 * @brief Drop index, next IsBuiltFor fails
+	 */
+	void Reset();
+
+	/**
+	 * @fn IsBuiltFor
+	 * @return true if index is current for given timeline
+	 */
+	bool IsBuiltFor(const void *owner, unsigned int generation, size_t entryCount, uint32_t timeScale) const;
+
+	/**
+	 * @fn GetEntryCount
+	 * @return number of S elements
+	 */
+	size_t GetEntryCount() const { return mNodes.size(); }
+
+	/**
+	 * @fn GetFragmentCount
+	 * @return number of fragments described by timeline
+	 */
+	uint64_t GetFragmentCount() const { return mFragmentCount; }
+
+	/**
+	 * @fn GetOrdinal
+	 * @return fragment ordinal of (entry, repeat)
+	 */
+	uint64_t GetOrdinal(int entry, int repeat) const;
+
+	/**
+	 * @fn GetPosition
+	 * @brief Convert fragment ordinal to (entry, repeat), ordinal must be less than GetFragmentCount
+	 */
+	void GetPosition(uint64_t ordinal, int &entry, int &repeat) const;
+
+	/**
+	 * @fn GetOffsetSeconds
+	 * @return offset of fragment start from timeline start, in seconds
+	 */
+	double GetOffsetSeconds(int entry, int repeat) const;
+
+	/**
+	 * @fn GetStartTime
+	 * @return start time of fragment in timescale units; S elements without S@t follow previous one
+	 */
+	uint64_t GetStartTime(int entry, int repeat) const;
+
+	/**
+	 * @fn HasStartTimeBetween
+	 * @return true if any S element in (fromEntry, toEntry] carries S@t
+	 */
+	bool HasStartTimeBetween(int fromEntry, int toEntry) const;
+
+	/**
+	 * @fn FindFragmentBySeconds
+	 * @param[in] offsetSeconds - offset from timeline start
+	 * @return ordinal of fragment containing offset, GetFragmentCount if offset is beyond last fragment
+	 */
+	uint64_t FindFragmentBySeconds(double offsetSeconds) const;
+
+	/**
+	 * @fn FindEntryByTime
+	 * @param[in] time - time in timescale units
+	 * @param[in] fromEntry - first entry considered
+	 * @return first entry at or after fromEntry ending after time, GetEntryCount if none
+	 */
+	int FindEntryByTime(uint64_t time, int fromEntry) const;
+
+private:
+	/**
+	 * @struct Node
+	 * @brief Prefix sums up to the start of an S element
+	 */
+	struct Node
+	{
+		uint64_t startTime;		/**< Resolved start time of first fragment */
+		uint64_t ordinal;		/**< Fragments before this entry */
+		double offsetSeconds;		/**< Duration of fragments before this entry */
+		double fragmentDuration;	/**< Duration of one fragment in seconds */
+		uint32_t duration;		/**< Duration of one fragment in timescale units */
+		uint32_t repeatCount;
+		int lastStartEntry;		/**< Last entry up to this one carrying S@t, -1 if none */
+	};
+
+	std::vector<Node> mNodes;
+	uint64_t mFragmentCount;
+	const void *mOwner;
+	unsigned int mGeneration;
+	uint32_t mTimeScale;
+};
+
+#endif /* __AAMP_TIMELINE_INDEX_H__ */
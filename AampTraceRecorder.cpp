@@ -0,0 +1,329 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampTraceRecorder.cpp
+ * @brief Per thread flight recorder of timed spans
+ */
+
+#include "AampTraceRecorder.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <chrono>
+#include <algorithm>
+
+std::atomic<bool> AampTraceRecorder::sEnabled(false);
+thread_local AampTraceRecorder::ThreadSlot AampTraceRecorder::sThreadSlot;
+
+/**
+ * @brief Append JSON string literal, escaping quotes, backslash and control characters
+ */
+static void AppendJsonString(std::string &json, const char *str)
+{
+	json += '"';
+	for (const char *p = str ? str : ""; *p; p++)
+	{
+		unsigned char c = (unsigned char)*p;
+		if (c == '"' || c == '\\')
+		{
+			json += '\\';
+			json += (char)c;
+		}
+		else if (c < 0x20)
+		{
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			json += escaped;
+		}
+		else
+		{
+			json += (char)c;
+		}
+	}
+	json += '"';
+}
+
+/**
+ * @brief Append thread or process name metadata event
+ */
+static void AppendNameEvent(std::string &json, const char *name, int pid, int tid, const char *value)
+{
+	json += "{\"ph\":\"M\",\"name\":\"";
+	json += name;
+	json += "\",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(tid) + ",\"args\":{\"name\":";
+	AppendJsonString(json, value);
+	json += "}},\n";
+}
+
+/**
+ * @brief Get process wide recorder
+ */
+AampTraceRecorder &AampTraceRecorder::GetInstance()
+{
+	static AampTraceRecorder instance;
+	return instance;
+}
+
+/**
+ * @brief AampTraceRecorder constructor
+ */
+AampTraceRecorder::AampTraceRecorder() : mMutex(), mBuffers(), mGeneration(0), mEventsPerThread(AAMP_TRACE_MIN_EVENTS), mNextTid(1)
+{
+}
+
+/**
+ * @brief Mark buffer of ending thread as reusable, its events stay for export
+ */
+AampTraceRecorder::ThreadSlot::~ThreadSlot()
+{
+	if (buffer)
+	{
+		buffer->retired.store(true, std::memory_order_release);
+	}
+}
+
+/**
+ * @brief Steady clock in microseconds
+ */
+long long AampTraceRecorder::NowUs()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Drop recorded events and start recording
+ */
+void AampTraceRecorder::Start(size_t eventsPerThread)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	mBuffers.clear();
+	mEventsPerThread = std::max(eventsPerThread, (size_t)AAMP_TRACE_MIN_EVENTS);
+	mNextTid = 1;
+	mGeneration++;
+	sEnabled.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Stop recording
+ */
+void AampTraceRecorder::Stop()
+{
+	sEnabled.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Get ring of calling thread, registering a ring on first event of a session
+ */
+AampTraceRecorder::ThreadBuffer *AampTraceRecorder::GetThreadBuffer()
+{
+	ThreadSlot &slot = sThreadSlot;
+	unsigned int generation = mGeneration.load(std::memory_order_acquire);
+	if (slot.buffer && slot.generation == generation)
+	{
+		return slot.buffer.get();
+	}
+	char threadName[16] = {0};
+	(void)pthread_getname_np(pthread_self(), threadName, sizeof(threadName));
+
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (slot.buffer)
+	{
+		slot.buffer->retired.store(true, std::memory_order_release);
+	}
+	slot.buffer.reset();
+	generation = mGeneration.load(std::memory_order_acquire);
+	std::shared_ptr<ThreadBuffer> buffer;
+	if (mBuffers.size() < AAMP_TRACE_MAX_THREADS)
+	{
+		buffer = std::make_shared<ThreadBuffer>(mEventsPerThread, mNextTid++);
+		mBuffers.push_back(buffer);
+	}
+	else
+	{
+		auto it = std::find_if(mBuffers.begin(), mBuffers.end(), [](const std::shared_ptr<ThreadBuffer> &candidate)
+		{
+			return candidate.use_count() == 1 && candidate->retired.load(std::memory_order_acquire);
+		});
+		if (it == mBuffers.end())
+		{
+			return NULL;
+		}
+		// ring of an ended thread is handed over, its events are lost
+		buffer = std::make_shared<ThreadBuffer>(mEventsPerThread, mNextTid++);
+		*it = buffer;
+	}
+	buffer->threadName = threadName;
+	slot.buffer = buffer;
+	slot.generation = generation;
+	return buffer.get();
+}
+
+/**
+ * @brief Append event to ring of calling thread
+ */
+void AampTraceRecorder::Add(char phase, const char *category, const char *name, long long startUs, long long durationUs,
+		const char *argName0, long long arg0, const char *argName1, long long arg1, const char *argName2, long long arg2)
+{
+	ThreadBuffer *buffer = GetThreadBuffer();
+	if (buffer)
+	{
+		unsigned long long head = buffer->head.load(std::memory_order_relaxed);
+		AampTraceEvent &event = buffer->events[head % buffer->events.size()];
+		event.timestampUs = startUs;
+		event.durationUs = durationUs;
+		event.category = category;
+		event.name = name;
+		event.argNames[0] = argName0;
+		event.argValues[0] = arg0;
+		event.argNames[1] = argName1;
+		event.argValues[1] = arg1;
+		event.argNames[2] = argName2;
+		event.argValues[2] = arg2;
+		event.phase = phase;
+		buffer->head.store(head + 1, std::memory_order_release);
+	}
+}
+
+/**
+ * @brief Record a span of calling thread
+ */
+void AampTraceRecorder::AddComplete(const char *category, const char *name, long long startUs, long long durationUs,
+		const char *argName0, long long arg0, const char *argName1, long long arg1, const char *argName2, long long arg2)
+{
+	if (IsEnabled())
+	{
+		Add('X', category, name, startUs, std::max(durationUs, 0LL), argName0, arg0, argName1, arg1, argName2, arg2);
+	}
+}
+
+/**
+ * @brief Record a point in time event of calling thread
+ */
+void AampTraceRecorder::AddInstant(const char *category, const char *name,
+		const char *argName0, long long arg0, const char *argName1, long long arg1, const char *argName2, long long arg2)
+{
+	if (IsEnabled())
+	{
+		Add('i', category, name, NowUs(), 0, argName0, arg0, argName1, arg1, argName2, arg2);
+	}
+}
+
+/**
+ * @brief Record a counter sample
+ */
+void AampTraceRecorder::AddCounter(const char *category, const char *name, const char *argName, long long value)
+{
+	if (IsEnabled())
+	{
+		Add('C', category, name, NowUs(), 0, argName, value, NULL, 0, NULL, 0);
+	}
+}
+
+/**
+ * @brief Export recorded events of all threads as Chrome trace event JSON
+ */
+size_t AampTraceRecorder::GetJson(std::string &json)
+{
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		buffers = mBuffers;
+	}
+	int pid = (int)getpid();
+	size_t count = 0;
+	json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	AppendNameEvent(json, "process_name", pid, 0, "aamp");
+	std::vector<AampTraceEvent> events;
+	for (const auto &buffer : buffers)
+	{
+		// one slot stays spare for the event being written
+		size_t capacity = buffer->events.size();
+		unsigned long long end = buffer->head.load(std::memory_order_acquire);
+		unsigned long long begin = (end + 1 > capacity) ? (end + 1 - capacity) : 0;
+		events.clear();
+		for (unsigned long long i = begin; i < end; i++)
+		{
+			events.push_back(buffer->events[i % capacity]);
+		}
+		// events a writer went over while they were copied are dropped
+		unsigned long long after = buffer->head.load(std::memory_order_acquire);
+		unsigned long long valid = (after + 1 > capacity) ? (after + 1 - capacity) : 0;
+		size_t first = (valid > begin) ? (size_t)std::min<unsigned long long>(valid - begin, events.size()) : 0;
+
+		AppendNameEvent(json, "thread_name", pid, buffer->tid, buffer->threadName.empty() ? "thread" : buffer->threadName.c_str());
+		for (size_t i = first; i < events.size(); i++)
+		{
+			const AampTraceEvent &event = events[i];
+			json += "{\"ph\":\"";
+			json += event.phase;
+			json += "\",\"cat\":";
+			AppendJsonString(json, event.category);
+			json += ",\"name\":";
+			AppendJsonString(json, event.name);
+			json += ",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(buffer->tid) + ",\"ts\":" + std::to_string(event.timestampUs);
+			if (event.phase == 'X')
+			{
+				json += ",\"dur\":" + std::to_string(event.durationUs);
+			}
+			else if (event.phase == 'i')
+			{
+				json += ",\"s\":\"t\"";
+			}
+			json += ",\"args\":{";
+			bool firstArg = true;
+			for (int arg = 0; arg < AAMP_TRACE_MAX_ARGS; arg++)
+			{
+				if (event.argNames[arg])
+				{
+					if (!firstArg)
+					{
+						json += ',';
+					}
+					AppendJsonString(json, event.argNames[arg]);
+					json += ':' + std::to_string(event.argValues[arg]);
+					firstArg = false;
+				}
+			}
+			json += "}},\n";
+			count++;
+		}
+	}
+	// metadata events always precede, so the last separator is replaced
+	json.resize(json.size() - 2);
+	json += "\n]}\n";
+	return count;
+}
+
+/**
+ * @brief Write recorded events of all threads to file
+ */
+bool AampTraceRecorder::WriteJson(const std::string &path)
+{
+	std::string json;
+	(void)GetJson(json);
+	bool ret = false;
+	FILE *file = fopen(path.c_str(), "w");
+	if (file)
+	{
+		ret = (fwrite(json.data(), 1, json.size(), file) == json.size());
+		ret = (fclose(file) == 0) && ret;
+	}
+	return ret;
+}
@@ -0,0 +1,255 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampTraceRecorder.h
+ * @brief Per thread flight recorder of timed spans, exported as Chrome trace event JSON
+ */
+
+#ifndef __AAMP_TRACE_RECORDER_H__
+#define __AAMP_TRACE_RECORDER_H__
+
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define AAMP_TRACE_MAX_ARGS		3	/**< Numeric arguments of an event */
+#define AAMP_TRACE_MAX_THREADS		64	/**< Thread buffers kept, buffers of ended threads are reused beyond it */
+#define AAMP_TRACE_MIN_EVENTS		256	/**< Least events per thread buffer */
+
+/**
+ * @struct AampTraceEvent
+ * @brief Recorded event. Names are string literals, so recording never allocates
+ */
+struct AampTraceEvent
+{
+	long long timestampUs;				/**< Steady clock start */
+	long long durationUs;				/**< Complete events only */
+	const char *category;
+	const char *name;
+	const char *argNames[AAMP_TRACE_MAX_ARGS];	/**< NULL for unused argument */
+	long long argValues[AAMP_TRACE_MAX_ARGS];
+	char phase;					/**< 'X' complete, 'i' instant, 'C' counter */
+};
+
+/**
+ * @class AampTraceRecorder
+ * @brief Process wide recorder of the fetch, decrypt, demux and inject pipeline
+ *
+ * Each thread records into a ring of its own without lock or allocation; a full ring
+ * overwrites its oldest events, so a capture holds the latest history of every thread.
+ * A thread takes the registry lock once, when it records its first event. Export copies
+ * each ring and drops the events a writer overwrote during the copy. The JSON written
+ * opens in Perfetto UI and chrome://tracing, one track per thread.
+ */
+class AampTraceRecorder
+{
+public:
+	/**
+	 * @fn GetInstance
+	 * @return process wide recorder
+	 */
+	static AampTraceRecorder &GetInstance();
+
+	/**
+	 * @fn IsEnabled
+	 * @retval true while recording, cheap enough to test before building an event
+	 */
+	static bool IsEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+	/**
+	 * @fn NowUs
+	 * @return steady clock in microseconds, same base as NOW_STEADY_TS_MS
+	 */
+	static long long NowUs();
+
+	AampTraceRecorder(const AampTraceRecorder&) = delete;
+	AampTraceRecorder& operator=(const AampTraceRecorder&) = delete;
+
+	/**
+	 * @fn Start
+	 * @brief Drop recorded events and start recording
+	 * @param[in] eventsPerThread - ring size of each thread
+	 * @return void
+	 */
+	void Start(size_t eventsPerThread);
+
+	/**
+	 * @fn Stop
+	 * @brief Stop recording, recorded events are kept for export
+	 * @return void
+	 */
+	void Stop();
+
+	/**
+	 * @fn AddComplete
+	 * @brief Record a span of calling thread
+	 * @param[in] category - category literal
+	 * @param[in] name - name literal
+	 * @param[in] startUs - start from NowUs
+	 * @param[in] durationUs - duration
+	 * @param[in] argName0..2 - argument name literals, NULL for none
+	 * @param[in] arg0..2 - argument values
+	 * @return void
+	 */
+	void AddComplete(const char *category, const char *name, long long startUs, long long durationUs,
+			const char *argName0 = NULL, long long arg0 = 0, const char *argName1 = NULL, long long arg1 = 0,
+			const char *argName2 = NULL, long long arg2 = 0);
+
+	/**
+	 * @fn AddInstant
+	 * @brief Record a point in time event of calling thread
+	 * @return void
+	 */
+	void AddInstant(const char *category, const char *name,
+			const char *argName0 = NULL, long long arg0 = 0, const char *argName1 = NULL, long long arg1 = 0,
+			const char *argName2 = NULL, long long arg2 = 0);
+
+	/**
+	 * @fn AddCounter
+	 * @brief Record a counter sample, drawn as a graph
+	 * @return void
+	 */
+	void AddCounter(const char *category, const char *name, const char *argName, long long value);
+
+	/**
+	 * @fn GetJson
+	 * @brief Export recorded events of all threads
+	 * @param[out] json - Chrome trace event JSON
+	 * @return number of events exported
+	 */
+	size_t GetJson(std::string &json);
+
+	/**
+	 * @fn WriteJson
+	 * @param[in] path - output file, replaced
+	 * @retval true if written
+	 */
+	bool WriteJson(const std::string &path);
+
+private:
+	/**
+	 * @struct ThreadBuffer
+	 * @brief Event ring written by one thread
+	 */
+	struct ThreadBuffer
+	{
+		ThreadBuffer(size_t capacity, int tid) : events(capacity + 1), head(0), tid(tid), threadName(), retired(false) {}
+		std::vector<AampTraceEvent> events;		/**< One slot more than events kept */
+		std::atomic<unsigned long long> head;	/**< Events ever written, next slot is head % capacity */
+		int tid;				/**< Track id in trace */
+		std::string threadName;
+		std::atomic<bool> retired;		/**< Thread ended, buffer may be reused */
+	};
+
+	/**
+	 * @struct ThreadSlot
+	 * @brief Thread local link to the buffer of a thread
+	 */
+	struct ThreadSlot
+	{
+		ThreadSlot() : buffer(), generation(0) {}
+		~ThreadSlot();
+		std::shared_ptr<ThreadBuffer> buffer;
+		unsigned int generation;	/**< Recording session the buffer belongs to */
+	};
+
+	/**
+	 * @fn AampTraceRecorder
+	 */
+	AampTraceRecorder();
+
+	/**
+	 * @fn GetThreadBuffer
+	 * @return ring of calling thread, NULL if none is available
+	 */
+	ThreadBuffer *GetThreadBuffer();
+
+	/**
+	 * @fn Add
+	 * @brief Append event to ring of calling thread
+	 */
+	void Add(char phase, const char *category, const char *name, long long startUs, long long durationUs,
+			const char *argName0, long long arg0, const char *argName1, long long arg1, const char *argName2, long long arg2);
+
+	static std::atomic<bool> sEnabled;
+	static thread_local ThreadSlot sThreadSlot;
+
+	std::mutex mMutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> mBuffers;	/**< Rings of current session */
+	std::atomic<unsigned int> mGeneration;			/**< Incremented by Start */
+	size_t mEventsPerThread;
+	int mNextTid;
+};
+
+/**
+ * @class AampTraceSpan
+ * @brief Records a span from construction to End or destruction, when recorder is enabled
+ */
+class AampTraceSpan
+{
+public:
+	/**
+	 * @brief AampTraceSpan constructor
+	 * @param[in] category - category literal
+	 * @param[in] name - name literal
+	 * @param[in] argName - argument name literal, NULL for none
+	 * @param[in] arg - argument value
+	 */
+	AampTraceSpan(const char *category, const char *name, const char *argName = NULL, long long arg = 0) :
+		mCategory(category), mName(name), mArgName(argName), mArg(arg), mStartUs(AampTraceRecorder::IsEnabled() ? AampTraceRecorder::NowUs() : -1)
+	{
+	}
+
+	~AampTraceSpan()
+	{
+		End();
+	}
+
+	AampTraceSpan(const AampTraceSpan&) = delete;
+	AampTraceSpan& operator=(const AampTraceSpan&) = delete;
+
+	/**
+	 * @brief Record span now, with up to two results known at its end
+	 */
+	void End(const char *resultName0 = NULL, long long result0 = 0, const char *resultName1 = NULL, long long result1 = 0)
+	{
+		if (mStartUs >= 0)
+		{
+			if (AampTraceRecorder::IsEnabled())
+			{
+				AampTraceRecorder::GetInstance().AddComplete(mCategory, mName, mStartUs, AampTraceRecorder::NowUs() - mStartUs,
+					mArgName, mArg, resultName0, result0, resultName1, result1);
+			}
+			mStartUs = -1;
+		}
+	}
+
+private:
+	const char *mCategory;
+	const char *mName;
+	const char *mArgName;
+	long long mArg;
+	long long mStartUs;
+};
+
+#endif /* __AAMP_TRACE_RECORDER_H__ */
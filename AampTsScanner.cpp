@@ -0,0 +1,222 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampTsScanner.cpp
+ * @brief Classification of MPEG-TS packets by PID ahead of demux
+ */
+
+#include "AampTsScanner.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define AAMP_TS_SCAN_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AAMP_TS_SCAN_NEON
+#endif
+
+#define TS_HEADER_SYNC_MASK 0x000000FFu		/**< Sync byte in header word */
+#define TS_HEADER_SYNC_PID_MASK 0x00FF1FFFu	/**< Sync byte and 13 bit PID in header word */
+#define TS_HEADER_NO_MATCH 0xFFFFFFFFu		/**< Key no masked header word equals */
+#define TS_MASK_SYNC_OK 0x80			/**< Internal mask bit, sync byte present */
+#define TS_SCAN_GROUP 4				/**< Packets compared per vector */
+
+/**
+ * @brief First four header bytes with byte 0 in the low bits, independent of host byte order
+ */
+static inline uint32_t ReadHeaderWord(const unsigned char *packet)
+{
+	return (uint32_t)packet[0] | ((uint32_t)packet[1] << 8) | ((uint32_t)packet[2] << 16) | ((uint32_t)packet[3] << 24);
+}
+
+/**
+ * @brief Masked header word of a packet with sync byte and given PID
+ */
+static inline uint32_t MakeKey(int pid)
+{
+	if (pid < 0 || pid > 0x1FFF)
+	{
+		return TS_HEADER_NO_MATCH;
+	}
+	return AAMP_TS_SYNC_BYTE | ((uint32_t)(pid >> 8) << 8) | ((uint32_t)(pid & 0xFF) << 16);
+}
+
+/**
+ * @brief Payload bytes following header and adaptation field
+ */
+static inline size_t GetPayloadSize(const unsigned char *packet)
+{
+	if (!(packet[3] & 0x10))
+	{
+		return 0;
+	}
+	size_t offset = 4;
+	if (packet[3] & 0x20)
+	{
+		offset += 1 + packet[4];
+	}
+	return (offset < AAMP_TS_PACKET_SIZE) ? (AAMP_TS_PACKET_SIZE - offset) : 0;
+}
+
+/**
+ * @brief Compare four header words against sync byte and PID keys
+ */
+static inline void ClassifyGroup(const uint32_t *words, const uint32_t *keys, int pidCount, uint8_t *masks)
+{
+#if defined(AAMP_TS_SCAN_SSE2)
+	__m128i header = _mm_set_epi32((int)words[3], (int)words[2], (int)words[1], (int)words[0]);
+	__m128i masked = _mm_and_si128(header, _mm_set1_epi32((int)TS_HEADER_SYNC_PID_MASK));
+	int sync = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(header, _mm_set1_epi32((int)TS_HEADER_SYNC_MASK)), _mm_set1_epi32(AAMP_TS_SYNC_BYTE))));
+	int bits[AAMP_TS_SCAN_MAX_PIDS] = {0};
+	for (int slot = 0; slot < pidCount; slot++)
+	{
+		bits[slot] = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(masked, _mm_set1_epi32((int)keys[slot]))));
+	}
+	for (int i = 0; i < TS_SCAN_GROUP; i++)
+	{
+		uint8_t mask = ((sync >> i) & 1) ? TS_MASK_SYNC_OK : 0;
+		for (int slot = 0; slot < pidCount; slot++)
+		{
+			mask |= ((bits[slot] >> i) & 1) << slot;
+		}
+		masks[i] = mask;
+	}
+#elif defined(AAMP_TS_SCAN_NEON)
+	uint32x4_t header = vld1q_u32(words);
+	uint32x4_t masked = vandq_u32(header, vdupq_n_u32(TS_HEADER_SYNC_PID_MASK));
+	// each lane accumulates its packet's mask bits
+	uint32x4_t result = vandq_u32(vceqq_u32(vandq_u32(header, vdupq_n_u32(TS_HEADER_SYNC_MASK)), vdupq_n_u32(AAMP_TS_SYNC_BYTE)), vdupq_n_u32(TS_MASK_SYNC_OK));
+	for (int slot = 0; slot < pidCount; slot++)
+	{
+		result = vorrq_u32(result, vandq_u32(vceqq_u32(masked, vdupq_n_u32(keys[slot])), vdupq_n_u32(1u << slot)));
+	}
+	uint32_t lanes[TS_SCAN_GROUP];
+	vst1q_u32(lanes, result);
+	for (int i = 0; i < TS_SCAN_GROUP; i++)
+	{
+		masks[i] = (uint8_t)lanes[i];
+	}
+#else
+	for (int i = 0; i < TS_SCAN_GROUP; i++)
+	{
+		uint8_t mask = ((words[i] & TS_HEADER_SYNC_MASK) == AAMP_TS_SYNC_BYTE) ? TS_MASK_SYNC_OK : 0;
+		uint32_t masked = words[i] & TS_HEADER_SYNC_PID_MASK;
+		for (int slot = 0; slot < pidCount; slot++)
+		{
+			if (masked == keys[slot])
+			{
+				mask |= (1 << slot);
+			}
+		}
+		masks[i] = mask;
+	}
+#endif
+}
+
+/**
+ * @brief AampTsScanner Constructor
+ */
+AampTsScanner::AampTsScanner() : mMasks(), mMatched(), mPackets(), mPayloadBytes(), mSyncErrors(0)
+{
+}
+
+/**
+ * @brief Classify complete packets of buffer by PID
+ */
+size_t AampTsScanner::Scan(const unsigned char *buffer, size_t len, const int *pids, int pidCount)
+{
+	size_t packetCount = buffer ? (len / AAMP_TS_PACKET_SIZE) : 0;
+	uint32_t keys[AAMP_TS_SCAN_MAX_PIDS];
+
+	if (pidCount > AAMP_TS_SCAN_MAX_PIDS)
+	{
+		pidCount = AAMP_TS_SCAN_MAX_PIDS;
+	}
+	if (pidCount < 0)
+	{
+		pidCount = 0;
+	}
+	for (int slot = 0; slot < AAMP_TS_SCAN_MAX_PIDS; slot++)
+	{
+		keys[slot] = (slot < pidCount) ? MakeKey(pids[slot]) : TS_HEADER_NO_MATCH;
+		mPackets[slot].clear();
+		mPayloadBytes[slot] = 0;
+	}
+	mMatched.clear();
+	mSyncErrors = 0;
+	// capacity is kept between segments, steady state scans do not allocate
+	mMasks.resize(packetCount);
+
+	uint32_t words[TS_SCAN_GROUP];
+	uint8_t masks[TS_SCAN_GROUP];
+	for (size_t first = 0; first < packetCount; first += TS_SCAN_GROUP)
+	{
+		int groupSize = TS_SCAN_GROUP;
+		if (packetCount - first < TS_SCAN_GROUP)
+		{
+			groupSize = (int)(packetCount - first);
+		}
+		for (int i = 0; i < TS_SCAN_GROUP; i++)
+		{
+			words[i] = (i < groupSize) ? ReadHeaderWord(buffer + (first + i) * AAMP_TS_PACKET_SIZE) : 0;
+		}
+		ClassifyGroup(words, keys, pidCount, masks);
+
+		for (int i = 0; i < groupSize; i++)
+		{
+			uint8_t mask = masks[i];
+			if (!(mask & TS_MASK_SYNC_OK))
+			{
+				mSyncErrors++;
+			}
+			mask &= ~TS_MASK_SYNC_OK;
+			mMasks[first + i] = mask;
+			if (mask)
+			{
+				uint32_t packet = (uint32_t)(first + i);
+				size_t payload = GetPayloadSize(buffer + packet * AAMP_TS_PACKET_SIZE);
+				mMatched.push_back(packet);
+				for (int slot = 0; slot < pidCount; slot++)
+				{
+					if (mask & (1 << slot))
+					{
+						mPackets[slot].push_back(packet);
+						mPayloadBytes[slot] += payload;
+					}
+				}
+			}
+		}
+	}
+	return packetCount;
+}
+
+/**
+ * @brief Name of header comparison code compiled in
+ */
+const char *AampTsScanner::GetImplementation()
+{
+#if defined(AAMP_TS_SCAN_SSE2)
+	return "sse2";
+#elif defined(AAMP_TS_SCAN_NEON)
+	return "neon";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,117 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampTsScanner.h
+ * @brief Classification of MPEG-TS packets by PID ahead of demux
+ */
+
+#ifndef __AAMP_TS_SCANNER_H__
+#define __AAMP_TS_SCANNER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#define AAMP_TS_PACKET_SIZE 188		/**< Size of a TS packet without timestamp prefix */
+#define AAMP_TS_SYNC_BYTE 0x47		/**< First byte of every TS packet */
+#define AAMP_TS_SCAN_MAX_PIDS 4		/**< PIDs one scan can classify */
+
+/**
+ * @class AampTsScanner
+ * @brief Validates sync bytes and sorts the packets of a segment by PID in one pass
+ *
+ * Packet headers are compared four at a time with SSE2 or NEON where available,
+ * falling back to scalar code otherwise. Each complete packet gets a bit mask of the
+ * watched PIDs it carries, packets with a bad sync byte never match. Packet index
+ * lists are kept per PID and for all matched packets in stream order, so a demuxer
+ * can skip packets it has no use for without looking at them.
+ */
+class AampTsScanner
+{
+public:
+	/**
+	 * @fn AampTsScanner
+	 */
+	AampTsScanner();
+
+	AampTsScanner(const AampTsScanner&) = delete;
+	AampTsScanner& operator=(const AampTsScanner&) = delete;
+
+	/**
+	 * @fn Scan
+	 * @param[in] buffer - TS packets, trailing partial packet is ignored
+	 * @param[in] len - buffer length in bytes
+	 * @param[in] pids - watched PIDs, negative entries never match
+	 * @param[in] pidCount - number of PIDs, at most AAMP_TS_SCAN_MAX_PIDS
+	 * @return number of complete packets
+	 */
+	size_t Scan(const unsigned char *buffer, size_t len, const int *pids, int pidCount);
+
+	/**
+	 * @fn GetPacketCount
+	 * @return complete packets of last scan
+	 */
+	size_t GetPacketCount() const { return mMasks.size(); }
+
+	/**
+	 * @fn GetSyncErrorCount
+	 * @return packets of last scan not starting with sync byte
+	 */
+	size_t GetSyncErrorCount() const { return mSyncErrors; }
+
+	/**
+	 * @fn GetMask
+	 * @return bit (1 << n) set if packet carries pids[n]
+	 */
+	unsigned int GetMask(size_t packet) const { return mMasks[packet]; }
+
+	/**
+	 * @fn GetMatchedPackets
+	 * @return indices of packets carrying any watched PID, in stream order
+	 */
+	const std::vector<uint32_t>& GetMatchedPackets() const { return mMatched; }
+
+	/**
+	 * @fn GetPackets
+	 * @return indices of packets carrying pids[slot], in stream order
+	 */
+	const std::vector<uint32_t>& GetPackets(int slot) const { return mPackets[slot]; }
+
+	/**
+	 * @fn GetPayloadBytes
+	 * @return payload bytes after adaptation field in packets carrying pids[slot]
+	 */
+	size_t GetPayloadBytes(int slot) const { return mPayloadBytes[slot]; }
+
+	/**
+	 * @fn GetImplementation
+	 * @return name of header comparison code compiled in
+	 */
+	static const char *GetImplementation();
+
+private:
+	std::vector<uint8_t> mMasks;
+	std::vector<uint32_t> mMatched;
+	std::vector<uint32_t> mPackets[AAMP_TS_SCAN_MAX_PIDS];
+	size_t mPayloadBytes[AAMP_TS_SCAN_MAX_PIDS];
+	size_t mSyncErrors;
+};
+
+#endif /* __AAMP_TS_SCANNER_H__ */
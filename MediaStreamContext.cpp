@@ -83,9 +83,15 @@ bool MediaStreamContext::CacheFragment(std::string fragmentUrl, unsigned int cur
         int iFogError = -1;
         int iCurrentRate = aamp->rate; //  Store it as back up, As sometimes by the time File is downloaded, rate might have changed due to user initiated Trick-Play
         bool bReadfromcache = false;
+        AampCachedFilePtr initFragment;
         if(initSegment)
         {
-            ret = bReadfromcache = aamp->getAampCacheHandler()->RetrieveFromInitFragCache(fragmentUrl,&cachedFragment->fragment,effectiveUrl);
+            initFragment = aamp->getAampCacheHandler()->BorrowFromInitFragCache(fragmentUrl);
+            ret = bReadfromcache = (initFragment != NULL);
+            if(bReadfromcache)
+            {
+                effectiveUrl = initFragment->effectiveUrl;
+            }
         }
 
         if(!bReadfromcache)
@@ -93,7 +99,13 @@ bool MediaStreamContext::CacheFragment(std::string fragmentUrl, unsigned int cur
             ret = aamp->LoadFragment(pCMCDMetrics,bucketType, fragmentUrl,effectiveUrl, &cachedFragment->fragment, curlInstance,
                     range, actualType, &httpErrorCode, &downloadTime, &bitrate, &iFogError, fragmentDurationSeconds );
 			if ( initSegment && ret )
-            			aamp->getAampCacheHandler()->InsertToInitFragCache ( fragmentUrl, &cachedFragment->fragment, effectiveUrl, actualType);
+            			initFragment = aamp->getAampCacheHandler()->InsertToInitFragCache ( fragmentUrl, &cachedFragment->fragment, effectiveUrl, actualType, aamp->GetResponseValidator(curlInstance));
+        }
+
+        if(initFragment)
+        {
+            // track id overwrite and webvtt parsing modify the fragment in place
+            aamp->UseCachedInitFragment(initFragment, &cachedFragment->fragment, (overWriteTrackId || eMEDIATYPE_INIT_SUBTITLE == actualType));
         }
 
         if (iCurrentRate != AAMP_NORMAL_PLAY_RATE)
@@ -199,7 +211,7 @@ bool MediaStreamContext::CacheFragment(std::string fragmentUrl, unsigned int cur
     else if (!ret)
     {
 	AAMPLOG_INFO("fragment fetch failed - Free cachedFragment");
-        aamp_Free(&cachedFragment->fragment);
+        aamp->ReleaseFragmentBuffer(&cachedFragment->fragment, (MediaType)type);
         if( aamp->DownloadsAreEnabled())
         {
             AAMPLOG_WARN("%sfragment fetch failed -- fragmentUrl %s", (initSegment)?"Init ":" ", fragmentUrl.c_str());
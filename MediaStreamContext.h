@@ -53,6 +53,7 @@ public:
             downloadedDuration(0)//,mCMCDNetworkMetrics{-1,-1,-1}
 	   , scaledPTO(0),pCMCDMetrics(NULL)
 	   , failAdjacentSegment(false),httpErrorCode(0)
+	   , timelineIndex()
     {
         memset(&mDownloadedFragment, 0, sizeof(GrowableBuffer));
         fragmentDescriptor.bUseMatchingBaseUrl = ISCONFIGSET(eAAMPConfig_MatchBaseUrl);
@@ -72,7 +73,7 @@ public:
      */
     ~MediaStreamContext()
     {
-        aamp_Free(&mDownloadedFragment);
+        aamp->ReleaseFragmentBuffer(&mDownloadedFragment, mediaType);
 	delete pCMCDMetrics;
     }
 
@@ -184,6 +185,7 @@ public:
     double scaledPTO;
     bool failAdjacentSegment;
     long httpErrorCode;
+    AampTimelineIndex timelineIndex; /**< SegmentTimeline index of current representation */
 }; // MediaStreamContext
 
 #endif /* MEDIASTREAMCONTEXT_H */
@@ -28,6 +28,10 @@
 #include "AampMemoryUtils.h"
 #include "priv_aamp.h"
 #include "AampJsonObject.h"
+#include "AampSpscRing.h"
+#include "AampBolaAbr.h"
+#include "isobmffstreamparser.h"
+#include "isobmffboxindex.h"
 #include <map>
 #include <iterator>
 #include <vector>
@@ -368,7 +372,17 @@ public:
 	bool IsDiscontinuityProcessed() { return discontinuityProcessed; }
 
 	bool isFragmentInjectorThreadStarted( ) {  return fragmentInjectorThreadStarted;}
-	void MonitorBufferHealth();
+	/**
+	 * @fn MonitorBufferHealth
+	 * @brief One check of buffer health, run by the reactor
+	 * @return ms until next check, AAMP_REACTOR_TASK_DONE once downloads stop
+	 */
+	int MonitorBufferHealth();
+	/**
+	 * @fn ScheduleBufferHealthMonitor
+	 * @brief Register buffer health monitor with the reactor unless it is scheduled
+	 * @return void
+	 */
 	void ScheduleBufferHealthMonitor();
 
 	/**
@@ -434,6 +448,14 @@ public:
 
 protected:
 
+	/**
+	 * @fn UpdateChunkRingAbort
+	 * @brief Propagate abort and abortInjectChunk to chunk ring waits
+	 *
+	 * @return void
+	 */
+	void UpdateChunkRingAbort();
+
 	/**
 	 * @fn UpdateTSAfterInject
 	 *
@@ -514,9 +536,9 @@ public:
 	bool eosReached;                    /**< set to true when a vod asset has been played to completion */
 	bool enabled;                       /**< set to true if track is enabled */
 	int numberOfFragmentsCached;        /**< Number of fragments cached in this track*/
-	int numberOfFragmentChunksCached;   /**< Number of fragments cached in this track*/
 	const char* name;                   /**< Track name used for debugging*/
 	double fragmentDurationSeconds;     /**< duration in seconds for current fragment-of-interest */
+	double lastFragmentSizeRatio;       /**< Size of last fetched fragment over size given by its bitrate, 0 if unknown */
 	int segDLFailCount;                 /**< Segment download fail count*/
 	int segDrmDecryptFailCount;         /**< Segment decryption failure count*/
 	int mSegInjectFailCount;            /**< Segment Inject/Decode fail count */
@@ -525,7 +547,6 @@ public:
 	bool refreshSubtitles;              /**< Switch subtitle track in the FetchLoop */
 	int maxCachedFragmentsPerTrack;
 	int maxCachedFragmentChunksPerTrack;
-	pthread_cond_t fragmentChunkFetched;/**< Signaled after a fragment Chunk is fetched*/
 	uint32_t totalMdatCount;            /**< Total MDAT Chunk Found*/
 	int noMDATCount;                    /**< MDAT Chunk Not Found count continuously while chunk buffer processoing*/
 
@@ -534,7 +555,8 @@ protected:
 	PrivateInstanceAAMP* aamp;          /**< Pointer to the PrivateInstanceAAMP*/
 	CachedFragment *cachedFragment;     /**< storage for currently-downloaded fragment */
 	CachedFragmentChunk cachedFragmentChunks[DEFAULT_CACHED_FRAGMENT_CHUNKS_PER_TRACK];
-	GrowableBuffer unparsedBufferChunk; /**< Buffer to keep fragment content */
+	IsoBmffStreamParser mChunkParser;   /**< Chunk bytes not yet injected, split at complete mdat boxes */
+	std::vector<IsoBmffBoxRecord> mChunkBoxRecords; /**< Box index storage for chunk units, grows to the largest unit seen */
 	GrowableBuffer parsedBufferChunk;   /**< Buffer to keep fragment content */
 	bool abort;                         /**< Abort all operations if flag is set*/
 	pthread_mutex_t mutex;              /**< protection of track variables accessed from multiple threads */
@@ -546,29 +568,26 @@ private:
 	pthread_cond_t fragmentFetched;     	/**< Signaled after a fragment is fetched*/
 	pthread_cond_t fragmentInjected;    	/**< Signaled after a fragment is injected*/
 	pthread_t fragmentInjectorThreadID;  	/**< Fragment injector thread id*/
-	pthread_cond_t fragmentChunkInjected;	/**< Signaled after a fragment is injected*/
 	pthread_t fragmentChunkInjectorThreadID;/**< Fragment injector thread id*/
-	pthread_t bufferMonitorThreadID;    	/**< Buffer Monitor thread id */
 	int totalFragmentsDownloaded;       	/**< Total fragments downloaded since start by track*/
 	int totalFragmentChunksDownloaded;      /**< Total fragments downloaded since start by track*/
 	bool fragmentInjectorThreadStarted; 	/**< Fragment injector's thread started or not*/
 	bool fragmentChunkInjectorThreadStarted;/**< Fragment Chunk injector's thread started or not*/
-	bool bufferMonitorThreadStarted;    	/**< Buffer Monitor thread started or not */
+	int bufferMonitorTaskId;            	/**< Buffer Monitor reactor task id */
 	double totalInjectedDuration;       	/**< Total fragment injected duration*/
 	double totalInjectedChunksDuration;  	/**< Total fragment injected chunk duration*/
 	int currentInitialCacheDurationSeconds; /**< Current cached fragments duration before playing*/
 	bool sinkBufferIsFull;                	/**< True if sink buffer is full and do not want new fragments*/
 	bool cachingCompleted;              	/**< Fragment caching completed or not*/
 	int fragmentIdxToInject;            	/**< Write position */
-	int fragmentChunkIdxToInject;       	/**< Write position */
 	int fragmentIdxToFetch;             	/**< Read position */
-	int fragmentChunkIdxToFetch;        	/**< Read position */
 	int bandwidthBitsPerSecond;        	/**< Bandwidth of last selected profile*/
 	double totalFetchedDuration;        	/**< Total fragment fetched duration*/
 	bool discontinuityProcessed;
 	BufferHealthStatus bufferStatus;     /**< Buffer status of the track*/
 	BufferHealthStatus prevBufferStatus; /**< Previous buffer status of the track*/
 	long long prevDownloadStartTime;		/**< Previous file download Start time*/
+	AampSpscRing mChunkRing;		/**< Fetch and inject positions in cachedFragmentChunks, handed over without mutex */
 };
 
 /**
@@ -751,6 +770,13 @@ public:
 	 *   @return None.
 	 */
 	void GetDesiredProfileOnSteadyState(int currProfileIndex, int &newProfileIndex, long nwBandwidth);
+	/**
+	 *   @fn GetDesiredProfileOnBola
+	 *
+	 *   @param [in] nwBandwidth - network bandwidth estimate, -1 if unknown
+	 *   @return profile index chosen from video buffer level
+	 */
+	int GetDesiredProfileOnBola(long nwBandwidth);
 	/**
 	 *   @fn ConfigureTimeoutOnBuffer
 	 *
@@ -1436,6 +1462,8 @@ private:
 	int mABRCacheLength;		    /**< ABR cache length*/
 	int mABRMinBuffer;		    /**< ABR ramp down buffer*/
 	int mABRNwConsistency;		    /**< ABR Network consistency*/
+	bool mBolaAbrEnabled;		    /**< Buffer based ABR replaces bandwidth based one */
+	AampBolaAbr mBolaAbr;		    /**< Buffer based ABR state */
 	bool mESChangeStatus;               /**< flag value which is used to call pipeline configuration if the audio type changed in mid stream */
 	unsigned int mAudiostateChangeCount;/**< variable to know how many times player need to reconfigure the pipeline for audio type change*/
 	double mLastVideoFragParsedTimeMS;  /**< timestamp when last video fragment was parsed */
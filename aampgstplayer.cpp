@@ -28,6 +28,8 @@
 #include "isobmffbuffer.h"
 #include "AampUtils.h"
 #include "AampGstUtils.h"
+#include "AampBufferPool.h"
+#include "AampTraceRecorder.h"
 #include <gst/gst.h>
 #include <gst/app/gstappsrc.h>
 #include <gst/app/gstappsink.h>
@@ -2620,10 +2622,49 @@ void AAMPGstPlayer::SendNewSegmentEvent(MediaType mediaType, GstClockTime startP
         }
 }
 
+/**
+ * @struct AampWrappedFragment
+ * @brief Fragment memory handed to gstreamer without copy, released from GstMemory destroy notify
+ */
+struct AampWrappedFragment
+{
+	std::shared_ptr<AampBufferPool> pool;	/**< Pool the memory is returned to, empty if pooling is disabled */
+	std::shared_ptr<const AampCachedFile> cachedFile;	/**< Cached init fragment owning the memory, empty for downloaded fragments */
+	GrowableBuffer fragment;		/**< Wrapped fragment memory */
+	MediaType type;				/**< Media type of fragment */
+
+	AampWrappedFragment(std::shared_ptr<AampBufferPool> fragmentPool, std::shared_ptr<const AampCachedFile> file, const GrowableBuffer &buffer, MediaType mediaType) :
+		pool(fragmentPool), cachedFile(file), fragment(buffer), type(mediaType)
+	{
+	}
+};
+
+/**
+ * @brief GstMemory destroy notify, returns wrapped fragment memory to buffer pool or drops the cache reference
+ * @param[in] userData AampWrappedFragment context
+ */
+static void ReleaseWrappedFragment(gpointer userData)
+{
+	AampWrappedFragment *wrapped = static_cast<AampWrappedFragment *>(userData);
+	if (!wrapped->cachedFile)
+	{
+		if (wrapped->pool)
+		{
+			wrapped->pool->Release(&wrapped->fragment, wrapped->type);
+		}
+		else
+		{
+			aamp_Free(&wrapped->fragment);
+		}
+	}
+	// a cached init fragment stays with the cache, deleting the context drops the reference
+	delete wrapped;
+}
+
 /**
  *  @brief Inject stream buffer to gstreamer pipeline
  */
-bool AAMPGstPlayer::SendHelper(MediaType mediaType, const void *ptr, size_t len, double fpts, double fdts, double fDuration, bool copy, bool initFragment)
+bool AAMPGstPlayer::SendHelper(MediaType mediaType, const void *ptr, size_t len, double fpts, double fdts, double fDuration, bool copy, bool initFragment, GstBuffer *wrappedBuffer)
 {
 	if(ISCONFIGSET(eAAMPConfig_SuppressDecode))
 	{
@@ -2700,6 +2741,7 @@ bool AAMPGstPlayer::SendHelper(MediaType mediaType, const void *ptr, size_t len,
 	}
 
 
+	bool bufferSent = false;
 	if( aamp->DownloadsAreEnabled())
 	{
 		GstBuffer *buffer;
@@ -2727,7 +2769,14 @@ bool AAMPGstPlayer::SendHelper(MediaType mediaType, const void *ptr, size_t len,
 		}
 		else
 		{ // transfer
-			buffer = gst_buffer_new_wrapped((gpointer)ptr,(gsize)len);
+			if (wrappedBuffer)
+			{ // zero copy, caller keeps its own reference
+				buffer = gst_buffer_ref(wrappedBuffer);
+			}
+			else
+			{
+				buffer = gst_buffer_new_wrapped((gpointer)ptr,(gsize)len);
+			}
 
 			if (buffer)
 			{
@@ -2744,12 +2793,15 @@ bool AAMPGstPlayer::SendHelper(MediaType mediaType, const void *ptr, size_t len,
 
 		if (bPushBuffer)
 		{
+			bufferSent = true;
 			if (mediaType == eMEDIATYPE_AUDIO && ForwardAudioBuffersToAux())
 			{
 				ForwardBuffersToAuxPipeline(buffer);
 			}
 
+			AampTraceSpan traceSpan("gstreamer", "gst_push", "type", mediaType);
 			GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(stream->source), buffer);
+			traceSpan.End("bytes", (long long)len, "pts_ms", (long long)(pts / GST_MSECOND));
 
 			if (ret != GST_FLOW_OK)
 			{
@@ -2791,7 +2843,8 @@ bool AAMPGstPlayer::SendHelper(MediaType mediaType, const void *ptr, size_t len,
 		StopBuffering(false);
 	}
 
-	return true;
+	// a transfer not handed to gstreamer is freed by the caller
+	return bufferSent;
 }
 
 /**
@@ -2809,7 +2862,24 @@ void AAMPGstPlayer::SendCopy(MediaType mediaType, const void *ptr, size_t len0,
 void AAMPGstPlayer::SendTransfer(MediaType mediaType, GrowableBuffer* pBuffer, double fpts, double fdts, double fDuration, bool initFragment)
 {
 	FN_TRACE( __FUNCTION__ );
-	if( !SendHelper( mediaType, pBuffer->ptr, pBuffer->len, fpts, fdts, fDuration, false /*transfer*/, initFragment) )
+	// a cached init fragment is never freed here, it is always wrapped read only
+	std::shared_ptr<const AampCachedFile> cachedFile = aamp->TakeBorrowedFragment(pBuffer);
+	if ((ISCONFIGSET(eAAMPConfig_EnableZeroCopyInjection) || cachedFile) && pBuffer->ptr)
+	{
+		// Wrap the fragment memory as is; the destroy notify gives it back to the fragment buffer pool once
+		// gstreamer is done with it, or frees it if the buffer could not be sent.
+		std::shared_ptr<AampBufferPool> pool;
+		if (ISCONFIGSET(eAAMPConfig_EnableFragmentBufferPool))
+		{
+			pool = aamp->GetFragmentBufferPool();
+		}
+		AampWrappedFragment *wrapped = new AampWrappedFragment(pool, cachedFile, *pBuffer, mediaType);
+		GstMemoryFlags flags = (cachedFile ? GST_MEMORY_FLAG_READONLY : (GstMemoryFlags)0);
+		GstBuffer *wrappedBuffer = gst_buffer_new_wrapped_full(flags, pBuffer->ptr, pBuffer->avail, 0, pBuffer->len, wrapped, ReleaseWrappedFragment);
+		SendHelper( mediaType, pBuffer->ptr, pBuffer->len, fpts, fdts, fDuration, false /*transfer*/, initFragment, wrappedBuffer);
+		gst_buffer_unref(wrappedBuffer);
+	}
+	else if( !SendHelper( mediaType, pBuffer->ptr, pBuffer->len, fpts, fdts, fDuration, false /*transfer*/, initFragment) )
 	{ // unable to transfer - free up the buffer we were passed.
 		aamp_Free(pBuffer);
 	}
@@ -74,8 +74,10 @@ private:
          * @param[in] duration duration of buffer (in sec)
          * @param[in] copy to map or transfer the buffer
          * @param[in] initFragment flag for buffer type (init, data)
+         * @param[in] wrappedBuffer buffer already wrapping ptr for zero copy transfer, NULL otherwise
+         * @return true if the buffer was pushed to gstreamer
          */
-	bool SendHelper(MediaType mediaType, const void *ptr, size_t len, double fpts, double fdts, double duration, bool copy, bool initFragment = 0);
+	bool SendHelper(MediaType mediaType, const void *ptr, size_t len, double fpts, double fdts, double duration, bool copy, bool initFragment = 0, GstBuffer *wrappedBuffer = NULL);
 
 	/**
 	 * @fn SendGstEvents
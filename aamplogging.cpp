@@ -25,6 +25,7 @@
 #include <iomanip>
 #include <algorithm>
 #include "priv_aamp.h"
+#include "AampAsyncLogger.h"
 using namespace std;
 
 #ifdef USE_SYSLOG_HELPER_PRINT
@@ -477,35 +478,28 @@ void logprintf(const char *format, ...)
 }
 
 /**
- * @brief Print logs to console / log file
+ * @brief Write formatted log lines to journal, syslog or console
  */
-void logprintf_new(int playerId,const char* levelstr,const char* file, int line,const char *format, ...)
+static void EmitLogLines(const AampLogLine *lines, int count)
 {
-	int len = 0;
-	va_list args;
-	va_start(args, format);
-
-	char gDebugPrintBuffer[MAX_DEBUG_LOG_BUFF_SIZE];
-	len = sprintf(gDebugPrintBuffer, "[AAMP-PLAYER][%d][%s][%s][%d]",playerId,levelstr,file,line);
-	vsnprintf(gDebugPrintBuffer+len, MAX_DEBUG_LOG_BUFF_SIZE-len, format, args);
-	gDebugPrintBuffer[(MAX_DEBUG_LOG_BUFF_SIZE-1)] = 0;
-
-	va_end(args);
-
 #if (defined (USE_SYSTEMD_JOURNAL_PRINT) || defined (USE_SYSLOG_HELPER_PRINT))
 	if(!AampLogManager::disableLogRedirection)
 	{
+		for (int i = 0; i < count; i++)
+		{
 #ifdef USE_SYSTEMD_JOURNAL_PRINT
-		sd_journal_print(LOG_NOTICE, "%s", gDebugPrintBuffer);
+			sd_journal_print(LOG_NOTICE, "%s", lines[i].text);
 #else
-		send_logs_to_syslog(gDebugPrintBuffer);
+			send_logs_to_syslog(lines[i].text);
 #endif
+		}
 	}
 	else
 	{
-		struct timeval t;
-		gettimeofday(&t, NULL);
-		printf("%ld:%3ld : %s\n", (long int)t.tv_sec, (long int)t.tv_usec / 1000, gDebugPrintBuffer);
+		for (int i = 0; i < count; i++)
+		{
+			printf("%ld:%3ld : %s\n", (long int)lines[i].time.tv_sec, (long int)lines[i].time.tv_usec / 1000, lines[i].text);
+		}
 	}
 #else	//USE_SYSTEMD_JOURNAL_PRINT
 #ifdef AAMP_SIMULATOR_BUILD
@@ -515,17 +509,81 @@ void logprintf_new(int playerId,const char* levelstr,const char* file, int line,
 	if (f)
 	{
 		init = true;
-		fputs(gDebugPrintBuffer, f);
+		for (int i = 0; i < count; i++)
+		{
+			fputs(lines[i].text, f);
+		}
 		fclose(f);
 	}
 
-	struct timeval t;
-	gettimeofday(&t, NULL);
-	printf("%ld:%3ld : %s\n", (long int)t.tv_sec, (long int)t.tv_usec / 1000, gDebugPrintBuffer);
+	for (int i = 0; i < count; i++)
+	{
+		printf("%ld:%3ld : %s\n", (long int)lines[i].time.tv_sec, (long int)lines[i].time.tv_usec / 1000, lines[i].text);
+	}
 #endif
 #endif
 }
 
+/**
+ * @brief Format log line with player, level, function and line prefix and write it
+ */
+static void vlogprintf_new(int playerId,const char* levelstr,const char* file, int line,const char *format, va_list args)
+{
+	int len = 0;
+	char gDebugPrintBuffer[MAX_DEBUG_LOG_BUFF_SIZE];
+	len = sprintf(gDebugPrintBuffer, AAMP_LOG_PREFIX_FORMAT,playerId,levelstr,file,line);
+	vsnprintf(gDebugPrintBuffer+len, MAX_DEBUG_LOG_BUFF_SIZE-len, format, args);
+	gDebugPrintBuffer[(MAX_DEBUG_LOG_BUFF_SIZE-1)] = 0;
+
+	AampLogLine logLine;
+	gettimeofday(&logLine.time, NULL);
+	logLine.text = gDebugPrintBuffer;
+	EmitLogLines(&logLine, 1);
+}
+
+/**
+ * @brief Print logs to console / log file
+ */
+void logprintf_new(int playerId,const char* levelstr,const char* file, int line,const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	vlogprintf_new(playerId, levelstr, file, line, format, args);
+	va_end(args);
+}
+
+/**
+ * @brief Print logs to console / log file, queued to the async logger while it runs
+ *
+ * Only literal formats are queued, they are formatted after this returns.
+ */
+void logprintf_async(bool literalFormat, int playerId,const char* levelstr,const char* file, int line,const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	if (!literalFormat || !AampAsyncLogger::IsRunning() ||
+		!AampAsyncLogger::GetInstance().Log(playerId, levelstr, file, line, format, args))
+	{
+		vlogprintf_new(playerId, levelstr, file, line, format, args);
+	}
+	va_end(args);
+}
+
+/**
+ * @brief Start or stop the async logger
+ */
+void AampLogManager::setAsyncLogging(bool enable)
+{
+	if (enable)
+	{
+		AampAsyncLogger::GetInstance().Start(AAMP_ASYNC_LOG_SLOTS, EmitLogLines);
+	}
+	else
+	{
+		AampAsyncLogger::GetInstance().Stop();
+	}
+}
+
 /**
  * @brief Compactly log blobs of binary data
  *
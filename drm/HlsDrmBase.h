@@ -114,6 +114,13 @@ public:
 	*
 	*/
 	virtual DRMState GetState() = 0;
+	/**
+	 * @brief Prepare decryption of the next segment while it downloads
+	 *
+	 * @param decryptor Per track decryptor to initialize with current key and IV
+	 * @retval true if key is available and decryptor was initialized
+	 */
+	virtual bool InitStreamDecryptor(class AesStreamDecryptor &decryptor) { return false; }
 	/**
 	 * @brief HlsDrmBase Destructor
 	 */
@@ -331,6 +331,21 @@ DrmReturn AesDec::Decrypt( ProfilerBucketType bucketType, void *encryptedDataPtr
 	return err;
 }
 
+/**
+ * @brief Hand key and IV of next segment to a per track decryptor
+ */
+bool AesDec::InitStreamDecryptor(AesStreamDecryptor &decryptor)
+{
+	bool ret = false;
+	pthread_mutex_lock(&mMutex);
+	// no wait here, a segment downloaded before the key arrives is decrypted by Decrypt
+	if ((mDrmState == eDRM_KEY_ACQUIRED) && (AES_128_KEY_LEN_BYTES == mAesKeyBuf.len))
+	{
+		ret = decryptor.Init((const unsigned char*)mAesKeyBuf.ptr, mDrmInfo.iv);
+	}
+	pthread_mutex_unlock(&mMutex);
+	return ret;
+}
 
 /**
  * @brief Release drm session
@@ -28,6 +28,7 @@
 #include <stddef.h> // for size_t
 #include "HlsDrmBase.h"
 #include "drm.h"
+#include "aamp_aes_stream.h"
 #include <openssl/evp.h>
 #include <memory>
 
@@ -81,6 +82,12 @@ public:
 	 * @param timeInMs wait time
 	 */
 	DrmReturn Decrypt(ProfilerBucketType bucketType, void *encryptedDataPtr, size_t encryptedDataLen, int timeInMs);
+	/**
+	 * @fn InitStreamDecryptor
+	 * @param decryptor per track decryptor, gets a copy of key and IV
+	 * @retval true if key was already acquired, false to fall back to Decrypt
+	 */
+	bool InitStreamDecryptor(AesStreamDecryptor &decryptor);
 	/**
 	 * @fn Release
 	 */
@@ -0,0 +1,167 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file aamp_aes_stream.cpp
+ * @brief In place AES-128 CBC decryption of a segment while it downloads
+ */
+
+#include "aamp_aes_stream.h"
+#include <string.h>
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+#define OPEN_SSL_CONTEXT mOpensslCtx
+#else
+#define OPEN_SSL_CONTEXT &mOpensslCtx
+#endif
+
+/**
+ * @brief AesStreamDecryptor Constructor
+ */
+AesStreamDecryptor::AesStreamDecryptor() : mOpensslCtx(), mKey(), mIv(), mDecryptedLen(0), mActive(false), mFailed(false)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	OPEN_SSL_CONTEXT = EVP_CIPHER_CTX_new();
+#else
+	EVP_CIPHER_CTX_init(OPEN_SSL_CONTEXT);
+#endif
+}
+
+/**
+ * @brief AesStreamDecryptor Destructor
+ */
+AesStreamDecryptor::~AesStreamDecryptor()
+{
+	// key material is not left behind in freed memory
+	memset(mKey, 0, sizeof(mKey));
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	EVP_CIPHER_CTX_free(OPEN_SSL_CONTEXT);
+#else
+	EVP_CIPHER_CTX_cleanup(OPEN_SSL_CONTEXT);
+#endif
+}
+
+/**
+ * @brief Start decryption of a new segment
+ */
+bool AesStreamDecryptor::Init(const unsigned char *key, const unsigned char *iv)
+{
+	mActive = false;
+	if (!key)
+	{
+		return false;
+	}
+	memcpy(mKey, key, AES_STREAM_BLOCK_SIZE);
+	if (iv)
+	{
+		memcpy(mIv, iv, AES_STREAM_BLOCK_SIZE);
+	}
+	else
+	{
+		memset(mIv, 0, AES_STREAM_BLOCK_SIZE);
+	}
+	mActive = StartCipher();
+	return mActive;
+}
+
+/**
+ * @brief Reinitialize cipher context with stored key and IV
+ */
+bool AesStreamDecryptor::StartCipher()
+{
+	mDecryptedLen = 0;
+	mFailed = true;
+	if (EVP_DecryptInit_ex(OPEN_SSL_CONTEXT, EVP_aes_128_cbc(), NULL, mKey, mIv))
+	{
+		// padding is handled by Finish, so output always lands on the input bytes
+		EVP_CIPHER_CTX_set_padding(OPEN_SSL_CONTEXT, 0);
+		mFailed = false;
+	}
+	return !mFailed;
+}
+
+/**
+ * @brief Segment download starts over
+ */
+void AesStreamDecryptor::Restart()
+{
+	if (mActive && mDecryptedLen)
+	{
+		StartCipher();
+	}
+}
+
+/**
+ * @brief Decrypt complete blocks received since previous call
+ */
+bool AesStreamDecryptor::Update(unsigned char *data, size_t len)
+{
+	if (!mActive || mFailed)
+	{
+		return !mFailed;
+	}
+	if (len < mDecryptedLen)
+	{
+		// buffer was refilled without Restart, decrypted prefix is lost
+		mFailed = true;
+		return false;
+	}
+	size_t blocksLen = (len - mDecryptedLen) & ~(size_t)(AES_STREAM_BLOCK_SIZE - 1);
+	while (blocksLen)
+	{
+		// EVP lengths are int
+		int chunkLen = (blocksLen > (1u << 30)) ? (1 << 30) : (int)blocksLen;
+		int outLen = 0;
+		unsigned char *blocks = data + mDecryptedLen;
+		if (!EVP_DecryptUpdate(OPEN_SSL_CONTEXT, blocks, &outLen, blocks, chunkLen) || outLen != chunkLen)
+		{
+			mFailed = true;
+			return false;
+		}
+		mDecryptedLen += chunkLen;
+		blocksLen -= chunkLen;
+	}
+	return true;
+}
+
+/**
+ * @brief Decrypt remaining blocks and check padding of complete segment
+ */
+bool AesStreamDecryptor::Finish(unsigned char *data, size_t len)
+{
+	bool ret = false;
+	if (mActive && Update(data, len) && len && mDecryptedLen == len)
+	{
+		unsigned char padding = data[len - 1];
+		if (padding >= 1 && padding <= AES_STREAM_BLOCK_SIZE)
+		{
+			ret = true;
+			for (size_t i = len - padding; i < len; i++)
+			{
+				ret = ret && (data[i] == padding);
+			}
+			if (ret)
+			{
+				memset(data + len - padding, 0, padding);
+			}
+		}
+	}
+	mActive = false;
+	return ret;
+}
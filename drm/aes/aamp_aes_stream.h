@@ -0,0 +1,131 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef _AAMP_AES_STREAM_H_
+#define _AAMP_AES_STREAM_H_
+
+/**
+ * @file aamp_aes_stream.h
+ * @brief In place AES-128 CBC decryption of a segment while it downloads
+ */
+
+#include <stddef.h>
+#include <openssl/evp.h>
+
+#define AES_STREAM_BLOCK_SIZE 16	/**< AES block size, also the AES-128 key and IV size */
+
+/**
+ * @class AesStreamDecryptor
+ * @brief Per track AES-128 CBC decryptor fed with a growing download buffer
+ *
+ * Each call decrypts the complete 16 byte blocks received since the previous call in
+ * place, a trailing partial block waits for the next call. PKCS7 padding is checked by
+ * Finish, which clears the padding bytes as AesDec::Decrypt does. The key and IV are
+ * copied by Init, so decryption needs no lock shared with other tracks.
+ */
+class AesStreamDecryptor
+{
+public:
+	/**
+	 * @fn AesStreamDecryptor
+	 */
+	AesStreamDecryptor();
+
+	/**
+	 * @fn ~AesStreamDecryptor
+	 */
+	~AesStreamDecryptor();
+
+	AesStreamDecryptor(const AesStreamDecryptor&) = delete;
+	AesStreamDecryptor& operator=(const AesStreamDecryptor&) = delete;
+
+	/**
+	 * @fn Init
+	 * @brief Start decryption of a new segment
+	 * @param[in] key - AES-128 key
+	 * @param[in] iv - initialization vector, NULL for all zero
+	 * @retval true on success
+	 */
+	bool Init(const unsigned char *key, const unsigned char *iv);
+
+	/**
+	 * @fn Restart
+	 * @brief Segment download starts over, buffer will be refilled from offset 0
+	 * @return void
+	 */
+	void Restart();
+
+	/**
+	 * @fn Update
+	 * @brief Decrypt complete blocks received since previous call
+	 * @param[in,out] data - start of segment buffer, may move between calls
+	 * @param[in] len - bytes received so far
+	 * @retval false if decryption failed, the segment has to be dropped
+	 */
+	bool Update(unsigned char *data, size_t len);
+
+	/**
+	 * @fn Finish
+	 * @brief Decrypt remaining blocks and check padding of complete segment. Deactivates decryptor
+	 * @param[in,out] data - start of segment buffer
+	 * @param[in] len - segment length
+	 * @retval true if whole segment was decrypted
+	 */
+	bool Finish(unsigned char *data, size_t len);
+
+	/**
+	 * @fn Deactivate
+	 * @brief Stop decrypting without finishing the segment
+	 * @return void
+	 */
+	void Deactivate() { mActive = false; }
+
+	/**
+	 * @fn IsActive
+	 * @retval true between Init and Finish or Deactivate
+	 */
+	bool IsActive() const { return mActive; }
+
+	/**
+	 * @fn GetDecryptedLength
+	 * @retval bytes of the current attempt already decrypted
+	 */
+	size_t GetDecryptedLength() const { return mDecryptedLen; }
+
+private:
+	/**
+	 * @fn StartCipher
+	 * @brief Reinitialize cipher context with stored key and IV
+	 * @retval true on success
+	 */
+	bool StartCipher();
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	EVP_CIPHER_CTX *mOpensslCtx;
+#else
+	EVP_CIPHER_CTX mOpensslCtx;
+#endif
+	unsigned char mKey[AES_STREAM_BLOCK_SIZE];	/**< Key of current segment */
+	unsigned char mIv[AES_STREAM_BLOCK_SIZE];	/**< IV of current segment */
+	size_t mDecryptedLen;				/**< Decrypted prefix of current attempt */
+	bool mActive;					/**< Segment decryption in progress */
+	bool mFailed;					/**< Cipher error in current attempt */
+};
+
+#endif // _AAMP_AES_STREAM_H_
@@ -63,6 +63,7 @@
 #include "tsprocessor.h"
 #include "isobmffprocessor.h"
 #include "AampUtils.h"
+#include "AampTraceRecorder.h"
 
 #ifdef AAMP_HLS_DRM
 #include "AampDRMSessionManager.h"
@@ -575,6 +576,24 @@ static char *mystrpbrk(char *ptr)
 	return next;
 }
 
+/***************************************************************************
+* @fn TerminateLine
+* @brief Function to NUL terminate a line found by the tag lexer
+*
+* @param buffer[in] playlist holding the line
+* @param line[in] line to terminate
+* @return char * - start of line
+***************************************************************************/
+static char *TerminateLine(GrowableBuffer &buffer, const HlsPlaylistLine &line)
+{ // the terminator replaces the CR or LF following the line; the last line already ends at the appended NUL
+	char *ptr = buffer.ptr + line.offset;
+	if ((line.offset + line.length) < buffer.len)
+	{
+		ptr[line.length] = 0x00;
+	}
+	return ptr;
+}
+
 /**
 * @param attrName pointer to HLS Attribute List, as a NUL-terminated CString
 */
@@ -749,7 +768,6 @@ AAMPStatusType StreamAbstractionAAMP_HLS::ParseMainManifest()
 {
 	int vProfileCount, iFrameCount , lineNum;
 	AAMPStatusType retval = eAAMPSTATUS_OK;
-	char* ptr = mainManifest.ptr;
 	mMediaCount = 0;
 	mProfileCount = 0;
 	vProfileCount = iFrameCount = lineNum = 0;
@@ -759,22 +777,27 @@ AAMPStatusType StreamAbstractionAAMP_HLS::ParseMainManifest()
 	//clear previouse data
 	setCustomLicensePayLoad(NULL);
 #endif
-	while (ptr)
+	// one pass over the manifest, tags are classified by the lexer instead of comparing each known tag
+	static const AampHlsTagLexer tagLexer;
+	std::vector<HlsPlaylistLine> lines;
+	tagLexer.Tokenize(mainManifest.ptr, mainManifest.len, lines);
+	for (size_t lineIdx = 0; lineIdx < lines.size() && retval == eAAMPSTATUS_OK; lineIdx++)
 	{
-		char *next = mystrpbrk(ptr);
-		if (*ptr)
+		const HlsPlaylistLine &line = lines[lineIdx];
+		char *ptr = TerminateLine(mainManifest, line);
+		if (line.tag != eHLS_TAG_NONE)
 		{
-			if (startswith(&ptr, "#EXT"))
+			ptr += line.valueOffset;
+			switch (line.tag)
 			{
-				if (startswith(&ptr, "-X-I-FRAME-STREAM-INF:"))
+				case eHLS_TAG_I_FRAME_STREAM_INF:
 				{
 					HlsStreamInfo *streamInfo = &this->streamInfo[mProfileCount];
 					memset(streamInfo, 0, sizeof(*streamInfo));
 					ParseAttrList(ptr, ParseStreamInfCallback, this);
-					if (streamInfo->uri == NULL)
+					if (streamInfo->uri == NULL && (lineIdx + 1) < lines.size())
 					{ // uri on following line
-						streamInfo->uri = next;
-						next = mystrpbrk(next);
+						streamInfo->uri = TerminateLine(mainManifest, lines[++lineIdx]);
 					}
 
 					if(streamInfo->averageBandwidth !=0 && useavgbw)
@@ -787,16 +810,16 @@ AAMPStatusType StreamAbstractionAAMP_HLS::ParseMainManifest()
 					iFrameCount++;
 					mProfileCount++;
 					mIframeAvailable = true;
+					break;
 				}
-				else if (startswith(&ptr, "-X-IMAGE-STREAM-INF:"))
+				case eHLS_TAG_IMAGE_STREAM_INF:
 				{
 					HlsStreamInfo *streamInfo = &this->streamInfo[mProfileCount];
 					memset(streamInfo, 0, sizeof(*streamInfo));
 					ParseAttrList(ptr, ParseStreamInfCallback, this);
-					if (streamInfo->uri == NULL)
+					if (streamInfo->uri == NULL && (lineIdx + 1) < lines.size())
 					{ // uri on following line
-						streamInfo->uri = next;
-						next = mystrpbrk(next);
+						streamInfo->uri = TerminateLine(mainManifest, lines[++lineIdx]);
 					}
 
 					if(streamInfo->averageBandwidth !=0 && useavgbw)
@@ -807,16 +830,16 @@ AAMPStatusType StreamAbstractionAAMP_HLS::ParseMainManifest()
 					streamInfo->isIframeTrack = true;
 					streamInfo->enabled = false;
 					mProfileCount++;
+					break;
 				}
-				else if (startswith(&ptr, "-X-STREAM-INF:"))
+				case eHLS_TAG_STREAM_INF:
 				{
 					struct HlsStreamInfo *streamInfo = &this->streamInfo[mProfileCount];
 					setupStreamInfo(streamInfo, mProfileCount);
 					ParseAttrList(ptr, ParseStreamInfCallback, this);
-					if (streamInfo->uri == NULL)
+					if (streamInfo->uri == NULL && (lineIdx + 1) < lines.size())
 					{ // uri on following line
-						streamInfo->uri = next;
-						next = mystrpbrk(next);
+						streamInfo->uri = TerminateLine(mainManifest, lines[++lineIdx]);
 					}
 					if(streamInfo->averageBandwidth!=0 && useavgbw)
 					{
@@ -834,8 +857,9 @@ AAMPStatusType StreamAbstractionAAMP_HLS::ParseMainManifest()
 					streamInfo->enabled = false;
 					mProfileCount++;
 					vProfileCount++;
+					break;
 				}
-				else if (startswith(&ptr, "-X-MEDIA:"))
+				case eHLS_TAG_MEDIA:
 				{
 					memset(&this->mediaInfo[mMediaCount], 0, sizeof(MediaInfo));
 					ParseAttrList(ptr, ParseMediaAttributeCallback, this);
@@ -848,31 +872,35 @@ AAMPStatusType StreamAbstractionAAMP_HLS::ParseMainManifest()
 						mLangList.insert(GetLanguageCode(mMediaCount));
 					}
 					mMediaCount++;
+					break;
 				}
-				else if (startswith(&ptr, "-X-VERSION:"))
+				case eHLS_TAG_VERSION:
 				{
 					// followed by integer
+					break;
 				}
-				else if (startswith(&ptr, "-X-INDEPENDENT-SEGMENTS"))
+				case eHLS_TAG_INDEPENDENT_SEGMENTS:
 				{
 					// followed by integer
+					break;
 				}
-				else if (startswith(&ptr, "-X-FAXS-CM"))
+				case eHLS_TAG_FAXS_CM:
 				{ // not needed - present in playlist
 					hasDrm = true;
 					AveDrmManager::ApplySessionToken();
+					break;
 				}
-				else if (startswith(&ptr, "M3U"))
+				case eHLS_TAG_EXTM3U:
 				{
 					// Spec :: 4.3.1.1.  EXTM3U - It MUST be the first line of every Media Playlist and every Master Playlist
 					if(lineNum)
 					{
 						AAMPLOG_WARN("M3U tag not the first line[%d] of Manifest",lineNum);
 						retval = eAAMPSTATUS_MANIFEST_CONTENT_ERROR;
-						break;
 					}
+					break;
 				}
-				else if (startswith(&ptr, "-X-CONTENT-IDENTIFIER:"))
+				case eHLS_TAG_CONTENT_IDENTIFIER:
 				{
 #ifdef AVE_DRM
 					std::string vssServiceZone = aamp->GetServiceZone();
@@ -901,23 +929,29 @@ AAMPStatusType StreamAbstractionAAMP_HLS::ParseMainManifest()
 						}
 					}
 #endif
+					break;
 				}
-				else if (startswith(&ptr, "-X-FOG"))
+				case eHLS_TAG_FOG:
 				{
+					break;
 				}
-				else if (startswith(&ptr, "-X-XCAL-CONTENTMETADATA"))
+				case eHLS_TAG_XCAL_CONTENTMETADATA:
 				{ // placeholder for new Super8 DRM Agnostic Metadata
+					break;
 				}
-				else if (startswith(&ptr, "-NOM-I-FRAME-DISTANCE"))
+				case eHLS_TAG_NOM_I_FRAME_DISTANCE:
 				{ // placeholder for nominal distance between IFrames
+					break;
 				}
-				else if (startswith(&ptr, "-X-ADVERTISING"))
+				case eHLS_TAG_ADVERTISING:
 				{ // placeholder for advertising zone for linear (soon to be deprecated)
+					break;
 				}
-				else if (startswith(&ptr, "-UPLYNK-LIVE"))
+				case eHLS_TAG_UPLYNK_LIVE:
 				{ // related to uplynk streaming service
+					break;
 				}
-				else if (startswith(&ptr, "-X-START:"))
+				case eHLS_TAG_START:
 				{ // i.e. "TIME-OFFSET=2.336, PRECISE=YES" - specifies the preferred point in the video to start playback; not yet supported
 
 					// check if App has not configured any liveoffset
@@ -937,8 +971,9 @@ AAMPStatusType StreamAbstractionAAMP_HLS::ParseMainManifest()
 							AAMPLOG_WARN("WARNING:found EXT-X-START in MainManifest Offset:%f  liveOffset:%f",offsetval,aamp->mLiveOffset);
 						}
 					}
+					break;
 				}
-				else if (startswith(&ptr, "INF:"))
+				case eHLS_TAG_EXTINF:
 				{
 					// its not a main manifest, instead its playlist given for playback . Consider not a error
 					// Report it , so that Init flow can be changed accordingly
@@ -946,7 +981,7 @@ AAMPStatusType StreamAbstractionAAMP_HLS::ParseMainManifest()
 					break;
 				}
 #ifdef AAMP_HLS_DRM
-				else if (startswith(&ptr, "-X-SESSION-KEY:"))
+				case eHLS_TAG_SESSION_KEY:
 				{
 						if (ISCONFIGSET(eAAMPConfig_Fragmp4PrefetchLicense))
 						{
@@ -966,18 +1001,19 @@ AAMPStatusType StreamAbstractionAAMP_HLS::ParseMainManifest()
 							aamp->fragmentCdmEncrypted = true;
 							InitiateDrmProcess(this->aamp);
 						}
+					break;
 				}
 #endif
-				else
+				default:
 				{
-					std::string unknowTag= ptr;
+					std::string unknowTag(mainManifest.ptr + line.offset, line.length);
 					AAMPLOG_INFO("***unknown tag:%s", unknowTag.substr(0,24).c_str());
+					break;
 				}
-				lineNum++;
 			}
+			lineNum++;
 		}
-		ptr = next;
-	}// while till end of file
+	}// for till end of file
 
 	if(retval == eAAMPSTATUS_OK)
 	{
@@ -1220,7 +1256,6 @@ char *TrackState::GetFragmentUriFromIndex(bool &bSegmentRepeated)
  */
 char *TrackState::GetNextFragmentUriFromPlaylist(bool ignoreDiscontinuity)
 {
-	char *ptr = fragmentURI;
 	char *rc = NULL;
 	size_t byteRangeLength = 0; // default, when optional byterange offset is left unspecified
 	size_t byteRangeOffset = 0;
@@ -1240,10 +1275,15 @@ char *TrackState::GetNextFragmentUriFromPlaylist(bool ignoreDiscontinuity)
 		//AAMPLOG_WARN("[PLAYLIST_POSITION==PLAY_TARGET]");
 		return fragmentURI;
 	}
+	if (mTokenizedPlaylist != playlist.ptr)
+	{
+		TokenizePlaylist();
+	}
+	size_t lineIdx = FindPlaylistLine(fragmentURI);
 	if ((playlistPosition != -1) && (fragmentURI != NULL))
 	{ // already presenting - skip past previous segment
 		//AAMPLOG_WARN("[PLAYLIST_POSITION!= -1]");
-		ptr += strlen(fragmentURI) + 1;
+		lineIdx++;
 	}
 	if ((playlistPosition > playTarget) && (fragmentDurationSeconds > PLAYLIST_TIME_DIFF_THRESHOLD_SECONDS) &&
 		((playlistPosition - playTarget) > fragmentDurationSeconds))
@@ -1256,208 +1296,171 @@ char *TrackState::GetNextFragmentUriFromPlaylist(bool ignoreDiscontinuity)
 		// Starts parsing from beginning, so change to default
 		fragmentEncrypted = false;
 	}
-	//AAMPLOG_WARN("before loop, ptr = %p fragmentURI %p", ptr, fragmentURI);
-	while (ptr)
+	//AAMPLOG_WARN("before loop, line %zu fragmentURI %p", lineIdx, fragmentURI);
+	while (lineIdx < mPlaylistLines.size())
 	{
-		char *next = mystrpbrk(ptr);
-		//AAMPLOG_WARN("ptr %s next %.*s", ptr, 10, next);
+		const HlsPlaylistLine &line = mPlaylistLines[lineIdx++];
+		char *ptr = TerminatePlaylistLine(line);
 		if (*ptr)
 		{
-			if (startswith(&ptr, "#EXT"))
+			if (line.tag != eHLS_TAG_NONE)
 			{ // tags begins with #EXT
-				if (startswith(&ptr, "M3U"))
-				{ // "Extended M3U file" - always first line
-				}
-				else if (startswith(&ptr, "INF:"))
-				{// preceeds each advertised fragment in a playlist
-					if (-1 != playlistPosition)
-					{
-						playlistPosition += fragmentDurationSeconds;
-					}
-					else
-					{
-						playlistPosition = 0;
-					}
-					fragmentDurationSeconds = atof(ptr);
+				ptr += line.valueOffset;
+				switch (line.tag)
+				{
+					case eHLS_TAG_EXTINF:
+					{// preceeds each advertised fragment in a playlist
+						if (-1 != playlistPosition)
+						{
+							playlistPosition += fragmentDurationSeconds;
+						}
+						else
+						{
+							playlistPosition = 0;
+						}
+						fragmentDurationSeconds = atof(ptr);
 #ifdef TRACE
-					AAMPLOG_WARN("Next - EXTINF - playlistPosition updated to %f", playlistPosition);
-					// optionally followed by human-readable title
+						AAMPLOG_WARN("Next - EXTINF - playlistPosition updated to %f", playlistPosition);
+						// optionally followed by human-readable title
 #endif
-				}
-				else if (startswith(&ptr, "-X-BYTERANGE:"))
-				{
-					char  temp[1024];
-					strncpy(temp, ptr, 1023);
-					temp[1023] = 0x00;
-					char * offsetDelim = strchr(temp, '@'); // optional
-					if (offsetDelim)
-					{
-						*offsetDelim++ = 0x00;
-						sscanf(offsetDelim, "%zu", &byteRangeOffset);
+						break;
 					}
-					sscanf(temp, "%zu", &byteRangeLength);
-
-					mByteOffsetCalculation = true;
-					if (0 != byteRangeLength && 0 == byteRangeOffset)
+					case eHLS_TAG_BYTERANGE:
 					{
-						byteRangeOffset = this->byteRangeOffset + this->byteRangeLength;
+						char  temp[1024];
+						strncpy(temp, ptr, 1023);
+						temp[1023] = 0x00;
+						char * offsetDelim = strchr(temp, '@'); // optional
+						if (offsetDelim)
+						{
+							*offsetDelim++ = 0x00;
+							sscanf(offsetDelim, "%zu", &byteRangeOffset);
+						}
+						sscanf(temp, "%zu", &byteRangeLength);
+
+						mByteOffsetCalculation = true;
+						if (0 != byteRangeLength && 0 == byteRangeOffset)
+						{
+							byteRangeOffset = this->byteRangeOffset + this->byteRangeLength;
+						}
+						AAMPLOG_TRACE("byteRangeOffset:%zu Last played fragment Offset:%zu byteRangeLength:%zu Last fragment Length:%zu", byteRangeOffset, this->byteRangeOffset, byteRangeLength, this->byteRangeLength);
+						break;
 					}
-					AAMPLOG_TRACE("byteRangeOffset:%zu Last played fragment Offset:%zu byteRangeLength:%zu Last fragment Length:%zu", byteRangeOffset, this->byteRangeOffset, byteRangeLength, this->byteRangeLength);
-				}
-				else if (startswith(&ptr, "-X-TARGETDURATION:"))
-				{ // max media segment duration; required; appears once
-					targetDurationSeconds = atof(ptr);
-				}
-				else if (startswith(&ptr, "-X-MEDIA-SEQUENCE:"))
-				{// first media URI's unique integer sequence number
-					nextMediaSequenceNumber = atoll(ptr);
-				}
-				else if (startswith(&ptr, "-X-KEY:"))
-				{ // identifies licensing server to contact for authentication
-					ParseAttrList(ptr, ParseKeyAttributeCallback, this);
-				}
-				else if(startswith(&ptr,"-X-MAP:"))
-				{
-					AAMPLOG_TRACE("Old-Init : %s, New-Init:%s", mInitFragmentInfo, ptr);
-					if ((!mInitFragmentInfo) || (mInitFragmentInfo && ptr && strcmp(mInitFragmentInfo, ptr) != 0))
-					{
-						mInitFragmentInfo = ptr;
-						mInjectInitFragment = true;
-						AAMPLOG_INFO("Found #EXT-X-MAP data: %s", mInitFragmentInfo);
+					case eHLS_TAG_TARGETDURATION:
+					{ // max media segment duration; required; appears once
+						targetDurationSeconds = atof(ptr);
+						break;
 					}
-				}
-				else if (startswith(&ptr, "-X-PROGRAM-DATE-TIME:"))
-				{ // associates following media URI with absolute date/time
-					// if used, should supplement any EXT-X-DISCONTINUITY tags
-					AAMPLOG_TRACE("Got EXT-X-PROGRAM-DATE-TIME: %s ", ptr);
-					if (context->mNumberOfTracks > 1)
+					case eHLS_TAG_MEDIA_SEQUENCE:
+					{// first media URI's unique integer sequence number
+						nextMediaSequenceNumber = atoll(ptr);
+						break;
+					}
+					case eHLS_TAG_KEY:
+					{ // identifies licensing server to contact for authentication
+						ParseAttrList(ptr, ParseKeyAttributeCallback, this);
+						break;
+					}
+					case eHLS_TAG_MAP:
 					{
-						programDateTime = ptr;
-						// The first X-PROGRAM-DATE-TIME tag holds the start time for each track
-						if (startTimeForPlaylistSync == 0.0 )
+						AAMPLOG_TRACE("Old-Init : %s, New-Init:%s", mInitFragmentInfo, ptr);
+						if ((!mInitFragmentInfo) || (mInitFragmentInfo && ptr && strcmp(mInitFragmentInfo, ptr) != 0))
+						{
+							mInitFragmentInfo = ptr;
+							mInjectInitFragment = true;
+							AAMPLOG_INFO("Found #EXT-X-MAP data: %s", mInitFragmentInfo);
+						}
+						break;
+					}
+					case eHLS_TAG_PROGRAM_DATE_TIME:
+					{ // associates following media URI with absolute date/time
+						// if used, should supplement any EXT-X-DISCONTINUITY tags
+						AAMPLOG_TRACE("Got EXT-X-PROGRAM-DATE-TIME: %s ", ptr);
+						if (context->mNumberOfTracks > 1)
 						{
-							/* discarding timezone assuming audio and video tracks has same timezone and we use this time only for synchronization*/
-							startTimeForPlaylistSync = ISO8601DateTimeToUTCSeconds(ptr);
-							AAMPLOG_WARN("%s StartTimeForPlaylistSync : %f ",name, startTimeForPlaylistSync);							
+							programDateTime = ptr;
+							// The first X-PROGRAM-DATE-TIME tag holds the start time for each track
+							if (startTimeForPlaylistSync == 0.0 )
+							{
+								/* discarding timezone assuming audio and video tracks has same timezone and we use this time only for synchronization*/
+								startTimeForPlaylistSync = ISO8601DateTimeToUTCSeconds(ptr);
+								AAMPLOG_WARN("%s StartTimeForPlaylistSync : %f ",name, startTimeForPlaylistSync);							
+							}
 						}
+						break;
 					}
-				}
-				else if (startswith(&ptr, "-X-ALLOW-CACHE:"))
-				{ // YES or NO - authorizes client to cache segments for later replay
-					if (startswith(&ptr, "YES"))
+					case eHLS_TAG_ALLOW_CACHE:
+					{ // YES or NO - authorizes client to cache segments for later replay
+						if (startswith(&ptr, "YES"))
+						{
+							context->allowsCache = true;
+						}
+						else if (startswith(&ptr, "NO"))
+						{
+							context->allowsCache = false;
+						}
+						else
+						{
+							AAMPLOG_ERR("unknown ALLOW-CACHE setting");
+						}
+						break;
+					}
+					case eHLS_TAG_ENDLIST:
+					{ // indicates that no more media segments are available
+						AAMPLOG_WARN("#EXT-X-ENDLIST");
+						mReachedEndListTag = true;
+						break;
+					}
+					case eHLS_TAG_DISCONTINUITY:
 					{
-						context->allowsCache = true;
+						discontinuity = true;
+						break;
 					}
-					else if (startswith(&ptr, "NO"))
+					case eHLS_TAG_I_FRAMES_ONLY:
 					{
-						context->allowsCache = false;
+						AAMPLOG_WARN("#EXT-X-I-FRAMES-ONLY");
+						break;
 					}
-					else
+					case eHLS_TAG_EXTM3U: // "Extended M3U file" - always first line
+					case eHLS_TAG_PLAYLIST_TYPE: //PlaylistType is handled during indexing.
+					case eHLS_TAG_DISCONTINUITY_SEQUENCE: // ignore this tag for now
+					case eHLS_TAG_VERSION: //CID:101256 - set not used
+					case eHLS_TAG_FAXS_CM: //DRM meta data is stored during indexing.
+					case eHLS_TAG_FAXS_PACKAGINGCERT:
+					case eHLS_TAG_FAXS_SIGNATURE:
+					case eHLS_TAG_CUE:
+					case eHLS_TAG_CM_SEQUENCE:
+					case eHLS_TAG_MARKER:
+					case eHLS_TAG_MEDIA_TIME:
+					case eHLS_TAG_END_TOP_TAGS:
+					case eHLS_TAG_CONTENT_IDENTIFIER:
+					case eHLS_TAG_TRICKMODE_RESTRICTION:
+					case eHLS_TAG_INDEPENDENT_SEGMENTS:
+					case eHLS_TAG_BITRATE:
+					case eHLS_TAG_FOG:
+					case eHLS_TAG_UPLYNK_LIVE: //tag related to uplynk streaming service
+					case eHLS_TAG_START:
+					case eHLS_TAG_XCAL_CONTENTMETADATA: // placeholder for new Super8 DRM Agnostic Metadata
+					case eHLS_TAG_NOM_I_FRAME_DISTANCE: // placeholder for nominal distance between IFrames
+					case eHLS_TAG_ADVERTISING: // placeholder for advertising zone for linear (soon to be deprecated)
+					case eHLS_TAG_SOURCE_STREAM: // placeholder for vss source stream id
+					case eHLS_TAG_X1_LIN_CK: // placeholder for deferred drm information
+					case eHLS_TAG_SCTE35: // placeholder for DAI tag processing
+					case eHLS_TAG_ASSET:
+					case eHLS_TAG_CUE_OUT:
+					case eHLS_TAG_CUE_OUT_CONT:
+					case eHLS_TAG_CUE_IN:
+					case eHLS_TAG_DATERANGE:
+					case eHLS_TAG_SPLICEPOINT_SCTE35: // placeholder for HLS ad markers used by MediaTailor
+						// tags not needed for fragment selection
+						break;
+					default:
 					{
-						AAMPLOG_ERR("unknown ALLOW-CACHE setting");
+						std::string unknowTag(playlist.ptr + line.offset, line.length);
+						AAMPLOG_INFO("***unknown tag:%s", unknowTag.substr(0,24).c_str());	
+						break;
 					}
 				}
-				else if (startswith(&ptr, "-X-PLAYLIST-TYPE:"))
-				{
-					//PlaylistType is handled during indexing.
-				}
-				else if (startswith(&ptr, "-X-ENDLIST"))
-				{ // indicates that no more media segments are available
-					AAMPLOG_WARN("#EXT-X-ENDLIST");
-					mReachedEndListTag = true;
-				}
-				else if (startswith(&ptr, "-X-DISCONTINUITY-SEQUENCE"))
-				{
-					// ignore this tag for now 
-				}
-				else if (startswith(&ptr, "-X-DISCONTINUITY"))
-				{
-					discontinuity = true;
-				}
-				else if (startswith(&ptr, "-X-I-FRAMES-ONLY"))
-				{
-					AAMPLOG_WARN("#EXT-X-I-FRAMES-ONLY");
-				}
-				else if (startswith(&ptr, "-X-VERSION:"))
-				{	//CID:101256 - set not used
-				}
-				// custom tags follow:
-				else if (startswith(&ptr, "-X-FAXS-CM:"))
-				{
-					//DRM meta data is stored during indexing.
-				}
-				else if (startswith(&ptr, "-X-FAXS-PACKAGINGCERT"))
-				{
-				}
-				else if (startswith(&ptr, "-X-FAXS-SIGNATURE"))
-				{
-				}
-				else if (startswith(&ptr, "-X-CUE"))
-				{
-				}
-				else if (startswith(&ptr, "-X-CM-SEQUENCE"))
-				{
-				}
-				else if (startswith(&ptr, "-X-MARKER"))
-				{
-				}
-				else if (startswith(&ptr, "-X-MAP"))
-				{
-				}
-				else if (startswith(&ptr, "-X-MEDIA-TIME"))
-				{
-				}
-				else if (startswith(&ptr, "-X-END-TOP-TAGS"))
-				{
-				}
-				else if (startswith(&ptr, "-X-CONTENT-IDENTIFIER"))
-				{
-				}
-				else if (startswith(&ptr, "-X-TRICKMODE-RESTRICTION"))
-				{
-				}
-				else if (startswith(&ptr, "-X-INDEPENDENT-SEGMENTS"))
-				{
-				}
-				else if (startswith(&ptr, "-X-BITRATE"))
-				{
-				}
-				else if (startswith(&ptr, "-X-FOG"))
-				{
-				}
-				else if (startswith(&ptr,"-UPLYNK-LIVE"))
-				{//tag related to uplynk streaming service
-				}
-				else if (startswith(&ptr, "-X-START:"))
-				{
-				}
-				else if (startswith(&ptr, "-X-XCAL-CONTENTMETADATA"))
-				{ // placeholder for new Super8 DRM Agnostic Metadata
-				}
-				else if (startswith(&ptr, "-NOM-I-FRAME-DISTANCE"))
-				{ // placeholder for nominal distance between IFrames
-				}
-				else if (startswith(&ptr, "-X-ADVERTISING"))
-				{ // placeholder for advertising zone for linear (soon to be deprecated)
-				}
-				else if (startswith(&ptr, "-X-SOURCE-STREAM"))
-				{ // placeholder for vss source stream id
-				}
-				else if (startswith(&ptr, "-X-X1-LIN-CK"))
-				{ // placeholder for deferred drm information
-				}
-				else if (startswith(&ptr, "-X-SCTE35"))
-				{ // placeholder for DAI tag processing
-				}
-				else if (startswith(&ptr, "-X-ASSET") || startswith(&ptr, "-X-CUE-OUT") || startswith(&ptr, "-X-CUE-IN") ||
-						startswith(&ptr, "-X-DATERANGE") || startswith(&ptr, "-X-SPLICEPOINT-SCTE35"))
-				{ // placeholder for HLS ad markers used by MediaTailor
-				}
-				else
-				{
-					std::string unknowTag= ptr;
-					AAMPLOG_INFO("***unknown tag:%s", unknowTag.substr(0,24).c_str());	
-				}
 			}
 			else if (*ptr == '#')
 			{ // all other lines beginning with # are comments
@@ -1533,7 +1536,6 @@ char *TrackState::GetNextFragmentUriFromPlaylist(bool ignoreDiscontinuity)
 											playTarget = playlistPosition + diff;
 											discontinuity = false;
 											programDateTime = NULL;
-											ptr = next;
 											continue;
 										}
 									}
@@ -1572,8 +1574,6 @@ char *TrackState::GetNextFragmentUriFromPlaylist(bool ignoreDiscontinuity)
 				}
 			}
 		}
-		ptr = next;
-
 	}
 	//As a part of RDK-37711 to fetch the url of next next fragment
 	if(rc && ISCONFIGSET(eAAMPConfig_EnableCMCD))
@@ -1606,32 +1606,36 @@ char *TrackState::GetNextFragmentUriFromPlaylist(bool ignoreDiscontinuity)
  */
 char *TrackState::FindMediaForSequenceNumber()
 {
-	char *ptr = playlist.ptr;
 	long long mediaSequenceNumber = nextMediaSequenceNumber - 1;
 	char *key = NULL;
 	char *initFragment = NULL;
 
+	if (mTokenizedPlaylist != playlist.ptr)
+	{
+		TokenizePlaylist();
+	}
 	long long seq = 0;
-	while (ptr)
+	for (size_t lineIdx = 0; lineIdx < mPlaylistLines.size(); lineIdx++)
 	{
-		char *next = mystrpbrk(ptr);
+		const HlsPlaylistLine &line = mPlaylistLines[lineIdx];
+		char *ptr = TerminatePlaylistLine(line);
 		if (*ptr)
 		{
-			if (startswith(&ptr, "#EXTINF:"))
+			if (line.tag == eHLS_TAG_EXTINF)
 			{
-				fragmentDurationSeconds = atof(ptr);
+				fragmentDurationSeconds = atof(ptr + line.valueOffset);
 			}
-			else if (startswith(&ptr, "#EXT-X-MEDIA-SEQUENCE:"))
+			else if (line.tag == eHLS_TAG_MEDIA_SEQUENCE)
 			{
-				seq = atoll(ptr);
+				seq = atoll(ptr + line.valueOffset);
 			}
-			else if (startswith(&ptr, "#EXT-X-KEY:"))
+			else if (line.tag == eHLS_TAG_KEY)
 			{
-				key = ptr;
+				key = ptr + line.valueOffset;
 			}
-			else if (startswith(&ptr, "#EXT-X-MAP:"))
+			else if (line.tag == eHLS_TAG_MAP)
 			{
-				initFragment = ptr;
+				initFragment = ptr + line.valueOffset;
 			}
 			else if (ptr[0] != '#')
 			{ // URI
@@ -1660,7 +1664,6 @@ char *TrackState::FindMediaForSequenceNumber()
 				seq++;
 			}
 		}
-		ptr = next;
 	}
 	return NULL;
 }
@@ -1769,9 +1772,23 @@ bool TrackState::FetchFragmentHelper(long &http_error, bool &decryption_error, b
 			// patch for http://bitdash-a.akamaihd.net/content/sintel/hls/playlist.m3u8
 			// if fragment URI uses relative path, we don't want to replace effective URI
 			std::string tempEffectiveUrl;
+			AesStreamDecryptor *aesDecryptor = NULL;
+			bool ivPrepared = false;
+			mAesStreamDecryptor.Deactivate();
+			if (fragmentEncrypted && mDrmMethod == eDRM_KEY_METHOD_AES_128 && !byteRangeLength && ISCONFIGSET(eAAMPConfig_StreamingAesDecrypt))
+			{
+				// InitStreamDecrypt resets mKeyTagChanged , take a back up here to give back to caller
+				bKeyChanged = mKeyTagChanged;
+				UpdateMediaSequenceIV();
+				ivPrepared = true;
+				if (InitStreamDecrypt())
+				{
+					aesDecryptor = &mAesStreamDecryptor;
+				}
+			}
 			AAMPLOG_TRACE(" Calling Getfile . buffer %p avail %d", &cachedFragment->fragment, (int)cachedFragment->fragment.avail);
 			bool fetched = aamp->GetFile(fragmentUrl, &cachedFragment->fragment,
-			 tempEffectiveUrl, &http_error, &downloadTime, range, type, false, (MediaType)(type), NULL, NULL, fragmentDurationSeconds,pCMCDMetrics);
+			 tempEffectiveUrl, &http_error, &downloadTime, range, type, false, (MediaType)(type), NULL, NULL, fragmentDurationSeconds,pCMCDMetrics, aesDecryptor);
 			//Workaround for 404 of subtitle fragments
 			//TODO: This needs to be handled at server side and this workaround has to be removed
 			if (!fetched && http_error == 404 && type == eTRACK_SUBTITLE)
@@ -1782,6 +1799,7 @@ bool TrackState::FetchFragmentHelper(long &http_error, bool &decryption_error, b
 			if (!fetched)
 			{
 				//cleanup is done in aamp_GetFile itself
+				mAesStreamDecryptor.Deactivate();
 
 				aamp->profiler.ProfileError(mediaTrackBucketTypes[type], http_error);
 				aamp->profiler.ProfileEnd(mediaTrackBucketTypes[type]);
@@ -1809,7 +1827,7 @@ bool TrackState::FetchFragmentHelper(long &http_error, bool &decryption_error, b
 					AAMPLOG_ERR("Not able to download fragments; reached failure threshold sending tune failed event");
 					aamp->SendDownloadErrorEvent(AAMP_TUNE_FRAGMENT_DOWNLOAD_FAILURE, http_error);
 				}
-				aamp_Free(&cachedFragment->fragment);
+				aamp->ReleaseFragmentBuffer(&cachedFragment->fragment, (MediaType)type);
 				lastDownloadedIFrameTarget = -1;
 				return false;
 			}
@@ -1817,6 +1835,7 @@ bool TrackState::FetchFragmentHelper(long &http_error, bool &decryption_error, b
 			{
 				// increment the buffer value after download 
 				playTargetBufferCalc += fragmentDurationSeconds;
+				PrefetchNextFragments();
 			}
 
 			if((eTRACK_VIDEO == type)  && (aamp->IsTSBSupported()))
@@ -1842,35 +1861,13 @@ bool TrackState::FetchFragmentHelper(long &http_error, bool &decryption_error, b
 
 			if (cachedFragment->fragment.len && fragmentEncrypted && mDrmMethod == eDRM_KEY_METHOD_AES_128)
 			{
-				// DrmDecrypt resets mKeyTagChanged , take a back up here to give back to caller
-				bKeyChanged = mKeyTagChanged;
-				{	
-					/* XRE-18526 
-					 * From RFC8216 - Section 5.2,
-					 * An EXT-X-KEY tag with a KEYFORMAT of "identity" that does not have an
-					 * IV attribute indicates that the Media Sequence Number is to be used
-					 * as the IV when decrypting a Media Segment, by putting its big-endian
-					 * binary representation into a 16-octet (128-bit) buffer and padding
-					 * (on the left) with zeros.
-					 * Eg:
-					 * When manifest has no IV attribute as below, client has to create IV data.
-					 * #EXT-X-KEY:METHOD=AES-128,URI="https://someserver.com/hls.key" 
-					 * When manifest has IV attribute as below, client will use this IV, no need to create IV data.
-					 * #EXT-X-KEY:METHOD=AES-128,URI="https://someserver.com/hls.key",IV=0xABCDABCD
-					 */
-					if ( eMETHOD_AES_128 == mDrmInfo.method && true == mDrmInfo.bUseMediaSequenceIV )
-					{
-						if ( true == CreateInitVectorByMediaSeqNo(nextMediaSequenceNumber-1) )
-						{
-							// Set this flag to seed the newly created IV to corresponding DRM instance
-							mKeyTagChanged = true;
-						}
-						else
-						{
-							AAMPLOG_WARN ( "FetchFragmentHelper : Create Init Vector failed");
-						}
-					}
-
+				if (!ivPrepared)
+				{
+					// DrmDecrypt resets mKeyTagChanged , take a back up here to give back to caller
+					bKeyChanged = mKeyTagChanged;
+					UpdateMediaSequenceIV();
+				}
+				{
 					AAMPLOG_TRACE(" [%s] uri %s - calling  DrmDecrypt()",name, fragmentURI);
 					DrmReturn drmReturn = DrmDecrypt(cachedFragment, mediaTrackDecryptBucketTypes[type]);
 
@@ -1898,7 +1895,7 @@ bool TrackState::FetchFragmentHelper(long &http_error, bool &decryption_error, b
 								}
 							}
 						}
-						aamp_Free(&cachedFragment->fragment);
+						aamp->ReleaseFragmentBuffer(&cachedFragment->fragment, (MediaType)type);
 						lastDownloadedIFrameTarget = -1;
 						return false;
 					}
@@ -1941,6 +1938,57 @@ bool TrackState::FetchFragmentHelper(long &http_error, bool &decryption_error, b
 }
 
 
+/**
+ * @brief Queue lookahead downloads of fragments following current one on download engine
+ */
+void TrackState::PrefetchNextFragments()
+{
+	int depth = aamp->GetDownloadEnginePrefetchDepth();
+	if (depth <= 0 || !fragmentURI || !playlist.ptr || context->trickplayMode)
+	{
+		return;
+	}
+	if (mTokenizedPlaylist != playlist.ptr)
+	{
+		TokenizePlaylist();
+	}
+	int count = 0;
+	// lines after current fragment are not terminated yet by GetNextFragmentUriFromPlaylist, leave playlist untouched
+	for (size_t lineIdx = FindPlaylistLine(fragmentURI) + 1; lineIdx < mPlaylistLines.size() && count < depth; lineIdx++)
+	{
+		const HlsPlaylistLine &line = mPlaylistLines[lineIdx];
+		const char *ptr = playlist.ptr + line.offset;
+		switch (line.tag)
+		{
+			case eHLS_TAG_BYTERANGE:
+			case eHLS_TAG_MAP:
+			case eHLS_TAG_KEY:
+			case eHLS_TAG_DISCONTINUITY:
+			{
+				// fragments after these tags depend on state updated while walking the playlist, fetch them the regular way
+				return;
+			}
+			case eHLS_TAG_NONE:
+			{
+				if (line.length > 0 && '#' != *ptr)
+				{
+					std::string uri(ptr, line.length);
+					std::string fragmentUrl;
+					aamp_ResolveURL(fragmentUrl, mEffectiveUrl, uri.c_str(), ISCONFIGSET(eAAMPConfig_PropogateURIParam));
+					// already queued fragments are skipped by download engine
+					aamp->PrefetchFragment(fragmentUrl, NULL, type, (MediaType)type, depth);
+					count++;
+				}
+				break;
+			}
+			default:
+			{
+				break;
+			}
+		}
+	}
+}
+
 /**
  * @brief Function to Fetch the fragment and inject for playback
  */ 
@@ -2111,14 +2159,25 @@ void TrackState::InjectFragmentInternal(CachedFragment* cachedFragment, bool &fr
 			{
 				position = cachedFragment->position;
 			}
+			// TS demux and timestamp restamping, or ISOBMFF restamping, up to the point of injection
+			AampTraceSpan traceSpan("fragment", "demux", "track", type);
 			fragmentDiscarded = !playContext->sendSegment(cachedFragment->fragment.ptr, cachedFragment->fragment.len,
 					position, cachedFragment->duration, cachedFragment->discontinuity, ptsError);
 		}
 		else
 		{
 			fragmentDiscarded = false;
-			aamp->SendStreamCopy((MediaType)type, cachedFragment->fragment.ptr, cachedFragment->fragment.len,
+			if(ISCONFIGSET(eAAMPConfig_EnableZeroCopyInjection))
+			{
+				// fragment memory is handed over, UpdateTSAfterInject finds an empty slot
+				aamp->SendStreamTransfer((MediaType)type, &cachedFragment->fragment,
 					cachedFragment->position, cachedFragment->position, cachedFragment->duration);
+			}
+			else
+			{
+				aamp->SendStreamCopy((MediaType)type, cachedFragment->fragment.ptr, cachedFragment->fragment.len,
+					cachedFragment->position, cachedFragment->position, cachedFragment->duration);
+			}
 		}
 #endif
 	}
@@ -2487,6 +2546,159 @@ static size_t FindLineLength(const char* ptr)
 	return len;
 }
 
+/**
+ * @brief Split playlist into lines classified by tag
+ */
+void TrackState::TokenizePlaylist()
+{
+	mTagLexer.SetSubscribedTags(aamp->subscribedTags);
+	mTagLexer.Tokenize(playlist.ptr, playlist.len, mPlaylistLines);
+	mTokenizedPlaylist = playlist.ptr;
+}
+
+/**
+ * @brief Find the line holding a pointer into playlist
+ */
+size_t TrackState::FindPlaylistLine(const char *ptr) const
+{
+	if (!ptr || !playlist.ptr || ptr < playlist.ptr || ptr >= (playlist.ptr + playlist.len))
+	{
+		return mPlaylistLines.size();
+	}
+	uint32_t offset = (uint32_t)(ptr - playlist.ptr);
+	std::vector<HlsPlaylistLine>::const_iterator it = std::upper_bound(mPlaylistLines.begin(), mPlaylistLines.end(), offset,
+		[](uint32_t value, const HlsPlaylistLine &line) { return value < line.offset; });
+	if (it == mPlaylistLines.begin())
+	{
+		return mPlaylistLines.size();
+	}
+	return (it - mPlaylistLines.begin()) - 1;
+}
+
+/**
+ * @brief NUL terminate a playlist line
+ */
+char *TrackState::TerminatePlaylistLine(const HlsPlaylistLine &line)
+{
+	return TerminateLine(playlist, line);
+}
+
+/**
+ * @brief Function to apply EXT-X-START of a media playlist to the live offset
+ */
+void TrackState::ProcessXStartTag(const char *ptr)
+{
+	// X-Start can have two attributes . Time-Offset & Precise .
+	// check if App has not configured any liveoffset
+	double offsetval = ParseXStartTimeOffset(ptr);
+	if(!aamp->IsLiveAdjustRequired())
+	{
+		SETCONFIGVALUE(AAMP_STREAM_SETTING,eAAMPConfig_CDVRLiveOffset,offsetval);
+		aamp->UpdateLiveOffset();
+	}
+	else
+	{
+		/** 4K stream and 4K offset configured is below stream settings ; Ovverride liveOffset */
+		if (aamp->mIsStream4K && (GETCONFIGOWNER(eAAMPConfig_LiveOffset4K) <= AAMP_STREAM_SETTING))
+		{
+			aamp->mLiveOffset = offsetval;
+		}
+		else
+		{
+			SETCONFIGVALUE(AAMP_STREAM_SETTING,eAAMPConfig_LiveOffset,offsetval);
+			aamp->UpdateLiveOffset();
+		}
+	}
+
+	SetXStartTimeOffset(aamp->mLiveOffset);
+}
+
+/**
+ * @brief Function to re-index a refreshed live playlist, updating index of the previous playlist in place
+ */
+bool TrackState::IndexPlaylistIncremental(double &totalDuration)
+{
+	// Only clear live playlists are handled here. DRM metadata and key tags are tracked by position in
+	// playlist and need the full indexing path
+	if (!firstIndexDone || indexCount <= 0 || !IsLive() || !playlist.ptr ||
+		mDrmMetaDataIndexCount > 0 || mDrmKeyTagCount > 0 || mDeferredDrmKeyMaxTime != 0)
+	{
+		return false;
+	}
+	if (memcmp(playlist.ptr, "#EXTM3U", 7) != 0)
+	{
+		return false;
+	}
+
+	// Only a few tags need their value here, others are checked by tag alone
+	long long firstMediaSequenceNumber = -1;
+	bool eventPlaylist = false;
+	const char *xStart = NULL;
+	for (size_t lineIdx = 1; lineIdx < mPlaylistLines.size(); lineIdx++)
+	{
+		const HlsPlaylistLine &line = mPlaylistLines[lineIdx];
+		char *ptr = playlist.ptr + line.offset + line.valueOffset;
+		switch (line.tag)
+		{
+			case eHLS_TAG_MEDIA_SEQUENCE:
+				firstMediaSequenceNumber = atoll(ptr);
+				break;
+			case eHLS_TAG_TARGETDURATION:
+				targetDurationSeconds = atof(ptr);
+				break;
+			case eHLS_TAG_PLAYLIST_TYPE:
+				if (!startswith(&ptr, "EVENT"))
+				{ // VOD or unknown type, leave it to full indexing
+					return false;
+				}
+				eventPlaylist = true;
+				break;
+			case eHLS_TAG_START:
+				xStart = ptr;
+				break;
+			case eHLS_TAG_KEY:
+			case eHLS_TAG_FAXS_CM:
+			case eHLS_TAG_X1_LIN_CK:
+			case eHLS_TAG_ENDLIST:
+				// DRM or end of live stream, leave it to full indexing
+				return false;
+			default:
+				break;
+		}
+	}
+
+	long long culledCount = firstMediaSequenceNumber - indexFirstMediaSequenceNumber;
+	AampHlsSegmentIndexer indexer(index, indexCount, mDiscontinuityIndex, mDiscontinuityIndexCount);
+	int prevCount = indexCount;
+	if (firstMediaSequenceNumber < 0 || culledCount < 0 || culledCount >= prevCount ||
+		!indexer.Update(playlist.ptr, mPlaylistLines, (int)culledCount))
+	{ // sequence went back, no overlap with previous playlist or retained segments changed
+		AAMPLOG_INFO("%s incremental indexing not possible, full re-index", name);
+		return false;
+	}
+
+	indexFirstMediaSequenceNumber = firstMediaSequenceNumber;
+	if (eventPlaylist)
+	{
+		mPlaylistType = ePLAYLISTTYPE_EVENT;
+	}
+	if (xStart)
+	{
+		ProcessXStartTag(xStart);
+	}
+	mProgramDateTime = indexer.GetProgramDateTime();
+	// The first X-PROGRAM-DATE-TIME tag holds the start time for each track
+	if (startTimeForPlaylistSync == 0.0)
+	{
+		startTimeForPlaylistSync = mProgramDateTime;
+	}
+	currentIdx = -1;
+	mInitFragmentInfo = NULL;
+	totalDuration = indexer.GetTotalDuration();
+	AAMPLOG_INFO("%s incremental index: culled %lld segments (%f sec), retained %lld, appended %d",
+		name, culledCount, indexer.GetCulledDuration(), (prevCount - culledCount), (int)(indexCount - (prevCount - culledCount)));
+	return true;
+}
 
 /**
  * @brief Function to to handle parse and indexing of individual tracks
@@ -2495,6 +2707,8 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 {
 	double totalDuration = 0.0;
 	pthread_mutex_lock(&mPlaylistMutex);
+	// lines are classified once here and reused until the next playlist download
+	TokenizePlaylist();
 	double prevProgramDateTime = mProgramDateTime;
 	long long commonPlayPosition = nextMediaSequenceNumber - 1; 
 	double prevSecondsBeforePlayPoint; 
@@ -2505,9 +2719,26 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 		prevSecondsBeforePlayPoint = GetCompletionTimeForFragment(this, commonPlayPosition); 
 	}
 
-	FlushIndex();
 	mIndexingInProgress = true;
-	if (playlist.ptr )
+	bool incrementalIndexDone = false;
+	if(IsRefresh && ISCONFIGSET(eAAMPConfig_HlsIncrementalIndex))
+	{
+		incrementalIndexDone = IndexPlaylistIncremental(totalDuration);
+	}
+	if(!incrementalIndexDone)
+	{
+		FlushIndex();
+		totalDuration = 0.0;
+	}
+	if (incrementalIndexDone)
+	{
+		aamp->SetIsLive(context->IsLive());
+		if(eTRACK_VIDEO == type)
+		{
+			aamp->UpdateDuration(totalDuration);
+		}
+	}
+	else if (playlist.ptr )
 	{
 		char *ptr;
 		if(memcmp(playlist.ptr,"#EXTM3U",7)!=0)
@@ -2540,12 +2771,13 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 		mDrmInfo.masterManifestURL = aamp->GetManifestUrl();
 		mDrmInfo.initData = aamp->GetDrmInitData();
 		double fragDuration = 0;
-		ptr = GetNextLineStart(playlist.ptr);
-		while (ptr)
+		for (size_t lineIdx = 1; lineIdx < mPlaylistLines.size(); lineIdx++)
 		{
-			if(startswith(&ptr,"#EXT"))
+			const HlsPlaylistLine &line = mPlaylistLines[lineIdx];
+			ptr = playlist.ptr + line.offset + line.valueOffset;
+			switch (line.tag)
 			{
-				if (startswith(&ptr,"INF:"))
+				case eHLS_TAG_EXTINF:
 				{
 					if (discontinuity)
 					{
@@ -2563,7 +2795,7 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 						discontinuity = false;
 					}
 					programDateTimeIdxOfFragment = NULL;
-					node.pFragmentInfo = ptr-8;//Point to beginning of #EXTINF
+					node.pFragmentInfo = playlist.ptr + line.offset;//Point to beginning of #EXTINF
 					fragDuration = atof(ptr);
 					// enable logging for all stream type , for top 10 segments .This will help to find diff between
 					// playlist
@@ -2581,8 +2813,9 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 					node.drmMetadataIdx = drmMetadataIdx;
 					node.initFragmentPtr = initFragmentPtr;
 					aamp_AppendBytes(&index, &node, sizeof(node));
+					break;
 				}
-				else if(startswith(&ptr,"-X-MEDIA-SEQUENCE:"))
+				case eHLS_TAG_MEDIA_SEQUENCE:
 				{
 					indexFirstMediaSequenceNumber = atoll(ptr);
 					mediaSequence = true;
@@ -2590,19 +2823,22 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 					{
 						AAMPLOG_WARN("%s First Media Sequence Number :%lld",name,indexFirstMediaSequenceNumber);
 					}
+					break;
 				}
-				else if(startswith(&ptr,"-X-TARGETDURATION:"))
+				case eHLS_TAG_TARGETDURATION:
 				{
 					targetDurationSeconds = atof(ptr);
 					AAMPLOG_INFO("aamp: EXT-X-TARGETDURATION = %f", targetDurationSeconds);
+					break;
 				}
-				else if(startswith(&ptr,"-X-X1-LIN-CK:"))
+				case eHLS_TAG_X1_LIN_CK:
 				{
 					// get the deferred drm key acquisition time
 					mDeferredDrmKeyMaxTime = atoi(ptr);
 					AAMPLOG_INFO("#EXT-X-LIN [%d]",mDeferredDrmKeyMaxTime);
+					break;
 				}
-				else if(startswith(&ptr,"-X-PLAYLIST-TYPE:"))
+				case eHLS_TAG_PLAYLIST_TYPE:
 				{
 					// EVENT or VOD (optional); VOD if playlist will never change
 					if (startswith(&ptr, "VOD"))
@@ -2619,8 +2855,9 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 					{
 						AAMPLOG_ERR("unknown PLAYLIST-TYPE");
 					}
+					break;
 				}
-				else if(startswith(&ptr,"-X-FAXS-CM:"))
+				case eHLS_TAG_FAXS_CM:
 				{
 					size_t srcLen;
 					AAMPLOG_TRACE("aamp: #EXT-X-FAXS-CM:");
@@ -2642,20 +2879,18 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 					aamp_AppendBytes(&mDrmMetaDataIndex, &drmMetadataNode, sizeof(drmMetadataNode));
 					AAMPLOG_TRACE("mDrmMetaDataIndex.ptr %p", mDrmMetaDataIndex.ptr);
 					mDrmMetaDataIndexCount++;
+					break;
 				}
-				else if(startswith(&ptr,"-X-DISCONTINUITY-SEQUENCE"))
-				{
-					// ignore sequence
-				}
-				else if(startswith(&ptr,"-X-DISCONTINUITY"))
+				case eHLS_TAG_DISCONTINUITY:
 				{
 					discontinuity = true;
 					if(ISCONFIGSET(eAAMPConfig_StreamLogging))
 					{
 						AAMPLOG_WARN("%s [%d] Discontinuity Posn : %f ",name,indexCount,totalDuration);
 					}
+					break;
 				}
-				else if (startswith(&ptr, "-X-PROGRAM-DATE-TIME:"))
+				case eHLS_TAG_PROGRAM_DATE_TIME:
 				{
 					programDateTimeIdxOfFragment = ptr;					
 					if(ISCONFIGSET(eAAMPConfig_StreamLogging))
@@ -2686,8 +2921,9 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 						startTimeForPlaylistSync = mProgramDateTime; 
 						AAMPLOG_WARN("%s StartTimeForPlaylistSync : %f ",name, startTimeForPlaylistSync);
 					}
+					break;
 				}
-				else if (startswith(&ptr, "-X-KEY:"))
+				case eHLS_TAG_KEY:
 				{
 					size_t len;
 					AAMPLOG_TRACE("aamp: EXT-X-KEY");
@@ -2750,8 +2986,9 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 
 					free (key);
 					mDrmKeyTagCount++;
+					break;
 				}
-				else if(startswith(&ptr,"-X-MAP:"))
+				case eHLS_TAG_MAP:
 				{
 					initFragmentPtr = ptr;
 					if (mCheckForInitialFragEnc)
@@ -2765,36 +3002,14 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 							mFirstEncInitFragmentInfo = ptr;
 						}
 					}
+					break;
 				}
-				else if (startswith(&ptr, "-X-START:"))
+				case eHLS_TAG_START:
 				{
-					// X-Start can have two attributes . Time-Offset & Precise .
-					// check if App has not configured any liveoffset
-					{
-						double offsetval = ParseXStartTimeOffset(ptr);
-						if(!aamp->IsLiveAdjustRequired())
-						{
-							SETCONFIGVALUE(AAMP_STREAM_SETTING,eAAMPConfig_CDVRLiveOffset,offsetval);
-							aamp->UpdateLiveOffset();
-						}
-						else
-						{
-							/** 4K stream and 4K offset configured is below stream settings ; Ovverride liveOffset */
-							if (aamp->mIsStream4K && (GETCONFIGOWNER(eAAMPConfig_LiveOffset4K) <= AAMP_STREAM_SETTING))
-							{
-								aamp->mLiveOffset = offsetval;
-							}
-							else
-							{
-								SETCONFIGVALUE(AAMP_STREAM_SETTING,eAAMPConfig_LiveOffset,offsetval);
-								aamp->UpdateLiveOffset();
-							}
-						}
-						
-						SetXStartTimeOffset(aamp->mLiveOffset);
-					}
+					ProcessXStartTag(ptr);
+					break;
 				}
-				else if (startswith(&ptr,"-X-ENDLIST"))
+				case eHLS_TAG_ENDLIST:
 				{
 					// ENDLIST found .Check playlist tag with vod was missing or not.If playlist still undefined
 					// mark it as VOD
@@ -2804,9 +3019,11 @@ void TrackState::IndexPlaylist(bool IsRefresh, double &culledSec)
 						AAMPLOG_WARN("aamp: Changing playlist type from[%d] to ePLAYLISTTYPE_VOD as ENDLIST tag present.",mPlaylistType);
 						mPlaylistType = ePLAYLISTTYPE_VOD;
 					}
+					break;
 				}
+				default:
+					break;
 			}
-			ptr=GetNextLineStart(ptr);
 		}
 
 		if (mDrmMetaDataIndexCount > 1)
@@ -2959,6 +3176,7 @@ void TrackState::ABRProfileChanged()
  */
 void TrackState::RefreshPlaylist(void)
 {
+	AampTraceSpan traceSpan("playlist", "playlist_refresh", "track", type);
 	GrowableBuffer tempBuff;
 	long http_error = 0;
 
@@ -5263,21 +5481,6 @@ AAMPStatusType StreamAbstractionAAMP_HLS::Init(TuneType tuneType)
 	return retval;
 }
 
-/***************************************************************************
-* @fn CachePlaylistThreadFunction
-* @brief Thread function created for PreCaching playlist
-*
-* @param This[in] PrivateAampInstance Context
-* @return none
-***************************************************************************/
-static void * CachePlaylistThreadFunction(void * This) 
-{
-	// DELIA-41566 [PEACOCK] temporary hack required to work around Adobe SSAI session lifecycle problem
-	// Temporary workaround code to address Peacock/Adobe Server issue 
-	((PrivateInstanceAAMP*)This)->PreCachePlaylistDownloadTask(); 
-	return NULL;
-}
-
 /**
  * @brief Function to initiate precaching of playlist
  */
@@ -5286,8 +5489,8 @@ void StreamAbstractionAAMP_HLS::PreCachePlaylist()
 	// DELIA-41566 [PEACOCK] temporary hack required to work around Adobe SSAI session lifecycle problem
 	// Tasks to be done
 	// Run thru all the streamInfo and get uri for download , push to a download list
-	// Start a thread and return back . This thread will wake up after Tune completion
-	// and start downloading the uri in the list
+	// Schedule a reactor task and return back . The task is woken after Tune completion
+	// and starts downloading the uri in the list
 	int szUrlList = mMediaCount + mProfileCount;
 	PreCacheUrlList dnldList ;
 	for (int idx=0;idx < mProfileCount; idx++)
@@ -5314,15 +5517,7 @@ void StreamAbstractionAAMP_HLS::PreCachePlaylist()
 	
 	// Set the download list to PrivateInstance to download it 
 	aamp->SetPreCacheDownloadList(dnldList);
-	int ret = pthread_create(&aamp->mPreCachePlaylistThreadId, NULL, CachePlaylistThreadFunction,(void *)aamp );
-	if(ret != 0)
-	{
-		AAMPLOG_ERR("pthread_create failed for PreCachePlaylist with errno = %d, %s", errno, strerror(errno));
-	}
-	else
-	{
-		aamp->mPreCachePlaylistThreadFlag = true;
-	}
+	aamp->SchedulePreCachePlaylist();
 }
 
 
@@ -5692,6 +5887,8 @@ TrackState::TrackState(AampLogManager *logObj, TrackType type, StreamAbstraction
 		,mProgramDateTime(0.0),pCMCDMetrics(NULL)
 		,mDiscontinuityCheckingOn(false)
 		,mSkipSegmentOnError(true)
+		,mAesStreamDecryptor()
+		,mTagLexer(), mPlaylistLines(), mTokenizedPlaylist(NULL)
 {
 	memset(&playlist, 0, sizeof(playlist));
 	memset(&index, 0, sizeof(index));
@@ -5728,7 +5925,7 @@ TrackState::~TrackState()
 	GETCONFIGVALUE(eAAMPConfig_MaxFragmentCached,maxCachedFragmentsPerTrack); 
 	for (int j=0; j< maxCachedFragmentsPerTrack; j++)
 	{
-		aamp_Free(&cachedFragment[j].fragment);
+		aamp->ReleaseFragmentBuffer(&cachedFragment[j].fragment, (MediaType)type);
 	}
 	FlushIndex();
 	SAFE_DELETE(playContext);
@@ -6273,6 +6470,7 @@ void StreamAbstractionAAMP_HLS::PauseSubtitleParser(bool pause)
  */
 DrmReturn TrackState::DrmDecrypt( CachedFragment * cachedFragment, ProfilerBucketType bucketTypeFragmentDecrypt)
 {
+		AampTraceSpan traceSpan("fragment", "decrypt", "track", type);
 		DrmReturn drmReturn = eDRM_ERROR;
 
 		pthread_mutex_lock(&mTrackDrmMutex);
@@ -6288,7 +6486,19 @@ DrmReturn TrackState::DrmDecrypt( CachedFragment * cachedFragment, ProfilerBucke
 				SetDrmContext();
 				mKeyTagChanged = false;
 			}
-			if(mDrm)
+			if (mAesStreamDecryptor.IsActive())
+			{
+				// blocks received so far are already decrypted by download callback
+				aamp->LogDrmDecryptBegin(bucketTypeFragmentDecrypt);
+				bool finished = mAesStreamDecryptor.Finish((unsigned char *)cachedFragment->fragment.ptr, cachedFragment->fragment.len);
+				aamp->LogDrmDecryptEnd(bucketTypeFragmentDecrypt);
+				drmReturn = finished ? eDRM_SUCCESS : eDRM_ERROR;
+				if (!finished)
+				{
+					AAMPLOG_WARN("[%s] AES stream decrypt failed len %zu", name, cachedFragment->fragment.len);
+				}
+			}
+			else if(mDrm)
 			{
 				drmReturn = mDrm->Decrypt(bucketTypeFragmentDecrypt, cachedFragment->fragment.ptr,
 						cachedFragment->fragment.len, MAX_LICENSE_ACQ_WAIT_TIME);
@@ -6304,6 +6514,60 @@ DrmReturn TrackState::DrmDecrypt( CachedFragment * cachedFragment, ProfilerBucke
 		return drmReturn;
 }
 
+/**
+ * @brief Function to set up decryption of current fragment in download callback
+ */
+bool TrackState::InitStreamDecrypt()
+{
+	bool ret = false;
+
+	pthread_mutex_lock(&mTrackDrmMutex);
+	if (aamp->DownloadsAreEnabled())
+	{
+		// same context update as DrmDecrypt, done ahead of download so that key and IV are known on arrival
+		if (fragmentEncrypted && (!mDrm || mKeyTagChanged))
+		{
+			SetDrmContext();
+			mKeyTagChanged = false;
+		}
+		ret = mDrm && mDrm->InitStreamDecryptor(mAesStreamDecryptor);
+	}
+	pthread_mutex_unlock(&mTrackDrmMutex);
+	return ret;
+}
+
+/**
+ * @brief Function to create IV of current fragment when key tag has none
+ */
+void TrackState::UpdateMediaSequenceIV()
+{
+	/* XRE-18526 
+	 * From RFC8216 - Section 5.2,
+	 * An EXT-X-KEY tag with a KEYFORMAT of "identity" that does not have an
+	 * IV attribute indicates that the Media Sequence Number is to be used
+	 * as the IV when decrypting a Media Segment, by putting its big-endian
+	 * binary representation into a 16-octet (128-bit) buffer and padding
+	 * (on the left) with zeros.
+	 * Eg:
+	 * When manifest has no IV attribute as below, client has to create IV data.
+	 * #EXT-X-KEY:METHOD=AES-128,URI="https://someserver.com/hls.key" 
+	 * When manifest has IV attribute as below, client will use this IV, no need to create IV data.
+	 * #EXT-X-KEY:METHOD=AES-128,URI="https://someserver.com/hls.key",IV=0xABCDABCD
+	 */
+	if ( eMETHOD_AES_128 == mDrmInfo.method && true == mDrmInfo.bUseMediaSequenceIV )
+	{
+		if ( true == CreateInitVectorByMediaSeqNo(nextMediaSequenceNumber-1) )
+		{
+			// Set this flag to seed the newly created IV to corresponding DRM instance
+			mKeyTagChanged = true;
+		}
+		else
+		{
+			AAMPLOG_WARN ( "UpdateMediaSequenceIV : Create Init Vector failed");
+		}
+	}
+}
+
 /**
  * @brief Function to create init vector using current media sequence number
  */
@@ -7052,7 +7316,12 @@ bool TrackState::FetchInitFragmentHelper(long &http_code, bool forcePushEncrypte
 			long long ts_start, ts_end;
 			ts_start = aamp_GetCurrentTimeMS();
 #endif /* CHECK_PERFORMANCE */
-			bool fetched = aamp->getAampCacheHandler()->RetrieveFromInitFragCache(fragmentUrl, &cachedFragment->fragment, tempEffectiveUrl);
+			AampCachedFilePtr initFragment = aamp->getAampCacheHandler()->BorrowFromInitFragCache(fragmentUrl);
+			bool fetched = (initFragment != NULL);
+			if (fetched)
+			{
+				tempEffectiveUrl = initFragment->effectiveUrl;
+			}
 
 #ifdef CHECK_PERFORMANCE
 			ts_end = aamp_GetCurrentTimeMS();
@@ -7075,7 +7344,7 @@ bool TrackState::FetchInitFragmentHelper(long &http_code, bool forcePushEncrypte
 				aamp->UpdateVideoEndMetrics(actualType, this->GetCurrentBandWidth(), main_error, mEffectiveUrl, downloadTime);
 
 				if ( fetched )
-				aamp->getAampCacheHandler()->InsertToInitFragCache ( fragmentUrl, &cachedFragment->fragment, tempEffectiveUrl, actualType);
+				initFragment = aamp->getAampCacheHandler()->InsertToInitFragCache ( fragmentUrl, &cachedFragment->fragment, tempEffectiveUrl, actualType, aamp->GetResponseValidator(type));
 			}
 			if (!fetched)
 			{
@@ -7084,6 +7353,11 @@ bool TrackState::FetchInitFragmentHelper(long &http_code, bool forcePushEncrypte
 			}
 			else
 			{
+				if (initFragment)
+				{
+					// webvtt parsing tokenizes subtitle fragments in place
+					aamp->UseCachedInitFragment(initFragment, &cachedFragment->fragment, (eMEDIATYPE_INIT_SUBTITLE == actualType));
+				}
 				ret = true;
 			}
 		}
@@ -7229,38 +7503,44 @@ void TrackState::FindTimedMetadata(bool reportBulkMeta, bool bInitCall)
 		pthread_mutex_lock(&mPlaylistMutex);
 		if (playlist.ptr)
 		{
-			char *ptr = GetNextLineStart(playlist.ptr);
-			while (ptr)
+			if (mTokenizedPlaylist != playlist.ptr)
+			{
+				TokenizePlaylist();
+			}
+			else if (mTagLexer.SetSubscribedTags(aamp->subscribedTags))
+			{ // subscription changed since playlist was tokenized
+				for (HlsPlaylistLine &line : mPlaylistLines)
+				{
+					mTagLexer.Classify(playlist.ptr, line);
+				}
+			}
+			for (size_t lineIdx = 1; lineIdx < mPlaylistLines.size(); lineIdx++)
 			{
-				if(startswith(&ptr,"#EXT"))
+				const HlsPlaylistLine &line = mPlaylistLines[lineIdx];
+				char *ptr = playlist.ptr + line.offset;
+				if (line.tag == eHLS_TAG_EXTINF)
 				{
-					if (startswith(&ptr, "INF:"))
+					totalDuration += atof(ptr + line.valueOffset);
+				}
+				else if (line.subscribedTag != HLS_NO_SUBSCRIBED_TAG)
+				{
+					const std::string &tag = aamp->subscribedTags.at(line.subscribedTag);
+					const char* data = tag.data();
+					size_t valueOffset = std::min((size_t)line.length, tag.size() + 1); // remove the TAG and the ":", only keep value(content) in PTR
+					ptr += valueOffset;
+					int nb = (int)(line.length - valueOffset);
+					long long positionMilliseconds = (long long) std::round((mCulledSecondsAtStart + mCulledSeconds + totalDuration) * 1000.0);
+					//AAMPLOG_INFO("mCulledSecondsAtStart:%f mCulledSeconds :%f totalDuration: %f posnMs:%lld playposn:%lld",mCulledSecondsAtStart,mCulledSeconds,totalDuration,positionMilliseconds,aamp->GetPositionMs());
+					//AAMPLOG_WARN("Found subscribedTag[%d]: @%f cull:%f Posn:%lld '%.*s'", line.subscribedTag, totalDuration, mCulledSeconds, positionMilliseconds, nb, ptr);
+					if(reportBulkMeta)
 					{
-						totalDuration += atof(ptr);
+						aamp->SaveTimedMetadata(positionMilliseconds, data, ptr, nb);
 					}
-					for (int i = 0; i < aamp->subscribedTags.size(); i++)
+					else
 					{
-						const char* data = aamp->subscribedTags.at(i).data();
-						if(startswith(&ptr, (data + 4))) // remove the TAG and only keep value(content) in PTR
-						{
-							ptr++; // skip the ":"
-							int nb = (int)FindLineLength(ptr);
-							long long positionMilliseconds = (long long) std::round((mCulledSecondsAtStart + mCulledSeconds + totalDuration) * 1000.0);
-							//AAMPLOG_INFO("mCulledSecondsAtStart:%f mCulledSeconds :%f totalDuration: %f posnMs:%lld playposn:%lld",mCulledSecondsAtStart,mCulledSeconds,totalDuration,positionMilliseconds,aamp->GetPositionMs());
-							//AAMPLOG_WARN("Found subscribedTag[%d]: @%f cull:%f Posn:%lld '%.*s'", i, totalDuration, mCulledSeconds, positionMilliseconds, nb, ptr);
-							if(reportBulkMeta)
-							{
-								aamp->SaveTimedMetadata(positionMilliseconds, data, ptr, nb);
-							}
-							else
-							{
-								aamp->ReportTimedMetadata(positionMilliseconds, data, ptr, nb,bInitCall);
-							}
-							break;
-						}
+						aamp->ReportTimedMetadata(positionMilliseconds, data, ptr, nb,bInitCall);
 					}
 				}
-				ptr=GetNextLineStart(ptr);
 			}
 		}
 		pthread_mutex_unlock(&mPlaylistMutex);
@@ -39,6 +39,9 @@
 #include "StreamAbstractionAAMP.h"
 #include "mediaprocessor.h"
 #include "drm.h"
+#include "aamp_aes_stream.h"
+#include "AampHlsTagLexer.h"
+#include "AampHlsSegmentIndexer.h"
 #include <sys/time.h>
 
 
@@ -113,18 +116,6 @@ typedef struct MediaInfo
 	bool isCC;			/**< True if the text track is closed-captions */
 } MediaInfo;
 
-/**
-*	\struct	IndexNode
-* 	\brief	IndexNode structure for Node/DRM Index
-*/
-struct IndexNode
-{
-	double completionTimeSecondsFromStart;	/**< Time of index from start */
-	const char *pFragmentInfo;		/**< Fragment Information pointer */
-	int drmMetadataIdx;			/**< DRM Index for Fragment */
-	const char *initFragmentPtr;		/**< Fragmented MP4 specific pointer to associated (preceding) initialization fragment */
-};
-
 /**
 *	\struct	KeyTagStruct
 * 	\brief	KeyTagStruct structure to store all Keytags with Hash
@@ -139,18 +130,6 @@ struct KeyTagStruct
 	std::string mKeyTagStr;	   /**< String to store key tag,needed for trickplay */
 };
 
-/**
-*	\struct	DiscontinuityIndexNode
-* 	\brief	Index Node structure for Discontinuity Index
-*/
-struct DiscontinuityIndexNode
-{
-	int fragmentIdx;	         /**< Idx of fragment in index table*/
-	double position;	         /**< Time of index from start */
-	double fragmentDuration;	 /**< Fragment duration of current discontinuity index */
-	double discontinuityPDT;	 /**< Program Date time value */
-};
-
 /**
 *	\enum DrmKeyMethod
 * 	\brief	Enum for various EXT-X-KEY:METHOD= values
@@ -229,6 +208,23 @@ public:
      	 * @return double total duration from playlist
      	***************************************************************************/
 	void IndexPlaylist(bool IsRefresh, double &culledSec);
+	/***************************************************************************
+     	 * @fn IndexPlaylistIncremental
+     	 * @brief Function to index refreshed live playlist by dropping nodes culled from
+     	 *        previous playlist (by EXT-X-MEDIA-SEQUENCE) in place and parsing only new segments
+     	 * @param[out] totalDuration total duration of playlist
+     	 *
+     	 * @return true if indexed, false if full re-index is required
+     	***************************************************************************/
+	bool IndexPlaylistIncremental(double &totalDuration);
+	/***************************************************************************
+     	 * @fn ProcessXStartTag
+     	 * @brief Function to apply EXT-X-START of media playlist to live offset
+     	 * @param[in] ptr EXT-X-START attributes
+     	 *
+     	 * @return void
+     	***************************************************************************/
+	void ProcessXStartTag(const char *ptr);
 	/***************************************************************************
      	 * @fn ABRProfileChanged
      	 *
@@ -270,6 +266,20 @@ public:
      	 * @return bool true if successfully created, false otherwise.
      	***************************************************************************/
 	bool CreateInitVectorByMediaSeqNo( unsigned int ui32Seqno );
+	/***************************************************************************
+     	 * @fn UpdateMediaSequenceIV
+     	 *
+     	 * @brief Create IV of current fragment from media sequence number if key tag has no IV
+     	 * @return void
+     	***************************************************************************/
+	void UpdateMediaSequenceIV();
+	/***************************************************************************
+     	 * @fn InitStreamDecrypt
+     	 *
+     	 * @brief Set up decryption of current AES-128 fragment while it downloads
+     	 * @return bool true if key is available and fragment can be decrypted on arrival
+     	***************************************************************************/
+	bool InitStreamDecrypt();
 	/***************************************************************************
      	 * @fn FetchPlaylist
      	 *
@@ -413,6 +423,13 @@ private:
      	 * @return bool true on success else false
      	 ***************************************************************************/
 	bool FetchFragmentHelper(long &http_error, bool &decryption_error, bool & bKeyChanged, int * fogError, double &downloadTime);
+	/***************************************************************************
+     	 * @fn PrefetchNextFragments
+     	 * @brief Queue lookahead downloads of fragments following current one on download engine
+     	 *
+     	 * @return void
+     	 ***************************************************************************/
+	void PrefetchNextFragments();
 	/***************************************************************************
      	 * @fn RefreshPlaylist
     	 *
@@ -438,6 +455,26 @@ private:
      	 * @return string fragment tag line pointer
      	 ***************************************************************************/
 	char *FindMediaForSequenceNumber();
+	/***************************************************************************
+     	 * @fn TokenizePlaylist
+     	 * @brief Split playlist into lines classified by tag, done once per downloaded playlist
+     	 *
+     	 * @return void
+     	 ***************************************************************************/
+	void TokenizePlaylist();
+	/***************************************************************************
+     	 * @fn FindPlaylistLine
+     	 * @param[in] ptr pointer into playlist
+     	 * @return index of the line holding ptr, mPlaylistLines.size() if not in playlist
+     	 ***************************************************************************/
+	size_t FindPlaylistLine(const char *ptr) const;
+	/***************************************************************************
+     	 * @fn TerminatePlaylistLine
+     	 * @brief Replace line terminator by NUL, as done by mystrpbrk
+     	 * @param[in] line playlist line
+     	 * @return start of line
+     	 ***************************************************************************/
+	char *TerminatePlaylistLine(const HlsPlaylistLine &line);
 	/***************************************************************************
      	 * @fn FetchInitFragment
     	 *
@@ -553,6 +590,10 @@ private:
 	double mXStartTimeOFfset;		/**< Holds value of time offset from X-Start tag */
 	double mCulledSecondsAtStart;		/**< Total culled duration with this asset prior to streamer instantiation*/
 	bool mSkipSegmentOnError;		/**< Flag used to enable segment skip on fetch error */
+	AesStreamDecryptor mAesStreamDecryptor;	/**< Decrypts AES-128 fragment in download buffer as data arrives */
+	AampHlsTagLexer mTagLexer;		/**< Classifies playlist lines by known and subscribed tags */
+	std::vector<HlsPlaylistLine> mPlaylistLines;	/**< Lines of playlist, shared by indexing, fragment selection and metadata search */
+	const char *mTokenizedPlaylist;		/**< Playlist buffer mPlaylistLines was built from */
 };
 
 class StreamAbstractionAAMP_HLS;
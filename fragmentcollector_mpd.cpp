@@ -49,6 +49,8 @@
 #include <regex>
 #include "AampCacheHandler.h"
 #include "AampUtils.h"
+#include "AampTraceRecorder.h"
+#include "AampReactor.h"
 #include "AampRfc.h"
 #include <chrono>
 //#define DEBUG_TIMELINE
@@ -306,16 +308,20 @@ StreamAbstractionAAMP_MPD::StreamAbstractionAAMP_MPD(AampLogManager *logObj, cla
 	,mFirstPeriodStartTime(0)
 	,mDrmPrefs({{CLEARKEY_UUID, 1}, {WIDEVINE_UUID, 2}, {PLAYREADY_UUID, 3}})// Default values, may get changed due to config file
 	,mLastDrmHelper()
-	,deferredDRMRequestThread(NULL), deferredDRMRequestThreadStarted(false), mCommonKeyDuration(0)
-	,mEarlyAvailableKeyIDMap(), mPendingKeyIDs(), mAbortDeferredLicenseLoop(false), mEarlyAvailablePeriodIds(), thumbnailtrack(), indexedTileInfo()
+	,deferredDRMRequestTaskId(AAMP_REACTOR_TASK_ID_INVALID), mDeferredKeyWaited(false), mCommonKeyDuration(0)
+	,mEarlyAvailableKeyIDMap(), mPendingKeyIDs(), mPendingKeyIDsMutex(), mAbortDeferredLicenseLoop(false), mEarlyAvailablePeriodIds(), thumbnailtrack(), indexedTileInfo()
 	,mMaxTracks(0)
 	,mServerUtcTime(0)
 	,mDeltaTime(0)
 	,mHasServerUtcTime(0)
-	,latencyMonitorThreadStarted(false),prevLatencyStatus(LATENCY_STATUS_UNKNOWN),latencyStatus(LATENCY_STATUS_UNKNOWN),latencyMonitorThreadID(0)
+	,latencyMonitorTaskId(AAMP_REACTOR_TASK_ID_INVALID),prevLatencyStatus(LATENCY_STATUS_UNKNOWN),latencyStatus(LATENCY_STATUS_UNKNOWN)
 	,mStreamLock()
 	,mProfileCount(0),pCMCDMetrics(NULL)
 	,mSubtitleParser()
+	,mManifestUpdateCount(0)
+	,mCachedPeriods()
+	,mCachedPeriodsPath()
+	,mSharedPeriodCount(0)
 {
         FN_TRACE_F_MPD( __FUNCTION__ );
 	this->aamp = aamp;
@@ -1200,6 +1206,151 @@ bool StreamAbstractionAAMP_MPD::FetchFragment(MediaStreamContext *pMediaStreamCo
 	return retval;
 }
 
+/**
+ * @brief Queue lookahead downloads of fragments following the one just fetched
+ */
+void StreamAbstractionAAMP_MPD::PrefetchNextFragments(MediaStreamContext *pMediaStreamContext, const std::string &media, const std::vector<ITimeline *> *timelines, double fragmentDuration, unsigned int curlInstance)
+{
+	FN_TRACE_F_MPD( __FUNCTION__ );
+	int depth = aamp->GetDownloadEnginePrefetchDepth();
+	if (depth <= 0 || rate != AAMP_NORMAL_PLAY_RATE || mCheckForRampdown || pMediaStreamContext->mDownloadedFragment.ptr)
+	{
+		return;
+	}
+	// walk a copy of the descriptor the same way PushNextFragment advances it
+	FragmentDescriptor descriptor(pMediaStreamContext->fragmentDescriptor);
+	int index = pMediaStreamContext->timeLineIndex;
+	uint32_t repeat = pMediaStreamContext->fragmentRepeatCount;
+	for (int count = 0; count < depth; count++)
+	{
+		if (timelines)
+		{
+			if (index < 0 || index >= timelines->size())
+			{
+				break;
+			}
+			ITimeline *timeline = timelines->at(index);
+			descriptor.Time += timeline->GetDuration();
+			descriptor.Number++;
+			repeat++;
+			if (repeat > timeline->GetRepeatCount())
+			{
+				repeat = 0;
+				index++;
+				if (index >= timelines->size())
+				{ // rest of timeline comes with next manifest refresh
+					break;
+				}
+				timeline = timelines->at(index);
+				map<string, string> attributeMap = timeline->GetRawAttributes();
+				if (attributeMap.find("t") != attributeMap.end())
+				{
+					descriptor.Time = timeline->GetStartTime();
+				}
+			}
+		}
+		else
+		{
+			descriptor.Number++;
+			descriptor.Time += fragmentDuration;
+			if (descriptor.Time >= mPeriodEndTime)
+			{
+				break;
+			}
+		}
+		std::string fragmentUrl;
+		GetFragmentUrl(fragmentUrl, &descriptor, media);
+		aamp->PrefetchFragment(fragmentUrl, NULL, curlInstance, pMediaStreamContext->mediaType, depth);
+	}
+}
+
+/**
+ * @brief Queue init fragment and first fragment of all enabled tracks on download engine
+ *
+ * Downloads are claimed by FetchAndInjectInitialization and the first PushNextFragment of each track,
+ * so they overlap each other, init fragment injection and pipeline setup. The first fragment is only
+ * queued where PushNextFragment does not depend on state known at fetch time; a wrong guess is
+ * dropped by the download engine when the track claims another url.
+ */
+void StreamAbstractionAAMP_MPD::PrefetchTuneFragments()
+{
+	FN_TRACE_F_MPD( __FUNCTION__ );
+	int depth = aamp->GetTunePrefetchDepth();
+	if (depth <= 0)
+	{
+		return;
+	}
+	for (int trackIdx = 0; trackIdx < mNumberOfTracks; trackIdx++)
+	{
+		MediaStreamContext *pMediaStreamContext = mMediaStreamContext[trackIdx];
+		if (!pMediaStreamContext->enabled || pMediaStreamContext->eos || !pMediaStreamContext->adaptationSet || !pMediaStreamContext->representation)
+		{
+			continue;
+		}
+		SegmentTemplates segmentTemplates(pMediaStreamContext->representation->GetSegmentTemplate(),
+						pMediaStreamContext->adaptationSet->GetSegmentTemplate() );
+		if (!segmentTemplates.HasSegmentTemplate())
+		{ // SegmentBase and SegmentList fragments are located through index, fetched the regular way
+			continue;
+		}
+		unsigned int curlInstance = getCurlInstanceByMediaType(pMediaStreamContext->mediaType);
+		std::string initialization = segmentTemplates.Getinitialization();
+		if (!initialization.empty() && (pMediaStreamContext->profileChanged || pMediaStreamContext->discontinuity))
+		{
+			std::string initUrl;
+			GetFragmentUrl(initUrl, &pMediaStreamContext->fragmentDescriptor, initialization);
+			if (!aamp->getAampCacheHandler()->IsInitFragmentCached(initUrl))
+			{
+				aamp->PrefetchFragment(initUrl, NULL, curlInstance, (MediaType)(eMEDIATYPE_INIT_VIDEO + pMediaStreamContext->mediaType), depth);
+			}
+		}
+
+		// position the descriptor the way PushNextFragment does before its first fetch
+		FragmentDescriptor descriptor(pMediaStreamContext->fragmentDescriptor);
+		const ISegmentTimeline *segmentTimeline = segmentTemplates.GetSegmentTimeline();
+		if (segmentTimeline)
+		{
+			std::vector<ITimeline *>&timelines = segmentTimeline->GetTimelines();
+			int index = pMediaStreamContext->timeLineIndex;
+			if (index < 0 || index >= timelines.size())
+			{
+				continue;
+			}
+			if (0 == descriptor.Time && (mIsLiveStream || segmentTemplates.GetPresentationTimeOffset() > 0))
+			{ // start is resolved against presentation time offset or last segment time
+				continue;
+			}
+			if (0 == pMediaStreamContext->fragmentRepeatCount)
+			{
+				ITimeline *timeline = timelines.at(index);
+				map<string, string> attributeMap = timeline->GetRawAttributes();
+				if (attributeMap.find("t") != attributeMap.end())
+				{
+					descriptor.Time = timeline->GetStartTime();
+				}
+			}
+		}
+		else
+		{
+			if (mIsLiveStream)
+			{ // segment number follows wall clock at fetch time
+				continue;
+			}
+			if (0 == pMediaStreamContext->lastSegmentNumber)
+			{
+				descriptor.Time = mPeriodStartTime;
+			}
+			if (descriptor.Time >= mPeriodEndTime)
+			{
+				continue;
+			}
+		}
+		std::string fragmentUrl;
+		GetFragmentUrl(fragmentUrl, &descriptor, segmentTemplates.Getmedia());
+		aamp->PrefetchFragment(fragmentUrl, NULL, curlInstance, pMediaStreamContext->mediaType, depth);
+	}
+}
+
 /**
  * @brief Fetch and push next fragment
  * @retval true if push is done successfully
@@ -1415,37 +1566,24 @@ bool StreamAbstractionAAMP_MPD::PushNextFragment( class MediaStreamContext *pMed
 							{
 								uint32_t duration =0;
 								uint32_t repeatCount =0;
-								uint64_t nextStartTime = 0;
 								int index = pMediaStreamContext->timeLineIndex;
-								// This for loop is to go to the right index based on LastSegmentTime
-			
-								for(;index<timelines.size();index++)
+								// Go to the right index based on LastSegmentTime, S without 't' follows end of previous S
+								const AampTimelineIndex &timelineIndex = GetTimelineIndex(pMediaStreamContext, segmentTimeline, timeScale);
+								int startIndex = index;
+								index = timelineIndex.FindEntryByTime(pMediaStreamContext->lastSegmentTime, startIndex);
+								if(index < timelines.size())
 								{
+									pMediaStreamContext->fragmentDescriptor.Number += (timelineIndex.GetOrdinal(index, 0) - timelineIndex.GetOrdinal(startIndex, 0));
 									timeline = timelines.at(index);
-									map<string, string> attributeMap = timeline->GetRawAttributes();
-									if(attributeMap.find("t") != attributeMap.end())
-									{
-										startTime = timeline->GetStartTime();
-									}
-									else
-									{
-										startTime = pMediaStreamContext->fragmentDescriptor.Time;
-									}
-
-									duration = timeline->GetDuration();
-									// For Dynamic segment timeline content
-									if (0 == startTime && 0 != duration)
-									{
-										startTime = nextStartTime;
-									}
-									repeatCount = timeline->GetRepeatCount();
-									nextStartTime = startTime+((uint64_t)(repeatCount+1)*duration);  //CID:98056 - Resolve Overfloew Before Widen
-									if(pMediaStreamContext->lastSegmentTime < nextStartTime)
-									{
-										break;
-									}
-									pMediaStreamContext->fragmentDescriptor.Number += (repeatCount+1);
-								}// end of for
+									startTime = timelineIndex.GetStartTime(index, 0);
+								}
+								else
+								{
+									pMediaStreamContext->fragmentDescriptor.Number += (timelineIndex.GetFragmentCount() - timelineIndex.GetOrdinal(startIndex, 0));
+									timeline = timelines.back();
+								}
+								duration = timeline->GetDuration();
+								repeatCount = timeline->GetRepeatCount();
 
 								
 								/*
@@ -1470,6 +1608,14 @@ bool StreamAbstractionAAMP_MPD::PushNextFragment( class MediaStreamContext *pMed
 								// Now we reached the right row , need to traverse the repeat index to reach right node
 								// Whenever new fragments arrive inside the same timeline update fragment number,repeat count and startNumber.
 								// If first fragment start Number is zero, check lastSegmentDuration of period timeline for update.
+								if(duration && pMediaStreamContext->fragmentRepeatCount >= 0 && pMediaStreamContext->fragmentRepeatCount < repeatCount && startTime < pMediaStreamContext->lastSegmentTime)
+								{
+									uint64_t steps = (pMediaStreamContext->lastSegmentTime - startTime + duration - 1) / duration;
+									steps = std::min(steps, (uint64_t)(repeatCount - pMediaStreamContext->fragmentRepeatCount));
+									startTime += steps * duration;
+									pMediaStreamContext->fragmentDescriptor.Number += steps;
+									pMediaStreamContext->fragmentRepeatCount += (int)steps;
+								}
 								while((pMediaStreamContext->fragmentRepeatCount < repeatCount && startTime < pMediaStreamContext->lastSegmentTime) ||
 									(startTime == 0 && pMediaStreamContext->lastSegmentTime == 0 && pMediaStreamContext->lastSegmentDuration != 0))
 								{
@@ -1563,6 +1709,10 @@ bool StreamAbstractionAAMP_MPD::PushNextFragment( class MediaStreamContext *pMed
 						if((mIsFogTSB || (mPeriodDuration !=0 && (mPeriodStartTime + positionInPeriod) < endTime))&& !FCS_content)
 						{
 							retval = FetchFragment( pMediaStreamContext, media, fragmentDuration, false, curlInstance);
+							if(retval && !FCS_rep)
+							{
+								PrefetchNextFragments(pMediaStreamContext, media, &timelines, fragmentDuration, curlInstance);
+							}
 						}
 						else
 						{
@@ -1903,6 +2053,10 @@ bool StreamAbstractionAAMP_MPD::PushNextFragment( class MediaStreamContext *pMed
 					pMediaStreamContext->fragmentDescriptor.Number = pMediaStreamContext->lastSegmentNumber;
 				}
 				retval = FetchFragment(pMediaStreamContext, media, fragmentDuration, false, curlInstance, false, pto, scale);
+				if (retval && !mIsLiveStream)
+				{ // live segments become available one by one, no lookahead
+					PrefetchNextFragments(pMediaStreamContext, media, NULL, fragmentDuration, curlInstance);
+				}
 				double positionInPeriod = 0;
 				if(pMediaStreamContext->lastSegmentNumber > startNumber)
 				{
@@ -2265,6 +2419,34 @@ void StreamAbstractionAAMP_MPD::ApplyLiveOffsetWorkaroundForSAP( double seekPosi
 	}
 }
 
+/**
+ * @brief Get SegmentTimeline index of a track, built once per MPD update
+ */
+const AampTimelineIndex& StreamAbstractionAAMP_MPD::GetTimelineIndex( MediaStreamContext *pMediaStreamContext, const ISegmentTimeline *segmentTimeline, uint32_t timeScale)
+{
+	AampTimelineIndex &index = pMediaStreamContext->timelineIndex;
+	std::vector<ITimeline *>&timelines = segmentTimeline->GetTimelines();
+	if (!index.IsBuiltFor(segmentTimeline, mManifestUpdateCount, timelines.size(), timeScale))
+	{
+		std::vector<AampTimelineEntry> entries(timelines.size());
+		for (size_t i = 0; i < timelines.size(); i++)
+		{
+			ITimeline *timeline = timelines.at(i);
+			map<string, string> attributeMap = timeline->GetRawAttributes();
+			if (attributeMap.find("t") != attributeMap.end())
+			{
+				entries[i].startTime = timeline->GetStartTime();
+				entries[i].hasStartTime = true;
+			}
+			entries[i].duration = timeline->GetDuration();
+			entries[i].repeatCount = timeline->GetRepeatCount();
+		}
+		index.Build(entries, timeScale, segmentTimeline, mManifestUpdateCount);
+		AAMPLOG_TRACE("Type[%d] timeline index built, entries:%zu fragments:%" PRIu64, pMediaStreamContext->type, timelines.size(), index.GetFragmentCount());
+	}
+	return index;
+}
+
 /**
  * @brief Skip to end of track
  */
@@ -2281,13 +2463,8 @@ void StreamAbstractionAAMP_MPD::SkipToEnd( MediaStreamContext *pMediaStreamConte
 			std::vector<ITimeline *>&timelines = segmentTimeline->GetTimelines();
 			if(!timelines.empty())
 			{
-				uint32_t repeatCount = 0;
-				for(int i = 0; i < timelines.size(); i++)
-				{
-					ITimeline *timeline = timelines.at(i);
-					repeatCount += (timeline->GetRepeatCount() + 1);
-				}
-				pMediaStreamContext->fragmentDescriptor.Number = pMediaStreamContext->fragmentDescriptor.Number + repeatCount - 1;
+				const AampTimelineIndex &index = GetTimelineIndex(pMediaStreamContext, segmentTimeline, segmentTemplates.GetTimescale());
+				pMediaStreamContext->fragmentDescriptor.Number = pMediaStreamContext->fragmentDescriptor.Number + index.GetFragmentCount() - 1;
 				pMediaStreamContext->timeLineIndex = timelines.size() - 1;
 				pMediaStreamContext->fragmentRepeatCount = timelines.at(pMediaStreamContext->timeLineIndex)->GetRepeatCount();
 			}
@@ -2404,6 +2581,50 @@ double StreamAbstractionAAMP_MPD::SkipFragments( MediaStreamContext *pMediaStrea
 						mFirstFragPTS[pMediaStreamContext->mediaType] = firstPTS;
 					}
 
+					if ((skipToEnd || skipTime >= fragmentDuration) && pMediaStreamContext->fragmentRepeatCount >= 0 &&
+						(uint32_t)pMediaStreamContext->fragmentRepeatCount <= repeatCount)
+					{ // jump through timeline index instead of stepping each fragment
+						const AampTimelineIndex &index = GetTimelineIndex(pMediaStreamContext, segmentTimeline, timeScale);
+						int currentIndex = pMediaStreamContext->timeLineIndex;
+						int currentRepeat = pMediaStreamContext->fragmentRepeatCount;
+						uint64_t current = index.GetOrdinal(currentIndex, currentRepeat);
+						uint64_t target = index.GetFragmentCount() - 1;
+						if (!skipToEnd)
+						{
+							// stop one fragment short of target, so that stepping below settles rounding at fragment boundaries
+							target = index.FindFragmentBySeconds(index.GetOffsetSeconds(currentIndex, currentRepeat) + skipTime);
+							target = (target > 0) ? (target - 1) : 0;
+						}
+						if (target > current)
+						{
+							int targetIndex = 0;
+							int targetRepeat = 0;
+							index.GetPosition(target, targetIndex, targetRepeat);
+							double offset = index.GetOffsetSeconds(targetIndex, targetRepeat) - index.GetOffsetSeconds(currentIndex, currentRepeat);
+							if (index.HasStartTimeBetween(currentIndex, targetIndex))
+							{
+								pMediaStreamContext->fragmentDescriptor.Time = index.GetStartTime(targetIndex, targetRepeat);
+							}
+							else
+							{
+								pMediaStreamContext->fragmentDescriptor.Time += (index.GetStartTime(targetIndex, targetRepeat) - index.GetStartTime(currentIndex, currentRepeat));
+							}
+							pMediaStreamContext->fragmentDescriptor.Number += (target - current);
+							pMediaStreamContext->fragmentTime += offset;
+							if (skipToEnd)
+							{
+								pMediaStreamContext->fragmentTime = ceil(pMediaStreamContext->fragmentTime * 1000.0) / 1000.0;
+							}
+							else
+							{
+								skipTime -= offset;
+							}
+							pMediaStreamContext->timeLineIndex = targetIndex;
+							pMediaStreamContext->fragmentRepeatCount = targetRepeat;
+							continue;
+						}
+					}
+
 					if (skipToEnd)
 					{
 						if ((pMediaStreamContext->fragmentRepeatCount == repeatCount) &&
@@ -2818,6 +3039,201 @@ static void AddAttributesToNode(xmlTextReaderPtr *reader, Node *node)
 
 
 
+/**
+ * @struct MPDParseContext
+ * @brief State shared by all nodes of one manifest parse
+ */
+struct MPDParseContext
+{
+	std::string mpdPath;					/**< Directory path of manifest url, same for every node */
+	bool isAd;						/**< Manifest is an ad, period ids are made unique */
+	std::vector<MPDPeriodText> *periodTexts;		/**< Period elements of manifest text, NULL if periods are not reused */
+	std::map<std::string, MPDCachedPeriod> *cachedPeriods;	/**< Periods of current MPD by Period@id */
+	std::vector<MPDCachedPeriod *> reusedPeriods;		/**< Cached period spliced in for each top level Period read, NULL if parsed */
+	int reusedCount;					/**< Number of Periods spliced in from cache */
+	bool skipped;						/**< Reader was moved past a spliced Period by xmlTextReaderNext */
+	int skipResult;						/**< Return value of xmlTextReaderNext */
+
+	MPDParseContext(const std::string &path, bool ad) : mpdPath(path), isAd(ad), periodTexts(NULL), cachedPeriods(NULL),
+		reusedPeriods(), reusedCount(0), skipped(false), skipResult(0)
+	{
+	}
+};
+
+static Node* ProcessNode(xmlTextReaderPtr *reader, MPDParseContext &context);
+
+/**
+ * @brief Find top level Period elements in manifest text
+ *
+ * Periods do not nest, so each element spans from its start tag to the next Period end tag.
+ * Elements the scan gets wrong (e.g. inside comments) only fail to match the reader and are parsed normally.
+ * Element text is not hashed here, see GetPeriodDigest.
+ * @param ptr manifest text
+ * @param len manifest length
+ * @param[out] periodTexts Period elements in document order
+ */
+static void FindPeriodTexts(const char *ptr, size_t len, std::vector<MPDPeriodText> &periodTexts)
+{
+	static const char startTag[] = "<Period";
+	static const char endTag[] = "</Period>";
+	const char *end = ptr + len;
+	const char *pos = (const char *)memmem(ptr, len, startTag, sizeof(startTag) - 1);
+	while (pos != NULL)
+	{
+		const char *nameEnd = pos + sizeof(startTag) - 1;
+		if (nameEnd == end)
+		{
+			break;
+		}
+		if (!isspace((unsigned char)*nameEnd) && *nameEnd != '>' && *nameEnd != '/')
+		{
+			// PeriodXXX element
+			pos = (const char *)memmem(nameEnd, end - nameEnd, startTag, sizeof(startTag) - 1);
+			continue;
+		}
+		const char *tagEnd = (const char *)memchr(nameEnd, '>', end - nameEnd);
+		if (tagEnd == NULL)
+		{
+			break;
+		}
+		const char *elementEnd = tagEnd + 1;
+		if (*(tagEnd - 1) != '/')
+		{
+			elementEnd = (const char *)memmem(tagEnd, end - tagEnd, endTag, sizeof(endTag) - 1);
+			if (elementEnd == NULL)
+			{
+				break;
+			}
+			elementEnd += sizeof(endTag) - 1;
+		}
+
+		MPDPeriodText periodText;
+		for (const char *attr = nameEnd; attr + 5 < tagEnd; attr++)
+		{
+			if (isspace((unsigned char)attr[0]) && attr[1] == 'i' && attr[2] == 'd' && attr[3] == '=' && (attr[4] == '"' || attr[4] == '\''))
+			{
+				const char *idEnd = (const char *)memchr(attr + 5, attr[4], tagEnd - (attr + 5));
+				if (idEnd != NULL)
+				{
+					periodText.id.assign(attr + 5, idEnd);
+				}
+				break;
+			}
+		}
+		periodText.ptr = pos;
+		periodText.length = elementEnd - pos;
+		periodTexts.push_back(periodText);
+		pos = (const char *)memmem(elementEnd, end - elementEnd, startTag, sizeof(startTag) - 1);
+	}
+}
+
+/**
+ * @brief Get hash of Period element text, computed on first use
+ *
+ * Only Periods whose id and length match a cached one, and Periods about to be cached, are hashed.
+ * @param periodText Period element of manifest text
+ * @retval FNV-1a over 64 bit words, with a shift to mix high bits down
+ */
+static uint64_t GetPeriodDigest(MPDPeriodText &periodText)
+{
+	if (periodText.digest == 0)
+	{
+		uint64_t digest = 14695981039346656037ULL;
+		const char *ptr = periodText.ptr;
+		const char *end = ptr + periodText.length;
+		for (; ptr + sizeof(uint64_t) <= end; ptr += sizeof(uint64_t))
+		{
+			uint64_t word;
+			memcpy(&word, ptr, sizeof(word));
+			digest = (digest ^ word) * 1099511628211ULL;
+			digest ^= digest >> 32;
+		}
+		for (; ptr < end; ptr++)
+		{
+			digest = (digest ^ (unsigned char)*ptr) * 1099511628211ULL;
+		}
+		periodText.digest = digest;
+	}
+	return periodText.digest;
+}
+
+/**
+ * @brief Put cached periods in place of the ones converted from their spliced nodes
+ *
+ * Cached periods are owned by the current MPD until ReleaseSharedPeriods hands them over.
+ * @param mpd MPD converted from parsed manifest
+ * @param reusedPeriods cached period spliced in for each Period node, NULL if parsed
+ */
+static void ShareReusedPeriods(MPD *mpd, const std::vector<MPDCachedPeriod *> &reusedPeriods)
+{
+	std::vector<IPeriod *> &periods = const_cast<std::vector<IPeriod *> &>(mpd->GetPeriods());
+	for (size_t idx = 0; idx < periods.size() && idx < reusedPeriods.size(); idx++)
+	{
+		if (reusedPeriods[idx])
+		{
+			delete periods[idx];
+			periods[idx] = reusedPeriods[idx]->period;
+		}
+	}
+}
+
+/**
+ * @brief Collect top level Period nodes and remove spliced cached ones from root
+ *
+ * Spliced nodes are owned by the cache, so they must be removed before root is deleted.
+ * @param root root node of parsed manifest
+ * @param reusedPeriods cached period spliced in for each Period node, NULL if parsed
+ * @param[out] periodNodes Period nodes in document order, spliced ones included
+ */
+static void DetachReusedPeriodNodes(Node *root, const std::vector<MPDCachedPeriod *> &reusedPeriods, std::vector<Node *> &periodNodes)
+{
+	std::vector<Node *> &subNodes = const_cast<std::vector<Node *> &>(root->GetSubNodes());
+	size_t retained = 0;
+	for (size_t idx = 0; idx < subNodes.size(); idx++)
+	{
+		Node *subNode = subNodes[idx];
+		if (subNode->GetName() == "Period")
+		{
+			size_t periodIndex = periodNodes.size();
+			periodNodes.push_back(subNode);
+			if (periodIndex < reusedPeriods.size() && reusedPeriods[periodIndex])
+			{
+				continue;
+			}
+		}
+		subNodes[retained++] = subNode;
+	}
+	subNodes.resize(retained);
+}
+
+/**
+ * @brief Copy Period attributes and all children but AdaptationSets
+ *
+ * AdaptationSets are only read from the converted period, FindTimedMetadata needs the rest.
+ * @param periodNode parsed Period node
+ * @param mpdPath directory path of manifest url
+ * @retval new node
+ */
+static Node* CopyPeriodMetadataNode(const Node *periodNode, const std::string &mpdPath)
+{
+	Node *node = new Node();
+	node->SetType(XML_READER_TYPE_ELEMENT);
+	node->SetMPDPath(mpdPath);
+	node->SetName(periodNode->GetName());
+	for (const std::string &key : periodNode->GetAttributeKeys())
+	{
+		node->AddAttribute(key, periodNode->GetAttributeValue(key));
+	}
+	for (Node *subNode : periodNode->GetSubNodes())
+	{
+		if (subNode->GetName() != "AdaptationSet")
+		{
+			node->AddSubNode(new Node(*subNode));
+		}
+	}
+	return node;
+}
+
 /**
  * @brief Get mpd object of manifest
  * @retval AAMPStatusType indicates if success or fail
@@ -2826,18 +3242,47 @@ AAMPStatusType StreamAbstractionAAMP_MPD::GetMpdFromManfiest(const GrowableBuffe
 {
 	FN_TRACE_F_MPD( __FUNCTION__ );
 	AAMPStatusType ret = eAAMPSTATUS_GENERIC_ERROR;
+	bool incrementalParse = ISCONFIGSET(eAAMPConfig_MpdIncrementalParse);
+	std::string mpdPath = Path::GetDirectoryPath(manifestUrl);
+	std::vector<MPDPeriodText> periodTexts;
+	if (!incrementalParse || mpdPath != mCachedPeriodsPath)
+	{
+		// cached periods resolved against another manifest location are not reused
+		ClearCachedPeriods();
+		mCachedPeriodsPath = mpdPath;
+	}
+	if (incrementalParse)
+	{
+		FindPeriodTexts(manifest.ptr, manifest.len, periodTexts);
+	}
+	mSharedPeriodCount = 0;
 	xmlTextReaderPtr reader = xmlReaderForMemory(manifest.ptr, (int) manifest.len, NULL, NULL, 0);
 	if (reader != NULL)
 	{
 		if (xmlTextReaderRead(reader))
 		{
-			Node *root = aamp_ProcessNode(&reader, manifestUrl);
+			MPDParseContext context(mpdPath, false);
+			if (incrementalParse && !mCachedPeriods.empty())
+			{
+				for (auto &cachedPeriod : mCachedPeriods)
+				{
+					cachedPeriod.second.reused = false;
+				}
+				context.periodTexts = &periodTexts;
+				context.cachedPeriods = &mCachedPeriods;
+			}
+			Node *root = ProcessNode(&reader, context);
 			if(root != NULL)
 			{
 				uint32_t fetchTime = Time::GetCurrentUTCTimeInSec();
 				mpd = root->ToMPD();
 				if (mpd)
 				{
+					if (context.reusedCount > 0)
+					{
+						ShareReusedPeriods(mpd, context.reusedPeriods);
+						mSharedPeriodCount = context.reusedCount;
+					}
 					mpd->SetFetchTime(fetchTime);
 #if 1
 					bool bMetadata = ISCONFIGSET(eAAMPConfig_BulkTimedMetaReport);
@@ -2873,6 +3318,16 @@ AAMPStatusType StreamAbstractionAAMP_MPD::GetMpdFromManfiest(const GrowableBuffe
 				{
 					ret = AAMPStatusType::eAAMPSTATUS_MANIFEST_CONTENT_ERROR;
 				}
+				if (incrementalParse)
+				{
+					std::vector<Node *> periodNodes;
+					DetachReusedPeriodNodes(root, context.reusedPeriods, periodNodes);
+					if (mpd)
+					{
+						AAMPLOG_INFO("Shared %d of %zu periods with previous manifest", context.reusedCount, periodNodes.size());
+						UpdateCachedPeriods(periodNodes, mpd, periodTexts, context.reusedPeriods);
+					}
+				}
 				SAFE_DELETE(root);
 			}
 			else if (root == NULL)
@@ -2890,12 +3345,135 @@ AAMPStatusType StreamAbstractionAAMP_MPD::GetMpdFromManfiest(const GrowableBuffe
 	return ret;
 }
 
+/**
+ * @brief Cache all but last Period of a parsed manifest for next refresh
+ *
+ * Last period is the one growing on a live manifest, so it is not worth caching.
+ * Cache holds the converted period, owned by the MPD, and a copy of the Period node without its AdaptationSets.
+ */
+void StreamAbstractionAAMP_MPD::UpdateCachedPeriods(const std::vector<Node *> &periodNodes, MPD *mpd, std::vector<MPDPeriodText> &periodTexts, const std::vector<MPDCachedPeriod *> &reusedPeriods)
+{
+	std::map<std::string, MPDCachedPeriod> cachedPeriods;
+	const std::vector<IPeriod *> &periods = mpd->GetPeriods();
+	for (size_t idx = 0; idx + 1 < periodNodes.size() && idx < periods.size() && idx < periodTexts.size(); idx++)
+	{
+		MPDPeriodText &periodText = periodTexts[idx];
+		Node *periodNode = periodNodes[idx];
+		if (periodText.id.empty() || periodNode->GetAttributeValue("id") != periodText.id || cachedPeriods.count(periodText.id))
+		{
+			// text scan does not match parsed periods, or duplicate id
+			continue;
+		}
+		MPDCachedPeriod &cachedPeriod = cachedPeriods[periodText.id];
+		MPDCachedPeriod *reusedPeriod = (idx < reusedPeriods.size()) ? reusedPeriods[idx] : NULL;
+		if (reusedPeriod)
+		{
+			// take over, old entries are freed below
+			cachedPeriod = *reusedPeriod;
+			reusedPeriod->node = NULL;
+		}
+		else
+		{
+			cachedPeriod.digest = GetPeriodDigest(periodText);
+			cachedPeriod.length = periodText.length;
+			cachedPeriod.node = CopyPeriodMetadataNode(periodNode, mCachedPeriodsPath);
+		}
+		cachedPeriod.period = periods[idx];
+		cachedPeriod.reused = false;
+	}
+	ClearCachedPeriods();
+	mCachedPeriods.swap(cachedPeriods);
+}
+
+/**
+ * @brief Free nodes of periods cached for incremental parse
+ */
+void StreamAbstractionAAMP_MPD::ClearCachedPeriods()
+{
+	for (auto &cachedPeriod : mCachedPeriods)
+	{
+		SAFE_DELETE(cachedPeriod.second.node);
+	}
+	mCachedPeriods.clear();
+}
+
+/**
+ * @brief Remove periods shared with refreshed MPD from previous one, so deleting it leaves them alive
+ */
+void StreamAbstractionAAMP_MPD::ReleaseSharedPeriods(MPD *oldMpd, MPD *newMpd)
+{
+	if (mSharedPeriodCount == 0)
+	{
+		return;
+	}
+	const std::vector<IPeriod *> &newPeriods = newMpd->GetPeriods();
+	std::set<IPeriod *> sharedPeriods(newPeriods.begin(), newPeriods.end());
+	std::vector<IPeriod *> &oldPeriods = const_cast<std::vector<IPeriod *> &>(oldMpd->GetPeriods());
+	oldPeriods.erase(std::remove_if(oldPeriods.begin(), oldPeriods.end(), [&sharedPeriods](IPeriod *period) { return sharedPeriods.count(period) != 0; }), oldPeriods.end());
+}
+
 /**
  * @brief Get xml node form reader
  *
  * @retval xml node
  */
 Node* aamp_ProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd)
+{
+	MPDParseContext context(Path::GetDirectoryPath(url), isAd);
+	return ProcessNode(reader, context);
+}
+
+/**
+ * @brief Get cached node of a top level Period unchanged since previous manifest
+ *
+ * On success the reader is moved past the Period with xmlTextReaderNext, so no node is built for
+ * its subtree. The subtree text is still read by libxml2.
+ * @retval cached node to splice in by reference, NULL if Period has to be parsed
+ */
+static Node* GetCachedPeriodNode(xmlTextReaderPtr *reader, MPDParseContext &context)
+{
+	size_t periodIndex = context.reusedPeriods.size();
+	context.reusedPeriods.push_back(NULL);
+	if (context.periodTexts == NULL || periodIndex >= context.periodTexts->size())
+	{
+		return NULL;
+	}
+	MPDPeriodText &periodText = (*context.periodTexts)[periodIndex];
+	std::map<std::string, MPDCachedPeriod>::iterator it = context.cachedPeriods->find(periodText.id);
+	if (it == context.cachedPeriods->end())
+	{
+		return NULL;
+	}
+	MPDCachedPeriod &cachedPeriod = it->second;
+	if (cachedPeriod.reused || cachedPeriod.length != periodText.length || cachedPeriod.digest != GetPeriodDigest(periodText))
+	{
+		return NULL;
+	}
+	// Text scan and reader must agree on which Period this is
+	xmlChar *id = xmlTextReaderGetAttribute(*reader, (const xmlChar *)"id");
+	bool sameId = (id != NULL && periodText.id == (const char *)id);
+	if (id)
+	{
+		xmlFree(id);
+	}
+	if (!sameId)
+	{
+		return NULL;
+	}
+	cachedPeriod.reused = true;
+	context.reusedPeriods.back() = &cachedPeriod;
+	context.reusedCount++;
+	context.skipResult = xmlTextReaderNext(*reader);
+	context.skipped = true;
+	return cachedPeriod.node;
+}
+
+/**
+ * @brief Get xml node form reader
+ *
+ * @retval xml node
+ */
+static Node* ProcessNode(xmlTextReaderPtr *reader, MPDParseContext &context)
 {
 	//FN_TRACE_F_MPD( __FUNCTION__ );
 	int type = xmlTextReaderNodeType(*reader);
@@ -2911,24 +3489,32 @@ Node* aamp_ProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd)
 			type = xmlTextReaderNodeType(*reader);
 		}
 
-		Node *node = new Node();
-		node->SetType(type);
-		node->SetMPDPath(Path::GetDirectoryPath(url));
-
 		const char *name = (const char *)xmlTextReaderConstName(*reader);
 		if (name == NULL)
 		{
-			SAFE_DELETE(node);
 			return NULL;
 		}
 
+		if (!context.isAd && xmlTextReaderDepth(*reader) == 1 && !strcmp("Period", name))
+		{
+			Node *cachedNode = GetCachedPeriodNode(reader, context);
+			if (cachedNode)
+			{
+				return cachedNode;
+			}
+		}
+
+		Node *node = new Node();
+		node->SetType(type);
+		node->SetMPDPath(context.mpdPath);
+
 		int         isEmpty = xmlTextReaderIsEmptyElement(*reader);
 
 		node->SetName(name);
 
 		AddAttributesToNode(reader, node);
 
-		if(isAd && !strcmp("Period", name))
+		if(context.isAd && !strcmp("Period", name))
 		{
 			//Making period ids unique. It needs for playing same ad back to back.
 			static int UNIQ_PID = 0;
@@ -2956,12 +3542,21 @@ Node* aamp_ProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd)
 
 			if(subnodeType != Comment && subnodeType != WhiteSpace)
 			{
-				subnode = aamp_ProcessNode(reader, url, isAd);
+				subnode = ProcessNode(reader, context);
 				if (subnode != NULL)
 					node->AddSubNode(subnode);
 			}
 
-			ret = xmlTextReaderRead(*reader);
+			if (context.skipped)
+			{
+				// reader is already past a spliced Period
+				context.skipped = false;
+				ret = context.skipResult;
+			}
+			else
+			{
+				ret = xmlTextReaderRead(*reader);
+			}
 			subnodeType = xmlTextReaderNodeType(*reader);
 		}
 
@@ -4169,6 +4764,7 @@ AAMPStatusType StreamAbstractionAAMP_MPD::Init(TuneType tuneType)
 	//Clear previously stored vss early period ids
 		mEarlyAvailablePeriodIds.clear();
 		mEarlyAvailableKeyIDMap.clear();
+		std::lock_guard<std::mutex> lock(mPendingKeyIDsMutex);
 		while(!mPendingKeyIDs.empty())
 			mPendingKeyIDs.pop();
 	}
@@ -4844,6 +5440,7 @@ AAMPStatusType StreamAbstractionAAMP_MPD::Init(TuneType tuneType)
 		}
 #endif
 
+		PrefetchTuneFragments();
 		AAMPLOG_WARN("StreamAbstractionAAMP_MPD: fetch initialization fragments");
 		FetchAndInjectInitFragments();
 	}
@@ -5057,6 +5654,8 @@ bool StreamAbstractionAAMP_MPD::IsPeriodEncrypted(IPeriod *period)
  */
 AAMPStatusType StreamAbstractionAAMP_MPD::UpdateMPD(bool init)
 {
+	// download and parse, on tune as well as on refresh
+	AampTraceSpan traceSpan("playlist", "manifest_refresh", "init", init);
 	GrowableBuffer manifest;
 	AAMPStatusType ret = AAMPStatusType::eAAMPSTATUS_OK;
 	std::string manifestUrl = aamp->GetManifestUrl();
@@ -5066,8 +5665,13 @@ AAMPStatusType StreamAbstractionAAMP_MPD::UpdateMPD(bool init)
 	bool gotManifest = false;
 	bool retrievedPlaylistFromCache = false;
 	memset(&manifest, 0, sizeof(manifest));
-	if (aamp->getAampCacheHandler()->RetrieveFromPlaylistCache(manifestUrl, &manifest, manifestUrl))
+	// Cached manifest is only parsed, so it is borrowed instead of copied
+	AampCachedFilePtr cachedManifest = aamp->getAampCacheHandler()->BorrowFromPlaylistCache(manifestUrl);
+	if (cachedManifest)
 	{
+		manifest.ptr = const_cast<char *>(cachedManifest->data.data());
+		manifest.len = manifest.avail = cachedManifest->data.size();
+		manifestUrl = cachedManifest->effectiveUrl;
 		AAMPLOG_WARN("StreamAbstractionAAMP_MPD: manifest retrieved from cache");
 		retrievedPlaylistFromCache = true;
 	}
@@ -5144,9 +5748,11 @@ AAMPStatusType StreamAbstractionAAMP_MPD::UpdateMPD(bool init)
 			}
 			if (this->mpd)
 			{
+				ReleaseSharedPeriods(this->mpd, mpd);
 				SAFE_DELETE(this->mpd);
 			}
 			this->mpd = mpd;
+			mManifestUpdateCount++;
 			if(aamp->mIsVSS)
 			{
 				CheckForVssTags();
@@ -5161,7 +5767,15 @@ AAMPStatusType StreamAbstractionAAMP_MPD::UpdateMPD(bool init)
 			AAMPLOG_WARN("Error while processing MPD, GetMpdFromManfiest returned %d", ret);
 			retrievedPlaylistFromCache = false;
 		}
-		aamp_Free(&manifest);
+		if (cachedManifest)
+		{
+			// borrowed buffer is owned by cache
+			manifest.ptr = NULL;
+		}
+		else
+		{
+			aamp_Free(&manifest);
+		}
 		mLastPlaylistDownloadTimeMs = aamp_GetCurrentTimeMS();
 		if(mIsLiveStream && ISCONFIGSET(eAAMPConfig_EnableClientDai))
 		{
@@ -6266,95 +6880,75 @@ void StreamAbstractionAAMP_MPD::UpdateLanguageList()
 void StreamAbstractionAAMP_MPD::ProcessEAPLicenseRequest()
 {
 	FN_TRACE_F_MPD( __FUNCTION__ );
+	std::lock_guard<std::mutex> lock(mPendingKeyIDsMutex);
 	AAMPLOG_TRACE("Processing License request for pending KeyIDs: %d", mPendingKeyIDs.size());
-	if(!deferredDRMRequestThreadStarted)
+	if(mPendingKeyIDs.empty())
 	{
-		// wait for thread to complete and create a new thread
-		if ((deferredDRMRequestThread != NULL) && (deferredDRMRequestThread->joinable()))
-		{
-			//Need to check if we ever hit this code block, there is a possible delay
-			//since mAbortDeferredLicenseLoop is not updated. Add a log for now for monitoring
-			AAMPLOG_INFO("Trying to join deferred DRM request thread with possible time delay!");
-			deferredDRMRequestThread->join();
-			SAFE_DELETE(deferredDRMRequestThread);
-		}
-
-		if(NULL == deferredDRMRequestThread)
-		{
-			AAMPLOG_INFO("New Deferred DRM License thread starting");
-			mAbortDeferredLicenseLoop = false;
-			deferredDRMRequestThread = new std::thread(&StreamAbstractionAAMP_MPD::StartDeferredDRMRequestThread, this, eMEDIATYPE_VIDEO);
-			deferredDRMRequestThreadStarted = true;
-		}
+		return;
+	}
+	if(AAMP_REACTOR_TASK_ID_INVALID == deferredDRMRequestTaskId)
+	{
+		AAMPLOG_INFO("New Deferred DRM License task scheduled");
+		mAbortDeferredLicenseLoop = false;
+		mDeferredKeyWaited = false;
+		deferredDRMRequestTaskId = AampReactor::GetInstance().Schedule("DeferredDRMRequest", 0,
+				std::bind(&StreamAbstractionAAMP_MPD::ProcessDeferredDRMRequest, this, eMEDIATYPE_VIDEO));
 	}
 	else
 	{
-		AAMPLOG_TRACE("Diferred License Request Thread already running");
+		AAMPLOG_TRACE("Diferred License Request task already scheduled");
 	}
 }
 
 
 /**
- * @brief Start Deferred License Request
+ * @brief Process Deferred License Request of first pending key ID
  */
-void StreamAbstractionAAMP_MPD::StartDeferredDRMRequestThread(MediaType mediaType)
+int StreamAbstractionAAMP_MPD::ProcessDeferredDRMRequest(MediaType mediaType)
 {
 	FN_TRACE_F_MPD( __FUNCTION__ );
-	int deferTime;
-	bool exitLoop = false;
-	// Start tread
-	do
+	std::string keyID;
 	{
-		// Wait for KeyID entry in queue
-		if(mPendingKeyIDs.empty())
+		std::lock_guard<std::mutex> lock(mPendingKeyIDsMutex);
+		if(mPendingKeyIDs.empty() || mAbortDeferredLicenseLoop)
 		{
-			if(mAbortDeferredLicenseLoop)
-			{
-				AAMPLOG_ERR("aborted");
-				break;
-			}
-			else
-			{
-				continue;
-			}
+			deferredDRMRequestTaskId = AAMP_REACTOR_TASK_ID_INVALID;
+			return AAMP_REACTOR_TASK_DONE;
 		}
-		else
+		keyID = mPendingKeyIDs.front();
+		if ((mCommonKeyDuration > 0) && !mDeferredKeyWaited)
 		{
-			deferTime = 0;
+			// TODO : Logic to share time for pending Key IDs
+			// (mCommonKeyDuration)/(mPendingKeyIds.size())
+			int deferTime = aamp_GetDeferTimeMs(mCommonKeyDuration);
+			AAMPLOG_TRACE("Deferring license request by %d ms", deferTime);
+			mDeferredKeyWaited = true;
+			return deferTime;
 		}
+		mDeferredKeyWaited = false;
+	}
 
-		// Process all pending key ID requests
-		while(!mPendingKeyIDs.empty())
-		{
-			std::string keyID = mPendingKeyIDs.front();
-			if (mCommonKeyDuration > 0)
-			{
-				// TODO : Logic to share time for pending Key IDs
-				// (mCommonKeyDuration)/(mPendingKeyIds.size())
-				deferTime = aamp_GetDeferTimeMs(mCommonKeyDuration);
-				// Going to sleep for deferred key process
-				aamp->InterruptableMsSleep(deferTime);
-				AAMPLOG_TRACE("sleep over for deferred time:%d", deferTime);
-			}
-
-			if((aamp->DownloadsAreEnabled()) && (!mEarlyAvailableKeyIDMap[keyID].isLicenseFailed))
-			{
-				AAMPLOG_TRACE("Processing License request after sleep");
-				// Process content protection with early created helper
-				ProcessVssContentProtection(mEarlyAvailableKeyIDMap[keyID].helper, mediaType);
-				mEarlyAvailableKeyIDMap[keyID].isLicenseProcessed = true;
-			}
-			else
-			{
-				AAMPLOG_ERR("Aborted");
-				exitLoop = true;
-				break;
-			}
-			// Remove processed keyID from FIFO queue
-			mPendingKeyIDs.pop();
-		}
+	if((aamp->DownloadsAreEnabled()) && (!mEarlyAvailableKeyIDMap[keyID].isLicenseFailed))
+	{
+		AAMPLOG_TRACE("Processing License request after deferred time");
+		// Process content protection with early created helper
+		ProcessVssContentProtection(mEarlyAvailableKeyIDMap[keyID].helper, mediaType);
+		mEarlyAvailableKeyIDMap[keyID].isLicenseProcessed = true;
+	}
+	else
+	{
+		AAMPLOG_ERR("Aborted");
+		std::lock_guard<std::mutex> lock(mPendingKeyIDsMutex);
+		deferredDRMRequestTaskId = AAMP_REACTOR_TASK_ID_INVALID;
+		return AAMP_REACTOR_TASK_DONE;
+	}
+	// Remove processed keyID from FIFO queue
+	std::lock_guard<std::mutex> lock(mPendingKeyIDsMutex);
+	if(!mPendingKeyIDs.empty() && (mPendingKeyIDs.front() == keyID))
+	{
+		mPendingKeyIDs.pop();
 	}
-	while(!exitLoop);
+	return 0;
 }
 #endif
 
@@ -8957,6 +9551,7 @@ void StreamAbstractionAAMP_MPD::FetcherLoop()
 										if ((retVal.second) && (!vssKeyPeriodInfo.isLicenseFailed))
 										{
 											// FIFO queue for processing license request
+											std::lock_guard<std::mutex> lock(mPendingKeyIDsMutex);
 											mPendingKeyIDs.push(keyIdDebugStr);
 										}
 										else
@@ -8975,12 +9570,8 @@ void StreamAbstractionAAMP_MPD::FetcherLoop()
 									}
 								}
 							}
-							// Proces EAP License request if there is pending keyIDs
-							if(!mPendingKeyIDs.empty())
-							{
-								// Check Deferred License thread status, and process license request
-								ProcessEAPLicenseRequest();
-							}
+							// Proces EAP License request, no effect without pending keyIDs
+							ProcessEAPLicenseRequest();
 						}
 #endif
 						mpdChanged = false;
@@ -9820,6 +10411,7 @@ StreamAbstractionAAMP_MPD::~StreamAbstractionAAMP_MPD()
 
 	aamp->SyncBegin();
 	SAFE_DELETE(mpd);
+	ClearCachedPeriods();
 
 	SAFE_DELETE_ARRAY(mStreamInfo);
 
@@ -9896,16 +10488,11 @@ void StreamAbstractionAAMP_MPD::Stop(bool clearChannelData)
 		}
 	}
 
-	if(latencyMonitorThreadStarted)
+	if(AAMP_REACTOR_TASK_ID_INVALID != latencyMonitorTaskId)
 	{
-		AAMPLOG_INFO("Waiting to join StartLatencyMonitorThread");
-		int rc = pthread_join(latencyMonitorThreadID, NULL);
-		if (rc != 0)
-		{
-			AAMPLOG_WARN("pthread_join returned %d for StartLatencyMonitorThread", rc);
-		}
-		AAMPLOG_INFO("Joined StartLatencyMonitorThread");
-		latencyMonitorThreadStarted = false;
+		AAMPLOG_INFO("Cancelling latency monitor");
+		AampReactor::GetInstance().Cancel(latencyMonitorTaskId);
+		latencyMonitorTaskId = AAMP_REACTOR_TASK_ID_INVALID;
 	}
 
 	if(fragmentCollectorThreadStarted)
@@ -9947,14 +10534,17 @@ void StreamAbstractionAAMP_MPD::Stop(bool clearChannelData)
 		drmSessionThreadStarted = false;
 	}
 
-	if(deferredDRMRequestThreadStarted)
+	int deferredTaskId;
 	{
-		if((deferredDRMRequestThread) && (deferredDRMRequestThread->joinable()))
-		{
-			mAbortDeferredLicenseLoop = true;
-			deferredDRMRequestThread->join();
-			SAFE_DELETE(deferredDRMRequestThread);
-		}
+		std::lock_guard<std::mutex> lock(mPendingKeyIDsMutex);
+		mAbortDeferredLicenseLoop = true;
+		deferredTaskId = deferredDRMRequestTaskId;
+	}
+	// waits for a license request in progress
+	if(AampReactor::GetInstance().Cancel(deferredTaskId))
+	{
+		std::lock_guard<std::mutex> lock(mPendingKeyIDsMutex);
+		deferredDRMRequestTaskId = AAMP_REACTOR_TASK_ID_INVALID;
 	}
 
 	aamp->mStreamSink->ClearProtectionEvent();
@@ -11755,201 +12345,149 @@ double StreamAbstractionAAMP_MPD::GetEncoderDisplayLatency()
 }
 
 /**
- * @brief Latency monitor thread
- * @param arg Pointer to FragmentCollector
- * @retval NULL
- */
-static void *LatencyMonitor(void *arg)
-{
-    FN_TRACE_F_MPD( __FUNCTION__ );
-    StreamAbstractionAAMP_MPD *stAbsAAMP_MPD = (StreamAbstractionAAMP_MPD *)arg;
-    if(aamp_pthread_setname(pthread_self(), "aampLatencyMonitor"))
-    {
-        AAMPLOG_WARN("aamp_pthread_setname failed");
-    }
-    AAMPLOG_WARN("LatencyMonitor -> Invoke MonitorLatency() ");
-    stAbsAAMP_MPD->MonitorLatency();
-    return NULL;
-}
-
-/**
- * @brief Starts Latency monitor loop
+ * @brief Starts Latency monitor task
  */
 void StreamAbstractionAAMP_MPD::StartLatencyMonitorThread()
 {
-    FN_TRACE_F_MPD( __FUNCTION__ );
-    assert(!latencyMonitorThreadStarted);
-    if (0 == pthread_create(&latencyMonitorThreadID, NULL, &LatencyMonitor, this))
-    {
-        latencyMonitorThreadStarted = true;
-        AAMPLOG_WARN("Latency monitor thread started");
-    }
-    else
-    {
-        AAMPLOG_WARN("Failed to create LatencyMonitor thread");
-    }
+	FN_TRACE_F_MPD( __FUNCTION__ );
+	assert(AAMP_REACTOR_TASK_ID_INVALID == latencyMonitorTaskId);
+	int latencyMonitorDelay = 0;
+	GETCONFIGVALUE(eAAMPConfig_LatencyMonitorDelay,latencyMonitorDelay);
+	AAMPLOG_INFO( "Speed correction state:%d", aamp->GetLLDashAdjustSpeed());
+	aamp->SetLLDashCurrentPlayBackRate(AAMP_NORMAL_PLAY_RATE);
+	latencyMonitorTaskId = AampReactor::GetInstance().Schedule("LatencyMonitor", latencyMonitorDelay * 1000,
+			std::bind(&StreamAbstractionAAMP_MPD::MonitorLatency, this));
+	if (AAMP_REACTOR_TASK_ID_INVALID != latencyMonitorTaskId)
+	{
+		AAMPLOG_WARN("Latency monitor task scheduled");
+	}
+	else
+	{
+		AAMPLOG_WARN("Failed to schedule LatencyMonitor task");
+	}
 }
 
 /**
  * @brief Monitor Live End Latency and Encoder Display Latency
  */
-void StreamAbstractionAAMP_MPD::MonitorLatency()
+int StreamAbstractionAAMP_MPD::MonitorLatency()
 {
 	FN_TRACE_F_MPD( __FUNCTION__ );
-	int latencyMonitorDelay = 0;
 	int latencyMonitorInterval = 0;
-	GETCONFIGVALUE(eAAMPConfig_LatencyMonitorDelay,latencyMonitorDelay);
 	GETCONFIGVALUE(eAAMPConfig_LatencyMonitorInterval,latencyMonitorInterval);
-
-	assert(latencyMonitorDelay >= latencyMonitorInterval);
-
-	AAMPLOG_TRACE("latencyMonitorDelay %d latencyMonitorInterval=%d", latencyMonitorDelay,latencyMonitorInterval );
-	unsigned int latencyMontiorScheduleTime = latencyMonitorDelay - latencyMonitorInterval;
-	bool keepRunning = false;
-	if(aamp->DownloadsAreEnabled())
-	{
-		AAMPLOG_TRACE("latencyMontiorScheduleTime %d", latencyMontiorScheduleTime );
-		aamp->InterruptableMsSleep(latencyMontiorScheduleTime *1000);
-		keepRunning = true;
-	}
-	AAMPLOG_TRACE("keepRunning : %d", keepRunning);
 	int monitorInterval = latencyMonitorInterval  * 1000;
-	AAMPLOG_INFO( "Speed correction state:%d", aamp->GetLLDashAdjustSpeed());
-
-	aamp->SetLLDashCurrentPlayBackRate(AAMP_NORMAL_PLAY_RATE);
-
-	while(keepRunning)
+	if (aamp->DownloadsAreEnabled())
 	{
-		aamp->InterruptableMsSleep(monitorInterval);
-		if (aamp->DownloadsAreEnabled())
+		double playRate = aamp->GetLLDashCurrentPlayBackRate();
+		if( aamp->GetPositionMs() > aamp->DurationFromStartOfPlaybackMs() )
 		{
-	
-			double playRate = aamp->GetLLDashCurrentPlayBackRate();
-			if( aamp->GetPositionMs() > aamp->DurationFromStartOfPlaybackMs() )
-			{
-				AAMPLOG_WARN("current position[%lld] must be less than Duration From Start Of Playback[%lld]!!!!:",aamp->GetPositionMs(), aamp->DurationFromStartOfPlaybackMs());
-			}
-			else
+			AAMPLOG_WARN("current position[%lld] must be less than Duration From Start Of Playback[%lld]!!!!:",aamp->GetPositionMs(), aamp->DurationFromStartOfPlaybackMs());
+		}
+		else
+		{
+			AampLLDashServiceData *pAampLLDashServiceData = NULL;
+			pAampLLDashServiceData = aamp->GetLLDashServiceData();
+			if( NULL != pAampLLDashServiceData )
 			{
-				monitorInterval = latencyMonitorInterval  * 1000;
-				AampLLDashServiceData *pAampLLDashServiceData = NULL;
-				pAampLLDashServiceData = aamp->GetLLDashServiceData();
-				if( NULL != pAampLLDashServiceData )
-				{
-					assert(pAampLLDashServiceData->minLatency != 0 );
-					assert(pAampLLDashServiceData->minLatency <= pAampLLDashServiceData->targetLatency);
-					assert(pAampLLDashServiceData->targetLatency !=0 );
-					assert(pAampLLDashServiceData->maxLatency !=0 );
-					assert(pAampLLDashServiceData->maxLatency >= pAampLLDashServiceData->targetLatency);
+				assert(pAampLLDashServiceData->minLatency != 0 );
+				assert(pAampLLDashServiceData->minLatency <= pAampLLDashServiceData->targetLatency);
+				assert(pAampLLDashServiceData->targetLatency !=0 );
+				assert(pAampLLDashServiceData->maxLatency !=0 );
+				assert(pAampLLDashServiceData->maxLatency >= pAampLLDashServiceData->targetLatency);
 
-					long InitialLatencyOffset =  ( aamp->GetDurationMs() - ( (long long) (aamp->mLLActualOffset*1000)));
-					long PlayBackLatency = ((aamp->DurationFromStartOfPlaybackMs()) - aamp->GetPositionMs() );
-					long TimeOffsetSeekLatency = (long)(((pAampLLDashServiceData->fragmentDuration - pAampLLDashServiceData->availabilityTimeOffset))*1000);
-					long currentLatency = ((InitialLatencyOffset+PlayBackLatency)-TimeOffsetSeekLatency);
+				long InitialLatencyOffset =  ( aamp->GetDurationMs() - ( (long long) (aamp->mLLActualOffset*1000)));
+				long PlayBackLatency = ((aamp->DurationFromStartOfPlaybackMs()) - aamp->GetPositionMs() );
+				long TimeOffsetSeekLatency = (long)(((pAampLLDashServiceData->fragmentDuration - pAampLLDashServiceData->availabilityTimeOffset))*1000);
+				long currentLatency = ((InitialLatencyOffset+PlayBackLatency)-TimeOffsetSeekLatency);
 
-					AAMPLOG_INFO("currentDur = %lld actualOffset=%ld DurationFromStart=%lld Position=%lld,seekLLValue=%ld",aamp->GetDurationMs(),
-									(long long) (aamp->mLLActualOffset*1000), aamp->DurationFromStartOfPlaybackMs(),aamp->GetPositionMs(), TimeOffsetSeekLatency);
-					AAMPLOG_INFO("LiveLatency=%ld currentPlayRate=%lf",currentLatency, playRate);
+				AAMPLOG_INFO("currentDur = %lld actualOffset=%ld DurationFromStart=%lld Position=%lld,seekLLValue=%ld",aamp->GetDurationMs(),
+								(long long) (aamp->mLLActualOffset*1000), aamp->DurationFromStartOfPlaybackMs(),aamp->GetPositionMs(), TimeOffsetSeekLatency);
+				AAMPLOG_INFO("LiveLatency=%ld currentPlayRate=%lf",currentLatency, playRate);
 
 #if 0
-					long encoderDisplayLatency = 0;
-					encoderDisplayLatency = (long)( GetEncoderDisplayLatency() * 1000)+currentLatency;
-					AAMPLOG_INFO("Encoder Display Latency=%ld", encoderDisplayLatency);
+				long encoderDisplayLatency = 0;
+				encoderDisplayLatency = (long)( GetEncoderDisplayLatency() * 1000)+currentLatency;
+				AAMPLOG_INFO("Encoder Display Latency=%ld", encoderDisplayLatency);
 #endif
-					//The minPlayback rate should be only <= AAMP_NORMAL_PLAY_RATE-0.20??
-					//The MaxPlayBack rate should be only >= AAMP_NORMAL_PLAY_RATE+0.20??
-					//Do we need to validate above?
-					if(ISCONFIGSET(eAAMPConfig_EnableLowLatencyCorrection) && 
-						pAampLLDashServiceData->minPlaybackRate !=0 && 
-						pAampLLDashServiceData->minPlaybackRate < pAampLLDashServiceData->maxPlaybackRate &&
-						pAampLLDashServiceData->minPlaybackRate < AAMP_NORMAL_PLAY_RATE && 
-						pAampLLDashServiceData->maxPlaybackRate !=0 && 
-						pAampLLDashServiceData->maxPlaybackRate > pAampLLDashServiceData->minPlaybackRate &&
-						pAampLLDashServiceData->maxPlaybackRate > AAMP_NORMAL_PLAY_RATE)
+				//The minPlayback rate should be only <= AAMP_NORMAL_PLAY_RATE-0.20??
+				//The MaxPlayBack rate should be only >= AAMP_NORMAL_PLAY_RATE+0.20??
+				//Do we need to validate above?
+				if(ISCONFIGSET(eAAMPConfig_EnableLowLatencyCorrection) && 
+					pAampLLDashServiceData->minPlaybackRate !=0 && 
+					pAampLLDashServiceData->minPlaybackRate < pAampLLDashServiceData->maxPlaybackRate &&
+					pAampLLDashServiceData->minPlaybackRate < AAMP_NORMAL_PLAY_RATE && 
+					pAampLLDashServiceData->maxPlaybackRate !=0 && 
+					pAampLLDashServiceData->maxPlaybackRate > pAampLLDashServiceData->minPlaybackRate &&
+					pAampLLDashServiceData->maxPlaybackRate > AAMP_NORMAL_PLAY_RATE)
+				{
+					if (currentLatency < (long)pAampLLDashServiceData->minLatency)
 					{
-						if (currentLatency < (long)pAampLLDashServiceData->minLatency)
-						{
-							//Yellow state(the latency is within range but less than mimium latency)
-							latencyStatus = LATENCY_STATUS_MIN;
-							AAMPLOG_INFO("latencyStatus = LATENCY_STATUS_MIN(%d)",latencyStatus);
-							playRate = pAampLLDashServiceData->minPlaybackRate;
-						}
-						else if ( ( currentLatency >= (long) pAampLLDashServiceData->minLatency ) &&
-							(  currentLatency <= (long)pAampLLDashServiceData->targetLatency) )
-						{
-							//Yellow state(the latency is within range but less than target latency but greater than minimum latency)
-							latencyStatus = LATENCY_STATUS_THRESHOLD_MIN;
-							AAMPLOG_INFO("latencyStatus = LATENCY_STATUS_THRESHOLD_MIN(%d)",latencyStatus);
-							playRate = AAMP_NORMAL_LL_PLAY_RATE;
-						}
-						else if ( currentLatency == (long)pAampLLDashServiceData->targetLatency )
-						{
-							//green state(No correction is requried. set the playrate to normal, the latency is equal to given latency from mpd)
-							latencyStatus = LATENCY_STATUS_THRESHOLD;
-							AAMPLOG_INFO("latencyStatus = LATENCY_STATUS_THRESHOLD(%d)",latencyStatus);
-							playRate = AAMP_NORMAL_LL_PLAY_RATE;
-						}
-						else if ( ( currentLatency >= (long)pAampLLDashServiceData->targetLatency ) &&
-							( currentLatency <= (long)pAampLLDashServiceData->maxLatency )  )
-						{
-							//Red state(The latency is more that target latency but less than maximum latency)
-							latencyStatus = LATENCY_STATUS_THRESHOLD_MAX;
-							AAMPLOG_INFO("latencyStatus = LATENCY_STATUS_THRESHOLD_MAX(%d)",latencyStatus);
-							playRate = AAMP_NORMAL_LL_PLAY_RATE;
-						}
-						else if (currentLatency > (long)pAampLLDashServiceData->maxLatency)
-						{
-							//Red state(The latency is more than maximum latency)
-							latencyStatus = LATENCY_STATUS_MAX; //Red state
-							AAMPLOG_INFO("latencyStatus = LATENCY_STATUS_MAX(%d)",latencyStatus);
-							playRate = pAampLLDashServiceData->maxPlaybackRate;
-						}
-						else //must not hit here
-						{
-							latencyStatus = LATENCY_STATUS_UNKNOWN; //Red state
-							AAMPLOG_WARN("latencyStatus = LATENCY_STATUS_UNKNOWN(%d)",latencyStatus);
-						}
+						//Yellow state(the latency is within range but less than mimium latency)
+						latencyStatus = LATENCY_STATUS_MIN;
+						AAMPLOG_INFO("latencyStatus = LATENCY_STATUS_MIN(%d)",latencyStatus);
+						playRate = pAampLLDashServiceData->minPlaybackRate;
+					}
+					else if ( ( currentLatency >= (long) pAampLLDashServiceData->minLatency ) &&
+						(  currentLatency <= (long)pAampLLDashServiceData->targetLatency) )
+					{
+						//Yellow state(the latency is within range but less than target latency but greater than minimum latency)
+						latencyStatus = LATENCY_STATUS_THRESHOLD_MIN;
+						AAMPLOG_INFO("latencyStatus = LATENCY_STATUS_THRESHOLD_MIN(%d)",latencyStatus);
+						playRate = AAMP_NORMAL_LL_PLAY_RATE;
+					}
+					else if ( currentLatency == (long)pAampLLDashServiceData->targetLatency )
+					{
+						//green state(No correction is requried. set the playrate to normal, the latency is equal to given latency from mpd)
+						latencyStatus = LATENCY_STATUS_THRESHOLD;
+						AAMPLOG_INFO("latencyStatus = LATENCY_STATUS_THRESHOLD(%d)",latencyStatus);
+						playRate = AAMP_NORMAL_LL_PLAY_RATE;
+					}
+					else if ( ( currentLatency >= (long)pAampLLDashServiceData->targetLatency ) &&
+						( currentLatency <= (long)pAampLLDashServiceData->maxLatency )  )
+					{
+						//Red state(The latency is more that target latency but less than maximum latency)
+						latencyStatus = LATENCY_STATUS_THRESHOLD_MAX;
+						AAMPLOG_INFO("latencyStatus = LATENCY_STATUS_THRESHOLD_MAX(%d)",latencyStatus);
+						playRate = AAMP_NORMAL_LL_PLAY_RATE;
+					}
+					else if (currentLatency > (long)pAampLLDashServiceData->maxLatency)
+					{
+						//Red state(The latency is more than maximum latency)
+						latencyStatus = LATENCY_STATUS_MAX; //Red state
+						AAMPLOG_INFO("latencyStatus = LATENCY_STATUS_MAX(%d)",latencyStatus);
+						playRate = pAampLLDashServiceData->maxPlaybackRate;
+					}
+					else //must not hit here
+					{
+						latencyStatus = LATENCY_STATUS_UNKNOWN; //Red state
+						AAMPLOG_WARN("latencyStatus = LATENCY_STATUS_UNKNOWN(%d)",latencyStatus);
+					}
 
-						if ( playRate != aamp->GetLLDashCurrentPlayBackRate() )
-						{
-							bool rateCorrected=false;
+					if ( playRate != aamp->GetLLDashCurrentPlayBackRate() )
+					{
+						bool rateCorrected=false;
 
-							switch(latencyStatus)
+						switch(latencyStatus)
+						{
+							case LATENCY_STATUS_THRESHOLD_MIN:
 							{
-								case LATENCY_STATUS_THRESHOLD_MIN:
+								if ( pAampLLDashServiceData->maxPlaybackRate == aamp->GetLLDashCurrentPlayBackRate() )
 								{
-									if ( pAampLLDashServiceData->maxPlaybackRate == aamp->GetLLDashCurrentPlayBackRate() )
+									if(false == aamp->mStreamSink->SetPlayBackRate(playRate))
 									{
-										if(false == aamp->mStreamSink->SetPlayBackRate(playRate))
-										{
-											AAMPLOG_WARN("[LATENCY_STATUS_%d] SetPlayBackRate: failed, rate:%f", latencyStatus,playRate);
-										}
-										else
-										{
-											rateCorrected = true;
-											AAMPLOG_TRACE("[LATENCY_STATUS_%d] SetPlayBackRate: success", latencyStatus);
-										}
+										AAMPLOG_WARN("[LATENCY_STATUS_%d] SetPlayBackRate: failed, rate:%f", latencyStatus,playRate);
 									}
-								}
-								break;
-								case LATENCY_STATUS_THRESHOLD_MAX:
-								{
-									if ( pAampLLDashServiceData->minPlaybackRate == aamp->GetLLDashCurrentPlayBackRate() )
+									else
 									{
-										if(false == aamp->mStreamSink->SetPlayBackRate(playRate))
-										{
-											AAMPLOG_WARN("[LATENCY_STATUS_%d] SetPlayBackRate: failed, rate:%f", latencyStatus,playRate);
-										}
-										else
-										{
-											rateCorrected = true;
-											AAMPLOG_TRACE("[LATENCY_STATUS_%d] SetPlayBackRate: success", latencyStatus);
-										}
+										rateCorrected = true;
+										AAMPLOG_TRACE("[LATENCY_STATUS_%d] SetPlayBackRate: success", latencyStatus);
 									}
 								}
-								break;
-								case LATENCY_STATUS_MIN:
-								case LATENCY_STATUS_MAX:
+							}
+							break;
+							case LATENCY_STATUS_THRESHOLD_MAX:
+							{
+								if ( pAampLLDashServiceData->minPlaybackRate == aamp->GetLLDashCurrentPlayBackRate() )
 								{
 									if(false == aamp->mStreamSink->SetPlayBackRate(playRate))
 									{
@@ -11961,34 +12499,47 @@ void StreamAbstractionAAMP_MPD::MonitorLatency()
 										AAMPLOG_TRACE("[LATENCY_STATUS_%d] SetPlayBackRate: success", latencyStatus);
 									}
 								}
-								break;
-								case LATENCY_STATUS_THRESHOLD:
-								break;
-								default:
-								break;
 							}
-
-							if ( rateCorrected )
+							break;
+							case LATENCY_STATUS_MIN:
+							case LATENCY_STATUS_MAX:
 							{
-								aamp->SetLLDashCurrentPlayBackRate(playRate);
+								if(false == aamp->mStreamSink->SetPlayBackRate(playRate))
+								{
+									AAMPLOG_WARN("[LATENCY_STATUS_%d] SetPlayBackRate: failed, rate:%f", latencyStatus,playRate);
+								}
+								else
+								{
+									rateCorrected = true;
+									AAMPLOG_TRACE("[LATENCY_STATUS_%d] SetPlayBackRate: success", latencyStatus);
+								}
 							}
+							break;
+							case LATENCY_STATUS_THRESHOLD:
+							break;
+							default:
+							break;
+						}
+
+						if ( rateCorrected )
+						{
+							aamp->SetLLDashCurrentPlayBackRate(playRate);
 						}
 					}
 				}
-				else
-				{
-					AAMPLOG_WARN("ServiceDescription Element is empty");
-				}
+			}
+			else
+			{
+				AAMPLOG_WARN("ServiceDescription Element is empty");
 			}
 		}
-		else
-		{
-			AAMPLOG_WARN("Stopping Thread");
-			keepRunning = false;
-
-		}
 	}
-	AAMPLOG_WARN("Thread Done");
+	else
+	{
+		AAMPLOG_WARN("Stopping latency monitor");
+		monitorInterval = AAMP_REACTOR_TASK_DONE;
+	}
+	return monitorInterval;
 }
 
 /**
@@ -39,6 +39,7 @@
 #include <libxml/xmlreader.h>
 #include <thread>
 #include "admanager_mpd.h"
+#include "AampTimelineIndex.h"
 
 using namespace dash;
 using namespace std;
@@ -72,6 +73,39 @@ Node* aamp_ProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd = fa
  */
 uint64_t aamp_GetDurationFromRepresentation(dash::mpd::IMPD *mpd);
 
+/**
+ * @struct MPDPeriodText
+ * @brief Top level Period element found in manifest text
+ */
+struct MPDPeriodText
+{
+	std::string id;		/**< Period@id as found in the start tag */
+	const char *ptr;	/**< Start tag in manifest text */
+	size_t length;		/**< Length of the element text, start tag to end tag */
+	uint64_t digest;	/**< Hash of the element text, 0 until computed */
+
+	MPDPeriodText() : id(), ptr(NULL), length(0), digest(0)
+	{
+	}
+};
+
+/**
+ * @struct MPDCachedPeriod
+ * @brief Period of current MPD, shared with next refreshed MPD while its text is unchanged
+ */
+struct MPDCachedPeriod
+{
+	uint64_t digest;	/**< Hash of the element text */
+	size_t length;		/**< Length of the element text */
+	IPeriod *period;	/**< Converted period, owned by the MPD it is in */
+	Node *node;		/**< Period node without AdaptationSet subtrees, for timed metadata */
+	bool reused;		/**< Already spliced into the manifest being parsed */
+
+	MPDCachedPeriod() : digest(0), length(0), period(NULL), node(NULL), reused(false)
+	{
+	}
+};
+
 /**
  * @struct ProfileInfo
  * @brief Manifest file adaptation and representation info
@@ -351,6 +385,21 @@ public:
 	 * @param scale timeScale value from mpd
 	 */
 	bool FetchFragment( class MediaStreamContext *pMediaStreamContext, std::string media, double fragmentDuration, bool isInitializationSegment, unsigned int curlInstance, bool discontinuity = false, double pto = 0 , uint32_t scale = 0);
+	/**
+	 * @fn PrefetchNextFragments
+	 * @brief Queue lookahead downloads of fragments following the one just fetched on download engine
+	 * @param pMediaStreamContext Track object pointer, descriptor still refers to fetched fragment
+	 * @param media media descriptor string
+	 * @param timelines segment timeline entries, NULL if template has no timeline
+	 * @param fragmentDuration duration of fragment in seconds, used when there is no timeline
+	 * @param curlInstance curl instance used to fetch
+	 */
+	void PrefetchNextFragments( class MediaStreamContext *pMediaStreamContext, const std::string &media, const std::vector<ITimeline *> *timelines, double fragmentDuration, unsigned int curlInstance);
+	/**
+	 * @fn PrefetchTuneFragments
+	 * @brief Queue init fragment and first fragment of all enabled tracks on download engine once tracks are positioned
+	 */
+	void PrefetchTuneFragments();
 	/**
 	 * @fn PushNextFragment 
 	 * @param pMediaStreamContext Track object
@@ -361,7 +410,12 @@ public:
 	 * @fn GetFirstPeriodStartTime
 	 */
 	double GetFirstPeriodStartTime(void);
-	void MonitorLatency();
+	/**
+	 * @fn MonitorLatency
+	 * @brief One latency check, run by the reactor
+	 * @return ms until next check, AAMP_REACTOR_TASK_DONE once downloads stop
+	 */
+	int MonitorLatency();
 	void StartSubtitleParser() override;
 	void PauseSubtitleParser(bool pause) override;
 	/**
@@ -627,6 +681,14 @@ private:
 	 * @param pMediaStreamContext Track object pointer
  	 */
 	void SkipToEnd( class MediaStreamContext *pMediaStreamContext); //Added to support rewind in multiperiod assets
+	/**
+	 * @fn GetTimelineIndex
+	 * @param pMediaStreamContext Track object pointer
+	 * @param segmentTimeline SegmentTimeline of current representation
+	 * @param timeScale timescale of segment template
+	 * @return prefix sum index of the timeline, built once per MPD update
+	 */
+	const AampTimelineIndex& GetTimelineIndex( class MediaStreamContext *pMediaStreamContext, const ISegmentTimeline *segmentTimeline, uint32_t timeScale);
 	/**
 	 * @fn ProcessContentProtection 
 	 * @param adaptationSet Adaptation set object
@@ -694,6 +756,26 @@ private:
 	 * @param init true if this is the first playlist download for a tune/seek/trickplay
 	 */
 	AAMPStatusType GetMpdFromManfiest(const GrowableBuffer &manifest, MPD * &mpd, std::string manifestUrl, bool init = false);
+	/**
+	 * @fn UpdateCachedPeriods
+	 * @brief Cache all but last Period of a parsed manifest for next refresh
+	 * @param periodNodes top level Period nodes of parsed manifest
+	 * @param mpd MPD converted from parsed manifest
+	 * @param periodTexts top level Period elements found in manifest text
+	 * @param reusedPeriods cached period spliced in for each Period node, NULL if parsed
+	 */
+	void UpdateCachedPeriods(const std::vector<Node *> &periodNodes, MPD *mpd, std::vector<MPDPeriodText> &periodTexts, const std::vector<MPDCachedPeriod *> &reusedPeriods);
+	/**
+	 * @fn ClearCachedPeriods
+	 */
+	void ClearCachedPeriods();
+	/**
+	 * @fn ReleaseSharedPeriods
+	 * @brief Remove periods shared with refreshed MPD from previous one, so deleting it leaves them alive
+	 * @param oldMpd MPD about to be deleted
+	 * @param newMpd MPD replacing it
+	 */
+	void ReleaseSharedPeriods(MPD *oldMpd, MPD *newMpd);
 	/**
 	 * @fn GetDrmPrefs
 	 * @param The UUID for the DRM type
@@ -747,6 +829,7 @@ private:
 	double GetEncoderDisplayLatency();
 	/**
 	 * @fn StartLatencyMonitorThread
+	 * @brief Register latency monitor with the reactor
 	 * @return void
 	 */
 	void StartLatencyMonitorThread();
@@ -806,8 +889,8 @@ private:
 	float rate;
 	std::thread *fragmentCollectorThreadID;
 	pthread_t createDRMSessionThreadID;
-	std::thread *deferredDRMRequestThread;
-	bool deferredDRMRequestThreadStarted;
+	int deferredDRMRequestTaskId;		/**< Reactor task of deferred license requests, guarded by mPendingKeyIDsMutex */
+	bool mDeferredKeyWaited;		/**< Defer time of the first pending key ID has passed */
 	bool mAbortDeferredLicenseLoop;
 	bool drmSessionThreadStarted;
 	dash::mpd::IMPD *mpd;
@@ -851,6 +934,7 @@ private:
 	std::vector<std::string> mEarlyAvailablePeriodIds;
 	std::map<std::string, struct EarlyAvailablePeriodInfo> mEarlyAvailableKeyIDMap;
 	std::queue<std::string> mPendingKeyIDs;
+	std::mutex mPendingKeyIDsMutex;
 	int mCommonKeyDuration;
 
 	// DASH does not use abr manager to store the supported bandwidth values,
@@ -916,10 +1000,12 @@ private:
 	 */
 	void ProcessEAPLicenseRequest(void);
 	/**
-	 * @fn StartDeferredDRMRequestThread
+	 * @fn ProcessDeferredDRMRequest
+	 * @brief Request license of first pending key ID once its defer time has passed, run by the reactor
 	 * @param mediaType type of track
+	 * @return ms until next run, AAMP_REACTOR_TASK_DONE if no key ID is pending
 	 */
-	void StartDeferredDRMRequestThread(MediaType mediaType);
+	int ProcessDeferredDRMRequest(MediaType mediaType);
 	/**
 	 * @fn ProcessVssContentProtection
 	 * @param drmHelper created
@@ -939,10 +1025,13 @@ private:
 
 	LatencyStatus latencyStatus; 		 /**< Latency status of the playback*/
 	LatencyStatus prevLatencyStatus;	 /**< Previous latency status of the playback*/
-	bool latencyMonitorThreadStarted;	 /**< Monitor latency thread  status*/
-	pthread_t latencyMonitorThreadID;	 /**< Fragment injector thread id*/
+	int latencyMonitorTaskId;		 /**< Latency monitor reactor task id*/
 	int mProfileCount;			 /**< Total video profile count*/
 	std::unique_ptr<SubtitleParser> mSubtitleParser;	/**< Parser for subtitle data*/
+	unsigned int mManifestUpdateCount;			/**< Incremented on each MPD update, invalidates timeline indexes*/
+	std::map<std::string, MPDCachedPeriod> mCachedPeriods;	/**< Periods of current MPD by Period@id, shared by incremental parse*/
+	std::string mCachedPeriodsPath;				/**< Manifest directory path of cached periods*/
+	int mSharedPeriodCount;					/**< Periods of last parsed MPD taken from current one*/
 };
 
 #endif //FRAGMENTCOLLECTOR_MPD_H_
@@ -0,0 +1,546 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+* @file isobmffboxindex.cpp
+* @brief Allocation free flat index of ISO BMFF boxes
+*/
+
+#include "isobmffboxindex.h"
+#include "isobmffbox.h"
+#include <string.h>
+
+#define INDEX_BOX_HEADER_SIZE 8
+#define INDEX_BOX_LARGE_HEADER_SIZE 16
+#define INDEX_FULL_BOX_HEADER_SIZE 4
+#define INDEX_MAX_DEPTH 8	/**< Containers nested deeper are recorded but not descended */
+
+#define TRUN_FLAG_DATA_OFFSET_PRESENT				0x0001
+#define TRUN_FLAG_FIRST_SAMPLE_FLAGS_PRESENT			0x0004
+#define TRUN_FLAG_SAMPLE_DURATION_PRESENT			0x0100
+#define TRUN_FLAG_SAMPLE_SIZE_PRESENT				0x0200
+#define TRUN_FLAG_SAMPLE_FLAGS_PRESENT				0x0400
+#define TRUN_FLAG_SAMPLE_COMPOSITION_TIME_OFFSET_PRESENT	0x0800
+
+#define TFHD_FLAG_BASE_DATA_OFFSET_PRESENT			0x0001
+#define TFHD_FLAG_SAMPLE_DESCRIPTION_INDEX_PRESENT		0x0002
+#define TFHD_FLAG_DEFAULT_SAMPLE_DURATION_PRESENT		0x0008
+
+/**
+ * @brief Read big endian 32 bit value
+ */
+static inline uint32_t ReadBE32(const uint8_t *buf)
+{
+	return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | buf[3];
+}
+
+/**
+ * @brief Read big endian 64 bit value
+ */
+static inline uint64_t ReadBE64(const uint8_t *buf)
+{
+	return ((uint64_t)ReadBE32(buf) << 32) | ReadBE32(buf + 4);
+}
+
+/**
+ * @brief Length of NUL terminated string including terminator, 0 if not terminated within len
+ */
+static inline size_t StringSize(const uint8_t *buf, size_t len)
+{
+	const void *nul = memchr(buf, '\0', len);
+	return nul ? ((const uint8_t *)nul - buf) + 1 : 0;
+}
+
+/**
+ *  @brief IsoBmffBoxIndex constructor
+ */
+IsoBmffBoxIndex::IsoBmffBoxIndex() : inlineRecords(), records(inlineRecords), capacity(ISOBMFF_BOX_INDEX_INLINE_CAPACITY),
+	count(0), requiredCount(0), buffer(NULL), bufSize(0)
+{
+}
+
+/**
+ *  @brief IsoBmffBoxIndex constructor
+ */
+IsoBmffBoxIndex::IsoBmffBoxIndex(IsoBmffBoxRecord *arena, size_t capacity) : inlineRecords(), records(inlineRecords),
+	capacity(ISOBMFF_BOX_INDEX_INLINE_CAPACITY), count(0), requiredCount(0), buffer(NULL), bufSize(0)
+{
+	setArena(arena, capacity);
+}
+
+/**
+ *  @brief Switch record storage
+ */
+void IsoBmffBoxIndex::setArena(IsoBmffBoxRecord *arena, size_t capacity)
+{
+	if (arena)
+	{
+		this->records = arena;
+		this->capacity = capacity;
+	}
+	else
+	{
+		this->records = inlineRecords;
+		this->capacity = ISOBMFF_BOX_INDEX_INLINE_CAPACITY;
+	}
+	count = 0;
+	requiredCount = 0;
+}
+
+/**
+ *  @brief Index boxes of buffer
+ */
+bool IsoBmffBoxIndex::parse(const uint8_t *buf, size_t len)
+{
+	buffer = buf;
+	// records hold 32 bit offsets, like the Box tree
+	bufSize = (len > UINT32_MAX) ? UINT32_MAX : len;
+	count = 0;
+	requiredCount = 0;
+	if (buffer)
+	{
+		indexBoxes(0, bufSize, 0);
+	}
+	return (count > 0) && (count == requiredCount);
+}
+
+/**
+ *  @brief Record boxes in [start, end) and descend into containers
+ */
+void IsoBmffBoxIndex::indexBoxes(size_t start, size_t end, uint16_t depth)
+{
+	size_t offset = start;
+	while (offset < end)
+	{
+		size_t avail = end - offset;
+		const uint8_t *header = buffer + offset;
+		uint64_t size = 0;
+		uint16_t headerSize = INDEX_BOX_HEADER_SIZE;
+		if (avail >= INDEX_BOX_HEADER_SIZE)
+		{
+			size = ReadBE32(header);
+			if (size == 1 && avail >= INDEX_BOX_LARGE_HEADER_SIZE)
+			{
+				size = ReadBE64(header + 8);
+				headerSize = INDEX_BOX_LARGE_HEADER_SIZE;
+			}
+			else if (size == 0)
+			{
+				// box extends to end of enclosing box
+				size = avail;
+			}
+		}
+		if (size < headerSize)
+		{
+			// type can't be determined or box is malformed, nothing more to index at this level
+			break;
+		}
+
+		if (requiredCount++ < capacity)
+		{
+			IsoBmffBoxRecord &record = records[count++];
+			memcpy(record.type, header + 4, 4);
+			record.offset = (uint32_t)offset;
+			record.size = (size > UINT32_MAX) ? UINT32_MAX : (uint32_t)size;
+			record.depth = depth;
+			record.headerSize = headerSize;
+		}
+
+		if (size > avail)
+		{
+			// partial box, its children are not indexed
+			break;
+		}
+		if (depth < INDEX_MAX_DEPTH && (IS_TYPE((header + 4), Box::MOOV) || IS_TYPE((header + 4), Box::TRAK) || IS_TYPE((header + 4), Box::MDIA) ||
+			IS_TYPE((header + 4), Box::MOOF) || IS_TYPE((header + 4), Box::TRAF)))
+		{
+			indexBoxes(offset + headerSize, offset + (size_t)size, depth + 1);
+		}
+		offset += (size_t)size;
+	}
+}
+
+/**
+ *  @brief Check if box extends beyond the indexed buffer
+ */
+bool IsoBmffBoxIndex::isPartial(size_t index) const
+{
+	return (size_t)records[index].offset + records[index].size > bufSize;
+}
+
+/**
+ *  @brief Find next box of a type in document order
+ */
+int IsoBmffBoxIndex::find(const char *type, size_t from, size_t end) const
+{
+	if (end == 0 || end > count)
+	{
+		end = count;
+	}
+	for (size_t i = from; i < end; i++)
+	{
+		if (IS_TYPE(records[i].type, type))
+		{
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+/**
+ *  @brief Index of first record after the descendants of index
+ */
+size_t IsoBmffBoxIndex::getSubtreeEnd(size_t index) const
+{
+	size_t end = index + 1;
+	while (end < count && records[end].depth > records[index].depth)
+	{
+		end++;
+	}
+	return end;
+}
+
+/**
+ *  @brief Check if buffer is an initialization segment
+ */
+bool IsoBmffBoxIndex::isInitSegment() const
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		if (records[i].depth == 0 && IS_TYPE(records[i].type, Box::FTYP))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ *  @brief Number of complete top level mdat boxes
+ */
+size_t IsoBmffBoxIndex::getMdatCount() const
+{
+	size_t mdatCount = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (records[i].depth == 0 && IS_TYPE(records[i].type, Box::MDAT) && !isPartial(i))
+		{
+			mdatCount++;
+		}
+	}
+	return mdatCount;
+}
+
+/**
+ *  @brief Get first PTS of buffer
+ */
+bool IsoBmffBoxIndex::getFirstPTS(uint64_t &pts) const
+{
+	for (int i = find(Box::TFDT); i >= 0; i = find(Box::TFDT, i + 1))
+	{
+		if (getTfdt(i, pts))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ *  @brief Get TimeScale value of buffer
+ */
+bool IsoBmffBoxIndex::getTimeScale(uint32_t &timeScale) const
+{
+	int index = find(Box::MDHD);
+	if (index < 0)
+	{
+		index = find(Box::MVHD);
+	}
+	return (index >= 0) && getMdhdTimeScale(index, timeScale);
+}
+
+/**
+ *  @brief Duration of a moof or traf
+ */
+uint64_t IsoBmffBoxIndex::getSampleDuration(size_t index) const
+{
+	size_t end = getSubtreeEnd(index);
+	uint16_t childDepth = records[index].depth + 1;
+	// last child first, the first non zero duration wins and the last traf is descended
+	for (size_t i = end; i > index + 1;)
+	{
+		--i;
+		if (records[i].depth != childDepth)
+		{
+			continue;
+		}
+		uint64_t duration = 0;
+		if (IS_TYPE(records[i].type, Box::TRUN))
+		{
+			duration = getTrunDuration(i);
+		}
+		else if (IS_TYPE(records[i].type, Box::TFHD))
+		{
+			duration = getTfhdDefaultDuration(i);
+		}
+		else if (IS_TYPE(records[i].type, Box::TRAF))
+		{
+			return getSampleDuration(i);
+		}
+		if (duration)
+		{
+			return duration;
+		}
+	}
+	return 0;
+}
+
+/**
+ *  @brief Get information from first top level EMSG box
+ */
+bool IsoBmffBoxIndex::getEMSGData(const uint8_t* &message, uint32_t &messageLen, const char* &schemeIdUri, const char* &value, uint64_t &presTime, uint32_t &timeScale, uint32_t &eventDuration, uint32_t &id) const
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		if (records[i].depth == 0 && IS_TYPE(records[i].type, Box::EMSG))
+		{
+			return getEmsg(i, message, messageLen, schemeIdUri, value, presTime, timeScale, eventDuration, id);
+		}
+	}
+	return false;
+}
+
+/**
+ *  @brief Payload of a complete box of the given type
+ */
+const uint8_t *IsoBmffBoxIndex::getPayload(size_t index, const char *type, size_t minSize, size_t &payloadSize) const
+{
+	if (index >= count || !IS_TYPE(records[index].type, type) || isPartial(index))
+	{
+		return NULL;
+	}
+	const IsoBmffBoxRecord &record = records[index];
+	payloadSize = record.size - record.headerSize;
+	if (payloadSize < minSize)
+	{
+		return NULL;
+	}
+	return buffer + record.offset + record.headerSize;
+}
+
+/**
+ *  @brief Base media decode time of a tfdt box
+ */
+bool IsoBmffBoxIndex::getTfdt(size_t index, uint64_t &baseMediaDecodeTime) const
+{
+	size_t size = 0;
+	const uint8_t *ptr = getPayload(index, Box::TFDT, INDEX_FULL_BOX_HEADER_SIZE + sizeof(uint32_t), size);
+	if (!ptr)
+	{
+		return false;
+	}
+	if (ptr[0] == 1)
+	{
+		if (size < INDEX_FULL_BOX_HEADER_SIZE + sizeof(uint64_t))
+		{
+			return false;
+		}
+		baseMediaDecodeTime = ReadBE64(ptr + INDEX_FULL_BOX_HEADER_SIZE);
+	}
+	else
+	{
+		baseMediaDecodeTime = ReadBE32(ptr + INDEX_FULL_BOX_HEADER_SIZE);
+	}
+	return true;
+}
+
+/**
+ *  @brief Timescale of an mdhd or mvhd box
+ */
+bool IsoBmffBoxIndex::getMdhdTimeScale(size_t index, uint32_t &timeScale) const
+{
+	size_t size = 0;
+	const uint8_t *ptr = getPayload(index, Box::MDHD, INDEX_FULL_BOX_HEADER_SIZE, size);
+	if (!ptr)
+	{
+		ptr = getPayload(index, Box::MVHD, INDEX_FULL_BOX_HEADER_SIZE, size);
+	}
+	if (!ptr)
+	{
+		return false;
+	}
+	// creation and modification time precede timescale
+	size_t offset = INDEX_FULL_BOX_HEADER_SIZE + ((ptr[0] == 1) ? 2 * sizeof(uint64_t) : 2 * sizeof(uint32_t));
+	if (size < offset + sizeof(uint32_t))
+	{
+		return false;
+	}
+	timeScale = ReadBE32(ptr + offset);
+	return true;
+}
+
+/**
+ *  @brief Sum of sample durations of a trun box
+ */
+uint64_t IsoBmffBoxIndex::getTrunDuration(size_t index) const
+{
+	size_t size = 0;
+	const uint8_t *ptr = getPayload(index, Box::TRUN, INDEX_FULL_BOX_HEADER_SIZE + sizeof(uint32_t), size);
+	if (!ptr)
+	{
+		return 0;
+	}
+	uint32_t flags = ReadBE32(ptr) & 0xFFFFFF;
+	if (!(flags & TRUN_FLAG_SAMPLE_DURATION_PRESENT))
+	{
+		return 0;
+	}
+	uint32_t sampleCount = ReadBE32(ptr + INDEX_FULL_BOX_HEADER_SIZE);
+	size_t offset = INDEX_FULL_BOX_HEADER_SIZE + sizeof(uint32_t);
+	if (flags & TRUN_FLAG_DATA_OFFSET_PRESENT)
+	{
+		offset += sizeof(uint32_t);
+	}
+	if (flags & TRUN_FLAG_FIRST_SAMPLE_FLAGS_PRESENT)
+	{
+		offset += sizeof(uint32_t);
+	}
+	size_t recordSize = 0;
+	const uint32_t sampleFields[] = { TRUN_FLAG_SAMPLE_DURATION_PRESENT, TRUN_FLAG_SAMPLE_SIZE_PRESENT,
+		TRUN_FLAG_SAMPLE_FLAGS_PRESENT, TRUN_FLAG_SAMPLE_COMPOSITION_TIME_OFFSET_PRESENT };
+	for (uint32_t field : sampleFields)
+	{
+		recordSize += (flags & field) ? sizeof(uint32_t) : 0;
+	}
+	if (offset > size || sampleCount > (size - offset) / recordSize)
+	{
+		return 0;
+	}
+	uint64_t duration = 0;
+	for (const uint8_t *sample = ptr + offset; sampleCount; sampleCount--, sample += recordSize)
+	{
+		// duration is the first field of each sample record
+		duration += ReadBE32(sample);
+	}
+	return duration;
+}
+
+/**
+ *  @brief Default sample duration of a tfhd box
+ */
+uint64_t IsoBmffBoxIndex::getTfhdDefaultDuration(size_t index) const
+{
+	size_t size = 0;
+	const uint8_t *ptr = getPayload(index, Box::TFHD, INDEX_FULL_BOX_HEADER_SIZE + sizeof(uint32_t), size);
+	if (!ptr)
+	{
+		return 0;
+	}
+	uint32_t flags = ReadBE32(ptr) & 0xFFFFFF;
+	if (!(flags & TFHD_FLAG_DEFAULT_SAMPLE_DURATION_PRESENT))
+	{
+		return 0;
+	}
+	// track_ID, then optional base_data_offset and sample_description_index
+	size_t offset = INDEX_FULL_BOX_HEADER_SIZE + sizeof(uint32_t);
+	if (flags & TFHD_FLAG_BASE_DATA_OFFSET_PRESENT)
+	{
+		offset += sizeof(uint64_t);
+	}
+	if (flags & TFHD_FLAG_SAMPLE_DESCRIPTION_INDEX_PRESENT)
+	{
+		offset += sizeof(uint32_t);
+	}
+	if (size < offset + sizeof(uint32_t))
+	{
+		return 0;
+	}
+	return ReadBE32(ptr + offset);
+}
+
+/**
+ *  @brief Decode an emsg box
+ */
+bool IsoBmffBoxIndex::getEmsg(size_t index, const uint8_t* &message, uint32_t &messageLen, const char* &schemeIdUri, const char* &value, uint64_t &presTime, uint32_t &timeScale, uint32_t &eventDuration, uint32_t &id) const
+{
+	size_t size = 0;
+	const uint8_t *ptr = getPayload(index, Box::EMSG, INDEX_FULL_BOX_HEADER_SIZE, size);
+	if (!ptr)
+	{
+		return false;
+	}
+	uint8_t version = ptr[0];
+	const uint8_t *end = ptr + size;
+	ptr += INDEX_FULL_BOX_HEADER_SIZE;
+
+	/*
+	 * Layout as per https://aomediacodec.github.io/id3-emsg/
+	 */
+	const size_t v1FieldsSize = 3 * sizeof(uint32_t) + sizeof(uint64_t);
+	const size_t v0FieldsSize = 4 * sizeof(uint32_t);
+	if (1 == version)
+	{
+		if ((size_t)(end - ptr) < v1FieldsSize)
+		{
+			return false;
+		}
+		timeScale = ReadBE32(ptr);
+		presTime = ReadBE64(ptr + 4);
+		eventDuration = ReadBE32(ptr + 12);
+		id = ReadBE32(ptr + 16);
+		ptr += v1FieldsSize;
+	}
+	else if (0 != version)
+	{
+		return false;
+	}
+
+	size_t schemeIdSize = StringSize(ptr, end - ptr);
+	if (!schemeIdSize)
+	{
+		return false;
+	}
+	schemeIdUri = (const char *)ptr;
+	ptr += schemeIdSize;
+	size_t valueSize = StringSize(ptr, end - ptr);
+	if (!valueSize)
+	{
+		return false;
+	}
+	value = (const char *)ptr;
+	ptr += valueSize;
+
+	if (0 == version)
+	{
+		if ((size_t)(end - ptr) < v0FieldsSize)
+		{
+			return false;
+		}
+		// presentation_time_delta is not reported, as with EmsgBox
+		timeScale = ReadBE32(ptr);
+		presTime = 0;
+		eventDuration = ReadBE32(ptr + 8);
+		id = ReadBE32(ptr + 12);
+		ptr += v0FieldsSize;
+	}
+
+	message = (ptr < end) ? ptr : NULL;
+	messageLen = (uint32_t)(end - ptr);
+	return true;
+}
@@ -0,0 +1,259 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+* @file isobmffboxindex.h
+* @brief Allocation free flat index of ISO BMFF boxes
+*/
+
+#ifndef __ISOBMFFBOXINDEX_H__
+#define __ISOBMFFBOXINDEX_H__
+
+#include <stddef.h>
+#include <cstdint>
+
+/**
+ * @brief Records held inline by an index constructed without an arena
+ */
+#define ISOBMFF_BOX_INDEX_INLINE_CAPACITY 64
+
+/**
+ * @struct IsoBmffBoxRecord
+ * @brief Location of one box in the indexed buffer
+ */
+struct IsoBmffBoxRecord
+{
+	char type[4];		/**< Box type, not terminated */
+	uint32_t offset;	/**< Offset of box header from start of buffer */
+	uint32_t size;		/**< Box size including header, may exceed buffer for a partial last box */
+	uint16_t depth;		/**< Nesting level, 0 for top level boxes */
+	uint16_t headerSize;	/**< 8, or 16 for boxes with 64 bit size */
+};
+
+/**
+ * @class IsoBmffBoxIndex
+ * @brief Flat alternative to IsoBmffBuffer for read only queries on fragments
+ *
+ * Boxes are recorded in document order, children directly after their parent with
+ * depth one higher, so a subtree is the run of records following its root with a
+ * greater depth. The same containers as the Box tree are descended (moov, trak, mdia,
+ * moof, traf). Nothing is allocated and no box payload is read while indexing; typed
+ * accessors decode tfdt, trun, tfhd, mdhd, mvhd and emsg fields from the source bytes
+ * when called. The buffer must stay valid and unchanged while the index is used.
+ */
+class IsoBmffBoxIndex
+{
+public:
+	/**
+	 * @brief IsoBmffBoxIndex constructor, records are kept in the inline array
+	 */
+	IsoBmffBoxIndex();
+
+	/**
+	 * @brief IsoBmffBoxIndex constructor
+	 * @param[in] arena - caller owned record storage, must outlive the index
+	 * @param[in] capacity - number of records in arena
+	 */
+	IsoBmffBoxIndex(IsoBmffBoxRecord *arena, size_t capacity);
+
+	IsoBmffBoxIndex(const IsoBmffBoxIndex&) = delete;
+	IsoBmffBoxIndex& operator=(const IsoBmffBoxIndex&) = delete;
+
+	/**
+	 * @fn setArena
+	 * @brief Switch record storage, e.g. after growing it to getRequiredCount(). Clears the index
+	 * @param[in] arena - caller owned record storage, NULL selects the inline array
+	 * @param[in] capacity - number of records in arena
+	 * @return void
+	 */
+	void setArena(IsoBmffBoxRecord *arena, size_t capacity);
+
+	/**
+	 * @fn parse
+	 * @brief Index boxes of buffer
+	 * @param[in] buf - buffer holding complete boxes, the last box may be partial
+	 * @param[in] len - buffer length
+	 * @return true if boxes were found and all of them fit in the record storage
+	 */
+	bool parse(const uint8_t *buf, size_t len);
+
+	/**
+	 * @fn getCount
+	 * @return number of indexed boxes
+	 */
+	size_t getCount() const { return count; }
+
+	/**
+	 * @fn getRequiredCount
+	 * @return number of boxes found by last parse, larger than getCount() if storage overflowed.
+	 *         Records beyond capacity are dropped, earlier boxes in document order stay indexed
+	 */
+	size_t getRequiredCount() const { return requiredCount; }
+
+	/**
+	 * @fn getRecord
+	 * @param[in] index - record index, less than getCount()
+	 * @return box record
+	 */
+	const IsoBmffBoxRecord &getRecord(size_t index) const { return records[index]; }
+
+	/**
+	 * @fn isPartial
+	 * @param[in] index - record index
+	 * @return true if box extends beyond the indexed buffer
+	 */
+	bool isPartial(size_t index) const;
+
+	/**
+	 * @fn find
+	 * @brief Find next box of a type in document order
+	 * @param[in] type - box type, e.g. Box::TFDT
+	 * @param[in] from - first record to check
+	 * @param[in] end - record after last one to check, 0 for all
+	 * @return record index, or -1 if not found
+	 */
+	int find(const char *type, size_t from = 0, size_t end = 0) const;
+
+	/**
+	 * @fn getSubtreeEnd
+	 * @param[in] index - record index
+	 * @return index of first record after the descendants of index
+	 */
+	size_t getSubtreeEnd(size_t index) const;
+
+	/**
+	 * @fn isInitSegment
+	 * @return true if a top level ftyp box is present
+	 */
+	bool isInitSegment() const;
+
+	/**
+	 * @fn getMdatCount
+	 * @return number of complete top level mdat boxes
+	 */
+	size_t getMdatCount() const;
+
+	/**
+	 * @fn getFirstPTS
+	 * @param[out] pts - base media decode time of first tfdt box
+	 * @return true if found
+	 */
+	bool getFirstPTS(uint64_t &pts) const;
+
+	/**
+	 * @fn getTimeScale
+	 * @param[out] timeScale - timescale of first mdhd box, or of mvhd box if there is no mdhd
+	 * @return true if found
+	 */
+	bool getTimeScale(uint32_t &timeScale) const;
+
+	/**
+	 * @fn getSampleDuration
+	 * @brief Duration of a moof as IsoBmffBuffer::getSampleDuration reports it: last traf,
+	 *        last trun with sample durations or else tfhd default sample duration
+	 * @param[in] index - record index of moof or traf
+	 * @return duration in track timescale, 0 if unknown
+	 */
+	uint64_t getSampleDuration(size_t index) const;
+
+	/**
+	 * @fn getEMSGData
+	 * @brief Fields of first top level emsg box, pointers refer to the indexed buffer
+	 * @param[out] message - message data
+	 * @param[out] messageLen - message length
+	 * @param[out] schemeIdUri - scheme id uri, NUL terminated
+	 * @param[out] value - value, NUL terminated
+	 * @param[out] presTime - presentation time, version 1 boxes only
+	 * @param[out] timeScale - timescale
+	 * @param[out] eventDuration - event duration
+	 * @param[out] id - event id
+	 * @return true if a well formed emsg box was found
+	 */
+	bool getEMSGData(const uint8_t* &message, uint32_t &messageLen, const char* &schemeIdUri, const char* &value, uint64_t &presTime, uint32_t &timeScale, uint32_t &eventDuration, uint32_t &id) const;
+
+	/**
+	 * @fn getTfdt
+	 * @param[in] index - record index of a tfdt box
+	 * @param[out] baseMediaDecodeTime - base media decode time
+	 * @return true if box is complete and of this type
+	 */
+	bool getTfdt(size_t index, uint64_t &baseMediaDecodeTime) const;
+
+	/**
+	 * @fn getMdhdTimeScale
+	 * @param[in] index - record index of an mdhd or mvhd box, both share the layout up to timescale
+	 * @param[out] timeScale - timescale
+	 * @return true if box is complete and of this type
+	 */
+	bool getMdhdTimeScale(size_t index, uint32_t &timeScale) const;
+
+	/**
+	 * @fn getTrunDuration
+	 * @param[in] index - record index of a trun box
+	 * @return sum of sample durations, 0 if not present in the box
+	 */
+	uint64_t getTrunDuration(size_t index) const;
+
+	/**
+	 * @fn getTfhdDefaultDuration
+	 * @param[in] index - record index of a tfhd box
+	 * @return default sample duration, 0 if not present in the box
+	 */
+	uint64_t getTfhdDefaultDuration(size_t index) const;
+
+	/**
+	 * @fn getEmsg
+	 * @brief Decode an emsg box, see getEMSGData
+	 * @param[in] index - record index of an emsg box
+	 * @return true if box is complete and well formed
+	 */
+	bool getEmsg(size_t index, const uint8_t* &message, uint32_t &messageLen, const char* &schemeIdUri, const char* &value, uint64_t &presTime, uint32_t &timeScale, uint32_t &eventDuration, uint32_t &id) const;
+
+private:
+	/**
+	 * @fn indexBoxes
+	 * @brief Record boxes in [start, end) and descend into containers
+	 * @param[in] start - offset of first box
+	 * @param[in] end - end of enclosing box or buffer
+	 * @param[in] depth - nesting level of boxes
+	 * @return void
+	 */
+	void indexBoxes(size_t start, size_t end, uint16_t depth);
+
+	/**
+	 * @fn getPayload
+	 * @brief Payload of a complete box of the given type
+	 * @param[in] index - record index
+	 * @param[in] type - expected box type
+	 * @param[in] minSize - least payload bytes needed
+	 * @param[out] payloadSize - payload size
+	 * @return start of payload, NULL if not matching
+	 */
+	const uint8_t *getPayload(size_t index, const char *type, size_t minSize, size_t &payloadSize) const;
+
+	IsoBmffBoxRecord inlineRecords[ISOBMFF_BOX_INDEX_INLINE_CAPACITY];	/**< Storage used when no arena is given */
+	IsoBmffBoxRecord *records;	/**< Record storage in use */
+	size_t capacity;		/**< Records available in storage */
+	size_t count;			/**< Records indexed */
+	size_t requiredCount;		/**< Boxes found by last parse */
+	const uint8_t *buffer;		/**< Indexed buffer */
+	size_t bufSize;			/**< Indexed buffer length */
+};
+
+#endif /* __ISOBMFFBOXINDEX_H__ */
@@ -78,11 +78,10 @@ bool IsoBmffProcessor::sendSegment(char *segment, size_t& size, double position,
 	{
 		if (!processPTSComplete)
 		{
-			IsoBmffBuffer buffer(mLogObj);
-			buffer.setBuffer((uint8_t *)segment, size);
-			buffer.parseBuffer();
+			IsoBmffBoxIndex boxIndex;
+			boxIndex.parse((uint8_t *)segment, size);
 
-			if (buffer.isInitSegment())
+			if (boxIndex.isInitSegment())
 			{
 				cacheInitSegment(segment, size);
 				ret = false;
@@ -131,14 +130,13 @@ bool IsoBmffProcessor::sendSegment(char *segment, size_t& size, double position,
 	if (ret && !processPTSComplete && playRate == AAMP_NORMAL_PLAY_RATE)
 	{
 		// We need to parse PTS from first buffer
-		IsoBmffBuffer buffer(mLogObj);
-		buffer.setBuffer((uint8_t *)segment, size);
-		buffer.parseBuffer();
+		IsoBmffBoxIndex boxIndex;
+		boxIndex.parse((uint8_t *)segment, size);
 
-		if (buffer.isInitSegment())
+		if (boxIndex.isInitSegment())
 		{
 			uint32_t tScale = 0;
-			if (buffer.getTimeScale(tScale))
+			if (boxIndex.getTimeScale(tScale))
 			{
 				timeScale = tScale;
 				AAMPLOG_INFO("IsoBmffProcessor:: [%s] TimeScale (%ld) set", IsoBmffProcessorTypeName[type], timeScale);
@@ -151,7 +149,7 @@ bool IsoBmffProcessor::sendSegment(char *segment, size_t& size, double position,
 		{
 			// Init segment was parsed and stored previously. Find the base PTS now
 			uint64_t fPts = 0;
-			if (buffer.getFirstPTS(fPts))
+			if (boxIndex.getFirstPTS(fPts))
 			{
 				basePTS = fPts;
 				processPTSComplete = true;
@@ -183,7 +181,7 @@ bool IsoBmffProcessor::sendSegment(char *segment, size_t& size, double position,
 					{
 						AAMPLOG_WARN("IsoBmffProcessor:: [%s] MDHD/MVHD boxes are missing in init segment!",  IsoBmffProcessorTypeName[type]);
 						uint32_t tScale = 0;
-						if (buffer.getTimeScale(tScale))
+						if (boxIndex.getTimeScale(tScale))
 						{
 							timeScale = tScale;
 							AAMPLOG_INFO("IsoBmffProcessor:: [%s] TimeScale (%ld) set",  IsoBmffProcessorTypeName[type], timeScale);
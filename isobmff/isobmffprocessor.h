@@ -26,6 +26,7 @@
 #define __ISOBMFFPROCESSOR_H__
 
 #include "isobmffbuffer.h"
+#include "isobmffboxindex.h"
 #include "mediaprocessor.h"
 #include "priv_aamp.h"
 #include <pthread.h>
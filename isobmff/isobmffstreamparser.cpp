@@ -0,0 +1,179 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+* @file isobmffstreamparser.cpp
+* @brief Incremental splitter of ISO BMFF byte streams into complete moof/mdat units
+*/
+
+#include "isobmffstreamparser.h"
+#include <string.h>
+#include <limits>
+
+#define STREAM_BOX_HEADER_SIZE 8
+#define STREAM_BOX_LARGE_HEADER_SIZE 16
+
+/**
+ * @brief Read big endian 32 bit value
+ */
+static inline uint64_t ReadBE32(const uint8_t *buf)
+{
+	return ((uint64_t)buf[0] << 24) | ((uint64_t)buf[1] << 16) | ((uint64_t)buf[2] << 8) | buf[3];
+}
+
+/**
+ *  @brief IsoBmffStreamParser constructor
+ */
+IsoBmffStreamParser::IsoBmffStreamParser() : buffer(), unitStart(0), unitEnd(0), scanOffset(0), boxEnd(0), boxIsMdat(false)
+{
+}
+
+/**
+ *  @brief Add bytes and advance over boxes they complete
+ */
+bool IsoBmffStreamParser::append(const uint8_t *data, size_t len)
+{
+	if (data && len)
+	{
+		compact();
+		buffer.insert(buffer.end(), data, data + len);
+	}
+	return scan();
+}
+
+/**
+ *  @brief Advance over complete boxes
+ */
+bool IsoBmffStreamParser::scan()
+{
+	size_t size = buffer.size();
+	while (true)
+	{
+		if (!boxEnd)
+		{
+			if (size - scanOffset < STREAM_BOX_HEADER_SIZE)
+			{
+				break;
+			}
+			const uint8_t *header = &buffer[scanOffset];
+			uint64_t boxSize = ReadBE32(header);
+			size_t headerSize = STREAM_BOX_HEADER_SIZE;
+			if (boxSize == 1)
+			{
+				if (size - scanOffset < STREAM_BOX_LARGE_HEADER_SIZE)
+				{
+					break;
+				}
+				boxSize = (ReadBE32(header + 8) << 32) | ReadBE32(header + 12);
+				headerSize = STREAM_BOX_LARGE_HEADER_SIZE;
+			}
+			if (boxSize == 0)
+			{
+				// box extends to end of stream, never complete while chunks keep coming
+				boxEnd = std::numeric_limits<size_t>::max();
+			}
+			else if (boxSize < headerSize || boxSize > std::numeric_limits<size_t>::max() - scanOffset)
+			{
+				reset();
+				return false;
+			}
+			else
+			{
+				boxEnd = scanOffset + (size_t)boxSize;
+			}
+			boxIsMdat = (0 == memcmp(header + 4, "mdat", 4));
+		}
+		if (boxEnd > size)
+		{
+			break;
+		}
+		scanOffset = boxEnd;
+		if (boxIsMdat)
+		{
+			unitEnd = boxEnd;
+		}
+		boxEnd = 0;
+		boxIsMdat = false;
+	}
+	return true;
+}
+
+/**
+ *  @brief Complete boxes up to and including the last complete mdat
+ */
+bool IsoBmffStreamParser::getUnit(uint8_t *&unit, size_t &len)
+{
+	if (unitEnd <= unitStart)
+	{
+		return false;
+	}
+	unit = &buffer[unitStart];
+	len = unitEnd - unitStart;
+	return true;
+}
+
+/**
+ *  @brief Release unit returned by getUnit
+ */
+void IsoBmffStreamParser::consumeUnit()
+{
+	if (unitEnd > unitStart)
+	{
+		unitStart = unitEnd;
+	}
+	if (unitStart == buffer.size())
+	{
+		// drained, common case when chunks end on box boundaries
+		reset();
+	}
+}
+
+/**
+ *  @brief Reclaim consumed bytes
+ */
+void IsoBmffStreamParser::compact()
+{
+	size_t pending = buffer.size() - unitStart;
+	if (unitStart && pending <= unitStart)
+	{
+		// moving pending bytes costs no more than the consumed bytes already did
+		memmove(&buffer[0], &buffer[unitStart], pending);
+		buffer.resize(pending);
+		unitEnd -= unitStart;
+		scanOffset -= unitStart;
+		if (boxEnd && boxEnd != std::numeric_limits<size_t>::max())
+		{
+			boxEnd -= unitStart;
+		}
+		unitStart = 0;
+	}
+}
+
+/**
+ *  @brief Drop buffered bytes
+ */
+void IsoBmffStreamParser::reset()
+{
+	buffer.clear();
+	unitStart = 0;
+	unitEnd = 0;
+	scanOffset = 0;
+	boxEnd = 0;
+	boxIsMdat = false;
+}
@@ -0,0 +1,114 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+* @file isobmffstreamparser.h
+* @brief Incremental splitter of ISO BMFF byte streams into complete moof/mdat units
+*/
+
+#ifndef __ISOBMFFSTREAMPARSER_H__
+#define __ISOBMFFSTREAMPARSER_H__
+
+#include <stddef.h>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class IsoBmffStreamParser
+ * @brief Tracks top level box boundaries of a stream arriving in arbitrary pieces
+ *
+ * Every byte is examined once: box headers are read as soon as they are complete and
+ * the parser then jumps to the end of the box, waiting for more data if the box is
+ * still partial. All bytes up to the end of the last complete mdat form a unit which
+ * the caller reads in place. Consumed bytes are reclaimed when the buffer drains or
+ * when they outweigh the pending bytes, so partial boxes are not shifted per append.
+ */
+class IsoBmffStreamParser
+{
+public:
+	/**
+	 * @brief IsoBmffStreamParser constructor
+	 */
+	IsoBmffStreamParser();
+
+	IsoBmffStreamParser(const IsoBmffStreamParser&) = delete;
+	IsoBmffStreamParser& operator=(const IsoBmffStreamParser&) = delete;
+
+	/**
+	 * @fn append
+	 * @brief Add bytes and advance over boxes they complete
+	 * @param[in] data - next bytes of the stream
+	 * @param[in] len - number of bytes
+	 * @return false if a malformed box header was found, buffered bytes are dropped
+	 */
+	bool append(const uint8_t *data, size_t len);
+
+	/**
+	 * @fn getUnit
+	 * @brief Complete boxes up to and including the last complete mdat
+	 * @param[out] unit - start of unit, valid until next append, consumeUnit or reset
+	 * @param[out] len - unit length
+	 * @return true if a unit is available
+	 */
+	bool getUnit(uint8_t *&unit, size_t &len);
+
+	/**
+	 * @fn consumeUnit
+	 * @brief Release unit returned by getUnit
+	 * @return void
+	 */
+	void consumeUnit();
+
+	/**
+	 * @fn getPendingSize
+	 * @return bytes buffered and not yet consumed
+	 */
+	size_t getPendingSize() const { return buffer.size() - unitStart; }
+
+	/**
+	 * @fn reset
+	 * @brief Drop buffered bytes, keeps allocated memory
+	 * @return void
+	 */
+	void reset();
+
+private:
+	/**
+	 * @fn scan
+	 * @brief Advance over complete boxes from scanOffset
+	 * @return false on malformed box header
+	 */
+	bool scan();
+
+	/**
+	 * @fn compact
+	 * @brief Reclaim consumed bytes when cheap relative to their size
+	 * @return void
+	 */
+	void compact();
+
+	std::vector<uint8_t> buffer;	/**< Buffered stream bytes */
+	size_t unitStart;		/**< Offset of first unconsumed byte */
+	size_t unitEnd;			/**< End of last complete mdat, unit is [unitStart, unitEnd) */
+	size_t scanOffset;		/**< Offset of next box header */
+	size_t boxEnd;			/**< End of partial box at scanOffset, 0 if header not read yet */
+	bool boxIsMdat;			/**< Partial box at scanOffset is an mdat */
+};
+
+#endif /* __ISOBMFFSTREAMPARSER_H__ */
@@ -759,41 +759,21 @@ public:
 	 */
 	void setEventProperties(const AAMPEventPtr& e, JSContextRef context, JSObjectRef eventObj)
 	{
+		static const char* const kNames[] = { "durationMiliseconds", "positionMiliseconds", "playbackSpeed", "startMiliseconds",
+			"endMiliseconds", "currentPTS", "videoBufferedMiliseconds", "timecode" };
+		static const auto progressTemplate = aamp_MakeJSObjectTemplate(kNames);
 		ProgressEventPtr evt = std::dynamic_pointer_cast<ProgressEvent>(e);
 
-		JSStringRef name;
-
-		name = JSStringCreateWithUTF8CString("durationMiliseconds");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getDuration()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("positionMiliseconds");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("playbackSpeed");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getSpeed()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("startMiliseconds");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getStart()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("endMiliseconds");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getEnd()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("currentPTS");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getPTS()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("videoBufferedMiliseconds");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getBufferedDuration()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("timecode");
-		JSObjectSetProperty(context, eventObj, name, aamp_CStringToJSValue(context, evt->getSEITimeCode()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
+		const JSValueRef values[] = {
+			JSValueMakeNumber(context, evt->getDuration()),
+			JSValueMakeNumber(context, evt->getPosition()),
+			JSValueMakeNumber(context, evt->getSpeed()),
+			JSValueMakeNumber(context, evt->getStart()),
+			JSValueMakeNumber(context, evt->getEnd()),
+			JSValueMakeNumber(context, evt->getPTS()),
+			JSValueMakeNumber(context, evt->getBufferedDuration()),
+			aamp_CStringToJSValue(context, evt->getSEITimeCode()) };
+		progressTemplate.SetProperties(context, eventObj, values);
 	}
 };
 
@@ -823,49 +803,23 @@ public:
 	 */
 	void setEventProperties(const AAMPEventPtr& e, JSContextRef context, JSObjectRef eventObj)
 	{
+		static const char* const kNames[] = { "time", "bitRate", "description", "width", "height", "framerate", "position",
+			"cappedProfile", "displayWidth", "displayHeight" };
+		static const auto bitrateTemplate = aamp_MakeJSObjectTemplate(kNames);
 		BitrateChangeEventPtr evt = std::dynamic_pointer_cast<BitrateChangeEvent>(e);
 
-		JSStringRef name;
-		name = JSStringCreateWithUTF8CString("time");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getTime()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("bitRate");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getBitrate()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("description");
-		JSObjectSetProperty(context, eventObj, name, aamp_CStringToJSValue(context, evt->getDescription().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("width");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getWidth()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("height");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getHeight()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-		
-		name = JSStringCreateWithUTF8CString("framerate");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getFrameRate()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("position");
-		JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		name = JSStringCreateWithUTF8CString("cappedProfile");
-                JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getCappedProfileStatus()), kJSPropertyAttributeReadOnly, NULL);
-
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("displayWidth");
-                JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getDisplayWidth()), kJSPropertyAttributeReadOnly, NULL);
-
-                JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("displayHeight");
-                JSObjectSetProperty(context, eventObj, name, JSValueMakeNumber(context, evt->getDisplayHeight()), kJSPropertyAttributeReadOnly, NULL);
-
-                JSStringRelease(name);
+		const JSValueRef values[] = {
+			JSValueMakeNumber(context, evt->getTime()),
+			JSValueMakeNumber(context, evt->getBitrate()),
+			aamp_CStringToJSValue(context, evt->getDescription().c_str()),
+			JSValueMakeNumber(context, evt->getWidth()),
+			JSValueMakeNumber(context, evt->getHeight()),
+			JSValueMakeNumber(context, evt->getFrameRate()),
+			JSValueMakeNumber(context, evt->getPosition()),
+			JSValueMakeNumber(context, evt->getCappedProfileStatus()),
+			JSValueMakeNumber(context, evt->getDisplayWidth()),
+			JSValueMakeNumber(context, evt->getDisplayHeight()) };
+		bitrateTemplate.SetProperties(context, eventObj, values);
 	}
 };
 
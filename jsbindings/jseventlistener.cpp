@@ -56,11 +56,7 @@ public:
 	{
 		StateChangedEventPtr evt = std::dynamic_pointer_cast<StateChangedEvent>(ev);
 
-		JSStringRef prop;
-
-		prop = JSStringCreateWithUTF8CString("state");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getState()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("state"), JSValueMakeNumber(p_obj->_ctx, evt->getState()), kJSPropertyAttributeReadOnly, NULL);
 	}
 
 };
@@ -91,41 +87,22 @@ public:
 	 */
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
+		static const char* const kNames[] = { "durationMiliseconds", "positionMiliseconds", "playbackSpeed", "startMiliseconds",
+			"endMiliseconds", "currentPTS", "videoBufferedMiliseconds", "timecode" };
+		// sent several times a second, names are interned once for all listeners
+		static const auto progressTemplate = aamp_MakeJSObjectTemplate(kNames);
 		ProgressEventPtr evt = std::dynamic_pointer_cast<ProgressEvent>(ev);
 
-		JSStringRef prop;
-
-		prop = JSStringCreateWithUTF8CString("durationMiliseconds");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getDuration()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("positionMiliseconds");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("playbackSpeed");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getSpeed()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("startMiliseconds");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getStart()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("endMiliseconds");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getEnd()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("currentPTS");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getPTS()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("videoBufferedMiliseconds");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getBufferedDuration()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("timecode");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getSEITimeCode()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		const JSValueRef values[] = {
+			JSValueMakeNumber(p_obj->_ctx, evt->getDuration()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getPosition()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getSpeed()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getStart()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getEnd()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getPTS()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getBufferedDuration()),
+			aamp_CStringToJSValue(p_obj->_ctx, evt->getSEITimeCode()) };
+		progressTemplate.SetProperties(p_obj->_ctx, jsEventObj, values);
 	}
 };
 
@@ -157,15 +134,9 @@ public:
 	{
 		SpeedChangedEventPtr evt = std::dynamic_pointer_cast<SpeedChangedEvent>(ev);
 
-		JSStringRef prop;
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("speed"), JSValueMakeNumber(p_obj->_ctx, evt->getRate()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("speed");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getRate()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("reason");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, "unknown"), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("reason"), aamp_CStringToJSValue(p_obj->_ctx, "unknown"), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -197,11 +168,7 @@ public:
 	{
 		BufferingChangedEventPtr evt = std::dynamic_pointer_cast<BufferingChangedEvent>(ev);
 
-		JSStringRef prop;
-
-		prop = JSStringCreateWithUTF8CString("buffering");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeBoolean(p_obj->_ctx, evt->buffering()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("buffering"), JSValueMakeBoolean(p_obj->_ctx, evt->buffering()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -233,33 +200,19 @@ public:
 	{
 		MediaErrorEventPtr evt = std::dynamic_pointer_cast<MediaErrorEvent>(ev);
 
-		JSStringRef prop;
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("code"), JSValueMakeNumber(p_obj->_ctx, evt->getCode()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("code");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getCode()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("description"), aamp_CStringToJSValue(p_obj->_ctx, evt->getDescription().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("description");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getDescription().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("shouldRetry");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeBoolean(p_obj->_ctx, evt->shouldRetry()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("shouldRetry"), JSValueMakeBoolean(p_obj->_ctx, evt->shouldRetry()), kJSPropertyAttributeReadOnly, NULL);
 		
 		if(-1 != evt->getClass()) //Only send verbose error for secclient/secmanager DRM failures
 		{
-			prop = JSStringCreateWithUTF8CString("class");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getClass()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
+			JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("class"), JSValueMakeNumber(p_obj->_ctx, evt->getClass()), kJSPropertyAttributeReadOnly, NULL);
 			
-			prop = JSStringCreateWithUTF8CString("reason");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getReason()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
+			JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("reason"), JSValueMakeNumber(p_obj->_ctx, evt->getReason()), kJSPropertyAttributeReadOnly, NULL);
 			
-			prop = JSStringCreateWithUTF8CString("businessStatus");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getBusinessStatus()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
+			JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("businessStatus"), JSValueMakeNumber(p_obj->_ctx, evt->getBusinessStatus()), kJSPropertyAttributeReadOnly, NULL);
 		}
 	}
 };
@@ -290,13 +243,12 @@ public:
 	 */
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
+		static const char* const kNames[] = { "durationMiliseconds", "languages", "bitrates", "playbackSpeeds", "programStartTime",
+			"width", "height", "hasDrm", "isLive", "DRM", "ratings", "ssi", "framerate", "progressive", "aspectRatioWidth",
+			"aspectRatioHeight", "videoCodec", "hdrType", "audioBitrates", "audioCodec", "audioMixType", "isAtmos", "mediaFormat" };
+		static const auto metadataTemplate = aamp_MakeJSObjectTemplate(kNames);
 		MediaMetadataEventPtr evt = std::dynamic_pointer_cast<MediaMetadataEvent>(ev);
 
-		JSStringRef prop;
-		prop = JSStringCreateWithUTF8CString("durationMiliseconds");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getDuration()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
 		int count = evt->getLanguagesCount();
 		const std::vector<std::string> &langVect = evt->getLanguages();
 		JSValueRef* array = new JSValueRef[count];
@@ -305,13 +257,9 @@ public:
 			JSValueRef lang = aamp_CStringToJSValue(p_obj->_ctx, langVect[i].c_str());
 			array[i] = lang;
 		}
-		JSValueRef propValue = JSObjectMakeArray(p_obj->_ctx, count, array, NULL);
+		JSValueRef languages = JSObjectMakeArray(p_obj->_ctx, count, array, NULL);
 		SAFE_DELETE_ARRAY(array);
 
-		prop = JSStringCreateWithUTF8CString("languages");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, propValue, kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
 		count = evt->getBitratesCount();
 		const std::vector<long> &bitrateVect = evt->getBitrates();
 		array = new JSValueRef[count];
@@ -319,13 +267,9 @@ public:
 		{
 			array[i] = JSValueMakeNumber(p_obj->_ctx, bitrateVect[i]);
 		}
-		propValue = JSObjectMakeArray(p_obj->_ctx, count, array, NULL);
+		JSValueRef bitrates = JSObjectMakeArray(p_obj->_ctx, count, array, NULL);
 		SAFE_DELETE_ARRAY(array);
 
-		prop = JSStringCreateWithUTF8CString("bitrates");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, propValue, kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
 		count = evt->getSupportedSpeedCount();
 		const std::vector<float> &speedVect = evt->getSupportedSpeeds();
 		array = new JSValueRef[count];
@@ -333,96 +277,11 @@ public:
 		{
 			array[i] = JSValueMakeNumber(p_obj->_ctx, speedVect[i]);
 		}
-		propValue = JSObjectMakeArray(p_obj->_ctx, count, array, NULL);
+		JSValueRef playbackSpeeds = JSObjectMakeArray(p_obj->_ctx, count, array, NULL);
 		SAFE_DELETE_ARRAY(array);
 
-		prop = JSStringCreateWithUTF8CString("playbackSpeeds");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, propValue, kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("programStartTime");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getProgramStartTime()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("width");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getWidth()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("height");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getHeight()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("hasDrm");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeBoolean(p_obj->_ctx, evt->hasDrm()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("isLive");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeBoolean(p_obj->_ctx, evt->isLive()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("DRM");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getDrmType().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		//ratings
-		if(!evt->getRatings().empty())
-		{
-			prop = JSStringCreateWithUTF8CString("ratings");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getRatings().c_str()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
-		}
-
-		//ssi
-		if(evt->getSsi() >= 0 )
-		{
-			prop = JSStringCreateWithUTF8CString("ssi");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getSsi()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
-		}
-
-		//framerate
-		if(evt->getFrameRate() > 0 )
-		{
-			prop = JSStringCreateWithUTF8CString("framerate");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getFrameRate()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
-		}
-
-		if(eVIDEOSCAN_UNKNOWN != evt->getVideoScanType())
-		{
-			prop = JSStringCreateWithUTF8CString("progressive");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeBoolean(p_obj->_ctx, ((eVIDEOSCAN_PROGRESSIVE == evt->getVideoScanType())?true:false)), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
-		}
-		//aspect ratio
-		if((0 != evt->getAspectRatioWidth()) && (0 != evt->getAspectRatioHeight()))
-		{
-			prop = JSStringCreateWithUTF8CString("aspectRatioWidth");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getAspectRatioWidth()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
-
-			prop = JSStringCreateWithUTF8CString("aspectRatioHeight");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getAspectRatioHeight()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
-		}
-
-		//VideoCodec
-		if(!evt->getVideoCodec().empty())
-		{
-			prop = JSStringCreateWithUTF8CString("videoCodec");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getVideoCodec().c_str()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
-		}
-
-		//HdrType
-		if(!evt->getHdrType().empty())
-		{
-			prop = JSStringCreateWithUTF8CString("hdrType");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getHdrType().c_str()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
-		}
-
 		//AudioBitrate
+		JSValueRef audioBitrates = NULL;
 		const std::vector<long> &audioBitrateVect = evt->getAudioBitrates();
 		count = audioBitrateVect.size();
 		if(count > 0 )
@@ -432,41 +291,37 @@ public:
 			{
 				array[i] = JSValueMakeNumber(p_obj->_ctx, audioBitrateVect[i]);
 			}
-			propValue = JSObjectMakeArray(p_obj->_ctx, count, array, NULL);
-			delete [] array;
-
-			prop = JSStringCreateWithUTF8CString("audioBitrates");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, propValue, kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
-		}
-
-
-		//AudioCodec
-		if(!evt->getAudioCodec().empty())
-		{
-			prop = JSStringCreateWithUTF8CString("audioCodec");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getAudioCodec().c_str()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
+			audioBitrates = JSObjectMakeArray(p_obj->_ctx, count, array, NULL);
+			SAFE_DELETE_ARRAY(array);
 		}
 
-		//AudioMixType
-		if(!evt->getAudioMixType().empty())
-		{
-			prop = JSStringCreateWithUTF8CString("audioMixType");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getAudioMixType().c_str()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
-		}
-
-		//AtmosInfo
-		prop = JSStringCreateWithUTF8CString("isAtmos");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeBoolean(p_obj->_ctx,evt->getAtmosInfo()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		//MediaFormat type
-		prop = JSStringCreateWithUTF8CString("mediaFormat");
-                JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getMediaFormat().c_str()), kJSPropertyAttributeReadOnly, NULL);
-                JSStringRelease(prop);
-
+		bool hasAspectRatio = ((0 != evt->getAspectRatioWidth()) && (0 != evt->getAspectRatioHeight()));
+		// optional properties are NULL when absent and left out by the template
+		const JSValueRef values[] = {
+			JSValueMakeNumber(p_obj->_ctx, evt->getDuration()),
+			languages,
+			bitrates,
+			playbackSpeeds,
+			JSValueMakeNumber(p_obj->_ctx, evt->getProgramStartTime()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getWidth()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getHeight()),
+			JSValueMakeBoolean(p_obj->_ctx, evt->hasDrm()),
+			JSValueMakeBoolean(p_obj->_ctx, evt->isLive()),
+			aamp_CStringToJSValue(p_obj->_ctx, evt->getDrmType().c_str()),
+			evt->getRatings().empty() ? NULL : aamp_CStringToJSValue(p_obj->_ctx, evt->getRatings().c_str()),
+			(evt->getSsi() >= 0) ? JSValueMakeNumber(p_obj->_ctx, evt->getSsi()) : NULL,
+			(evt->getFrameRate() > 0) ? JSValueMakeNumber(p_obj->_ctx, evt->getFrameRate()) : NULL,
+			(eVIDEOSCAN_UNKNOWN != evt->getVideoScanType()) ? JSValueMakeBoolean(p_obj->_ctx, (eVIDEOSCAN_PROGRESSIVE == evt->getVideoScanType())) : NULL,
+			hasAspectRatio ? JSValueMakeNumber(p_obj->_ctx, evt->getAspectRatioWidth()) : NULL,
+			hasAspectRatio ? JSValueMakeNumber(p_obj->_ctx, evt->getAspectRatioHeight()) : NULL,
+			evt->getVideoCodec().empty() ? NULL : aamp_CStringToJSValue(p_obj->_ctx, evt->getVideoCodec().c_str()),
+			evt->getHdrType().empty() ? NULL : aamp_CStringToJSValue(p_obj->_ctx, evt->getHdrType().c_str()),
+			audioBitrates,
+			evt->getAudioCodec().empty() ? NULL : aamp_CStringToJSValue(p_obj->_ctx, evt->getAudioCodec().c_str()),
+			evt->getAudioMixType().empty() ? NULL : aamp_CStringToJSValue(p_obj->_ctx, evt->getAudioMixType().c_str()),
+			JSValueMakeBoolean(p_obj->_ctx, evt->getAtmosInfo()),
+			aamp_CStringToJSValue(p_obj->_ctx, evt->getMediaFormat().c_str()) };
+		metadataTemplate.SetProperties(p_obj->_ctx, jsEventObj, values);
 	}
 };
 
@@ -508,9 +363,7 @@ public:
 		JSValueRef propValue = JSObjectMakeArray(p_obj->_ctx, count, array, NULL);
 		SAFE_DELETE_ARRAY(array);
 
-		JSStringRef prop = JSStringCreateWithUTF8CString("playbackSpeeds");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, propValue, kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("playbackSpeeds"), propValue, kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -540,9 +393,7 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		SeekedEventPtr evt = std::dynamic_pointer_cast<SeekedEvent>(ev);
-		JSStringRef prop = JSStringCreateWithUTF8CString("position");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("position"), JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -573,13 +424,10 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		TuneProfilingEventPtr evt = std::dynamic_pointer_cast<TuneProfilingEvent>(ev);
-                JSStringRef prop;
                 const char* microData = evt->getProfilingData().c_str();
 
                 LOG_TRACE("AAMP_Listener_TuneProfiling microData %s", microData);
-                prop = JSStringCreateWithUTF8CString("microData");
-                JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, microData), kJSPropertyAttributeReadOnly, NULL);
-                JSStringRelease(prop);
+                JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("microData"), aamp_CStringToJSValue(p_obj->_ctx, microData), kJSPropertyAttributeReadOnly, NULL);
 	}
 
 };
@@ -611,11 +459,7 @@ public:
 	{
 		CCHandleEventPtr evt = std::dynamic_pointer_cast<CCHandleEvent>(ev);
 
-		JSStringRef prop;
-
-		prop = JSStringCreateWithUTF8CString("decoderHandle");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getCCHandle()), kJSPropertyAttributeReadOnly, NULL);
-                JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("decoderHandle"), JSValueMakeNumber(p_obj->_ctx, evt->getCCHandle()), kJSPropertyAttributeReadOnly, NULL);
 	}
 
 };
@@ -647,19 +491,13 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		DrmMetaDataEventPtr evt = std::dynamic_pointer_cast<DrmMetaDataEvent>(ev);
-		JSStringRef prop;
-
 		int code = evt->getAccessStatusValue();
 		const char* description = evt->getAccessStatus().c_str();
 
         	LOG_WARN_EX("AAMP_Listener_DRMMetadata code %d Description %s", code, description);
-		prop = JSStringCreateWithUTF8CString("code");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, code), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("code"), JSValueMakeNumber(p_obj->_ctx, code), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("description");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, description), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("description"), aamp_CStringToJSValue(p_obj->_ctx, description), kJSPropertyAttributeReadOnly, NULL);
 	}
 
 };
@@ -691,19 +529,13 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		AnomalyReportEventPtr evt = std::dynamic_pointer_cast<AnomalyReportEvent>(ev);
-		JSStringRef prop;
-
 		int severity = evt->getSeverity();
 		const char* description = evt->getMessage().c_str();
 
         	LOG_WARN_EX("AAMP_Listener_AnomalyReport severity %d Description %s", severity, description);
-		prop = JSStringCreateWithUTF8CString("severity");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, severity), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("severity"), JSValueMakeNumber(p_obj->_ctx, severity), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("description");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, description), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("description"), aamp_CStringToJSValue(p_obj->_ctx, description), kJSPropertyAttributeReadOnly, NULL);
 	}
 
 };
@@ -736,20 +568,13 @@ public:
 	{
 		WebVttCueEventPtr evt = std::dynamic_pointer_cast<WebVttCueEvent>(ev);
 
-		JSStringRef prop;
 		VTTCue *cue = evt->getCueData();
 
-		prop = JSStringCreateWithUTF8CString("start");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, cue->mStart), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("start"), JSValueMakeNumber(p_obj->_ctx, cue->mStart), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("duration");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, cue->mDuration), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("duration"), JSValueMakeNumber(p_obj->_ctx, cue->mDuration), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("text");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, cue->mText.c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("text"), aamp_CStringToJSValue(p_obj->_ctx, cue->mText.c_str()), kJSPropertyAttributeReadOnly, NULL);
 	}
 
 };
@@ -786,9 +611,7 @@ public:
 		if (timedMetadata)
 		{
 			JSValueProtect(p_obj->_ctx, timedMetadata);
-			JSStringRef prop = JSStringCreateWithUTF8CString("timedMetadata");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, timedMetadata, kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
+			JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("timedMetadata"), timedMetadata, kJSPropertyAttributeReadOnly, NULL);
 			JSValueUnprotect(p_obj->_ctx, timedMetadata);
 		}
 	}
@@ -819,9 +642,7 @@ public:
         void SetEventProperties(const AAMPEventPtr& ev,  JSObjectRef eventObj)
         {
 		BulkTimedMetadataEventPtr evt = std::dynamic_pointer_cast<BulkTimedMetadataEvent>(ev);
-		JSStringRef name = JSStringCreateWithUTF8CString("timedMetadatas");
-		JSObjectSetProperty(p_obj->_ctx, eventObj, name, aamp_CStringToJSValue(p_obj->_ctx, evt->getContent().c_str()),  kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
+		JSObjectSetProperty(p_obj->_ctx, eventObj, aamp_GetJSPropertyName("timedMetadatas"), aamp_CStringToJSValue(p_obj->_ctx, evt->getContent().c_str()),  kJSPropertyAttributeReadOnly, NULL);
         }
 };
 
@@ -853,23 +674,13 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		AdResolvedEventPtr evt = std::dynamic_pointer_cast<AdResolvedEvent>(ev);
-		JSStringRef prop;
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("resolvedStatus"), JSValueMakeBoolean(p_obj->_ctx, evt->getResolveStatus()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("resolvedStatus");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeBoolean(p_obj->_ctx, evt->getResolveStatus()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("placementId"), aamp_CStringToJSValue(p_obj->_ctx, evt->getAdId().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("placementId");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getAdId().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("placementStartTime"), JSValueMakeNumber(p_obj->_ctx, evt->getStart()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("placementStartTime");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getStart()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("placementDuration");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getDuration()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("placementDuration"), JSValueMakeNumber(p_obj->_ctx, evt->getDuration()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -901,15 +712,9 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		AdReservationEventPtr evt = std::dynamic_pointer_cast<AdReservationEvent>(ev);
-		JSStringRef prop;
-
-		prop = JSStringCreateWithUTF8CString("adbreakId");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getAdBreakId().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("adbreakId"), aamp_CStringToJSValue(p_obj->_ctx, evt->getAdBreakId().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("time");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("time"), JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -941,15 +746,9 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		AdReservationEventPtr evt = std::dynamic_pointer_cast<AdReservationEvent>(ev);
-		JSStringRef prop;
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("adbreakId"), aamp_CStringToJSValue(p_obj->_ctx, evt->getAdBreakId().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("adbreakId");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getAdBreakId().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("time");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("time"), JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -981,15 +780,9 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		AdPlacementEventPtr evt = std::dynamic_pointer_cast<AdPlacementEvent>(ev);
-		JSStringRef prop;
-
-		prop = JSStringCreateWithUTF8CString("adId");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getAdId().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("adId"), aamp_CStringToJSValue(p_obj->_ctx, evt->getAdId().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("time");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("time"), JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -1021,15 +814,9 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		AdPlacementEventPtr evt = std::dynamic_pointer_cast<AdPlacementEvent>(ev);
-		JSStringRef prop;
-
-		prop = JSStringCreateWithUTF8CString("adId");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getAdId().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("adId"), aamp_CStringToJSValue(p_obj->_ctx, evt->getAdId().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("time");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("time"), JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -1061,15 +848,9 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		AdPlacementEventPtr evt = std::dynamic_pointer_cast<AdPlacementEvent>(ev);
-		JSStringRef prop;
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("adId"), aamp_CStringToJSValue(p_obj->_ctx, evt->getAdId().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("adId");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getAdId().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("time");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("time"), JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -1101,19 +882,11 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		AdPlacementEventPtr evt = std::dynamic_pointer_cast<AdPlacementEvent>(ev);
-		JSStringRef prop;
-
-		prop = JSStringCreateWithUTF8CString("adId");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getAdId().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("adId"), aamp_CStringToJSValue(p_obj->_ctx, evt->getAdId().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("time");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("time"), JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("error");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getErrorCode()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("error"), JSValueMakeNumber(p_obj->_ctx, evt->getErrorCode()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -1143,66 +916,28 @@ public:
 	 */
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
+		static const char* const kNames[] = { "time", "bitRate", "description", "width", "height", "framerate", "position",
+			"cappedProfile", "displayWidth", "displayHeight", "progressive", "aspectRatioWidth", "aspectRatioHeight" };
+		static const auto bitrateTemplate = aamp_MakeJSObjectTemplate(kNames);
 		BitrateChangeEventPtr evt = std::dynamic_pointer_cast<BitrateChangeEvent>(ev);
-		JSStringRef name;
-		name = JSStringCreateWithUTF8CString("time");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getTime()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("bitRate");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getBitrate()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("description");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, aamp_CStringToJSValue(p_obj->_ctx, evt->getDescription().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("width");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getWidth()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("height");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getHeight()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("framerate");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getFrameRate()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("position");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getPosition()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("cappedProfile");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getCappedProfileStatus()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("displayWidth");
-                JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getDisplayWidth()), kJSPropertyAttributeReadOnly, NULL);
-                JSStringRelease(name);
-
-		name = JSStringCreateWithUTF8CString("displayHeight");
-                JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getDisplayHeight()), kJSPropertyAttributeReadOnly, NULL);
-                JSStringRelease(name);
-
-		if(eVIDEOSCAN_UNKNOWN != evt->getScanType())
-		{
-			name = JSStringCreateWithUTF8CString("progressive");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeBoolean(p_obj->_ctx, ((eVIDEOSCAN_PROGRESSIVE == evt->getScanType())?true:false)), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(name);
-		}
-
-		if((0 != evt->getAspectRatioWidth()) && (0 != evt->getAspectRatioHeight()))
-		{
-			name = JSStringCreateWithUTF8CString("aspectRatioWidth");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getAspectRatioWidth()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(name);
-
-			name = JSStringCreateWithUTF8CString("aspectRatioHeight");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, name, JSValueMakeNumber(p_obj->_ctx, evt->getAspectRatioHeight()), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(name);
-		}
 
+		bool hasAspectRatio = ((0 != evt->getAspectRatioWidth()) && (0 != evt->getAspectRatioHeight()));
+		// optional properties are NULL when absent and left out by the template
+		const JSValueRef values[] = {
+			JSValueMakeNumber(p_obj->_ctx, evt->getTime()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getBitrate()),
+			aamp_CStringToJSValue(p_obj->_ctx, evt->getDescription().c_str()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getWidth()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getHeight()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getFrameRate()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getPosition()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getCappedProfileStatus()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getDisplayWidth()),
+			JSValueMakeNumber(p_obj->_ctx, evt->getDisplayHeight()),
+			(eVIDEOSCAN_UNKNOWN != evt->getScanType()) ? JSValueMakeBoolean(p_obj->_ctx, (eVIDEOSCAN_PROGRESSIVE == evt->getScanType())) : NULL,
+			hasAspectRatio ? JSValueMakeNumber(p_obj->_ctx, evt->getAspectRatioWidth()) : NULL,
+			hasAspectRatio ? JSValueMakeNumber(p_obj->_ctx, evt->getAspectRatioHeight()) : NULL };
+		bitrateTemplate.SetProperties(p_obj->_ctx, jsEventObj, values);
 	}
 };
 
@@ -1234,49 +969,29 @@ public:
 		ID3MetadataEventPtr evt = std::dynamic_pointer_cast<ID3MetadataEvent>(ev);
 		std::vector<uint8_t> data = evt->getMetadata();
 		int len = evt->getMetadataSize();
-		JSStringRef prop;
-
 		JSValueRef* array = new JSValueRef[len];
 		for (int32_t i = 0; i < len; i++)
 		{
 			array[i] = JSValueMakeNumber(p_obj->_ctx, data[i]);
 		}
-		prop = JSStringCreateWithUTF8CString("schemeIdUri");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getSchemeIdUri().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("schemeIdUri"), aamp_CStringToJSValue(p_obj->_ctx, evt->getSchemeIdUri().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("value");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getValue().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("value"), aamp_CStringToJSValue(p_obj->_ctx, evt->getValue().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("timeScale");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getTimeScale()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("timeScale"), JSValueMakeNumber(p_obj->_ctx, evt->getTimeScale()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("presentationTime");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getPresentationTime()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("presentationTime"), JSValueMakeNumber(p_obj->_ctx, evt->getPresentationTime()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("eventDuration");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getEventDuration()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("eventDuration"), JSValueMakeNumber(p_obj->_ctx, evt->getEventDuration()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("id");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getId()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("id"), JSValueMakeNumber(p_obj->_ctx, evt->getId()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("timestampOffset");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getTimestampOffset()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("timestampOffset"), JSValueMakeNumber(p_obj->_ctx, evt->getTimestampOffset()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("data");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSObjectMakeArray(p_obj->_ctx, len, array, NULL), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("data"), JSObjectMakeArray(p_obj->_ctx, len, array, NULL), kJSPropertyAttributeReadOnly, NULL);
 		SAFE_DELETE_ARRAY(array);
 
-		prop = JSStringCreateWithUTF8CString("length");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, len), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("length"), JSValueMakeNumber(p_obj->_ctx, len), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -1306,11 +1021,7 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		BlockedEventPtr evt = std::dynamic_pointer_cast<BlockedEvent>(ev);
-		JSStringRef prop;
-
-		prop = JSStringCreateWithUTF8CString("reason");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getReason().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("reason"), aamp_CStringToJSValue(p_obj->_ctx, evt->getReason().c_str()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -1340,20 +1051,14 @@ public:
 	void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
 	{
 		ContentGapEventPtr evt = std::dynamic_pointer_cast<ContentGapEvent>(ev);
-		JSStringRef prop;
-
 		double time = evt->getTime();
 		double durationMs = evt->getDuration();
 
-		prop = JSStringCreateWithUTF8CString("time");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, std::round(time)), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("time"), JSValueMakeNumber(p_obj->_ctx, std::round(time)), kJSPropertyAttributeReadOnly, NULL);
 
 		if (durationMs >= 0)
 		{
-			prop = JSStringCreateWithUTF8CString("duration");
-			JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, (int)durationMs), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(prop);
+			JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("duration"), JSValueMakeNumber(p_obj->_ctx, (int)durationMs), kJSPropertyAttributeReadOnly, NULL);
 		}
 	}
 };
@@ -1386,15 +1091,9 @@ public:
 	{
 		HTTPResponseHeaderEventPtr evt = std::dynamic_pointer_cast<HTTPResponseHeaderEvent>(ev);
 
-		JSStringRef prop;
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("header"), aamp_CStringToJSValue(p_obj->_ctx, evt->getHeader().c_str()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("header");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getHeader().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
-
-		prop = JSStringCreateWithUTF8CString("response");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getResponse().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("response"), aamp_CStringToJSValue(p_obj->_ctx, evt->getResponse().c_str()), kJSPropertyAttributeReadOnly, NULL);
 	}
 };
 
@@ -1424,19 +1123,11 @@ public:
         void SetEventProperties(const AAMPEventPtr& ev, JSObjectRef jsEventObj)
         {
                 WatermarkSessionUpdateEventPtr evt = std::dynamic_pointer_cast<WatermarkSessionUpdateEvent>(ev);
-                JSStringRef prop;
-
-		prop = JSStringCreateWithUTF8CString("sessionHandle");
-                JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getSessionHandle()), kJSPropertyAttributeReadOnly, NULL);
-                JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("sessionHandle"), JSValueMakeNumber(p_obj->_ctx, evt->getSessionHandle()), kJSPropertyAttributeReadOnly, NULL);
 
-		prop = JSStringCreateWithUTF8CString("status");
-                JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSValueMakeNumber(p_obj->_ctx, evt->getStatus()), kJSPropertyAttributeReadOnly, NULL);
-                JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("status"), JSValueMakeNumber(p_obj->_ctx, evt->getStatus()), kJSPropertyAttributeReadOnly, NULL);
 
-                prop = JSStringCreateWithUTF8CString("system");
-                JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getSystem().c_str()), kJSPropertyAttributeReadOnly, NULL);
-                JSStringRelease(prop);
+                JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("system"), aamp_CStringToJSValue(p_obj->_ctx, evt->getSystem().c_str()), kJSPropertyAttributeReadOnly, NULL);
         }
 };
 
@@ -1469,21 +1160,16 @@ public:
 		ContentProtectionDataEventPtr evt = std::dynamic_pointer_cast<ContentProtectionDataEvent>(ev);
 		std::vector<uint8_t> keyId = evt->getKeyID();
 		int len = keyId.size();
-		JSStringRef prop;
 		JSValueRef* array = new JSValueRef[len];
 		for (int32_t i = 0; i < len; i++)
 		{
 			array[i] = JSValueMakeNumber(p_obj->_ctx, keyId[i]);
 		}
 
-		prop = JSStringCreateWithUTF8CString("keyID");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, JSObjectMakeArray(p_obj->_ctx, len, array, NULL), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("keyID"), JSObjectMakeArray(p_obj->_ctx, len, array, NULL), kJSPropertyAttributeReadOnly, NULL);
 		SAFE_DELETE_ARRAY(array);
 
-		prop = JSStringCreateWithUTF8CString("streamType");
-		JSObjectSetProperty(p_obj->_ctx, jsEventObj, prop, aamp_CStringToJSValue(p_obj->_ctx, evt->getStreamType().c_str()), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(prop);
+		JSObjectSetProperty(p_obj->_ctx, jsEventObj, aamp_GetJSPropertyName("streamType"), aamp_CStringToJSValue(p_obj->_ctx, evt->getStreamType().c_str()), kJSPropertyAttributeReadOnly, NULL);
 	}
 
 };
@@ -30,6 +30,8 @@
 
 #include <iomanip>
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
 
 #ifdef USE_SYSLOG_HELPER_PRINT
 #include "syslog_helper_ifc.h"
@@ -388,6 +390,56 @@ const char* aampPlayer_getNameFromEventType(AAMPEventType type)
 }
 
 
+/**
+ * @struct JSPropertyNameHash
+ * @brief Hash of C string content, property names are looked up without copying them
+ */
+struct JSPropertyNameHash
+{
+	size_t operator()(const char* name) const
+	{
+		size_t hash = 5381;
+		for (; *name != '\0'; name++)
+		{
+			hash = (hash * 33) ^ (unsigned char)*name;
+		}
+		return hash;
+	}
+};
+
+/**
+ * @struct JSPropertyNameEqual
+ * @brief Compare C string content
+ */
+struct JSPropertyNameEqual
+{
+	bool operator()(const char* a, const char* b) const
+	{
+		return strcmp(a, b) == 0;
+	}
+};
+
+/**
+ * @brief Get interned JSString of a property name
+ */
+JSStringRef aamp_GetJSPropertyName(const char* name)
+{
+	// JSStrings are not bound to a context, one cache serves all players
+	static std::mutex cacheMutex;
+	static std::unordered_map<const char*, JSStringRef, JSPropertyNameHash, JSPropertyNameEqual> cache;
+	std::lock_guard<std::mutex> guard(cacheMutex);
+	auto it = cache.find(name);
+	if (it != cache.end())
+	{
+		return it->second;
+	}
+	JSStringRef jsName = JSStringCreateWithUTF8CString(name);
+	// key points to a copy owned by the cache
+	char* key = strdup(name);
+	cache[key] = jsName;
+	return jsName;
+}
+
 /**
  * @brief Create a TimedMetadata JS object with args passed.
  *        Sample input "#EXT-X-CUE:ID=eae90713-db8e,DURATION=30.063"
@@ -403,47 +455,33 @@ JSObjectRef aamp_CreateTimedMetadataJSObject(JSContextRef context, long long tim
 		JSValueProtect(context, timedMetadata);
 		bool bGenerateID = true;
 
-		name = JSStringCreateWithUTF8CString("time");
-		JSObjectSetProperty(context, timedMetadata, name, JSValueMakeNumber(context, std::round(timeMS)), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
+		JSObjectSetProperty(context, timedMetadata, aamp_GetJSPropertyName("time"), JSValueMakeNumber(context, std::round(timeMS)), kJSPropertyAttributeReadOnly, NULL);
 
 		// For SCTE35 tag, set id as value of key reservationId
 		if(!strcmp(szName, "SCTE35") && id && *id != '\0')
 		{
-			name = JSStringCreateWithUTF8CString("reservationId");
-			JSObjectSetProperty(context, timedMetadata, name, aamp_CStringToJSValue(context, id), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(name);
+			JSObjectSetProperty(context, timedMetadata, aamp_GetJSPropertyName("reservationId"), aamp_CStringToJSValue(context, id), kJSPropertyAttributeReadOnly, NULL);
 			bGenerateID = false;
 		}
 
 		if (durationMS >= 0)
 		{
-			name = JSStringCreateWithUTF8CString("duration");
-			JSObjectSetProperty(context, timedMetadata, name, JSValueMakeNumber(context, (int)durationMS), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(name);
+			JSObjectSetProperty(context, timedMetadata, aamp_GetJSPropertyName("duration"), JSValueMakeNumber(context, (int)durationMS), kJSPropertyAttributeReadOnly, NULL);
 		}
 
-		name = JSStringCreateWithUTF8CString("name");
-		JSObjectSetProperty(context, timedMetadata, name, aamp_CStringToJSValue(context, szName), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
+		JSObjectSetProperty(context, timedMetadata, aamp_GetJSPropertyName("name"), aamp_CStringToJSValue(context, szName), kJSPropertyAttributeReadOnly, NULL);
 
-		name = JSStringCreateWithUTF8CString("content");
-		JSObjectSetProperty(context, timedMetadata, name, aamp_CStringToJSValue(context, szContent), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
+		JSObjectSetProperty(context, timedMetadata, aamp_GetJSPropertyName("content"), aamp_CStringToJSValue(context, szContent), kJSPropertyAttributeReadOnly, NULL);
 
 		// Force type=0 (HLS tag) for now.
 		// Does type=1 ID3 need to be supported?
-		name = JSStringCreateWithUTF8CString("type");
-		JSObjectSetProperty(context, timedMetadata, name, JSValueMakeNumber(context, 0), kJSPropertyAttributeReadOnly, NULL);
-		JSStringRelease(name);
+		JSObjectSetProperty(context, timedMetadata, aamp_GetJSPropertyName("type"), JSValueMakeNumber(context, 0), kJSPropertyAttributeReadOnly, NULL);
 
 		// Force metadata as empty object
 		JSObjectRef metadata = JSObjectMake(context, NULL, NULL);
 		if (metadata) {
 			JSValueProtect(context, metadata);
-			name = JSStringCreateWithUTF8CString("metadata");
-			JSObjectSetProperty(context, timedMetadata, name, metadata, kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(name);
+			JSObjectSetProperty(context, timedMetadata, aamp_GetJSPropertyName("metadata"), metadata, kJSPropertyAttributeReadOnly, NULL);
 
 			// Parse CUE metadata and TRICKMODE-RESTRICTION metadata
 			// Parsed values are used in PlayerPlatform at the time of tag object creation
@@ -483,9 +521,7 @@ JSObjectRef aamp_CreateTimedMetadataJSObject(JSContextRef context, long long tim
 						// If we just added the 'ID', copy into timedMetadata.id
 						if (szStart[0] == 'I' && szStart[1] == 'D' && szStart[2] == '=') {
 							bGenerateID = false;
-							name = JSStringCreateWithUTF8CString("id");
-							JSObjectSetProperty(context, timedMetadata, name, value, kJSPropertyAttributeReadOnly, NULL);
-							JSStringRelease(name);
+							JSObjectSetProperty(context, timedMetadata, aamp_GetJSPropertyName("id"), value, kJSPropertyAttributeReadOnly, NULL);
 						}
 					}
 
@@ -505,12 +541,11 @@ JSObjectRef aamp_CreateTimedMetadataJSObject(JSContextRef context, long long tim
 				if (strcmp(szName, "#EXT-X-TARGETDURATION") == 0) {
 					// Stuff into DURATION if EXT-X-TARGETDURATION content.
 					// Since #EXT-X-TARGETDURATION has only duration as value
-					name = JSStringCreateWithUTF8CString("DURATION");
+					name = aamp_GetJSPropertyName("DURATION");
 				} else {
-					name = JSStringCreateWithUTF8CString("DATA");
+					name = aamp_GetJSPropertyName("DATA");
 				}
 				JSObjectSetProperty(context, metadata, name, value, kJSPropertyAttributeReadOnly, NULL);
-				JSStringRelease(name);
 			}
 			JSValueUnprotect(context, metadata);
 		}
@@ -525,9 +560,7 @@ JSObjectRef aamp_CreateTimedMetadataJSObject(JSContextRef context, long long tim
 
 			char buf[32];
 			sprintf(buf, "%d", hash);
-			name = JSStringCreateWithUTF8CString("id");
-			JSObjectSetProperty(context, timedMetadata, name, aamp_CStringToJSValue(context, buf), kJSPropertyAttributeReadOnly, NULL);
-			JSStringRelease(name);
+			JSObjectSetProperty(context, timedMetadata, aamp_GetJSPropertyName("id"), aamp_CStringToJSValue(context, buf), kJSPropertyAttributeReadOnly, NULL);
 		}
 		JSValueUnprotect(context, timedMetadata);
 	}
@@ -149,6 +149,70 @@ AAMPEventType aampPlayer_getEventTypeFromName(const char* szName);
  */
 const char* aampPlayer_getNameFromEventType(AAMPEventType type);
 
+/**
+ * @fn aamp_GetJSPropertyName
+ * @brief Interned JSString of a fixed property name, created on first use and kept for the process
+ * @param[in] name property name, not a value taken from content as names are never released
+ * @retval JSString of the name, owned by the cache
+ */
+JSStringRef aamp_GetJSPropertyName(const char* name);
+
+/**
+ * @class AampJSObjectTemplate
+ * @brief Fixed list of read only properties set in the same order on each object built
+ *
+ * Names are interned once, building an event object is then one JSObjectSetProperty per
+ * value. Objects built from a template get their properties in the same order, so
+ * JavaScriptCore shares the structure of all of them.
+ */
+template <size_t N>
+class AampJSObjectTemplate
+{
+public:
+	/**
+	 * @brief AampJSObjectTemplate Constructor
+	 * @param[in] names property names
+	 */
+	explicit AampJSObjectTemplate(const char* const (&names)[N]) : mNames()
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			mNames[i] = aamp_GetJSPropertyName(names[i]);
+		}
+	}
+
+	/**
+	 * @brief Set properties of an object
+	 * @param[in] context JS execution context
+	 * @param[in] object object to set properties of
+	 * @param[in] values value of each name, properties with NULL value are left out
+	 */
+	void SetProperties(JSContextRef context, JSObjectRef object, const JSValueRef (&values)[N]) const
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			if (values[i] != NULL)
+			{
+				JSObjectSetProperty(context, object, mNames[i], values[i], kJSPropertyAttributeReadOnly, NULL);
+			}
+		}
+	}
+
+private:
+	JSStringRef mNames[N];
+};
+
+/**
+ * @brief Create template of an event object
+ * @param[in] names property names
+ * @retval template with the names interned
+ */
+template <size_t N>
+AampJSObjectTemplate<N> aamp_MakeJSObjectTemplate(const char* const (&names)[N])
+{
+	return AampJSObjectTemplate<N>(names);
+}
+
 /**
  * @fn aamp_CreateTimedMetadataJSObject
  * @param[in] context JS execution context
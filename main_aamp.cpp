@@ -1649,6 +1649,14 @@ void PlayerInstanceAAMP::SetPreCacheTimeWindow(int nTimeWindow)
 	SETCONFIGVALUE(AAMP_APPLICATION_SETTING,eAAMPConfig_PreCachePlaylistTime,nTimeWindow);
 }
 
+/**
+ *  @brief Stage likely next channels for fast channel change
+ */
+void PlayerInstanceAAMP::SetPreTuneChannels(const std::vector<std::string> &manifestUrls)
+{
+	aamp->SetPreTuneChannels(manifestUrls);
+}
+
 /**
  *  @brief Set VOD Trickplay FPS.
  */
@@ -1920,17 +1928,15 @@ std::vector<long> PlayerInstanceAAMP::GetVideoBitrates(void)
 std::string PlayerInstanceAAMP::GetManifest(void)
 {
 	ERROR_OR_IDLE_STATE_CHECK_VAL(std::string());
-	GrowableBuffer manifest;
 	ContentType ContentType;
 	if ((aamp->GetContentType() == ContentType_VOD) && (aamp->mMediaFormat == eMEDIAFORMAT_DASH))
 	{
 		std::string manifestUrl = aamp->GetManifestUrl();
-		memset(&manifest, 0, sizeof(manifest));
-		if (aamp->getAampCacheHandler()->RetrieveFromPlaylistCache(manifestUrl, &manifest, manifestUrl))
+		AampCachedFilePtr cachedManifest = aamp->getAampCacheHandler()->BorrowFromPlaylistCache(manifestUrl);
+		if (cachedManifest)
 		{
-			/*char pointer to string conversion*/
-			std::string Manifest(manifest.ptr,manifest.len);
-			aamp_Free(&manifest);
+			/*cached data to string conversion, the only copy taken*/
+			std::string Manifest(cachedManifest->data.begin(), cachedManifest->data.end());
 			AAMPLOG_INFO("PlayerInstanceAAMP: manifest retrieved from cache");
 			return Manifest;
 		}
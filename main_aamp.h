@@ -1190,6 +1190,17 @@ public:
 	 */
 	void SetPreCacheTimeWindow(int nTimeWindow);
 
+	/**
+	 *   @fn SetPreTuneChannels
+	 *   @brief Keep manifests, init fragments, first segments and AES-128 keys of the likely
+	 *          next channels staged for fast channel change. Memory, age and bandwidth used are
+	 *          bounded by preTuneCacheSize, preTuneMaxAge and preTuneMaxBandwidth
+	 *
+	 *   @param[in] manifestUrls - manifest urls, most likely first; empty to stop
+	 *   @return void
+	 */
+	void SetPreTuneChannels(const std::vector<std::string> &manifestUrls);
+
 	/**
 	 *   @fn SetVODTrickplayFPS
 	 *
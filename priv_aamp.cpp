@@ -25,9 +25,16 @@
 #include "priv_aamp.h"
 #include "AampJsonObject.h"
 #include "isobmffbuffer.h"
+#include "isobmffboxindex.h"
+#include "aamp_aes_stream.h"
 #include "AampFnLogger.h"
 #include "AampConstants.h"
 #include "AampCacheHandler.h"
+#include "AampBufferPool.h"
+#include "AampDownloadEngine.h"
+#include "AampPreTuner.h"
+#include "AampTraceRecorder.h"
+#include "AampReactor.h"
 #include "AampUtils.h"
 #include "iso639map.h"
 #include "fragmentcollector_mpd.h"
@@ -121,6 +128,8 @@
 #define FOG_RECORDING_ID_STRING		"Fog-Recording-Id:"
 #define CAPPED_PROFILE_STRING 		"Profile-Capped:"
 #define TRANSFER_ENCODING_STRING		"Transfer-Encoding:"
+#define ETAG_HEADER_STRING			"ETag:"
+#define LAST_MODIFIED_HEADER_STRING		"Last-Modified:"
 
 #define MAX_DOWNLOAD_DELAY_LIMIT_MS 30000
 
@@ -277,6 +286,46 @@ static constexpr const char *mMediaFormatName[] =
 };
 
 static_assert(sizeof(mMediaFormatName)/sizeof(mMediaFormatName[0]) == (eMEDIAFORMAT_UNKNOWN + 1), "Ensure 1:1 mapping between mMediaFormatName[] and enum MediaFormat");
+/**
+ * @brief Record a download and its dns, connect, tls, first byte and transfer phases as trace spans
+ * @param curl curl handle of completed transfer
+ * @param type media type of file
+ * @param httpCode http status or curl error
+ * @param bytes bytes downloaded
+ * @param endTimeMs steady clock time transfer ended
+ */
+static void TraceDownload(CURL *curl, MediaType type, long httpCode, size_t bytes, long long endTimeMs)
+{
+	double resolve = 0, connect = 0, appConnect = 0, preTransfer = 0, startTransfer = 0, total = 0;
+	curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &resolve);
+	curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect);
+	curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &appConnect);
+	curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME, &preTransfer);
+	curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &startTransfer);
+	curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total);
+	// curl times are cumulative from transfer start; a reused connection has no dns, connect or tls phase
+	const double phaseEnd[] = { resolve, connect, appConnect, startTransfer, total };
+	const char *phaseName[] = { "dns", "connect", "tls", "ttfb", "transfer" };
+	long long startUs = (endTimeMs * 1000) - (long long)(total * 1000000);
+	AampTraceRecorder &recorder = AampTraceRecorder::GetInstance();
+	recorder.AddComplete("network", "download", startUs, (long long)(total * 1000000), "type", type, "http", httpCode, "bytes", (long long)bytes);
+	double phaseStart = 0;
+	for (size_t i = 0; i < sizeof(phaseEnd) / sizeof(phaseEnd[0]); i++)
+	{
+		if (i == 3)
+		{
+			// request is sent after pretransfer, first byte wait starts there
+			phaseStart = std::max(phaseStart, preTransfer);
+		}
+		double phaseStop = std::min(phaseEnd[i], total);
+		if (phaseStop > phaseStart)
+		{
+			recorder.AddComplete("network", phaseName[i], startUs + (long long)(phaseStart * 1000000), (long long)((phaseStop - phaseStart) * 1000000));
+			phaseStart = phaseStop;
+		}
+	}
+}
+
 /**
  * @brief Get the idle task's source ID
  * @retval source ID
@@ -819,6 +868,16 @@ size_t PrivateInstanceAAMP::HandleSSLWriteCallback ( char *ptr, size_t size, siz
     pthread_mutex_lock(&context->aamp->mLock);
     if (context->aamp->mDownloadsEnabled)
     {
+		if ((NULL == context->buffer->ptr) && !context->downloadIsEncoded && ISCONFIGSET_PRIV(eAAMPConfig_EnableFragmentBufferPool) &&
+			(context->fileType == eMEDIATYPE_VIDEO || context->fileType == eMEDIATYPE_AUDIO ||
+			 context->fileType == eMEDIATYPE_SUBTITLE || context->fileType == eMEDIATYPE_AUX_AUDIO ||
+			 context->fileType == eMEDIATYPE_IFRAME))
+		{
+			// Size from Content-Length when known, else pool picks from previous fragment of same type.
+			// Add 2 additional characters to take care of extra characters inserted by aamp_AppendNulTerminator
+			size_t expectedSize = (context->contentLength > 0) ? (context->contentLength + 2) : 0;
+			mFragmentBufferPool->Acquire(context->buffer, expectedSize, context->fileType);
+		}
 		if ((NULL == context->buffer->ptr) && (context->contentLength > 0))
 		{
 			size_t len = context->contentLength + 2;
@@ -861,6 +920,12 @@ size_t PrivateInstanceAAMP::HandleSSLWriteCallback ( char *ptr, size_t size, siz
     }
     pthread_mutex_unlock(&context->aamp->mLock);
 
+	if (ret && context->aesDecryptor && context->buffer->ptr)
+	{
+		// buffer is only touched by this transfer, complete blocks are decrypted in place as they arrive
+		context->aesDecryptor->Update(reinterpret_cast<unsigned char *>(context->buffer->ptr), context->buffer->len);
+	}
+
     return ret;
 }
 /**
@@ -915,6 +980,7 @@ size_t PrivateInstanceAAMP::HandleSSLHeaderCallback ( const char *ptr, size_t si
 	bool isBitrateHeader = false;
 	bool isFogRecordingIdHeader = false;
 	bool isProfileCapHeader = false;
+	bool isValidatorHeader = false;
 
 	if( len<2 || ptr[endPos] != '\r' || ptr[endPos+1] != '\n' )
 	{ // only proceed if this is a CRLF terminated curl header, as expected
@@ -975,6 +1041,17 @@ size_t PrivateInstanceAAMP::HandleSSLHeaderCallback ( const char *ptr, size_t si
 	{
 		context->chunkedDownload = true;
 	}
+	else if (STARTS_WITH_IGNORE_CASE(ptr, ETAG_HEADER_STRING))
+	{
+		startPos = STRLEN_LITERAL(ETAG_HEADER_STRING);
+		isValidatorHeader = true;
+	}
+	else if (STARTS_WITH_IGNORE_CASE(ptr, LAST_MODIFIED_HEADER_STRING) && httpHeader->validator.empty())
+	{
+		// ETag identifies the response version, Last-Modified is only kept if there is none
+		startPos = STRLEN_LITERAL(LAST_MODIFIED_HEADER_STRING);
+		isValidatorHeader = true;
+	}
 	else if (0 == context->buffer->avail)
 	{
 		if (STARTS_WITH_IGNORE_CASE(ptr, CONTENTLENGTH_STRING))
@@ -1037,6 +1114,10 @@ size_t PrivateInstanceAAMP::HandleSSLHeaderCallback ( const char *ptr, size_t si
 			context->aamp->mProfileCappedStatus = atol(strProfileCap)? true : false;
 			AAMPLOG_TRACE("Parsed Profile-Capped Header : %d", context->aamp->mProfileCappedStatus);
 		}
+		else if(isValidatorHeader)
+		{
+			httpHeader->validator = string( ptr + startPos, endPos - startPos );
+		}
 		else
 		{
 			httpHeader->data = string( ptr + startPos, endPos - startPos );
@@ -1174,7 +1255,12 @@ int PrivateInstanceAAMP::HandleSSLProgressCallback ( void *clientp, double dltot
 		int  AbrChunkThresholdSize = 0;
 		GETCONFIGVALUE(eAAMPConfig_ABRChunkThresholdSize,AbrChunkThresholdSize);
 
-		if (/*(dlnow > AbrChunkThresholdSize) &&*/ (context->downloadNow != dlnow))
+		if (aamp->mBandwidthEstimator.IsEnabled())
+		{
+			// only bursts of chunk data are timed, waits for the encoder between chunks are left out
+			context->transferSampler.OnProgress(dlnow, NOW_STEADY_TS_MS, aamp->mBandwidthEstimator);
+		}
+		else if (/*(dlnow > AbrChunkThresholdSize) &&*/ (context->downloadNow != dlnow))
 		{
 			long downloadbps = 0;
 
@@ -1316,10 +1402,45 @@ static int progress_callback(
 
 // End of curl callback functions
 
+/**
+ * @struct FragmentPrefetchRequest
+ * @brief Lookahead fragment download, holds the state a GetFile call keeps on its stack
+ */
+struct FragmentPrefetchRequest : public AampDownloadRequest
+{
+	PrivateInstanceAAMP *aamp;
+	GrowableBuffer buffer;
+	CurlCallbackContext context;
+	CurlProgressCbContext progressCtx;
+	httpRespHeaderData headerData;
+
+	FragmentPrefetchRequest(PrivateInstanceAAMP *_aamp) : AampDownloadRequest(), aamp(_aamp), buffer(), context(_aamp, &buffer), progressCtx(), headerData()
+	{
+		memset(&buffer, 0x00, sizeof(buffer));
+		context.responseHeaderData = &headerData;
+		progressCtx.aamp = _aamp;
+	}
+
+	~FragmentPrefetchRequest()
+	{
+		if (buffer.ptr)
+		{
+			aamp->ReleaseFragmentBuffer(&buffer, type);
+		}
+		if (curl)
+		{
+			curl_easy_cleanup(curl);
+		}
+	}
+
+	FragmentPrefetchRequest(const FragmentPrefetchRequest&) = delete;
+	FragmentPrefetchRequest& operator=(const FragmentPrefetchRequest&) = delete;
+};
+
 /**
  * @brief PrivateInstanceAAMP Constructor
  */
-PrivateInstanceAAMP::PrivateInstanceAAMP(AampConfig *config) : mReportProgressPosn(0.0), mAbrBitrateData(), mLock(), mMutexAttr(),
+PrivateInstanceAAMP::PrivateInstanceAAMP(AampConfig *config) : mReportProgressPosn(0.0), mAbrBitrateData(), mBandwidthEstimator(), mLock(), mMutexAttr(),
 	mpStreamAbstractionAAMP(NULL), mInitSuccess(false), mVideoFormat(FORMAT_INVALID), mAudioFormat(FORMAT_INVALID), mDownloadsDisabled(),
 	mDownloadsEnabled(true), mStreamSink(NULL), profiler(), licenceFromManifest(false), previousAudioType(eAUDIO_UNKNOWN),isPreferredDRMConfigured(false),
 	mbDownloadsBlocked(false), streamerIsActive(false), mTSBEnabled(false), mIscDVR(false), mLiveOffset(AAMP_LIVE_OFFSET),
@@ -1345,6 +1466,13 @@ PrivateInstanceAAMP::PrivateInstanceAAMP(AampConfig *config) : mReportProgressPo
 	,mBufUnderFlowStatus(false), mVideoBasePTS(0)
 	,mCustomLicenseHeaders(), mIsIframeTrackPresent(false), mManifestTimeoutMs(-1), mNetworkTimeoutMs(-1)
 	,mbPlayEnabled(true), mPlayerPreBuffered(false), mPlayerId(PLAYERID_CNTR++),mAampCacheHandler(NULL)
+	,mFragmentBufferPool()
+	,mDownloadEngine()
+	,mPreTuner()
+	,mPreTunedFiles()
+	,mPreTunedFilesMutex()
+	,mBorrowedFragments()
+	,mBorrowedFragmentsMutex()
 	,mAsyncTuneEnabled(false) 
 	,waitforplaystart() 
 	,mCurlShared(NULL)
@@ -1358,7 +1486,8 @@ PrivateInstanceAAMP::PrivateInstanceAAMP(AampConfig *config) : mReportProgressPo
 #if defined(AAMP_MPD_DRM) || defined(AAMP_HLS_DRM)
 	, mDRMSessionManager(NULL)
 #endif
-	,  mPreCachePlaylistThreadId(0), mPreCachePlaylistThreadFlag(false) , mPreCacheDnldList()
+	,  mPreCachePlaylistTaskId(AAMP_REACTOR_TASK_ID_INVALID), mPreCacheDnldIndex(0), mPreCacheDnldWaited(false)
+	, mPreCacheCurlInitialized(false), mPreCacheDnldList()
 	, mPreCacheDnldTimeWindow(0), mParallelPlaylistFetchLock(), mAppName()
 	, mProgressReportFromProcessDiscontinuity(false)
 	, mPlaylistFetchFailError(0L),mAudioDecoderStreamSync(true)
@@ -1478,6 +1607,9 @@ PrivateInstanceAAMP::PrivateInstanceAAMP(AampConfig *config) : mReportProgressPo
 	mLogObj = mConfig->GetLoggerInstance();
 	//LazilyLoadConfigIfNeeded();
 	mAampCacheHandler = new AampCacheHandler(mConfig->GetLoggerInstance());
+	mFragmentBufferPool = std::make_shared<AampBufferPool>(mLogObj, DEFAULT_FRAGMENT_BUFFER_POOL_SIZE*1024);
+	mDownloadEngine = std::make_shared<AampDownloadEngine>(mLogObj, DEFAULT_DOWNLOAD_ENGINE_MAX_TRANSFERS);
+	mPreTuner = std::make_shared<AampPreTuner>(mLogObj);
 #ifdef AAMP_CC_ENABLED
 	AampCCManager::GetInstance()->SetLogger(mConfig->GetLoggerInstance());
 #endif
@@ -1593,6 +1725,10 @@ PrivateInstanceAAMP::~PrivateInstanceAAMP()
 	}
 	pthread_mutex_unlock(&gMutex);
 
+	// transfer callbacks use player state, event loop has to be gone first
+	mDownloadEngine->Stop();
+	mPreTuner->SetChannels(std::vector<std::string>());
+
 	pthread_mutex_lock(&mLock);
 
 	SAFE_DELETE(mVideoEnd);
@@ -2518,6 +2654,8 @@ void PrivateInstanceAAMP::SendErrorEvent(AAMPTuneFailure tuneFailure, const char
 		int code;
 		const char *errorDescription = NULL;
 		DisableDownloads();
+		// no first frame will resume staging of next channels
+		mPreTuner->SetPaused(false);
 		if(tuneFailure >= 0 && tuneFailure < AAMP_TUNE_FAILURE_UNKNOWN)
 		{
 			if (tuneFailure == AAMP_TUNE_PLAYBACK_STALLED)
@@ -3079,10 +3217,23 @@ void PrivateInstanceAAMP::TuneFail(bool fail)
 	{
 		LogPlayerPreBuffered();        //Need to calculate prebufferedtime when tune interruption happens with playerprebuffer
 	}
+	UpdateProfilerConnectionStats();
 	profiler.TuneEnd(mTuneMetrics, mAppName,(mbPlayEnabled?STRFGPLAYER:STRBGPLAYER), mPlayerId, mPlayerPreBuffered, durationSeconds, activeInterfaceWifi,mFailureReason);
 	AdditionalTuneFailLogEntries();
 }
 
+/**
+ * @brief Pass HTTP/2 connection usage of download engine to profiler
+ */
+void PrivateInstanceAAMP::UpdateProfilerConnectionStats(void)
+{
+	if(ISCONFIGSET_PRIV(eAAMPConfig_EnableHttp2Multiplex) && mDownloadEngine->IsRunning())
+	{
+		AampDownloadEngineStats engineStats = mDownloadEngine->GetStats();
+		profiler.SetConnectionStreamConcurrency((int)engineStats.connects, engineStats.peakStreamsPerConnection);
+	}
+}
+
 /**
  *  @brief Notify tune end for profiling/logging
  */
@@ -3099,6 +3250,7 @@ void PrivateInstanceAAMP::LogTuneComplete(void)
 	mTuneMetrics.mTuneAttempts 		 = mTuneAttempts;
 	mTuneMetrics.streamType 		 = streamType;
 	mTuneMetrics.mTSBEnabled                 = mTSBEnabled;
+	UpdateProfilerConnectionStats();
 	profiler.TuneEnd(mTuneMetrics,mAppName,(mbPlayEnabled?STRFGPLAYER:STRBGPLAYER), mPlayerId, mPlayerPreBuffered, durationSeconds, activeInterfaceWifi,mFailureReason);
 	//update tunedManifestUrl if FOG was NOT used as manifestUrl might be updated with redirected url.
 	if(!IsTSBSupported())
@@ -3450,6 +3602,7 @@ void PrivateInstanceAAMP::ResetCurrentlyAvailableBandwidth(long bitsPerSecond ,
 		mAbrBitrateData.erase(mAbrBitrateData.begin(),mAbrBitrateData.end());
 	}
 	pthread_mutex_unlock(&mLock);
+	mBandwidthEstimator.Reset();
 }
 
 /**
@@ -3464,17 +3617,29 @@ long PrivateInstanceAAMP::GetCurrentlyAvailableBandwidth(void)
 	// 3. if any outliers  , remove those entries based on a threshold value.
 	// 4. Get the average of remaining data. 
 	// 5. if no item in the list , return -1 . Caller to ignore bandwidth based processing
+	// With bandwidthEstimator set, estimate is kept up to date as samples arrive and read without lock
 	
 	std::vector< long> tmpData;
 	long ret = -1;
-	pthread_mutex_lock(&mLock);
-	mhAbrManager.UpdateABRBitrateDataBasedOnCacheLife(mAbrBitrateData,tmpData);
-	pthread_mutex_unlock(&mLock);
+	bool estimated = mBandwidthEstimator.IsEnabled();
+	if (estimated)
+	{
+		ret = mBandwidthEstimator.GetEstimate(NOW_STEADY_TS_MS);
+	}
+	else
+	{
+		pthread_mutex_lock(&mLock);
+		mhAbrManager.UpdateABRBitrateDataBasedOnCacheLife(mAbrBitrateData,tmpData);
+		pthread_mutex_unlock(&mLock);
+	}
 		
-		if (tmpData.size())
+		if ((estimated && ret > 0) || tmpData.size())
 		{
 			//AAMPLOG_WARN("NwBW with newlogic size[%d] avg[%ld] ",tmpData.size(), avg/tmpData.size());
-			ret =mhAbrManager.UpdateABRBitrateDataBasedOnCacheOutlier(tmpData);
+			if (!estimated)
+			{
+				ret =mhAbrManager.UpdateABRBitrateDataBasedOnCacheOutlier(tmpData);
+			}
 			mAvailableBandwidth = ret;
 			//Store the PersistBandwidth and UpdatedTime on ABRManager
 			//Bitrate Update only for foreground player
@@ -3629,7 +3794,7 @@ bool PrivateInstanceAAMP::GetNetworkTime(enum UtcTiming timingType, const std::s
 bool PrivateInstanceAAMP::GetFile(std::string remoteUrl,struct GrowableBuffer *buffer, std::string& effectiveUrl,
 				long * http_error, double *downloadTime, const char *range, unsigned int curlInstance, 
 				bool resetBuffer, MediaType fileType, long *bitrate, int * fogError,
-				double fragmentDurationSeconds,CMCDHeaders *pCMCDMetrics)
+				double fragmentDurationSeconds,CMCDHeaders *pCMCDMetrics, AesStreamDecryptor *aesDecryptor)
 {
 	MediaType simType = fileType; // remember the requested specific file type; fileType gets overridden later with simple VIDEO/AUDIO
 	MediaTypeTelemetry mediaType = aamp_GetMediaTypeForTelemetry(fileType);
@@ -3668,6 +3833,43 @@ bool PrivateInstanceAAMP::GetFile(std::string remoteUrl,struct GrowableBuffer *b
         	}	
 		memset(buffer, 0x00, sizeof(*buffer));
 	}
+	if (mDownloadsEnabled && (NULL == range) && (NULL == buffer->ptr))
+	{
+		std::shared_ptr<const AampCachedFile> preTuned = TakePreTunedFile(remoteUrl);
+		if (preTuned)
+		{
+			AAMPLOG_INFO("aamp url:%d,%d,%d from pre-tune len:%zu %s", mediaType, simType, curlInstance, preTuned->data.size(), remoteUrl.c_str());
+			aamp_AppendBytes(buffer, preTuned->data.data(), preTuned->data.size());
+			if (aesDecryptor && buffer->ptr)
+			{
+				aesDecryptor->Update(reinterpret_cast<unsigned char *>(buffer->ptr), buffer->len);
+			}
+			effectiveUrl = preTuned->effectiveUrl;
+			// staged files skip the transfer, record their bucket and request end so tune profiling stays complete
+			ProfilerBucketType bucketType = mediaType2Bucket(simType);
+			profiler.ProfileBegin(bucketType);
+			profiler.ProfileEnd(bucketType);
+			if (gpGlobalConfig->logging.isLogLevelAllowed(eLOGLEVEL_INFO))
+			{
+				std::string appName;
+				if (!mAppName.empty())
+				{
+					appName = mAppName + ",";
+				}
+				AAMPLOG(mLogObj, eLOGLEVEL_INFO, "WARN", "HttpRequestEnd: %s%d,%d,%ld%s,%2.4f,%2.4f,%2.4f,%2.4f,%2.4f,%2.4f,%2.4f,%2.4f,%g,%ld,%ld,%ld,%.500s",
+					appName.c_str(), mediaType, simType, 200L, "", 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, (double)preTuned->data.size(), 0L, 0L, 0L, effectiveUrl.c_str());
+			}
+			if (http_error)
+			{
+				*http_error = 200;
+			}
+			if (downloadTime)
+			{
+				*downloadTime = 0;
+			}
+			return true;
+		}
+	}
 	if (mDownloadsEnabled)
 	{
 		int downloadTimeMS = 0;
@@ -3716,6 +3918,30 @@ bool PrivateInstanceAAMP::GetFile(std::string remoteUrl,struct GrowableBuffer *b
 
 		AAMPLOG_INFO("aamp url:%d,%d,%d,%f,%s", mediaType, simType, curlInstance,fragmentDurationSeconds, remoteUrl.c_str());
 		CurlCallbackContext context;
+		// lookahead download of this fragment, if download engine has one; holds the easy handle used for getinfo below
+		std::shared_ptr<AampDownloadRequest> prefetched;
+		FragmentPrefetchRequest *prefetch = NULL;
+		if ((NULL == buffer->ptr) && (simType == eMEDIATYPE_VIDEO || simType == eMEDIATYPE_AUDIO || simType == eMEDIATYPE_AUX_AUDIO || simType == eMEDIATYPE_SUBTITLE ||
+			simType == eMEDIATYPE_INIT_VIDEO || simType == eMEDIATYPE_INIT_AUDIO || simType == eMEDIATYPE_INIT_AUX_AUDIO || simType == eMEDIATYPE_INIT_SUBTITLE))
+		{
+			prefetched = mDownloadEngine->ClaimPrefetch(simType, remoteUrl, range ? range : "");
+			if (prefetched)
+			{
+				long prefetchHttpCode = 0;
+				prefetch = static_cast<FragmentPrefetchRequest *>(prefetched.get());
+				if (CURLE_OK == prefetch->result)
+				{
+					curl_easy_getinfo(prefetch->curl, CURLINFO_RESPONSE_CODE, &prefetchHttpCode);
+				}
+				if (prefetchHttpCode != 200 && prefetchHttpCode != 206)
+				{
+					// errors are handled (and retried) by regular download
+					AAMPLOG_WARN("Prefetch failed res:%d http:%ld, downloading again url:%s", prefetch->result, prefetchHttpCode, remoteUrl.c_str());
+					prefetch = NULL;
+					prefetched.reset();
+				}
+			}
+		}
 		if (curl)
 		{
 			CURL_EASY_SETOPT(curl, CURLOPT_URL, remoteUrl.c_str());
@@ -3724,10 +3950,22 @@ bool PrivateInstanceAAMP::GetFile(std::string remoteUrl,struct GrowableBuffer *b
 				CURL_EASY_SETOPT(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
 				context.remoteUrl = remoteUrl;
 			}
+			else if(ISCONFIGSET_PRIV(eAAMPConfig_EnableHttp2Multiplex))
+			{
+				// https only, plain http stays on HTTP/1.1
+				CURL_EASY_SETOPT(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+			}
+			else
+			{
+				// handle is reused, undo a previous multiplex setting
+				CURL_EASY_SETOPT(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+			}
 			context.aamp = this;
 			context.buffer = buffer;
 			context.responseHeaderData = &httpRespHeaders[curlInstance];
+			httpRespHeaders[curlInstance].validator.clear();
 			context.fileType = simType;
+			context.aesDecryptor = aesDecryptor;
 			
 			if(!this->mAampLLDashServiceData.lowLatencyMode)
 			{
@@ -3934,6 +4172,7 @@ bool PrivateInstanceAAMP::GetFile(std::string remoteUrl,struct GrowableBuffer *b
 			while(downloadAttempt < maxDownloadAttempt)
 			{
 				progressCtx.downloadStartTime = NOW_STEADY_TS_MS;
+				progressCtx.transferSampler.Start(progressCtx.downloadStartTime);
 								
 				if(this->mAampLLDashServiceData.lowLatencyMode)
 				{
@@ -3950,12 +4189,43 @@ bool PrivateInstanceAAMP::GetFile(std::string remoteUrl,struct GrowableBuffer *b
 					AAMPLOG_WARN("reset length. buffer %p avail %d",  buffer, (int)buffer->avail);
 					buffer->len = 0;
 				}
+				if(aesDecryptor)
+				{
+					// new attempt refills buffer from start
+					aesDecryptor->Restart();
+				}
 
 				isDownloadStalled = false;
 				abortReason = eCURL_ABORT_REASON_NONE;
 
 				long long tStartTime = NOW_STEADY_TS_MS;
-				CURLcode res = curl_easy_perform(curl); // synchronous; callbacks allow interruption
+				CURLcode res;
+				if (prefetch)
+				{ // already downloaded by download engine, take over the transfer
+					tStartTime = prefetch->startTimeMs;
+					res = prefetch->result;
+					*buffer = prefetch->buffer;
+					memset(&prefetch->buffer, 0x00, sizeof(GrowableBuffer));
+					context.downloadIsEncoded = prefetch->context.downloadIsEncoded;
+					context.bitrate = prefetch->context.bitrate;
+					context.allResponseHeadersForErrorLogging = prefetch->context.allResponseHeadersForErrorLogging;
+					if (prefetch->headerData.data.length() > 0)
+					{
+						httpRespHeaders[curlInstance] = prefetch->headerData;
+					}
+					httpRespHeaders[curlInstance].validator = prefetch->headerData.validator;
+					curl = prefetch->curl;
+					AAMPLOG_INFO("Prefetched fragment type:%d len:%zu url:%s", simType, buffer->len, remoteUrl.c_str());
+				}
+				else if(this->mAampLLDashServiceData.lowLatencyMode)
+				{
+					// chunk handover blocks in the write callback, a shared engine thread would stall every other transfer
+					res = curl_easy_perform(curl); // synchronous; callbacks allow interruption
+				}
+				else
+				{
+					res = mDownloadEngine->Perform(curl, AampDownloadEngine::GetPriorityForMediaType(simType)); // synchronous; callbacks allow interruption
+				}
 
 				if(!mAampLLDashServiceData.lowLatencyMode)
 				{
@@ -3968,7 +4238,7 @@ bool PrivateInstanceAAMP::GetFile(std::string remoteUrl,struct GrowableBuffer *b
 					}
 				}
 
-				long long tEndTime = NOW_STEADY_TS_MS;
+				long long tEndTime = prefetch ? prefetch->endTimeMs : NOW_STEADY_TS_MS;
 				downloadAttempt++;
 
 				downloadTimeMS = (int)(tEndTime - tStartTime);
@@ -4205,6 +4475,10 @@ bool PrivateInstanceAAMP::GetFile(std::string remoteUrl,struct GrowableBuffer *b
 				curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect);
 				connectTime = connect;
 				fileDownloadTime = total;
+				if (AampTraceRecorder::IsEnabled())
+				{
+					TraceDownload(curl, simType, http_code, buffer->len, tEndTime);
+				}
 				if(res != CURLE_OK || http_code == 0 || http_code >= 400 || total > 2.0 /*seconds*/)
 				{
 					reqEndLogLevel = eLOGLEVEL_WARN;
@@ -4266,7 +4540,19 @@ bool PrivateInstanceAAMP::GetFile(std::string remoteUrl,struct GrowableBuffer *b
 				GETCONFIGVALUE_PRIV(eAAMPConfig_ABRThresholdSize,AbrThresholdSize);
 				//HybridABRManager mhABRManager;
 				HybridABRManager::CurlAbortReason hybridabortReason = (HybridABRManager::CurlAbortReason) abortReason;
-				if((buffer->len > AbrThresholdSize) && (!GetLLDashServiceData()->lowLatencyMode ||
+				bool lowLatencyABR = GetLLDashServiceData()->lowLatencyMode && !ISCONFIGSET_PRIV(eAAMPConfig_DisableLowLatencyABR);
+				if (mBandwidthEstimator.IsEnabled())
+				{
+					if (lowLatencyABR)
+					{
+						progressCtx.transferSampler.Finish(buffer->len, NOW_STEADY_TS_MS, mBandwidthEstimator);
+					}
+					else if (buffer->len > AbrThresholdSize)
+					{
+						mBandwidthEstimator.AddSample(buffer->len, downloadTimeMS, NOW_STEADY_TS_MS);
+					}
+				}
+				else if((buffer->len > AbrThresholdSize) && (!GetLLDashServiceData()->lowLatencyMode ||
                                         ( GetLLDashServiceData()->lowLatencyMode  && ISCONFIGSET_PRIV(eAAMPConfig_DisableLowLatencyABR))))
 				{
 					long currentProfilebps  = mpStreamAbstractionAAMP->GetVideoBitrate();
@@ -4685,6 +4971,8 @@ bool PrivateInstanceAAMP::ProcessCustomCurlRequest(std::string& remoteUrl, Growa
  */
 void PrivateInstanceAAMP::TeardownStream(bool newTune)
 {
+	// lookahead downloads are for the position being torn down
+	mDownloadEngine->CancelPrefetch(eMEDIATYPE_DEFAULT);
 	pthread_mutex_lock(&mLock);
 	//Have to perfom this for trick and stop operations but avoid ad insertion related ones
 	AAMPLOG_WARN(" mProgressReportFromProcessDiscontinuity:%d mDiscontinuityTuneOperationId:%d newTune:%d", mProgressReportFromProcessDiscontinuity, mDiscontinuityTuneOperationId, newTune);
@@ -5460,6 +5748,9 @@ void PrivateInstanceAAMP::Tune(const char *mainManifestUrl, bool autoPlay, const
 	// Set the EventManager config
 	// TODO When faketune code is added later , push the faketune status here 
 	mEventManager->SetAsyncTuneState(mAsyncTuneEnabled);
+	mEventManager->SetBatchDispatch(ISCONFIGSET_PRIV(eAAMPConfig_BatchEventDispatch));
+	GETCONFIGVALUE_PRIV(eAAMPConfig_EventRateLimit,intTmpVar);
+	mEventManager->SetEventRateLimit(AAMP_EVENT_ALL_EVENTS, intTmpVar);
 	mIsFakeTune = strcasestr(mainManifestUrl, "fakeTune=true");
 	if(mIsFakeTune)
 	{
@@ -5486,6 +5777,11 @@ void PrivateInstanceAAMP::Tune(const char *mainManifestUrl, bool autoPlay, const
 		{
 			LoadAampAbrConfig();
 		}
+		int bandwidthEstimator = eBANDWIDTH_ESTIMATOR_HYBRID_ABR;
+		int abrCacheLife = DEFAULT_ABR_CACHE_LIFE;
+		GETCONFIGVALUE_PRIV(eAAMPConfig_BandwidthEstimator,bandwidthEstimator);
+		GETCONFIGVALUE_PRIV(eAAMPConfig_ABRCacheLife,abrCacheLife);
+		mBandwidthEstimator.Configure(bandwidthEstimator, abrCacheLife);
 	}
 	//temporary hack for peacock
 	if (STARTS_WITH_IGNORE_CASE(mAppName.c_str(), "peacock"))
@@ -5527,6 +5823,55 @@ void PrivateInstanceAAMP::Tune(const char *mainManifestUrl, bool autoPlay, const
 		getAampCacheHandler()->SetMaxInitFragCacheSize(iCacheMaxSize);
 	}
 
+	if(ISCONFIGSET_PRIV(eAAMPConfig_PersistentCache))
+	{
+		std::string cachePath;
+		int cacheMaxAge;
+		GETCONFIGVALUE_PRIV(eAAMPConfig_PersistentCachePath,cachePath);
+		GETCONFIGVALUE_PRIV(eAAMPConfig_PersistentCacheSize,iCacheMaxSize);
+		GETCONFIGVALUE_PRIV(eAAMPConfig_PersistentCacheMaxAge,cacheMaxAge);
+		getAampCacheHandler()->SetPersistentCache(cachePath, iCacheMaxSize, cacheMaxAge);
+	}
+	else
+	{
+		getAampCacheHandler()->SetPersistentCache("", 0, 0);
+	}
+
+	if(ISCONFIGSET_PRIV(eAAMPConfig_EnablePerfTrace))
+	{
+		int traceBufferSize;
+		GETCONFIGVALUE_PRIV(eAAMPConfig_PerfTraceBufferSize,traceBufferSize);
+		// each tune starts a new trace, written out on stop
+		AampTraceRecorder::GetInstance().Start((size_t)traceBufferSize);
+	}
+	else if (AampTraceRecorder::IsEnabled())
+	{
+		AampTraceRecorder::GetInstance().Stop();
+	}
+
+	// process wide, follows the config of the latest tune
+	AampLogManager::setAsyncLogging(ISCONFIGSET_PRIV(eAAMPConfig_AsyncLogging));
+
+	if(ISCONFIGSET_PRIV(eAAMPConfig_EnableFragmentBufferPool))
+	{
+		int poolSize;
+		GETCONFIGVALUE_PRIV(eAAMPConfig_FragmentBufferPoolSize,poolSize);
+		mFragmentBufferPool->SetMaxPoolSize((size_t)poolSize*1024); // convert KB inputs to bytes
+	}
+
+	if(ISCONFIGSET_PRIV(eAAMPConfig_EnableDownloadEngine) || ISCONFIGSET_PRIV(eAAMPConfig_EnableHttp2Multiplex) || ISCONFIGSET_PRIV(eAAMPConfig_EnableTunePrefetch))
+	{
+		int maxTransfers;
+		GETCONFIGVALUE_PRIV(eAAMPConfig_DownloadEngineMaxTransfers,maxTransfers);
+		mDownloadEngine->SetMaxTransfers(maxTransfers);
+		// multiplexing needs transfers to share a multi handle, engine runs them even without lookahead
+		mDownloadEngine->SetMultiplex(ISCONFIGSET_PRIV(eAAMPConfig_EnableHttp2Multiplex));
+		if(!mDownloadEngine->Start())
+		{
+			AAMPLOG_WARN("Download engine not available, downloads run on track threads");
+		}
+	}
+
 	mAudioDecoderStreamSync = audioDecoderStreamSync;
 
 
@@ -5778,6 +6123,18 @@ void PrivateInstanceAAMP::Tune(const char *mainManifestUrl, bool autoPlay, const
 		mfirstTuneFmt = (int)mMediaFormat;
 	}
 	mCdaiObject = NULL;
+
+	// staged files of the channel stand in for their downloads; staging holds off until first frame
+	mPreTuner->SetPaused(true);
+	{
+		std::lock_guard<std::mutex> guard(mPreTunedFilesMutex);
+		mPreTunedFiles.clear();
+		if (mPreTuner->Take(mainManifestUrl, mPreTunedFiles))
+		{
+			AAMPLOG_WARN("Tune from %zu pre-tuned files", mPreTunedFiles.size());
+		}
+	}
+
 	AcquireStreamLock();
 	TuneHelper(tuneType);
 
@@ -6325,6 +6682,195 @@ AampCacheHandler * PrivateInstanceAAMP::getAampCacheHandler()
 	return mAampCacheHandler;
 }
 
+/**
+ * @brief Get fragment buffer pool instance
+ */
+std::shared_ptr<AampBufferPool> PrivateInstanceAAMP::GetFragmentBufferPool()
+{
+	return mFragmentBufferPool;
+}
+
+/**
+ * @brief Return fragment memory to buffer pool if enabled, otherwise free it
+ */
+void PrivateInstanceAAMP::ReleaseFragmentBuffer(GrowableBuffer *buffer, MediaType type)
+{
+	if(TakeBorrowedFragment(buffer))
+	{
+		// memory belongs to the init fragment cache
+		memset(buffer, 0x00, sizeof(GrowableBuffer));
+	}
+	else if(ISCONFIGSET_PRIV(eAAMPConfig_EnableFragmentBufferPool))
+	{
+		mFragmentBufferPool->Release(buffer, type);
+	}
+	else
+	{
+		aamp_Free(buffer);
+		memset(buffer, 0x00, sizeof(GrowableBuffer));
+	}
+}
+
+/**
+ * @brief Fill fragment buffer from a cached init fragment, borrowing the cached memory if not modified
+ */
+void PrivateInstanceAAMP::UseCachedInitFragment(const std::shared_ptr<const AampCachedFile> &file, GrowableBuffer *buffer, bool writable)
+{
+	if(writable || file->data.empty())
+	{
+		aamp_AppendBytes(buffer, file->data.data(), file->data.size());
+	}
+	else
+	{
+		// the cached file is immutable, the buffer is only read until released or handed to gstreamer
+		buffer->ptr = const_cast<char *>(file->data.data());
+		buffer->len = buffer->avail = file->data.size();
+		std::lock_guard<std::mutex> guard(mBorrowedFragmentsMutex);
+		mBorrowedFragments.insert(std::make_pair(file->data.data(), file));
+	}
+}
+
+/**
+ * @brief Drop the borrow of a fragment buffer filled by UseCachedInitFragment
+ */
+std::shared_ptr<const AampCachedFile> PrivateInstanceAAMP::TakeBorrowedFragment(const GrowableBuffer *buffer)
+{
+	std::shared_ptr<const AampCachedFile> file;
+	if(buffer->ptr)
+	{
+		std::lock_guard<std::mutex> guard(mBorrowedFragmentsMutex);
+		// same init fragment may be queued more than once, every borrow holds its own reference
+		auto it = mBorrowedFragments.find(buffer->ptr);
+		if(it != mBorrowedFragments.end())
+		{
+			file = it->second;
+			mBorrowedFragments.erase(it);
+		}
+	}
+	return file;
+}
+
+/**
+ * @brief Check if downloads can be handed over from download engine to GetFile
+ */
+bool PrivateInstanceAAMP::IsDownloadEnginePrefetchAllowed()
+{
+	// prefetched requests have to be replayable as is; per-request headers (FOG, CMCD, custom) and LL chunk handling are not
+	return (mDownloadEngine->IsRunning() && !mTSBEnabled && !mAampLLDashServiceData.lowLatencyMode && !ISCONFIGSET_PRIV(eAAMPConfig_EnableCMCD) &&
+		mCustomHeaders.empty() && rate == AAMP_NORMAL_PLAY_RATE);
+}
+
+/**
+ * @brief Get number of fragments to prefetch ahead per track
+ */
+int PrivateInstanceAAMP::GetDownloadEnginePrefetchDepth()
+{
+	int depth = 0;
+	if (ISCONFIGSET_PRIV(eAAMPConfig_EnableDownloadEngine) && IsDownloadEnginePrefetchAllowed())
+	{
+		int maxFragmentCached;
+		GETCONFIGVALUE_PRIV(eAAMPConfig_DownloadEngineDepth,depth);
+		GETCONFIGVALUE_PRIV(eAAMPConfig_MaxFragmentCached,maxFragmentCached);
+		if (depth > maxFragmentCached)
+		{
+			depth = maxFragmentCached;
+		}
+	}
+	return depth;
+}
+
+/**
+ * @brief Get number of downloads per track that may be queued at tune
+ */
+int PrivateInstanceAAMP::GetTunePrefetchDepth()
+{
+	int depth = 0;
+	if (ISCONFIGSET_PRIV(eAAMPConfig_EnableTunePrefetch) && IsDownloadEnginePrefetchAllowed())
+	{
+		// init fragment and first fragment are in separate queues, one of each per track
+		depth = GetDownloadEnginePrefetchDepth();
+		if (depth < 1)
+		{
+			depth = 1;
+		}
+	}
+	return depth;
+}
+
+/**
+ * @brief Queue lookahead download of a fragment on download engine
+ */
+bool PrivateInstanceAAMP::PrefetchFragment(const std::string &url, const char *range, unsigned int curlInstance, MediaType type, int depth)
+{
+	std::string byteRange = range ? range : "";
+	if (depth <= 0 || !mDownloadsEnabled || curlInstance >= eCURLINSTANCE_MAX || !mDownloadEngine->CanPrefetch(type, url, byteRange, depth))
+	{
+		return false;
+	}
+	CURL *templateCurl = curl[curlInstance];
+	CURLSH *share = mCurlShared;
+	if (ISCONFIGSET_PRIV(eAAMPConfig_EnableCurlStore) && mOrigManifestUrl.isRemotehost)
+	{
+		// host switch of a curl store handle is done by GetFile, prefetch only when current handle serves url
+		if (NULL == curlhost[curlInstance]->curl || std::string::npos == url.find(curlhost[curlInstance]->hostname))
+		{
+			return false;
+		}
+		templateCurl = curlhost[curlInstance]->curl;
+		share = NULL;
+	}
+	if (NULL == templateCurl)
+	{
+		return false;
+	}
+	std::shared_ptr<FragmentPrefetchRequest> request = std::make_shared<FragmentPrefetchRequest>(this);
+	request->curl = curl_easy_duphandle(templateCurl);
+	if (NULL == request->curl)
+	{
+		AAMPLOG_WARN("curl_easy_duphandle failed, type:%d", type);
+		return false;
+	}
+	request->type = type;
+	request->url = url;
+	request->range = byteRange;
+	request->context.fileType = type;
+	request->progressCtx.fileType = type;
+	request->progressCtx.downloadStartTime = NOW_STEADY_TS_MS;
+	// request may wait for a transfer slot, rely on stall detection only
+	request->progressCtx.startTimeout = 0;
+	GETCONFIGVALUE_PRIV(eAAMPConfig_CurlStallTimeout,request->progressCtx.stallTimeout);
+
+	CURL_EASY_SETOPT(request->curl, CURLOPT_URL, request->url.c_str());
+	CURL_EASY_SETOPT(request->curl, CURLOPT_RANGE, range);
+	CURL_EASY_SETOPT(request->curl, CURLOPT_WRITEDATA, &request->context);
+	CURL_EASY_SETOPT(request->curl, CURLOPT_HEADERDATA, &request->context);
+	CURL_EASY_SETOPT(request->curl, CURLOPT_PROGRESSDATA, &request->progressCtx);
+	// header list of the template handle belongs to an earlier GetFile call
+	CURL_EASY_SETOPT(request->curl, CURLOPT_HTTPHEADER, NULL);
+	// duplicated handles do not inherit share object
+	CURL_EASY_SETOPT(request->curl, CURLOPT_SHARE, share);
+	// at tune, template handle has not been through GetFile yet
+	if(ISCONFIGSET_PRIV(eAAMPConfig_EnableHttp2Multiplex))
+	{
+		CURL_EASY_SETOPT(request->curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+	}
+	if(!ISCONFIGSET_PRIV(eAAMPConfig_SslVerifyPeer))
+	{
+		CURL_EASY_SETOPT(request->curl, CURLOPT_SSL_VERIFYHOST, 0L);
+		CURL_EASY_SETOPT(request->curl, CURLOPT_SSL_VERIFYPEER, 0L);
+	}
+	else
+	{
+		CURL_EASY_SETOPT(request->curl, CURLOPT_SSLVERSION, mSupportedTLSVersion);
+		CURL_EASY_SETOPT(request->curl, CURLOPT_SSL_VERIFYPEER, 1L);
+	}
+	if ((httpRespHeaders[curlInstance].type == eHTTPHEADERTYPE_COOKIE) && (httpRespHeaders[curlInstance].data.length() > 0))
+	{
+		CURL_EASY_SETOPT(request->curl, CURLOPT_COOKIE, httpRespHeaders[curlInstance].data.c_str());
+	}
+	return mDownloadEngine->Prefetch(request, depth);
+}
+
 /**
  * @brief Get maximum bitrate value.
  */
@@ -7149,6 +7695,17 @@ void PrivateInstanceAAMP::Stop()
 
 	TeardownStream(true);
 
+	if (AampTraceRecorder::IsEnabled())
+	{
+		std::string tracePath;
+		GETCONFIGVALUE_PRIV(eAAMPConfig_PerfTracePath,tracePath);
+		AampTraceRecorder::GetInstance().Stop();
+		if (!AampTraceRecorder::GetInstance().WriteJson(tracePath))
+		{
+			AAMPLOG_WARN("Failed to write perf trace to %s", tracePath.c_str());
+		}
+	}
+
 	for(int i=0; i<eMEDIATYPE_DEFAULT; i++)
 	{
 		FlushLastId3Data((MediaType)i);
@@ -7181,6 +7738,13 @@ void PrivateInstanceAAMP::Stop()
 	{
 		timedMetadata.clear();
 	}
+	{
+		// unused staged files must not stand in for downloads of a later tune
+		std::lock_guard<std::mutex> guard(mPreTunedFilesMutex);
+		mPreTunedFiles.clear();
+	}
+	// a stop before first frame leaves staging paused otherwise
+	mPreTuner->SetPaused(false);
 	mFailureReason="";
 
 
@@ -7205,14 +7769,32 @@ void PrivateInstanceAAMP::Stop()
 	pthread_mutex_lock(&mMutexPlaystart);
 	pthread_cond_broadcast(&waitforplaystart);
 	pthread_mutex_unlock(&mMutexPlaystart);
-	if(mPreCachePlaylistThreadFlag)
+	// waits for a download in progress
+	if(AampReactor::GetInstance().Cancel(mPreCachePlaylistTaskId))
 	{
-		pthread_join(mPreCachePlaylistThreadId,NULL);
-		mPreCachePlaylistThreadFlag=false;
-		mPreCachePlaylistThreadId = 0;
+		FinishPreCachePlaylist();
 	}
+	mPreCachePlaylistTaskId = AAMP_REACTOR_TASK_ID_INVALID;
 	getAampCacheHandler()->StopPlaylistCache();
 
+	if(ISCONFIGSET_PRIV(eAAMPConfig_EnableFragmentBufferPool))
+	{
+		AampBufferPoolStats poolStats = mFragmentBufferPool->GetStats();
+		AAMPLOG_WARN("Fragment buffer pool allocations:%lu reuses:%lu releases:%lu discards:%lu peakPooledBytes:%zu",
+			poolStats.allocations, poolStats.reuses, poolStats.releases, poolStats.discards, poolStats.peakPooledBytes);
+	}
+	if(mDownloadEngine->IsRunning())
+	{
+		// Tracks are torn down by now, no transfer is waited for
+		mDownloadEngine->Stop();
+		AampDownloadEngineStats engineStats = mDownloadEngine->GetStats();
+		AAMPLOG_WARN("Download engine performed:%lu prefetched:%lu claimed:%lu discarded:%lu peakActive:%d transfers:%lu connects:%lu peakStreamsPerConnection:%d",
+			engineStats.performed, engineStats.prefetched, engineStats.claimed, engineStats.discarded, engineStats.peakActive,
+			engineStats.transfers, engineStats.connects, engineStats.peakStreamsPerConnection);
+	}
+	// Tracks are torn down by now, give pooled memory back to the system between sessions
+	mFragmentBufferPool->Flush();
+
 
 	if (pipeline_paused)
 	{
@@ -7545,6 +8127,9 @@ void PrivateInstanceAAMP::NotifyFirstFrameReceived()
 	pthread_mutex_lock(&mMutexPlaystart);
 	pthread_cond_broadcast(&waitforplaystart);
 	pthread_mutex_unlock(&mMutexPlaystart);
+	AampReactor::GetInstance().Wake(mPreCachePlaylistTaskId);
+	// channel is up, staging of next channels may use the network again
+	mPreTuner->SetPaused(false);
 
 	if (eTUNED_EVENT_ON_GST_PLAYING == GetTuneEventConfig(IsLive()))
 	{
@@ -9319,79 +9904,94 @@ void PrivateInstanceAAMP::FlushStreamSink(double position, double rate)
 }
 
 /**
- * @brief PreCachePlaylistDownloadTask Thread function for PreCaching Playlist 
+ * @brief Register download of the PreCache list, woken when playback starts
  */
-void PrivateInstanceAAMP::PreCachePlaylistDownloadTask()
+void PrivateInstanceAAMP::SchedulePreCachePlaylist()
 {
-	// This is the thread function to download all the HLS Playlist in a 
-	// differed manner
-	int maxWindowforDownload = mPreCacheDnldTimeWindow * 60; // convert to seconds  
-	int szPlaylistCount = mPreCacheDnldList.size();
-	if(szPlaylistCount)
+	mPreCacheDnldIndex = 0;
+	mPreCacheDnldWaited = false;
+	mPreCachePlaylistTaskId = AampReactor::GetInstance().Schedule("PreCachePlaylist", AAMP_REACTOR_WAIT_WAKE,
+			std::bind(&PrivateInstanceAAMP::PreCachePlaylistDownloadTask, this));
+	if(AAMP_REACTOR_TASK_ID_INVALID == mPreCachePlaylistTaskId)
 	{
-		PrivAAMPState state;
-		// First wait for Tune to complete to start this functionality
-		pthread_mutex_lock(&mMutexPlaystart);
-		pthread_cond_wait(&waitforplaystart, &mMutexPlaystart);
-		pthread_mutex_unlock(&mMutexPlaystart);
-		// May be Stop is called to release all resources .
-		// Before download , check the state 
-		GetState(state);
-		// Check for state not IDLE also to avoid DELIA-46092
-		if(state != eSTATE_RELEASED && state != eSTATE_IDLE && state != eSTATE_ERROR)
-		{
-			CurlInit(eCURLINSTANCE_PLAYLISTPRECACHE, 1, GetNetworkProxy());
-			SetCurlTimeout(mPlaylistTimeoutMs, eCURLINSTANCE_PLAYLISTPRECACHE);
-			int sleepTimeBetweenDnld = (maxWindowforDownload / szPlaylistCount) * 1000; // time in milliSec 
-			int idx = 0;
-			do
-			{
-				if(DownloadsAreEnabled())
-				{
-					InterruptableMsSleep(sleepTimeBetweenDnld);
+		AAMPLOG_ERR("Failed to schedule PreCachePlaylist");
+	}
+}
 
-					// First check if the file is already in Cache
-					PreCacheUrlStruct newelem = mPreCacheDnldList.at(idx);
-					
-					// check if url cached ,if not download
-					if(getAampCacheHandler()->IsUrlCached(newelem.url)==false)
-					{
-						AAMPLOG_WARN("Downloading Playlist Type:%d for PreCaching:%s",
-							newelem.type, newelem.url.c_str());
-						std::string playlistUrl;
-						std::string playlistEffectiveUrl;
-						GrowableBuffer playlistStore ;
-						long http_error;
-						double downloadTime;
-						if(GetFile(newelem.url, &playlistStore, playlistEffectiveUrl, &http_error, &downloadTime, NULL, eCURLINSTANCE_PLAYLISTPRECACHE, true, newelem.type))
-						{
-							// If successful download , then insert into Cache 
-							getAampCacheHandler()->InsertToPlaylistCache(newelem.url, &playlistStore, playlistEffectiveUrl, false, newelem.type);
-							aamp_Free(&playlistStore);
-						}	
-					}
-					idx++;
-				}
-				else
-				{
-					// this can come here if trickplay is done or play started late
-					if(state == eSTATE_SEEKING || state == eSTATE_PREPARED)
-					{
-						// wait for seek to complete 
-						sleep(1);
-					}
-					else
-					{
-						usleep(500000); // call sleep for other stats except seeking and prepared, otherwise this thread will run in highest priority until the state changes.
-					}
-				}
-				GetState(state);
-			}while (idx < mPreCacheDnldList.size() && state != eSTATE_RELEASED && state != eSTATE_IDLE && state != eSTATE_ERROR);
-			mPreCacheDnldList.clear();
-			CurlTerm(eCURLINSTANCE_PLAYLISTPRECACHE);
+/**
+ * @brief PreCachePlaylistDownloadTask Reactor task for PreCaching Playlist
+ */
+int PrivateInstanceAAMP::PreCachePlaylistDownloadTask()
+{
+	// This is the task to download all the HLS Playlist in a
+	// differed manner, one per run spread over the time window
+	PrivAAMPState state;
+	// May be Stop is called to release all resources .
+	// Before download , check the state
+	GetState(state);
+	// Check for state not IDLE also to avoid DELIA-46092
+	if(mPreCacheDnldIndex >= mPreCacheDnldList.size() || state == eSTATE_RELEASED || state == eSTATE_IDLE || state == eSTATE_ERROR)
+	{
+		FinishPreCachePlaylist();
+		AAMPLOG_WARN("End of PreCachePlaylistDownloadTask ");
+		return AAMP_REACTOR_TASK_DONE;
+	}
+	if(!mPreCacheCurlInitialized)
+	{
+		CurlInit(eCURLINSTANCE_PLAYLISTPRECACHE, 1, GetNetworkProxy());
+		SetCurlTimeout(mPlaylistTimeoutMs, eCURLINSTANCE_PLAYLISTPRECACHE);
+		mPreCacheCurlInitialized = true;
+	}
+	if(!DownloadsAreEnabled())
+	{
+		// this can come here if trickplay is done or play started late
+		// wait for seek to complete, poll slower for other states
+		return (state == eSTATE_SEEKING || state == eSTATE_PREPARED) ? 1000 : 500;
+	}
+	if(!mPreCacheDnldWaited)
+	{
+		int maxWindowforDownload = mPreCacheDnldTimeWindow * 60; // convert to seconds
+		int sleepTimeBetweenDnld = (maxWindowforDownload / (int)mPreCacheDnldList.size()) * 1000; // time in milliSec
+		mPreCacheDnldWaited = true;
+		return sleepTimeBetweenDnld;
+	}
+	mPreCacheDnldWaited = false;
+
+	// First check if the file is already in Cache
+	PreCacheUrlStruct newelem = mPreCacheDnldList.at(mPreCacheDnldIndex);
+
+	// check if url cached ,if not download
+	if(getAampCacheHandler()->IsUrlCached(newelem.url)==false)
+	{
+		AAMPLOG_WARN("Downloading Playlist Type:%d for PreCaching:%s",
+			newelem.type, newelem.url.c_str());
+		std::string playlistUrl;
+		std::string playlistEffectiveUrl;
+		GrowableBuffer playlistStore ;
+		long http_error;
+		double downloadTime;
+		if(GetFile(newelem.url, &playlistStore, playlistEffectiveUrl, &http_error, &downloadTime, NULL, eCURLINSTANCE_PLAYLISTPRECACHE, true, newelem.type))
+		{
+			// If successful download , then insert into Cache
+			getAampCacheHandler()->InsertToPlaylistCache(newelem.url, &playlistStore, playlistEffectiveUrl, false, newelem.type);
+			aamp_Free(&playlistStore);
 		}
 	}
-	AAMPLOG_WARN("End of PreCachePlaylistDownloadTask ");
+	mPreCacheDnldIndex++;
+	return 0;
+}
+
+/**
+ * @brief Release PreCache list and its curl instance
+ */
+void PrivateInstanceAAMP::FinishPreCachePlaylist()
+{
+	mPreCacheDnldList.clear();
+	if(mPreCacheCurlInitialized)
+	{
+		CurlTerm(eCURLINSTANCE_PLAYLISTPRECACHE);
+		mPreCacheCurlInitialized = false;
+	}
 }
 
 /**
@@ -9407,6 +10007,61 @@ void PrivateInstanceAAMP::SetPreCacheDownloadList(PreCacheUrlList &dnldListInput
 	
 }
 
+/**
+ *   @brief Stage files of likely next channels in the background
+ */
+void PrivateInstanceAAMP::SetPreTuneChannels(const std::vector<std::string> &manifestUrls)
+{
+	AampPreTuneConfig config;
+	int cacheSize;
+	int maxAge;
+	int maxBandwidth;
+	double networkTimeout;
+	GETCONFIGVALUE_PRIV(eAAMPConfig_PreTuneCacheSize,cacheSize);
+	GETCONFIGVALUE_PRIV(eAAMPConfig_PreTuneMaxAge,maxAge);
+	GETCONFIGVALUE_PRIV(eAAMPConfig_PreTuneMaxBandwidth,maxBandwidth);
+	GETCONFIGVALUE_PRIV(eAAMPConfig_NetworkTimeout,networkTimeout);
+	GETCONFIGVALUE_PRIV(eAAMPConfig_DefaultBitrate,config.initialBitrate);
+	GETCONFIGVALUE_PRIV(eAAMPConfig_LiveOffset,config.liveOffset);
+	GETCONFIGVALUE_PRIV(eAAMPConfig_UserAgent,config.userAgent);
+	config.maxBytes = (size_t)cacheSize*1024; // convert KB inputs to bytes
+	config.maxAgeMs = maxAge*1000;
+	config.maxRecvSpeed = (long)maxBandwidth*1000/8; // kbps to bytes per second
+	config.timeoutMs = (long)(networkTimeout*1000);
+	config.propagateUriParams = ISCONFIGSET_PRIV(eAAMPConfig_PropogateURIParam);
+	config.sslVerifyPeer = ISCONFIGSET_PRIV(eAAMPConfig_SslVerifyPeer);
+	config.sslVersion = mSupportedTLSVersion;
+	config.proxy = GetNetworkProxy();
+
+	// staged under the url Tune ends up with
+	std::vector<std::string> channels;
+	for (const std::string &url : manifestUrls)
+	{
+		const char *remapUrl = mConfig->GetChannelOverride(url);
+		channels.push_back(remapUrl ? remapUrl : url);
+	}
+	AAMPLOG_WARN("Pre-tune channels:%zu cache:%dKB maxAge:%ds", channels.size(), cacheSize, maxAge);
+	mPreTuner->SetConfig(config);
+	mPreTuner->SetChannels(channels);
+}
+
+/**
+ *   @brief Hand out a staged file of the channel being tuned, once
+ */
+std::shared_ptr<const AampCachedFile> PrivateInstanceAAMP::TakePreTunedFile(const std::string &url)
+{
+	std::shared_ptr<const AampCachedFile> file;
+	std::lock_guard<std::mutex> guard(mPreTunedFilesMutex);
+	auto it = mPreTunedFiles.find(url);
+	if (it != mPreTunedFiles.end())
+	{
+		// served once, refreshed playlists have to come from the network
+		file = it->second;
+		mPreTunedFiles.erase(it);
+	}
+	return file;
+}
+
 /**
  *   @brief get the current text preference set by user
  *
@@ -11534,30 +12189,29 @@ void PrivateInstanceAAMP::ProcessID3Metadata(char *segment, size_t size, MediaTy
 	// Logic for ID3 metadata
 	if(segment && mEventManager->IsEventListenerAvailable(AAMP_EVENT_ID3_METADATA))
 	{
-		IsoBmffBuffer buffer(mLogObj);
-		buffer.setBuffer((uint8_t *)segment, size);
-		buffer.parseBuffer();
-		if(!buffer.isInitSegment())
+		IsoBmffBoxIndex boxIndex;
+		boxIndex.parse((uint8_t *)segment, size);
+		if(!boxIndex.isInitSegment())
 		{
-			uint8_t* message = nullptr;
+			const uint8_t* message = nullptr;
 			uint32_t messageLen = 0;
-			uint8_t* schemeIDUri = nullptr;
-			uint8_t* value = nullptr;
+			const char* schemeIDUri = nullptr;
+			const char* value = nullptr;
 			uint64_t presTime = 0;
 			uint32_t timeScale = 0;
 			uint32_t eventDuration = 0;
 			uint32_t id = 0;
-			if(buffer.getEMSGData(message, messageLen, schemeIDUri, value, presTime, timeScale, eventDuration, id))
+			if(boxIndex.getEMSGData(message, messageLen, schemeIDUri, value, presTime, timeScale, eventDuration, id))
 			{
 				if(message && messageLen > 0 && hasId3Header(message, messageLen))
 				{
 					AAMPLOG_TRACE("PrivateInstanceAAMP: Found ID3 metadata[%d]", type);
 					if(mMediaFormat == eMEDIAFORMAT_DASH)
 					{
-						ReportID3Metadata(type, message, messageLen, (char*)(schemeIDUri), (char*)(value), presTime, id, eventDuration, timeScale, GetMediaStreamContext(type)->timeStampOffset);
+						ReportID3Metadata(type, message, messageLen, schemeIDUri, value, presTime, id, eventDuration, timeScale, GetMediaStreamContext(type)->timeStampOffset);
 					}else
 					{
-						ReportID3Metadata(type, message, messageLen, (char*)(schemeIDUri), (char*)(value), presTime, id, eventDuration, timeScale);
+						ReportID3Metadata(type, message, messageLen, schemeIDUri, value, presTime, id, eventDuration, timeScale);
 					}
 				}
 			}
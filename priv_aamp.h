@@ -57,6 +57,7 @@
 #include "AampRfc.h"
 #include "AampEventManager.h"
 #include <HybridABRManager.h>
+#include "AampBandwidthEstimator.h"
 
 #ifdef __APPLE__
 #define aamp_pthread_setname(tid,name) pthread_setname_np(name)
@@ -460,11 +461,12 @@ typedef void(*DestroyTask)(void * arg);
  * @brief To store Set Cookie: headers and X-Reason headers in HTTP Response
  */
 struct httpRespHeaderData {
-	httpRespHeaderData() : type(0), data("")
+	httpRespHeaderData() : type(0), data(""), validator("")
 	{
 	}
 	int type;             /**< Header type */
 	std::string data;     /**< Header value */
+	std::string validator; /**< ETag, else Last-Modified of last response */
 };
 
 /**
@@ -632,6 +634,14 @@ typedef struct AampUrlInfo
 
 class AampCacheHandler;
 
+class AampBufferPool;
+
+class AampDownloadEngine;
+
+class AampPreTuner;
+
+struct AampCachedFile;
+
 class AampDRMSessionManager;
 
 /**
@@ -799,6 +809,7 @@ public:
 	unsigned char* ReplaceKeyIDPsshData(const unsigned char *InputData, const size_t InputDataLength,  size_t & OutputDataLength);
 	
 	std::vector< std::pair<long long,long> > mAbrBitrateData;
+	AampBandwidthEstimator mBandwidthEstimator;	/**< Incremental estimate replacing mAbrBitrateData when bandwidthEstimator is set */
 
 	pthread_mutex_t mLock;				/**< = PTHREAD_MUTEX_INITIALIZER; */
 	pthread_mutexattr_t mMutexAttr;
@@ -1038,8 +1049,10 @@ public:
 	pthread_mutex_t drmParserMutex; 			/**< Mutex to lock DRM parsing logic */
 	bool fragmentCdmEncrypted; 				/**< Indicates CDM protection added in fragments **/
 #endif
-	pthread_t mPreCachePlaylistThreadId;
-	bool mPreCachePlaylistThreadFlag;
+	int mPreCachePlaylistTaskId;				/**< Reactor task downloading mPreCacheDnldList once playback started */
+	size_t mPreCacheDnldIndex;				/**< Next entry of mPreCacheDnldList to download */
+	bool mPreCacheDnldWaited;				/**< Time between downloads has passed for mPreCacheDnldIndex */
+	bool mPreCacheCurlInitialized;				/**< eCURLINSTANCE_PLAYLISTPRECACHE is initialized */
 	bool mbPlayEnabled;					/**< Send buffer to pipeline or just cache them */
 #if defined(AAMP_MPD_DRM) || defined(AAMP_HLS_DRM) || defined(USE_OPENCDM)
 	pthread_t createDRMSessionThreadID; 			/**< thread ID for DRM session creation */
@@ -1220,6 +1233,13 @@ public:
 	 */
 	AampCurlInstance GetPlaylistCurlInstance(MediaType type, bool IsInitDnld=true);
 
+	/**
+	 * @brief Validator of last download on a curl instance
+	 * @param[in] curlInstance - curl instance used for download
+	 * @return ETag, else Last-Modified header value, empty if response had neither
+	 */
+	const std::string &GetResponseValidator(unsigned int curlInstance) const { return httpRespHeaders[curlInstance].validator; }
+
 	/**
 	* @fn GetNetworkTime
 	*
@@ -1244,9 +1264,10 @@ public:
 	 * @param[in] resetBuffer - Flag to reset the out buffer
 	 * @param[in] fileType - File type
 	 * @param[in] CMCDMetrics - pointer to CMCDNetwork metrics
+	 * @param[in] aesDecryptor - decrypts the file in place while it downloads, NULL for none
 	 * @return void
 	 */
-	bool GetFile(std::string remoteUrl, struct GrowableBuffer *buffer, std::string& effectiveUrl, long *http_error = NULL, double *downloadTime = NULL, const char *range = NULL,unsigned int curlInstance = 0, bool resetBuffer = true,MediaType fileType = eMEDIATYPE_DEFAULT, long *bitrate = NULL,  int * fogError = NULL, double fragmentDurationSec = 0,class CMCDHeaders *pCMCDMetrics = NULL);
+	bool GetFile(std::string remoteUrl, struct GrowableBuffer *buffer, std::string& effectiveUrl, long *http_error = NULL, double *downloadTime = NULL, const char *range = NULL,unsigned int curlInstance = 0, bool resetBuffer = true,MediaType fileType = eMEDIATYPE_DEFAULT, long *bitrate = NULL,  int * fogError = NULL, double fragmentDurationSec = 0,class CMCDHeaders *pCMCDMetrics = NULL, class AesStreamDecryptor *aesDecryptor = NULL);
 
 	/**
 	 * @fn getUUID
@@ -1830,6 +1851,14 @@ public:
 	 */
 	void LogTuneComplete(void);
 
+	/**
+	 *   @fn UpdateProfilerConnectionStats
+	 *   @brief Pass HTTP/2 connection usage of download engine to profiler
+	 *
+	 *   @return void
+	 */
+	void UpdateProfilerConnectionStats(void);
+
 	/**
 	*   @brief Additional log entries to assist with tune failure diagnostics
 	*
@@ -3103,12 +3132,45 @@ public:
 	 *   @return void
 	 */
 	void SetPreCacheDownloadList(PreCacheUrlList &dnldListInput);	
+	/**
+	 *   @fn SchedulePreCachePlaylist
+	 *   @brief Register download of the PreCache list with the reactor, to run once playback started
+	 *
+	 *   @return void
+	 */
+	void SchedulePreCachePlaylist();
 	/**
 	 *   @fn PreCachePlaylistDownloadTask 
+	 *   @brief Download next playlist of the PreCache list, run by the reactor
+	 *
+	 *   @return ms until next run, AAMP_REACTOR_TASK_DONE once list is done or player stopped
+	 */
+	int PreCachePlaylistDownloadTask();
+	/**
+	 *   @fn FinishPreCachePlaylist
+	 *   @brief Release PreCache list and its curl instance
 	 *
 	 *   @return void
 	 */
-	void PreCachePlaylistDownloadTask();
+	void FinishPreCachePlaylist();
+
+	/**
+	 *   @fn SetPreTuneChannels
+	 *   @brief Stage files of likely next channels in the background, most likely first
+	 *   @param[in] manifestUrls - manifest urls, empty to stop staging
+	 *
+	 *   @return void
+	 */
+	void SetPreTuneChannels(const std::vector<std::string> &manifestUrls);
+
+	/**
+	 *   @fn TakePreTunedFile
+	 *   @brief Hand out a staged file of the channel being tuned, once
+	 *   @param[in] url - file url
+	 *
+	 *   @return staged file, NULL if not staged
+	 */
+	std::shared_ptr<const AampCachedFile> TakePreTunedFile(const std::string &url);
 
 	/**
 	 *   @fn SetAppName
@@ -3172,6 +3234,78 @@ public:
 	 */
 	AampCacheHandler * getAampCacheHandler();
 
+	/**
+	 * @fn GetFragmentBufferPool
+	 *
+	 * @return Shared pointer to fragment buffer pool
+	 */
+	std::shared_ptr<AampBufferPool> GetFragmentBufferPool();
+
+	/**
+	 * @fn ReleaseFragmentBuffer
+	 * @brief Return fragment memory to buffer pool if enabled, otherwise free it
+	 *
+	 * @param[in,out] buffer - fragment buffer, reset on return
+	 * @param[in] type - media type of fragment
+	 * @return void
+	 */
+	void ReleaseFragmentBuffer(GrowableBuffer *buffer, MediaType type);
+
+	/**
+	 * @fn UseCachedInitFragment
+	 * @brief Fill fragment buffer from a cached init fragment. Unless the caller modifies it, the
+	 *        buffer borrows the cached memory, which then reaches gstreamer without copy
+	 *
+	 * @param[in] file - cached init fragment
+	 * @param[out] buffer - empty fragment buffer
+	 * @param[in] writable - buffer is modified before injection and needs a private copy
+	 * @return void
+	 */
+	void UseCachedInitFragment(const std::shared_ptr<const AampCachedFile> &file, GrowableBuffer *buffer, bool writable);
+
+	/**
+	 * @fn TakeBorrowedFragment
+	 * @brief Drop the borrow of a fragment buffer filled by UseCachedInitFragment
+	 *
+	 * @param[in] buffer - fragment buffer
+	 * @return cached file the buffer points into, NULL if the buffer owns its memory
+	 */
+	std::shared_ptr<const AampCachedFile> TakeBorrowedFragment(const GrowableBuffer *buffer);
+
+	/**
+	 * @fn PrefetchFragment
+	 * @brief Queue lookahead download of a fragment on download engine
+	 *
+	 * Download is handed over to a later GetFile call for the same url and range.
+	 * Ignored if download engine is not running or request can not be replayed exactly,
+	 * e.g. when per-request headers are in use.
+	 * @param[in] url - fragment url
+	 * @param[in] range - byte range, NULL if none
+	 * @param[in] curlInstance - curl instance of track, used as template for request
+	 * @param[in] type - media type of fragment
+	 * @param[in] depth - maximum number of queued downloads of this media type
+	 * @return true if queued
+	 */
+	bool PrefetchFragment(const std::string &url, const char *range, unsigned int curlInstance, MediaType type, int depth);
+
+	/**
+	 * @fn GetDownloadEnginePrefetchDepth
+	 * @return number of fragments to prefetch ahead per track, 0 if lookahead is disabled
+	 */
+	int GetDownloadEnginePrefetchDepth();
+
+	/**
+	 * @fn GetTunePrefetchDepth
+	 * @return number of downloads per media type that may be queued at tune, 0 if tune prefetch is disabled
+	 */
+	int GetTunePrefetchDepth();
+
+	/**
+	 * @fn IsDownloadEnginePrefetchAllowed
+	 * @return true if downloads started by download engine can be handed over to GetFile
+	 */
+	bool IsDownloadEnginePrefetchAllowed();
+
 	/*
 	 * @brief Set profile ramp down limit.
 	 *
@@ -4050,6 +4184,13 @@ private:
 	bool mProgressReportFromProcessDiscontinuity; /** flag dentoes if progress reporting is in execution from ProcessPendingDiscontinuity*/
 	AampEventManager *mEventManager;
 	AampCacheHandler *mAampCacheHandler;
+	std::shared_ptr<AampBufferPool> mFragmentBufferPool;	/**< Recycles fragment download buffers */
+	std::shared_ptr<AampDownloadEngine> mDownloadEngine;	/**< curl_multi event loop running downloads and fragment lookahead */
+	std::shared_ptr<AampPreTuner> mPreTuner;		/**< Stages likely next channels for fast channel change */
+	std::map<std::string, std::shared_ptr<const AampCachedFile>> mPreTunedFiles;	/**< Staged files of the tuned channel, by url */
+	std::mutex mPreTunedFilesMutex;
+	std::multimap<const char *, std::shared_ptr<const AampCachedFile>> mBorrowedFragments;	/**< Cached init fragments in fragment buffers, by content pointer */
+	std::mutex mBorrowedFragmentsMutex;
 	int mMinInitialCacheSeconds; 		/**< Minimum cached duration before playing in seconds*/
 	std::string mDrmInitData; 		/**< DRM init data from main manifest URL (if present) */
 	bool mFragmentCachingRequired; 		/**< True if fragment caching is required or ongoing */
@@ -25,6 +25,8 @@
 
 #include "StreamAbstractionAAMP.h"
 #include "AampUtils.h"
+#include "AampTraceRecorder.h"
+#include "AampReactor.h"
 #include "isobmffbuffer.h"
 #include <assert.h>
 #include <errno.h>
@@ -39,22 +41,6 @@
 
 using namespace std;
 
-/**
- * @brief Thread funtion for Buffer Health Monitoring
- *
- * @return NULL
- */
-static void* BufferHealthMonitor(void* user_data)
-{
-	MediaTrack *track = (MediaTrack *)user_data;
-	if(aamp_pthread_setname(pthread_self(), "aampBuffHealth"))
-	{
-		AAMPLOG_WARN("aamp_pthread_setname failed");
-	}
-	track->MonitorBufferHealth();
-	return NULL;
-}
-
 /**
  * @brief Get string corresponding to buffer status.
  */
@@ -101,75 +87,84 @@ BufferHealthStatus MediaTrack::GetBufferStatus()
 }
 
 
-void MediaTrack::MonitorBufferHealth()
+/**
+ * @brief Register buffer health monitor with the reactor
+ */
+void MediaTrack::ScheduleBufferHealthMonitor()
 {
-	int  bufferHealthMonitorDelay,bufferHealthMonitorInterval;
+	if (!AampReactor::GetInstance().IsScheduled(bufferMonitorTaskId))
+	{
+		int bufferHealthMonitorDelay = 0;
+		GETCONFIGVALUE(eAAMPConfig_BufferHealthMonitorDelay,bufferHealthMonitorDelay);
+		bufferMonitorTaskId = AampReactor::GetInstance().Schedule("BufferHealthMonitor", bufferHealthMonitorDelay * 1000,
+				std::bind(&MediaTrack::MonitorBufferHealth, this));
+		if (AAMP_REACTOR_TASK_ID_INVALID == bufferMonitorTaskId)
+		{
+			AAMPLOG_WARN("Failed to schedule BufferHealthMonitor track %s", name);
+		}
+	}
+}
+
+/**
+ * @brief One check of buffer health
+ */
+int MediaTrack::MonitorBufferHealth()
+{
+	int bufferHealthMonitorInterval = 0;
 	long discontinuityTimeoutValue;
-	GETCONFIGVALUE(eAAMPConfig_BufferHealthMonitorDelay,bufferHealthMonitorDelay); 
 	GETCONFIGVALUE(eAAMPConfig_BufferHealthMonitorInterval,bufferHealthMonitorInterval);
 	GETCONFIGVALUE(eAAMPConfig_DiscontinuityTimeout,discontinuityTimeoutValue);
-	assert(bufferHealthMonitorDelay >= bufferHealthMonitorInterval);
-	unsigned int bufferMontiorScheduleTime = bufferHealthMonitorDelay - bufferHealthMonitorInterval;
-	bool keepRunning = false;
-	if(aamp->DownloadsAreEnabled() && !abort)
-	{
-		aamp->InterruptableMsSleep(bufferMontiorScheduleTime *1000);
-		keepRunning = true;
-	}
-	int monitorInterval = bufferHealthMonitorInterval  * 1000;
-	while(keepRunning && !abort)
+	int nextCheckMs = bufferHealthMonitorInterval * 1000;
+	pthread_mutex_lock(&mutex);
+	if (aamp->DownloadsAreEnabled() && !abort)
 	{
-		aamp->InterruptableMsSleep(monitorInterval);
-		pthread_mutex_lock(&mutex);
-		if (aamp->DownloadsAreEnabled() && !abort)
+		bufferStatus = GetBufferStatus();
+		if (bufferStatus != prevBufferStatus)
 		{
-			bufferStatus = GetBufferStatus();
-			if (bufferStatus != prevBufferStatus)
-			{
-				AAMPLOG_WARN("aamp: track[%s] buffering %s->%s", name, GetBufferHealthStatusString(prevBufferStatus),
-						GetBufferHealthStatusString(bufferStatus));
-				prevBufferStatus = bufferStatus;
-			}
-			else
-			{
-				AAMPLOG_TRACE(" track[%s] No Change [%s]",  name,
-						GetBufferHealthStatusString(bufferStatus));
-			}
+			AAMPLOG_WARN("aamp: track[%s] buffering %s->%s", name, GetBufferHealthStatusString(prevBufferStatus),
+					GetBufferHealthStatusString(bufferStatus));
+			prevBufferStatus = bufferStatus;
+		}
+		else
+		{
+			AAMPLOG_TRACE(" track[%s] No Change [%s]",  name,
+					GetBufferHealthStatusString(bufferStatus));
+		}
 
-			pthread_mutex_unlock(&mutex);
+		pthread_mutex_unlock(&mutex);
 
-			// We use another lock inside CheckForMediaTrackInjectionStall for synchronization
-			GetContext()->CheckForMediaTrackInjectionStall(type);
+		// We use another lock inside CheckForMediaTrackInjectionStall for synchronization
+		GetContext()->CheckForMediaTrackInjectionStall(type);
 
-			pthread_mutex_lock(&mutex);
-			if((!aamp->pipeline_paused) && aamp->IsDiscontinuityProcessPending() && discontinuityTimeoutValue)
-			{
-				aamp->CheckForDiscontinuityStall((MediaType)type);
-			}
+		pthread_mutex_lock(&mutex);
+		if((!aamp->pipeline_paused) && aamp->IsDiscontinuityProcessPending() && discontinuityTimeoutValue)
+		{
+			aamp->CheckForDiscontinuityStall((MediaType)type);
+		}
 
-			// If underflow occurred and cached fragments are full
-			if (aamp->GetBufUnderFlowStatus() && bufferStatus == BUFFER_STATUS_GREEN && type == eTRACK_VIDEO)
+		// If underflow occurred and cached fragments are full
+		if (aamp->GetBufUnderFlowStatus() && bufferStatus == BUFFER_STATUS_GREEN && type == eTRACK_VIDEO)
+		{
+			// There is a chance for deadlock here
+			// We hit an underflow in a scenario where its not actually an underflow
+			// If track injection to GStreamer is stopped because of this special case, we can't come out of
+			// buffering even if we have enough data
+			if (!aamp->TrackDownloadsAreEnabled(eMEDIATYPE_VIDEO))
 			{
-				// There is a chance for deadlock here
-				// We hit an underflow in a scenario where its not actually an underflow
-				// If track injection to GStreamer is stopped because of this special case, we can't come out of
-				// buffering even if we have enough data
-				if (!aamp->TrackDownloadsAreEnabled(eMEDIATYPE_VIDEO))
-				{
-					// This is a deadlock, buffering is active and enough-data received from GStreamer
-					AAMPLOG_WARN("Possible deadlock with buffering. Enough buffers cached, un-pause pipeline!");
-					aamp->StopBuffering(true);
-				}
-
+				// This is a deadlock, buffering is active and enough-data received from GStreamer
+				AAMPLOG_WARN("Possible deadlock with buffering. Enough buffers cached, un-pause pipeline!");
+				aamp->StopBuffering(true);
 			}
 
 		}
-		else
-		{
-			keepRunning = false;
-		}
-		pthread_mutex_unlock(&mutex);
+
+	}
+	else
+	{
+		nextCheckMs = AAMP_REACTOR_TASK_DONE;
 	}
+	pthread_mutex_unlock(&mutex);
+	return nextCheckMs;
 }
 
 /**
@@ -180,7 +175,7 @@ void MediaTrack::UpdateTSAfterInject()
 	pthread_mutex_lock(&mutex);
 	AAMPLOG_TRACE("[%s] Free cachedFragment[%d] numberOfFragmentsCached %d",
 			name, fragmentIdxToInject, numberOfFragmentsCached);
-	aamp_Free(&cachedFragment[fragmentIdxToInject].fragment);
+	aamp->ReleaseFragmentBuffer(&cachedFragment[fragmentIdxToInject].fragment, (MediaType)type);
 	memset(&cachedFragment[fragmentIdxToInject], 0, sizeof(CachedFragment));
 	fragmentIdxToInject++;
 	if (fragmentIdxToInject == maxCachedFragmentsPerTrack)
@@ -204,24 +199,20 @@ void MediaTrack::UpdateTSAfterInject()
  */
 void MediaTrack::UpdateTSAfterChunkInject()
 {
-	pthread_mutex_lock(&mutex);
+	int fragmentChunkIdxToInject = mChunkRing.GetReadIndex();
 	//Free Chunk Cache Buffer
 	prevDownloadStartTime = cachedFragmentChunks[fragmentChunkIdxToInject].downloadStartTime;
 	aamp_Free(&cachedFragmentChunks[fragmentChunkIdxToInject].fragmentChunk);
-    memset(&cachedFragmentChunks[fragmentChunkIdxToInject], 0, sizeof(CachedFragmentChunk));
+	memset(&cachedFragmentChunks[fragmentChunkIdxToInject], 0, sizeof(CachedFragmentChunk));
 
 	aamp_Free(&parsedBufferChunk);
 	memset(&parsedBufferChunk, 0x00, sizeof(GrowableBuffer));
 
-	//increment Inject Index
-	fragmentChunkIdxToInject = (++fragmentChunkIdxToInject) % maxCachedFragmentChunksPerTrack;
-	if(numberOfFragmentChunksCached > 0) numberOfFragmentChunksCached--;
+	//increment Inject Index, wakes fetcher only if it waits for free slots
+	mChunkRing.Pop();
 
 	AAMPLOG_TRACE("[%s] updated fragmentChunkIdxToInject = %d numberOfFragmentChunksCached %d",
-			name, fragmentChunkIdxToInject, numberOfFragmentChunksCached);
-
-	pthread_cond_signal(&fragmentChunkInjected);
-	pthread_mutex_unlock(&mutex);
+			name, mChunkRing.GetReadIndex(), mChunkRing.GetCount());
 }
 
 /**
@@ -252,6 +243,15 @@ void MediaTrack::UpdateTSAfterFetch()
 	}
 #endif
 	totalFetchedDuration += cachedFragment[fragmentIdxToFetch].duration;
+	if ((eTRACK_VIDEO == type) && !cachedFragment[fragmentIdxToFetch].initFragment)
+	{
+		// VBR fragment sizes vary around the bitrate, buffer based ABR scales its size estimate by the last one
+		double nominalBytes = cachedFragment[fragmentIdxToFetch].cacheFragStreamInfo.bandwidthBitsPerSecond * cachedFragment[fragmentIdxToFetch].duration / 8;
+		if (nominalBytes > 0)
+		{
+			lastFragmentSizeRatio = cachedFragment[fragmentIdxToFetch].fragment.len / nominalBytes;
+		}
+	}
 #ifdef AAMP_DEBUG_FETCH_INJECT
 	if ((1 << type) & AAMP_DEBUG_FETCH_INJECT)
 	{
@@ -316,25 +316,17 @@ void MediaTrack::UpdateTSAfterFetch()
  */
 void MediaTrack::UpdateTSAfterChunkFetch()
 {
-	pthread_mutex_lock(&mutex);
-
-	numberOfFragmentChunksCached++;
+	totalFragmentChunksDownloaded++;
 
-	AAMPLOG_TRACE("[%s] numberOfFragmentChunksCached++ [%d]", name,numberOfFragmentChunksCached);
+	//publishes chunk, wakes injector only if it waits for one
+	bool pushed = mChunkRing.Push();
 
 	//this should never HIT
-	assert(numberOfFragmentChunksCached <= maxCachedFragmentChunksPerTrack);
-
-	fragmentChunkIdxToFetch = (fragmentChunkIdxToFetch+1) % maxCachedFragmentChunksPerTrack;
+	assert(pushed);
+	(void)pushed;
 
 	AAMPLOG_TRACE("[%s] updated fragmentChunkIdxToFetch [%d] numberOfFragmentChunksCached [%d]",
-			name, fragmentChunkIdxToFetch, numberOfFragmentChunksCached);
-
-	totalFragmentChunksDownloaded++;
-	pthread_cond_signal(&fragmentChunkFetched);
-	pthread_mutex_unlock(&mutex);
-
-	AAMPLOG_TRACE("[%s] pthread_cond_signal(fragmentChunkFetched)", name);
+			name, mChunkRing.GetWriteIndex(), mChunkRing.GetCount());
 }
 
 /**
@@ -482,52 +474,16 @@ bool MediaTrack::WaitForCachedFragmentAvailable()
  */
 bool MediaTrack::WaitForCachedFragmentChunkInjected(int timeoutMs)
 {
-	bool ret = true;
-	int pthreadReturnValue = 0;
-	pthread_mutex_lock(&mutex);
-
-	if ((numberOfFragmentChunksCached == maxCachedFragmentChunksPerTrack) && !(abort || abortInjectChunk))
-	{
-		if (timeoutMs >= 0)
-		{
-			struct timespec tspec = aamp_GetTimespec(timeoutMs);
-
-			pthreadReturnValue = pthread_cond_timedwait(&fragmentChunkInjected, &mutex, &tspec);
-
-			if (ETIMEDOUT == pthreadReturnValue)
-			{
-				ret = false;
-			}
-			else if (0 != pthreadReturnValue)
-			{
-				AAMPLOG_WARN("[%s] pthread_cond_timedwait returned %s", name, strerror(pthreadReturnValue));
-				ret = false;
-			}
-		}
-		else
-		{
-			AAMPLOG_TRACE("[%s] waiting for fragmentChunkInjected condition", name);
-			pthreadReturnValue = pthread_cond_wait(&fragmentChunkInjected, &mutex);
-
-			if (0 != pthreadReturnValue)
-			{
-				AAMPLOG_WARN("[%s] pthread_cond_wait returned %s", name, strerror(pthreadReturnValue));
-				ret = false;
-			}
-			AAMPLOG_TRACE("[%s] wait complete for fragmentChunkInjected", name);
-		}
-	}
-	if(abort || abortInjectChunk)
+	bool ret = mChunkRing.WaitForFreeSlot(timeoutMs);
+	if(mChunkRing.IsAborted())
 	{
 		AAMPLOG_TRACE("[%s] abort set, returning false", name);
 		ret = false;
 	}
 
 	AAMPLOG_TRACE("[%s] fragmentChunkIdxToFetch = %d numberOfFragmentChunksCached %d",
-			name, fragmentChunkIdxToFetch, numberOfFragmentChunksCached);
-
-    pthread_mutex_unlock(&mutex);
-    return ret;
+			name, mChunkRing.GetWriteIndex(), mChunkRing.GetCount());
+	return ret;
 }
 
 /**
@@ -536,33 +492,22 @@ bool MediaTrack::WaitForCachedFragmentChunkInjected(int timeoutMs)
 bool MediaTrack::WaitForCachedFragmentChunkAvailable()
 {
 	bool ret = true;
-	pthread_mutex_lock(&mutex);
-
-	AAMPLOG_TRACE("[%s] Acquired MUTEX ==> fragmentChunkIdxToInject = %d numberOfFragmentChunksCached %d ret = %d abort = %d abortInjectChunk = %d ", name, fragmentChunkIdxToInject, numberOfFragmentChunksCached, ret, abort, abortInjectChunk);
 
-	if ((numberOfFragmentChunksCached == 0) && !(abort || abortInjectChunk ))
+	if ((mChunkRing.GetCount() == 0) && !mChunkRing.IsAborted())
 	{
 		AAMPLOG_TRACE("## [%s] Waiting for CachedFragment to be available, eosReached=%d ##", name, eosReached);
 
 		if (!eosReached)
 		{
-			int pthreadReturnValue = 0;
-			pthreadReturnValue = pthread_cond_wait(&fragmentChunkFetched, &mutex);
-			if (0 != pthreadReturnValue)
-			{
-				AAMPLOG_WARN("[%s] pthread_cond_wait(fragmentChunkFetched) returned %s", name, strerror(pthreadReturnValue));
-			}
+			mChunkRing.WaitForUsedSlot(-1);
 			AAMPLOG_TRACE("[%s] wait complete for fragmentChunkFetched", name);
 		}
 	}
 
+	ret = !mChunkRing.IsAborted();
 
-	ret = !(abort || abortInjectChunk);
-
-	AAMPLOG_TRACE("[%s] fragmentChunkIdxToInject = %d numberOfFragmentChunksCached %d ret = %d abort = %d abortInjectChunk = %d",
-			 name, fragmentChunkIdxToInject, numberOfFragmentChunksCached, ret, abort, abortInjectChunk);
-
-	pthread_mutex_unlock(&mutex);
+	AAMPLOG_TRACE("[%s] fragmentChunkIdxToInject = %d numberOfFragmentChunksCached %d ret = %d",
+			 name, mChunkRing.GetReadIndex(), mChunkRing.GetCount(), ret);
 	return ret;
 }
 
@@ -582,16 +527,12 @@ void MediaTrack::AbortWaitForCachedAndFreeFragment(bool immediate)
 		}
 #endif
 		pthread_cond_signal(&fragmentInjected);
-		if(aamp->GetLLDashServiceData()->lowLatencyMode)
-		{
-			AAMPLOG_TRACE("[%s] signal fragmentChunkInjected condition", name);
-			pthread_cond_signal(&fragmentChunkInjected);
-		}
+		UpdateChunkRingAbort();
 	}
 	if(aamp->GetLLDashServiceData()->lowLatencyMode)
 	{
-		AAMPLOG_TRACE("[%s] signal fragmentChunkFetched condition", name);
-		pthread_cond_signal(&fragmentChunkFetched);
+		AAMPLOG_TRACE("[%s] wake chunk injector", name);
+		mChunkRing.WakeConsumer();
 	}
 	pthread_cond_signal(&aamp->waitforplaystart);
 	pthread_cond_signal(&fragmentFetched);
@@ -611,8 +552,8 @@ void MediaTrack::AbortWaitForCachedFragment()
 	if(aamp->GetLLDashServiceData()->lowLatencyMode)
 	{
 		abortInjectChunk = true;
-		AAMPLOG_TRACE("[%s] signal fragmentChunkFetched condition", name);
-		pthread_cond_signal(&fragmentChunkFetched);
+		AAMPLOG_TRACE("[%s] abort chunk ring", name);
+		UpdateChunkRingAbort();
 	}
 
 	abortInject = true;
@@ -628,30 +569,39 @@ void MediaTrack::AbortWaitForCachedFragment()
 	GetContext()->AbortWaitForDiscontinuity();
 }
 
+/**
+ *  @brief Propagate abort flags to chunk ring waits
+ */
+void MediaTrack::UpdateChunkRingAbort()
+{
+	mChunkRing.SetAborted(abort || abortInjectChunk);
+}
+
 /**
  *  @brief Process next cached fragment chunk
  */
 bool MediaTrack::ProcessFragmentChunk()
 {
 	//Get Cache buffer
-	CachedFragmentChunk* cachedFragmentChunk = &this->cachedFragmentChunks[fragmentChunkIdxToInject];
+	CachedFragmentChunk* cachedFragmentChunk = &this->cachedFragmentChunks[mChunkRing.GetReadIndex()];
 	if(cachedFragmentChunk != NULL && NULL == cachedFragmentChunk->fragmentChunk.ptr)
 	{
 		AAMPLOG_TRACE("[%s] Ignore NULL Chunk - cachedFragmentChunk->fragmentChunk.len %d", name, cachedFragmentChunk->fragmentChunk.len);
 		return false;
 	}
-	if((cachedFragmentChunk->downloadStartTime != prevDownloadStartTime) && (unparsedBufferChunk.ptr != NULL))
+	if((cachedFragmentChunk->downloadStartTime != prevDownloadStartTime) && mChunkParser.getPendingSize())
 	{
 		AAMPLOG_WARN("[%s] clean up curl chunk buffer, since  prevDownloadStartTime[%lld] != currentdownloadtime[%lld]", name,prevDownloadStartTime,cachedFragmentChunk->downloadStartTime);
-		aamp_Free(&unparsedBufferChunk);
-		memset(&unparsedBufferChunk,0x00,sizeof(GrowableBuffer));
-
+		mChunkParser.reset();
 	}
-	size_t requiredLength = cachedFragmentChunk->fragmentChunk.len + unparsedBufferChunk.len;
-	AAMPLOG_TRACE("[%s] cachedFragmentChunk->fragmentChunk.len [%d] to unparsedBufferChunk.len [%d] Required Len [%d]", name, cachedFragmentChunk->fragmentChunk.len, unparsedBufferChunk.len, requiredLength);
+	AAMPLOG_TRACE("[%s] cachedFragmentChunk->fragmentChunk.len [%d] to unparsed len [%d]", name, cachedFragmentChunk->fragmentChunk.len, mChunkParser.getPendingSize());
 
-	//Append Cache buffer to unparsed buffer for processing
-	aamp_AppendBytes(&unparsedBufferChunk, cachedFragmentChunk->fragmentChunk.ptr, cachedFragmentChunk->fragmentChunk.len);
+	//Append Cache buffer to unparsed buffer, only box headers completed by it are read
+	if(!mChunkParser.append(reinterpret_cast<uint8_t *>(cachedFragmentChunk->fragmentChunk.ptr), cachedFragmentChunk->fragmentChunk.len))
+	{
+		AAMPLOG_WARN("[%s] Malformed box in chunk, unparsed data dropped", name);
+		return true;
+	}
 
 #if 0  //enable to avoid small buffer processing
 	if(cachedFragmentChunk->fragmentChunk.len < 500)
@@ -660,118 +610,64 @@ bool MediaTrack::ProcessFragmentChunk()
 		return true;
 	}
 #endif
+	//Complete boxes up to last complete MDAT, parsed once when they close
+	uint8_t *unitBuffer = NULL;
+	size_t unitSize = 0;
+	if(!mChunkParser.getUnit(unitBuffer, unitSize))
+	{
+		if( noMDATCount > MAX_MDAT_NOT_FOUND_COUNT )
+		{
+			AAMPLOG_INFO("[%s] noMDATCount=%d ChunkIndex=%d totchunklen=%d", name,noMDATCount, mChunkRing.GetReadIndex(),mChunkParser.getPendingSize());
+			noMDATCount=0;
+		}
+		noMDATCount++;
+		return true;
+	}
+	noMDATCount = 0;
+
 	//Parse Chunk Data
-	IsoBmffBuffer isobuf(mLogObj);                   /**< Fragment Chunk buffer box parser*/
-	const Box *pBox = NULL;
-	std::vector<Box*> *pBoxes;
+	//Index boxes in place, records live in the inline array or in mChunkBoxRecords
+	IsoBmffBoxIndex boxIndex(mChunkBoxRecords.data(), mChunkBoxRecords.size());
 	size_t mdatCount = 0;
-	size_t parsedBoxCount = 0;
-	char *unParsedBuffer = NULL;
-	size_t parsedBufferSize = 0, unParsedBufferSize = 0;
-	
-	unParsedBuffer = unparsedBufferChunk.ptr;
-	unParsedBufferSize = parsedBufferSize = unparsedBufferChunk.len;
-
-	isobuf.setBuffer(reinterpret_cast<uint8_t *>(unparsedBufferChunk.ptr), unparsedBufferChunk.len);
 
-	AAMPLOG_TRACE("[%s] Unparsed Buffer Size: %d", name,unparsedBufferChunk.len);
+	AAMPLOG_TRACE("[%s] Parsed Buffer Size: %d", name, unitSize);
 
-	bool bParse = false;
-	try
-	{
-		bParse = isobuf.parseBuffer();
-	}
-	catch( std::bad_alloc& ba)
-	{
-		AAMPLOG_ERR("Bad allocation: %s", ba.what() );
-	}
-	catch( std::exception &e)
-	{
-		AAMPLOG_ERR("Unhandled exception: %s", e.what() );
-	}
-	catch( ... )
+	bool bParse = boxIndex.parse(unitBuffer, unitSize);
+	if(!bParse && boxIndex.getRequiredCount() > boxIndex.getCount())
 	{
-		AAMPLOG_ERR("Unknown exception");
+		//Grow storage to the largest unit seen, later units index without allocating
+		mChunkBoxRecords.resize(boxIndex.getRequiredCount());
+		boxIndex.setArena(mChunkBoxRecords.data(), mChunkBoxRecords.size());
+		bParse = boxIndex.parse(unitBuffer, unitSize);
 	}
 	if(!bParse)
 	{
-		AAMPLOG_INFO("[%s] No Box available in cache chunk: fragmentChunkIdxToInject %d", name, fragmentChunkIdxToInject);
+		AAMPLOG_INFO("[%s] No Box available in cache chunk: fragmentChunkIdxToInject %d", name, mChunkRing.GetReadIndex());
+		mChunkParser.consumeUnit();
 		return true;
 	}
-	//Print box details
-	//isobuf.printBoxes();
 
-	isobuf.getMdatBoxCount(mdatCount);
-	if(!mdatCount)
-	{
-		 if( noMDATCount > MAX_MDAT_NOT_FOUND_COUNT )
-		 {
-			 AAMPLOG_INFO("[%s] noMDATCount=%d ChunkIndex=%d totchunklen=%d", name,noMDATCount, fragmentChunkIdxToInject,unParsedBufferSize);
-			 noMDATCount=0;
-		 }
-		 noMDATCount++;
-		 return true;
-	}
-	noMDATCount = 0;
+	mdatCount = boxIndex.getMdatCount();
 	totalMdatCount += mdatCount;
 	AAMPLOG_TRACE("[%s] MDAT count found: %d, Total Found: %d", name,  mdatCount, totalMdatCount );
 
-	pBoxes = isobuf.getParsedBoxes();
-	parsedBoxCount = pBoxes->size();
-
-	pBox = isobuf.getChunkedfBox();
-	if(pBox)
-	{
-		
-		parsedBoxCount--;
-
-		AAMPLOG_TRACE("[%s] MDAT Chunk Found - Actual Parsed Box Count: %d", name,parsedBoxCount);
-		AAMPLOG_TRACE("[%s] Chunk Offset[%u] Chunk Type[%s] Chunk Size[%u]\n", name, pBox->getOffset(), pBox->getBoxType(), pBox->getSize());
-	}
 	if(mdatCount)
 	{
-		int lastMDatIndex = -1;
-		//Get Last MDAT box
-		for(int i=parsedBoxCount-1;i>=0;i--)
-		{
-			Box *box = pBoxes->at(i);
-			if (IS_TYPE(box->getType(), Box::MDAT))
-			{
-				lastMDatIndex = i;
-
-				AAMPLOG_TRACE("[%s] Last MDAT Index : %d", name,lastMDatIndex);
-
-				//Calculate unparsed buffer based on last MDAT
-				unParsedBuffer += (box->getOffset()+box->getSize()); //increment buffer pointer to chunk offset
-				unParsedBufferSize -= (box->getOffset()+box->getSize()); //decerese by parsed buffer size
-
-				parsedBufferSize -= unParsedBufferSize; //get parsed buf size
-
-				AAMPLOG_TRACE("[%s] parsedBufferSize : %d updated unParsedBufferSize: %d Total Buf Size processed: %d", name,parsedBufferSize,unParsedBufferSize,parsedBufferSize+unParsedBufferSize);
-
-				break;
-			}
-		}
-
 		uint64_t fPts = 0;
 		double fpts = 0.0;
 		uint64_t fDuration = 0;
 		double fduration = 0.0;
 		uint64_t totalChunkDuration = 0.0;
 
-		//AAMPLOG_WARN("===========Base Media Decode Time Start================");
-		//isobuf.PrintPTS();
-		//AAMPLOG_WARN("============Base Media Decode Time End===============");
-
-		for(int i=0;i<lastMDatIndex;i++)
+		for(size_t i=0;i<boxIndex.getCount();i++)
 		{
-			Box *box = pBoxes->at(i);
+			const IsoBmffBoxRecord &record = boxIndex.getRecord(i);
 #ifdef AAMP_DEBUG_INJECT_CHUNK
-			AAMPLOG_WARN("[%s] Type: %s", name,box->getType());
+			AAMPLOG_WARN("[%s] Type: %.4s Depth: %d", name, record.type, record.depth);
 #endif
-			if (IS_TYPE(box->getType(), Box::MOOF))
+			if (record.depth == 0 && IS_TYPE(record.type, Box::MOOF))
 			{
-				isobuf.getSampleDuration(box, fDuration);
+				fDuration = boxIndex.getSampleDuration(i);
 				totalChunkDuration += fDuration;
 #ifdef AAMP_DEBUG_INJECT_CHUNK
 				AAMPLOG_WARN("[%s] fDuration = %lld, totalChunkDuration = %lld", name,fDuration, totalChunkDuration);
@@ -779,7 +675,7 @@ bool MediaTrack::ProcessFragmentChunk()
 			}
 		}
 		//get PTS of buffer
-		bool bParse = isobuf.getFirstPTS(fPts);
+		bool bParse = boxIndex.getFirstPTS(fPts);
 		if (bParse)
 		{
 			AAMPLOG_TRACE("[%s] fPts %lld",name, fPts);
@@ -810,7 +706,7 @@ bool MediaTrack::ProcessFragmentChunk()
 		fduration = totalChunkDuration/(timeScale*1.0);
 
 		//Prepeare parsed buffer
-		aamp_AppendBytes(&parsedBufferChunk, unparsedBufferChunk.ptr, parsedBufferSize);
+		aamp_AppendBytes(&parsedBufferChunk, unitBuffer, unitSize);
 #ifdef AAMP_DEBUG_INJECT_CHUNK
 		IsoBmffBuffer isobufTest(mLogObj);
 		//TEST CODE for PARSED DATA COMPELTENESS
@@ -832,29 +728,9 @@ bool MediaTrack::ProcessFragmentChunk()
 		totalInjectedChunksDuration += fduration;
 	}
 
-	// Move unparsed data sections to beginning
-	//Available size remains same
-	//This buffer should be released on Track cleanup
-	if(unParsedBufferSize)
-	{
-		AAMPLOG_TRACE("[%s] unparsed[%p] unparsed_size[%u]", name,unParsedBuffer,unParsedBufferSize);
+	// Partial boxes stay in the parser for the next chunk
+	mChunkParser.consumeUnit();
 
-		GrowableBuffer tempBuffer;
-		memset(&tempBuffer,0x00,sizeof(GrowableBuffer));
-		aamp_AppendBytes(&tempBuffer,unParsedBuffer,unParsedBufferSize);
-		aamp_Free(&unparsedBufferChunk);
-		memset(&unparsedBufferChunk,0x00,sizeof(GrowableBuffer));
-		aamp_AppendBytes(&unparsedBufferChunk,tempBuffer.ptr,tempBuffer.len);
-		aamp_Free(&tempBuffer);
-		memset(&tempBuffer,0x00,sizeof(GrowableBuffer));
-	}
-	else
-	{
-		AAMPLOG_TRACE("[%s] Set Unparsed Buffer chunk Empty...", name);
-		aamp_Free(&unparsedBufferChunk);
-		memset(&unparsedBufferChunk, 0x00, sizeof(GrowableBuffer));
-	}
-	
 	aamp_Free(&parsedBufferChunk);
 	memset(&parsedBufferChunk, 0x00, sizeof(GrowableBuffer));
 	return true;
@@ -997,7 +873,11 @@ bool MediaTrack::InjectFragment()
 
 				if (type != eTRACK_SUBTITLE || ISCONFIGSET(eAAMPConfig_GstSubtecEnabled))
 				{
+					// zero copy injection hands fragment memory over, size is taken before
+					long long injectBytes = (long long)cachedFragment->fragment.len;
+					AampTraceSpan traceSpan("fragment", "inject", "track", type);
 					InjectFragmentInternal(cachedFragment, fragmentDiscarded);
+					traceSpan.End("bytes", injectBytes, "position_ms", (long long)(cachedFragment->position * 1000));
 				}
 				if (eTRACK_VIDEO == type && GetContext()->GetProfileCount())
 				{
@@ -1129,6 +1009,7 @@ static void *FragmentChunkInjector(void *arg)
 void MediaTrack::StartInjectLoop()
 {
 	abort = false;
+	UpdateChunkRingAbort();
 	abortInject = false;
 	discontinuityProcessed = false;
 	assert(!fragmentInjectorThreadStarted);
@@ -1149,6 +1030,7 @@ void MediaTrack::StartInjectChunkLoop()
 {
 	abort = false;
 	abortInjectChunk = false;
+	UpdateChunkRingAbort();
 	discontinuityProcessed = false;
 	assert(!fragmentChunkInjectorThreadStarted);
 	if (0 == pthread_create(&fragmentChunkInjectorThreadID, NULL, &FragmentChunkInjector, this))
@@ -1169,17 +1051,9 @@ void MediaTrack::RunInjectLoop()
     AAMPLOG_WARN("fragment injector started. track %s", name);
     bool notifyFirstFragment = true;
     bool keepInjecting = true;
-    if ((AAMP_NORMAL_PLAY_RATE == aamp->rate) && !bufferMonitorThreadStarted )
-
+    if (AAMP_NORMAL_PLAY_RATE == aamp->rate)
     {
-        if (0 == pthread_create(&bufferMonitorThreadID, NULL, &BufferHealthMonitor, this))
-        {
-            bufferMonitorThreadStarted = true;
-        }
-        else
-        {
-            AAMPLOG_WARN("Failed to create BufferHealthMonitor thread errno = %d, %s", errno, strerror(errno));
-        }
+        ScheduleBufferHealthMonitor();
     }
     totalInjectedDuration = 0;
     while (aamp->DownloadsAreEnabled() && keepInjecting)
@@ -1247,6 +1121,7 @@ void MediaTrack::RunInjectChunkLoop()
 		}
 	}
 	abortInjectChunk = true;
+	UpdateChunkRingAbort();
 	AAMPLOG_WARN("fragment chunk injector done. track %s", name);
 }
 
@@ -1326,6 +1201,7 @@ CachedFragment* MediaTrack::GetFetchBuffer(bool initialize)
  */
 CachedFragmentChunk* MediaTrack::GetFetchChunkBuffer(bool initialize)
 {
+	int fragmentChunkIdxToFetch = mChunkRing.GetWriteIndex();
 	if(fragmentChunkIdxToFetch <0 || fragmentChunkIdxToFetch >= maxCachedFragmentChunksPerTrack)
 	{
 		AAMPLOG_WARN("[%s] OUT OF RANGE => fragmentChunkIdxToFetch: %d",name,fragmentChunkIdxToFetch);
@@ -1381,7 +1257,7 @@ void MediaTrack::FlushFragments()
 {
 	for (int i = 0; i < maxCachedFragmentsPerTrack; i++)
 	{
-		aamp_Free(&cachedFragment[i].fragment);
+		aamp->ReleaseFragmentBuffer(&cachedFragment[i].fragment, (MediaType)type);
 		memset(&cachedFragment[i], 0, sizeof(CachedFragment));
 	}
 	fragmentIdxToInject = 0;
@@ -1404,15 +1280,12 @@ void MediaTrack::FlushFragmentChunks()
 		aamp_Free(&cachedFragmentChunks[i].fragmentChunk);
 		memset(&cachedFragmentChunks[i], 0, sizeof(CachedFragmentChunk));
 	}
-	aamp_Free(&unparsedBufferChunk);
-	memset(&unparsedBufferChunk, 0x00, sizeof(GrowableBuffer));
+	mChunkParser.reset();
 	aamp_Free(&parsedBufferChunk);
 	memset(&parsedBufferChunk, 0x00, sizeof(GrowableBuffer));
 
-	fragmentChunkIdxToInject = 0;
-	fragmentChunkIdxToFetch = 0;
 	pthread_mutex_lock(&mutex);
-	numberOfFragmentChunksCached = 0;
+	mChunkRing.Reset(maxCachedFragmentChunksPerTrack, DEFAULT_CHUNK_RING_WAKEUP_SLOTS(maxCachedFragmentChunksPerTrack));
 	totalFragmentChunksDownloaded = 0;
 	totalInjectedChunksDuration = 0;
 	pthread_mutex_unlock(&mutex);
@@ -1423,17 +1296,17 @@ void MediaTrack::FlushFragmentChunks()
  *  @brief MediaTrack Constructor
  */
 MediaTrack::MediaTrack(AampLogManager *logObj, TrackType type, PrivateInstanceAAMP* aamp, const char* name) :
-		eosReached(false), enabled(false), numberOfFragmentsCached(0), numberOfFragmentChunksCached(0), fragmentIdxToInject(0), fragmentChunkIdxToInject(0),
-fragmentIdxToFetch(0), fragmentChunkIdxToFetch(0), abort(false), fragmentInjectorThreadID(0), fragmentChunkInjectorThreadID(0),bufferMonitorThreadID(0), totalFragmentsDownloaded(0), totalFragmentChunksDownloaded(0),
-		fragmentInjectorThreadStarted(false), fragmentChunkInjectorThreadStarted(false),bufferMonitorThreadStarted(false), totalInjectedDuration(0), totalInjectedChunksDuration(0), currentInitialCacheDurationSeconds(0),
-		sinkBufferIsFull(false), cachingCompleted(false), fragmentDurationSeconds(0),  segDLFailCount(0),segDrmDecryptFailCount(0),mSegInjectFailCount(0),
+		eosReached(false), enabled(false), numberOfFragmentsCached(0), fragmentIdxToInject(0),
+fragmentIdxToFetch(0), abort(false), fragmentInjectorThreadID(0), fragmentChunkInjectorThreadID(0), totalFragmentsDownloaded(0), totalFragmentChunksDownloaded(0),
+		fragmentInjectorThreadStarted(false), fragmentChunkInjectorThreadStarted(false),bufferMonitorTaskId(AAMP_REACTOR_TASK_ID_INVALID), totalInjectedDuration(0), totalInjectedChunksDuration(0), currentInitialCacheDurationSeconds(0),
+		sinkBufferIsFull(false), cachingCompleted(false), fragmentDurationSeconds(0), lastFragmentSizeRatio(0), segDLFailCount(0),segDrmDecryptFailCount(0),mSegInjectFailCount(0),
 		bufferStatus(BUFFER_STATUS_GREEN), prevBufferStatus(BUFFER_STATUS_GREEN),
 		bandwidthBitsPerSecond(0), totalFetchedDuration(0),
 		discontinuityProcessed(false), ptsError(false), cachedFragment(NULL), name(name), type(type), aamp(aamp),
 		mutex(), fragmentFetched(), fragmentInjected(), abortInject(false),
 		mSubtitleParser(), refreshSubtitles(false), maxCachedFragmentsPerTrack(0),
-		totalMdatCount(0), cachedFragmentChunks{}, unparsedBufferChunk{}, parsedBufferChunk{}, fragmentChunkFetched(), fragmentChunkInjected(), abortInjectChunk(false), maxCachedFragmentChunksPerTrack(0),
-		noMDATCount(0), mLogObj(logObj) ,prevDownloadStartTime(-1)
+		totalMdatCount(0), cachedFragmentChunks{}, mChunkParser(), mChunkBoxRecords(), parsedBufferChunk{}, abortInjectChunk(false), maxCachedFragmentChunksPerTrack(0),
+		noMDATCount(0), mLogObj(logObj) ,prevDownloadStartTime(-1), mChunkRing()
 {
 	GETCONFIGVALUE(eAAMPConfig_MaxFragmentCached,maxCachedFragmentsPerTrack);
 	cachedFragment = new CachedFragment[maxCachedFragmentsPerTrack];
@@ -1444,11 +1317,15 @@ fragmentIdxToFetch(0), fragmentChunkIdxToFetch(0), abort(false), fragmentInjecto
 	if(aamp->GetLLDashServiceData()->lowLatencyMode)
 	{
 		GETCONFIGVALUE(eAAMPConfig_MaxFragmentChunkCached,maxCachedFragmentChunksPerTrack);
+		if(maxCachedFragmentChunksPerTrack <= 0 || maxCachedFragmentChunksPerTrack > DEFAULT_CACHED_FRAGMENT_CHUNKS_PER_TRACK)
+		{
+			AAMPLOG_WARN("[%s] downloadBufferChunks %d out of range, using %d", name, maxCachedFragmentChunksPerTrack, DEFAULT_CACHED_FRAGMENT_CHUNKS_PER_TRACK);
+			maxCachedFragmentChunksPerTrack = DEFAULT_CACHED_FRAGMENT_CHUNKS_PER_TRACK;
+		}
 		for(int X =0; X< maxCachedFragmentChunksPerTrack; ++X)
 			memset(&cachedFragmentChunks[X], 0x00, sizeof(CachedFragmentChunk));
 
-		pthread_cond_init(&fragmentChunkFetched, NULL);
-		pthread_cond_init(&fragmentChunkInjected, NULL);
+		mChunkRing.Reset(maxCachedFragmentChunksPerTrack, DEFAULT_CHUNK_RING_WAKEUP_SLOTS(maxCachedFragmentChunksPerTrack));
 	}
 
 	pthread_cond_init(&fragmentFetched, NULL);
@@ -1462,20 +1339,8 @@ fragmentIdxToFetch(0), fragmentChunkIdxToFetch(0), abort(false), fragmentInjecto
  */
 MediaTrack::~MediaTrack()
 {
-	if (bufferMonitorThreadStarted)
-	{
-		int rc = pthread_join(bufferMonitorThreadID, NULL);
-		if (rc != 0)
-		{
-			AAMPLOG_WARN("***pthread_join bufferMonitorThreadID returned %d(%s)", rc, strerror(rc));
-		}
-#ifdef TRACE
-		else
-		{
-			AAMPLOG_WARN("joined bufferMonitorThreadID");
-		}
-#endif
-	}
+	// waits for a check in progress
+	AampReactor::GetInstance().Cancel(bufferMonitorTaskId);
 
 	if (fragmentInjectorThreadStarted)
 	{
@@ -1492,13 +1357,11 @@ MediaTrack::~MediaTrack()
 	{
 		AAMPLOG_INFO("LL-Mode flushing chunks");
 		FlushFragmentChunks();
-		pthread_cond_destroy(&fragmentChunkFetched);
-		pthread_cond_destroy(&fragmentChunkInjected);
 	}
     
 	for (int j = 0; j < maxCachedFragmentsPerTrack; j++)
 	{
-		aamp_Free(&cachedFragment[j].fragment);
+		aamp->ReleaseFragmentBuffer(&cachedFragment[j].fragment, (MediaType)type);
 		memset(&cachedFragment[j], 0x00, sizeof(CachedFragment));
 	}
 
@@ -1607,6 +1470,7 @@ StreamAbstractionAAMP::StreamAbstractionAAMP(AampLogManager *logObj, PrivateInst
 		mSubCond(), mAudioTracks(), mTextTracks(),mABRHighBufferCounter(0),mABRLowBufferCounter(0),mMaxBufferCountCheck(0),
 		mStateLock(), mStateCond(), mTrackState(eDISCONTIUITY_FREE),
 		mRampDownLimit(-1), mRampDownCount(0),mABRMaxBuffer(0), mABRCacheLength(0), mABRMinBuffer(0), mABRNwConsistency(0),
+		mBolaAbrEnabled(false), mBolaAbr(),
 		mBitrateReason(eAAMP_BITRATE_CHANGE_BY_TUNE),
 		mAudioTrackIndex(), mTextTrackIndex(),
 		mAuxCond(), mFwdAudioToAux(false), mLogObj(logObj)
@@ -1628,6 +1492,15 @@ StreamAbstractionAAMP::StreamAbstractionAAMP(AampLogManager *logObj, PrivateInst
 	GETCONFIGVALUE(eAAMPConfig_MaxABRNWBufferRampUp,mABRMaxBuffer);
 	GETCONFIGVALUE(eAAMPConfig_MinABRNWBufferRampDown,mABRMinBuffer);
 	GETCONFIGVALUE(eAAMPConfig_ABRNWConsistency,mABRNwConsistency); 
+	mBolaAbrEnabled = ISCONFIGSET(eAAMPConfig_BolaAbr);
+	if (mBolaAbrEnabled)
+	{
+		int bolaBufferTarget = DEFAULT_BOLA_BUFFER_TARGET;
+		int bolaUtility = DEFAULT_BOLA_UTILITY;
+		GETCONFIGVALUE(eAAMPConfig_BolaBufferTarget,bolaBufferTarget);
+		GETCONFIGVALUE(eAAMPConfig_BolaUtility,bolaUtility);
+		mBolaAbr.Configure(bolaUtility, bolaBufferTarget);
+	}
 	aamp->mhAbrManager.setDefaultInitBitrate(aamp->GetDefaultBitrate());
 
 
@@ -1889,6 +1762,47 @@ void StreamAbstractionAAMP::GetDesiredProfileOnSteadyState(int currProfileIndex,
 	}
 }
 
+/**
+ *  @brief Get desired profile from video buffer level
+ */
+int StreamAbstractionAAMP::GetDesiredProfileOnBola(long nwBandwidth)
+{
+	MediaTrack *video = GetMediaTrack(eTRACK_VIDEO);
+	// profiles ramp up and down can reach, in bitrate order
+	std::vector<AampBolaProfile> ladder;
+	int profileCount = GetProfileCount();
+	int profileIndex = currentProfileIndex;
+	for (int i = 0; i < profileCount; i++)
+	{
+		int lowerProfileIndex = aamp->mhAbrManager.getRampedDownProfileIndex(profileIndex);
+		if (lowerProfileIndex < 0 || lowerProfileIndex == profileIndex)
+		{
+			break;
+		}
+		profileIndex = lowerProfileIndex;
+	}
+	for (int i = 0; i < profileCount; i++)
+	{
+		StreamInfo *streamInfo = GetStreamInfo(profileIndex);
+		if (streamInfo)
+		{
+			ladder.push_back({profileIndex, streamInfo->bandwidthBitsPerSecond});
+		}
+		int higherProfileIndex = aamp->mhAbrManager.getRampedUpProfileIndex(profileIndex);
+		if (higherProfileIndex < 0 || higherProfileIndex == profileIndex)
+		{
+			break;
+		}
+		profileIndex = higherProfileIndex;
+	}
+	double bufferValue = video->GetBufferedDuration();
+	int desiredProfileIndex = mBolaAbr.GetProfileIndex(ladder, currentProfileIndex, bufferValue,
+			video->fragmentDurationSeconds, video->lastFragmentSizeRatio, nwBandwidth);
+	AAMPLOG_INFO("buffer:%f sizeRatio:%f nwBW:%ld steady:%d currProf:%d desiredProf:%d", bufferValue,
+			video->lastFragmentSizeRatio, nwBandwidth, mBolaAbr.IsSteady(), currentProfileIndex, desiredProfileIndex);
+	return desiredProfileIndex;
+}
+
 /**
  *  @brief Configure download timeouts based on buffer
  */
@@ -1962,6 +1876,18 @@ int StreamAbstractionAAMP::GetDesiredProfileBasedOnCache(void)
 				desiredProfileIndex = tmpIframeProfile;
 			}
 		}
+		else if (mBolaAbrEnabled)
+		{
+			desiredProfileIndex = GetDesiredProfileOnBola(aamp->GetCurrentlyAvailableBandwidth());
+			if (currentProfileIndex != desiredProfileIndex)
+			{
+				mBitrateReason = eAAMP_BITRATE_CHANGE_BY_ABR;
+			}
+			if (ISCONFIGSET(eAAMPConfig_ABRBufferCheckEnabled))
+			{
+				ConfigureTimeoutOnBuffer();
+			}
+		}
 		/*In live, fog takes care of ABR, and cache updating is not based only on bandwidth,
 		 * but also depends on fragment availability in CDN*/
 		else
@@ -2052,6 +1978,8 @@ bool StreamAbstractionAAMP::RampDownProfile(long http_error)
 			stAbrInfo.errorCode = (int)http_error;
 
 			AAMP_LOG_ABR_INFO(&stAbrInfo);
+			AampTraceRecorder::GetInstance().AddInstant("abr", "rampdown_on_error", "from", stAbrInfo.currentBandwidth,
+				"to", stAbrInfo.desiredBandwidth, "network", stAbrInfo.networkBandwidth);
 
 			aamp->UpdateVideoEndMetrics(stAbrInfo);
 
@@ -2201,7 +2129,8 @@ void StreamAbstractionAAMP::CheckForProfileChange(void)
 			long availBW = aamp->GetCurrentlyAvailableBandwidth();
 			bool checkProfileChange = aamp->mhAbrManager.CheckProfileChange(totalFetchedDuration,currentProfileIndex,availBW);
 		
-			if (checkProfileChange)
+			// buffer based ABR picks the profile of every fragment
+			if (checkProfileChange || mBolaAbrEnabled)
 			{
 				UpdateProfileBasedOnFragmentCache();
 			}
@@ -2309,6 +2238,8 @@ bool StreamAbstractionAAMP::UpdateProfileBasedOnFragmentCache()
 		stAbrInfo.errorType = AAMPNetworkErrorNone;
 
 		AAMP_LOG_ABR_INFO(&stAbrInfo);
+		AampTraceRecorder::GetInstance().AddInstant("abr", "profile_change", "from", stAbrInfo.currentBandwidth,
+			"to", stAbrInfo.desiredBandwidth, "network", stAbrInfo.networkBandwidth);
 		aamp->UpdateVideoEndMetrics(stAbrInfo);
 #endif /* 0 */
 
@@ -46,6 +46,7 @@
 #include "AampcliSet.h"
 #include "AampcliShader.h"
 #include "AampcliHarvestor.h"
+#include "AampcliBenchmark.h"
 
 #ifdef __APPLE__
 #import <cocoa_window.h>
@@ -0,0 +1,521 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file AampcliBenchmark.cpp
+ * @brief Offline benchmark of harvested assets
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <new>
+#include <algorithm>
+#include "Aampcli.h"
+#include "AampcliBenchmark.h"
+#include "AampReactor.h"
+
+#define BENCHMARK_DEFAULT_WAIT_MS	30000	// wait timeout when script gives none
+#define BENCHMARK_POLL_MS		5	// state poll interval, step times are this precise
+#define BENCHMARK_DEFAULT_TOLERANCE	10	// percent a gated metric may grow by
+
+extern Aampcli mAampcli;
+
+ReplayServer Benchmark::mReplayServer;
+
+// C++ heap allocations of the whole process, libaamp included, counted by replacing global new.
+// Counting is only on while a bench script runs, other sessions pay a single relaxed load per allocation.
+static std::atomic<bool> gAllocationCounting(false);
+static std::atomic<unsigned long long> gAllocationCount(0);
+static std::atomic<unsigned long long> gAllocationBytes(0);
+
+static inline void countAllocation(size_t size)
+{
+	if (gAllocationCounting.load(std::memory_order_relaxed))
+	{
+		gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		gAllocationBytes.fetch_add(size, std::memory_order_relaxed);
+	}
+}
+
+void *operator new(size_t size)
+{
+	countAllocation(size);
+	void *ptr = malloc(size ? size : 1);
+	if (ptr == NULL)
+	{
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	countAllocation(size);
+	return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t&) noexcept
+{
+	free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t&) noexcept
+{
+	free(ptr);
+}
+
+static long long nowMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static long long toMs(const struct timeval& tv)
+{
+	return (long long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+static long long getPeakRssKb(const struct rusage& usage)
+{
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+static double getNumber(cJSON *object, const char *name)
+{
+	cJSON *item = cJSON_GetObjectItem(object, name);
+	return (item && cJSON_IsNumber(item)) ? item->valuedouble : 0;
+}
+
+static cJSON *readJson(const std::string& path)
+{
+	std::ifstream file(path);
+	std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	cJSON *root = text.empty() ? NULL : cJSON_Parse(text.c_str());
+	if (root == NULL)
+	{
+		printf("[AAMPCLI] bench can not read results %s\n", path.c_str());
+	}
+	return root;
+}
+
+void Benchmark::setAllocationCounting(bool enable)
+{
+	gAllocationCounting.store(enable, std::memory_order_relaxed);
+}
+
+unsigned long long Benchmark::getAllocationCount()
+{
+	return gAllocationCount.load(std::memory_order_relaxed);
+}
+
+unsigned long long Benchmark::getAllocationBytes()
+{
+	return gAllocationBytes.load(std::memory_order_relaxed);
+}
+
+std::map<int, ThreadCpu> Benchmark::getThreadCpu()
+{
+	std::map<int, ThreadCpu> threads;
+#ifdef __linux__
+	long ticksPerSecond = sysconf(_SC_CLK_TCK);
+	DIR *dir = opendir("/proc/self/task");
+	if (dir && ticksPerSecond > 0)
+	{
+		struct dirent *entry;
+		while ((entry = readdir(dir)) != NULL)
+		{
+			int tid = atoi(entry->d_name);
+			if (tid > 0)
+			{
+				std::ifstream file(std::string("/proc/self/task/") + entry->d_name + "/stat");
+				std::string stat((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+				size_t open = stat.find('(');
+				size_t close = stat.rfind(')');
+				if (open != std::string::npos && close != std::string::npos && close > open)
+				{
+					// fields after comm start with state (3rd); utime and stime are 14th and 15th
+					std::istringstream fields(stat.substr(close + 2));
+					std::string field;
+					unsigned long long utime = 0, stime = 0;
+					for (int i = 3; i <= 15 && (fields >> field); i++)
+					{
+						if (i == 14)
+						{
+							utime = strtoull(field.c_str(), NULL, 10);
+						}
+						else if (i == 15)
+						{
+							stime = strtoull(field.c_str(), NULL, 10);
+						}
+					}
+					ThreadCpu cpu = { stat.substr(open + 1, close - open - 1), (long long)((utime + stime) * 1000 / ticksPerSecond) };
+					threads.insert(std::make_pair(tid, cpu));
+				}
+			}
+		}
+	}
+	if (dir)
+	{
+		closedir(dir);
+	}
+#endif
+	return threads;
+}
+
+bool Benchmark::waitForState(const std::string& stateName, long long timeoutMs, long long& elapsedMs, long long startMs)
+{
+	bool reached = false;
+	for (;;)
+	{
+		PrivAAMPState state = mAampcli.mSingleton->GetState();
+		elapsedMs = nowMs() - startMs;
+		if (strcasecmp(mAampcli.mEventListener->stringifyPrivAAMPState(state), stateName.c_str()) == 0)
+		{
+			reached = true;
+			break;
+		}
+		if (state == eSTATE_ERROR || elapsedMs >= timeoutMs)
+		{
+			break;
+		}
+		usleep(BENCHMARK_POLL_MS * 1000);
+	}
+	return reached;
+}
+
+bool Benchmark::runScript(const std::string& scriptPath, const std::string& resultsPath)
+{
+	std::ifstream script(scriptPath);
+	if (!script.good())
+	{
+		printf("[AAMPCLI] bench can not open script %s\n", scriptPath.c_str());
+		return true;
+	}
+	CommandHandler lCommandHandler;
+	std::vector<BenchmarkStep> steps;
+	std::string lastCommand;
+	long long lastCommandMs = nowMs();
+	bool exitRequested = false;
+
+	mReplayServer.resetStats();
+	std::map<int, ThreadCpu> threadsBefore = getThreadCpu();
+	struct rusage usageBefore;
+	getrusage(RUSAGE_SELF, &usageBefore);
+	setAllocationCounting(true);
+	unsigned long long allocationsBefore = getAllocationCount();
+	unsigned long long allocationBytesBefore = getAllocationBytes();
+	long long startMs = nowMs();
+
+	std::string line;
+	while (!exitRequested && std::getline(script, line))
+	{
+		line.erase(0, line.find_first_not_of(" \t"));
+		line.erase(line.find_last_not_of(" \t\r\n") + 1);
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+		size_t pos;
+		while ((pos = line.find("${server}")) != std::string::npos)
+		{
+			line.replace(pos, 9, mReplayServer.getBaseUrl());
+		}
+		char stateName[32] = {'\0'};
+		long long timeoutMs = BENCHMARK_DEFAULT_WAIT_MS;
+		if (sscanf(line.c_str(), "wait %31s %lld", stateName, &timeoutMs) >= 1)
+		{
+			BenchmarkStep step = { lastCommand, stateName, 0, false };
+			step.reached = waitForState(step.state, timeoutMs, step.elapsedMs, lastCommandMs);
+			printf("[AAMPCLI] bench '%s' %s %s in %lld ms\n", step.command.c_str(), step.reached ? "reached" : "did not reach", stateName, step.elapsedMs);
+			steps.push_back(step);
+		}
+		else if (line.compare(0, 9, "bench run") == 0)
+		{
+			printf("[AAMPCLI] bench skipping nested '%s'\n", line.c_str());
+		}
+		else
+		{
+			char cmd[Aampcli::mMaxBufferLength] = {'\0'};
+			snprintf(cmd, sizeof(cmd), "%s", line.c_str());
+			lastCommand = line;
+			lastCommandMs = nowMs();
+			exitRequested = !lCommandHandler.dispatchAampcliCommands(cmd, mAampcli.mSingleton);
+		}
+	}
+
+	long long wallMs = nowMs() - startMs;
+	struct rusage usageAfter;
+	getrusage(RUSAGE_SELF, &usageAfter);
+	unsigned long long allocations = getAllocationCount() - allocationsBefore;
+	unsigned long long allocationBytes = getAllocationBytes() - allocationBytesBefore;
+	setAllocationCounting(false);
+	std::map<int, ThreadCpu> threadsAfter = getThreadCpu();
+	ReplayStats stats = mReplayServer.getStats();
+	ReplayShaping shaping = mReplayServer.getShaping();
+
+	cJSON *root = cJSON_CreateObject();
+	cJSON_AddStringToObject(root, "script", scriptPath.c_str());
+	cJSON_AddNumberToObject(root, "wallMs", (double)wallMs);
+	cJSON *stepArray = cJSON_AddArrayToObject(root, "steps");
+	for (const BenchmarkStep& step : steps)
+	{
+		cJSON *item = cJSON_CreateObject();
+		cJSON_AddStringToObject(item, "command", step.command.c_str());
+		cJSON_AddStringToObject(item, "state", step.state.c_str());
+		cJSON_AddNumberToObject(item, "elapsedMs", (double)step.elapsedMs);
+		cJSON_AddBoolToObject(item, "reached", step.reached);
+		cJSON_AddItemToArray(stepArray, item);
+	}
+	cJSON *cpu = cJSON_AddObjectToObject(root, "cpu");
+	cJSON_AddNumberToObject(cpu, "userMs", (double)(toMs(usageAfter.ru_utime) - toMs(usageBefore.ru_utime)));
+	cJSON_AddNumberToObject(cpu, "systemMs", (double)(toMs(usageAfter.ru_stime) - toMs(usageBefore.ru_stime)));
+	// threads ended during the run are in process totals only
+	std::vector<std::pair<long long, int>> busiest;
+	for (const auto& thread : threadsAfter)
+	{
+		auto before = threadsBefore.find(thread.first);
+		long long cpuMs = thread.second.cpuMs - ((before != threadsBefore.end()) ? before->second.cpuMs : 0);
+		if (cpuMs > 0)
+		{
+			busiest.push_back(std::make_pair(cpuMs, thread.first));
+		}
+	}
+	std::sort(busiest.rbegin(), busiest.rend());
+	cJSON *threadArray = cJSON_AddArrayToObject(root, "threads");
+	for (const auto& thread : busiest)
+	{
+		cJSON *item = cJSON_CreateObject();
+		cJSON_AddNumberToObject(item, "tid", thread.second);
+		cJSON_AddStringToObject(item, "name", threadsAfter.at(thread.second).name.c_str());
+		cJSON_AddNumberToObject(item, "cpuMs", (double)thread.first);
+		cJSON_AddItemToArray(threadArray, item);
+	}
+	// reactor statistics are totals since process start
+	std::vector<AampReactorTaskStats> reactorStats;
+	AampReactor::GetInstance().GetStats(reactorStats);
+	cJSON *reactor = cJSON_AddObjectToObject(root, "reactor");
+	cJSON_AddNumberToObject(reactor, "workers", AampReactor::GetInstance().GetWorkerCount());
+	cJSON *taskArray = cJSON_AddArrayToObject(reactor, "tasks");
+	for (const AampReactorTaskStats& task : reactorStats)
+	{
+		cJSON *item = cJSON_CreateObject();
+		cJSON_AddStringToObject(item, "name", task.name.c_str());
+		cJSON_AddNumberToObject(item, "runs", (double)task.runs);
+		cJSON_AddNumberToObject(item, "avgRunUs", task.runs ? (double)task.totalRunUs / task.runs : 0.0);
+		cJSON_AddNumberToObject(item, "maxRunUs", (double)task.maxRunUs);
+		cJSON_AddNumberToObject(item, "avgLateUs", task.runs ? (double)task.totalLateUs / task.runs : 0.0);
+		cJSON_AddNumberToObject(item, "maxLateUs", (double)task.maxLateUs);
+		cJSON_AddItemToArray(taskArray, item);
+	}
+	cJSON *allocationObject = cJSON_AddObjectToObject(root, "allocations");
+	cJSON_AddNumberToObject(allocationObject, "count", (double)allocations);
+	cJSON_AddNumberToObject(allocationObject, "bytes", (double)allocationBytes);
+	cJSON_AddNumberToObject(root, "peakRssKb", (double)getPeakRssKb(usageAfter));
+	cJSON *server = cJSON_AddObjectToObject(root, "server");
+	cJSON_AddNumberToObject(server, "requests", (double)stats.requests);
+	cJSON_AddNumberToObject(server, "notFound", (double)stats.notFound);
+	cJSON_AddNumberToObject(server, "injectedErrors", (double)stats.injectedErrors);
+	cJSON_AddNumberToObject(server, "bytesSent", (double)stats.bytesSent);
+	cJSON_AddNumberToObject(server, "latencyMs", shaping.latencyMs);
+	cJSON_AddNumberToObject(server, "bandwidthKbps", (double)shaping.bandwidthKbps);
+	cJSON_AddNumberToObject(server, "errorPercent", shaping.errorPercent);
+
+	char *json = cJSON_Print(root);
+	if (json)
+	{
+		FILE *f = fopen(resultsPath.c_str(), "w");
+		if (f)
+		{
+			fprintf(f, "%s\n", json);
+			fclose(f);
+			printf("[AAMPCLI] bench results written to %s\n", resultsPath.c_str());
+		}
+		else
+		{
+			printf("[AAMPCLI] bench can not write %s\n", resultsPath.c_str());
+		}
+		cJSON_free(json);
+	}
+	cJSON_Delete(root);
+	return !exitRequested;
+}
+
+bool Benchmark::gate(const std::string& resultsPath, const std::string& baselinePath, double tolerancePercent)
+{
+	cJSON *results = readJson(resultsPath);
+	cJSON *baseline = readJson(baselinePath);
+	bool pass = (results != NULL) && (baseline != NULL);
+	if (pass)
+	{
+		double factor = 1 + tolerancePercent / 100;
+		auto check = [&pass, factor](const std::string& metric, double base, double value, double slack)
+		{
+			bool regressed = value > base * factor + slack;
+			printf("[AAMPCLI] bench gate %-40s baseline=%-12.0f result=%-12.0f %s\n", metric.c_str(), base, value, regressed ? "REGRESSION" : "ok");
+			pass = pass && !regressed;
+		};
+		cJSON *steps = cJSON_GetObjectItem(results, "steps");
+		cJSON *baseSteps = cJSON_GetObjectItem(baseline, "steps");
+		int count = std::min(cJSON_GetArraySize(steps), cJSON_GetArraySize(baseSteps));
+		if (cJSON_GetArraySize(steps) != cJSON_GetArraySize(baseSteps))
+		{
+			printf("[AAMPCLI] bench gate step count differs from baseline, comparing first %d\n", count);
+		}
+		for (int i = 0; i < count; i++)
+		{
+			cJSON *step = cJSON_GetArrayItem(steps, i);
+			cJSON *baseStep = cJSON_GetArrayItem(baseSteps, i);
+			cJSON *command = cJSON_GetObjectItem(step, "command");
+			std::string metric = "step " + std::to_string(i) + " " + ((command && cJSON_IsString(command)) ? command->valuestring : "");
+			if (cJSON_IsTrue(cJSON_GetObjectItem(baseStep, "reached")) && !cJSON_IsTrue(cJSON_GetObjectItem(step, "reached")))
+			{
+				printf("[AAMPCLI] bench gate %-40s state not reached REGRESSION\n", metric.c_str());
+				pass = false;
+			}
+			else
+			{
+				check(metric.substr(0, 40), getNumber(baseStep, "elapsedMs"), getNumber(step, "elapsedMs"), BENCHMARK_POLL_MS * 2);
+			}
+		}
+		cJSON *cpu = cJSON_GetObjectItem(results, "cpu");
+		cJSON *baseCpu = cJSON_GetObjectItem(baseline, "cpu");
+		check("cpu ms", getNumber(baseCpu, "userMs") + getNumber(baseCpu, "systemMs"), getNumber(cpu, "userMs") + getNumber(cpu, "systemMs"), 0);
+		check("allocations", getNumber(cJSON_GetObjectItem(baseline, "allocations"), "count"), getNumber(cJSON_GetObjectItem(results, "allocations"), "count"), 0);
+		check("peak rss kb", getNumber(baseline, "peakRssKb"), getNumber(results, "peakRssKb"), 0);
+	}
+	printf("[AAMPCLI] bench gate %s\n", pass ? "PASSED" : "FAILED");
+	cJSON_Delete(results);
+	cJSON_Delete(baseline);
+	return pass;
+}
+
+void Benchmark::showHelp()
+{
+	printf("******************************************************************************************\n");
+	printf("*   bench <command> [<arguments>]\n");
+	printf("*   Replay a harvested asset from a local server and measure scripted playback\n");
+	printf("******************************************************************************************\n");
+	printf("bench serve <harvestPath> [port]                         Serve harvested files on 127.0.0.1, any free port by default\n");
+	printf("bench shape <latencyMs> <kbps> [errorPercent] [errorCode] [seed]\n");
+	printf("                                                         Per request latency, shared bandwidth (0 unlimited) and failed\n");
+	printf("                                                         requests (errorCode 0 drops the connection)\n");
+	printf("bench run <script> <results.json>                        Run aamp-cli script, ${server} is replaced by server url and\n");
+	printf("                                                         'wait <state> [timeoutMs]' times the previous command\n");
+	printf("bench gate <results.json> <baseline.json> [tolerance%%]   Compare with baseline and exit, status 1 on regression\n");
+	printf("bench status                                             Show server url, shaping and counters\n");
+	printf("bench stop                                               Stop server\n");
+}
+
+bool Benchmark::execute(char *cmd, PlayerInstanceAAMP *playerInstanceAamp)
+{
+	std::istringstream args(cmd);
+	std::vector<std::string> params;
+	std::string param;
+	while (args >> param)
+	{
+		params.push_back(param);
+	}
+	std::string subCommand = (params.size() > 1) ? params[1] : "help";
+	bool ret = true;
+
+	if (subCommand == "serve" && params.size() > 2)
+	{
+		int port = (params.size() > 3) ? atoi(params[3].c_str()) : 0;
+		if (mReplayServer.start(params[2], port))
+		{
+			printf("[AAMPCLI] bench serving %s at %s\n", params[2].c_str(), mReplayServer.getBaseUrl().c_str());
+		}
+	}
+	else if (subCommand == "shape" && params.size() > 3)
+	{
+		ReplayShaping shaping;
+		shaping.latencyMs = atoi(params[2].c_str());
+		shaping.bandwidthKbps = atol(params[3].c_str());
+		shaping.errorPercent = (params.size() > 4) ? atoi(params[4].c_str()) : 0;
+		shaping.errorCode = (params.size() > 5) ? atoi(params[5].c_str()) : 503;
+		shaping.seed = (params.size() > 6) ? (unsigned int)strtoul(params[6].c_str(), NULL, 10) : 1;
+		mReplayServer.setShaping(shaping);
+		printf("[AAMPCLI] bench shaping latency=%dms bandwidth=%ldkbps errors=%d%% code=%d seed=%u\n",
+			shaping.latencyMs, shaping.bandwidthKbps, shaping.errorPercent, shaping.errorCode, shaping.seed);
+	}
+	else if (subCommand == "run" && params.size() > 3)
+	{
+		if (!mReplayServer.isRunning())
+		{
+			printf("[AAMPCLI] bench server not running, ${server} urls will fail\n");
+		}
+		ret = runScript(params[2], params[3]);
+	}
+	else if (subCommand == "gate" && params.size() > 3)
+	{
+		double tolerance = (params.size() > 4) ? atof(params[4].c_str()) : BENCHMARK_DEFAULT_TOLERANCE;
+		bool pass = gate(params[2], params[3], tolerance);
+		fflush(stdout);
+		_exit(pass ? 0 : 1);
+	}
+	else if (subCommand == "status")
+	{
+		ReplayStats stats = mReplayServer.getStats();
+		ReplayShaping shaping = mReplayServer.getShaping();
+		printf("[AAMPCLI] bench server %s latency=%dms bandwidth=%ldkbps errors=%d%% requests=%lu notFound=%lu injectedErrors=%lu bytesSent=%llu\n",
+			mReplayServer.isRunning() ? mReplayServer.getBaseUrl().c_str() : "stopped", shaping.latencyMs, shaping.bandwidthKbps,
+			shaping.errorPercent, stats.requests, stats.notFound, stats.injectedErrors, stats.bytesSent);
+	}
+	else if (subCommand == "stop")
+	{
+		mReplayServer.stop();
+	}
+	else
+	{
+		showHelp();
+	}
+	return ret;
+}
@@ -0,0 +1,91 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file AampcliBenchmark.h
+ * @brief Offline benchmark of harvested assets
+ */
+
+#ifndef AAMPCLIBENCHMARK_H
+#define AAMPCLIBENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cjson/cJSON.h>
+#include "AampcliCommandHandler.h"
+#include "AampcliReplayServer.h"
+
+/**
+ * @brief Outcome of a script wait
+ */
+typedef struct benchmarkStep
+{
+	std::string command;	// command the wait measures from
+	std::string state;	// state waited for
+	long long elapsedMs;	// from command dispatch to state, or to timeout
+	bool reached;
+}BenchmarkStep;
+
+/**
+ * @brief CPU time of a thread
+ */
+typedef struct threadCpu
+{
+	std::string name;
+	long long cpuMs;
+}ThreadCpu;
+
+/**
+ * @brief Replays a harvested asset from a local server and measures scripted playback
+ *
+ * A script holds one aamp-cli command per line; ${server} is replaced by the replay server
+ * url. Extra script lines:
+ *   wait <state> [timeoutMs]  - wait for player state, timed from the previous command
+ * For example:
+ *   bench shape 20 8000
+ *   ${server}/cdn.example.com/vod/master.m3u8
+ *   wait playing 10000
+ *   seek 60
+ *   wait playing
+ *   bench shape 20 1500
+ *   sleep 20000
+ *   ff16
+ *   wait playing
+ *   stop
+ * Results hold step times, process and per thread CPU time, C++ heap allocations, peak
+ * RSS and replay server counters as JSON, and can be gated against a baseline run.
+ */
+class Benchmark : public Command
+{
+	public:
+		static ReplayServer mReplayServer;
+
+		bool execute(char *cmd, PlayerInstanceAAMP *playerInstanceAamp);
+		bool runScript(const std::string& scriptPath, const std::string& resultsPath);
+		static bool gate(const std::string& resultsPath, const std::string& baselinePath, double tolerancePercent);
+		static bool waitForState(const std::string& stateName, long long timeoutMs, long long& elapsedMs, long long startMs);
+		static std::map<int, ThreadCpu> getThreadCpu();
+		static void showHelp();
+		static void setAllocationCounting(bool enable);
+		static unsigned long long getAllocationCount();
+		static unsigned long long getAllocationBytes();
+};
+
+#endif // AAMPCLIBENCHMARK_H
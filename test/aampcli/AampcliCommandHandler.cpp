@@ -40,6 +40,7 @@ void CommandHandler::registerCommandObjects()
 	registerCommand( "set", new Set);
 	registerCommand( "get", new Get);
 	registerCommand( "harvest", new Harvestor);
+	registerCommand( "bench", new Benchmark);
 	registerCommand( "default", new PlaybackCommand);
 }
 
@@ -436,6 +436,7 @@ void PlaybackCommand::registerPlaybackCommands()
 	addCommand("list","Type list to view virtual channel map");
 	addCommand("get help","Show help of get command");
 	addCommand("set help","Show help of set command");
+	addCommand("bench help","Show help of bench command");
 	addCommand("<channelNumber>","Play selected channel from guide");
 	addCommand("<url>","Play arbitrary stream");
 	addCommand("sleep <ms>","Sleep <ms> milliseconds");
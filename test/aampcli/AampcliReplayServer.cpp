@@ -0,0 +1,547 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file AampcliReplayServer.cpp
+ * @brief Local HTTP server replaying a harvested asset
+ */
+
+#include "AampcliReplayServer.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static const size_t MAX_REQUEST_HEAD = 16*1024;
+
+static long long nowUs()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool isRegularFile(const std::string& path)
+{
+	struct stat st;
+	return (stat(path.c_str(), &st) == 0) && S_ISREG(st.st_mode);
+}
+
+static bool hasSuffix(const std::string& str, const char *suffix)
+{
+	size_t len = strlen(suffix);
+	return (str.size() >= len) && (str.compare(str.size() - len, len, suffix) == 0);
+}
+
+static bool isDigits(const std::string& str)
+{
+	return !str.empty() && std::all_of(str.begin(), str.end(), [](char c){ return isdigit((unsigned char)c) != 0; });
+}
+
+static const char *getStatusText(int status)
+{
+	switch (status)
+	{
+		case 200: return "OK";
+		case 206: return "Partial Content";
+		case 400: return "Bad Request";
+		case 403: return "Forbidden";
+		case 404: return "Not Found";
+		case 405: return "Method Not Allowed";
+		case 416: return "Range Not Satisfiable";
+		case 500: return "Internal Server Error";
+		case 502: return "Bad Gateway";
+		case 503: return "Service Unavailable";
+		case 504: return "Gateway Timeout";
+		default: return "Error";
+	}
+}
+
+static const char *getContentType(const std::string& path)
+{
+	if (path.find(".m3u8") != std::string::npos)
+	{
+		return "application/vnd.apple.mpegurl";
+	}
+	if (path.find(".mpd") != std::string::npos)
+	{
+		return "application/dash+xml";
+	}
+	if (path.find(".ts") != std::string::npos)
+	{
+		return "video/mp2t";
+	}
+	return "application/octet-stream";
+}
+
+ReplayServer::ReplayServer():
+	mRootPath(),
+	mListenFd(-1),
+	mPort(0),
+	mRunning(false),
+	mAcceptThread(),
+	mMutex(),
+	mCond(),
+	mConnectionFds(),
+	mRequestCount(),
+	mShaping(),
+	mStats(),
+	mRandom(),
+	mPaceMutex(),
+	mNextSendUs(0)
+{
+	memset(&mShaping, 0, sizeof(mShaping));
+	memset(&mStats, 0, sizeof(mStats));
+}
+
+ReplayServer::~ReplayServer()
+{
+	stop();
+}
+
+bool ReplayServer::start(const std::string& rootPath, int port)
+{
+	if (mRunning)
+	{
+		printf("[AAMPCLI] replay server already running on port %d\n", mPort);
+		return false;
+	}
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0)
+	{
+		printf("[AAMPCLI] replay server socket failed errno=%d\n", errno);
+		return false;
+	}
+	int enable = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons((uint16_t)port);
+	socklen_t addrLen = sizeof(addr);
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0 ||
+		getsockname(fd, (struct sockaddr *)&addr, &addrLen) != 0)
+	{
+		printf("[AAMPCLI] replay server can not listen on port %d errno=%d\n", port, errno);
+		close(fd);
+		return false;
+	}
+	mRootPath = rootPath;
+	while (mRootPath.size() > 1 && mRootPath.back() == '/')
+	{
+		mRootPath.pop_back();
+	}
+	mListenFd = fd;
+	mPort = ntohs(addr.sin_port);
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		mRequestCount.clear();
+	}
+	mRunning = true;
+	mAcceptThread = std::thread(&ReplayServer::acceptLoop, this);
+	return true;
+}
+
+void ReplayServer::stop()
+{
+	if (mRunning)
+	{
+		mRunning = false;
+		mAcceptThread.join();
+		close(mListenFd);
+		mListenFd = -1;
+		std::unique_lock<std::mutex> lock(mMutex);
+		for (int fd : mConnectionFds)
+		{
+			shutdown(fd, SHUT_RDWR);
+		}
+		mCond.wait(lock, [this]{ return mConnectionFds.empty(); });
+	}
+}
+
+bool ReplayServer::isRunning()
+{
+	return mRunning;
+}
+
+int ReplayServer::getPort()
+{
+	return mPort;
+}
+
+std::string ReplayServer::getBaseUrl()
+{
+	return "http://127.0.0.1:" + std::to_string(mPort);
+}
+
+void ReplayServer::setShaping(const ReplayShaping& shaping)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	mShaping = shaping;
+	mRandom.seed(shaping.seed);
+}
+
+ReplayShaping ReplayServer::getShaping()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	return mShaping;
+}
+
+ReplayStats ReplayServer::getStats()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	return mStats;
+}
+
+void ReplayServer::resetStats()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	memset(&mStats, 0, sizeof(mStats));
+}
+
+void ReplayServer::acceptLoop()
+{
+	while (mRunning)
+	{
+		struct pollfd pfd = { mListenFd, POLLIN, 0 };
+		if (poll(&pfd, 1, 100) > 0)
+		{
+			int fd = accept(mListenFd, NULL, NULL);
+			if (fd >= 0)
+			{
+				int enable = 1;
+				setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+				std::lock_guard<std::mutex> guard(mMutex);
+				mConnectionFds.push_back(fd);
+				std::thread(&ReplayServer::serveConnection, this, fd).detach();
+			}
+		}
+	}
+}
+
+bool ReplayServer::injectError()
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	bool inject = false;
+	if (mShaping.errorPercent > 0)
+	{
+		inject = (int)(mRandom() % 100) < mShaping.errorPercent;
+		if (inject)
+		{
+			mStats.injectedErrors++;
+		}
+	}
+	return inject;
+}
+
+void ReplayServer::pace(size_t bytes)
+{
+	long bandwidthKbps = getShaping().bandwidthKbps;
+	if (bandwidthKbps > 0)
+	{
+		long long endUs;
+		{
+			// all connections share the link, each write takes its slot after the previous one
+			std::lock_guard<std::mutex> guard(mPaceMutex);
+			long long startUs = std::max(nowUs(), mNextSendUs);
+			endUs = startUs + (long long)bytes * 8000 / bandwidthKbps;
+			mNextSendUs = endUs;
+		}
+		long long waitUs = endUs - nowUs();
+		if (waitUs > 0)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(waitUs));
+		}
+	}
+}
+
+bool ReplayServer::sendAll(int fd, const char *data, size_t len, bool shaped)
+{
+	long bandwidthKbps = getShaping().bandwidthKbps;
+	// 20ms worth of data per write keeps shaped rate smooth
+	size_t chunk = (shaped && bandwidthKbps > 0) ? std::min(std::max((size_t)bandwidthKbps * 1000 / 8 / 50, (size_t)1460), (size_t)65536) : len;
+	while (len > 0 && mRunning)
+	{
+		size_t part = std::min(len, std::max(chunk, (size_t)1));
+		if (shaped)
+		{
+			pace(part);
+		}
+		ssize_t sent = send(fd, data, part, MSG_NOSIGNAL);
+		if (sent <= 0)
+		{
+			return false;
+		}
+		data += sent;
+		len -= (size_t)sent;
+		std::lock_guard<std::mutex> guard(mMutex);
+		mStats.bytesSent += (unsigned long long)sent;
+	}
+	return len == 0;
+}
+
+bool ReplayServer::resolveFile(const std::string& target, std::string& filePath)
+{
+	std::string path = target.substr(1);
+	if (target.empty() || target[0] != '/' || path.find("..") != std::string::npos)
+	{
+		return false;
+	}
+	unsigned int count;
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		count = mRequestCount[target]++;
+	}
+	std::string pathNoQuery = path.substr(0, path.find('?'));
+	if (isRegularFile(mRootPath + "/" + path))
+	{
+		filePath = mRootPath + "/" + path;
+		return true;
+	}
+	if (isRegularFile(mRootPath + "/" + pathNoQuery))
+	{
+		filePath = mRootPath + "/" + pathNoQuery;
+		return true;
+	}
+
+	// harvest keeps every refresh of a playlist as <name>.<n> and of a manifest as manifest.<n>.<ext>,
+	// n growing over the session; successive requests get them in that order
+	size_t slash = pathNoQuery.find_last_of('/');
+	std::string dirPath = mRootPath + "/" + ((slash == std::string::npos) ? "" : pathNoQuery.substr(0, slash));
+	std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+	std::string nameNoQuery = name.substr(0, name.find('?'));
+	size_t extPos = nameNoQuery.find_last_of('.');
+	std::string ext = (extPos == std::string::npos) ? "" : nameNoQuery.substr(extPos);
+	std::vector<std::pair<unsigned long, std::string>> refreshes;
+	DIR *dir = opendir(dirPath.c_str());
+	if (dir)
+	{
+		struct dirent *entry;
+		while ((entry = readdir(dir)) != NULL)
+		{
+			std::string entryName = entry->d_name;
+			std::string number;
+			for (const std::string& prefix : { name + ".", nameNoQuery + "." })
+			{
+				if (number.empty() && entryName.compare(0, prefix.size(), prefix) == 0 && isDigits(entryName.substr(prefix.size())))
+				{
+					number = entryName.substr(prefix.size());
+				}
+			}
+			if (number.empty() && !ext.empty() && entryName.compare(0, 9, "manifest.") == 0 && hasSuffix(entryName, ext.c_str()) &&
+				entryName.size() > 9 + ext.size() && isDigits(entryName.substr(9, entryName.size() - 9 - ext.size())))
+			{
+				number = entryName.substr(9, entryName.size() - 9 - ext.size());
+			}
+			if (!number.empty())
+			{
+				refreshes.push_back(std::make_pair(strtoul(number.c_str(), NULL, 10), dirPath + "/" + entryName));
+			}
+		}
+		closedir(dir);
+	}
+	if (refreshes.empty())
+	{
+		return false;
+	}
+	std::sort(refreshes.begin(), refreshes.end());
+	filePath = refreshes[std::min((size_t)count, refreshes.size() - 1)].second;
+	return true;
+}
+
+void ReplayServer::serveConnection(int fd)
+{
+	std::string pending;
+	char buffer[4096];
+	bool keepAlive = true;
+	while (keepAlive && mRunning)
+	{
+		size_t headEnd;
+		while ((headEnd = pending.find("\r\n\r\n")) == std::string::npos && pending.size() < MAX_REQUEST_HEAD)
+		{
+			ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+			if (received <= 0)
+			{
+				break;
+			}
+			pending.append(buffer, (size_t)received);
+		}
+		if (headEnd == std::string::npos)
+		{
+			break;
+		}
+		std::istringstream head(pending.substr(0, headEnd));
+		pending.erase(0, headEnd + 4);
+
+		std::string method, target, version, line;
+		head >> method >> target >> version;
+		std::getline(head, line);
+		std::string range, connection;
+		while (std::getline(head, line))
+		{
+			size_t colon = line.find(':');
+			if (colon != std::string::npos)
+			{
+				std::string field = line.substr(0, colon);
+				std::transform(field.begin(), field.end(), field.begin(), ::tolower);
+				std::string value = line.substr(colon + 1);
+				value.erase(0, value.find_first_not_of(' '));
+				value.erase(value.find_last_not_of("\r ") + 1);
+				if (field == "range")
+				{
+					range = value;
+				}
+				else if (field == "connection")
+				{
+					connection = value;
+					std::transform(connection.begin(), connection.end(), connection.begin(), ::tolower);
+				}
+			}
+		}
+		keepAlive = (version == "HTTP/1.1") ? (connection != "close") : (connection == "keep-alive");
+		{
+			std::lock_guard<std::mutex> guard(mMutex);
+			mStats.requests++;
+		}
+
+		ReplayShaping shaping = getShaping();
+		for (int waitedMs = 0; waitedMs < shaping.latencyMs && mRunning; waitedMs += 10)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(std::min(10, shaping.latencyMs - waitedMs)));
+		}
+
+		int status = 200;
+		std::string body;
+		std::string filePath;
+		std::string contentRange;
+		if (injectError())
+		{
+			if (shaping.errorCode == 0)
+			{
+				break; // dropped connection
+			}
+			status = shaping.errorCode;
+		}
+		else if (method != "GET" && method != "HEAD")
+		{
+			status = 405;
+		}
+		else if (!resolveFile(target, filePath))
+		{
+			std::lock_guard<std::mutex> guard(mMutex);
+			mStats.notFound++;
+			status = 404;
+		}
+		else
+		{
+			std::ifstream file(filePath, std::ifstream::binary);
+			body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			if (body.compare(0, 7, "#EXTM3U") == 0 || body.find("<MPD") != std::string::npos)
+			{
+				// absolute urls of harvested asset are served from here as /<host>/<path>
+				std::string baseUrl = getBaseUrl() + "/";
+				size_t pos = 0;
+				while ((pos = body.find("http", pos)) != std::string::npos)
+				{
+					size_t schemeLen = (body.compare(pos, 8, "https://") == 0) ? 8 : ((body.compare(pos, 7, "http://") == 0) ? 7 : 0);
+					if (schemeLen)
+					{
+						body.replace(pos, schemeLen, baseUrl);
+						pos += baseUrl.size();
+					}
+					else
+					{
+						pos += 4;
+					}
+				}
+			}
+			unsigned long long first = 0, last = 0;
+			size_t dash = range.find('-');
+			if (range.compare(0, 6, "bytes=") == 0 && dash != std::string::npos)
+			{
+				std::string from = range.substr(6, dash - 6);
+				std::string to = range.substr(dash + 1);
+				if (from.empty())
+				{
+					unsigned long long suffix = strtoull(to.c_str(), NULL, 10);
+					first = (suffix < body.size()) ? body.size() - suffix : 0;
+					last = body.size() - 1;
+				}
+				else
+				{
+					first = strtoull(from.c_str(), NULL, 10);
+					last = to.empty() ? body.size() - 1 : std::min(strtoull(to.c_str(), NULL, 10), (unsigned long long)body.size() - 1);
+				}
+				if (body.empty() || first > last || first >= body.size())
+				{
+					status = 416;
+					contentRange = "bytes */" + std::to_string(body.size());
+					body.clear();
+				}
+				else
+				{
+					status = 206;
+					contentRange = "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(body.size());
+					body = body.substr(first, last - first + 1);
+				}
+			}
+		}
+
+		std::string response = "HTTP/1.1 " + std::to_string(status) + " " + getStatusText(status) + "\r\n";
+		if (status == 200 || status == 206)
+		{
+			response += std::string("Content-Type: ") + getContentType(filePath) + "\r\nAccept-Ranges: bytes\r\n";
+		}
+		else
+		{
+			body.clear();
+		}
+		if (!contentRange.empty())
+		{
+			response += "Content-Range: " + contentRange + "\r\n";
+		}
+		response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+		response += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+		if (!sendAll(fd, response.data(), response.size(), false) ||
+			(method != "HEAD" && !sendAll(fd, body.data(), body.size(), true)))
+		{
+			break;
+		}
+	}
+	std::lock_guard<std::mutex> guard(mMutex);
+	mConnectionFds.remove(fd);
+	close(fd);
+	mCond.notify_all();
+}
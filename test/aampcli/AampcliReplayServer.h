@@ -0,0 +1,111 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file AampcliReplayServer.h
+ * @brief Local HTTP server replaying a harvested asset
+ */
+
+#ifndef AAMPCLIREPLAYSERVER_H
+#define AAMPCLIREPLAYSERVER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <random>
+
+/**
+ * @brief Network conditions applied to replayed requests
+ */
+typedef struct replayShaping
+{
+	int latencyMs;		// delay before each response
+	long bandwidthKbps;	// shared by all connections, 0 for unlimited
+	int errorPercent;	// share of requests failed on purpose
+	int errorCode;		// http status of failed requests, 0 to drop the connection instead
+	unsigned int seed;	// error injection is reproducible for a seed
+}ReplayShaping;
+
+/**
+ * @brief Counters of replayed requests
+ */
+typedef struct replayStats
+{
+	unsigned long requests;
+	unsigned long notFound;
+	unsigned long injectedErrors;
+	unsigned long long bytesSent;
+}ReplayStats;
+
+/**
+ * @brief Serves files written by harvest (aamp_WriteFile) on 127.0.0.1
+ *
+ * http://<host>/<path> of the original asset is served as http://127.0.0.1:<port>/<host>/<path>.
+ * Playlists and manifests harvested once per refresh (<path>.<n>, manifest.<n>.<ext>) are
+ * served in harvest order on successive requests, the last one repeating. Absolute urls in
+ * playlists and manifests are pointed to the server, so a whole asset replays offline.
+ */
+class ReplayServer
+{
+	public:
+		ReplayServer();
+		~ReplayServer();
+		ReplayServer(const ReplayServer&) = delete;
+		ReplayServer& operator=(const ReplayServer&) = delete;
+
+		bool start(const std::string& rootPath, int port);
+		void stop();
+		bool isRunning();
+		int getPort();
+		std::string getBaseUrl();
+		void setShaping(const ReplayShaping& shaping);
+		ReplayShaping getShaping();
+		ReplayStats getStats();
+		void resetStats();
+
+	private:
+		void acceptLoop();
+		void serveConnection(int fd);
+		bool resolveFile(const std::string& target, std::string& filePath);
+		bool injectError();
+		void pace(size_t bytes);
+		bool sendAll(int fd, const char *data, size_t len, bool shaped);
+
+		std::string mRootPath;
+		int mListenFd;
+		int mPort;
+		std::atomic<bool> mRunning;
+		std::thread mAcceptThread;
+		std::mutex mMutex;
+		std::condition_variable mCond;
+		std::list<int> mConnectionFds;				// open connections, each served by a detached thread
+		std::map<std::string, unsigned int> mRequestCount;	// requests per target, picks harvested refresh
+		ReplayShaping mShaping;
+		ReplayStats mStats;
+		std::mt19937 mRandom;
+		std::mutex mPaceMutex;
+		long long mNextSendUs;					// earliest start of next shaped write
+};
+
+#endif // AAMPCLIREPLAYSERVER_H
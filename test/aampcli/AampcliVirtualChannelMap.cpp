@@ -231,6 +231,20 @@ void VirtualChannelMap::tuneToChannel( VirtualChannelInfo &channel, PlayerInstan
 	const char *locator = channel.uri.c_str();
 	printf( "TUNING to '%s' %s\n", name, locator );
 	playerInstanceAamp->Tune(locator);
+
+	// zapping goes on up or down, keep both neighbours staged
+	std::vector<std::string> neighbours;
+	VirtualChannelInfo *pNextChannel = next();
+	VirtualChannelInfo *pPrevChannel = prev();
+	if (pNextChannel)
+	{
+		neighbours.push_back(pNextChannel->uri);
+	}
+	if (pPrevChannel && pPrevChannel != pNextChannel)
+	{
+		neighbours.push_back(pPrevChannel->uri);
+	}
+	playerInstanceAamp->SetPreTuneChannels(neighbours);
 }
 
 std::string VirtualChannelMap::getNextFieldFromCSV( const char **pptr )
@@ -0,0 +1,61 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "AampBandwidthEstimator.h"
+
+AampBandwidthEstimator::AampBandwidthEstimator() : mMutex(), mModel(), mMaxAgeMs(0), mEnabled(false), mBitsPerSecond(-1), mLastSampleTimeMs(0)
+{
+}
+
+void AampBandwidthEstimator::Configure(int type, long maxAgeMs)
+{
+}
+
+void AampBandwidthEstimator::SetModel(std::unique_ptr<AampBandwidthModel> model, long maxAgeMs)
+{
+}
+
+void AampBandwidthEstimator::AddSample(double bytes, long long durationMs, long long nowMs)
+{
+}
+
+long AampBandwidthEstimator::GetEstimate(long long nowMs) const
+{
+    return -1;
+}
+
+void AampBandwidthEstimator::Reset()
+{
+}
+
+AampTransferSampler::AampTransferSampler(long idleGapMs) : mIdleGapMs(idleGapMs), mStartMs(-1), mLastMs(-1), mLastBytes(0), mActiveMs(0)
+{
+}
+
+void AampTransferSampler::Start(long long nowMs)
+{
+}
+
+void AampTransferSampler::OnProgress(double bytesNow, long long nowMs, AampBandwidthEstimator &estimator)
+{
+}
+
+void AampTransferSampler::Finish(double bytes, long long nowMs, AampBandwidthEstimator &estimator)
+{
+}
@@ -0,0 +1,50 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "AampBufferPool.h"
+
+AampBufferPool::AampBufferPool(AampLogManager *logObj, size_t maxPoolBytes)
+{
+}
+
+AampBufferPool::~AampBufferPool()
+{
+}
+
+bool AampBufferPool::Acquire(GrowableBuffer *buffer, size_t expectedSize, MediaType type)
+{
+	return false;
+}
+
+void AampBufferPool::Release(GrowableBuffer *buffer, MediaType type)
+{
+}
+
+void AampBufferPool::Flush()
+{
+}
+
+void AampBufferPool::SetMaxPoolSize(size_t maxPoolBytes)
+{
+}
+
+AampBufferPoolStats AampBufferPool::GetStats()
+{
+	return AampBufferPoolStats();
+}
@@ -44,6 +44,11 @@ bool AampCacheHandler::RetrieveFromPlaylistCache(const std::string url, Growable
     return false;
 }
 
+AampCachedFilePtr AampCacheHandler::BorrowFromPlaylistCache(const std::string &url)
+{
+    return NULL;
+}
+
 void AampCacheHandler::SetMaxPlaylistCacheSize(int maxPlaylistCacheSz)
 {
 }
@@ -55,4 +60,13 @@ void AampCacheHandler::SetMaxInitFragCacheSize(int maxInitFragCacheSz)
 bool AampCacheHandler::IsUrlCached(std::string url)
 {
     return false;
-}
\ No newline at end of file
+}
+
+bool AampCacheHandler::IsInitFragmentCached(const std::string &url)
+{
+    return false;
+}
+
+void AampCacheHandler::SetPersistentCache(const std::string &path, int maxSizeKB, int maxAgeSec)
+{
+}
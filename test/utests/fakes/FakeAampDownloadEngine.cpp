@@ -0,0 +1,84 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "AampDownloadEngine.h"
+
+AampDownloadEngine::AampDownloadEngine(AampLogManager *logObj, int maxTransfers)
+{
+}
+
+AampDownloadEngine::~AampDownloadEngine()
+{
+}
+
+bool AampDownloadEngine::Start()
+{
+    return false;
+}
+
+void AampDownloadEngine::Stop()
+{
+}
+
+bool AampDownloadEngine::IsRunning()
+{
+    return false;
+}
+
+void AampDownloadEngine::SetMaxTransfers(int maxTransfers)
+{
+}
+
+void AampDownloadEngine::SetMultiplex(bool multiplex)
+{
+}
+
+CURLcode AampDownloadEngine::Perform(CURL *curl, AampDownloadPriority priority)
+{
+    return curl_easy_perform(curl);
+}
+
+bool AampDownloadEngine::CanPrefetch(MediaType type, const std::string &url, const std::string &range, int maxOutstanding)
+{
+    return false;
+}
+
+bool AampDownloadEngine::Prefetch(std::shared_ptr<AampDownloadRequest> request, int maxOutstanding)
+{
+    return false;
+}
+
+std::shared_ptr<AampDownloadRequest> AampDownloadEngine::ClaimPrefetch(MediaType type, const std::string &url, const std::string &range)
+{
+    return nullptr;
+}
+
+void AampDownloadEngine::CancelPrefetch(MediaType type)
+{
+}
+
+AampDownloadEngineStats AampDownloadEngine::GetStats()
+{
+    return AampDownloadEngineStats();
+}
+
+AampDownloadPriority AampDownloadEngine::GetPriorityForMediaType(MediaType type)
+{
+    return eDOWNLOAD_PRIORITY_MEDIA;
+}
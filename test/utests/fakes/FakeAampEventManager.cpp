@@ -82,6 +82,19 @@ void AampEventManager::SetPlayerState(PrivAAMPState state)
 {
 }
 
+void AampEventManager::SetBatchDispatch(bool enable)
+{
+}
+
+bool AampEventManager::SetEventRateLimit(AAMPEventType eventType, int intervalMs)
+{
+    return false;
+}
+
+void AampEventManager::GetDispatchStats(AAMPEventType eventType, AampEventDispatchStats &stats)
+{
+}
+
 bool AampEventManager::IsSpecificEventListenerAvailable(AAMPEventType eventType)
 {	
     return false;
@@ -50,6 +50,10 @@ void AampLogManager::setLogLevel(AAMP_LogLevel newLevel)
 {
 }
 
+void AampLogManager::setAsyncLogging(bool enable)
+{
+}
+
 void logprintf(const char *format, ...)
 {
 #ifdef ENABLE_LOGGING
@@ -86,6 +90,24 @@ void logprintf_new(int playerId, const char* levelstr, const char* file, int lin
 #endif
 }
 
+void logprintf_async(bool literalFormat, int playerId, const char* levelstr, const char* file, int line, const char *format, ...)
+{
+#ifdef ENABLE_LOGGING
+	int len = 0;
+	va_list args;
+	va_start(args, format);
+
+	char gDebugPrintBuffer[MAX_DEBUG_LOG_BUFF_SIZE];
+	len = sprintf(gDebugPrintBuffer, "[AAMP-PLAYER][%d][%s][%s][%d]", playerId, levelstr, file, line);
+	vsnprintf(gDebugPrintBuffer+len, MAX_DEBUG_LOG_BUFF_SIZE-len, format, args);
+	gDebugPrintBuffer[(MAX_DEBUG_LOG_BUFF_SIZE-1)] = 0;
+
+	std::cout << gDebugPrintBuffer << std::endl;
+
+	va_end(args);
+#endif
+}
+
 void DumpBlob(const unsigned char *ptr, size_t len)
 {
 }
@@ -0,0 +1,25 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "AampLruCache.h"
+
+AampLruCache::AampLruCache() : mEntries(), mTypes(), mTotalBytes(0), mMaxTotalBytes(AAMP_LRU_CACHE_UNLIMITED),
+    mDefaultMaxBytes(AAMP_LRU_CACHE_UNLIMITED), mDefaultMaxEntries(AAMP_LRU_CACHE_UNLIMITED), mCount(0)
+{
+}
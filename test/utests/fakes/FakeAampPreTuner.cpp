@@ -0,0 +1,66 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "AampPreTuner.h"
+
+AampPreTuner::AampPreTuner(AampLogManager *logObj, Downloader downloader) : mMutex(), mCond(), mThread(), mRunning(false), mPaused(false),
+    mInterrupt(false), mChannels(), mStaged(), mAttemptTimeMs(), mConfig(), mStats(), mDownloader(downloader), mCurl(NULL), mLogObj(logObj)
+{
+}
+
+AampPreTuner::~AampPreTuner()
+{
+}
+
+void AampPreTuner::SetConfig(const AampPreTuneConfig &config)
+{
+}
+
+void AampPreTuner::SetChannels(const std::vector<std::string> &urls)
+{
+}
+
+void AampPreTuner::SetPaused(bool paused)
+{
+}
+
+bool AampPreTuner::Take(const std::string &url, AampPreTunedFiles &files)
+{
+    return false;
+}
+
+bool AampPreTuner::StageChannel(const std::string &url)
+{
+    return false;
+}
+
+AampPreTuneStats AampPreTuner::GetStats()
+{
+    return AampPreTuneStats();
+}
+
+bool AampPreTuner::SelectVariant(const std::string &manifest, long bitrate, std::string &videoUri, std::string &audioUri)
+{
+    return false;
+}
+
+bool AampPreTuner::SelectFragments(const std::string &playlist, double liveOffset, std::string &initUri, std::string &keyUri, std::string &segmentUri)
+{
+    return false;
+}
@@ -0,0 +1,66 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "AampReactor.h"
+
+AampReactor &AampReactor::GetInstance()
+{
+    static AampReactor instance;
+    return instance;
+}
+
+AampReactor::AampReactor() : mMutex(), mTimerCond(), mWorkerCond(), mDoneCond(), mTasks(), mWheel(), mOccupied(),
+    mCurrentTick(0), mSleepUntilTick(0), mStartUs(0), mReady(), mStats(), mTimerThread(), mWorkers(),
+    mIdleWorkers(0), mNextId(0), mStopping(false)
+{
+}
+
+AampReactor::~AampReactor()
+{
+}
+
+int AampReactor::Schedule(const char *name, int delayMs, AampReactorTask task)
+{
+    return AAMP_REACTOR_TASK_ID_INVALID;
+}
+
+bool AampReactor::Wake(int id)
+{
+    return false;
+}
+
+bool AampReactor::Cancel(int id)
+{
+    return false;
+}
+
+bool AampReactor::IsScheduled(int id)
+{
+    return false;
+}
+
+void AampReactor::GetStats(std::vector<AampReactorTaskStats> &stats)
+{
+    stats.clear();
+}
+
+int AampReactor::GetWorkerCount()
+{
+    return 0;
+}
@@ -0,0 +1,70 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "AampTraceRecorder.h"
+
+std::atomic<bool> AampTraceRecorder::sEnabled(false);
+
+AampTraceRecorder &AampTraceRecorder::GetInstance()
+{
+    static AampTraceRecorder instance;
+    return instance;
+}
+
+AampTraceRecorder::AampTraceRecorder() : mMutex(), mBuffers(), mGeneration(0), mEventsPerThread(0), mNextTid(1)
+{
+}
+
+long long AampTraceRecorder::NowUs()
+{
+    return 0;
+}
+
+void AampTraceRecorder::Start(size_t eventsPerThread)
+{
+}
+
+void AampTraceRecorder::Stop()
+{
+}
+
+void AampTraceRecorder::AddComplete(const char *category, const char *name, long long startUs, long long durationUs,
+        const char *argName0, long long arg0, const char *argName1, long long arg1, const char *argName2, long long arg2)
+{
+}
+
+void AampTraceRecorder::AddInstant(const char *category, const char *name,
+        const char *argName0, long long arg0, const char *argName1, long long arg1, const char *argName2, long long arg2)
+{
+}
+
+void AampTraceRecorder::AddCounter(const char *category, const char *name, const char *argName, long long value)
+{
+}
+
+size_t AampTraceRecorder::GetJson(std::string &json)
+{
+    json.clear();
+    return 0;
+}
+
+bool AampTraceRecorder::WriteJson(const std::string &path)
+{
+    return false;
+}
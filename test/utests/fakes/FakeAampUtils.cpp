@@ -18,6 +18,8 @@
 */
 
 #include "AampUtils.h"
+#include <stdlib.h>
+#include <time.h>
 
 long long aamp_GetCurrentTimeMS(void)
 {
@@ -71,4 +73,25 @@ void getDefaultHarvestPath(std::string &value)
 bool aamp_WriteFile(std::string fileName, const char* data, size_t len, MediaType &fileType, unsigned int count,const char *prefix)
 {
     return false;
-}
\ No newline at end of file
+}
+
+void aamp_ResolveURL(std::string& dst, std::string base, const char *uri , bool bPropagateUriParams)
+{
+    dst = uri;
+}
+
+double ISO8601DateTimeToUTCSeconds(const char *ptr)
+{
+	double timeSeconds = 0;
+	if (ptr)
+	{
+		std::tm timeObj = { 0 };
+		const char *msString = strptime(ptr, "%Y-%m-%dT%H:%M:%S.", &timeObj);
+		timeSeconds = timegm(&timeObj);
+		if (msString && *msString)
+		{
+			timeSeconds += atof(msString - 1);
+		}
+	}
+	return timeSeconds;
+}
@@ -42,6 +42,11 @@ void curl_easy_cleanup(CURL *curl)
 {
 }
 
+CURL *curl_easy_duphandle(CURL *curl)
+{
+    return nullptr;
+}
+
 CURLcode curl_easy_getinfo(CURL *curl, CURLINFO info, ...)
 {
     return CURLE_OK;
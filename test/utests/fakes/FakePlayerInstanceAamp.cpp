@@ -62,6 +62,7 @@ MockPlayerInstanceAAMP *g_mockPlayerInstanceAAMP = nullptr;
 	void PlayerInstanceAAMP::SetAnonymousRequest(bool isAnonymous) {  }
 	void PlayerInstanceAAMP::SetAvgBWForABR(bool useAvgBW) {  }
 	void PlayerInstanceAAMP::SetPreCacheTimeWindow(int nTimeWindow) {  }
+	void PlayerInstanceAAMP::SetPreTuneChannels(const std::vector<std::string> &manifestUrls) {  }
 	void PlayerInstanceAAMP::SetVODTrickplayFPS(int vodTrickplayFPS) {  }
 	void PlayerInstanceAAMP::SetLinearTrickplayFPS(int linearTrickplayFPS) {  }
 	void PlayerInstanceAAMP::SetLiveOffset(double liveoffset) {  }
@@ -302,6 +302,10 @@ void PrivateInstanceAAMP::SetAppName(std::string name)
 {
 }
 
+void PrivateInstanceAAMP::SetPreTuneChannels(const std::vector<std::string> &manifestUrls)
+{
+}
+
 int PrivateInstanceAAMP::GetAudioTrack()
 {
 	return 0;
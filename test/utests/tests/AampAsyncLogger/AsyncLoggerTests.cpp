@@ -0,0 +1,244 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AampAsyncLogger.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+#define TEST_PREFIX "[AAMP-PLAYER][7][WARN][TestFunction][42]"
+
+class AsyncLoggerTests : public ::testing::Test
+{
+protected:
+	std::mutex mMutex;
+	std::vector<std::string> mLines;
+
+	void TearDown() override
+	{
+		AampAsyncLogger::GetInstance().Stop();
+	}
+
+	void Start(int slotsPerThread)
+	{
+		AampAsyncLogger::GetInstance().Start(slotsPerThread, [this](const AampLogLine *lines, int count)
+		{
+			std::lock_guard<std::mutex> guard(mMutex);
+			for (int i = 0; i < count; i++)
+			{
+				mLines.push_back(lines[i].text);
+			}
+		});
+	}
+
+	static bool Log(const char *format, ...)
+	{
+		va_list args;
+		va_start(args, format);
+		bool queued = AampAsyncLogger::GetInstance().Log(7, "WARN", "TestFunction", 42, format, args);
+		va_end(args);
+		return queued;
+	}
+
+	static std::string Expected(const char *format, ...)
+	{
+		char text[AAMP_ASYNC_LOG_LINE_SIZE];
+		int length = snprintf(text, sizeof(text), "%s", TEST_PREFIX);
+		va_list args;
+		va_start(args, format);
+		vsnprintf(text + length, sizeof(text) - length, format, args);
+		va_end(args);
+		return text;
+	}
+};
+
+/*
+    Queued messages are formatted as snprintf formats them
+*/
+TEST_F(AsyncLoggerTests, FormatsLikeSnprintf)
+{
+	const char unterminated[] = {'a', 'b', 'c', 'd'};
+	int value = 0;
+	Start(AAMP_ASYNC_LOG_SLOTS);
+	ASSERT_TRUE(Log("plain text"));
+	ASSERT_TRUE(Log("%d %5i %-4u| %x %#X %o %c %%", -12, 34, 56u, 255, 255, 8, 'z'));
+	ASSERT_TRUE(Log("%hhd %hu %ld %lld %zu %jd %td", 300, 70000, -5L, 1LL << 40, (size_t)17, (intmax_t)-3, (ptrdiff_t)9));
+	ASSERT_TRUE(Log("%.2f %10.3e %g %Lf", 3.14159, 12345.678, 0.5, (long double)2.5));
+	ASSERT_TRUE(Log("[%s] [%-8s] [%.2s] [%.*s] [%*d] [%*.*f]", "str", "left", "cut", 3, unterminated, 6, 5, 8, 2, 1.5));
+	ASSERT_TRUE(Log("%s %p", (const char *)NULL, (void *)&value));
+	AampAsyncLogger::GetInstance().Stop();
+
+	ASSERT_EQ(mLines.size(), 6u);
+	EXPECT_EQ(mLines[0], Expected("plain text"));
+	EXPECT_EQ(mLines[1], Expected("%d %5i %-4u| %x %#X %o %c %%", -12, 34, 56u, 255, 255, 8, 'z'));
+	EXPECT_EQ(mLines[2], Expected("%hhd %hu %ld %lld %zu %jd %td", 300, 70000, -5L, 1LL << 40, (size_t)17, (intmax_t)-3, (ptrdiff_t)9));
+	EXPECT_EQ(mLines[3], Expected("%.2f %10.3e %g %Lf", 3.14159, 12345.678, 0.5, (long double)2.5));
+	EXPECT_EQ(mLines[4], Expected("[%s] [%-8s] [%.2s] [%.*s] [%*d] [%*.*f]", "str", "left", "cut", 3, unterminated, 6, 5, 8, 2, 1.5));
+	EXPECT_EQ(mLines[5], Expected("%s %p", "(null)", (void *)&value));
+}
+
+/*
+    Formats which cannot be queued and a stopped logger are left to the caller
+*/
+TEST_F(AsyncLoggerTests, RefusesWhatCannotBeQueued)
+{
+	EXPECT_FALSE(Log("stopped"));
+	Start(AAMP_ASYNC_LOG_SLOTS);
+	EXPECT_FALSE(Log("%2$d %1$d", 1, 2));
+	EXPECT_FALSE(Log("%ls", L"wide"));
+	EXPECT_FALSE(Log("%m"));
+	EXPECT_FALSE(Log("%Ld", 1LL));
+	EXPECT_TRUE(Log("%d", 1));
+	AampAsyncLogger::GetInstance().Stop();
+	EXPECT_EQ(mLines.size(), 1u);
+	EXPECT_FALSE(Log("stopped"));
+}
+
+/*
+    Long strings are cut so the message fits, lines end at AAMP_ASYNC_LOG_LINE_SIZE
+*/
+TEST_F(AsyncLoggerTests, CutsLongMessages)
+{
+	std::string url(3 * AAMP_ASYNC_LOG_LINE_SIZE, 'u');
+	Start(AAMP_ASYNC_LOG_SLOTS);
+	ASSERT_TRUE(Log("url %s", url.c_str()));
+	AampAsyncLogger::GetInstance().Stop();
+	ASSERT_EQ(mLines.size(), 1u);
+	EXPECT_EQ(mLines[0].size(), (size_t)(AAMP_ASYNC_LOG_LINE_SIZE - 1));
+	EXPECT_EQ(mLines[0].compare(0, strlen(TEST_PREFIX "url u"), TEST_PREFIX "url u"), 0);
+}
+
+/*
+    Messages of a full ring are dropped, counted and reported by the writer
+*/
+TEST_F(AsyncLoggerTests, CountsDroppedMessages)
+{
+	std::mutex sinkMutex;
+	std::condition_variable sinkCond;
+	bool inSink = false;
+	bool release = false;
+	const int slots = 8;
+	unsigned long long droppedBefore = AampAsyncLogger::GetInstance().GetDroppedCount();
+	AampAsyncLogger::GetInstance().Start(slots, [&](const AampLogLine *lines, int count)
+	{
+		std::unique_lock<std::mutex> lock(sinkMutex);
+		inSink = true;
+		sinkCond.notify_all();
+		sinkCond.wait(lock, [&]() { return release; });
+		for (int i = 0; i < count; i++)
+		{
+			mLines.push_back(lines[i].text);
+		}
+	});
+	// logged from a new thread, so the ring has the size given to Start
+	std::thread producer([&]()
+	{
+		ASSERT_TRUE(Log("first"));
+		{
+			std::unique_lock<std::mutex> lock(sinkMutex);
+			sinkCond.wait(lock, [&]() { return inSink; });
+		}
+		for (int i = 0; i < 3 * slots; i++)
+		{
+			ASSERT_TRUE(Log("message %d", i));
+		}
+	});
+	producer.join();
+	{
+		std::lock_guard<std::mutex> lock(sinkMutex);
+		release = true;
+		sinkCond.notify_all();
+	}
+	AampAsyncLogger::GetInstance().Stop();
+
+	EXPECT_EQ(AampAsyncLogger::GetInstance().GetDroppedCount() - droppedBefore, (unsigned long long)(2 * slots));
+	ASSERT_EQ(mLines.size(), (size_t)(slots + 2));
+	EXPECT_EQ(mLines[0], Expected("first"));
+	for (int i = 0; i < slots; i++)
+	{
+		EXPECT_EQ(mLines[i + 1], Expected("message %d", i));
+	}
+	EXPECT_NE(mLines[slots + 1].find("[WARN]"), std::string::npos);
+	EXPECT_NE(mLines[slots + 1].find("16 messages of thread"), std::string::npos);
+}
+
+/*
+    Messages of several threads arrive in the order each thread logged them
+*/
+TEST_F(AsyncLoggerTests, KeepsOrderOfEachThread)
+{
+	const int threadCount = 4;
+	const int count = 2000;
+	unsigned long long droppedBefore = AampAsyncLogger::GetInstance().GetDroppedCount();
+	Start(AAMP_ASYNC_LOG_SLOTS);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; t++)
+	{
+		threads.push_back(std::thread([t]()
+		{
+			for (int i = 0; i < count; i++)
+			{
+				ASSERT_TRUE(Log("thread %d message %d", t, i));
+				if (i % 100 == 0)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+			}
+		}));
+	}
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+	AampAsyncLogger::GetInstance().Stop();
+
+	unsigned long long dropped = AampAsyncLogger::GetInstance().GetDroppedCount() - droppedBefore;
+	size_t messages = 0;
+	std::vector<int> next(threadCount, 0);
+	for (const std::string &line : mLines)
+	{
+		int t = -1;
+		int i = -1;
+		if (sscanf(line.c_str(), TEST_PREFIX "thread %d message %d", &t, &i) == 2)
+		{
+			ASSERT_GE(t, 0);
+			ASSERT_LT(t, threadCount);
+			EXPECT_GE(i, next[t]);
+			next[t] = i + 1;
+			messages++;
+		}
+	}
+	EXPECT_GT(messages, 0u);
+	EXPECT_LE(messages, (size_t)(threadCount * count));
+	if (dropped == 0)
+	{
+		EXPECT_EQ(messages, (size_t)(threadCount * count));
+	}
+}
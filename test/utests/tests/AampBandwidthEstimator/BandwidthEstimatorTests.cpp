@@ -0,0 +1,178 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include "AampBandwidthEstimator.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+#define TEST_CACHE_LIFE_MS 5000
+
+/*
+    EWMA reports nothing until enough bytes are seen, then the steady rate
+*/
+TEST(BandwidthEstimatorTests, EwmaFollowsSteadyRate)
+{
+	AampEwmaBandwidthModel model;
+	// 125000 bytes in 100 ms is 10 Mbps
+	EXPECT_EQ(model.AddSample(25000, 20, 0), -1);
+	long bps = -1;
+	for (int i = 1; i <= 20; i++)
+	{
+		bps = model.AddSample(125000, 100, i * 100);
+	}
+	EXPECT_NEAR(bps, 10000000, 10000);
+
+	model.Reset();
+	EXPECT_EQ(model.AddSample(25000, 20, 0), -1);
+}
+
+/*
+    Lower of fast and slow average is reported, so drops show quickly and bursts slowly
+*/
+TEST(BandwidthEstimatorTests, EwmaReportsLowerAverage)
+{
+	AampEwmaBandwidthModel model;
+	long bps = -1;
+	long long now = 0;
+	for (int i = 0; i < 50; i++)
+	{
+		bps = model.AddSample(125000, 100, now += 100);
+	}
+	// three seconds of transfer at 1 Mbps, fast average follows
+	for (int i = 0; i < 30; i++)
+	{
+		bps = model.AddSample(12500, 100, now += 100);
+	}
+	EXPECT_LT(bps, 5000000);
+
+	// one second at 10 Mbps after a long run at 1 Mbps, slow average holds estimate down
+	model.Reset();
+	for (int i = 0; i < 100; i++)
+	{
+		bps = model.AddSample(12500, 100, now += 100);
+	}
+	EXPECT_NEAR(bps, 1000000, 1000);
+	for (int i = 0; i < 10; i++)
+	{
+		bps = model.AddSample(125000, 100, now += 100);
+	}
+	EXPECT_GT(bps, 1000000);
+	EXPECT_LT(bps, 3000000);
+}
+
+/*
+    Sliding window drops samples by age and by count
+*/
+TEST(BandwidthEstimatorTests, SlidingWindowDropsOldSamples)
+{
+	AampSlidingWindowBandwidthModel model(1000, 4);
+	EXPECT_EQ(model.AddSample(1000, 10, 0), 800000);
+	EXPECT_EQ(model.AddSample(3000, 10, 500), 1600000);
+	// first sample is older than window
+	EXPECT_EQ(model.AddSample(1000, 10, 1200), 1600000);
+	EXPECT_EQ(model.AddSample(1000, 10, 1300), 1333333);
+	EXPECT_EQ(model.AddSample(1000, 10, 1400), 1200000);
+	// window holds 4 samples, 3000 bytes sample is dropped
+	EXPECT_EQ(model.AddSample(1000, 10, 1450), 800000);
+	model.Reset();
+	EXPECT_EQ(model.AddSample(2000, 10, 1500), 1600000);
+}
+
+/*
+    Estimate is read without lock, expires after cache life and is dropped by Reset
+*/
+TEST(BandwidthEstimatorTests, PublishesEstimate)
+{
+	AampBandwidthEstimator estimator;
+	EXPECT_FALSE(estimator.IsEnabled());
+	estimator.AddSample(1000, 10, 0);
+	EXPECT_EQ(estimator.GetEstimate(0), -1);
+
+	estimator.Configure(eBANDWIDTH_ESTIMATOR_SLIDING_WINDOW, TEST_CACHE_LIFE_MS);
+	ASSERT_TRUE(estimator.IsEnabled());
+	estimator.AddSample(1000, 0, 0);
+	EXPECT_EQ(estimator.GetEstimate(0), -1);
+	estimator.AddSample(1000, 10, 100);
+	EXPECT_EQ(estimator.GetEstimate(100), 800000);
+	EXPECT_EQ(estimator.GetEstimate(100 + TEST_CACHE_LIFE_MS), 800000);
+	EXPECT_EQ(estimator.GetEstimate(101 + TEST_CACHE_LIFE_MS), -1);
+
+	estimator.Reset();
+	EXPECT_EQ(estimator.GetEstimate(100), -1);
+	EXPECT_TRUE(estimator.IsEnabled());
+
+	estimator.Configure(eBANDWIDTH_ESTIMATOR_HYBRID_ABR, TEST_CACHE_LIFE_MS);
+	EXPECT_FALSE(estimator.IsEnabled());
+}
+
+/*
+    Only active transfer within a chunked response is sampled, not the wait for the encoder
+*/
+TEST(BandwidthEstimatorTests, SamplesActiveTransferTime)
+{
+	AampBandwidthEstimator estimator;
+	estimator.Configure(eBANDWIDTH_ESTIMATOR_SLIDING_WINDOW, TEST_CACHE_LIFE_MS);
+	AampTransferSampler sampler;
+	long long now = 1000;
+	double bytes = 0;
+	sampler.Start(now);
+	// 4 chunks, 200 ms apart, each delivered in 5 progress updates 2 ms apart
+	for (int chunk = 0; chunk < 4; chunk++)
+	{
+		now += 200;
+		for (int update = 0; update < 5; update++)
+		{
+			bytes += 2000;
+			sampler.OnProgress(bytes, now, estimator);
+			// repeated update without new bytes
+			sampler.OnProgress(bytes, now + 1, estimator);
+			now += 2;
+		}
+	}
+	// first update of each chunk follows a pause and is not timed: 8000 bytes in 8 ms per chunk
+	EXPECT_EQ(sampler.GetActiveMs(), 32);
+	EXPECT_EQ(estimator.GetEstimate(now), 8000000);
+	sampler.Finish(bytes, now, estimator);
+	EXPECT_EQ(estimator.GetEstimate(now), 8000000);
+}
+
+/*
+    Transfer without timed interval is sampled over its whole duration
+*/
+TEST(BandwidthEstimatorTests, SamplesWholeTransferAsFallback)
+{
+	AampBandwidthEstimator estimator;
+	estimator.Configure(eBANDWIDTH_ESTIMATOR_SLIDING_WINDOW, TEST_CACHE_LIFE_MS);
+	AampTransferSampler sampler;
+	sampler.Start(0);
+	sampler.OnProgress(5000, 100, estimator);
+	sampler.OnProgress(10000, 400, estimator);
+	EXPECT_EQ(estimator.GetEstimate(400), -1);
+	sampler.Finish(10000, 500, estimator);
+	EXPECT_EQ(estimator.GetEstimate(500), 160000);
+	// finished transfer ignores late progress
+	sampler.OnProgress(20000, 501, estimator);
+	sampler.Finish(20000, 600, estimator);
+	EXPECT_EQ(estimator.GetEstimate(600), 160000);
+}
@@ -0,0 +1,166 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include "AampBolaAbr.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+#define TEST_BUFFER_TARGET 15
+#define TEST_FRAGMENT_DURATION 2.0
+
+class BolaAbrTests : public ::testing::Test
+{
+protected:
+	AampBolaAbr mAbr;
+	std::vector<AampBolaProfile> mLadder;
+
+	void SetUp() override
+	{
+		// profile indexes are not in bitrate order, as in a manifest
+		mLadder = { {3, 500000}, {0, 1000000}, {4, 2000000}, {1, 4000000}, {2, 8000000} };
+		mAbr.Configure(eBOLA_UTILITY_LOG, TEST_BUFFER_TARGET);
+	}
+
+	int Choose(int current, double bufferSec, long throughputBps, double sizeScale = 1.0)
+	{
+		return mAbr.GetProfileIndex(mLadder, current, bufferSec, TEST_FRAGMENT_DURATION, sizeScale, throughputBps);
+	}
+};
+
+/*
+    Empty ladder keeps current profile
+*/
+TEST_F(BolaAbrTests, EmptyLadder)
+{
+	std::vector<AampBolaProfile> ladder;
+	EXPECT_EQ(mAbr.GetProfileIndex(ladder, 7, 10, TEST_FRAGMENT_DURATION, 1.0, 1000000), 7);
+}
+
+/*
+    Until buffer builds, throughput with a safety margin picks the profile
+*/
+TEST_F(BolaAbrTests, StartupUsesThroughput)
+{
+	EXPECT_EQ(Choose(3, 0, 3000000), 4);
+	EXPECT_FALSE(mAbr.IsSteady());
+	// 90% of 2.1 Mbps does not sustain 2 Mbps
+	EXPECT_EQ(Choose(4, 1, 2100000), 0);
+	EXPECT_EQ(Choose(0, 1, 100000), 3);
+	// without an estimate the profile is kept
+	EXPECT_EQ(Choose(1, 2, -1), 1);
+}
+
+/*
+    Once buffer reaches a third of target, the buffer level alone picks the profile
+*/
+TEST_F(BolaAbrTests, SteadyStateFollowsBuffer)
+{
+	EXPECT_EQ(Choose(3, 5, -1), 3);
+	EXPECT_TRUE(mAbr.IsSteady());
+	EXPECT_EQ(Choose(3, 7, -1), 0);
+	EXPECT_EQ(Choose(0, 9, -1), 4);
+	EXPECT_EQ(Choose(4, 12, -1), 1);
+	EXPECT_EQ(Choose(1, 14, -1), 2);
+	EXPECT_EQ(Choose(2, 30, -1), 2);
+
+	size_t position = 0;
+	for (double buffer = 5; buffer <= TEST_BUFFER_TARGET; buffer += 0.25)
+	{
+		int profile = Choose(mLadder[position].profileIndex, buffer, -1);
+		size_t next = 0;
+		while (mLadder[next].profileIndex != profile)
+		{
+			next++;
+		}
+		EXPECT_GE(next, position) << "buffer " << buffer;
+		position = next;
+	}
+	EXPECT_EQ(position, mLadder.size() - 1);
+}
+
+/*
+    Oscillating throughput causes no switches while the buffer holds
+*/
+TEST_F(BolaAbrTests, ThroughputOscillationIgnored)
+{
+	EXPECT_EQ(Choose(3, 6, 20000000), 3);
+	int profile = Choose(3, 12, 20000000);
+	EXPECT_EQ(profile, 1);
+	for (int i = 0; i < 20; i++)
+	{
+		long throughput = (i % 2) ? 9000000 : 1500000;
+		EXPECT_EQ(Choose(profile, 12, throughput), 1) << "throughput " << throughput;
+	}
+}
+
+/*
+    Upswitch is capped by throughput, a fragment that would not arrive in time is avoided
+*/
+TEST_F(BolaAbrTests, ThroughputGuards)
+{
+	EXPECT_EQ(Choose(3, 6, 20000000), 3);
+	// buffer asks for top, network sustains 2 Mbps
+	EXPECT_EQ(Choose(3, 15, 2500000), 4);
+	// staying is allowed although throughput is below current bitrate
+	EXPECT_EQ(Choose(4, 15, 1000000), 4);
+	// 8 Mbps fragment at 1 Mbps takes 16s, 4 Mbps one 8s, with 15s of buffer
+	EXPECT_EQ(Choose(2, 15, 1000000), 1);
+	// fragments twice their nominal size
+	EXPECT_EQ(Choose(2, 15, 1000000, 2.0), 4);
+}
+
+/*
+    Buffer draining below half of a third of target returns to throughput
+*/
+TEST_F(BolaAbrTests, LowBufferFallsBackToThroughput)
+{
+	EXPECT_EQ(Choose(3, 20, -1), 2);
+	EXPECT_TRUE(mAbr.IsSteady());
+	EXPECT_EQ(Choose(2, 3, 9000000), 3);
+	EXPECT_TRUE(mAbr.IsSteady());
+	EXPECT_EQ(Choose(3, 2, 9000000), 2);
+	EXPECT_FALSE(mAbr.IsSteady());
+	// back to buffer based once it recovers
+	EXPECT_EQ(Choose(2, 5, 9000000), 3);
+	EXPECT_TRUE(mAbr.IsSteady());
+}
+
+/*
+    Utility selects how fast the buffer climbs the ladder
+*/
+TEST_F(BolaAbrTests, Utility)
+{
+	EXPECT_EQ(Choose(3, 6, -1), 3);
+	EXPECT_EQ(Choose(3, 10, -1), 4);
+
+	mAbr.Configure(eBOLA_UTILITY_SQRT, TEST_BUFFER_TARGET);
+	EXPECT_EQ(Choose(3, 6, -1), 3);
+	EXPECT_EQ(Choose(3, 10, -1), 1);
+
+	// nothing gained above 1 Mbps, so nothing above it is picked
+	mAbr.SetUtility([](double bitrateRatio) { return std::min(bitrateRatio, 2.0); });
+	EXPECT_EQ(Choose(3, 10, -1), 0);
+	EXPECT_EQ(Choose(0, 14, -1), 0);
+}
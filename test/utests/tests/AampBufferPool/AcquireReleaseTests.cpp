@@ -0,0 +1,158 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <glib.h>
+#include "AampBufferPool.h"
+
+class AampConfig;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+#define TEST_POOL_SIZE (8*1024*1024)
+
+class AcquireReleaseTests : public ::testing::Test
+{
+protected:
+	AampBufferPool *mPool = nullptr;
+
+	void SetUp() override
+	{
+		mPool = new AampBufferPool(mLogObj, TEST_POOL_SIZE);
+	}
+
+	void TearDown() override
+	{
+		delete mPool;
+		mPool = nullptr;
+	}
+};
+
+/*
+    Acquire rounds the expected size up to a power of two size class
+*/
+TEST_F(AcquireReleaseTests, AcquireRoundsUpToSizeClass)
+{
+	GrowableBuffer buffer;
+	memset(&buffer, 0x00, sizeof(buffer));
+
+	EXPECT_TRUE(mPool->Acquire(&buffer, 100*1024, eMEDIATYPE_VIDEO));
+	EXPECT_NE(buffer.ptr, nullptr);
+	EXPECT_EQ(buffer.len, 0);
+	EXPECT_EQ(buffer.avail, 128*1024);
+	mPool->Release(&buffer, eMEDIATYPE_VIDEO);
+	EXPECT_EQ(buffer.ptr, nullptr);
+}
+
+/*
+    Acquire on a buffer which already holds memory must not overwrite it
+*/
+TEST_F(AcquireReleaseTests, AcquireRejectsNonEmptyBuffer)
+{
+	char data[4];
+	GrowableBuffer buffer = { data, 0, sizeof(data) };
+
+	EXPECT_FALSE(mPool->Acquire(&buffer, 1024, eMEDIATYPE_VIDEO));
+	EXPECT_EQ(buffer.ptr, data);
+}
+
+/*
+    A released block is handed out again for a request of the same size class
+*/
+TEST_F(AcquireReleaseTests, ReleasedBlockIsReused)
+{
+	GrowableBuffer buffer;
+	memset(&buffer, 0x00, sizeof(buffer));
+
+	mPool->Acquire(&buffer, 1000*1024, eMEDIATYPE_VIDEO);
+	char *first = buffer.ptr;
+	buffer.len = 900*1024;
+	mPool->Release(&buffer, eMEDIATYPE_VIDEO);
+
+	mPool->Acquire(&buffer, 800*1024, eMEDIATYPE_VIDEO);
+	EXPECT_EQ(buffer.ptr, first);
+	mPool->Release(&buffer, eMEDIATYPE_VIDEO);
+
+	AampBufferPoolStats stats = mPool->GetStats();
+	EXPECT_EQ(stats.allocations, 1);
+	EXPECT_EQ(stats.reuses, 1);
+	EXPECT_EQ(stats.releases, 2);
+	EXPECT_EQ(stats.peakPooledBytes, 1024*1024);
+}
+
+/*
+    When size is not known, the size of the previous fragment of the same type is used
+*/
+TEST_F(AcquireReleaseTests, SizeHintFromPreviousFragment)
+{
+	GrowableBuffer buffer;
+	memset(&buffer, 0x00, sizeof(buffer));
+
+	mPool->Acquire(&buffer, 0, eMEDIATYPE_AUDIO);
+	EXPECT_EQ(buffer.avail, 64*1024);
+	buffer.len = 300*1024;
+	mPool->Release(&buffer, eMEDIATYPE_AUDIO);
+
+	mPool->Acquire(&buffer, 0, eMEDIATYPE_AUDIO);
+	EXPECT_EQ(buffer.avail, 512*1024);
+	mPool->Release(&buffer, eMEDIATYPE_AUDIO);
+}
+
+/*
+    Blocks which would take the pool over its byte budget are freed instead of pooled
+*/
+TEST_F(AcquireReleaseTests, BudgetIsEnforced)
+{
+	GrowableBuffer first, second;
+	memset(&first, 0x00, sizeof(first));
+	memset(&second, 0x00, sizeof(second));
+
+	mPool->Acquire(&first, 6*1024*1024, eMEDIATYPE_VIDEO);
+	mPool->Acquire(&second, 6*1024*1024, eMEDIATYPE_VIDEO);
+	mPool->Release(&first, eMEDIATYPE_VIDEO);
+	mPool->Release(&second, eMEDIATYPE_VIDEO);
+
+	AampBufferPoolStats stats = mPool->GetStats();
+	EXPECT_EQ(stats.releases, 1);
+	EXPECT_EQ(stats.discards, 1);
+	EXPECT_EQ(stats.pooledBytes, 8*1024*1024);
+
+	mPool->SetMaxPoolSize(0);
+	EXPECT_EQ(mPool->GetStats().pooledBytes, 0);
+}
+
+/*
+    Memory not allocated by the pool (plain g_malloc) is accepted on release
+*/
+TEST_F(AcquireReleaseTests, ReleaseForeignBuffer)
+{
+	GrowableBuffer buffer;
+	buffer.avail = 200*1024;
+	buffer.len = 10;
+	buffer.ptr = (char *)g_malloc(buffer.avail);
+
+	mPool->Release(&buffer, eMEDIATYPE_SUBTITLE);
+	EXPECT_EQ(buffer.ptr, nullptr);
+	EXPECT_EQ(mPool->GetStats().pooledBytes, 200*1024);
+
+	mPool->Flush();
+	EXPECT_EQ(mPool->GetStats().pooledBytes, 0);
+}
@@ -0,0 +1,209 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <algorithm>
+#include "AampDiskCache.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+#define TEST_STORE_SIZE (256*1024)
+
+class DiskCacheTests : public ::testing::Test
+{
+protected:
+	std::string mPath;
+
+	void SetUp() override
+	{
+		mPath = "/tmp/aamp_disk_cache_test_" + std::to_string(getpid()) + ".bin";
+		unlink(mPath.c_str());
+	}
+
+	void TearDown() override
+	{
+		unlink(mPath.c_str());
+	}
+
+	bool Get(AampDiskCache &cache, const std::string &url, std::string &content, int64_t now = 0, int64_t maxAge = 0)
+	{
+		std::vector<char> data;
+		std::string effectiveUrl;
+		int type = -1;
+		bool found = cache.Retrieve(url, data, effectiveUrl, type, NULL, now, maxAge);
+		content.assign(data.begin(), data.end());
+		return found;
+	}
+};
+
+/*
+    Entries survive close and reopen of the store
+*/
+TEST_F(DiskCacheTests, PersistsEntries)
+{
+	{
+		AampDiskCache cache;
+		ASSERT_TRUE(cache.Open(mPath, TEST_STORE_SIZE));
+		EXPECT_TRUE(cache.Insert("http://host/v.init", "\"v1\"", "http://cdn/v.init", 3, "video", 5, 100));
+		EXPECT_TRUE(cache.Insert("http://host/a.init", "", "", 4, "audio", 5, 100));
+		EXPECT_EQ(cache.GetEntryCount(), 2);
+	}
+
+	AampDiskCache cache;
+	ASSERT_TRUE(cache.Open(mPath, TEST_STORE_SIZE));
+	EXPECT_EQ(cache.GetEntryCount(), 2);
+	std::vector<char> data;
+	std::string effectiveUrl;
+	std::string validator;
+	int type = -1;
+	ASSERT_TRUE(cache.Retrieve("http://host/v.init", data, effectiveUrl, type, &validator, 200, 0));
+	EXPECT_EQ(std::string(data.begin(), data.end()), "video");
+	EXPECT_EQ(effectiveUrl, "http://cdn/v.init");
+	EXPECT_EQ(validator, "\"v1\"");
+	EXPECT_EQ(type, 3);
+	EXPECT_FALSE(cache.Retrieve("http://host/missing", data, effectiveUrl, type, NULL, 200, 0));
+
+	EXPECT_TRUE(cache.Remove("http://host/a.init"));
+	EXPECT_EQ(cache.GetEntryCount(), 1);
+
+	// other capacity starts an empty store
+	cache.Close();
+	ASSERT_TRUE(cache.Open(mPath, 2 * TEST_STORE_SIZE));
+	EXPECT_EQ(cache.GetEntryCount(), 0);
+}
+
+/*
+    Same validator keeps stored copy, a new version replaces it
+*/
+TEST_F(DiskCacheTests, ReplacesOnNewValidator)
+{
+	AampDiskCache cache;
+	ASSERT_TRUE(cache.Open(mPath, TEST_STORE_SIZE));
+	std::string content;
+	ASSERT_TRUE(cache.Insert("http://host/v.init", "etag1", "", 0, "first", 5, 100));
+	ASSERT_TRUE(cache.Insert("http://host/v.init", "etag1", "", 0, "other", 5, 150));
+	ASSERT_TRUE(Get(cache, "http://host/v.init", content));
+	EXPECT_EQ(content, "first");
+
+	ASSERT_TRUE(cache.Insert("http://host/v.init", "etag2", "", 0, "second!", 7, 200));
+	ASSERT_TRUE(Get(cache, "http://host/v.init", content));
+	EXPECT_EQ(content, "second!");
+	EXPECT_EQ(cache.GetEntryCount(), 1);
+	EXPECT_EQ(cache.GetUsedBytes(), 32);
+
+	// same validator refreshes age
+	EXPECT_TRUE(Get(cache, "http://host/v.init", content, 250, 60));
+	ASSERT_TRUE(cache.Insert("http://host/v.init", "etag2", "", 0, "second!", 7, 300));
+	EXPECT_TRUE(Get(cache, "http://host/v.init", content, 350, 60));
+	EXPECT_FALSE(Get(cache, "http://host/v.init", content, 400, 60));
+	EXPECT_EQ(cache.GetEntryCount(), 0);
+}
+
+/*
+    Least recently used entries are evicted to make room, freed space is reused
+*/
+TEST_F(DiskCacheTests, EvictsLeastRecentlyUsed)
+{
+	AampDiskCache cache;
+	ASSERT_TRUE(cache.Open(mPath, TEST_STORE_SIZE));
+	std::vector<char> payload(60 * 1024, 'x');
+	std::string content;
+	for (int i = 0; i < 3; i++)
+	{
+		ASSERT_TRUE(cache.Insert("url" + std::to_string(i), "", "", 0, payload.data(), payload.size(), 0));
+	}
+	ASSERT_TRUE(Get(cache, "url0", content));
+
+	ASSERT_TRUE(cache.Insert("url3", "", "", 0, payload.data(), payload.size(), 0));
+	EXPECT_EQ(cache.GetEntryCount(), 3);
+	EXPECT_TRUE(Get(cache, "url0", content));
+	EXPECT_FALSE(Get(cache, "url1", content));
+	EXPECT_TRUE(Get(cache, "url2", content));
+	EXPECT_TRUE(Get(cache, "url3", content));
+
+	// larger than store
+	std::vector<char> huge(TEST_STORE_SIZE, 'y');
+	EXPECT_FALSE(cache.Insert("huge", "", "", 0, huge.data(), huge.size(), 0));
+	EXPECT_EQ(cache.GetEntryCount(), 3);
+
+	// many small entries recycle entry table slots
+	for (int i = 0; i < 2 * AAMP_DISK_CACHE_SLOTS; i++)
+	{
+		ASSERT_TRUE(cache.Insert("small" + std::to_string(i), "", "", 0, "s", 1, 0));
+	}
+	EXPECT_EQ(cache.GetEntryCount(), AAMP_DISK_CACHE_SLOTS);
+	EXPECT_TRUE(Get(cache, "small" + std::to_string(2 * AAMP_DISK_CACHE_SLOTS - 1), content));
+	EXPECT_FALSE(Get(cache, "url3", content));
+}
+
+/*
+    Corrupted record is dropped instead of served
+*/
+TEST_F(DiskCacheTests, DropsCorruptEntry)
+{
+	const char payload[] = "init-segment-payload";
+	{
+		AampDiskCache cache;
+		ASSERT_TRUE(cache.Open(mPath, TEST_STORE_SIZE));
+		ASSERT_TRUE(cache.Insert("http://host/v.init", "", "", 0, payload, sizeof(payload), 0));
+	}
+	FILE *file = fopen(mPath.c_str(), "r+b");
+	ASSERT_TRUE(file != NULL);
+	std::vector<char> bytes(TEST_STORE_SIZE);
+	ASSERT_EQ(fread(bytes.data(), 1, bytes.size(), file), bytes.size());
+	auto pos = std::search(bytes.begin(), bytes.end(), payload, payload + sizeof(payload) - 1);
+	ASSERT_TRUE(pos != bytes.end());
+	fseek(file, pos - bytes.begin(), SEEK_SET);
+	fputc('X', file);
+	fclose(file);
+
+	AampDiskCache cache;
+	ASSERT_TRUE(cache.Open(mPath, TEST_STORE_SIZE));
+	EXPECT_EQ(cache.GetEntryCount(), 1);
+	std::string content;
+	EXPECT_FALSE(Get(cache, "http://host/v.init", content));
+	EXPECT_EQ(cache.GetEntryCount(), 0);
+}
+
+/*
+    Player instances share one store, the file is locked against other users
+*/
+TEST_F(DiskCacheTests, SharesStoreOfPath)
+{
+	std::shared_ptr<AampDiskCache> first = AampDiskCache::Acquire(mPath, TEST_STORE_SIZE);
+	ASSERT_TRUE(first != NULL);
+	std::shared_ptr<AampDiskCache> second = AampDiskCache::Acquire(mPath, TEST_STORE_SIZE);
+	EXPECT_EQ(first, second);
+
+	AampDiskCache other;
+	EXPECT_FALSE(other.Open(mPath, TEST_STORE_SIZE));
+	EXPECT_FALSE(other.Insert("url", "", "", 0, "x", 1, 0));
+
+	first.reset();
+	second.reset();
+	EXPECT_TRUE(other.Open(mPath, TEST_STORE_SIZE));
+	EXPECT_FALSE(AampDiskCache::Acquire(mPath, TEST_STORE_SIZE));
+	EXPECT_FALSE(AampDiskCache::Acquire("", TEST_STORE_SIZE));
+}
@@ -0,0 +1,230 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <glib.h>
+#include <set>
+#include <vector>
+#include "AampEventManager.h"
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+/**
+ * @brief Records events and the main loop source dispatching them
+ */
+class RecordingListener : public EventListener
+{
+public:
+	std::vector<AAMPEventPtr> mEvents;
+	std::vector<guint> mSources;
+	std::vector<gint64> mTimesUs;
+
+	RecordingListener() : mEvents(), mSources(), mTimesUs()
+	{
+	}
+
+	void SendEvent(const AAMPEventPtr &event) override
+	{
+		mEvents.push_back(event);
+		mSources.push_back(g_source_get_id(g_main_current_source()));
+		mTimesUs.push_back(g_get_monotonic_time());
+	}
+};
+
+class EventManagerTests : public ::testing::Test
+{
+protected:
+	AampEventManager *mEventManager;
+	RecordingListener mListener;
+
+	EventManagerTests() : mEventManager(NULL), mListener()
+	{
+	}
+
+	void SetUp() override
+	{
+		mEventManager = new AampEventManager(NULL);
+		mEventManager->AddListenerForAllEvents(&mListener);
+	}
+
+	void TearDown() override
+	{
+		mEventManager->RemoveListenerForAllEvents(&mListener);
+		delete mEventManager;
+		mEventManager = NULL;
+	}
+
+	AAMPEventPtr Send(AAMPEventType eventType)
+	{
+		AAMPEventPtr event = std::make_shared<AAMPEventObject>(eventType);
+		mEventManager->SendEvent(event, AAMP_EVENT_ASYNC_MODE);
+		return event;
+	}
+
+	static void RunPending()
+	{
+		while (g_main_context_iteration(NULL, FALSE))
+		{
+		}
+	}
+
+	void RunUntil(size_t eventCount, int timeoutMs)
+	{
+		gint64 endUs = g_get_monotonic_time() + timeoutMs * 1000LL;
+		while (mListener.mEvents.size() < eventCount && g_get_monotonic_time() < endUs)
+		{
+			g_main_context_iteration(NULL, FALSE);
+			g_usleep(1000);
+		}
+	}
+};
+
+/*
+    Without batch dispatch each async event has its own idle task
+*/
+TEST_F(EventManagerTests, DispatchesEachEventInOwnTask)
+{
+	Send(AAMP_EVENT_BITRATE_CHANGED);
+	Send(AAMP_EVENT_TIMED_METADATA);
+	Send(AAMP_EVENT_PROGRESS);
+	Send(AAMP_EVENT_PROGRESS);
+	RunPending();
+	ASSERT_EQ(mListener.mEvents.size(), 4u);
+	EXPECT_EQ(std::set<guint>(mListener.mSources.begin(), mListener.mSources.end()).size(), 4u);
+
+	AampEventDispatchStats stats;
+	mEventManager->GetDispatchStats(AAMP_EVENT_PROGRESS, stats);
+	EXPECT_EQ(stats.dispatched, 2u);
+	EXPECT_EQ(stats.merged, 0u);
+	EXPECT_GE(stats.totalLatencyUs, stats.maxLatencyUs);
+}
+
+/*
+    Batch dispatch sends all queued events in order from one idle task
+*/
+TEST_F(EventManagerTests, BatchDispatchesInOneTask)
+{
+	mEventManager->SetBatchDispatch(true);
+	std::vector<AAMPEventPtr> sent;
+	sent.push_back(Send(AAMP_EVENT_BITRATE_CHANGED));
+	sent.push_back(Send(AAMP_EVENT_TIMED_METADATA));
+	sent.push_back(Send(AAMP_EVENT_ID3_METADATA));
+	sent.push_back(Send(AAMP_EVENT_TIMED_METADATA));
+	RunPending();
+	EXPECT_EQ(mListener.mEvents, sent);
+	ASSERT_EQ(mListener.mSources.size(), sent.size());
+	EXPECT_EQ(std::set<guint>(mListener.mSources.begin(), mListener.mSources.end()).size(), 1u);
+
+	AampEventDispatchStats stats;
+	mEventManager->GetDispatchStats(AAMP_EVENT_TIMED_METADATA, stats);
+	EXPECT_EQ(stats.dispatched, 2u);
+	EXPECT_EQ(stats.merged, 0u);
+}
+
+/*
+    A queued coalescable event is dropped when a later one of its type is queued
+*/
+TEST_F(EventManagerTests, MergesSupersededEvents)
+{
+	mEventManager->SetBatchDispatch(true);
+	Send(AAMP_EVENT_PROGRESS);
+	AAMPEventPtr metadata = Send(AAMP_EVENT_TIMED_METADATA);
+	Send(AAMP_EVENT_PROGRESS);
+	AAMPEventPtr tracks = Send(AAMP_EVENT_AUDIO_TRACKS_CHANGED);
+	AAMPEventPtr progress = Send(AAMP_EVENT_PROGRESS);
+	RunPending();
+	ASSERT_EQ(mListener.mEvents.size(), 3u);
+	EXPECT_EQ(mListener.mEvents[0], metadata);
+	EXPECT_EQ(mListener.mEvents[1], tracks);
+	EXPECT_EQ(mListener.mEvents[2], progress);
+
+	AampEventDispatchStats stats;
+	mEventManager->GetDispatchStats(AAMP_EVENT_PROGRESS, stats);
+	EXPECT_EQ(stats.dispatched, 1u);
+	EXPECT_EQ(stats.merged, 2u);
+
+	// after dispatch a new event of the type is sent again
+	AAMPEventPtr next = Send(AAMP_EVENT_PROGRESS);
+	RunPending();
+	ASSERT_EQ(mListener.mEvents.size(), 4u);
+	EXPECT_EQ(mListener.mEvents[3], next);
+}
+
+/*
+    Rate limited events are held until the interval passed, the latest held one is sent
+*/
+TEST_F(EventManagerTests, HoldsRateLimitedEvents)
+{
+	const int intervalMs = 100;
+	mEventManager->SetBatchDispatch(true);
+	EXPECT_FALSE(mEventManager->SetEventRateLimit(AAMP_EVENT_TIMED_METADATA, intervalMs));
+	EXPECT_TRUE(mEventManager->SetEventRateLimit(AAMP_EVENT_PROGRESS, intervalMs));
+	Send(AAMP_EVENT_PROGRESS);
+	RunPending();
+	ASSERT_EQ(mListener.mEvents.size(), 1u);
+
+	Send(AAMP_EVENT_PROGRESS);
+	RunPending();
+	AAMPEventPtr metadata = Send(AAMP_EVENT_TIMED_METADATA);
+	AAMPEventPtr progress = Send(AAMP_EVENT_PROGRESS);
+	RunPending();
+	// other types are not held
+	ASSERT_EQ(mListener.mEvents.size(), 2u);
+	EXPECT_EQ(mListener.mEvents[1], metadata);
+
+	RunUntil(3, 5000);
+	ASSERT_EQ(mListener.mEvents.size(), 3u);
+	EXPECT_EQ(mListener.mEvents[2], progress);
+	EXPECT_GE(mListener.mTimesUs[2] - mListener.mTimesUs[0], intervalMs * 1000LL);
+
+	AampEventDispatchStats stats;
+	mEventManager->GetDispatchStats(AAMP_EVENT_PROGRESS, stats);
+	EXPECT_EQ(stats.dispatched, 2u);
+	EXPECT_EQ(stats.merged, 1u);
+	EXPECT_GE(stats.maxLatencyUs, (intervalMs / 2) * 1000LL);
+}
+
+/*
+    Flushing drops queued and held events, later events are dispatched again
+*/
+TEST_F(EventManagerTests, FlushDropsPendingEvents)
+{
+	mEventManager->SetBatchDispatch(true);
+	mEventManager->SetEventRateLimit(AAMP_EVENT_ALL_EVENTS, 1000);
+	Send(AAMP_EVENT_PROGRESS);
+	RunPending();
+	Send(AAMP_EVENT_PROGRESS);
+	RunPending();
+	Send(AAMP_EVENT_BITRATE_CHANGED);
+	mEventManager->FlushPendingEvents();
+	RunPending();
+	ASSERT_EQ(mListener.mEvents.size(), 1u);
+
+	AampEventDispatchStats stats;
+	mEventManager->GetDispatchStats(AAMP_EVENT_PROGRESS, stats);
+	EXPECT_EQ(stats.dispatched, 0u);
+
+	AAMPEventPtr bitrate = Send(AAMP_EVENT_BITRATE_CHANGED);
+	AAMPEventPtr progress = Send(AAMP_EVENT_PROGRESS);
+	RunPending();
+	ASSERT_EQ(mListener.mEvents.size(), 3u);
+	EXPECT_EQ(mListener.mEvents[1], bitrate);
+	EXPECT_EQ(mListener.mEvents[2], progress);
+}
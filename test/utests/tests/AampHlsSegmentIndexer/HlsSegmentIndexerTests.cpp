@@ -0,0 +1,284 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "AampHlsSegmentIndexer.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+/**
+ * @brief Index tables as held by a track
+ */
+struct SegmentIndex
+{
+	GrowableBuffer index;
+	int indexCount;
+	GrowableBuffer discontinuityIndex;
+	int discontinuityIndexCount;
+
+	SegmentIndex() : indexCount(0), discontinuityIndexCount(0)
+	{
+		memset(&index, 0, sizeof(index));
+		memset(&discontinuityIndex, 0, sizeof(discontinuityIndex));
+	}
+
+	~SegmentIndex()
+	{
+		aamp_Free(&index);
+		aamp_Free(&discontinuityIndex);
+	}
+
+	const IndexNode &Node(int idx) const { return ((const IndexNode *)index.ptr)[idx]; }
+	const DiscontinuityIndexNode &Discontinuity(int idx) const { return ((const DiscontinuityIndexNode *)discontinuityIndex.ptr)[idx]; }
+};
+
+class HlsSegmentIndexerTests : public ::testing::Test
+{
+protected:
+	AampHlsTagLexer mLexer;
+	std::string mPlaylist;
+	std::string mRefreshed;
+	std::vector<HlsPlaylistLine> mLines;
+	std::vector<HlsPlaylistLine> mRefreshedLines;
+	double mProgramDateTime;
+
+	HlsSegmentIndexerTests() : mLexer(), mPlaylist(), mRefreshed(), mLines(), mRefreshedLines(), mProgramDateTime(0)
+	{
+	}
+
+	/**
+	 * @brief Full index of a playlist, as on first download
+	 */
+	double IndexFull(std::string &playlist, std::vector<HlsPlaylistLine> &lines, SegmentIndex &index, double *programDateTime = NULL)
+	{
+		mLexer.Tokenize(playlist.c_str(), playlist.size(), lines);
+		AampHlsSegmentIndexer indexer(index.index, index.indexCount, index.discontinuityIndex, index.discontinuityIndexCount);
+		indexer.Append(&playlist[0], lines, 1);
+		if (programDateTime)
+		{
+			*programDateTime = indexer.GetProgramDateTime();
+		}
+		return indexer.GetTotalDuration();
+	}
+
+	/**
+	 * @brief Index mPlaylist, update with mRefreshed, and check result matches a full index of mRefreshed
+	 */
+	void ExpectIncrementalMatchesFull(int culledCount)
+	{
+		SegmentIndex incremental;
+		IndexFull(mPlaylist, mLines, incremental);
+		int prevCount = incremental.indexCount;
+
+		mLexer.Tokenize(mRefreshed.c_str(), mRefreshed.size(), mRefreshedLines);
+		AampHlsSegmentIndexer indexer(incremental.index, incremental.indexCount, incremental.discontinuityIndex, incremental.discontinuityIndexCount);
+		ASSERT_TRUE(indexer.Update(&mRefreshed[0], mRefreshedLines, culledCount));
+		EXPECT_GT(incremental.indexCount, prevCount - culledCount);
+
+		SegmentIndex full;
+		std::vector<HlsPlaylistLine> fullLines;
+		double fullProgramDateTime = 0;
+		double fullDuration = IndexFull(mRefreshed, fullLines, full, &fullProgramDateTime);
+
+		EXPECT_NEAR(indexer.GetTotalDuration(), fullDuration, 1e-9);
+		EXPECT_DOUBLE_EQ(indexer.GetProgramDateTime(), fullProgramDateTime);
+		mProgramDateTime = indexer.GetProgramDateTime();
+		ASSERT_EQ(incremental.indexCount, full.indexCount);
+		for (int i = 0; i < full.indexCount; i++)
+		{
+			EXPECT_NEAR(incremental.Node(i).completionTimeSecondsFromStart, full.Node(i).completionTimeSecondsFromStart, 1e-9) << i;
+			EXPECT_EQ(incremental.Node(i).pFragmentInfo, full.Node(i).pFragmentInfo) << i;
+			EXPECT_EQ(incremental.Node(i).initFragmentPtr, full.Node(i).initFragmentPtr) << i;
+			EXPECT_EQ(incremental.Node(i).drmMetadataIdx, full.Node(i).drmMetadataIdx) << i;
+		}
+		ASSERT_EQ(incremental.discontinuityIndexCount, full.discontinuityIndexCount);
+		for (int i = 0; i < full.discontinuityIndexCount; i++)
+		{
+			EXPECT_EQ(incremental.Discontinuity(i).fragmentIdx, full.Discontinuity(i).fragmentIdx) << i;
+			EXPECT_NEAR(incremental.Discontinuity(i).position, full.Discontinuity(i).position, 1e-9) << i;
+			EXPECT_DOUBLE_EQ(incremental.Discontinuity(i).fragmentDuration, full.Discontinuity(i).fragmentDuration) << i;
+			EXPECT_DOUBLE_EQ(incremental.Discontinuity(i).discontinuityPDT, full.Discontinuity(i).discontinuityPDT) << i;
+		}
+	}
+};
+
+/*
+    Culled head is dropped, retained segments point into refreshed playlist and
+    new segments, discontinuities and PDT match a full index
+*/
+TEST_F(HlsSegmentIndexerTests, MatchesFullIndexAfterRefresh)
+{
+	mPlaylist =
+		"#EXTM3U\n"
+		"#EXT-X-MEDIA-SEQUENCE:10\n"
+		"#EXT-X-MAP:URI=\"init1.mp4\"\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:00.000Z\n"
+		"#EXTINF:2.002,\nseg10.m4s\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:02.002Z\n"
+		"#EXTINF:2.002,\nseg11.m4s\n"
+		"#EXT-X-DISCONTINUITY\n"
+		"#EXT-X-MAP:URI=\"init2.mp4\"\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:30.000Z\n"
+		"#EXTINF:1.5,\nseg12.m4s\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:31.500Z\n"
+		"#EXTINF:2.002,\nseg13.m4s\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:33.502Z\n"
+		"#EXTINF:2.002,\nseg14.m4s\n";
+	mRefreshed =
+		"#EXTM3U\n"
+		"#EXT-X-MEDIA-SEQUENCE:11\n"
+		"#EXT-X-MAP:URI=\"init1.mp4\"\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:02.002Z\n"
+		"#EXTINF:2.002,\nseg11.m4s\n"
+		"#EXT-X-DISCONTINUITY\n"
+		"#EXT-X-MAP:URI=\"init2.mp4\"\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:30.000Z\n"
+		"#EXTINF:1.5,\nseg12.m4s\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:31.500Z\n"
+		"#EXTINF:2.002,\nseg13.m4s\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:33.502Z\n"
+		"#EXTINF:2.002,\nseg14.m4s\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:35.504Z\n"
+		"#EXTINF:2.002,\nseg15.m4s\n"
+		"#EXT-X-DISCONTINUITY\n"
+		"#EXT-X-MAP:URI=\"init3.mp4\"\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:01:00.000Z\n"
+		"#EXTINF:4.0,\nseg16.m4s\n";
+	ExpectIncrementalMatchesFull(1);
+	// 2022-03-01T10:00:02.002Z
+	EXPECT_NEAR(mProgramDateTime, 1646128802.002, 1e-6);
+}
+
+/*
+    PDT first found after culled segments or only in new segments is extrapolated to first segment
+*/
+TEST_F(HlsSegmentIndexerTests, ExtrapolatesProgramDateTime)
+{
+	mPlaylist =
+		"#EXTM3U\n"
+		"#EXT-X-MEDIA-SEQUENCE:100\n"
+		"#EXTINF:6.0,\nseg100.ts\n"
+		"#EXTINF:6.0,\nseg101.ts\n"
+		"#EXTINF:6.0,\nseg102.ts\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:18.000Z\n"
+		"#EXTINF:6.0,\nseg103.ts\n";
+	mRefreshed =
+		"#EXTM3U\n"
+		"#EXT-X-MEDIA-SEQUENCE:102\n"
+		"#EXTINF:6.0,\nseg102.ts\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:18.000Z\n"
+		"#EXTINF:6.0,\nseg103.ts\n"
+		"#EXTINF:6.0,\nseg104.ts\n";
+	ExpectIncrementalMatchesFull(2);
+	// 2022-03-01T10:00:12Z
+	EXPECT_DOUBLE_EQ(mProgramDateTime, 1646128812.0);
+
+	// no PDT in retained segments
+	mPlaylist =
+		"#EXTM3U\n"
+		"#EXT-X-MEDIA-SEQUENCE:100\n"
+		"#EXTINF:6.0,\nseg100.ts\n"
+		"#EXTINF:6.0,\nseg101.ts\n";
+	mRefreshed =
+		"#EXTM3U\n"
+		"#EXT-X-MEDIA-SEQUENCE:100\n"
+		"#EXTINF:6.0,\nseg100.ts\n"
+		"#EXTINF:6.0,\nseg101.ts\n"
+		"#EXT-X-DISCONTINUITY\n"
+		"#EXT-X-PROGRAM-DATE-TIME:2022-03-01T10:00:12.000Z\n"
+		"#EXTINF:6.0,\nseg102.ts\n";
+	ExpectIncrementalMatchesFull(0);
+	// 2022-03-01T10:00:00Z
+	EXPECT_DOUBLE_EQ(mProgramDateTime, 1646128800.0);
+}
+
+/*
+    Discontinuities of culled segments are dropped, later ones move to the new first segment
+*/
+TEST_F(HlsSegmentIndexerTests, CullsDiscontinuities)
+{
+	mPlaylist =
+		"#EXTM3U\n"
+		"#EXT-X-MEDIA-SEQUENCE:1\n"
+		"#EXTINF:4.0,\nseg1.ts\n"
+		"#EXT-X-DISCONTINUITY\n"
+		"#EXTINF:4.0,\nseg2.ts\n"
+		"#EXTINF:4.0,\nseg3.ts\n"
+		"#EXT-X-DISCONTINUITY\n"
+		"#EXTINF:4.0,\nseg4.ts\n";
+	mRefreshed =
+		"#EXTM3U\n"
+		"#EXT-X-MEDIA-SEQUENCE:3\n"
+		"#EXT-X-DISCONTINUITY-SEQUENCE:1\n"
+		"#EXTINF:4.0,\nseg3.ts\n"
+		"#EXT-X-DISCONTINUITY\n"
+		"#EXTINF:4.0,\nseg4.ts\n"
+		"#EXTINF:4.0,\nseg5.ts\n";
+	ExpectIncrementalMatchesFull(2);
+}
+
+/*
+    Tables are left untouched when retained segments are missing or changed
+*/
+TEST_F(HlsSegmentIndexerTests, RejectsInconsistentRefresh)
+{
+	mPlaylist =
+		"#EXTM3U\n"
+		"#EXT-X-MEDIA-SEQUENCE:1\n"
+		"#EXTINF:4.0,\nseg1.ts\n"
+		"#EXTINF:4.0,\nseg2.ts\n"
+		"#EXTINF:4.0,\nseg3.ts\n";
+	SegmentIndex index;
+	IndexFull(mPlaylist, mLines, index);
+	ASSERT_EQ(index.indexCount, 3);
+	const char *firstSegment = index.Node(0).pFragmentInfo;
+
+	const char *refreshed[] =
+	{
+		// lost segment at tail
+		"#EXTM3U\n#EXT-X-MEDIA-SEQUENCE:2\n#EXTINF:4.0,\nseg2.ts\n",
+		// last retained segment changed
+		"#EXTM3U\n#EXT-X-MEDIA-SEQUENCE:2\n#EXTINF:4.0,\nseg2.ts\n#EXTINF:2.0,\nseg3.ts\n#EXTINF:4.0,\nseg4.ts\n",
+		// first retained segment changed
+		"#EXTM3U\n#EXT-X-MEDIA-SEQUENCE:2\n#EXTINF:6.0,\nseg2.ts\n#EXTINF:4.0,\nseg3.ts\n#EXTINF:4.0,\nseg4.ts\n",
+	};
+	for (size_t i = 0; i < sizeof(refreshed) / sizeof(refreshed[0]); i++)
+	{
+		mRefreshed = refreshed[i];
+		mLexer.Tokenize(mRefreshed.c_str(), mRefreshed.size(), mRefreshedLines);
+		AampHlsSegmentIndexer indexer(index.index, index.indexCount, index.discontinuityIndex, index.discontinuityIndexCount);
+		EXPECT_FALSE(indexer.Update(&mRefreshed[0], mRefreshedLines, 1)) << i;
+		EXPECT_EQ(index.indexCount, 3);
+		EXPECT_EQ(index.Node(0).pFragmentInfo, firstSegment);
+		EXPECT_DOUBLE_EQ(index.Node(2).completionTimeSecondsFromStart, 12.0);
+	}
+
+	// no overlap with indexed segments
+	AampHlsSegmentIndexer indexer(index.index, index.indexCount, index.discontinuityIndex, index.discontinuityIndexCount);
+	EXPECT_FALSE(indexer.Update(&mRefreshed[0], mRefreshedLines, 3));
+	EXPECT_FALSE(indexer.Update(&mRefreshed[0], mRefreshedLines, -1));
+	EXPECT_EQ(index.indexCount, 3);
+}
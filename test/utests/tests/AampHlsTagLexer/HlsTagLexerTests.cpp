@@ -0,0 +1,226 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "AampHlsTagLexer.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+class HlsTagLexerTests : public ::testing::Test
+{
+protected:
+	AampHlsTagLexer mLexer;
+	std::vector<HlsPlaylistLine> mLines;
+
+	HlsTagLexerTests() : mLexer(), mLines()
+	{
+	}
+
+	void Tokenize(const std::string &playlist)
+	{
+		mLexer.Tokenize(playlist.c_str(), playlist.size(), mLines);
+	}
+
+	static std::string GetLine(const std::string &playlist, const HlsPlaylistLine &line)
+	{
+		return playlist.substr(line.offset, line.length);
+	}
+
+	static std::string GetValue(const std::string &playlist, const HlsPlaylistLine &line)
+	{
+		return playlist.substr(line.offset + line.valueOffset, line.length - line.valueOffset);
+	}
+};
+
+/*
+    Lines end at LF or CR LF, the last line may have no terminator
+*/
+TEST_F(HlsTagLexerTests, SplitsLines)
+{
+	const std::string playlist = "#EXTM3U\r\n#EXT-X-VERSION:3\n\n#EXTINF:2.0,\r\r\nseg1.ts";
+	Tokenize(playlist);
+	ASSERT_EQ(mLines.size(), 5u);
+	EXPECT_EQ(GetLine(playlist, mLines[0]), "#EXTM3U");
+	EXPECT_EQ(GetLine(playlist, mLines[1]), "#EXT-X-VERSION:3");
+	EXPECT_EQ(GetLine(playlist, mLines[2]), "");
+	EXPECT_EQ(GetLine(playlist, mLines[3]), "#EXTINF:2.0,");
+	EXPECT_EQ(GetLine(playlist, mLines[4]), "seg1.ts");
+	EXPECT_EQ(mLines[2].tag, eHLS_TAG_NONE);
+	EXPECT_EQ(mLines[4].tag, eHLS_TAG_NONE);
+}
+
+/*
+    The playlist ends at the first NUL, as downloaded playlists have NUL bytes appended
+*/
+TEST_F(HlsTagLexerTests, StopsAtNul)
+{
+	const std::string playlist("#EXTM3U\nseg1.ts\n\0\0", 18);
+	Tokenize(playlist);
+	ASSERT_EQ(mLines.size(), 2u);
+	EXPECT_EQ(GetLine(playlist, mLines[1]), "seg1.ts");
+
+	mLexer.Tokenize(NULL, 0, mLines);
+	EXPECT_TRUE(mLines.empty());
+}
+
+/*
+    Known tags match the full name and the value starts after the ':'
+*/
+TEST_F(HlsTagLexerTests, ClassifiesKnownTags)
+{
+	const std::string playlist =
+		"#EXTM3U\n"
+		"#EXT-X-MEDIA-SEQUENCE:10\n"
+		"#EXT-X-MEDIA:TYPE=AUDIO\n"
+		"#EXT-X-DISCONTINUITY\n"
+		"#EXT-X-DISCONTINUITY-SEQUENCE:2\n"
+		"#EXT-X-CUE-OUT-CONT:ElapsedTime=5\n"
+		"#EXT-X-CUE-OUT:30\n"
+		"#EXT-X-INDEPENDENT-SEGMENTS \n"
+		"#EXT-X-MEDIAX:1\n"
+		"#EXT-NOT-A-TAG\n"
+		"# comment\n";
+	Tokenize(playlist);
+	ASSERT_EQ(mLines.size(), 11u);
+	const HlsTag expected[] = {eHLS_TAG_EXTM3U, eHLS_TAG_MEDIA_SEQUENCE, eHLS_TAG_MEDIA, eHLS_TAG_DISCONTINUITY,
+		eHLS_TAG_DISCONTINUITY_SEQUENCE, eHLS_TAG_CUE_OUT_CONT, eHLS_TAG_CUE_OUT, eHLS_TAG_INDEPENDENT_SEGMENTS,
+		eHLS_TAG_UNKNOWN, eHLS_TAG_UNKNOWN, eHLS_TAG_NONE};
+	for (size_t i = 0; i < mLines.size(); i++)
+	{
+		EXPECT_EQ(mLines[i].tag, expected[i]) << GetLine(playlist, mLines[i]);
+		EXPECT_EQ(mLines[i].subscribedTag, HLS_NO_SUBSCRIBED_TAG);
+	}
+	EXPECT_EQ(GetValue(playlist, mLines[0]), "");
+	EXPECT_EQ(GetValue(playlist, mLines[1]), "10");
+	EXPECT_EQ(GetValue(playlist, mLines[2]), "TYPE=AUDIO");
+	EXPECT_EQ(GetValue(playlist, mLines[4]), "2");
+	EXPECT_EQ(GetValue(playlist, mLines[5]), "ElapsedTime=5");
+	EXPECT_EQ(GetValue(playlist, mLines[6]), "30");
+	EXPECT_EQ(GetValue(playlist, mLines[8]), "-X-MEDIAX:1");
+}
+
+/*
+    Every known tag name is classified as its tag
+*/
+TEST_F(HlsTagLexerTests, MatchesTagNameTable)
+{
+	for (int tag = eHLS_TAG_EXTM3U; tag < eHLS_TAG_COUNT; tag++)
+	{
+		std::string playlist = std::string(AampHlsTagLexer::GetTagName((HlsTag)tag)) + ":1";
+		Tokenize(playlist);
+		ASSERT_EQ(mLines.size(), 1u);
+		EXPECT_EQ(mLines[0].tag, tag) << playlist;
+		EXPECT_EQ(GetValue(playlist, mLines[0]), "1");
+	}
+	EXPECT_EQ(AampHlsTagLexer::GetTagName(eHLS_TAG_NONE), (const char *)NULL);
+	EXPECT_EQ(AampHlsTagLexer::GetTagName(eHLS_TAG_UNKNOWN), (const char *)NULL);
+}
+
+/*
+    Subscribed tags match as prefix, the first subscribed tag matching wins
+*/
+TEST_F(HlsTagLexerTests, MatchesSubscribedTags)
+{
+	std::vector<std::string> tags;
+	tags.push_back("#EXT-X-CUE");
+	tags.push_back("#EXT-X-CUE-OUT");
+	tags.push_back("#EXT-X-CUSTOM");
+	tags.push_back("#EX");
+	tags.push_back("#EXT-X-CUE");
+	EXPECT_TRUE(mLexer.SetSubscribedTags(tags));
+
+	const std::string playlist =
+		"#EXT-X-CUE-OUT:30\n"
+		"#EXT-X-CUSTOM-DATA:abc\n"
+		"#EXT-X-CUSTOM\n"
+		"#EXT-X-CU\n"
+		"#EXTINF:2.0,\n";
+	Tokenize(playlist);
+	ASSERT_EQ(mLines.size(), 5u);
+	EXPECT_EQ(mLines[0].tag, eHLS_TAG_CUE_OUT);
+	EXPECT_EQ(mLines[0].subscribedTag, 0);
+	EXPECT_EQ(mLines[1].tag, eHLS_TAG_UNKNOWN);
+	EXPECT_EQ(mLines[1].subscribedTag, 2);
+	EXPECT_EQ(mLines[2].subscribedTag, 2);
+	EXPECT_EQ(mLines[3].subscribedTag, HLS_NO_SUBSCRIBED_TAG);
+	EXPECT_EQ(mLines[4].tag, eHLS_TAG_EXTINF);
+	EXPECT_EQ(mLines[4].subscribedTag, HLS_NO_SUBSCRIBED_TAG);
+
+	// "#EXT" matches every tag line, but not other lines
+	tags.push_back("#EXT");
+	EXPECT_TRUE(mLexer.SetSubscribedTags(tags));
+	Tokenize(playlist + "seg1.ts\n");
+	ASSERT_EQ(mLines.size(), 6u);
+	EXPECT_EQ(mLines[0].subscribedTag, 0);
+	EXPECT_EQ(mLines[3].subscribedTag, 5);
+	EXPECT_EQ(mLines[4].subscribedTag, 5);
+	EXPECT_EQ(mLines[5].subscribedTag, HLS_NO_SUBSCRIBED_TAG);
+}
+
+/*
+    The trie is only rebuilt when the subscribed tags change
+*/
+TEST_F(HlsTagLexerTests, DetectsSubscribedTagChange)
+{
+	std::vector<std::string> tags;
+	EXPECT_FALSE(mLexer.SetSubscribedTags(tags));
+	tags.push_back("#EXT-X-SCTE35");
+	EXPECT_TRUE(mLexer.SetSubscribedTags(tags));
+	EXPECT_FALSE(mLexer.SetSubscribedTags(tags));
+
+	const std::string playlist = "#EXT-X-SCTE35:CUE=abc";
+	Tokenize(playlist);
+	ASSERT_EQ(mLines.size(), 1u);
+	EXPECT_EQ(mLines[0].tag, eHLS_TAG_SCTE35);
+	EXPECT_EQ(mLines[0].subscribedTag, 0);
+
+	tags.clear();
+	EXPECT_TRUE(mLexer.SetSubscribedTags(tags));
+	mLexer.Classify(playlist.c_str(), mLines[0]);
+	EXPECT_EQ(mLines[0].tag, eHLS_TAG_SCTE35);
+	EXPECT_EQ(mLines[0].subscribedTag, HLS_NO_SUBSCRIBED_TAG);
+}
+
+/*
+    Subscribed tags not starting with "#EXT" never match
+*/
+TEST_F(HlsTagLexerTests, IgnoresSubscribedNonTags)
+{
+	std::vector<std::string> tags;
+	tags.push_back("#EXAMPLE");
+	tags.push_back("XXXX-X-CUE");
+	EXPECT_TRUE(mLexer.SetSubscribedTags(tags));
+
+	const std::string playlist = "#EXTMPLE\n#EXT-X-CUE:1\n#EXAMPLE\n";
+	Tokenize(playlist);
+	ASSERT_EQ(mLines.size(), 3u);
+	EXPECT_EQ(mLines[0].tag, eHLS_TAG_UNKNOWN);
+	EXPECT_EQ(mLines[1].tag, eHLS_TAG_CUE);
+	EXPECT_EQ(mLines[2].tag, eHLS_TAG_NONE);
+	for (size_t i = 0; i < mLines.size(); i++)
+	{
+		EXPECT_EQ(mLines[i].subscribedTag, HLS_NO_SUBSCRIBED_TAG) << GetLine(playlist, mLines[i]);
+	}
+}
@@ -0,0 +1,186 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include "AampLruCache.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+#define TYPE_VIDEO	1
+#define TYPE_AUDIO	2
+#define TYPE_MANIFEST	3
+
+class LruCacheTests : public ::testing::Test
+{
+protected:
+	AampLruCache mCache;
+
+	AampCachedFilePtr MakeFile(size_t len, int type, const std::string &effectiveUrl = "")
+	{
+		std::vector<char> content(len, 'x');
+		return std::make_shared<AampCachedFile>(std::move(content), effectiveUrl, type);
+	}
+};
+
+/*
+    Lookup returns the shared file, no copy is taken
+*/
+TEST_F(LruCacheTests, SharesCachedFile)
+{
+	AampCachedFilePtr file = std::make_shared<AampCachedFile>("#EXTM3U", 7, "http://cdn/main.m3u8", TYPE_MANIFEST);
+	ASSERT_TRUE(mCache.Insert("http://host/main.m3u8", file));
+	EXPECT_FALSE(mCache.Insert("http://host/main.m3u8", file));
+
+	AampCachedFilePtr found = mCache.Find("http://host/main.m3u8");
+	EXPECT_EQ(found.get(), file.get());
+	EXPECT_EQ(std::string(found->data.begin(), found->data.end()), "#EXTM3U");
+	EXPECT_EQ(mCache.Find("http://cdn/main.m3u8").get(), file.get());
+	EXPECT_TRUE(mCache.Find("http://host/other.m3u8") == NULL);
+
+	// effective url entry takes no budget
+	EXPECT_EQ(mCache.GetCount(), 1);
+	EXPECT_EQ(mCache.GetTotalBytes(), 7);
+
+	// borrower keeps removed file alive
+	EXPECT_TRUE(mCache.Remove("http://host/main.m3u8"));
+	EXPECT_FALSE(mCache.Contains("http://cdn/main.m3u8"));
+	EXPECT_EQ(mCache.GetTotalBytes(), 0);
+	EXPECT_EQ(found->data.size(), 7);
+}
+
+static int gReleaseCount = 0;
+
+static void CountingRelease(void *ptr)
+{
+	gReleaseCount++;
+	free(ptr);
+}
+
+/*
+    Adopted memory is used in place and released with the last reference
+*/
+TEST_F(LruCacheTests, AdoptsMemory)
+{
+	char *ptr = (char *)malloc(5);
+	memcpy(ptr, "ftyp1", 5);
+	gReleaseCount = 0;
+	AampCachedFilePtr file = std::make_shared<AampCachedFile>(ptr, 5, CountingRelease, "", TYPE_VIDEO);
+	EXPECT_EQ(file->data.data(), ptr);
+	EXPECT_EQ(std::string(file->data.begin(), file->data.end()), "ftyp1");
+	ASSERT_TRUE(mCache.Insert("http://host/init.mp4", file));
+	EXPECT_EQ(mCache.GetTotalBytes(), 5);
+
+	AampCachedFilePtr found = mCache.Find("http://host/init.mp4");
+	file.reset();
+	EXPECT_TRUE(mCache.Remove("http://host/init.mp4"));
+	EXPECT_EQ(gReleaseCount, 0);
+	found.reset();
+	EXPECT_EQ(gReleaseCount, 1);
+}
+
+/*
+    Full type evicts its least recently used entry, other types are kept
+*/
+TEST_F(LruCacheTests, EvictsLeastRecentlyUsedOfType)
+{
+	mCache.SetTypeBudget(TYPE_VIDEO, 300, 10);
+	ASSERT_TRUE(mCache.Insert("v0", MakeFile(100, TYPE_VIDEO)));
+	ASSERT_TRUE(mCache.Insert("v1", MakeFile(100, TYPE_VIDEO)));
+	ASSERT_TRUE(mCache.Insert("v2", MakeFile(100, TYPE_VIDEO)));
+	ASSERT_TRUE(mCache.Insert("a0", MakeFile(500, TYPE_AUDIO)));
+	ASSERT_TRUE(mCache.Find("v0") != NULL);
+
+	ASSERT_TRUE(mCache.Insert("v3", MakeFile(150, TYPE_VIDEO)));
+	EXPECT_TRUE(mCache.Contains("v0"));
+	EXPECT_FALSE(mCache.Contains("v1"));
+	EXPECT_FALSE(mCache.Contains("v2"));
+	EXPECT_TRUE(mCache.Contains("v3"));
+	EXPECT_TRUE(mCache.Contains("a0"));
+	EXPECT_EQ(mCache.GetTypeBytes(TYPE_VIDEO), 250);
+	EXPECT_EQ(mCache.GetTypeBytes(TYPE_AUDIO), 500);
+
+	// larger than budget of type
+	EXPECT_FALSE(mCache.Insert("v4", MakeFile(301, TYPE_VIDEO)));
+	EXPECT_TRUE(mCache.Contains("v0"));
+}
+
+/*
+    Entry limit of a type, as used for init fragments per track
+*/
+TEST_F(LruCacheTests, LimitsEntriesPerType)
+{
+	mCache.SetDefaultBudget(AAMP_LRU_CACHE_UNLIMITED, 2);
+	ASSERT_TRUE(mCache.Insert("v0", MakeFile(1, TYPE_VIDEO, "r0")));
+	ASSERT_TRUE(mCache.Insert("v1", MakeFile(1, TYPE_VIDEO)));
+	ASSERT_TRUE(mCache.Insert("a0", MakeFile(1, TYPE_AUDIO)));
+	ASSERT_TRUE(mCache.Find("r0") != NULL);
+
+	ASSERT_TRUE(mCache.Insert("v2", MakeFile(1, TYPE_VIDEO)));
+	EXPECT_TRUE(mCache.Contains("v0"));
+	EXPECT_FALSE(mCache.Contains("v1"));
+	EXPECT_EQ(mCache.GetCount(), 3);
+
+	mCache.SetDefaultBudget(AAMP_LRU_CACHE_UNLIMITED, 1);
+	ASSERT_TRUE(mCache.Insert("v3", MakeFile(1, TYPE_VIDEO)));
+	EXPECT_FALSE(mCache.Contains("v0"));
+	EXPECT_FALSE(mCache.Contains("r0"));
+	EXPECT_FALSE(mCache.Contains("v2"));
+	EXPECT_EQ(mCache.GetCount(), 2);
+}
+
+/*
+    Total budget evicts the inserted type first, then the largest type, never a reserved type
+*/
+TEST_F(LruCacheTests, SharesTotalBudget)
+{
+	mCache.SetTotalBudget(1000);
+	mCache.SetTypeBudget(TYPE_MANIFEST, AAMP_LRU_CACHE_UNLIMITED, AAMP_LRU_CACHE_UNLIMITED, true);
+	ASSERT_TRUE(mCache.Insert("m", MakeFile(400, TYPE_MANIFEST)));
+	ASSERT_TRUE(mCache.Insert("v0", MakeFile(200, TYPE_VIDEO)));
+	ASSERT_TRUE(mCache.Insert("v1", MakeFile(200, TYPE_VIDEO)));
+	ASSERT_TRUE(mCache.Insert("a0", MakeFile(100, TYPE_AUDIO)));
+
+	ASSERT_TRUE(mCache.Insert("a1", MakeFile(150, TYPE_AUDIO)));
+	EXPECT_FALSE(mCache.Contains("a0"));
+	EXPECT_TRUE(mCache.Contains("v0"));
+	EXPECT_EQ(mCache.GetTotalBytes(), 950);
+
+	ASSERT_TRUE(mCache.Insert("v2", MakeFile(500, TYPE_VIDEO)));
+	EXPECT_TRUE(mCache.Contains("m"));
+	EXPECT_FALSE(mCache.Contains("v0"));
+	EXPECT_FALSE(mCache.Contains("v1"));
+	EXPECT_FALSE(mCache.Contains("a1"));
+	EXPECT_EQ(mCache.GetTotalBytes(), 900);
+
+	// nothing evictable left for it
+	EXPECT_FALSE(mCache.Insert("a2", MakeFile(700, TYPE_AUDIO)));
+	EXPECT_TRUE(mCache.Insert("a2", MakeFile(100, TYPE_AUDIO)));
+
+	mCache.Clear();
+	EXPECT_EQ(mCache.GetCount(), 0);
+	EXPECT_EQ(mCache.GetTotalBytes(), 0);
+	EXPECT_EQ(mCache.GetTypeBytes(TYPE_MANIFEST), 0);
+}
@@ -0,0 +1,272 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <algorithm>
+#include "AampPreTuner.h"
+
+class AampConfig;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+static const char *MASTER =
+	"#EXTM3U\n"
+	"#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID=\"aac\",LANGUAGE=\"fr\",URI=\"http://host/fr.m3u8\"\n"
+	"#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID=\"aac\",LANGUAGE=\"en\",DEFAULT=YES,URI=\"http://host/en.m3u8\"\n"
+	"#EXT-X-STREAM-INF:AVERAGE-BANDWIDTH=900000,BANDWIDTH=1000000,CODECS=\"avc1.4d401f,mp4a.40.2\",AUDIO=\"aac\"\n"
+	"http://host/1m.m3u8\n"
+	"#EXT-X-I-FRAME-STREAM-INF:BANDWIDTH=200000,URI=\"http://host/iframe.m3u8\"\n"
+	"#EXT-X-STREAM-INF:BANDWIDTH=3000000,AUDIO=\"aac\"\n"
+	"http://host/3m.m3u8\n"
+	"#EXT-X-STREAM-INF:BANDWIDTH=6000000,AUDIO=\"aac\"\n"
+	"http://host/6m.m3u8\n";
+
+static const char *LIVE =
+	"#EXTM3U\r\n"
+	"#EXT-X-TARGETDURATION:6\r\n"
+	"#EXT-X-MAP:URI=\"http://host/v.init\"\r\n"
+	"#EXT-X-KEY:METHOD=AES-128,URI=\"http://host/k1\"\r\n"
+	"#EXTINF:6.0,\r\n"
+	"http://host/v1.m4s\r\n"
+	"#EXTINF:6.0,\r\n"
+	"http://host/v2.m4s\r\n"
+	"#EXT-X-KEY:METHOD=AES-128,URI=\"http://host/k2\"\r\n"
+	"#EXTINF:6.0,\r\n"
+	"http://host/v3.m4s\r\n"
+	"#EXTINF:6.0,\r\n"
+	"http://host/v4.m4s\r\n";
+
+class PreTunerTests : public ::testing::Test
+{
+protected:
+	std::map<std::string, std::string> mServer;
+	std::vector<std::string> mRequests;
+	std::mutex mServerMutex;
+
+	AampPreTuner::Downloader GetDownloader()
+	{
+		return [this](const std::string &url, std::vector<char> &data, std::string &effectiveUrl)
+		{
+			std::lock_guard<std::mutex> guard(mServerMutex);
+			mRequests.push_back(url);
+			auto it = mServer.find(url);
+			if (it == mServer.end())
+			{
+				return false;
+			}
+			data.assign(it->second.begin(), it->second.end());
+			effectiveUrl = url;
+			return true;
+		};
+	}
+
+	AampPreTuneConfig GetConfig()
+	{
+		AampPreTuneConfig config;
+		config.maxBytes = 64 * 1024;
+		config.maxAgeMs = 60000;
+		config.intervalMs = 1;
+		config.initialBitrate = 2500000;
+		config.liveOffset = 15;
+		return config;
+	}
+
+	static std::string MakePlaylist(size_t size)
+	{
+		// media playlist without segments, only the playlist itself is staged
+		std::string playlist = "#EXTM3U\n";
+		playlist.append(size - playlist.size(), '#');
+		return playlist;
+	}
+
+	bool WaitForRequest(const std::string &url)
+	{
+		for (int i = 0; i < 200; i++)
+		{
+			{
+				std::lock_guard<std::mutex> guard(mServerMutex);
+				if (std::find(mRequests.begin(), mRequests.end(), url) != mRequests.end())
+				{
+					return true;
+				}
+			}
+			usleep(10000);
+		}
+		return false;
+	}
+
+	bool WaitForStaged(AampPreTuner &preTuner, unsigned long staged)
+	{
+		for (int i = 0; i < 200 && preTuner.GetStats().staged < staged; i++)
+		{
+			usleep(10000);
+		}
+		return preTuner.GetStats().staged >= staged;
+	}
+};
+
+/*
+    Variant closest below initial bitrate and default audio rendition of its group are picked
+*/
+TEST_F(PreTunerTests, SelectsVariant)
+{
+	std::string video;
+	std::string audio;
+	ASSERT_TRUE(AampPreTuner::SelectVariant(MASTER, 2500000, video, audio));
+	EXPECT_EQ(video, "http://host/1m.m3u8");
+	EXPECT_EQ(audio, "http://host/en.m3u8");
+
+	ASSERT_TRUE(AampPreTuner::SelectVariant(MASTER, 10000000, video, audio));
+	EXPECT_EQ(video, "http://host/6m.m3u8");
+
+	// nothing at or below bitrate falls back to lowest
+	ASSERT_TRUE(AampPreTuner::SelectVariant(MASTER, 1000, video, audio));
+	EXPECT_EQ(video, "http://host/1m.m3u8");
+
+	ASSERT_TRUE(AampPreTuner::SelectVariant("#EXTM3U\n#EXT-X-STREAM-INF:BANDWIDTH=100\nmuxed.m3u8\n", 1000, video, audio));
+	EXPECT_EQ(video, "muxed.m3u8");
+	EXPECT_TRUE(audio.empty());
+	EXPECT_FALSE(AampPreTuner::SelectVariant("#EXTM3U\n", 1000, video, audio));
+}
+
+/*
+    Live tune starts live offset from edge with the key and init of that segment, VOD from first segment
+*/
+TEST_F(PreTunerTests, SelectsFragments)
+{
+	std::string init;
+	std::string key;
+	std::string segment;
+	ASSERT_TRUE(AampPreTuner::SelectFragments(LIVE, 15, init, key, segment));
+	EXPECT_EQ(segment, "http://host/v2.m4s");
+	EXPECT_EQ(key, "http://host/k1");
+	EXPECT_EQ(init, "http://host/v.init");
+
+	ASSERT_TRUE(AampPreTuner::SelectFragments(LIVE, 0, init, key, segment));
+	EXPECT_EQ(segment, "http://host/v4.m4s");
+	EXPECT_EQ(key, "http://host/k2");
+
+	// offset beyond window starts from first segment
+	ASSERT_TRUE(AampPreTuner::SelectFragments(LIVE, 100, init, key, segment));
+	EXPECT_EQ(segment, "http://host/v1.m4s");
+
+	std::string vod = std::string(LIVE) + "#EXT-X-ENDLIST\n";
+	ASSERT_TRUE(AampPreTuner::SelectFragments(vod, 15, init, key, segment));
+	EXPECT_EQ(segment, "http://host/v1.m4s");
+
+	ASSERT_TRUE(AampPreTuner::SelectFragments("#EXTM3U\n#EXT-X-KEY:METHOD=SAMPLE-AES,URI=\"skd://k\"\n#EXTINF:2,\nts1.ts\n", 0, init, key, segment));
+	EXPECT_TRUE(init.empty());
+	EXPECT_TRUE(key.empty());
+	EXPECT_EQ(segment, "ts1.ts");
+	EXPECT_FALSE(AampPreTuner::SelectFragments("#EXTM3U\n", 0, init, key, segment));
+}
+
+/*
+    Manifest, playlists, key, init and first segment of a HLS channel are staged and handed to a tune once
+*/
+TEST_F(PreTunerTests, StagesHlsChannel)
+{
+	mServer["http://host/master.m3u8"] = MASTER;
+	mServer["http://host/1m.m3u8"] = LIVE;
+	mServer["http://host/en.m3u8"] = "#EXTM3U\n#EXTINF:6,\nhttp://host/a1.aac\n#EXT-X-ENDLIST\n";
+	mServer["http://host/k1"] = "0123456789abcdef";
+	mServer["http://host/v.init"] = "init";
+	mServer["http://host/v2.m4s"] = "segment";
+	mServer["http://host/a1.aac"] = "audio";
+	mServer["http://host/other.mpd"] = "<MPD/>";
+
+	AampPreTuner preTuner(NULL, GetDownloader());
+	preTuner.SetConfig(GetConfig());
+	preTuner.SetChannels({"http://host/master.m3u8", "http://host/other.mpd"});
+	ASSERT_TRUE(WaitForStaged(preTuner, 1));
+	ASSERT_TRUE(WaitForRequest("http://host/other.mpd"));
+
+	AampPreTunedFiles files;
+	ASSERT_TRUE(preTuner.Take("http://host/master.m3u8", files));
+	EXPECT_EQ(files.size(), 7);
+	ASSERT_TRUE(files["http://host/k1"] != NULL);
+	EXPECT_EQ(files["http://host/k1"]->type, eMEDIATYPE_LICENCE);
+	EXPECT_EQ(files["http://host/v.init"]->type, eMEDIATYPE_INIT_VIDEO);
+	EXPECT_EQ(files["http://host/a1.aac"]->type, eMEDIATYPE_AUDIO);
+	const AampCachedContent &segment = files["http://host/v2.m4s"]->data;
+	EXPECT_EQ(std::string(segment.begin(), segment.end()), "segment");
+
+	AampPreTunedFiles again;
+	EXPECT_FALSE(preTuner.Take("http://host/master.m3u8", again));
+	EXPECT_TRUE(again.empty());
+
+	// DASH channel is not staged and its manifest not downloaded again
+	usleep(20000);
+	EXPECT_FALSE(preTuner.Take("http://host/other.mpd", files));
+	EXPECT_EQ(preTuner.GetStats().taken, 1);
+	{
+		std::lock_guard<std::mutex> guard(mServerMutex);
+		EXPECT_EQ(std::count(mRequests.begin(), mRequests.end(), "http://host/other.mpd"), 1);
+	}
+
+	preTuner.SetChannels({});
+	EXPECT_EQ(preTuner.GetStats().stagedBytes, 0);
+}
+
+/*
+    Budget keeps the most likely channels, staged files older than max age are not used
+*/
+TEST_F(PreTunerTests, KeepsBudgetAndAge)
+{
+	mServer["http://host/a.m3u8"] = MakePlaylist(40 * 1024);
+	mServer["http://host/b.m3u8"] = MakePlaylist(40 * 1024);
+	mServer["http://host/c.m3u8"] = MakePlaylist(10 * 1024);
+
+	AampPreTuner preTuner(NULL, GetDownloader());
+	preTuner.SetConfig(GetConfig());
+	preTuner.SetChannels({"http://host/a.m3u8", "http://host/b.m3u8", "http://host/c.m3u8"});
+	ASSERT_TRUE(WaitForStaged(preTuner, 2));
+	usleep(50000);
+
+	AampPreTuneStats stats = preTuner.GetStats();
+	EXPECT_EQ(stats.stagedBytes, 50 * 1024);
+	AampPreTunedFiles files;
+	EXPECT_FALSE(preTuner.Take("http://host/b.m3u8", files));
+	EXPECT_TRUE(preTuner.Take("http://host/c.m3u8", files));
+
+	// pause holds downloads
+	preTuner.SetPaused(true);
+	preTuner.SetChannels({"http://host/d.m3u8"});
+	usleep(50000);
+	size_t requests;
+	{
+		std::lock_guard<std::mutex> guard(mServerMutex);
+		requests = mRequests.size();
+		EXPECT_TRUE(std::find(mRequests.begin(), mRequests.end(), "http://host/d.m3u8") == mRequests.end());
+		mServer["http://host/d.m3u8"] = MakePlaylist(16);
+	}
+	AampPreTuneConfig config = GetConfig();
+	config.maxAgeMs = 0;
+	preTuner.SetConfig(config);
+	preTuner.SetPaused(false);
+	ASSERT_TRUE(WaitForStaged(preTuner, 3));
+	preTuner.SetPaused(true);
+	usleep(10000);
+	EXPECT_FALSE(preTuner.Take("http://host/d.m3u8", files));
+	EXPECT_EQ(preTuner.GetStats().expired, 1);
+	std::lock_guard<std::mutex> guard(mServerMutex);
+	EXPECT_GT(mRequests.size(), requests);
+}
@@ -0,0 +1,298 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AampReactor.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+class ReactorTests : public ::testing::Test
+{
+protected:
+	std::mutex mMutex;
+	std::condition_variable mCond;
+
+	static long long NowMs()
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	template<typename Predicate> bool WaitFor(int timeoutMs, Predicate predicate)
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		return mCond.wait_for(lock, std::chrono::milliseconds(timeoutMs), predicate);
+	}
+
+	static bool WaitUntilDone(int id)
+	{
+		for (int i = 0; i < 500 && AampReactor::GetInstance().IsScheduled(id); i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return !AampReactor::GetInstance().IsScheduled(id);
+	}
+
+	void Notify()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCond.notify_all();
+	}
+};
+
+/*
+    Delayed tasks run in due order, not before their delay and within a few ticks of it
+*/
+TEST_F(ReactorTests, RunsTasksWhenDue)
+{
+	AampReactor &reactor = AampReactor::GetInstance();
+	std::vector<int> order;
+	std::vector<long long> elapsed;
+	const int delays[] = {80, 20, 700, 50, 0};
+	const int count = sizeof(delays) / sizeof(delays[0]);
+	long long startMs = NowMs();
+	for (int i = 0; i < count; i++)
+	{
+		int delay = delays[i];
+		EXPECT_NE(reactor.Schedule("RunsTasksWhenDue", delay, [this, delay, startMs, &order, &elapsed]()
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			order.push_back(delay);
+			elapsed.push_back(NowMs() - startMs);
+			mCond.notify_all();
+			return AAMP_REACTOR_TASK_DONE;
+		}), AAMP_REACTOR_TASK_ID_INVALID);
+	}
+	ASSERT_TRUE(WaitFor(5000, [&]() { return order.size() == (size_t)count; }));
+	std::lock_guard<std::mutex> lock(mMutex);
+	EXPECT_EQ(order, std::vector<int>({0, 20, 50, 80, 700}));
+	for (int i = 0; i < count; i++)
+	{
+		EXPECT_GE(elapsed[i], order[i]);
+		EXPECT_LT(elapsed[i], order[i] + 200);
+	}
+}
+
+/*
+    A periodic task runs again after the delay it returns until it is done
+*/
+TEST_F(ReactorTests, ReschedulesByReturnValue)
+{
+	AampReactor &reactor = AampReactor::GetInstance();
+	int runs = 0;
+	long long firstMs = 0;
+	long long lastMs = 0;
+	int id = reactor.Schedule("ReschedulesByReturnValue", 0, [this, &runs, &firstMs, &lastMs]()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		lastMs = NowMs();
+		if (runs++ == 0)
+		{
+			firstMs = lastMs;
+		}
+		mCond.notify_all();
+		return (runs < 5) ? 30 : AAMP_REACTOR_TASK_DONE;
+	});
+	ASSERT_TRUE(WaitFor(5000, [&]() { return runs == 5; }));
+	EXPECT_TRUE(WaitUntilDone(id));
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	std::lock_guard<std::mutex> lock(mMutex);
+	EXPECT_EQ(runs, 5);
+	EXPECT_GE(lastMs - firstMs, 4 * 30);
+}
+
+/*
+    Cancel removes a pending task and waits for a run in progress
+*/
+TEST_F(ReactorTests, CancelWaitsForRun)
+{
+	AampReactor &reactor = AampReactor::GetInstance();
+	std::atomic<bool> pendingRan(false);
+	int pendingId = reactor.Schedule("CancelWaitsForRun", 100, [&pendingRan]()
+	{
+		pendingRan = true;
+		return AAMP_REACTOR_TASK_DONE;
+	});
+	EXPECT_TRUE(reactor.Cancel(pendingId));
+	EXPECT_FALSE(reactor.IsScheduled(pendingId));
+	EXPECT_FALSE(reactor.Cancel(pendingId));
+
+	std::atomic<bool> started(false);
+	std::atomic<bool> finished(false);
+	std::atomic<int> runs(0);
+	int runningId = reactor.Schedule("CancelWaitsForRun", 0, [this, &started, &finished, &runs]()
+	{
+		runs++;
+		started = true;
+		Notify();
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		finished = true;
+		return 0;
+	});
+	ASSERT_TRUE(WaitFor(5000, [&]() { return started.load(); }));
+	EXPECT_TRUE(reactor.Cancel(runningId));
+	EXPECT_TRUE(finished);
+	EXPECT_FALSE(reactor.IsScheduled(runningId));
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	EXPECT_EQ(runs, 1);
+	EXPECT_FALSE(pendingRan);
+}
+
+/*
+    A task cancelling itself ends after the current run without waiting for itself
+*/
+TEST_F(ReactorTests, CancelFromOwnRun)
+{
+	AampReactor &reactor = AampReactor::GetInstance();
+	std::atomic<int> id(AAMP_REACTOR_TASK_ID_INVALID);
+	std::atomic<int> runs(0);
+	std::atomic<bool> cancelled(false);
+	std::unique_lock<std::mutex> lock(mMutex);
+	id = reactor.Schedule("CancelFromOwnRun", 0, [this, &id, &runs, &cancelled]()
+	{
+		std::lock_guard<std::mutex> guard(mMutex);
+		runs++;
+		cancelled = AampReactor::GetInstance().Cancel(id);
+		mCond.notify_all();
+		return 10;
+	});
+	ASSERT_TRUE(mCond.wait_for(lock, std::chrono::seconds(5), [&]() { return runs > 0; }));
+	lock.unlock();
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_TRUE(cancelled);
+	EXPECT_EQ(runs, 1);
+	EXPECT_FALSE(reactor.IsScheduled(id));
+}
+
+/*
+    Waiting tasks run on Wake, a wake during a run makes the task run once more
+*/
+TEST_F(ReactorTests, RunsOnWake)
+{
+	AampReactor &reactor = AampReactor::GetInstance();
+	std::atomic<int> runs(0);
+	std::atomic<int> concurrent(0);
+	std::atomic<bool> overlapped(false);
+	int id = reactor.Schedule("RunsOnWake", AAMP_REACTOR_WAIT_WAKE, [this, &runs, &concurrent, &overlapped]()
+	{
+		if (++concurrent > 1)
+		{
+			overlapped = true;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		runs++;
+		concurrent--;
+		Notify();
+		return AAMP_REACTOR_WAIT_WAKE;
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_EQ(runs, 0);
+	EXPECT_TRUE(reactor.Wake(id));
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	EXPECT_TRUE(reactor.Wake(id));
+	EXPECT_TRUE(reactor.Wake(id));
+	ASSERT_TRUE(WaitFor(5000, [&]() { return runs == 2; }));
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_EQ(runs, 2);
+	EXPECT_FALSE(overlapped);
+
+	std::atomic<bool> woken(false);
+	long long startMs = NowMs();
+	int delayedId = reactor.Schedule("RunsOnWake", 60000, [this, &woken]()
+	{
+		woken = true;
+		Notify();
+		return AAMP_REACTOR_TASK_DONE;
+	});
+	EXPECT_TRUE(reactor.Wake(delayedId));
+	ASSERT_TRUE(WaitFor(5000, [&]() { return woken.load(); }));
+	EXPECT_LT(NowMs() - startMs, 1000);
+
+	EXPECT_TRUE(reactor.Cancel(id));
+	EXPECT_FALSE(reactor.Wake(id));
+}
+
+/*
+    Blocked workers make the pool grow, statistics count runs per task name
+*/
+TEST_F(ReactorTests, GrowsPoolAndCountsRuns)
+{
+	AampReactor &reactor = AampReactor::GetInstance();
+	const int blocking = AAMP_REACTOR_MIN_WORKERS + 2;
+	int started = 0;
+	bool release = false;
+	std::vector<int> ids;
+	std::vector<AampReactorTaskStats> stats;
+	unsigned long long runsBefore = 0;
+	reactor.GetStats(stats);
+	for (const AampReactorTaskStats &entry : stats)
+	{
+		if (entry.name == "GrowsPoolAndCountsRuns")
+		{
+			runsBefore = entry.runs;
+		}
+	}
+	for (int i = 0; i < blocking; i++)
+	{
+		ids.push_back(reactor.Schedule("GrowsPoolAndCountsRuns", 0, [this, &started, &release]()
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			started++;
+			mCond.notify_all();
+			mCond.wait(lock, [&]() { return release; });
+			return AAMP_REACTOR_TASK_DONE;
+		}));
+	}
+	EXPECT_TRUE(WaitFor(5000, [&]() { return started == blocking; }));
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		release = true;
+		mCond.notify_all();
+	}
+	for (int id : ids)
+	{
+		EXPECT_TRUE(WaitUntilDone(id));
+	}
+	EXPECT_GE(reactor.GetWorkerCount(), blocking);
+	EXPECT_LE(reactor.GetWorkerCount(), AAMP_REACTOR_MAX_WORKERS);
+
+	reactor.GetStats(stats);
+	bool found = false;
+	for (const AampReactorTaskStats &entry : stats)
+	{
+		if (entry.name == "GrowsPoolAndCountsRuns")
+		{
+			found = true;
+			EXPECT_EQ(entry.runs - runsBefore, (unsigned long long)blocking);
+			EXPECT_GT(entry.maxRunUs, 0);
+			EXPECT_GE(entry.totalRunUs, entry.maxRunUs);
+			EXPECT_GE(entry.totalLateUs, entry.maxLateUs);
+		}
+	}
+	EXPECT_TRUE(found);
+}
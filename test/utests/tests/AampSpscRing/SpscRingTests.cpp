@@ -0,0 +1,158 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <thread>
+#include "AampSpscRing.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+#define TEST_RING_CAPACITY 4
+
+class SpscRingTests : public ::testing::Test
+{
+protected:
+	AampSpscRing mRing;
+
+	void SetUp() override
+	{
+		mRing.Reset(TEST_RING_CAPACITY);
+	}
+};
+
+/*
+    Indices wrap around and count follows Push and Pop
+*/
+TEST_F(SpscRingTests, WrapsIndices)
+{
+	EXPECT_FALSE(mRing.Pop());
+	for (int i = 0; i < TEST_RING_CAPACITY; i++)
+	{
+		EXPECT_EQ(mRing.GetWriteIndex(), i);
+		EXPECT_TRUE(mRing.Push());
+	}
+	EXPECT_EQ(mRing.GetCount(), TEST_RING_CAPACITY);
+	EXPECT_EQ(mRing.GetWriteIndex(), 0);
+	EXPECT_FALSE(mRing.Push());
+	EXPECT_TRUE(mRing.Pop());
+	EXPECT_EQ(mRing.GetReadIndex(), 1);
+	EXPECT_TRUE(mRing.Push());
+	EXPECT_EQ(mRing.GetWriteIndex(), 1);
+	mRing.Reset(TEST_RING_CAPACITY);
+	EXPECT_EQ(mRing.GetCount(), 0);
+	EXPECT_EQ(mRing.GetReadIndex(), 0);
+}
+
+/*
+    Several slots are published and freed at once, wrapping around
+*/
+TEST_F(SpscRingTests, PushesSeveralSlots)
+{
+	EXPECT_FALSE(mRing.Push(0));
+	EXPECT_FALSE(mRing.Push(TEST_RING_CAPACITY + 1));
+	EXPECT_TRUE(mRing.Push(3));
+	EXPECT_EQ(mRing.GetCount(), 3);
+	EXPECT_EQ(mRing.GetWriteIndex(), 3);
+	EXPECT_FALSE(mRing.Push(2));
+	EXPECT_FALSE(mRing.Pop(4));
+	EXPECT_TRUE(mRing.Pop(2));
+	EXPECT_EQ(mRing.GetReadIndex(), 2);
+	EXPECT_TRUE(mRing.Push(3));
+	EXPECT_EQ(mRing.GetWriteIndex(), 2);
+	EXPECT_EQ(mRing.GetCount(), TEST_RING_CAPACITY);
+	EXPECT_TRUE(mRing.Pop(TEST_RING_CAPACITY));
+	EXPECT_EQ(mRing.GetReadIndex(), 2);
+	EXPECT_EQ(mRing.GetCount(), 0);
+}
+
+/*
+    Waits return at once when not blocked, time out or stop on abort otherwise
+*/
+TEST_F(SpscRingTests, WaitsAndAborts)
+{
+	EXPECT_TRUE(mRing.WaitForFreeSlot(-1));
+	EXPECT_FALSE(mRing.WaitForUsedSlot(10));
+	mRing.Push();
+	EXPECT_TRUE(mRing.WaitForUsedSlot(-1));
+	mRing.SetAborted(true);
+	EXPECT_FALSE(mRing.WaitForUsedSlot(-1));
+	EXPECT_FALSE(mRing.WaitForFreeSlot(-1));
+	mRing.SetAborted(false);
+	EXPECT_TRUE(mRing.WaitForFreeSlot(-1));
+
+	std::thread aborter([this]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		mRing.WakeConsumer();
+	});
+	mRing.Pop();
+	EXPECT_FALSE(mRing.WaitForUsedSlot(-1));
+	EXPECT_FALSE(mRing.IsAborted());
+	aborter.join();
+}
+
+/*
+    Blocked producer is only woken after the configured number of slots are free
+*/
+TEST_F(SpscRingTests, BatchesProducerWakeup)
+{
+	mRing.Reset(TEST_RING_CAPACITY, 2);
+	while (mRing.Push());
+	std::atomic<int> freeOnWakeup(-1);
+	std::thread producer([&]() {
+		EXPECT_TRUE(mRing.WaitForFreeSlot(-1));
+		freeOnWakeup = TEST_RING_CAPACITY - mRing.GetCount();
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	mRing.Pop();
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	EXPECT_EQ(freeOnWakeup, -1);
+	mRing.Pop();
+	producer.join();
+	EXPECT_EQ(freeOnWakeup, 2);
+}
+
+/*
+    Slots are handed over in order between two threads
+*/
+TEST_F(SpscRingTests, HandsOverSlots)
+{
+	const int count = 100000;
+	int slots[TEST_RING_CAPACITY] = {0};
+	mRing.Reset(TEST_RING_CAPACITY, TEST_RING_CAPACITY / 2);
+	std::thread producer([&]() {
+		for (int i = 0; i < count; i++)
+		{
+			ASSERT_TRUE(mRing.WaitForFreeSlot(-1));
+			slots[mRing.GetWriteIndex()] = i;
+			mRing.Push();
+		}
+	});
+	for (int i = 0; i < count; i++)
+	{
+		ASSERT_TRUE(mRing.WaitForUsedSlot(-1));
+		EXPECT_EQ(slots[mRing.GetReadIndex()], i);
+		mRing.Pop();
+	}
+	producer.join();
+	EXPECT_EQ(mRing.GetCount(), 0);
+}
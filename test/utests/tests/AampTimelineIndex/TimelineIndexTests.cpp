@@ -0,0 +1,150 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include "AampTimelineIndex.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+#define TEST_TIMESCALE 1000
+
+static AampTimelineEntry MakeEntry(uint32_t duration, uint32_t repeatCount)
+{
+	AampTimelineEntry entry;
+	entry.duration = duration;
+	entry.repeatCount = repeatCount;
+	return entry;
+}
+
+static AampTimelineEntry MakeEntry(uint64_t startTime, uint32_t duration, uint32_t repeatCount)
+{
+	AampTimelineEntry entry = MakeEntry(duration, repeatCount);
+	entry.startTime = startTime;
+	entry.hasStartTime = true;
+	return entry;
+}
+
+class TimelineIndexTests : public ::testing::Test
+{
+protected:
+	AampTimelineIndex mIndex;
+	int mOwner = 0;
+
+	void SetUp() override
+	{
+		// <S t="10000" d="2000" r="2"/><S d="1000"/><S d="2000" r="9999"/><S t="100000000" d="4000" r="1"/>
+		std::vector<AampTimelineEntry> entries;
+		entries.push_back(MakeEntry(10000, 2000, 2));
+		entries.push_back(MakeEntry(1000, 0));
+		entries.push_back(MakeEntry(2000, 9999));
+		entries.push_back(MakeEntry(100000000, 4000, 1));
+		mIndex.Build(entries, TEST_TIMESCALE, &mOwner, 1);
+	}
+};
+
+/*
+    Prefix sums count fragments of every S element
+*/
+TEST_F(TimelineIndexTests, CountsFragments)
+{
+	EXPECT_EQ(mIndex.GetEntryCount(), 4);
+	EXPECT_EQ(mIndex.GetFragmentCount(), 3 + 1 + 10000 + 2);
+	EXPECT_EQ(mIndex.GetOrdinal(2, 0), 4);
+	EXPECT_EQ(mIndex.GetOrdinal(3, 1), 10005);
+}
+
+/*
+    S elements without @t continue from end of previous one, @t resets start time
+*/
+TEST_F(TimelineIndexTests, ResolvesStartTimes)
+{
+	EXPECT_EQ(mIndex.GetStartTime(0, 1), 12000);
+	EXPECT_EQ(mIndex.GetStartTime(1, 0), 16000);
+	EXPECT_EQ(mIndex.GetStartTime(2, 0), 17000);
+	EXPECT_EQ(mIndex.GetStartTime(2, 5), 27000);
+	EXPECT_EQ(mIndex.GetStartTime(3, 1), 100004000);
+	EXPECT_FALSE(mIndex.HasStartTimeBetween(0, 2));
+	EXPECT_TRUE(mIndex.HasStartTimeBetween(2, 3));
+}
+
+/*
+    Ordinal and (entry, repeat) convert both ways
+*/
+TEST_F(TimelineIndexTests, ConvertsOrdinals)
+{
+	for (uint64_t ordinal = 0; ordinal < mIndex.GetFragmentCount(); ordinal += 7)
+	{
+		int entry = -1;
+		int repeat = -1;
+		mIndex.GetPosition(ordinal, entry, repeat);
+		EXPECT_EQ(mIndex.GetOrdinal(entry, repeat), ordinal);
+	}
+	int entry = -1;
+	int repeat = -1;
+	mIndex.GetPosition(3, entry, repeat);
+	EXPECT_EQ(entry, 1);
+	EXPECT_EQ(repeat, 0);
+}
+
+/*
+    Seconds offsets map to the fragment containing them
+*/
+TEST_F(TimelineIndexTests, FindsFragmentBySeconds)
+{
+	EXPECT_EQ(mIndex.FindFragmentBySeconds(0), 0);
+	EXPECT_EQ(mIndex.FindFragmentBySeconds(5.9), 2);
+	EXPECT_EQ(mIndex.FindFragmentBySeconds(6.5), 3);
+	EXPECT_EQ(mIndex.FindFragmentBySeconds(7.0), 4);
+	EXPECT_EQ(mIndex.FindFragmentBySeconds(7.0 + 2 * 9999 + 1), 10003);
+	EXPECT_EQ(mIndex.FindFragmentBySeconds(7.0 + 2 * 10000 + 4.5), 10005);
+	EXPECT_EQ(mIndex.FindFragmentBySeconds(7.0 + 2 * 10000 + 8), mIndex.GetFragmentCount());
+	EXPECT_DOUBLE_EQ(mIndex.GetOffsetSeconds(2, 100), 207.0);
+}
+
+/*
+    Entry lookup by time returns first S element ending after it
+*/
+TEST_F(TimelineIndexTests, FindsEntryByTime)
+{
+	EXPECT_EQ(mIndex.FindEntryByTime(0, 0), 0);
+	EXPECT_EQ(mIndex.FindEntryByTime(15999, 0), 0);
+	EXPECT_EQ(mIndex.FindEntryByTime(16000, 0), 1);
+	EXPECT_EQ(mIndex.FindEntryByTime(50000, 0), 2);
+	EXPECT_EQ(mIndex.FindEntryByTime(50000, 3), 3);
+	EXPECT_EQ(mIndex.FindEntryByTime(100008000, 0), 4);
+}
+
+/*
+    Index is only reused for the timeline and manifest update it was built for
+*/
+TEST_F(TimelineIndexTests, TracksOwner)
+{
+	int otherOwner = 0;
+	EXPECT_TRUE(mIndex.IsBuiltFor(&mOwner, 1, 4, TEST_TIMESCALE));
+	EXPECT_FALSE(mIndex.IsBuiltFor(&mOwner, 2, 4, TEST_TIMESCALE));
+	EXPECT_FALSE(mIndex.IsBuiltFor(&otherOwner, 1, 4, TEST_TIMESCALE));
+	EXPECT_FALSE(mIndex.IsBuiltFor(&mOwner, 1, 5, TEST_TIMESCALE));
+	mIndex.Reset();
+	EXPECT_FALSE(mIndex.IsBuiltFor(&mOwner, 1, 4, TEST_TIMESCALE));
+	EXPECT_EQ(mIndex.GetFragmentCount(), 0);
+}
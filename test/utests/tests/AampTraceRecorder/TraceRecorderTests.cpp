@@ -0,0 +1,186 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "AampTraceRecorder.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+class TraceRecorderTests : public ::testing::Test
+{
+protected:
+	void TearDown() override
+	{
+		AampTraceRecorder::GetInstance().Stop();
+	}
+
+	static size_t Count(const std::string &json, const std::string &pattern)
+	{
+		size_t count = 0;
+		for (size_t pos = json.find(pattern); pos != std::string::npos; pos = json.find(pattern, pos + 1))
+		{
+			count++;
+		}
+		return count;
+	}
+};
+
+/*
+    Nothing is recorded unless started, events of a stopped recorder stay for export
+*/
+TEST_F(TraceRecorderTests, RecordsOnlyWhileStarted)
+{
+	AampTraceRecorder &recorder = AampTraceRecorder::GetInstance();
+	std::string json;
+	recorder.Stop();
+	{
+		AampTraceSpan span("fragment", "download");
+	}
+	recorder.Start(0);
+	EXPECT_TRUE(AampTraceRecorder::IsEnabled());
+	EXPECT_EQ(recorder.GetJson(json), 0);
+	{
+		AampTraceSpan span("fragment", "download", "type", 1);
+		usleep(2000);
+		span.End("bytes", 1000);
+	}
+	recorder.Stop();
+	recorder.AddInstant("abr", "profile_change");
+	EXPECT_EQ(recorder.GetJson(json), 1);
+	EXPECT_NE(json.find("\"ph\":\"X\",\"cat\":\"fragment\",\"name\":\"download\""), std::string::npos);
+	EXPECT_NE(json.find("\"args\":{\"type\":1,\"bytes\":1000}"), std::string::npos);
+	size_t dur = json.find("\"dur\":");
+	ASSERT_NE(dur, std::string::npos);
+	EXPECT_GE(atoll(json.c_str() + dur + 6), 2000);
+
+	// restart drops previous session
+	recorder.Start(0);
+	EXPECT_EQ(recorder.GetJson(json), 0);
+}
+
+/*
+    Each thread gets a named track, instants and counters carry their arguments
+*/
+TEST_F(TraceRecorderTests, RecordsThreads)
+{
+	AampTraceRecorder &recorder = AampTraceRecorder::GetInstance();
+	recorder.Start(1024);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; i++)
+	{
+		threads.push_back(std::thread([i]()
+		{
+			char name[16];
+			snprintf(name, sizeof(name), "aampWorker%d", i);
+			pthread_setname_np(pthread_self(), name);
+			for (int j = 0; j < 100; j++)
+			{
+				AampTraceSpan span("fragment", "inject", "track", i);
+			}
+		}));
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	recorder.AddInstant("abr", "profile_change", "from", 1000000, "to", 2000000, "network", 3000000);
+	recorder.AddCounter("abr", "bandwidth", "bps", 3000000);
+
+	std::string json;
+	EXPECT_EQ(recorder.GetJson(json), 402);
+	EXPECT_EQ(Count(json, "\"name\":\"inject\""), 400);
+	EXPECT_EQ(Count(json, "\"name\":\"thread_name\""), 5);
+	EXPECT_NE(json.find("\"args\":{\"name\":\"aampWorker3\"}"), std::string::npos);
+	EXPECT_NE(json.find("\"ph\":\"i\""), std::string::npos);
+	EXPECT_NE(json.find("\"args\":{\"from\":1000000,\"to\":2000000,\"network\":3000000}"), std::string::npos);
+	EXPECT_NE(json.find("\"ph\":\"C\",\"cat\":\"abr\",\"name\":\"bandwidth\""), std::string::npos);
+	EXPECT_EQ(json.compare(0, 19, "{\"displayTimeUnit\":"), 0);
+	EXPECT_EQ(json.substr(json.size() - 5), "}\n]}\n");
+}
+
+/*
+    Full ring keeps latest events in order
+*/
+TEST_F(TraceRecorderTests, OverwritesOldest)
+{
+	AampTraceRecorder &recorder = AampTraceRecorder::GetInstance();
+	recorder.Start(AAMP_TRACE_MIN_EVENTS);
+	for (int i = 0; i < AAMP_TRACE_MIN_EVENTS * 3 + 10; i++)
+	{
+		recorder.AddComplete("fragment", "decrypt", i, 1, "index", i);
+	}
+	std::string json;
+	EXPECT_EQ(recorder.GetJson(json), AAMP_TRACE_MIN_EVENTS);
+	std::string oldest = "\"index\":" + std::to_string(AAMP_TRACE_MIN_EVENTS * 2 + 10) + "}";
+	std::string newest = "\"index\":" + std::to_string(AAMP_TRACE_MIN_EVENTS * 3 + 9) + "}";
+	EXPECT_EQ(json.find("\"index\":" + std::to_string(AAMP_TRACE_MIN_EVENTS * 2 + 9) + "}"), std::string::npos);
+	ASSERT_NE(json.find(oldest), std::string::npos);
+	ASSERT_NE(json.find(newest), std::string::npos);
+	EXPECT_LT(json.find(oldest), json.find(newest));
+}
+
+/*
+    Export while threads record gives well formed events only, file is written
+*/
+TEST_F(TraceRecorderTests, ExportsWhileRecording)
+{
+	AampTraceRecorder &recorder = AampTraceRecorder::GetInstance();
+	recorder.Start(AAMP_TRACE_MIN_EVENTS);
+	std::atomic<bool> running(true);
+	std::thread writer([&running]()
+	{
+		while (running)
+		{
+			AampTraceRecorder::GetInstance().AddComplete("fragment", "gst_push", 1, 2, "bytes", 3);
+		}
+	});
+	for (int i = 0; i < 50; i++)
+	{
+		std::string json;
+		size_t count = recorder.GetJson(json);
+		EXPECT_LE(count, AAMP_TRACE_MIN_EVENTS);
+		EXPECT_EQ(Count(json, "\"ts\":1,\"dur\":2,\"args\":{\"bytes\":3}"), count);
+	}
+	running = false;
+	writer.join();
+
+	char path[] = "/tmp/aampTraceXXXXXX";
+	int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	close(fd);
+	EXPECT_TRUE(recorder.WriteJson(path));
+	FILE *file = fopen(path, "r");
+	ASSERT_TRUE(file != NULL);
+	char head[20] = {0};
+	EXPECT_EQ(fread(head, 1, sizeof(head) - 1, file), sizeof(head) - 1);
+	fclose(file);
+	unlink(path);
+	EXPECT_EQ(std::string(head), "{\"displayTimeUnit\":");
+	EXPECT_FALSE(recorder.WriteJson("/nonexistent/dir/trace.json"));
+}
@@ -0,0 +1,143 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+ * @file TsProcessorBenchmark.cpp
+ * @brief Feeds recorded HLS TS segments through TSProcessor::sendSegment and reports demux throughput
+ *
+ * Usage: TsProcessorBenchmark [-n iterations] segment.ts [segment.ts ...]
+ * Segments are demuxed in the given order at normal rate, elementary streams are counted and dropped.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "priv_aamp.h"
+#include "AampConfig.h"
+#include "tsprocessor.h"
+#include "AampTsScanner.h"
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+/**
+ * @class CountingSink
+ * @brief Sink counting elementary stream buffers instead of playing them
+ */
+class CountingSink : public StreamSink
+{
+public:
+	CountingSink() : mBuffers(0), mBytes(0)
+	{
+	}
+
+	void SendCopy(MediaType mediaType, const void *ptr, size_t len, double fpts, double fdts, double duration) override
+	{
+		mBuffers++;
+		mBytes += len;
+	}
+
+	void SendTransfer(MediaType mediaType, struct GrowableBuffer* buffer, double fpts, double fdts, double duration, bool initFragment) override
+	{
+		mBuffers++;
+		mBytes += buffer->len;
+		aamp_Free(buffer);
+	}
+
+	bool Discontinuity(MediaType mediaType) override
+	{
+		return false;
+	}
+
+	unsigned long long mBuffers;
+	unsigned long long mBytes;
+};
+
+int main(int argc, char **argv)
+{
+	int iterations = 10;
+	std::vector<std::vector<char>> segments;
+	size_t totalBytes = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (0 == strcmp(argv[i], "-n") && (i + 1 < argc))
+		{
+			iterations = atoi(argv[++i]);
+			continue;
+		}
+		std::ifstream file(argv[i], std::ios::binary);
+		if (!file)
+		{
+			fprintf(stderr, "cannot open %s\n", argv[i]);
+			return 1;
+		}
+		segments.push_back(std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()));
+		totalBytes += segments.back().size();
+	}
+	if (segments.empty())
+	{
+		fprintf(stderr, "usage: %s [-n iterations] segment.ts [segment.ts ...]\n", argv[0]);
+		return 1;
+	}
+
+	gpGlobalConfig = new AampConfig();
+	PrivateInstanceAAMP *aamp = new PrivateInstanceAAMP(gpGlobalConfig);
+	CountingSink sink;
+	aamp->mStreamSink = &sink;
+
+	double elapsedSeconds = 0;
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		TSProcessor *tsProcessor = new TSProcessor(mLogObj, aamp, eStreamOp_DEMUX_ALL);
+		tsProcessor->setThrottleEnable(false);
+		double position = 0;
+		std::vector<char> segment;
+		for (size_t i = 0; i < segments.size(); i++)
+		{
+			// sendSegment may rewrite packets in place, every pass starts from the recording
+			segment = segments[i];
+			size_t size = segment.size();
+			bool ptsError = false;
+			auto start = std::chrono::steady_clock::now();
+			tsProcessor->sendSegment(segment.data(), size, position, 0, (i == 0), ptsError);
+			elapsedSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (ptsError)
+			{
+				fprintf(stderr, "pts error in segment %d\n", (int)i);
+			}
+		}
+		delete tsProcessor;
+	}
+
+	double megabytes = (double)totalBytes * iterations / (1024 * 1024);
+	printf("scanner %s: %d segments x %d iterations, %.1f MB in %.3f s, %.1f MB/s, %llu ES buffers %llu bytes\n",
+		AampTsScanner::GetImplementation(), (int)segments.size(), iterations, megabytes, elapsedSeconds,
+		(elapsedSeconds > 0) ? (megabytes / elapsedSeconds) : 0, sink.mBuffers, sink.mBytes);
+
+	aamp->mStreamSink = NULL;
+	delete aamp;
+	delete gpGlobalConfig;
+	return 0;
+}
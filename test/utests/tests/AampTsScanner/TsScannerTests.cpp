@@ -0,0 +1,146 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "AampTsScanner.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+#define TEST_VIDEO_PID 0x100
+#define TEST_AUDIO_PID 0x101
+#define TEST_OTHER_PID 0x1FFF
+
+class TsScannerTests : public ::testing::Test
+{
+protected:
+	AampTsScanner mScanner;
+	std::vector<unsigned char> mSegment;
+
+	void AddPacket(int pid, int adaptationLength = -1, unsigned char sync = AAMP_TS_SYNC_BYTE)
+	{
+		size_t offset = mSegment.size();
+		mSegment.resize(offset + AAMP_TS_PACKET_SIZE, 0xFF);
+		unsigned char *packet = &mSegment[offset];
+		packet[0] = sync;
+		packet[1] = (pid >> 8) & 0x1F;
+		packet[2] = pid & 0xFF;
+		packet[3] = 0x10;
+		if (adaptationLength >= 0)
+		{
+			packet[3] |= 0x20;
+			packet[4] = adaptationLength;
+		}
+	}
+};
+
+/*
+    Packets are sorted by PID in stream order, other PIDs are skipped
+*/
+TEST_F(TsScannerTests, ClassifiesPids)
+{
+	int pids[] = { TEST_VIDEO_PID, TEST_AUDIO_PID, -1, TEST_VIDEO_PID };
+	for (int i = 0; i < 11; i++)
+	{
+		AddPacket((i % 3 == 0) ? TEST_AUDIO_PID : ((i % 3 == 1) ? TEST_VIDEO_PID : TEST_OTHER_PID));
+	}
+	mSegment.resize(mSegment.size() + 100);
+
+	EXPECT_EQ(mScanner.Scan(mSegment.data(), mSegment.size(), pids, 4), 11);
+	EXPECT_EQ(mScanner.GetSyncErrorCount(), 0);
+	EXPECT_EQ(mScanner.GetPackets(0), std::vector<uint32_t>({1, 4, 7, 10}));
+	EXPECT_EQ(mScanner.GetPackets(1), std::vector<uint32_t>({0, 3, 6, 9}));
+	EXPECT_TRUE(mScanner.GetPackets(2).empty());
+	EXPECT_EQ(mScanner.GetPackets(3), mScanner.GetPackets(0));
+	EXPECT_EQ(mScanner.GetMatchedPackets(), std::vector<uint32_t>({0, 1, 3, 4, 6, 7, 9, 10}));
+	EXPECT_EQ(mScanner.GetMask(1), 0x9);
+	EXPECT_EQ(mScanner.GetMask(2), 0);
+}
+
+/*
+    Packets without sync byte are counted and never matched
+*/
+TEST_F(TsScannerTests, RejectsLostSync)
+{
+	int pids[] = { TEST_VIDEO_PID };
+	AddPacket(TEST_VIDEO_PID);
+	AddPacket(TEST_VIDEO_PID, -1, 0x46);
+	AddPacket(TEST_VIDEO_PID);
+
+	mScanner.Scan(mSegment.data(), mSegment.size(), pids, 1);
+	EXPECT_EQ(mScanner.GetSyncErrorCount(), 1);
+	EXPECT_EQ(mScanner.GetPackets(0), std::vector<uint32_t>({0, 2}));
+}
+
+/*
+    Payload size excludes adaptation field
+*/
+TEST_F(TsScannerTests, SumsPayloadBytes)
+{
+	int pids[] = { TEST_VIDEO_PID, TEST_AUDIO_PID };
+	AddPacket(TEST_VIDEO_PID);
+	AddPacket(TEST_VIDEO_PID, 7);
+	AddPacket(TEST_AUDIO_PID, 183);
+	AddPacket(TEST_AUDIO_PID, 200);
+
+	mScanner.Scan(mSegment.data(), mSegment.size(), pids, 2);
+	EXPECT_EQ(mScanner.GetPayloadBytes(0), 184 + 176);
+	EXPECT_EQ(mScanner.GetPayloadBytes(1), 0);
+}
+
+/*
+    Results match a plain per packet comparison for every group alignment
+*/
+TEST_F(TsScannerTests, MatchesScalarReference)
+{
+	int pids[] = { 0, TEST_VIDEO_PID, TEST_AUDIO_PID };
+	unsigned int seed = 1;
+	for (int i = 0; i < 1000; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		AddPacket((seed >> 16) % 4 ? ((seed >> 8) & 1) + TEST_VIDEO_PID : (seed >> 4) & 0x1FFF, -1, (seed >> 20) % 50 ? AAMP_TS_SYNC_BYTE : 0);
+	}
+	for (size_t count = 995; count <= 1000; count++)
+	{
+		mScanner.Scan(mSegment.data(), count * AAMP_TS_PACKET_SIZE, pids, 3);
+		ASSERT_EQ(mScanner.GetPacketCount(), count);
+		size_t syncErrors = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			const unsigned char *packet = &mSegment[i * AAMP_TS_PACKET_SIZE];
+			int pid = (packet[1] & 0x1F) << 8 | packet[2];
+			bool sync = (packet[0] == AAMP_TS_SYNC_BYTE);
+			unsigned int expected = 0;
+			for (int slot = 0; slot < 3; slot++)
+			{
+				if (sync && pid == pids[slot])
+				{
+					expected |= 1 << slot;
+				}
+			}
+			syncErrors += sync ? 0 : 1;
+			EXPECT_EQ(mScanner.GetMask(i), expected);
+		}
+		EXPECT_EQ(mScanner.GetSyncErrorCount(), syncErrors);
+	}
+}
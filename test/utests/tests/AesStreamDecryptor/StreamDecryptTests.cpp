@@ -0,0 +1,166 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <openssl/evp.h>
+#include "aamp_aes_stream.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+class StreamDecryptTests : public ::testing::Test
+{
+protected:
+	unsigned char mKey[AES_STREAM_BLOCK_SIZE];
+	unsigned char mIv[AES_STREAM_BLOCK_SIZE];
+	std::vector<unsigned char> mClear;
+	std::vector<unsigned char> mSegment;
+
+	void SetUp()
+	{
+		for (int i = 0; i < AES_STREAM_BLOCK_SIZE; i++)
+		{
+			mKey[i] = (unsigned char)(0x10 + i);
+			mIv[i] = (unsigned char)(0xA0 + i);
+		}
+		// PKCS7 padded as for an HLS AES-128 segment
+		for (int i = 0; i < 1000; i++)
+		{
+			mClear.push_back((unsigned char)(i * 7));
+		}
+		mSegment.resize(mClear.size() + AES_STREAM_BLOCK_SIZE);
+		EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+		int len = 0, finalLen = 0;
+		EVP_EncryptInit_ex(ctx, EVP_aes_128_cbc(), NULL, mKey, mIv);
+		EVP_EncryptUpdate(ctx, mSegment.data(), &len, mClear.data(), (int)mClear.size());
+		EVP_EncryptFinal_ex(ctx, mSegment.data() + len, &finalLen);
+		EVP_CIPHER_CTX_free(ctx);
+		mSegment.resize(len + finalLen);
+	}
+
+	// Feeds segment the way the download callback does, as a growing buffer
+	void Download(AesStreamDecryptor &decryptor, std::vector<unsigned char> &buffer, size_t chunk)
+	{
+		buffer.clear();
+		for (size_t pos = 0; pos < mSegment.size(); pos += chunk)
+		{
+			size_t end = std::min(pos + chunk, mSegment.size());
+			buffer.insert(buffer.end(), mSegment.begin() + pos, mSegment.begin() + end);
+			ASSERT_TRUE(decryptor.Update(buffer.data(), buffer.size()));
+			EXPECT_EQ(decryptor.GetDecryptedLength(), buffer.size() & ~(size_t)(AES_STREAM_BLOCK_SIZE - 1));
+		}
+	}
+
+	void ExpectClear(const std::vector<unsigned char> &buffer)
+	{
+		ASSERT_EQ(buffer.size(), mSegment.size());
+		EXPECT_TRUE(std::equal(mClear.begin(), mClear.end(), buffer.begin()));
+		// padding is cleared, length is kept
+		for (size_t i = mClear.size(); i < buffer.size(); i++)
+		{
+			EXPECT_EQ(buffer[i], 0);
+		}
+	}
+};
+
+/*
+    Result does not depend on how the segment is split into chunks
+*/
+TEST_F(StreamDecryptTests, DecryptsAnyChunking)
+{
+	AesStreamDecryptor decryptor;
+	const size_t chunks[] = { 1, 7, 16, 100, 4096 };
+	for (size_t chunk : chunks)
+	{
+		std::vector<unsigned char> buffer;
+		ASSERT_TRUE(decryptor.Init(mKey, mIv));
+		Download(decryptor, buffer, chunk);
+		ASSERT_TRUE(decryptor.Finish(buffer.data(), buffer.size()));
+		EXPECT_FALSE(decryptor.IsActive());
+		ExpectClear(buffer);
+	}
+}
+
+/*
+    Segment delivered in one piece, e.g. from cache, is decrypted by Finish
+*/
+TEST_F(StreamDecryptTests, FinishesUndecryptedSegment)
+{
+	AesStreamDecryptor decryptor;
+	std::vector<unsigned char> buffer(mSegment);
+	ASSERT_TRUE(decryptor.Init(mKey, mIv));
+	ASSERT_TRUE(decryptor.Finish(buffer.data(), buffer.size()));
+	ExpectClear(buffer);
+}
+
+/*
+    Retried download refills the buffer from offset 0 after Restart
+*/
+TEST_F(StreamDecryptTests, RestartsOnRetry)
+{
+	AesStreamDecryptor decryptor;
+	std::vector<unsigned char> buffer(mSegment.begin(), mSegment.begin() + 500);
+	ASSERT_TRUE(decryptor.Init(mKey, mIv));
+	ASSERT_TRUE(decryptor.Update(buffer.data(), buffer.size()));
+
+	// refill without Restart loses track of decrypted prefix
+	buffer.assign(mSegment.begin(), mSegment.begin() + 100);
+	EXPECT_FALSE(decryptor.Update(buffer.data(), buffer.size()));
+	EXPECT_FALSE(decryptor.Finish(buffer.data(), buffer.size()));
+
+	ASSERT_TRUE(decryptor.Init(mKey, mIv));
+	buffer.assign(mSegment.begin(), mSegment.begin() + 500);
+	ASSERT_TRUE(decryptor.Update(buffer.data(), buffer.size()));
+	decryptor.Restart();
+	EXPECT_EQ(decryptor.GetDecryptedLength(), 0);
+	Download(decryptor, buffer, 333);
+	ASSERT_TRUE(decryptor.Finish(buffer.data(), buffer.size()));
+	ExpectClear(buffer);
+}
+
+/*
+    Wrong key, truncated segment and inactive decryptor are reported by Finish
+*/
+TEST_F(StreamDecryptTests, ReportsBadSegments)
+{
+	AesStreamDecryptor decryptor;
+	std::vector<unsigned char> buffer(mSegment);
+	EXPECT_FALSE(decryptor.Finish(buffer.data(), buffer.size()));
+	EXPECT_EQ(buffer, mSegment);
+
+	buffer.resize(buffer.size() - 3);
+	ASSERT_TRUE(decryptor.Init(mKey, mIv));
+	EXPECT_FALSE(decryptor.Finish(buffer.data(), buffer.size()));
+
+	// a wrong key leaves garbage padding
+	unsigned char key[AES_STREAM_BLOCK_SIZE] = { 0 };
+	buffer = mSegment;
+	ASSERT_TRUE(decryptor.Init(key, mIv));
+	EXPECT_FALSE(decryptor.Finish(buffer.data(), buffer.size()));
+
+	ASSERT_TRUE(decryptor.Init(mKey, mIv));
+	decryptor.Deactivate();
+	EXPECT_FALSE(decryptor.IsActive());
+	EXPECT_FALSE(decryptor.Init(NULL, mIv));
+}
@@ -0,0 +1,236 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include "isobmffboxindex.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+class BoxIndexTests : public ::testing::Test
+{
+protected:
+	std::vector<uint8_t> mStream;
+	std::vector<size_t> mOpen;
+
+	void U32(uint32_t value)
+	{
+		for (int shift = 24; shift >= 0; shift -= 8)
+		{
+			mStream.push_back((uint8_t)(value >> shift));
+		}
+	}
+
+	void U64(uint64_t value)
+	{
+		U32((uint32_t)(value >> 32));
+		U32((uint32_t)value);
+	}
+
+	void Str(const char *value)
+	{
+		mStream.insert(mStream.end(), value, value + strlen(value) + 1);
+	}
+
+	void Open(const char *type, int version = -1, uint32_t flags = 0)
+	{
+		mOpen.push_back(mStream.size());
+		U32(0);
+		mStream.insert(mStream.end(), type, type + 4);
+		if (version >= 0)
+		{
+			U32(((uint32_t)version << 24) | flags);
+		}
+	}
+
+	void Close()
+	{
+		size_t start = mOpen.back();
+		mOpen.pop_back();
+		uint32_t size = (uint32_t)(mStream.size() - start);
+		for (int i = 0; i < 4; i++)
+		{
+			mStream[start + i] = (uint8_t)(size >> (24 - 8 * i));
+		}
+	}
+
+	void AddFragment(uint64_t baseMediaDecodeTime, bool sampleDurations)
+	{
+		Open("moof");
+		Open("mfhd", 0); U32(1); Close();
+		Open("traf");
+		Open("tfhd", 0, 0x0A); U32(1); U32(1); U32(512); Close();
+		Open("tfdt", 1); U64(baseMediaDecodeTime); Close();
+		Open("trun", 0, sampleDurations ? 0x0301 : 0x0201); U32(3); U32(0);
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			if (sampleDurations)
+			{
+				U32(1000 + i);
+			}
+			U32(100);
+		}
+		Close();
+		Close();
+		Close();
+		Open("mdat"); U32(0xDEADBEEF); Close();
+	}
+};
+
+/*
+    Boxes are recorded in document order with their nesting level
+*/
+TEST_F(BoxIndexTests, IndexesFragment)
+{
+	IsoBmffBoxIndex index;
+	Open("styp"); U32(0); Close();
+	AddFragment(0x100000000ULL + 5, true);
+	AddFragment(7, false);
+
+	ASSERT_TRUE(index.parse(mStream.data(), mStream.size()));
+	ASSERT_EQ(index.getCount(), 15);
+	const char *types[] = { "styp", "moof", "mfhd", "traf", "tfhd", "tfdt", "trun", "mdat" };
+	const int depths[] = { 0, 0, 1, 1, 2, 2, 2, 0 };
+	for (int i = 0; i < 8; i++)
+	{
+		EXPECT_EQ(std::string(index.getRecord(i).type, 4), types[i]);
+		EXPECT_EQ(index.getRecord(i).depth, depths[i]);
+	}
+	EXPECT_EQ(index.getSubtreeEnd(1), 7);
+	EXPECT_FALSE(index.isInitSegment());
+	EXPECT_EQ(index.getMdatCount(), 2);
+
+	uint64_t pts = 0;
+	ASSERT_TRUE(index.getFirstPTS(pts));
+	EXPECT_EQ(pts, 0x100000000ULL + 5);
+
+	// sample durations from trun, else tfhd default duration
+	EXPECT_EQ(index.getSampleDuration(1), 3003);
+	int moof = index.find("moof", 2);
+	ASSERT_EQ(moof, 8);
+	EXPECT_EQ(index.getSampleDuration(moof), 512);
+	EXPECT_EQ(index.getTrunDuration(index.find("trun", moof)), 0);
+}
+
+/*
+    Timescale is taken from mdhd in preference to mvhd
+*/
+TEST_F(BoxIndexTests, ReadsInitSegment)
+{
+	IsoBmffBoxIndex index;
+	Open("ftyp"); U32(0); Close();
+	Open("moov");
+	Open("mvhd", 0); U32(0); U32(0); U32(1000); U32(0); Close();
+	Open("trak");
+	Open("tkhd", 0); U32(0); Close();
+	Open("mdia");
+	Open("mdhd", 1); U64(0); U64(0); U32(90000); U64(0); Close();
+	Close();
+	Close();
+	Close();
+
+	ASSERT_TRUE(index.parse(mStream.data(), mStream.size()));
+	EXPECT_TRUE(index.isInitSegment());
+	uint32_t timeScale = 0;
+	ASSERT_TRUE(index.getTimeScale(timeScale));
+	EXPECT_EQ(timeScale, 90000);
+	ASSERT_TRUE(index.getMdhdTimeScale(index.find("mvhd"), timeScale));
+	EXPECT_EQ(timeScale, 1000);
+	EXPECT_EQ(index.getRecord(index.find("mdhd")).depth, 3);
+}
+
+/*
+    emsg fields of both versions point into the source buffer
+*/
+TEST_F(BoxIndexTests, ReadsEmsg)
+{
+	IsoBmffBoxIndex index;
+	const uint8_t id3[] = { 'I', 'D', '3', 4, 0 };
+	Open("emsg", 1); U32(1000); U64(123456); U32(50); U32(9); Str("https://aomedia.org/emsg/ID3"); Str("1");
+	mStream.insert(mStream.end(), id3, id3 + sizeof(id3));
+	Close();
+	size_t v0Start = mStream.size();
+	Open("emsg", 0); Str("urn:test"); Str(""); U32(90000); U32(10); U32(20); U32(30); Close();
+
+	ASSERT_TRUE(index.parse(mStream.data(), mStream.size()));
+	const uint8_t *message = NULL;
+	uint32_t messageLen = 0;
+	const char *schemeIdUri = NULL;
+	const char *value = NULL;
+	uint64_t presTime = 0;
+	uint32_t timeScale = 0, eventDuration = 0, id = 0;
+	ASSERT_TRUE(index.getEMSGData(message, messageLen, schemeIdUri, value, presTime, timeScale, eventDuration, id));
+	EXPECT_STREQ(schemeIdUri, "https://aomedia.org/emsg/ID3");
+	EXPECT_STREQ(value, "1");
+	EXPECT_EQ(presTime, 123456);
+	EXPECT_EQ(timeScale, 1000);
+	EXPECT_EQ(eventDuration, 50);
+	EXPECT_EQ(id, 9);
+	EXPECT_EQ(messageLen, sizeof(id3));
+	EXPECT_EQ(message, &mStream[v0Start - sizeof(id3)]);
+
+	ASSERT_TRUE(index.getEmsg(1, message, messageLen, schemeIdUri, value, presTime, timeScale, eventDuration, id));
+	EXPECT_STREQ(schemeIdUri, "urn:test");
+	EXPECT_STREQ(value, "");
+	EXPECT_EQ(timeScale, 90000);
+	EXPECT_EQ(eventDuration, 20);
+	EXPECT_EQ(id, 30);
+	EXPECT_EQ(messageLen, 0);
+
+	// unterminated scheme id
+	mStream[v0Start + 12 + 8] = 'x';
+	mStream[v0Start + 12 + 9] = 'x';
+	EXPECT_FALSE(index.getEmsg(1, message, messageLen, schemeIdUri, value, presTime, timeScale, eventDuration, id));
+}
+
+/*
+    Caller arena overflow is reported, partial boxes are indexed but not decoded
+*/
+TEST_F(BoxIndexTests, HandlesArenaAndPartialBoxes)
+{
+	IsoBmffBoxRecord arena[4];
+	IsoBmffBoxIndex index(arena, 4);
+	AddFragment(42, true);
+
+	EXPECT_FALSE(index.parse(mStream.data(), mStream.size()));
+	EXPECT_EQ(index.getCount(), 4);
+	EXPECT_EQ(index.getRequiredCount(), 7);
+
+	IsoBmffBoxRecord larger[8];
+	index.setArena(larger, 8);
+	ASSERT_TRUE(index.parse(mStream.data(), mStream.size()));
+	EXPECT_EQ(&index.getRecord(0), &larger[0]);
+
+	// mdat cut short, tfdt cut short
+	ASSERT_TRUE(index.parse(mStream.data(), mStream.size() - 2));
+	EXPECT_TRUE(index.isPartial(6));
+	EXPECT_EQ(index.getMdatCount(), 0);
+	int tfdt = index.find("tfdt");
+	size_t tfdtEnd = index.getRecord(tfdt).offset + index.getRecord(tfdt).size;
+	ASSERT_TRUE(index.parse(mStream.data(), tfdtEnd - 1));
+	uint64_t pts = 0;
+	EXPECT_TRUE(index.isPartial(0));
+	EXPECT_EQ(index.getCount(), 1);
+	EXPECT_FALSE(index.getFirstPTS(pts));
+}
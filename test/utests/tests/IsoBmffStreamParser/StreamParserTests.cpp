@@ -0,0 +1,130 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2022 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "isobmffstreamparser.h"
+
+class AampConfig;
+class AampLogManager;
+
+AampConfig *gpGlobalConfig = NULL;
+AampLogManager *mLogObj = NULL;
+
+static void AddBox(std::vector<uint8_t> &stream, const char *type, uint32_t size, uint8_t fill = 0)
+{
+	uint8_t header[8] = { (uint8_t)(size >> 24), (uint8_t)(size >> 16), (uint8_t)(size >> 8), (uint8_t)size };
+	memcpy(header + 4, type, 4);
+	stream.insert(stream.end(), header, header + 8);
+	stream.insert(stream.end(), size - 8, fill);
+}
+
+class StreamParserTests : public ::testing::Test
+{
+protected:
+	IsoBmffStreamParser mParser;
+	std::vector<uint8_t> mStream;
+
+	void SetUp() override
+	{
+		// styp moof mdat moof mdat moof(partial mdat follows)
+		AddBox(mStream, "styp", 24);
+		AddBox(mStream, "moof", 100, 1);
+		AddBox(mStream, "mdat", 1000, 2);
+		AddBox(mStream, "moof", 100, 3);
+		AddBox(mStream, "mdat", 500, 4);
+		AddBox(mStream, "moof", 100, 5);
+		AddBox(mStream, "mdat", 2000, 6);
+	}
+};
+
+/*
+    Unit ends with the last complete mdat whatever the chunk boundaries are
+*/
+TEST_F(StreamParserTests, EmitsUnitsAcrossChunks)
+{
+	uint8_t *unit = NULL;
+	size_t len = 0;
+	size_t fed = 0;
+	std::vector<uint8_t> out;
+	const size_t chunkSizes[] = { 3, 5, 200, 1, 1000, 600, 900, 1115 };
+	for (size_t chunk : chunkSizes)
+	{
+		ASSERT_TRUE(mParser.append(&mStream[fed], chunk));
+		fed += chunk;
+		if (mParser.getUnit(unit, len))
+		{
+			// units never end inside a box
+			size_t end = out.size() + len;
+			EXPECT_TRUE(end == 1124 || end == 1724 || end == 3824) << end;
+			out.insert(out.end(), unit, unit + len);
+			mParser.consumeUnit();
+		}
+		EXPECT_EQ(out.size() + mParser.getPendingSize(), fed);
+	}
+	ASSERT_EQ(fed, mStream.size());
+	EXPECT_EQ(out, mStream);
+	EXPECT_EQ(mParser.getPendingSize(), 0);
+}
+
+/*
+    Boxes before an mdat are held back until the mdat completes
+*/
+TEST_F(StreamParserTests, HoldsPartialUnit)
+{
+	uint8_t *unit = NULL;
+	size_t len = 0;
+	ASSERT_TRUE(mParser.append(mStream.data(), 124 + 999));
+	EXPECT_FALSE(mParser.getUnit(unit, len));
+	ASSERT_TRUE(mParser.append(&mStream[1123], 1 + 100 + 10));
+	ASSERT_TRUE(mParser.getUnit(unit, len));
+	EXPECT_EQ(len, 1124);
+	EXPECT_EQ(0, memcmp(unit, mStream.data(), len));
+	mParser.consumeUnit();
+	EXPECT_EQ(mParser.getPendingSize(), 110);
+
+	// consumed bytes are reclaimed once pending data is smaller, offsets stay consistent
+	ASSERT_TRUE(mParser.append(&mStream[1234], 490));
+	ASSERT_TRUE(mParser.getUnit(unit, len));
+	EXPECT_EQ(len, 600);
+	EXPECT_EQ(0, memcmp(unit, &mStream[1124], len));
+}
+
+/*
+    64 bit box sizes are honoured, malformed sizes drop buffered data
+*/
+TEST_F(StreamParserTests, HandlesLargeAndBadSizes)
+{
+	uint8_t *unit = NULL;
+	size_t len = 0;
+	std::vector<uint8_t> stream;
+	uint8_t large[16] = { 0, 0, 0, 1, 'm', 'd', 'a', 't', 0, 0, 0, 0, 0, 0, 0, 40 };
+	stream.insert(stream.end(), large, large + 16);
+	stream.insert(stream.end(), 24, 7);
+	ASSERT_TRUE(mParser.append(stream.data(), 20));
+	EXPECT_FALSE(mParser.getUnit(unit, len));
+	ASSERT_TRUE(mParser.append(&stream[20], 20));
+	ASSERT_TRUE(mParser.getUnit(unit, len));
+	EXPECT_EQ(len, 40);
+	mParser.consumeUnit();
+
+	uint8_t bad[8] = { 0, 0, 0, 4, 'm', 'o', 'o', 'f' };
+	EXPECT_FALSE(mParser.append(bad, 8));
+	EXPECT_EQ(mParser.getPendingSize(), 0);
+}
@@ -117,6 +117,19 @@ void print_nop(const char *format, ...){}
 #define PES_STATE_GETTING_HEADER_EXTENSION  2
 #define PES_STATE_GETTING_ES  3
 
+/**
+ * @enum TsScanSlot
+ * @brief Order of PIDs classified by AampTsScanner in demuxAndSend
+ */
+enum TsScanSlot
+{
+	eTS_SCAN_SLOT_VIDEO,
+	eTS_SCAN_SLOT_AUDIO,
+	eTS_SCAN_SLOT_DSMCC,
+	eTS_SCAN_SLOT_PCR,
+	eTS_SCAN_SLOT_COUNT
+};
+
 #define PAYLOAD_UNIT_START(packetStart) ( packetStart[1] & 0x40)
 #define CONTAINS_PAYLOAD(packetStart) ( packetStart[3] & 0x10)
 #define IS_PES_PACKET_START(a) ( (a[0] == 0 )&& (a[1] == 0 ) &&(a[2] == 1 ))
@@ -863,6 +876,7 @@ TSProcessor::TSProcessor(AampLogManager *logObj, class PrivateInstanceAAMP *aamp
 	, m_auxiliaryAudio(false)
 	, mLogObj(logObj)
 	,m_audioGroupId()
+	,m_tsScanner()
 {
 	INFO("constructor - %p", this);
 
@@ -2149,28 +2163,42 @@ bool TSProcessor::demuxAndSend(const void *ptr, size_t len, double position, dou
 	}
 	INFO("demuxAndSend : len  %d videoPid %d audioPid %d m_pcrPid %d videoComponentCount %d m_demuxInitialized = %d", (int)len, videoPid, audioPid, m_pcrPid, videoComponentCount, m_demuxInitialized);
 
-	unsigned char * packetStart = (unsigned char *)ptr;
-	while (len >= PACKET_SIZE)
+	/*Classify all packets up front, packets of other pids are skipped without being touched*/
+	int scanPids[eTS_SCAN_SLOT_COUNT];
+	scanPids[eTS_SCAN_SLOT_VIDEO] = m_vidDemuxer ? videoPid : -1;
+	scanPids[eTS_SCAN_SLOT_AUDIO] = m_audDemuxer ? audioPid : -1;
+	scanPids[eTS_SCAN_SLOT_DSMCC] = m_dsmccDemuxer ? dsmccPid : -1;
+	scanPids[eTS_SCAN_SLOT_PCR] = m_pcrPid;
+	m_tsScanner.Scan((const unsigned char *)ptr, len, scanPids, eTS_SCAN_SLOT_COUNT);
+	if (m_tsScanner.GetSyncErrorCount())
+	{
+		WARNING("demuxAndSend : %d of %d packets without sync byte skipped", (int)m_tsScanner.GetSyncErrorCount(), (int)m_tsScanner.GetPacketCount());
+	}
+	INFO("demuxAndSend : %d of %d packets to demux", (int)m_tsScanner.GetMatchedPackets().size(), (int)m_tsScanner.GetPacketCount());
+
+	const std::vector<uint32_t> &packets = m_tsScanner.GetMatchedPackets();
+	for (size_t packetIdx = 0; packetIdx < packets.size(); packetIdx++)
 	{
+		unsigned char * packetStart = (unsigned char *)ptr + (size_t)packets[packetIdx] * PACKET_SIZE;
+		unsigned int scanMask = m_tsScanner.GetMask(packets[packetIdx]);
 		Demuxer* demuxer = NULL;
-		int pid = (packetStart[1] & 0x1f) << 8 | packetStart[2];
 		bool dsmccDemuxerUsed = false;
 
-		if (m_vidDemuxer && (pid == videoPid))
+		if (scanMask & (1 << eTS_SCAN_SLOT_VIDEO))
 		{
 			demuxer = m_vidDemuxer;
 		}
-		else if (m_audDemuxer && (pid == audioPid))
+		else if (scanMask & (1 << eTS_SCAN_SLOT_AUDIO))
 		{
 			demuxer = m_audDemuxer;
 		}
-		else if(m_dsmccDemuxer && (pid == dsmccPid))
+		else if (scanMask & (1 << eTS_SCAN_SLOT_DSMCC))
 		{
 			demuxer = m_dsmccDemuxer;
 			dsmccDemuxerUsed = true;
 		}
 
-		if ((discontinuous || !m_demuxInitialized ) && !firstPcr && (pid == m_pcrPid))
+		if ((discontinuous || !m_demuxInitialized ) && !firstPcr && (scanMask & (1 << eTS_SCAN_SLOT_PCR)))
 		{
 			int adaptation_fieldlen = 0;
 			if ((packetStart[3] & 0x20) == 0x20)
@@ -2274,13 +2302,6 @@ bool TSProcessor::demuxAndSend(const void *ptr, size_t len, double position, dou
 				basePtsUpdatedFromCurrentSegment = true;
 			}
 		}
-		else
-		{
-			INFO("demuxAndSend : discarded packet with pid %d", pid);
-		}
-
-		packetStart += PACKET_SIZE;
-		len -= PACKET_SIZE;
 	}
 	return ret;
 }
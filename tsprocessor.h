@@ -27,6 +27,7 @@
 
 #include "mediaprocessor.h"
 #include "uint33_t.h"
+#include "AampTsScanner.h"
 #include <stdio.h>
 #include <pthread.h>
 
@@ -566,6 +567,7 @@ class TSProcessor : public MediaProcessor
       bool m_auxiliaryAudio;
       AampLogManager *mLogObj;
       std::string m_audioGroupId;
+      AampTsScanner m_tsScanner;
 };
 
 #endif